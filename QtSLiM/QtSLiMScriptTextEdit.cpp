@@ -503,6 +503,7 @@ void QtSLiMTextEdit::scriptHelpOptionClick(QString searchString)
     else if (searchString == "early")			searchString = "Eidos events";
 	else if (searchString == "late")			searchString = "Eidos events";
 	else if (searchString == "mutationEffect")  searchString = "mutationEffect() callbacks";
+	else if (searchString == "mutationEffects") searchString = "mutationEffect() callbacks";
 	else if (searchString == "fitnessEffect")   searchString = "fitnessEffect() callbacks";
 	else if (searchString == "interaction")     searchString = "interaction() callbacks";
 	else if (searchString == "mateChoice")      searchString = "mateChoice() callbacks";
@@ -943,6 +944,12 @@ void QtSLiMTextEdit::updateStatusFieldFromSelection(void)
                 if (!callbackSig) callbackSig = EidosCallSignature_CSP((new EidosFunctionSignature("mutationEffect", nullptr, kEidosValueMaskFloat | kEidosValueMaskSingleton))->AddObject_S("mutationType", gSLiM_MutationType_Class)->AddObject_OS("subpop", gSLiM_Subpopulation_Class, gStaticEidosValueNULLInvisible));
                 signature = callbackSig;
             }
+            else if (callName == "mutationEffects")
+            {
+                static EidosCallSignature_CSP callbackSig = nullptr;
+                if (!callbackSig) callbackSig = EidosCallSignature_CSP((new EidosFunctionSignature("mutationEffects", nullptr, kEidosValueMaskFloat))->AddObject_S("mutationType", gSLiM_MutationType_Class)->AddObject_OS("subpop", gSLiM_Subpopulation_Class, gStaticEidosValueNULLInvisible));
+                signature = callbackSig;
+            }
             else if (callName == "fitnessEffect")
             {
                 static EidosCallSignature_CSP callbackSig = nullptr;
@@ -1956,6 +1963,7 @@ void QtSLiMTextEdit::slimSpecificCompletion(QString completionScriptString, NSRa
                         else if (child_string.compare(gStr_initialize) == 0)		block_type = SLiMEidosBlockType::SLiMEidosInitializeCallback;
                         else if (child_string.compare(gStr_fitnessEffect) == 0)		block_type = SLiMEidosBlockType::SLiMEidosFitnessEffectCallback;
                         else if (child_string.compare(gStr_mutationEffect) == 0)	block_type = SLiMEidosBlockType::SLiMEidosMutationEffectCallback;
+                        else if (child_string.compare(gStr_mutationEffects) == 0)	block_type = SLiMEidosBlockType::SLiMEidosMutationEffectCallback;
                         else if (child_string.compare(gStr_interaction) == 0)		block_type = SLiMEidosBlockType::SLiMEidosInteractionCallback;
                         else if (child_string.compare(gStr_mateChoice) == 0)		block_type = SLiMEidosBlockType::SLiMEidosMateChoiceCallback;
                         else if (child_string.compare(gStr_modifyChild) == 0)		block_type = SLiMEidosBlockType::SLiMEidosModifyChildCallback;
@@ -2214,6 +2222,7 @@ void QtSLiMTextEdit::slimSpecificCompletion(QString completionScriptString, NSRa
     (*keywords) << "early() { }";
     (*keywords) << "late() { }";
     (*keywords) << "mutationEffect() { }";
+    (*keywords) << "mutationEffects() { }";
     (*keywords) << "fitnessEffect() { }";
     (*keywords) << "interaction() { }";
     (*keywords) << "mateChoice() { }";
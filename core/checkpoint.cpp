@@ -0,0 +1,2233 @@
+//
+//  checkpoint.cpp
+//  SLiM
+//
+//  Created on 10/18/26.
+//  Copyright (c) 2026 Philipp Messer.  All rights reserved.
+//	A product of the Messer Lab, http://messerlab.org/slim/
+//
+
+//	This file is part of SLiM.
+//
+//	SLiM is free software: you can redistribute it and/or modify it under the terms of the GNU General Public License as published by
+//	the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+//
+//	SLiM is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+//	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+//
+//	You should have received a copy of the GNU General Public License along with SLiM.  If not, see <http://www.gnu.org/licenses/>.
+
+
+#include "checkpoint.h"
+
+#include <algorithm>
+#include <fstream>
+#include <sstream>
+#include <cstring>
+#include <cstdio>
+#include <unordered_set>
+#include <unistd.h>
+#include <sys/stat.h>
+
+#include "community.h"
+#include "species.h"
+#include "population.h"
+#include "subpopulation.h"
+#include "individual.h"
+#include "genome.h"
+#include "mutation.h"
+#include "mutation_type.h"
+#include "genomic_element.h"
+#include "genomic_element_type.h"
+#include "chromosome.h"
+#include "substitution.h"
+#include "interaction_type.h"
+#include "slim_eidos_block.h"
+#include "log_file.h"
+#include "spatial_map.h"
+#include "eidos_rng.h"
+#include "eidos_interpreter.h"
+#include "eidos_class_Dictionary.h"
+#include "eidos_class_DataFrame.h"
+
+
+// The file header: magic bytes, a format version, and a tag that detects a byte order mismatch; see checkpoint.h
+static const char gSLiM_CheckpointMagic[8] = {'S', 'L', 'i', 'M', 'C', 'K', 'P', 'T'};
+static const uint32_t gSLiM_CheckpointVersion = 1;
+static const uint32_t gSLiM_CheckpointEndianTag = 0x12345678;
+
+// The kinds of object reference written by _WriteObject(); the first group refers to existing SLiM objects by identifier,
+// the last group is written inline (with kBackReference used for later references to an object already written inline)
+enum class SLiMCheckpointRef : uint8_t
+{
+	kCommunity = 0,
+	kSpecies,
+	kMutationType,
+	kGenomicElementType,
+	kGenomicElement,
+	kChromosome,
+	kSubpopulation,
+	kIndividual,
+	kGenome,
+	kMutation,
+	kSubstitution,
+	kInteractionType,
+	kScriptBlock,
+	kLogFile,
+	kBackReference,
+	kDictionary,
+	kDataFrame,
+	kSpatialMap
+};
+
+template <typename T>
+static inline void _AppendCheckpoint(std::string &p_buffer, T p_value)
+{
+	p_buffer.append((const char *)&p_value, sizeof(T));
+}
+
+static inline void _AppendCheckpointString(std::string &p_buffer, const std::string &p_string)
+{
+	_AppendCheckpoint(p_buffer, (uint32_t)p_string.size());
+	p_buffer.append(p_string);
+}
+
+template <typename T>
+static inline void _AppendCheckpointVector(std::string &p_buffer, const std::vector<T> &p_vector)
+{
+	_AppendCheckpoint(p_buffer, (uint64_t)p_vector.size());
+	
+	if (p_vector.size())
+		p_buffer.append((const char *)p_vector.data(), p_vector.size() * sizeof(T));
+}
+
+static void _RaiseForCorruptCheckpoint(void)
+{
+	EIDOS_TERMINATION << "ERROR (SLiMCheckpoint::RestoreState): the checkpoint file is truncated or corrupt." << EidosTerminate();
+}
+
+static inline const char *_ConsumeCheckpoint(const char *&p_ptr, const char *p_end, uint64_t p_length)
+{
+	if (p_length > (uint64_t)(p_end - p_ptr))
+		_RaiseForCorruptCheckpoint();
+	
+	const char *data = p_ptr;
+	
+	p_ptr += p_length;
+	return data;
+}
+
+template <typename T>
+static inline T _ReadCheckpoint(const char *&p_ptr, const char *p_end)
+{
+	T value;
+	
+	memcpy(&value, _ConsumeCheckpoint(p_ptr, p_end, sizeof(T)), sizeof(T));
+	return value;
+}
+
+static inline std::string _ReadCheckpointString(const char *&p_ptr, const char *p_end)
+{
+	uint32_t length = _ReadCheckpoint<uint32_t>(p_ptr, p_end);
+	
+	return std::string(_ConsumeCheckpoint(p_ptr, p_end, length), length);
+}
+
+template <typename T>
+static inline void _ReadCheckpointVector(const char *&p_ptr, const char *p_end, std::vector<T> &p_vector)
+{
+	uint64_t count = _ReadCheckpoint<uint64_t>(p_ptr, p_end);
+	
+	if (count > (uint64_t)(p_end - p_ptr) / sizeof(T))
+		_RaiseForCorruptCheckpoint();
+	
+	p_vector.resize(count);
+	
+	if (count)
+		memcpy(p_vector.data(), _ConsumeCheckpoint(p_ptr, p_end, count * sizeof(T)), count * sizeof(T));
+}
+
+static bool _WriteCheckpointChunk(std::ofstream &p_stream, const char *p_tag, const std::string &p_payload)
+{
+	uint64_t length = p_payload.size();
+	
+	p_stream.write(p_tag, 4);
+	p_stream.write((const char *)&length, sizeof(length));
+	p_stream.write(p_payload.data(), (std::streamsize)length);
+	
+	return !p_stream.fail();
+}
+
+
+#pragma mark -
+#pragma mark SLiMCheckpoint
+#pragma mark -
+
+SLiMCheckpoint::SLiMCheckpoint(Community &p_community, const std::string &p_file_path) : community_(p_community), file_path_(p_file_path)
+{
+}
+
+SLiMCheckpoint::~SLiMCheckpoint(void)
+{
+	// We hold one retain on each object read inline; whoever else kept a reference to it retains it too
+	for (EidosObject *object : read_objects_)
+		static_cast<EidosDictionaryRetained *>(object)->Release();
+	
+	read_objects_.clear();
+}
+
+void SLiMCheckpoint::WriteCheckpoint(Community &p_community, const std::string &p_file_path)
+{
+	SLiMCheckpoint checkpoint(p_community, p_file_path);
+	std::string temp_path = p_file_path + ".tmp";
+	std::ofstream file_stream(temp_path, std::ios_base::out | std::ios_base::trunc | std::ios_base::binary);
+	
+	if (!file_stream.is_open())
+		EIDOS_TERMINATION << "ERROR (SLiMCheckpoint::WriteCheckpoint): could not open checkpoint file at " << p_file_path << " for writing." << EidosTerminate();
+	
+	// The header
+	std::string buffer;
+	
+	buffer.append(gSLiM_CheckpointMagic, sizeof(gSLiM_CheckpointMagic));
+	_AppendCheckpoint(buffer, gSLiM_CheckpointVersion);
+	_AppendCheckpoint(buffer, gSLiM_CheckpointEndianTag);
+	_AppendCheckpointString(buffer, SLIM_VERSION_STRING);
+	_AppendCheckpointString(buffer, p_community.script_->String());
+	file_stream.write(buffer.data(), (std::streamsize)buffer.size());
+	
+	// The chunks, each generated and written in turn
+	bool success = !file_stream.fail();
+	
+	buffer.clear();
+	checkpoint._WriteChunk_CMTY(buffer);
+	success = success && _WriteCheckpointChunk(file_stream, "CMTY", buffer);
+	
+	buffer.clear();
+	checkpoint._WriteChunk_INIT(buffer);
+	success = success && _WriteCheckpointChunk(file_stream, "INIT", buffer);
+	
+	for (Species *species : p_community.all_species_)
+	{
+		buffer.clear();
+		checkpoint._WriteChunk_SPEC(buffer, species);
+		success = success && _WriteCheckpointChunk(file_stream, "SPEC", buffer);
+	}
+	
+	buffer.clear();
+	checkpoint._WriteChunk_BLCK(buffer);
+	success = success && _WriteCheckpointChunk(file_stream, "BLCK", buffer);
+	
+	buffer.clear();
+	checkpoint._WriteChunk_INTR(buffer);
+	success = success && _WriteCheckpointChunk(file_stream, "INTR", buffer);
+	
+	buffer.clear();
+	checkpoint._WriteChunk_LOGF(buffer);
+	success = success && _WriteCheckpointChunk(file_stream, "LOGF", buffer);
+	
+	buffer.clear();
+	checkpoint._WriteChunk_DICT(buffer);
+	success = success && _WriteCheckpointChunk(file_stream, "DICT", buffer);
+	
+	buffer.clear();
+	checkpoint._WriteChunk_GLOB(buffer);
+	success = success && _WriteCheckpointChunk(file_stream, "GLOB", buffer);
+	
+	buffer.clear();
+	Eidos_SaveRNGState(buffer);
+	success = success && _WriteCheckpointChunk(file_stream, "RAND", buffer);
+	
+	buffer.clear();
+	success = success && _WriteCheckpointChunk(file_stream, "END!", buffer);
+	
+	file_stream.close();
+	
+	if (!success || file_stream.fail() || (std::rename(temp_path.c_str(), p_file_path.c_str()) != 0))
+	{
+		std::remove(temp_path.c_str());
+		EIDOS_TERMINATION << "ERROR (SLiMCheckpoint::WriteCheckpoint): could not write checkpoint file at " << p_file_path << "." << EidosTerminate();
+	}
+}
+
+SLiMCheckpoint *SLiMCheckpoint::ReadCheckpoint(Community &p_community, const std::string &p_file_path)
+{
+	SLiMCheckpoint *checkpoint = new SLiMCheckpoint(p_community, p_file_path);
+	std::ifstream file_stream(p_file_path, std::ios_base::in | std::ios_base::binary);
+	
+	if (!file_stream.is_open())
+		EIDOS_TERMINATION << "ERROR (SLiMCheckpoint::ReadCheckpoint): could not read checkpoint file at " << p_file_path << "." << EidosTerminate();
+	
+	std::ostringstream file_contents;
+	
+	file_contents << file_stream.rdbuf();
+	checkpoint->file_data_ = file_contents.str();
+	
+	// Check the header
+	const char *p = checkpoint->file_data_.data();
+	const char *end = p + checkpoint->file_data_.size();
+	
+	if ((checkpoint->file_data_.size() < sizeof(gSLiM_CheckpointMagic) + 2 * sizeof(uint32_t)) || (memcmp(p, gSLiM_CheckpointMagic, sizeof(gSLiM_CheckpointMagic)) != 0))
+		EIDOS_TERMINATION << "ERROR (SLiMCheckpoint::ReadCheckpoint): the file at " << p_file_path << " is not a SLiM checkpoint file." << EidosTerminate();
+	
+	p += sizeof(gSLiM_CheckpointMagic);
+	
+	uint32_t version = _ReadCheckpoint<uint32_t>(p, end);
+	uint32_t endian_tag = _ReadCheckpoint<uint32_t>(p, end);
+	
+	if (endian_tag != gSLiM_CheckpointEndianTag)
+		EIDOS_TERMINATION << "ERROR (SLiMCheckpoint::ReadCheckpoint): the checkpoint file at " << p_file_path << " was written on a machine with a different byte order." << EidosTerminate();
+	if (version != gSLiM_CheckpointVersion)
+		EIDOS_TERMINATION << "ERROR (SLiMCheckpoint::ReadCheckpoint): the checkpoint file at " << p_file_path << " has an unsupported format version (" << version << ")." << EidosTerminate();
+	
+	std::string slim_version = _ReadCheckpointString(p, end);
+	
+	if (slim_version != SLIM_VERSION_STRING)
+		EIDOS_TERMINATION << "ERROR (SLiMCheckpoint::ReadCheckpoint): the checkpoint file at " << p_file_path << " was written by SLiM " << slim_version << "; checkpoints can be restored only by the SLiM version that wrote them (" << SLIM_VERSION_STRING << ")." << EidosTerminate();
+	
+	std::string script_string = _ReadCheckpointString(p, end);
+	
+	if (script_string != p_community.script_->String())
+		EIDOS_TERMINATION << "ERROR (SLiMCheckpoint::ReadCheckpoint): the checkpoint file at " << p_file_path << " was written by a different script; a checkpoint can be restored only with the exact script that wrote it." << EidosTerminate();
+	
+	// Find the chunks; the file must end with an END! chunk, or it is incomplete
+	bool found_end = false;
+	
+	while (p < end)
+	{
+		std::string tag(_ConsumeCheckpoint(p, end, 4), 4);
+		uint64_t length = _ReadCheckpoint<uint64_t>(p, end);
+		const char *payload = _ConsumeCheckpoint(p, end, length);
+		
+		if (tag == "END!")
+		{
+			found_end = true;
+			break;
+		}
+		
+		checkpoint->chunks_.emplace_back(tag, std::pair<const char *, const char *>(payload, payload + length));
+	}
+	
+	if (!found_end)
+		EIDOS_TERMINATION << "ERROR (SLiMCheckpoint::ReadCheckpoint): the checkpoint file at " << p_file_path << " is incomplete." << EidosTerminate();
+	
+	checkpoint->init_ptr_ = checkpoint->_ChunkPayload("INIT", 0, &checkpoint->init_end_);
+	
+	return checkpoint;
+}
+
+const char *SLiMCheckpoint::_ChunkPayload(const std::string &p_tag, int p_occurrence, const char **p_end)
+{
+	for (auto &chunk : chunks_)
+	{
+		if ((chunk.first == p_tag) && (p_occurrence-- == 0))
+		{
+			*p_end = chunk.second.second;
+			return chunk.second.first;
+		}
+	}
+	
+	EIDOS_TERMINATION << "ERROR (SLiMCheckpoint::RestoreState): the checkpoint file at " << file_path_ << " is missing a " << p_tag << " chunk." << EidosTerminate();
+}
+
+
+#pragma mark -
+#pragma mark Values and object references
+#pragma mark -
+
+void SLiMCheckpoint::_WriteValue(std::string &p_buffer, const EidosValue *p_value)
+{
+	EidosValueType value_type = p_value->Type();
+	
+	_AppendCheckpoint(p_buffer, (uint8_t)value_type);
+	
+	if ((value_type == EidosValueType::kValueVOID) || (value_type == EidosValueType::kValueNULL))
+		return;
+	
+	int count = p_value->Count();
+	int dim_count = p_value->DimensionCount();
+	
+	_AppendCheckpoint(p_buffer, (uint64_t)count);
+	_AppendCheckpoint(p_buffer, (int32_t)dim_count);
+	
+	if (dim_count > 1)
+		p_buffer.append((const char *)p_value->Dimensions(), dim_count * sizeof(int64_t));
+	
+	if (count == 0)
+	{
+		// the class of an empty object vector still matters
+		if (value_type == EidosValueType::kValueObject)
+			_AppendCheckpointString(p_buffer, ((const EidosValue_Object *)p_value)->Class()->ClassName());
+		return;
+	}
+	
+	switch (value_type)
+	{
+		case EidosValueType::kValueLogical:
+			p_buffer.append((const char *)p_value->LogicalData(), count * sizeof(eidos_logical_t));
+			break;
+		case EidosValueType::kValueInt:
+			p_buffer.append((const char *)p_value->IntData(), count * sizeof(int64_t));
+			break;
+		case EidosValueType::kValueFloat:
+			p_buffer.append((const char *)p_value->FloatData(), count * sizeof(double));
+			break;
+		case EidosValueType::kValueString:
+		{
+			const std::string *string_data = p_value->StringData();
+			
+			for (int index = 0; index < count; ++index)
+				_AppendCheckpointString(p_buffer, string_data[index]);
+			break;
+		}
+		case EidosValueType::kValueObject:
+		{
+			EidosObject * const *object_data = p_value->ObjectData();
+			
+			_AppendCheckpointString(p_buffer, ((const EidosValue_Object *)p_value)->Class()->ClassName());
+			
+			for (int index = 0; index < count; ++index)
+				_WriteObject(p_buffer, object_data[index]);
+			break;
+		}
+		default:
+			break;
+	}
+}
+
+EidosValue_SP SLiMCheckpoint::_ReadValue(const char *&p_ptr, const char *p_end)
+{
+	EidosValueType value_type = (EidosValueType)_ReadCheckpoint<uint8_t>(p_ptr, p_end);
+	
+	if (value_type == EidosValueType::kValueVOID)
+		return gStaticEidosValueVOID;
+	if (value_type == EidosValueType::kValueNULL)
+		return gStaticEidosValueNULL;
+	
+	uint64_t count = _ReadCheckpoint<uint64_t>(p_ptr, p_end);
+	int32_t dim_count = _ReadCheckpoint<int32_t>(p_ptr, p_end);
+	std::vector<int64_t> dims;
+	
+	if (count > (uint64_t)(p_end - p_ptr))		// every element takes at least one byte
+		_RaiseForCorruptCheckpoint();
+	
+	if (dim_count > 1)
+	{
+		dims.resize(dim_count);
+		memcpy(dims.data(), _ConsumeCheckpoint(p_ptr, p_end, dim_count * sizeof(int64_t)), dim_count * sizeof(int64_t));
+	}
+	
+	EidosValue_SP result_SP;
+	
+	switch (value_type)
+	{
+		case EidosValueType::kValueLogical:
+		{
+			const eidos_logical_t *data = (const eidos_logical_t *)_ConsumeCheckpoint(p_ptr, p_end, count * sizeof(eidos_logical_t));
+			
+			result_SP = EidosValue_SP(new (gEidosValuePool->AllocateChunk()) EidosValue_Logical(data, count));
+			break;
+		}
+		case EidosValueType::kValueInt:
+		{
+			std::vector<int64_t> values(count);
+			
+			if (count)
+				memcpy(values.data(), _ConsumeCheckpoint(p_ptr, p_end, count * sizeof(int64_t)), count * sizeof(int64_t));
+			
+			result_SP = EidosValue_SP(new (gEidosValuePool->AllocateChunk()) EidosValue_Int(values.data(), count));
+			break;
+		}
+		case EidosValueType::kValueFloat:
+		{
+			std::vector<double> values(count);
+			
+			if (count)
+				memcpy(values.data(), _ConsumeCheckpoint(p_ptr, p_end, count * sizeof(double)), count * sizeof(double));
+			
+			result_SP = EidosValue_SP(new (gEidosValuePool->AllocateChunk()) EidosValue_Float(values.data(), count));
+			break;
+		}
+		case EidosValueType::kValueString:
+		{
+			EidosValue_String *string_result = new (gEidosValuePool->AllocateChunk()) EidosValue_String();
+			
+			result_SP = EidosValue_SP(string_result);
+			
+			for (uint64_t index = 0; index < count; ++index)
+				string_result->PushString(_ReadCheckpointString(p_ptr, p_end));
+			break;
+		}
+		case EidosValueType::kValueObject:
+		{
+			std::string class_name = _ReadCheckpointString(p_ptr, p_end);
+			const EidosClass *object_class = nullptr;
+			
+			for (EidosClass *registered_class : EidosClass::RegisteredClasses(true, true))
+				if (registered_class->ClassName() == class_name)
+				{
+					object_class = registered_class;
+					break;
+				}
+			
+			if (!object_class)
+				_RaiseForCorruptCheckpoint();
+			
+			std::vector<EidosObject *> objects;
+			
+			for (uint64_t index = 0; index < count; ++index)
+				objects.emplace_back(_ReadObject(p_ptr, p_end));
+			
+			result_SP = EidosValue_SP(new (gEidosValuePool->AllocateChunk()) EidosValue_Object(objects, object_class));
+			break;
+		}
+		default:
+			_RaiseForCorruptCheckpoint();
+	}
+	
+	if (dim_count > 1)
+		result_SP->SetDimensions(dim_count, dims.data());
+	
+	return result_SP;
+}
+
+void SLiMCheckpoint::_WriteObject(std::string &p_buffer, EidosObject *p_object)
+{
+	const EidosClass *object_class = p_object->Class();
+	
+	if (object_class == gSLiM_Community_Class)
+	{
+		_AppendCheckpoint(p_buffer, SLiMCheckpointRef::kCommunity);
+	}
+	else if (object_class == gSLiM_Species_Class)
+	{
+		_AppendCheckpoint(p_buffer, SLiMCheckpointRef::kSpecies);
+		_AppendCheckpoint(p_buffer, (int32_t)((Species *)p_object)->species_id_);
+	}
+	else if (object_class == gSLiM_MutationType_Class)
+	{
+		_AppendCheckpoint(p_buffer, SLiMCheckpointRef::kMutationType);
+		_AppendCheckpoint(p_buffer, (int32_t)((MutationType *)p_object)->mutation_type_id_);
+	}
+	else if (object_class == gSLiM_GenomicElementType_Class)
+	{
+		_AppendCheckpoint(p_buffer, SLiMCheckpointRef::kGenomicElementType);
+		_AppendCheckpoint(p_buffer, (int32_t)((GenomicElementType *)p_object)->genomic_element_type_id_);
+	}
+	else if (object_class == gSLiM_GenomicElement_Class)
+	{
+		GenomicElement *element = (GenomicElement *)p_object;
+		Species &species = element->genomic_element_type_ptr_->species_;
+		std::vector<GenomicElement *> &elements = species.TheChromosome().GenomicElements();
+		
+		_AppendCheckpoint(p_buffer, SLiMCheckpointRef::kGenomicElement);
+		_AppendCheckpoint(p_buffer, (int32_t)species.species_id_);
+		_AppendCheckpoint(p_buffer, (uint64_t)(std::find(elements.begin(), elements.end(), element) - elements.begin()));
+	}
+	else if (object_class == gSLiM_Chromosome_Class)
+	{
+		_AppendCheckpoint(p_buffer, SLiMCheckpointRef::kChromosome);
+		_AppendCheckpoint(p_buffer, (int32_t)((Chromosome *)p_object)->species_.species_id_);
+	}
+	else if (object_class == gSLiM_Subpopulation_Class)
+	{
+		Subpopulation *subpop = (Subpopulation *)p_object;
+		
+		if (subpop->has_been_removed_)
+			EIDOS_TERMINATION << "ERROR (SLiMCheckpoint::WriteCheckpoint): a reference to a removed subpopulation cannot be saved in a checkpoint." << EidosTerminate();
+		
+		_AppendCheckpoint(p_buffer, SLiMCheckpointRef::kSubpopulation);
+		_AppendCheckpoint(p_buffer, (int32_t)subpop->subpopulation_id_);
+	}
+	else if (object_class == gSLiM_Individual_Class)
+	{
+		Individual *individual = (Individual *)p_object;
+		Subpopulation *subpop = individual->subpopulation_;
+		
+		if ((individual->index_ < 0) || (individual->index_ >= subpop->parent_subpop_size_) || (subpop->parent_individuals_[individual->index_] != individual))
+			EIDOS_TERMINATION << "ERROR (SLiMCheckpoint::WriteCheckpoint): a reference to an individual that is no longer in the population cannot be saved in a checkpoint." << EidosTerminate();
+		
+		_AppendCheckpoint(p_buffer, SLiMCheckpointRef::kIndividual);
+		_AppendCheckpoint(p_buffer, (int32_t)subpop->subpopulation_id_);
+		_AppendCheckpoint(p_buffer, (int32_t)individual->index_);
+	}
+	else if (object_class == gSLiM_Genome_Class)
+	{
+		Genome *genome = (Genome *)p_object;
+		Individual *individual = genome->OwningIndividual();
+		Subpopulation *subpop = individual->subpopulation_;
+		
+		if ((individual->index_ < 0) || (individual->index_ >= subpop->parent_subpop_size_) || (subpop->parent_individuals_[individual->index_] != individual))
+			EIDOS_TERMINATION << "ERROR (SLiMCheckpoint::WriteCheckpoint): a reference to a genome that is no longer in the population cannot be saved in a checkpoint." << EidosTerminate();
+		
+		_AppendCheckpoint(p_buffer, SLiMCheckpointRef::kGenome);
+		_AppendCheckpoint(p_buffer, (int32_t)subpop->subpopulation_id_);
+		_AppendCheckpoint(p_buffer, (int32_t)individual->index_);
+		_AppendCheckpoint(p_buffer, (uint8_t)(genome == individual->genome1_ ? 0 : 1));
+	}
+	else if (object_class == gSLiM_Mutation_Class)
+	{
+		Mutation *mutation = (Mutation *)p_object;
+		
+		if (mutation->state_ != MutationState::kInRegistry)
+			EIDOS_TERMINATION << "ERROR (SLiMCheckpoint::WriteCheckpoint): a reference to a mutation that is no longer segregating cannot be saved in a checkpoint." << EidosTerminate();
+		
+		_AppendCheckpoint(p_buffer, SLiMCheckpointRef::kMutation);
+		_AppendCheckpoint(p_buffer, (int32_t)mutation->mutation_type_ptr_->species_.species_id_);
+		_AppendCheckpoint(p_buffer, (int64_t)mutation->mutation_id_);
+	}
+	else if (object_class == gSLiM_Substitution_Class)
+	{
+		Substitution *substitution = (Substitution *)p_object;
+		Species &species = substitution->mutation_type_ptr_->species_;
+		
+		if (substitution_lookup_.empty())
+			for (Species *lookup_species : community_.all_species_)
+				for (size_t index = 0; index < lookup_species->population_.substitutions_.size(); ++index)
+					substitution_lookup_.emplace(lookup_species->population_.substitutions_[index], index);
+		
+		auto lookup_iter = substitution_lookup_.find(substitution);
+		
+		if (lookup_iter == substitution_lookup_.end())
+			EIDOS_TERMINATION << "ERROR (SLiMCheckpoint::WriteCheckpoint): (internal error) substitution not found." << EidosTerminate();
+		
+		_AppendCheckpoint(p_buffer, SLiMCheckpointRef::kSubstitution);
+		_AppendCheckpoint(p_buffer, (int32_t)species.species_id_);
+		_AppendCheckpoint(p_buffer, (uint64_t)lookup_iter->second);
+	}
+	else if (object_class == gSLiM_InteractionType_Class)
+	{
+		_AppendCheckpoint(p_buffer, SLiMCheckpointRef::kInteractionType);
+		_AppendCheckpoint(p_buffer, (int32_t)((InteractionType *)p_object)->interaction_type_id_);
+	}
+	else if (object_class == gSLiM_SLiMEidosBlock_Class)
+	{
+		std::vector<SLiMEidosBlock *> &blocks = community_.script_blocks_;
+		auto block_iter = std::find(blocks.begin(), blocks.end(), (SLiMEidosBlock *)p_object);
+		
+		if (block_iter == blocks.end())
+			EIDOS_TERMINATION << "ERROR (SLiMCheckpoint::WriteCheckpoint): a reference to a deregistered script block cannot be saved in a checkpoint." << EidosTerminate();
+		
+		_AppendCheckpoint(p_buffer, SLiMCheckpointRef::kScriptBlock);
+		_AppendCheckpoint(p_buffer, (uint32_t)(block_iter - blocks.begin()));
+	}
+	else if (object_class == gSLiM_LogFile_Class)
+	{
+		std::vector<LogFile *> &log_files = community_.log_file_registry_;
+		auto log_iter = std::find(log_files.begin(), log_files.end(), (LogFile *)p_object);
+		
+		if (log_iter == log_files.end())
+			EIDOS_TERMINATION << "ERROR (SLiMCheckpoint::WriteCheckpoint): (internal error) LogFile not found." << EidosTerminate();
+		
+		_AppendCheckpoint(p_buffer, SLiMCheckpointRef::kLogFile);
+		_AppendCheckpoint(p_buffer, (uint32_t)(log_iter - log_files.begin()));
+	}
+	else if ((object_class == gEidosDictionaryRetained_Class) || (object_class == gEidosDataFrame_Class) || (object_class == gSLiM_SpatialMap_Class))
+	{
+		// Objects written inline are written once; later references to them refer back to the first
+		auto written_iter = written_objects_.find(p_object);
+		
+		if (written_iter != written_objects_.end())
+		{
+			_AppendCheckpoint(p_buffer, SLiMCheckpointRef::kBackReference);
+			_AppendCheckpoint(p_buffer, written_iter->second);
+			return;
+		}
+		
+		written_objects_.emplace(p_object, (uint32_t)written_objects_.size());
+		
+		if (object_class == gSLiM_SpatialMap_Class)
+		{
+			SpatialMap *map = (SpatialMap *)p_object;
+			
+			_AppendCheckpoint(p_buffer, SLiMCheckpointRef::kSpatialMap);
+			_AppendCheckpointString(p_buffer, map->name_);
+			_AppendCheckpoint(p_buffer, (int64_t)map->tag_value_);
+			_AppendCheckpointString(p_buffer, map->spatiality_string_);
+			_AppendCheckpoint(p_buffer, (int32_t)map->spatiality_);
+			_AppendCheckpoint(p_buffer, (int32_t)map->spatiality_type_);
+			_AppendCheckpoint(p_buffer, (uint8_t)map->periodic_a_);
+			_AppendCheckpoint(p_buffer, (uint8_t)map->periodic_b_);
+			_AppendCheckpoint(p_buffer, (uint8_t)map->periodic_c_);
+			_AppendCheckpoint(p_buffer, (int32_t)map->required_dimensionality_);
+			_AppendCheckpoint(p_buffer, map->bounds_a0_);
+			_AppendCheckpoint(p_buffer, map->bounds_a1_);
+			_AppendCheckpoint(p_buffer, map->bounds_b0_);
+			_AppendCheckpoint(p_buffer, map->bounds_b1_);
+			_AppendCheckpoint(p_buffer, map->bounds_c0_);
+			_AppendCheckpoint(p_buffer, map->bounds_c1_);
+			_AppendCheckpoint(p_buffer, map->grid_size_[0]);
+			_AppendCheckpoint(p_buffer, map->grid_size_[1]);
+			_AppendCheckpoint(p_buffer, map->grid_size_[2]);
+			_AppendCheckpoint(p_buffer, map->values_size_);
+			p_buffer.append((const char *)map->values_, map->values_size_ * sizeof(double));
+			_AppendCheckpoint(p_buffer, (uint8_t)map->interpolate_);
+			_AppendCheckpoint(p_buffer, map->values_min_);
+			_AppendCheckpoint(p_buffer, map->values_max_);
+			_AppendCheckpoint(p_buffer, (int32_t)map->n_colors_);
+			_AppendCheckpoint(p_buffer, map->colors_min_);
+			_AppendCheckpoint(p_buffer, map->colors_max_);
+			
+			if (map->n_colors_ > 0)
+			{
+				p_buffer.append((const char *)map->red_components_, map->n_colors_ * sizeof(float));
+				p_buffer.append((const char *)map->green_components_, map->n_colors_ * sizeof(float));
+				p_buffer.append((const char *)map->blue_components_, map->n_colors_ * sizeof(float));
+			}
+		}
+		else
+		{
+			_AppendCheckpoint(p_buffer, (object_class == gEidosDataFrame_Class) ? SLiMCheckpointRef::kDataFrame : SLiMCheckpointRef::kDictionary);
+		}
+		
+		_WriteDictionary(p_buffer, (EidosDictionaryUnretained *)(EidosDictionaryRetained *)p_object);
+	}
+	else
+	{
+		EIDOS_TERMINATION << "ERROR (SLiMCheckpoint::WriteCheckpoint): an object of class " << object_class->ClassName() << " cannot be saved in a checkpoint." << EidosTerminate();
+	}
+}
+
+EidosObject *SLiMCheckpoint::_ReadObject(const char *&p_ptr, const char *p_end)
+{
+	SLiMCheckpointRef ref_type = _ReadCheckpoint<SLiMCheckpointRef>(p_ptr, p_end);
+	EidosObject *object = nullptr;
+	
+	switch (ref_type)
+	{
+		case SLiMCheckpointRef::kCommunity:
+			object = &community_;
+			break;
+		case SLiMCheckpointRef::kSpecies:
+		{
+			int32_t species_id = _ReadCheckpoint<int32_t>(p_ptr, p_end);
+			
+			if ((species_id >= 0) && (species_id < (int32_t)community_.all_species_.size()))
+				object = community_.all_species_[species_id];
+			break;
+		}
+		case SLiMCheckpointRef::kMutationType:
+		{
+			// this is used while initialize...() calls are replayed, before Community knows the mutation types, so we ask each species
+			int32_t muttype_id = _ReadCheckpoint<int32_t>(p_ptr, p_end);
+			
+			for (Species *species : community_.all_species_)
+				if ((object = species->MutationTypeWithID(muttype_id)))
+					break;
+			break;
+		}
+		case SLiMCheckpointRef::kGenomicElementType:
+		{
+			int32_t getype_id = _ReadCheckpoint<int32_t>(p_ptr, p_end);
+			
+			for (Species *species : community_.all_species_)
+				if ((object = species->GenomicElementTypeWithID(getype_id)))
+					break;
+			break;
+		}
+		case SLiMCheckpointRef::kGenomicElement:
+		{
+			int32_t species_id = _ReadCheckpoint<int32_t>(p_ptr, p_end);
+			uint64_t element_index = _ReadCheckpoint<uint64_t>(p_ptr, p_end);
+			
+			if ((species_id >= 0) && (species_id < (int32_t)community_.all_species_.size()))
+			{
+				std::vector<GenomicElement *> &elements = community_.all_species_[species_id]->TheChromosome().GenomicElements();
+				
+				if (element_index < elements.size())
+					object = elements[element_index];
+			}
+			break;
+		}
+		case SLiMCheckpointRef::kChromosome:
+		{
+			int32_t species_id = _ReadCheckpoint<int32_t>(p_ptr, p_end);
+			
+			if ((species_id >= 0) && (species_id < (int32_t)community_.all_species_.size()))
+				object = &community_.all_species_[species_id]->TheChromosome();
+			break;
+		}
+		case SLiMCheckpointRef::kSubpopulation:
+			object = community_.SubpopulationWithID(_ReadCheckpoint<int32_t>(p_ptr, p_end));
+			break;
+		case SLiMCheckpointRef::kIndividual:
+		case SLiMCheckpointRef::kGenome:
+		{
+			Subpopulation *subpop = community_.SubpopulationWithID(_ReadCheckpoint<int32_t>(p_ptr, p_end));
+			int32_t individual_index = _ReadCheckpoint<int32_t>(p_ptr, p_end);
+			
+			if (subpop && (individual_index >= 0) && (individual_index < subpop->parent_subpop_size_))
+			{
+				Individual *individual = subpop->parent_individuals_[individual_index];
+				
+				if (ref_type == SLiMCheckpointRef::kIndividual)
+					object = individual;
+				else
+					object = (_ReadCheckpoint<uint8_t>(p_ptr, p_end) == 0) ? individual->genome1_ : individual->genome2_;
+			}
+			break;
+		}
+		case SLiMCheckpointRef::kMutation:
+		{
+			int32_t species_id = _ReadCheckpoint<int32_t>(p_ptr, p_end);
+			slim_mutationid_t mutation_id = _ReadCheckpoint<int64_t>(p_ptr, p_end);
+			
+			if (mutation_id_lookup_.empty())
+			{
+				mutation_id_lookup_.resize(community_.all_species_.size());
+				
+				for (Species *species : community_.all_species_)
+				{
+					MutationRun &registry = species->population_.mutation_registry_;
+					const MutationIndex *registry_iter = registry.begin_pointer_const();
+					const MutationIndex *registry_end = registry.end_pointer_const();
+					
+					for (; registry_iter != registry_end; ++registry_iter)
+					{
+						Mutation *mutation = gSLiM_Mutation_Block + *registry_iter;
+						
+						mutation_id_lookup_[species->species_id_].emplace(mutation->mutation_id_, mutation);
+					}
+				}
+			}
+			
+			if ((species_id >= 0) && (species_id < (int32_t)mutation_id_lookup_.size()))
+			{
+				auto mutation_iter = mutation_id_lookup_[species_id].find(mutation_id);
+				
+				if (mutation_iter != mutation_id_lookup_[species_id].end())
+					object = mutation_iter->second;
+			}
+			break;
+		}
+		case SLiMCheckpointRef::kSubstitution:
+		{
+			int32_t species_id = _ReadCheckpoint<int32_t>(p_ptr, p_end);
+			uint64_t substitution_index = _ReadCheckpoint<uint64_t>(p_ptr, p_end);
+			
+			if ((species_id >= 0) && (species_id < (int32_t)community_.all_species_.size()))
+			{
+				std::vector<Substitution *> &substitutions = community_.all_species_[species_id]->population_.substitutions_;
+				
+				if (substitution_index < substitutions.size())
+					object = substitutions[substitution_index];
+			}
+			break;
+		}
+		case SLiMCheckpointRef::kInteractionType:
+			object = community_.InteractionTypeWithID(_ReadCheckpoint<int32_t>(p_ptr, p_end));
+			break;
+		case SLiMCheckpointRef::kScriptBlock:
+		{
+			uint32_t block_index = _ReadCheckpoint<uint32_t>(p_ptr, p_end);
+			
+			if (block_index < community_.script_blocks_.size())
+				object = community_.script_blocks_[block_index];
+			break;
+		}
+		case SLiMCheckpointRef::kLogFile:
+		{
+			uint32_t log_index = _ReadCheckpoint<uint32_t>(p_ptr, p_end);
+			
+			if (log_index < community_.log_file_registry_.size())
+				object = community_.log_file_registry_[log_index];
+			break;
+		}
+		case SLiMCheckpointRef::kBackReference:
+		{
+			uint32_t object_index = _ReadCheckpoint<uint32_t>(p_ptr, p_end);
+			
+			if (object_index < read_objects_.size())
+				object = read_objects_[object_index];
+			break;
+		}
+		case SLiMCheckpointRef::kDictionary:
+		case SLiMCheckpointRef::kDataFrame:
+		{
+			EidosDictionaryRetained *dictionary = (ref_type == SLiMCheckpointRef::kDataFrame) ? new EidosDataFrame() : new EidosDictionaryRetained();
+			
+			// register the object before reading its contents, which might refer back to it
+			read_objects_.emplace_back(dictionary);
+			_ReadDictionary(p_ptr, p_end, dictionary);
+			object = dictionary;
+			break;
+		}
+		case SLiMCheckpointRef::kSpatialMap:
+		{
+			SpatialMap *map = new SpatialMap(_ReadCheckpointString(p_ptr, p_end));
+			
+			read_objects_.emplace_back(map);
+			
+			map->tag_value_ = _ReadCheckpoint<int64_t>(p_ptr, p_end);
+			map->spatiality_string_ = _ReadCheckpointString(p_ptr, p_end);
+			map->spatiality_ = _ReadCheckpoint<int32_t>(p_ptr, p_end);
+			map->spatiality_type_ = _ReadCheckpoint<int32_t>(p_ptr, p_end);
+			map->periodic_a_ = _ReadCheckpoint<uint8_t>(p_ptr, p_end);
+			map->periodic_b_ = _ReadCheckpoint<uint8_t>(p_ptr, p_end);
+			map->periodic_c_ = _ReadCheckpoint<uint8_t>(p_ptr, p_end);
+			map->required_dimensionality_ = _ReadCheckpoint<int32_t>(p_ptr, p_end);
+			map->bounds_a0_ = _ReadCheckpoint<double>(p_ptr, p_end);
+			map->bounds_a1_ = _ReadCheckpoint<double>(p_ptr, p_end);
+			map->bounds_b0_ = _ReadCheckpoint<double>(p_ptr, p_end);
+			map->bounds_b1_ = _ReadCheckpoint<double>(p_ptr, p_end);
+			map->bounds_c0_ = _ReadCheckpoint<double>(p_ptr, p_end);
+			map->bounds_c1_ = _ReadCheckpoint<double>(p_ptr, p_end);
+			map->grid_size_[0] = _ReadCheckpoint<int64_t>(p_ptr, p_end);
+			map->grid_size_[1] = _ReadCheckpoint<int64_t>(p_ptr, p_end);
+			map->grid_size_[2] = _ReadCheckpoint<int64_t>(p_ptr, p_end);
+			map->values_size_ = _ReadCheckpoint<int64_t>(p_ptr, p_end);
+			
+			if ((map->values_size_ < 0) || ((uint64_t)map->values_size_ > (uint64_t)(p_end - p_ptr) / sizeof(double)))
+				_RaiseForCorruptCheckpoint();
+			
+			map->values_ = (double *)malloc(std::max((int64_t)1, map->values_size_) * sizeof(double));
+			if (!map->values_)
+				EIDOS_TERMINATION << "ERROR (SLiMCheckpoint::RestoreState): allocation failed; you may need to raise the memory limit for SLiM." << EidosTerminate();
+			memcpy(map->values_, _ConsumeCheckpoint(p_ptr, p_end, map->values_size_ * sizeof(double)), map->values_size_ * sizeof(double));
+			
+			map->interpolate_ = _ReadCheckpoint<uint8_t>(p_ptr, p_end);
+			map->values_min_ = _ReadCheckpoint<double>(p_ptr, p_end);
+			map->values_max_ = _ReadCheckpoint<double>(p_ptr, p_end);
+			map->n_colors_ = _ReadCheckpoint<int32_t>(p_ptr, p_end);
+			map->colors_min_ = _ReadCheckpoint<double>(p_ptr, p_end);
+			map->colors_max_ = _ReadCheckpoint<double>(p_ptr, p_end);
+			
+			if (map->n_colors_ < 0)
+				_RaiseForCorruptCheckpoint();
+			
+			if (map->n_colors_ > 0)
+			{
+				size_t color_bytes = map->n_colors_ * sizeof(float);
+				
+				map->red_components_ = (float *)malloc(color_bytes);
+				map->green_components_ = (float *)malloc(color_bytes);
+				map->blue_components_ = (float *)malloc(color_bytes);
+				if (!map->red_components_ || !map->green_components_ || !map->blue_components_)
+					EIDOS_TERMINATION << "ERROR (SLiMCheckpoint::RestoreState): allocation failed; you may need to raise the memory limit for SLiM." << EidosTerminate();
+				
+				memcpy(map->red_components_, _ConsumeCheckpoint(p_ptr, p_end, color_bytes), color_bytes);
+				memcpy(map->green_components_, _ConsumeCheckpoint(p_ptr, p_end, color_bytes), color_bytes);
+				memcpy(map->blue_components_, _ConsumeCheckpoint(p_ptr, p_end, color_bytes), color_bytes);
+			}
+			
+			_ReadDictionary(p_ptr, p_end, map);
+			object = map;
+			break;
+		}
+	}
+	
+	if (!object)
+		_RaiseForCorruptCheckpoint();
+	
+	return object;
+}
+
+void SLiMCheckpoint::_WriteDictionary(std::string &p_buffer, EidosDictionaryUnretained *p_dictionary)
+{
+	bool keys_are_strings = p_dictionary->KeysAreStrings();
+	
+	_AppendCheckpoint(p_buffer, (uint8_t)keys_are_strings);
+	_AppendCheckpoint(p_buffer, (uint32_t)p_dictionary->KeyCount());
+	
+	// keys are written in sorted order (or column order, for DataFrame), which reading them back in preserves
+	if (keys_are_strings)
+	{
+		for (const std::string &key : p_dictionary->SortedKeys_StringKeys())
+		{
+			_AppendCheckpointString(p_buffer, key);
+			_WriteValue(p_buffer, p_dictionary->GetValueForKey_StringKeys(key).get());
+		}
+	}
+	else
+	{
+		for (int64_t key : p_dictionary->SortedKeys_IntegerKeys())
+		{
+			_AppendCheckpoint(p_buffer, key);
+			_WriteValue(p_buffer, p_dictionary->GetValueForKey_IntegerKeys(key).get());
+		}
+	}
+}
+
+void SLiMCheckpoint::_ReadDictionary(const char *&p_ptr, const char *p_end, EidosDictionaryUnretained *p_dictionary)
+{
+	bool keys_are_strings = _ReadCheckpoint<uint8_t>(p_ptr, p_end);
+	uint32_t key_count = _ReadCheckpoint<uint32_t>(p_ptr, p_end);
+	
+	for (uint32_t key_index = 0; key_index < key_count; ++key_index)
+	{
+		if (keys_are_strings)
+		{
+			std::string key = _ReadCheckpointString(p_ptr, p_end);
+			
+			p_dictionary->SetKeyValue_StringKeys(key, _ReadValue(p_ptr, p_end));
+		}
+		else
+		{
+			int64_t key = _ReadCheckpoint<int64_t>(p_ptr, p_end);
+			
+			p_dictionary->SetKeyValue_IntegerKeys(key, _ReadValue(p_ptr, p_end));
+		}
+	}
+}
+
+
+#pragma mark -
+#pragma mark Writing chunks
+#pragma mark -
+
+void SLiMCheckpoint::_WriteChunk_CMTY(std::string &p_buffer)
+{
+	_AppendCheckpoint(p_buffer, (int32_t)community_.tick_);
+	_AppendCheckpoint(p_buffer, (int32_t)community_.tick_start_);
+	_AppendCheckpoint(p_buffer, (uint64_t)community_.original_seed_);
+	_AppendCheckpoint(p_buffer, (int64_t)community_.tag_value_);
+	_AppendCheckpoint(p_buffer, (uint8_t)community_.model_type_);
+	_AppendCheckpoint(p_buffer, (uint8_t)community_.all_tick_ranges_evaluated_);
+	
+	_AppendCheckpoint(p_buffer, (uint8_t)community_.warned_early_mutation_add_);
+	_AppendCheckpoint(p_buffer, (uint8_t)community_.warned_early_mutation_remove_);
+	_AppendCheckpoint(p_buffer, (uint8_t)community_.warned_early_output_);
+	_AppendCheckpoint(p_buffer, (uint8_t)community_.warned_early_read_);
+	_AppendCheckpoint(p_buffer, (uint8_t)community_.warned_no_max_distance_);
+	_AppendCheckpoint(p_buffer, (uint8_t)community_.warned_readFromVCF_mutIDs_unused_);
+	_AppendCheckpoint(p_buffer, (uint8_t)community_.warned_no_ancestry_read_);
+	
+	_AppendCheckpoint(p_buffer, (uint8_t)Individual::s_any_individual_color_set_);
+	_AppendCheckpoint(p_buffer, (uint8_t)Individual::s_any_individual_dictionary_set_);
+	_AppendCheckpoint(p_buffer, (uint8_t)Individual::s_any_individual_tag_set_);
+	_AppendCheckpoint(p_buffer, (uint8_t)Individual::s_any_individual_tagF_set_);
+	_AppendCheckpoint(p_buffer, (uint8_t)Individual::s_any_individual_tagL_set_);
+	_AppendCheckpoint(p_buffer, (uint8_t)Individual::s_any_genome_tag_set_);
+	_AppendCheckpoint(p_buffer, (uint8_t)Individual::s_any_individual_fitness_scaling_set_);
+	
+	_AppendCheckpoint(p_buffer, (int64_t)gSLiM_next_pedigree_id);
+	_AppendCheckpoint(p_buffer, (int64_t)gSLiM_next_mutation_id);
+	
+	_AppendCheckpoint(p_buffer, (uint32_t)community_.all_species_.size());
+	
+	for (Species *species : community_.all_species_)
+		_AppendCheckpointString(p_buffer, species->name_);
+}
+
+void SLiMCheckpoint::_WriteChunk_INIT(std::string &p_buffer)
+{
+	for (SLiMInitializeCall &call : community_.initialize_calls_)
+	{
+		_AppendCheckpoint(p_buffer, (int32_t)call.species_id_);
+		_AppendCheckpointString(p_buffer, call.function_name_);
+		
+		if (call.function_name_ == gStr_initializeAncestralNucleotides)
+		{
+			// the sequence is saved with the population, so only its length is needed to replay this call
+			NucleotideArray *ancestral_sequence = community_.all_species_[call.species_id_]->TheChromosome().AncestralSequence();
+			EidosValue_SP length_value(new (gEidosValuePool->AllocateChunk()) EidosValue_Int((int64_t)(ancestral_sequence ? ancestral_sequence->size() : 1)));
+			
+			_AppendCheckpoint(p_buffer, (uint32_t)1);
+			_WriteValue(p_buffer, length_value.get());
+		}
+		else
+		{
+			_AppendCheckpoint(p_buffer, (uint32_t)call.arguments_.size());
+			
+			for (EidosValue_SP &argument : call.arguments_)
+				_WriteValue(p_buffer, argument.get());
+		}
+	}
+}
+
+void SLiMCheckpoint::_WriteChunk_SPEC(std::string &p_buffer, Species *p_species)
+{
+	_AppendCheckpoint(p_buffer, (int32_t)p_species->species_id_);
+	
+	// Mutation types; those created by initialize...() calls already exist, so only their mutable state is saved
+	_AppendCheckpoint(p_buffer, (uint32_t)p_species->mutation_types_.size());
+	
+	for (auto &muttype_pair : p_species->mutation_types_)
+	{
+		MutationType *muttype = muttype_pair.second;
+		
+		_AppendCheckpoint(p_buffer, (int32_t)muttype->mutation_type_id_);
+		_AppendCheckpoint(p_buffer, muttype->dominance_coeff_);
+		_AppendCheckpoint(p_buffer, muttype->haploid_dominance_coeff_);
+		_AppendCheckpoint(p_buffer, muttype->dfe_type_);
+		_AppendCheckpointVector(p_buffer, muttype->dfe_parameters_);
+		_AppendCheckpoint(p_buffer, (uint32_t)muttype->dfe_strings_.size());
+		for (const std::string &dfe_string : muttype->dfe_strings_)
+			_AppendCheckpointString(p_buffer, dfe_string);
+		_AppendCheckpoint(p_buffer, (uint8_t)muttype->convert_to_substitution_);
+		_AppendCheckpoint(p_buffer, muttype->stack_policy_);
+		_AppendCheckpoint(p_buffer, muttype->stack_group_);
+		_AppendCheckpointString(p_buffer, muttype->color_);
+		_AppendCheckpoint(p_buffer, muttype->color_red_);
+		_AppendCheckpoint(p_buffer, muttype->color_green_);
+		_AppendCheckpoint(p_buffer, muttype->color_blue_);
+		_AppendCheckpointString(p_buffer, muttype->color_sub_);
+		_AppendCheckpoint(p_buffer, muttype->color_sub_red_);
+		_AppendCheckpoint(p_buffer, muttype->color_sub_green_);
+		_AppendCheckpoint(p_buffer, muttype->color_sub_blue_);
+		_AppendCheckpoint(p_buffer, (int64_t)muttype->tag_value_);
+		_AppendCheckpoint(p_buffer, (uint8_t)muttype->all_pure_neutral_DFE_);
+	}
+	
+	// Genomic element types
+	_AppendCheckpoint(p_buffer, (uint32_t)p_species->genomic_element_types_.size());
+	
+	for (auto &getype_pair : p_species->genomic_element_types_)
+	{
+		GenomicElementType *getype = getype_pair.second;
+		
+		_AppendCheckpoint(p_buffer, (int32_t)getype->genomic_element_type_id_);
+		_AppendCheckpoint(p_buffer, (uint32_t)getype->mutation_type_ptrs_.size());
+		for (MutationType *muttype : getype->mutation_type_ptrs_)
+			_AppendCheckpoint(p_buffer, (int32_t)muttype->mutation_type_id_);
+		_AppendCheckpointVector(p_buffer, getype->mutation_fractions_);
+		_AppendCheckpointString(p_buffer, getype->color_);
+		_AppendCheckpoint(p_buffer, getype->color_red_);
+		_AppendCheckpoint(p_buffer, getype->color_green_);
+		_AppendCheckpoint(p_buffer, getype->color_blue_);
+		_AppendCheckpoint(p_buffer, (int64_t)getype->tag_value_);
+		_AppendCheckpoint(p_buffer, (uint8_t)(getype->mutation_matrix_ ? 1 : 0));
+		if (getype->mutation_matrix_)
+			_WriteValue(p_buffer, getype->mutation_matrix_.get());
+	}
+	
+	// The chromosome's rate maps and other mutable state
+	Chromosome &chromosome = p_species->TheChromosome();
+	
+	_AppendCheckpointVector(p_buffer, chromosome.mutation_end_positions_H_);
+	_AppendCheckpointVector(p_buffer, chromosome.mutation_end_positions_M_);
+	_AppendCheckpointVector(p_buffer, chromosome.mutation_end_positions_F_);
+	_AppendCheckpointVector(p_buffer, chromosome.mutation_rates_H_);
+	_AppendCheckpointVector(p_buffer, chromosome.mutation_rates_M_);
+	_AppendCheckpointVector(p_buffer, chromosome.mutation_rates_F_);
+	_AppendCheckpointVector(p_buffer, chromosome.recombination_end_positions_H_);
+	_AppendCheckpointVector(p_buffer, chromosome.recombination_end_positions_M_);
+	_AppendCheckpointVector(p_buffer, chromosome.recombination_end_positions_F_);
+	_AppendCheckpointVector(p_buffer, chromosome.recombination_rates_H_);
+	_AppendCheckpointVector(p_buffer, chromosome.recombination_rates_M_);
+	_AppendCheckpointVector(p_buffer, chromosome.recombination_rates_F_);
+	_AppendCheckpointVector(p_buffer, chromosome.hotspot_end_positions_H_);
+	_AppendCheckpointVector(p_buffer, chromosome.hotspot_end_positions_M_);
+	_AppendCheckpointVector(p_buffer, chromosome.hotspot_end_positions_F_);
+	_AppendCheckpointVector(p_buffer, chromosome.hotspot_multipliers_H_);
+	_AppendCheckpointVector(p_buffer, chromosome.hotspot_multipliers_M_);
+	_AppendCheckpointVector(p_buffer, chromosome.hotspot_multipliers_F_);
+	_AppendCheckpoint(p_buffer, (uint8_t)chromosome.using_DSB_model_);
+	_AppendCheckpoint(p_buffer, chromosome.non_crossover_fraction_);
+	_AppendCheckpoint(p_buffer, chromosome.gene_conversion_avg_length_);
+	_AppendCheckpoint(p_buffer, chromosome.gene_conversion_inv_half_length_);
+	_AppendCheckpoint(p_buffer, chromosome.simple_conversion_fraction_);
+	_AppendCheckpoint(p_buffer, chromosome.mismatch_repair_bias_);
+	_AppendCheckpoint(p_buffer, (uint8_t)chromosome.redraw_lengths_on_failure_);
+	_AppendCheckpointString(p_buffer, chromosome.color_sub_);
+	_AppendCheckpoint(p_buffer, chromosome.color_sub_red_);
+	_AppendCheckpoint(p_buffer, chromosome.color_sub_green_);
+	_AppendCheckpoint(p_buffer, chromosome.color_sub_blue_);
+	_AppendCheckpoint(p_buffer, (int64_t)chromosome.tag_value_);
+	
+	std::vector<GenomicElement *> &elements = chromosome.GenomicElements();
+	
+	_AppendCheckpoint(p_buffer, (uint64_t)elements.size());
+	
+	for (GenomicElement *element : elements)
+	{
+		_AppendCheckpoint(p_buffer, (int32_t)element->genomic_element_type_ptr_->genomic_element_type_id_);
+		_AppendCheckpoint(p_buffer, (int64_t)element->tag_value_);
+	}
+	
+	// The population, in the binary format written by outputFull(binary=T), with everything optional included
+	{
+		std::ostringstream population_stream;
+		
+		p_species->population_.PrintAllBinary(population_stream, true, true, true, true);
+		
+		_AppendCheckpointString(p_buffer, population_stream.str());
+	}
+	
+	// Species state
+	_AppendCheckpoint(p_buffer, (int32_t)p_species->cycle_);
+	_AppendCheckpoint(p_buffer, (int64_t)p_species->tag_value_);
+	_AppendCheckpoint(p_buffer, (uint8_t)p_species->species_active_);
+	_AppendCheckpointString(p_buffer, p_species->description_);
+	_AppendCheckpoint(p_buffer, (uint8_t)p_species->pure_neutral_);
+	_AppendCheckpoint(p_buffer, (uint8_t)p_species->type_s_dfes_present_);
+	_AppendCheckpoint(p_buffer, (uint8_t)p_species->any_dominance_coeff_changed_);
+	_AppendCheckpoint(p_buffer, (int32_t)p_species->last_nonneutral_regime_);
+	
+	_AppendCheckpoint(p_buffer, (uint32_t)p_species->used_subpop_ids_.size());
+	for (auto &used_id_pair : p_species->used_subpop_ids_)
+	{
+		_AppendCheckpoint(p_buffer, (int32_t)used_id_pair.first);
+		_AppendCheckpointString(p_buffer, used_id_pair.second);
+	}
+	
+	_AppendCheckpoint(p_buffer, (uint32_t)p_species->used_subpop_names_.size());
+	for (const std::string &used_name : p_species->used_subpop_names_)
+		_AppendCheckpointString(p_buffer, used_name);
+	
+	// Substitutions
+	std::vector<Substitution *> &substitutions = p_species->population_.substitutions_;
+	
+	_AppendCheckpoint(p_buffer, (uint64_t)substitutions.size());
+	
+	for (Substitution *substitution : substitutions)
+	{
+		_AppendCheckpoint(p_buffer, (int64_t)substitution->mutation_id_);
+		_AppendCheckpoint(p_buffer, (int32_t)substitution->mutation_type_ptr_->mutation_type_id_);
+		_AppendCheckpoint(p_buffer, (int64_t)substitution->position_);
+		_AppendCheckpoint(p_buffer, substitution->selection_coeff_);
+		_AppendCheckpoint(p_buffer, (int32_t)substitution->subpop_index_);
+		_AppendCheckpoint(p_buffer, (int32_t)substitution->origin_tick_);
+		_AppendCheckpoint(p_buffer, (int32_t)substitution->fixation_tick_);
+		_AppendCheckpoint(p_buffer, substitution->nucleotide_);
+		_AppendCheckpoint(p_buffer, (int64_t)substitution->tag_value_);
+	}
+	
+	// The order of the mutation registry, with mutation tags; the population format above writes mutations in a different order
+	MutationRun &registry = p_species->population_.mutation_registry_;
+	const MutationIndex *registry_iter = registry.begin_pointer_const();
+	const MutationIndex *registry_end = registry.end_pointer_const();
+	
+	_AppendCheckpoint(p_buffer, (uint64_t)registry.size());
+	
+	for (; registry_iter != registry_end; ++registry_iter)
+	{
+		Mutation *mutation = gSLiM_Mutation_Block + *registry_iter;
+		
+		_AppendCheckpoint(p_buffer, (int64_t)mutation->mutation_id_);
+		_AppendCheckpoint(p_buffer, (int64_t)mutation->tag_value_);
+	}
+	
+	// Subpopulations, with the state of their individuals and genomes
+	_AppendCheckpoint(p_buffer, (uint32_t)p_species->population_.subpops_.size());
+	
+	for (auto &subpop_pair : p_species->population_.subpops_)
+	{
+		Subpopulation *subpop = subpop_pair.second;
+		
+		_AppendCheckpoint(p_buffer, (int32_t)subpop->subpopulation_id_);
+		_AppendCheckpointString(p_buffer, subpop->name_);
+		_AppendCheckpointString(p_buffer, subpop->description_);
+		_AppendCheckpoint(p_buffer, subpop->selfing_fraction_);
+		_AppendCheckpoint(p_buffer, subpop->female_clone_fraction_);
+		_AppendCheckpoint(p_buffer, subpop->male_clone_fraction_);
+		
+		_AppendCheckpoint(p_buffer, (uint32_t)subpop->migrant_fractions_.size());
+		for (auto &migrant_pair : subpop->migrant_fractions_)
+		{
+			_AppendCheckpoint(p_buffer, (int32_t)migrant_pair.first);
+			_AppendCheckpoint(p_buffer, migrant_pair.second);
+		}
+		
+		_AppendCheckpoint(p_buffer, (uint8_t)subpop->has_null_genomes_);
+		_AppendCheckpoint(p_buffer, subpop->bounds_x0_);
+		_AppendCheckpoint(p_buffer, subpop->bounds_x1_);
+		_AppendCheckpoint(p_buffer, subpop->bounds_y0_);
+		_AppendCheckpoint(p_buffer, subpop->bounds_y1_);
+		_AppendCheckpoint(p_buffer, subpop->bounds_z0_);
+		_AppendCheckpoint(p_buffer, subpop->bounds_z1_);
+		_AppendCheckpoint(p_buffer, (int64_t)subpop->tag_value_);
+		_AppendCheckpoint(p_buffer, subpop->subpop_fitness_scaling_);
+		_AppendCheckpointVector(p_buffer, subpop->lifetime_reproductive_output_MH_);
+		_AppendCheckpointVector(p_buffer, subpop->lifetime_reproductive_output_F_);
+		_AppendCheckpoint(p_buffer, (uint8_t)subpop->individual_cached_fitness_OVERRIDE_);
+		_AppendCheckpoint(p_buffer, subpop->individual_cached_fitness_OVERRIDE_value_);
+		
+		_AppendCheckpoint(p_buffer, (uint32_t)subpop->spatial_maps_.size());
+		for (auto &map_pair : subpop->spatial_maps_)
+		{
+			_AppendCheckpointString(p_buffer, map_pair.first);
+			_WriteObject(p_buffer, map_pair.second);
+		}
+		
+		_AppendCheckpoint(p_buffer, subpop->parent_sex_ratio_);
+		_AppendCheckpoint(p_buffer, (int32_t)subpop->child_subpop_size_);
+		_AppendCheckpoint(p_buffer, subpop->child_sex_ratio_);
+		_AppendCheckpoint(p_buffer, (uint8_t)(((subpop->sex_enabled_ ? subpop->lookup_female_parent_ : subpop->lookup_parent_) != nullptr) ? 1 : 0));
+		
+		_AppendCheckpoint(p_buffer, (uint64_t)subpop->parent_individuals_.size());
+		for (Individual *individual : subpop->parent_individuals_)
+		{
+			uint16_t tagL_bits = (uint16_t)(individual->tagL0_set_ | (individual->tagL0_value_ << 1) | (individual->tagL1_set_ << 2) | (individual->tagL1_value_ << 3) |
+											(individual->tagL2_set_ << 4) | (individual->tagL2_value_ << 5) | (individual->tagL3_set_ << 6) | (individual->tagL3_value_ << 7) |
+											(individual->tagL4_set_ << 8) | (individual->tagL4_value_ << 9));
+			
+			_AppendCheckpoint(p_buffer, (int64_t)individual->tag_value_);
+			_AppendCheckpoint(p_buffer, individual->tagF_value_);
+			_AppendCheckpoint(p_buffer, tagL_bits);
+			_AppendCheckpoint(p_buffer, (uint8_t)individual->migrant_);
+			_AppendCheckpoint(p_buffer, individual->fitness_scaling_);
+			_AppendCheckpoint(p_buffer, individual->cached_fitness_UNSAFE_);
+			_AppendCheckpoint(p_buffer, individual->color_set_);
+			_AppendCheckpoint(p_buffer, individual->colorR_);
+			_AppendCheckpoint(p_buffer, individual->colorG_);
+			_AppendCheckpoint(p_buffer, individual->colorB_);
+			_AppendCheckpoint(p_buffer, individual->mean_parent_age_);
+			_AppendCheckpoint(p_buffer, (int64_t)individual->pedigree_p1_);
+			_AppendCheckpoint(p_buffer, (int64_t)individual->pedigree_p2_);
+			_AppendCheckpoint(p_buffer, (int64_t)individual->pedigree_g1_);
+			_AppendCheckpoint(p_buffer, (int64_t)individual->pedigree_g2_);
+			_AppendCheckpoint(p_buffer, (int64_t)individual->pedigree_g3_);
+			_AppendCheckpoint(p_buffer, (int64_t)individual->pedigree_g4_);
+			_AppendCheckpoint(p_buffer, (int32_t)individual->reproductive_output_);
+		}
+		
+		_AppendCheckpoint(p_buffer, (uint64_t)subpop->parent_genomes_.size());
+		for (Genome *genome : subpop->parent_genomes_)
+			_AppendCheckpoint(p_buffer, (int64_t)genome->tag_value_);
+	}
+}
+
+void SLiMCheckpoint::_WriteChunk_BLCK(std::string &p_buffer)
+{
+	std::vector<SLiMEidosBlock *> &blocks = community_.script_blocks_;
+	
+	_AppendCheckpoint(p_buffer, (uint32_t)blocks.size());
+	
+	for (SLiMEidosBlock *block : blocks)
+	{
+		// blocks from the script file are identified by their position in the script; programmatic blocks are saved in full
+		bool programmatic = (block->script_ != nullptr);
+		
+		_AppendCheckpoint(p_buffer, (uint8_t)programmatic);
+		
+		if (!programmatic)
+			_AppendCheckpoint(p_buffer, (int32_t)block->root_node_->token_->token_start_);
+		
+		_AppendCheckpoint(p_buffer, (uint8_t)block->tick_range_evaluated_);
+		_AppendCheckpoint(p_buffer, (uint8_t)block->tick_range_is_sequence_);
+		_AppendCheckpoint(p_buffer, (int32_t)block->tick_start_);
+		_AppendCheckpoint(p_buffer, (int32_t)block->tick_end_);
+		_AppendCheckpoint(p_buffer, (uint64_t)block->tick_set_.size());
+		for (slim_tick_t tick : block->tick_set_)
+			_AppendCheckpoint(p_buffer, (int32_t)tick);
+		_AppendCheckpoint(p_buffer, (int64_t)block->block_active_);
+		_AppendCheckpoint(p_buffer, (int64_t)block->tag_value_);
+		
+		if (programmatic)
+		{
+			_AppendCheckpoint(p_buffer, (int32_t)block->block_id_);
+			_AppendCheckpointString(p_buffer, block->script_->String());
+			_AppendCheckpoint(p_buffer, (int32_t)block->type_);
+			_AppendCheckpoint(p_buffer, (int32_t)(block->species_spec_ ? block->species_spec_->species_id_ : -1));
+			_AppendCheckpoint(p_buffer, (int32_t)(block->ticks_spec_ ? block->ticks_spec_->species_id_ : -1));
+			_AppendCheckpoint(p_buffer, (int32_t)block->mutation_type_id_);
+			_AppendCheckpoint(p_buffer, (int32_t)block->subpopulation_id_);
+			_AppendCheckpoint(p_buffer, (int32_t)block->interaction_type_id_);
+			_AppendCheckpoint(p_buffer, block->sex_specificity_);
+			_AppendCheckpoint(p_buffer, (uint8_t)block->vectorized_);
+		}
+	}
+}
+
+void SLiMCheckpoint::_WriteChunk_INTR(std::string &p_buffer)
+{
+	_AppendCheckpoint(p_buffer, (uint32_t)community_.interaction_types_.size());
+	
+	for (auto &inttype_pair : community_.interaction_types_)
+	{
+		InteractionType *inttype = inttype_pair.second;
+		
+		_AppendCheckpoint(p_buffer, (int32_t)inttype->interaction_type_id_);
+		_AppendCheckpoint(p_buffer, inttype->max_distance_);
+		_AppendCheckpoint(p_buffer, inttype->max_distance_sq_);
+		_AppendCheckpoint(p_buffer, inttype->receiver_constraints_);
+		_AppendCheckpoint(p_buffer, inttype->exerter_constraints_);
+		_AppendCheckpoint(p_buffer, inttype->if_type_);
+		_AppendCheckpoint(p_buffer, inttype->if_param1_);
+		_AppendCheckpoint(p_buffer, inttype->if_param2_);
+		_AppendCheckpoint(p_buffer, inttype->if_param3_);
+		_AppendCheckpoint(p_buffer, inttype->n_2param2sq_);
+		_AppendCheckpoint(p_buffer, (int64_t)inttype->tag_value_);
+		
+		// the cached interaction data is not saved; the evaluated subpopulations are re-evaluated on restore instead
+		std::vector<slim_objectid_t> evaluated_subpop_ids;
+		
+		for (auto &data_pair : inttype->data_)
+			if (data_pair.second.evaluated_)
+				evaluated_subpop_ids.emplace_back(data_pair.first);
+		
+		_AppendCheckpointVector(p_buffer, evaluated_subpop_ids);
+	}
+}
+
+void SLiMCheckpoint::_WriteChunk_LOGF(std::string &p_buffer)
+{
+	_AppendCheckpoint(p_buffer, (uint32_t)community_.log_file_registry_.size());
+	
+	for (LogFile *log_file : community_.log_file_registry_)
+	{
+		// Flush everything logged so far, so that the file's length now is the length to restore to
+		if (log_file->binary_)
+			log_file->WriteBinaryRowGroup();
+		else
+			Eidos_FlushFile(log_file->resolved_file_path_);
+		
+		log_file->unflushed_row_count_ = 0;
+		
+		struct stat file_info;
+		uint64_t file_size = (stat(log_file->resolved_file_path_.c_str(), &file_info) == 0) ? (uint64_t)file_info.st_size : 0;
+		
+		_AppendCheckpointString(p_buffer, log_file->user_file_path_);
+		_AppendCheckpointString(p_buffer, log_file->resolved_file_path_);
+		_AppendCheckpoint(p_buffer, file_size);
+		_AppendCheckpoint(p_buffer, (uint8_t)log_file->header_logged_);
+		_AppendCheckpoint(p_buffer, (uint8_t)log_file->compress_);
+		_AppendCheckpoint(p_buffer, (uint8_t)log_file->binary_);
+		_AppendCheckpointString(p_buffer, log_file->sep_);
+		_AppendCheckpoint(p_buffer, (int32_t)log_file->float_precision_);
+		_AppendCheckpoint(p_buffer, (uint8_t)log_file->autologging_enabled_);
+		_AppendCheckpoint(p_buffer, log_file->log_interval_);
+		_AppendCheckpoint(p_buffer, (int32_t)log_file->autolog_start_);
+		_AppendCheckpoint(p_buffer, (uint8_t)log_file->explicit_flushing_);
+		_AppendCheckpoint(p_buffer, log_file->flush_interval_);
+		_AppendCheckpoint(p_buffer, (int64_t)log_file->tag_value_);
+		
+		_AppendCheckpoint(p_buffer, (uint32_t)log_file->column_names_.size());
+		for (const std::string &column_name : log_file->column_names_)
+			_AppendCheckpointString(p_buffer, column_name);
+		
+		_AppendCheckpoint(p_buffer, (uint32_t)log_file->generator_info_.size());
+		for (LogFileGeneratorInfo &generator : log_file->generator_info_)
+		{
+			_AppendCheckpoint(p_buffer, (int32_t)generator.type_);
+			_AppendCheckpoint(p_buffer, (uint8_t)(generator.script_ ? 1 : 0));
+			if (generator.script_)
+				_AppendCheckpointString(p_buffer, generator.script_->String());
+			_AppendCheckpoint(p_buffer, (int32_t)generator.objectid_);
+			_AppendCheckpoint(p_buffer, (uint8_t)(generator.context_ ? 1 : 0));
+			if (generator.context_)
+				_WriteValue(p_buffer, generator.context_.get());
+		}
+	}
+}
+
+void SLiMCheckpoint::_WriteChunk_DICT(std::string &p_buffer)
+{
+	// Gather every SLiM object with Dictionary contents; LogFile is excluded, since its keys are its logged values
+	std::vector<EidosDictionaryUnretained *> owners;
+	
+	owners.emplace_back(&community_);
+	
+	for (Species *species : community_.all_species_)
+	{
+		owners.emplace_back(species);
+		owners.emplace_back(&species->TheChromosome());
+		
+		for (auto &muttype_pair : species->mutation_types_)
+			owners.emplace_back(muttype_pair.second);
+		for (auto &getype_pair : species->genomic_element_types_)
+			owners.emplace_back(getype_pair.second);
+		
+		for (auto &subpop_pair : species->population_.subpops_)
+		{
+			owners.emplace_back(subpop_pair.second);
+			
+			if (Individual::s_any_individual_dictionary_set_)
+				for (Individual *individual : subpop_pair.second->parent_individuals_)
+					owners.emplace_back(individual);
+		}
+		
+		MutationRun &registry = species->population_.mutation_registry_;
+		const MutationIndex *registry_iter = registry.begin_pointer_const();
+		const MutationIndex *registry_end = registry.end_pointer_const();
+		
+		for (; registry_iter != registry_end; ++registry_iter)
+			owners.emplace_back(gSLiM_Mutation_Block + *registry_iter);
+		
+		for (Substitution *substitution : species->population_.substitutions_)
+			owners.emplace_back(substitution);
+	}
+	
+	for (auto &inttype_pair : community_.interaction_types_)
+		owners.emplace_back(inttype_pair.second);
+	for (SLiMEidosBlock *block : community_.script_blocks_)
+		owners.emplace_back(block);
+	
+	owners.erase(std::remove_if(owners.begin(), owners.end(), [](EidosDictionaryUnretained *owner) { return owner->KeyCount() == 0; }), owners.end());
+	
+	_AppendCheckpoint(p_buffer, (uint64_t)owners.size());
+	
+	for (EidosDictionaryUnretained *owner : owners)
+	{
+		_WriteObject(p_buffer, owner);
+		_WriteDictionary(p_buffer, owner);
+	}
+}
+
+void SLiMCheckpoint::_WriteChunk_GLOB(std::string &p_buffer)
+{
+	// User-defined constants live in the defined-constants table above the globals table; the intrinsic constants are excluded
+	EidosSymbolTable *globals_table = community_.simulation_globals_;
+	EidosSymbolTable *constants_table = globals_table->ParentSymbolTable();
+	std::vector<std::string> constant_names;
+	
+	if (constants_table && (constants_table->TableType() == EidosSymbolTableType::kEidosDefinedConstantsTable))
+	{
+		std::vector<std::string> intrinsic_names = gEidosConstantsSymbolTable->ReadOnlySymbols();
+		std::unordered_set<std::string> intrinsic_set(intrinsic_names.begin(), intrinsic_names.end());
+		
+		for (const std::string &constant_name : constants_table->ReadOnlySymbols())
+			if (intrinsic_set.find(constant_name) == intrinsic_set.end())
+				constant_names.emplace_back(constant_name);
+	}
+	
+	std::vector<std::string> global_names = globals_table->ReadWriteSymbols();
+	
+	_AppendCheckpoint(p_buffer, (uint32_t)constant_names.size());
+	for (const std::string &constant_name : constant_names)
+	{
+		_AppendCheckpointString(p_buffer, constant_name);
+		_WriteValue(p_buffer, globals_table->GetValueOrRaiseForSymbol(EidosStringRegistry::GlobalStringIDForString(constant_name)).get());
+	}
+	
+	_AppendCheckpoint(p_buffer, (uint32_t)global_names.size());
+	for (const std::string &global_name : global_names)
+	{
+		_AppendCheckpointString(p_buffer, global_name);
+		_WriteValue(p_buffer, globals_table->GetValueOrRaiseForSymbol(EidosStringRegistry::GlobalStringIDForString(global_name)).get());
+	}
+}
+
+
+#pragma mark -
+#pragma mark Restoring
+#pragma mark -
+
+void SLiMCheckpoint::ReplayInitializeCalls(Species *p_species)
+{
+	// The calls were logged for `species all` callbacks first, then for each species in turn, which is the order we are called in
+	slim_objectid_t species_id = (p_species ? p_species->species_id_ : -1);
+	EidosSymbolTable callback_symbols(EidosSymbolTableType::kContextConstantsTable, &community_.SymbolTable());
+	EidosSymbolTable client_symbols(EidosSymbolTableType::kLocalVariablesTable, &callback_symbols);
+	std::ostringstream discarded_output;
+	EidosInterpreter interpreter(community_.script_->AST(), client_symbols, community_.simulation_functions_, &community_, discarded_output, SLIM_ERRSTREAM);
+	
+	while (init_ptr_ < init_end_)
+	{
+		const char *record_ptr = init_ptr_;
+		
+		if (_ReadCheckpoint<int32_t>(record_ptr, init_end_) != species_id)
+			break;
+		
+		std::string function_name = _ReadCheckpointString(record_ptr, init_end_);
+		uint32_t argument_count = _ReadCheckpoint<uint32_t>(record_ptr, init_end_);
+		std::vector<EidosValue_SP> arguments;
+		
+		for (uint32_t argument_index = 0; argument_index < argument_count; ++argument_index)
+			arguments.emplace_back(_ReadValue(record_ptr, init_end_));
+		
+		if ((function_name == gStr_initializeAncestralNucleotides) && (argument_count == 1))
+		{
+			// the real sequence is read with the population; a placeholder of the right length suffices until then
+			int64_t sequence_length = arguments[0]->IntAtIndex_NOCAST(0, nullptr);
+			
+			arguments[0] = EidosValue_SP(new (gEidosValuePool->AllocateChunk()) EidosValue_String(std::string((size_t)sequence_length, 'A')));
+		}
+		
+		init_ptr_ = record_ptr;
+		community_.ContextDefinedFunctionDispatch(function_name, arguments, interpreter);
+	}
+}
+
+slim_tick_t SLiMCheckpoint::RestoreState(void)
+{
+	if (init_ptr_ != init_end_)
+		EIDOS_TERMINATION << "ERROR (SLiMCheckpoint::RestoreState): the checkpoint file at " << file_path_ << " does not match the model's initialize() callbacks." << EidosTerminate();
+	
+	// Community state; the tick is set first, since restoring the rest depends upon it
+	const char *end;
+	const char *p = _ChunkPayload("CMTY", 0, &end);
+	
+	slim_tick_t tick = _ReadCheckpoint<int32_t>(p, end);
+	slim_tick_t tick_start = _ReadCheckpoint<int32_t>(p, end);
+	uint64_t original_seed = _ReadCheckpoint<uint64_t>(p, end);
+	slim_usertag_t tag_value = _ReadCheckpoint<int64_t>(p, end);
+	SLiMModelType model_type = (SLiMModelType)_ReadCheckpoint<uint8_t>(p, end);
+	bool all_tick_ranges_evaluated = _ReadCheckpoint<uint8_t>(p, end);
+	
+	community_.warned_early_mutation_add_ = _ReadCheckpoint<uint8_t>(p, end);
+	community_.warned_early_mutation_remove_ = _ReadCheckpoint<uint8_t>(p, end);
+	community_.warned_early_output_ = _ReadCheckpoint<uint8_t>(p, end);
+	community_.warned_early_read_ = _ReadCheckpoint<uint8_t>(p, end);
+	community_.warned_no_max_distance_ = _ReadCheckpoint<uint8_t>(p, end);
+	community_.warned_readFromVCF_mutIDs_unused_ = _ReadCheckpoint<uint8_t>(p, end);
+	community_.warned_no_ancestry_read_ = _ReadCheckpoint<uint8_t>(p, end);
+	
+	bool any_individual_flags[7];
+	
+	for (bool &flag : any_individual_flags)
+		flag = _ReadCheckpoint<uint8_t>(p, end);
+	
+	slim_pedigreeid_t next_pedigree_id = _ReadCheckpoint<int64_t>(p, end);
+	slim_mutationid_t next_mutation_id = _ReadCheckpoint<int64_t>(p, end);
+	uint32_t species_count = _ReadCheckpoint<uint32_t>(p, end);
+	
+	if ((model_type != community_.model_type_) || (species_count != community_.all_species_.size()))
+		EIDOS_TERMINATION << "ERROR (SLiMCheckpoint::RestoreState): the checkpoint file at " << file_path_ << " does not match the model's configuration." << EidosTerminate();
+	
+	for (Species *species : community_.all_species_)
+		if (_ReadCheckpointString(p, end) != species->name_)
+			EIDOS_TERMINATION << "ERROR (SLiMCheckpoint::RestoreState): the checkpoint file at " << file_path_ << " does not match the model's species." << EidosTerminate();
+	
+	community_.SetTick(tick);
+	community_.tick_start_ = tick_start;
+	community_.original_seed_ = (unsigned long int)original_seed;
+	community_.tag_value_ = tag_value;
+	community_.all_tick_ranges_evaluated_ = all_tick_ranges_evaluated;
+	
+	// The chunks for each species, and then for objects that may refer to species-level objects
+	for (Species *species : community_.all_species_)
+	{
+		p = _ChunkPayload("SPEC", species->species_id_, &end);
+		_ReadChunk_SPEC(p, end, species);
+	}
+	
+	p = _ChunkPayload("BLCK", 0, &end);
+	_ReadChunk_BLCK(p, end);
+	
+	p = _ChunkPayload("INTR", 0, &end);
+	_ReadChunk_INTR(p, end);
+	
+	p = _ChunkPayload("LOGF", 0, &end);
+	_ReadChunk_LOGF(p, end);
+	
+	p = _ChunkPayload("DICT", 0, &end);
+	_ReadChunk_DICT(p, end);
+	
+	p = _ChunkPayload("GLOB", 0, &end);
+	_ReadChunk_GLOB(p, end);
+	
+	// Global counters, which reading the population may have changed; and last of all, the random number generators
+	Individual::s_any_individual_color_set_ = any_individual_flags[0];
+	Individual::s_any_individual_dictionary_set_ = any_individual_flags[1];
+	Individual::s_any_individual_tag_set_ = any_individual_flags[2];
+	Individual::s_any_individual_tagF_set_ = any_individual_flags[3];
+	Individual::s_any_individual_tagL_set_ = any_individual_flags[4];
+	Individual::s_any_genome_tag_set_ = any_individual_flags[5];
+	Individual::s_any_individual_fitness_scaling_set_ = any_individual_flags[6];
+	
+	gSLiM_next_pedigree_id = next_pedigree_id;
+	gSLiM_next_mutation_id = next_mutation_id;
+	
+	p = _ChunkPayload("RAND", 0, &end);
+	Eidos_RestoreRNGState(p, end);
+	
+	return tick;
+}
+
+void SLiMCheckpoint::_ReadChunk_SPEC(const char *p_ptr, const char *p_end, Species *p_species)
+{
+	if (_ReadCheckpoint<int32_t>(p_ptr, p_end) != p_species->species_id_)
+		_RaiseForCorruptCheckpoint();
+	
+	// Mutation types
+	uint32_t muttype_count = _ReadCheckpoint<uint32_t>(p_ptr, p_end);
+	
+	if (muttype_count != p_species->mutation_types_.size())
+		EIDOS_TERMINATION << "ERROR (SLiMCheckpoint::RestoreState): the checkpoint file at " << file_path_ << " does not match the model's mutation types." << EidosTerminate();
+	
+	for (uint32_t muttype_index = 0; muttype_index < muttype_count; ++muttype_index)
+	{
+		MutationType *muttype = p_species->MutationTypeWithID(_ReadCheckpoint<int32_t>(p_ptr, p_end));
+		
+		if (!muttype)
+			EIDOS_TERMINATION << "ERROR (SLiMCheckpoint::RestoreState): the checkpoint file at " << file_path_ << " does not match the model's mutation types." << EidosTerminate();
+		
+		muttype->dominance_coeff_ = _ReadCheckpoint<slim_selcoeff_t>(p_ptr, p_end);
+		muttype->haploid_dominance_coeff_ = _ReadCheckpoint<slim_selcoeff_t>(p_ptr, p_end);
+		muttype->dfe_type_ = _ReadCheckpoint<DFEType>(p_ptr, p_end);
+		_ReadCheckpointVector(p_ptr, p_end, muttype->dfe_parameters_);
+		
+		uint32_t dfe_string_count = _ReadCheckpoint<uint32_t>(p_ptr, p_end);
+		
+		muttype->dfe_strings_.clear();
+		for (uint32_t string_index = 0; string_index < dfe_string_count; ++string_index)
+			muttype->dfe_strings_.emplace_back(_ReadCheckpointString(p_ptr, p_end));
+		
+		if (muttype->cached_dfe_script_)
+		{
+			delete muttype->cached_dfe_script_;
+			muttype->cached_dfe_script_ = nullptr;
+		}
+		
+		muttype->convert_to_substitution_ = _ReadCheckpoint<uint8_t>(p_ptr, p_end);
+		muttype->stack_policy_ = _ReadCheckpoint<MutationStackPolicy>(p_ptr, p_end);
+		muttype->stack_group_ = _ReadCheckpoint<int64_t>(p_ptr, p_end);
+		muttype->color_ = _ReadCheckpointString(p_ptr, p_end);
+		muttype->color_red_ = _ReadCheckpoint<float>(p_ptr, p_end);
+		muttype->color_green_ = _ReadCheckpoint<float>(p_ptr, p_end);
+		muttype->color_blue_ = _ReadCheckpoint<float>(p_ptr, p_end);
+		muttype->color_sub_ = _ReadCheckpointString(p_ptr, p_end);
+		muttype->color_sub_red_ = _ReadCheckpoint<float>(p_ptr, p_end);
+		muttype->color_sub_green_ = _ReadCheckpoint<float>(p_ptr, p_end);
+		muttype->color_sub_blue_ = _ReadCheckpoint<float>(p_ptr, p_end);
+		muttype->tag_value_ = _ReadCheckpoint<int64_t>(p_ptr, p_end);
+		muttype->all_pure_neutral_DFE_ = _ReadCheckpoint<uint8_t>(p_ptr, p_end);
+	}
+	
+	// Genomic element types
+	uint32_t getype_count = _ReadCheckpoint<uint32_t>(p_ptr, p_end);
+	
+	if (getype_count != p_species->genomic_element_types_.size())
+		EIDOS_TERMINATION << "ERROR (SLiMCheckpoint::RestoreState): the checkpoint file at " << file_path_ << " does not match the model's genomic element types." << EidosTerminate();
+	
+	for (uint32_t getype_index = 0; getype_index < getype_count; ++getype_index)
+	{
+		GenomicElementType *getype = p_species->GenomicElementTypeWithID(_ReadCheckpoint<int32_t>(p_ptr, p_end));
+		
+		if (!getype)
+			EIDOS_TERMINATION << "ERROR (SLiMCheckpoint::RestoreState): the checkpoint file at " << file_path_ << " does not match the model's genomic element types." << EidosTerminate();
+		
+		uint32_t getype_muttype_count = _ReadCheckpoint<uint32_t>(p_ptr, p_end);
+		
+		getype->mutation_type_ptrs_.clear();
+		for (uint32_t muttype_index = 0; muttype_index < getype_muttype_count; ++muttype_index)
+		{
+			MutationType *muttype = p_species->MutationTypeWithID(_ReadCheckpoint<int32_t>(p_ptr, p_end));
+			
+			if (!muttype)
+				_RaiseForCorruptCheckpoint();
+			
+			getype->mutation_type_ptrs_.emplace_back(muttype);
+		}
+		
+		_ReadCheckpointVector(p_ptr, p_end, getype->mutation_fractions_);
+		getype->color_ = _ReadCheckpointString(p_ptr, p_end);
+		getype->color_red_ = _ReadCheckpoint<float>(p_ptr, p_end);
+		getype->color_green_ = _ReadCheckpoint<float>(p_ptr, p_end);
+		getype->color_blue_ = _ReadCheckpoint<float>(p_ptr, p_end);
+		getype->tag_value_ = _ReadCheckpoint<int64_t>(p_ptr, p_end);
+		
+		if (_ReadCheckpoint<uint8_t>(p_ptr, p_end))
+		{
+			EidosValue_SP matrix_value = _ReadValue(p_ptr, p_end);
+			
+			if (matrix_value->Type() != EidosValueType::kValueFloat)
+				_RaiseForCorruptCheckpoint();
+			
+			getype->SetNucleotideMutationMatrix(EidosValue_Float_SP(static_cast<EidosValue_Float *>(matrix_value.get())));
+		}
+		
+		getype->InitializeDraws();
+	}
+	
+	// The chromosome
+	Chromosome &chromosome = p_species->TheChromosome();
+	
+	_ReadCheckpointVector(p_ptr, p_end, chromosome.mutation_end_positions_H_);
+	_ReadCheckpointVector(p_ptr, p_end, chromosome.mutation_end_positions_M_);
+	_ReadCheckpointVector(p_ptr, p_end, chromosome.mutation_end_positions_F_);
+	_ReadCheckpointVector(p_ptr, p_end, chromosome.mutation_rates_H_);
+	_ReadCheckpointVector(p_ptr, p_end, chromosome.mutation_rates_M_);
+	_ReadCheckpointVector(p_ptr, p_end, chromosome.mutation_rates_F_);
+	_ReadCheckpointVector(p_ptr, p_end, chromosome.recombination_end_positions_H_);
+	_ReadCheckpointVector(p_ptr, p_end, chromosome.recombination_end_positions_M_);
+	_ReadCheckpointVector(p_ptr, p_end, chromosome.recombination_end_positions_F_);
+	_ReadCheckpointVector(p_ptr, p_end, chromosome.recombination_rates_H_);
+	_ReadCheckpointVector(p_ptr, p_end, chromosome.recombination_rates_M_);
+	_ReadCheckpointVector(p_ptr, p_end, chromosome.recombination_rates_F_);
+	_ReadCheckpointVector(p_ptr, p_end, chromosome.hotspot_end_positions_H_);
+	_ReadCheckpointVector(p_ptr, p_end, chromosome.hotspot_end_positions_M_);
+	_ReadCheckpointVector(p_ptr, p_end, chromosome.hotspot_end_positions_F_);
+	_ReadCheckpointVector(p_ptr, p_end, chromosome.hotspot_multipliers_H_);
+	_ReadCheckpointVector(p_ptr, p_end, chromosome.hotspot_multipliers_M_);
+	_ReadCheckpointVector(p_ptr, p_end, chromosome.hotspot_multipliers_F_);
+	chromosome.using_DSB_model_ = _ReadCheckpoint<uint8_t>(p_ptr, p_end);
+	chromosome.non_crossover_fraction_ = _ReadCheckpoint<double>(p_ptr, p_end);
+	chromosome.gene_conversion_avg_length_ = _ReadCheckpoint<double>(p_ptr, p_end);
+	chromosome.gene_conversion_inv_half_length_ = _ReadCheckpoint<double>(p_ptr, p_end);
+	chromosome.simple_conversion_fraction_ = _ReadCheckpoint<double>(p_ptr, p_end);
+	chromosome.mismatch_repair_bias_ = _ReadCheckpoint<double>(p_ptr, p_end);
+	chromosome.redraw_lengths_on_failure_ = _ReadCheckpoint<uint8_t>(p_ptr, p_end);
+	chromosome.color_sub_ = _ReadCheckpointString(p_ptr, p_end);
+	chromosome.color_sub_red_ = _ReadCheckpoint<float>(p_ptr, p_end);
+	chromosome.color_sub_green_ = _ReadCheckpoint<float>(p_ptr, p_end);
+	chromosome.color_sub_blue_ = _ReadCheckpoint<float>(p_ptr, p_end);
+	chromosome.tag_value_ = _ReadCheckpoint<int64_t>(p_ptr, p_end);
+	
+	std::vector<GenomicElement *> &elements = chromosome.GenomicElements();
+	
+	if (_ReadCheckpoint<uint64_t>(p_ptr, p_end) != elements.size())
+		EIDOS_TERMINATION << "ERROR (SLiMCheckpoint::RestoreState): the checkpoint file at " << file_path_ << " does not match the model's genomic elements." << EidosTerminate();
+	
+	for (GenomicElement *element : elements)
+	{
+		GenomicElementType *getype = p_species->GenomicElementTypeWithID(_ReadCheckpoint<int32_t>(p_ptr, p_end));
+		
+		if (!getype)
+			_RaiseForCorruptCheckpoint();
+		
+		element->genomic_element_type_ptr_ = getype;
+		element->tag_value_ = _ReadCheckpoint<int64_t>(p_ptr, p_end);
+	}
+	
+	if (chromosome.GenomicElementCount() > 0)
+	{
+		if (p_species->IsNucleotideBased())
+		{
+			p_species->CacheNucleotideMatrices();
+			p_species->CreateNucleotideMutationRateMap();
+		}
+		
+		chromosome.InitializeDraws();
+	}
+	
+	// The population; this sets the tick and cycle, creates the subpopulations, and registers the mutations
+	{
+		uint32_t population_length = _ReadCheckpoint<uint32_t>(p_ptr, p_end);
+		const char *population_data = _ConsumeCheckpoint(p_ptr, p_end, population_length);
+		
+		p_species->_InitializePopulationFromBinaryBuffer(const_cast<char *>(population_data), population_length, nullptr);
+	}
+	
+	// Species state
+	p_species->SetCycle(_ReadCheckpoint<int32_t>(p_ptr, p_end));
+	p_species->tag_value_ = _ReadCheckpoint<int64_t>(p_ptr, p_end);
+	p_species->species_active_ = _ReadCheckpoint<uint8_t>(p_ptr, p_end);
+	p_species->description_ = _ReadCheckpointString(p_ptr, p_end);
+	p_species->pure_neutral_ = _ReadCheckpoint<uint8_t>(p_ptr, p_end);
+	p_species->type_s_dfes_present_ = _ReadCheckpoint<uint8_t>(p_ptr, p_end);
+	p_species->any_dominance_coeff_changed_ = _ReadCheckpoint<uint8_t>(p_ptr, p_end);
+	p_species->last_nonneutral_regime_ = _ReadCheckpoint<int32_t>(p_ptr, p_end);
+	p_species->nonneutral_change_counter_++;
+	
+	uint32_t used_id_count = _ReadCheckpoint<uint32_t>(p_ptr, p_end);
+	
+	p_species->used_subpop_ids_.clear();
+	for (uint32_t used_index = 0; used_index < used_id_count; ++used_index)
+	{
+		slim_objectid_t used_id = _ReadCheckpoint<int32_t>(p_ptr, p_end);
+		
+		p_species->used_subpop_ids_.emplace(used_id, _ReadCheckpointString(p_ptr, p_end));
+	}
+	
+	uint32_t used_name_count = _ReadCheckpoint<uint32_t>(p_ptr, p_end);
+	
+	p_species->used_subpop_names_.clear();
+	for (uint32_t used_index = 0; used_index < used_name_count; ++used_index)
+		p_species->used_subpop_names_.emplace(_ReadCheckpointString(p_ptr, p_end));
+	
+	// Substitutions
+	uint64_t substitution_count = _ReadCheckpoint<uint64_t>(p_ptr, p_end);
+	std::vector<Substitution *> &substitutions = p_species->population_.substitutions_;
+	
+	for (uint64_t substitution_index = 0; substitution_index < substitution_count; ++substitution_index)
+	{
+		slim_mutationid_t mutation_id = _ReadCheckpoint<int64_t>(p_ptr, p_end);
+		MutationType *muttype = p_species->MutationTypeWithID(_ReadCheckpoint<int32_t>(p_ptr, p_end));
+		slim_position_t position = _ReadCheckpoint<int64_t>(p_ptr, p_end);
+		slim_selcoeff_t selection_coeff = _ReadCheckpoint<slim_selcoeff_t>(p_ptr, p_end);
+		slim_objectid_t subpop_index = _ReadCheckpoint<int32_t>(p_ptr, p_end);
+		slim_tick_t origin_tick = _ReadCheckpoint<int32_t>(p_ptr, p_end);
+		slim_tick_t fixation_tick = _ReadCheckpoint<int32_t>(p_ptr, p_end);
+		int8_t nucleotide = _ReadCheckpoint<int8_t>(p_ptr, p_end);
+		slim_usertag_t substitution_tag = _ReadCheckpoint<int64_t>(p_ptr, p_end);
+		
+		if (!muttype)
+			_RaiseForCorruptCheckpoint();
+		
+		Substitution *substitution = new Substitution(mutation_id, muttype, position, selection_coeff, subpop_index, origin_tick, fixation_tick, nucleotide);
+		
+		substitution->tag_value_ = substitution_tag;
+		substitutions.emplace_back(substitution);
+	}
+	
+	// The order of the mutation registry, and mutation tags; mutations without references were not saved with the population
+	{
+		MutationRun &registry = p_species->population_.mutation_registry_;
+		MutationIndex *registry_begin = registry.begin_pointer();
+		int registry_size = registry.size();
+		std::unordered_map<slim_mutationid_t, MutationIndex> registry_lookup;
+		std::vector<MutationIndex> registry_order;
+		
+		for (int registry_index = 0; registry_index < registry_size; ++registry_index)
+			registry_lookup.emplace((gSLiM_Mutation_Block + registry_begin[registry_index])->mutation_id_, registry_begin[registry_index]);
+		
+		uint64_t registry_count = _ReadCheckpoint<uint64_t>(p_ptr, p_end);
+		
+		for (uint64_t registry_index = 0; registry_index < registry_count; ++registry_index)
+		{
+			slim_mutationid_t mutation_id = _ReadCheckpoint<int64_t>(p_ptr, p_end);
+			slim_usertag_t mutation_tag = _ReadCheckpoint<int64_t>(p_ptr, p_end);
+			auto lookup_iter = registry_lookup.find(mutation_id);
+			
+			if (lookup_iter != registry_lookup.end())
+			{
+				(gSLiM_Mutation_Block + lookup_iter->second)->tag_value_ = mutation_tag;
+				registry_order.emplace_back(lookup_iter->second);
+				registry_lookup.erase(lookup_iter);
+			}
+		}
+		
+		if (registry_lookup.size())
+			_RaiseForCorruptCheckpoint();
+		
+		std::copy(registry_order.begin(), registry_order.end(), registry_begin);
+	}
+	
+	// Subpopulations
+	uint32_t subpop_count = _ReadCheckpoint<uint32_t>(p_ptr, p_end);
+	
+	if (subpop_count != p_species->population_.subpops_.size())
+		_RaiseForCorruptCheckpoint();
+	
+	for (uint32_t subpop_index = 0; subpop_index < subpop_count; ++subpop_index)
+	{
+		Subpopulation *subpop = p_species->SubpopulationWithID(_ReadCheckpoint<int32_t>(p_ptr, p_end));
+		
+		if (!subpop)
+			_RaiseForCorruptCheckpoint();
+		
+		subpop->name_ = _ReadCheckpointString(p_ptr, p_end);
+		subpop->description_ = _ReadCheckpointString(p_ptr, p_end);
+		subpop->selfing_fraction_ = _ReadCheckpoint<double>(p_ptr, p_end);
+		subpop->female_clone_fraction_ = _ReadCheckpoint<double>(p_ptr, p_end);
+		subpop->male_clone_fraction_ = _ReadCheckpoint<double>(p_ptr, p_end);
+		
+		uint32_t migrant_count = _ReadCheckpoint<uint32_t>(p_ptr, p_end);
+		
+		subpop->migrant_fractions_.clear();
+		for (uint32_t migrant_index = 0; migrant_index < migrant_count; ++migrant_index)
+		{
+			slim_objectid_t source_id = _ReadCheckpoint<int32_t>(p_ptr, p_end);
+			
+			subpop->migrant_fractions_.emplace(source_id, _ReadCheckpoint<double>(p_ptr, p_end));
+		}
+		
+		subpop->has_null_genomes_ = _ReadCheckpoint<uint8_t>(p_ptr, p_end);
+		subpop->bounds_x0_ = _ReadCheckpoint<double>(p_ptr, p_end);
+		subpop->bounds_x1_ = _ReadCheckpoint<double>(p_ptr, p_end);
+		subpop->bounds_y0_ = _ReadCheckpoint<double>(p_ptr, p_end);
+		subpop->bounds_y1_ = _ReadCheckpoint<double>(p_ptr, p_end);
+		subpop->bounds_z0_ = _ReadCheckpoint<double>(p_ptr, p_end);
+		subpop->bounds_z1_ = _ReadCheckpoint<double>(p_ptr, p_end);
+		subpop->tag_value_ = _ReadCheckpoint<int64_t>(p_ptr, p_end);
+		subpop->subpop_fitness_scaling_ = _ReadCheckpoint<double>(p_ptr, p_end);
+		_ReadCheckpointVector(p_ptr, p_end, subpop->lifetime_reproductive_output_MH_);
+		_ReadCheckpointVector(p_ptr, p_end, subpop->lifetime_reproductive_output_F_);
+		subpop->individual_cached_fitness_OVERRIDE_ = _ReadCheckpoint<uint8_t>(p_ptr, p_end);
+		subpop->individual_cached_fitness_OVERRIDE_value_ = _ReadCheckpoint<double>(p_ptr, p_end);
+		
+		uint32_t map_count = _ReadCheckpoint<uint32_t>(p_ptr, p_end);
+		
+		for (uint32_t map_index = 0; map_index < map_count; ++map_index)
+		{
+			std::string map_name = _ReadCheckpointString(p_ptr, p_end);
+			EidosObject *map_object = _ReadObject(p_ptr, p_end);
+			
+			if (map_object->Class() != gSLiM_SpatialMap_Class)
+				_RaiseForCorruptCheckpoint();
+			
+			SpatialMap *map = (SpatialMap *)map_object;
+			
+			map->Retain();
+			subpop->spatial_maps_.emplace(map_name, map);
+		}
+		
+		double parent_sex_ratio = _ReadCheckpoint<double>(p_ptr, p_end);
+		slim_popsize_t child_subpop_size = _ReadCheckpoint<int32_t>(p_ptr, p_end);
+		double child_sex_ratio = _ReadCheckpoint<double>(p_ptr, p_end);
+		bool has_fitness_lookup = _ReadCheckpoint<uint8_t>(p_ptr, p_end);
+		
+		if (_ReadCheckpoint<uint64_t>(p_ptr, p_end) != subpop->parent_individuals_.size())
+			_RaiseForCorruptCheckpoint();
+		
+		for (Individual *individual : subpop->parent_individuals_)
+		{
+			individual->tag_value_ = _ReadCheckpoint<int64_t>(p_ptr, p_end);
+			individual->tagF_value_ = _ReadCheckpoint<double>(p_ptr, p_end);
+			
+			uint16_t tagL_bits = _ReadCheckpoint<uint16_t>(p_ptr, p_end);
+			
+			individual->tagL0_set_ = (tagL_bits >> 0) & 1;
+			individual->tagL0_value_ = (tagL_bits >> 1) & 1;
+			individual->tagL1_set_ = (tagL_bits >> 2) & 1;
+			individual->tagL1_value_ = (tagL_bits >> 3) & 1;
+			individual->tagL2_set_ = (tagL_bits >> 4) & 1;
+			individual->tagL2_value_ = (tagL_bits >> 5) & 1;
+			individual->tagL3_set_ = (tagL_bits >> 6) & 1;
+			individual->tagL3_value_ = (tagL_bits >> 7) & 1;
+			individual->tagL4_set_ = (tagL_bits >> 8) & 1;
+			individual->tagL4_value_ = (tagL_bits >> 9) & 1;
+			individual->migrant_ = _ReadCheckpoint<uint8_t>(p_ptr, p_end);
+			individual->fitness_scaling_ = _ReadCheckpoint<double>(p_ptr, p_end);
+			individual->cached_fitness_UNSAFE_ = _ReadCheckpoint<double>(p_ptr, p_end);
+			individual->color_set_ = _ReadCheckpoint<uint8_t>(p_ptr, p_end);
+			individual->colorR_ = _ReadCheckpoint<uint8_t>(p_ptr, p_end);
+			individual->colorG_ = _ReadCheckpoint<uint8_t>(p_ptr, p_end);
+			individual->colorB_ = _ReadCheckpoint<uint8_t>(p_ptr, p_end);
+			individual->mean_parent_age_ = _ReadCheckpoint<float>(p_ptr, p_end);
+			individual->pedigree_p1_ = _ReadCheckpoint<int64_t>(p_ptr, p_end);
+			individual->pedigree_p2_ = _ReadCheckpoint<int64_t>(p_ptr, p_end);
+			individual->pedigree_g1_ = _ReadCheckpoint<int64_t>(p_ptr, p_end);
+			individual->pedigree_g2_ = _ReadCheckpoint<int64_t>(p_ptr, p_end);
+			individual->pedigree_g3_ = _ReadCheckpoint<int64_t>(p_ptr, p_end);
+			individual->pedigree_g4_ = _ReadCheckpoint<int64_t>(p_ptr, p_end);
+			individual->reproductive_output_ = _ReadCheckpoint<int32_t>(p_ptr, p_end);
+		}
+		
+		if (_ReadCheckpoint<uint64_t>(p_ptr, p_end) != subpop->parent_genomes_.size())
+			_RaiseForCorruptCheckpoint();
+		
+		for (Genome *genome : subpop->parent_genomes_)
+			genome->tag_value_ = _ReadCheckpoint<int64_t>(p_ptr, p_end);
+		
+		// In WF models, the next tick draws parents from the fitness buffers and sizes its offspring generation from the child size
+		subpop->parent_sex_ratio_ = parent_sex_ratio;
+		
+		if (community_.model_type_ == SLiMModelType::kModelTypeWF)
+		{
+			if ((child_subpop_size != subpop->child_subpop_size_) || (child_sex_ratio != subpop->child_sex_ratio_))
+			{
+				subpop->child_subpop_size_ = child_subpop_size;
+				subpop->child_sex_ratio_ = child_sex_ratio;
+				subpop->GenerateChildrenToFitWF();
+			}
+			
+			subpop->UpdateWFFitnessBuffers(!has_fitness_lookup);
+		}
+	}
+}
+
+void SLiMCheckpoint::_ReadChunk_BLCK(const char *p_ptr, const char *p_end)
+{
+	std::vector<SLiMEidosBlock *> &blocks = community_.script_blocks_;
+	std::vector<SLiMEidosBlock *> restored_blocks;
+	uint32_t block_count = _ReadCheckpoint<uint32_t>(p_ptr, p_end);
+	
+	for (uint32_t block_index = 0; block_index < block_count; ++block_index)
+	{
+		bool programmatic = _ReadCheckpoint<uint8_t>(p_ptr, p_end);
+		SLiMEidosBlock *block = nullptr;
+		
+		if (!programmatic)
+		{
+			int32_t token_start = _ReadCheckpoint<int32_t>(p_ptr, p_end);
+			
+			for (SLiMEidosBlock *script_block : blocks)
+				if (!script_block->script_ && (script_block->root_node_->token_->token_start_ == token_start))
+				{
+					block = script_block;
+					break;
+				}
+			
+			if (!block)
+				_RaiseForCorruptCheckpoint();
+		}
+		
+		bool tick_range_evaluated = _ReadCheckpoint<uint8_t>(p_ptr, p_end);
+		bool tick_range_is_sequence = _ReadCheckpoint<uint8_t>(p_ptr, p_end);
+		slim_tick_t tick_start = _ReadCheckpoint<int32_t>(p_ptr, p_end);
+		slim_tick_t tick_end = _ReadCheckpoint<int32_t>(p_ptr, p_end);
+		uint64_t tick_set_count = _ReadCheckpoint<uint64_t>(p_ptr, p_end);
+		std::unordered_set<slim_tick_t> tick_set;
+		
+		for (uint64_t tick_index = 0; tick_index < tick_set_count; ++tick_index)
+			tick_set.emplace(_ReadCheckpoint<int32_t>(p_ptr, p_end));
+		
+		slim_usertag_t block_active = _ReadCheckpoint<int64_t>(p_ptr, p_end);
+		slim_usertag_t block_tag = _ReadCheckpoint<int64_t>(p_ptr, p_end);
+		
+		if (programmatic)
+		{
+			slim_objectid_t block_id = _ReadCheckpoint<int32_t>(p_ptr, p_end);
+			std::string script_string = _ReadCheckpointString(p_ptr, p_end);
+			SLiMEidosBlockType block_type = (SLiMEidosBlockType)_ReadCheckpoint<int32_t>(p_ptr, p_end);
+			int32_t species_spec_id = _ReadCheckpoint<int32_t>(p_ptr, p_end);
+			int32_t ticks_spec_id = _ReadCheckpoint<int32_t>(p_ptr, p_end);
+			Species *species_spec = (species_spec_id == -1) ? nullptr : community_.SpeciesWithID(species_spec_id);
+			Species *ticks_spec = (ticks_spec_id == -1) ? nullptr : community_.SpeciesWithID(ticks_spec_id);
+			
+			if (((species_spec_id != -1) && !species_spec) || ((ticks_spec_id != -1) && !ticks_spec))
+				_RaiseForCorruptCheckpoint();
+			
+			block = new SLiMEidosBlock(block_id, script_string, -1, block_type, tick_start, tick_end, species_spec, ticks_spec);
+			block->mutation_type_id_ = _ReadCheckpoint<int32_t>(p_ptr, p_end);
+			block->subpopulation_id_ = _ReadCheckpoint<int32_t>(p_ptr, p_end);
+			block->interaction_type_id_ = _ReadCheckpoint<int32_t>(p_ptr, p_end);
+			block->sex_specificity_ = _ReadCheckpoint<IndividualSex>(p_ptr, p_end);
+			block->vectorized_ = _ReadCheckpoint<uint8_t>(p_ptr, p_end);
+			
+			community_.AddScriptBlock(block, nullptr, nullptr);		// takes ownership from us
+		}
+		
+		block->tick_range_evaluated_ = tick_range_evaluated;
+		block->tick_range_is_sequence_ = tick_range_is_sequence;
+		block->tick_start_ = tick_start;
+		block->tick_end_ = tick_end;
+		block->tick_set_ = std::move(tick_set);
+		block->block_active_ = block_active;
+		block->tag_value_ = block_tag;
+		
+		restored_blocks.emplace_back(block);
+	}
+	
+	// Blocks from the script that are not in the checkpoint were deregistered before it was written, so we dispose of them now
+	for (SLiMEidosBlock *block : blocks)
+	{
+		if (std::find(restored_blocks.begin(), restored_blocks.end(), block) == restored_blocks.end())
+		{
+			if (block->block_id_ != -1)
+				community_.simulation_constants_->RemoveConstantForSymbol(block->ScriptBlockSymbolTableEntry().first);
+			
+			delete block;
+		}
+	}
+	
+	blocks = restored_blocks;
+	
+	community_.last_script_block_tick_cached_ = false;
+	community_.script_block_types_cached_ = false;
+	community_.scripts_changed_ = true;
+}
+
+void SLiMCheckpoint::_ReadChunk_INTR(const char *p_ptr, const char *p_end)
+{
+	uint32_t inttype_count = _ReadCheckpoint<uint32_t>(p_ptr, p_end);
+	
+	if (inttype_count != community_.interaction_types_.size())
+		EIDOS_TERMINATION << "ERROR (SLiMCheckpoint::RestoreState): the checkpoint file at " << file_path_ << " does not match the model's interaction types." << EidosTerminate();
+	
+	for (uint32_t inttype_index = 0; inttype_index < inttype_count; ++inttype_index)
+	{
+		InteractionType *inttype = community_.InteractionTypeWithID(_ReadCheckpoint<int32_t>(p_ptr, p_end));
+		
+		if (!inttype)
+			EIDOS_TERMINATION << "ERROR (SLiMCheckpoint::RestoreState): the checkpoint file at " << file_path_ << " does not match the model's interaction types." << EidosTerminate();
+		
+		inttype->max_distance_ = _ReadCheckpoint<double>(p_ptr, p_end);
+		inttype->max_distance_sq_ = _ReadCheckpoint<double>(p_ptr, p_end);
+		inttype->receiver_constraints_ = _ReadCheckpoint<InteractionConstraints>(p_ptr, p_end);
+		inttype->exerter_constraints_ = _ReadCheckpoint<InteractionConstraints>(p_ptr, p_end);
+		inttype->if_type_ = _ReadCheckpoint<SpatialKernelType>(p_ptr, p_end);
+		inttype->if_param1_ = _ReadCheckpoint<double>(p_ptr, p_end);
+		inttype->if_param2_ = _ReadCheckpoint<double>(p_ptr, p_end);
+		inttype->if_param3_ = _ReadCheckpoint<double>(p_ptr, p_end);
+		inttype->n_2param2sq_ = _ReadCheckpoint<double>(p_ptr, p_end);
+		inttype->tag_value_ = _ReadCheckpoint<int64_t>(p_ptr, p_end);
+		
+		std::vector<slim_objectid_t> evaluated_subpop_ids;
+		
+		_ReadCheckpointVector(p_ptr, p_end, evaluated_subpop_ids);
+		
+		for (slim_objectid_t subpop_id : evaluated_subpop_ids)
+		{
+			Subpopulation *subpop = community_.SubpopulationWithID(subpop_id);
+			
+			if (!subpop)
+				_RaiseForCorruptCheckpoint();
+			
+			inttype->EvaluateSubpopulation(subpop);
+		}
+	}
+}
+
+void SLiMCheckpoint::_ReadChunk_LOGF(const char *p_ptr, const char *p_end)
+{
+	uint32_t log_count = _ReadCheckpoint<uint32_t>(p_ptr, p_end);
+	
+	for (uint32_t log_index = 0; log_index < log_count; ++log_index)
+	{
+		LogFile *log_file = new LogFile(community_);
+		
+		community_.log_file_registry_.emplace_back(log_file);		// the registry takes over the retain count from new
+		
+		log_file->user_file_path_ = _ReadCheckpointString(p_ptr, p_end);
+		log_file->resolved_file_path_ = _ReadCheckpointString(p_ptr, p_end);
+		
+		uint64_t file_size = _ReadCheckpoint<uint64_t>(p_ptr, p_end);
+		
+		log_file->header_logged_ = _ReadCheckpoint<uint8_t>(p_ptr, p_end);
+		log_file->compress_ = _ReadCheckpoint<uint8_t>(p_ptr, p_end);
+		log_file->binary_ = _ReadCheckpoint<uint8_t>(p_ptr, p_end);
+		log_file->sep_ = _ReadCheckpointString(p_ptr, p_end);
+		log_file->float_precision_ = _ReadCheckpoint<int32_t>(p_ptr, p_end);
+		log_file->autologging_enabled_ = _ReadCheckpoint<uint8_t>(p_ptr, p_end);
+		log_file->log_interval_ = _ReadCheckpoint<int64_t>(p_ptr, p_end);
+		log_file->autolog_start_ = _ReadCheckpoint<int32_t>(p_ptr, p_end);
+		log_file->explicit_flushing_ = _ReadCheckpoint<uint8_t>(p_ptr, p_end);
+		log_file->flush_interval_ = _ReadCheckpoint<int64_t>(p_ptr, p_end);
+		log_file->tag_value_ = _ReadCheckpoint<int64_t>(p_ptr, p_end);
+		
+		uint32_t column_count = _ReadCheckpoint<uint32_t>(p_ptr, p_end);
+		
+		for (uint32_t column_index = 0; column_index < column_count; ++column_index)
+			log_file->column_names_.emplace_back(_ReadCheckpointString(p_ptr, p_end));
+		
+		uint32_t generator_count = _ReadCheckpoint<uint32_t>(p_ptr, p_end);
+		
+		for (uint32_t generator_index = 0; generator_index < generator_count; ++generator_index)
+		{
+			LogFileGeneratorType generator_type = (LogFileGeneratorType)_ReadCheckpoint<int32_t>(p_ptr, p_end);
+			EidosScript *generator_script = nullptr;
+			
+			if (_ReadCheckpoint<uint8_t>(p_ptr, p_end))
+			{
+				// this script parsed successfully when it was added, so it will again
+				generator_script = new EidosScript(_ReadCheckpointString(p_ptr, p_end), -1);
+				generator_script->Tokenize();
+				generator_script->ParseInterpreterBlockToAST(false);
+			}
+			
+			slim_objectid_t generator_objectid = _ReadCheckpoint<int32_t>(p_ptr, p_end);
+			EidosValue_SP generator_context;
+			
+			if (_ReadCheckpoint<uint8_t>(p_ptr, p_end))
+				generator_context = _ReadValue(p_ptr, p_end);
+			
+			log_file->generator_info_.emplace_back(generator_type, generator_script, generator_objectid, generator_context);
+		}
+		
+		if (log_file->binary_ && log_file->header_logged_)
+			log_file->binary_columns_.resize(log_file->column_names_.size());
+		
+		// Discard anything logged to the file after the checkpoint was written
+		struct stat file_info;
+		
+		if ((stat(log_file->resolved_file_path_.c_str(), &file_info) != 0) || ((uint64_t)file_info.st_size < file_size))
+			EIDOS_TERMINATION << "ERROR (SLiMCheckpoint::RestoreState): the log file at " << log_file->user_file_path_ << " is missing or shorter than when the checkpoint was written." << EidosTerminate();
+		
+		if (((uint64_t)file_info.st_size > file_size) && (truncate(log_file->resolved_file_path_.c_str(), (off_t)file_size) != 0))
+			EIDOS_TERMINATION << "ERROR (SLiMCheckpoint::RestoreState): could not truncate the log file at " << log_file->user_file_path_ << " to its length when the checkpoint was written." << EidosTerminate();
+	}
+}
+
+void SLiMCheckpoint::_ReadChunk_DICT(const char *p_ptr, const char *p_end)
+{
+	uint64_t owner_count = _ReadCheckpoint<uint64_t>(p_ptr, p_end);
+	
+	for (uint64_t owner_index = 0; owner_index < owner_count; ++owner_index)
+	{
+		EidosDictionaryUnretained *owner = dynamic_cast<EidosDictionaryUnretained *>(_ReadObject(p_ptr, p_end));
+		
+		if (!owner)
+			_RaiseForCorruptCheckpoint();
+		
+		_ReadDictionary(p_ptr, p_end, owner);
+	}
+}
+
+void SLiMCheckpoint::_ReadChunk_GLOB(const char *p_ptr, const char *p_end)
+{
+	// Symbols that are already defined, such as constants given with -d on the command line, take precedence over saved values
+	EidosSymbolTable &symbols = community_.SymbolTable();
+	
+	for (int pass = 0; pass < 2; ++pass)
+	{
+		uint32_t symbol_count = _ReadCheckpoint<uint32_t>(p_ptr, p_end);
+		
+		for (uint32_t symbol_index = 0; symbol_index < symbol_count; ++symbol_index)
+		{
+			EidosGlobalStringID symbol_id = EidosStringRegistry::GlobalStringIDForString(_ReadCheckpointString(p_ptr, p_end));
+			EidosValue_SP value = _ReadValue(p_ptr, p_end);
+			
+			if (symbols.ContainsSymbol(symbol_id))
+				continue;
+			
+			if (pass == 0)
+				symbols.DefineConstantForSymbol(symbol_id, value);
+			else
+				symbols.DefineGlobalForSymbol(symbol_id, value);
+		}
+	}
+}
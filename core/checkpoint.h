@@ -0,0 +1,156 @@
+//
+//  checkpoint.h
+//  SLiM
+//
+//  Created on 10/18/26.
+//  Copyright (c) 2026 Philipp Messer.  All rights reserved.
+//	A product of the Messer Lab, http://messerlab.org/slim/
+//
+
+//	This file is part of SLiM.
+//
+//	SLiM is free software: you can redistribute it and/or modify it under the terms of the GNU General Public License as published by
+//	the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+//
+//	SLiM is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+//	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+//
+//	You should have received a copy of the GNU General Public License along with SLiM.  If not, see <http://www.gnu.org/licenses/>.
+
+/*
+
+ The class SLiMCheckpoint reads and writes checkpoint files, which capture the complete state of a Community at the end of a tick
+ so that a long run can be resumed later with "slim -restore <checkpoint> <script>".  A checkpoint is requested from script with
+ community.outputCheckpoint(), and is written at the end of that tick, after the tick counter has advanced.
+
+ A checkpoint file begins with a header (the bytes "SLiMCKPT", a uint32_t format version, a uint32_t endianness tag, the SLiM
+ version string, and the model's script), followed by a series of chunks.  Each chunk is a four-character tag, a uint64_t payload
+ length, and the payload; chunks are generated and written one at a time, so that only one species (for example) is ever held in
+ memory in serialized form.  The file is written under a temporary name and renamed into place only once it is complete, so that
+ an interrupted write never replaces a good checkpoint.  The chunks, in order, are:
+
+	CMTY	community-level state: the tick, the seed, warning flags, and the next mutation and pedigree ids
+	INIT	the initialize...() calls made in tick 0, with their arguments
+	SPEC	one per species: type/chromosome state, the population (in the format of outputFull(binary=T)), and everything else
+	BLCK	script blocks: which blocks from the script remain, which were registered programmatically, and their schedules
+	INTR	InteractionType state, and which subpopulations were evaluated (they are re-evaluated on restore)
+	LOGF	LogFile objects, including the length of each file at checkpoint time
+	DICT	the Dictionary contents of SLiM objects (Species, Subpopulation, Individual, Mutation, etc.)
+	GLOB	user-defined constants and global variables
+	RAND	the state of the random number generators (one per thread, when running multithreaded)
+	END!	an empty chunk marking a complete file
+
+ Restoring does not run initialize() callbacks.  Instead, the initialize...() calls logged by Community during the original run are
+ replayed with their original arguments, rebuilding the same configuration without re-executing any user script; the remaining
+ chunks are then applied in place of the rest of tick 0.  Eidos values are written with their type, dimensions, and contents;
+ Dictionary, DataFrame, and SpatialMap objects are written inline the first time they are referenced (so that shared references
+ remain shared after restoring), and other SLiM objects are written as references by identifier.  Objects that cannot be referred
+ to in this way, such as Image objects, cause an error when the checkpoint is written.
+
+ */
+
+#ifndef checkpoint_h
+#define checkpoint_h
+
+#include "eidos_value.h"
+#include "slim_globals.h"
+
+#include <string>
+#include <vector>
+#include <unordered_map>
+
+
+class Community;
+class Species;
+class Mutation;
+class Substitution;
+class EidosDictionaryUnretained;
+
+
+// A record of one initialize...() call made in tick 0, kept by Community so that a checkpoint can replay it when restoring
+struct SLiMInitializeCall
+{
+	slim_objectid_t species_id_;					// the active species for the call, or -1 for a `species all` initialize() callback
+	std::string function_name_;
+	std::vector<EidosValue_SP> arguments_;			// copies of the arguments passed
+};
+
+
+class SLiMCheckpoint
+{
+	//	This class has its copy constructor and assignment operator disabled, to prevent accidental copying.
+
+private:
+
+	Community &community_;
+	std::string file_path_;													// the user's path, for error messages
+
+	// Restore state: the file contents, and the chunks found in them
+	std::string file_data_;
+	std::vector<std::pair<std::string, std::pair<const char *, const char *>>> chunks_;	// tag, and payload start/end
+
+	// Inline objects (Dictionary, DataFrame, SpatialMap), by their index in the file; when reading, each object here is retained
+	std::unordered_map<const EidosObject *, uint32_t> written_objects_;
+	std::vector<EidosObject *> read_objects_;
+
+	// The logged initialize...() calls not yet replayed, when restoring
+	const char *init_ptr_ = nullptr;
+	const char *init_end_ = nullptr;
+
+	// Lookup tables for references to substitutions (when writing) and mutations (when reading), built when first needed
+	std::unordered_map<const Substitution *, size_t> substitution_lookup_;
+	std::vector<std::unordered_map<slim_mutationid_t, Mutation *>> mutation_id_lookup_;
+
+	// Writing values and object references
+	void _WriteValue(std::string &p_buffer, const EidosValue *p_value);
+	void _WriteObject(std::string &p_buffer, EidosObject *p_object);
+	void _WriteDictionary(std::string &p_buffer, EidosDictionaryUnretained *p_dictionary);
+
+	// Writing chunks
+	void _WriteChunk_CMTY(std::string &p_buffer);
+	void _WriteChunk_INIT(std::string &p_buffer);
+	void _WriteChunk_SPEC(std::string &p_buffer, Species *p_species);
+	void _WriteChunk_BLCK(std::string &p_buffer);
+	void _WriteChunk_INTR(std::string &p_buffer);
+	void _WriteChunk_LOGF(std::string &p_buffer);
+	void _WriteChunk_DICT(std::string &p_buffer);
+	void _WriteChunk_GLOB(std::string &p_buffer);
+
+	// Reading values and object references; these advance p_ptr, and raise if it would pass p_end
+	EidosValue_SP _ReadValue(const char *&p_ptr, const char *p_end);
+	EidosObject *_ReadObject(const char *&p_ptr, const char *p_end);
+	void _ReadDictionary(const char *&p_ptr, const char *p_end, EidosDictionaryUnretained *p_dictionary);
+
+	// Reading chunks
+	const char *_ChunkPayload(const std::string &p_tag, int p_occurrence, const char **p_end);
+	void _ReadChunk_SPEC(const char *p_ptr, const char *p_end, Species *p_species);
+	void _ReadChunk_BLCK(const char *p_ptr, const char *p_end);
+	void _ReadChunk_INTR(const char *p_ptr, const char *p_end);
+	void _ReadChunk_LOGF(const char *p_ptr, const char *p_end);
+	void _ReadChunk_DICT(const char *p_ptr, const char *p_end);
+	void _ReadChunk_GLOB(const char *p_ptr, const char *p_end);
+
+	SLiMCheckpoint(Community &p_community, const std::string &p_file_path);
+
+public:
+
+	SLiMCheckpoint(const SLiMCheckpoint&) = delete;					// no copying
+	SLiMCheckpoint& operator=(const SLiMCheckpoint&) = delete;		// no copying
+	SLiMCheckpoint(void) = delete;									// no null construction
+	~SLiMCheckpoint(void);
+
+	// Write a checkpoint of p_community to p_file_path; this should be called only at the end of a tick
+	static void WriteCheckpoint(Community &p_community, const std::string &p_file_path);
+
+	// Read a checkpoint file and check that it matches the community's script; the state is applied later, by the methods below
+	static SLiMCheckpoint *ReadCheckpoint(Community &p_community, const std::string &p_file_path);
+
+	// Replay the logged initialize...() calls for one species (or for `species all` callbacks, if p_species is nullptr)
+	void ReplayInitializeCalls(Species *p_species);
+
+	// Apply the rest of the checkpoint, after the initialize...() calls have been replayed; returns the tick to resume at
+	slim_tick_t RestoreState(void);
+};
+
+
+#endif /* checkpoint_h */
@@ -107,6 +107,12 @@ Community::~Community(void)
 {
 	//EIDOS_ERRSTREAM << "Community::~Community" << std::endl;
 	
+	if (restore_checkpoint_)
+	{
+		delete restore_checkpoint_;
+		restore_checkpoint_ = nullptr;
+	}
+	
 	// our log file registry retains all log files
 	for (LogFile *log_file : log_file_registry_)
 		log_file->Release();
@@ -465,6 +471,26 @@ void Community::FinishInitialization(void)
 	}
 }
 
+void Community::RestoreFromCheckpoint(const std::string &p_file_path)
+{
+	// The checkpoint is read and checked now, but applied during initialization; see AllSpecies_RunInitializeCallbacks()
+	if (restore_checkpoint_)
+		EIDOS_TERMINATION << "ERROR (Community::RestoreFromCheckpoint): (internal error) a checkpoint is already being restored." << EidosTerminate();
+	
+	restore_checkpoint_ = SLiMCheckpoint::ReadCheckpoint(*this, Eidos_ResolvedPath(p_file_path));
+}
+
+void Community::WritePendingCheckpoint(void)
+{
+	if (pending_checkpoint_path_.length())
+	{
+		std::string file_path;
+		
+		std::swap(file_path, pending_checkpoint_path_);
+		SLiMCheckpoint::WriteCheckpoint(*this, file_path);
+	}
+}
+
 void Community::ValidateScriptBlockCaches(void)
 {
 #if DEBUG_BLOCK_REG_DEREG
@@ -2188,6 +2214,29 @@ void Community::AllSpecies_RunInitializeCallbacks(void)
 	// we're done with the initialization tick, so remove the zero-tick functions
 	RemoveZeroTickFunctionsFromMap(simulation_functions_);
 	
+	// when restoring from a checkpoint, the rest of its state is applied now, and we resume at the tick it was written for
+	if (restore_checkpoint_)
+	{
+		slim_tick_t restored_tick = restore_checkpoint_->RestoreState();
+		
+		delete restore_checkpoint_;
+		restore_checkpoint_ = nullptr;
+		
+		if (SLiM_verbosity_level >= 1)
+			SLIM_OUTSTREAM << "\n// Resuming run from checkpoint at tick <tick>:\n" << restored_tick << " " << "\n" << std::endl;
+		
+		SetTick(restored_tick);
+		
+#if (SLIMPROFILING == 1)
+		// PROFILING
+		SLIM_PROFILE_BLOCK_END(profile_stage_totals_[0]);
+#endif
+		
+		gEidosErrorContext.currentScript = nullptr;
+		gEidosErrorContext.executingRuntimeScript = false;
+		return;
+	}
+	
 	// BCH 3/6/2024: Here is where we now determine the tick ranges for script blocks; we now
 	// do this in a deferred fashion to allow tick ranges to contain constant expressions.
 	// It needs to be done before the call to FirstTick() below so tick ranges are valid.
@@ -2232,10 +2281,18 @@ void Community::RunInitializeCallbacks(void)
 	num_modeltype_declarations_ = 0;
 	
 	// execute `species all` initialize() callbacks, which should always have a tick of 0 set
-	std::vector<SLiMEidosBlock*> init_blocks = ScriptBlocksMatching(0, SLiMEidosBlockType::SLiMEidosInitializeCallback, -1, -1, -1, nullptr);
-	
-	for (auto script_block : init_blocks)
-		ExecuteEidosEvent(script_block);
+	// when restoring from a checkpoint, the logged initialize...() calls are replayed instead of running the callbacks
+	if (restore_checkpoint_)
+	{
+		restore_checkpoint_->ReplayInitializeCalls(nullptr);
+	}
+	else
+	{
+		std::vector<SLiMEidosBlock*> init_blocks = ScriptBlocksMatching(0, SLiMEidosBlockType::SLiMEidosInitializeCallback, -1, -1, -1, nullptr);
+		
+		for (auto script_block : init_blocks)
+			ExecuteEidosEvent(script_block);
+	}
 	
 	// check for complete initialization
 	
@@ -2740,6 +2797,9 @@ bool Community::_RunOneTickWF(void)
 			if (species->Active())
 				species->AdvanceCycleCounter();
 		
+		// Write a checkpoint requested during this tick, now that the tick is complete
+		WritePendingCheckpoint();
+		
 #if (SLIMPROFILING == 1)
 		// PROFILING
 		if (gEidosProfilingClientCount)
@@ -3146,6 +3206,9 @@ bool Community::_RunOneTickNonWF(void)
 					subpop_pair.second->IncrementIndividualAges();
 		}
 		
+		// Write a checkpoint requested during this tick, now that the tick is complete
+		WritePendingCheckpoint();
+		
 #if (SLIMPROFILING == 1)
 		// PROFILING
 		if (gEidosProfilingClientCount)
@@ -3181,6 +3244,10 @@ void Community::SimulationHasFinished(void)
 	for (Species *species : all_species_)
 		species->SimulationHasFinished();
 	
+	// Write out any rows that binary log files have buffered
+	for (LogFile *log_file : log_file_registry_)
+		log_file->WriteBinaryRowGroup();
+	
 	// Error on any script blocks that never got scheduled
 	FlagUnevaluatedScriptBlockTickRanges();
 }
@@ -3219,6 +3286,8 @@ void Community::TabulateSLiMMemoryUsage_Community(SLiMMemoryUsage_Community *p_u
 	for (auto const &filebuf_pair : gEidosBufferedZipAppendData)
 		p_usage->fileBuffers += filebuf_pair.second.capacity();
 	
+	p_usage->fileBuffers += Eidos_QueuedFileWriteBytes();
+	
 	// Total
 	SumUpMemoryUsage_Community(*p_usage);
 }
@@ -37,6 +37,7 @@
 #include "eidos_value.h"
 #include "eidos_functions.h"
 #include "slim_eidos_block.h"
+#include "checkpoint.h"
 
 
 class EidosInterpreter;
@@ -62,6 +63,8 @@ class Community : public EidosDictionaryUnretained
 	
 private:
 	typedef EidosDictionaryUnretained super;
+	
+	friend class SLiMCheckpoint;				// reads and writes private state for checkpointing
 
 private:
 	// the way we handle script blocks is complicated and is private even against SLiMgui
@@ -136,6 +139,11 @@ private:
 	// LogFile registry, for logging data out to a file
 	std::vector<LogFile *> log_file_registry_;										// OWNED POINTERS (under retain/release)
 	
+	// checkpointing; see checkpoint.h
+	std::vector<SLiMInitializeCall> initialize_calls_;								// the initialize...() calls made in tick 0, for replay when restoring
+	SLiMCheckpoint *restore_checkpoint_ = nullptr;									// OWNED POINTER; the checkpoint being restored, during initialization only
+	std::string pending_checkpoint_path_;											// a checkpoint requested by outputCheckpoint(), written at the end of the tick
+	
 public:
 	
 	bool is_explicit_species_ = false;												// true if we have explicit species declarations (even if only one, even if named "sim")
@@ -200,6 +208,9 @@ public:
 	void InitializeFromFile(std::istream &p_infile);								// parse an input file; call after construction
 	void InitializeRNGFromSeed(unsigned long int *p_override_seed_ptr);				// call after InitializeFromFile(), generally
 	void FinishInitialization(void);												// call last, after InitializeRNGFromSeed()
+	void RestoreFromCheckpoint(const std::string &p_file_path);						// optionally call after FinishInitialization(), to resume a checkpointed run
+	void WritePendingCheckpoint(void);												// write a checkpoint requested by outputCheckpoint(), at the end of a tick
+	inline SLiMCheckpoint *RestoreCheckpoint(void) const { return restore_checkpoint_; }
 	
 	void TabulateSLiMMemoryUsage_Community(SLiMMemoryUsage_Community *p_usage, EidosSymbolTable *p_current_symbols);		// used by outputUsage() and SLiMgui profiling
 	
@@ -370,6 +381,7 @@ public:
 	EidosValue_SP ExecuteMethod_speciesWithIDs(EidosGlobalStringID p_method_id, const std::vector<EidosValue_SP> &p_arguments, EidosInterpreter &p_interpreter);
 	EidosValue_SP ExecuteMethod_subpopulationsWithIDs(EidosGlobalStringID p_method_id, const std::vector<EidosValue_SP> &p_arguments, EidosInterpreter &p_interpreter);
 	EidosValue_SP ExecuteMethod_subpopulationsWithNames(EidosGlobalStringID p_method_id, const std::vector<EidosValue_SP> &p_arguments, EidosInterpreter &p_interpreter);
+	EidosValue_SP ExecuteMethod_outputCheckpoint(EidosGlobalStringID p_method_id, const std::vector<EidosValue_SP> &p_arguments, EidosInterpreter &p_interpreter);
 	EidosValue_SP ExecuteMethod_outputUsage(EidosGlobalStringID p_method_id, const std::vector<EidosValue_SP> &p_arguments, EidosInterpreter &p_interpreter);
 	EidosValue_SP ExecuteMethod_registerFirstEarlyLateEvent(EidosGlobalStringID p_method_id, const std::vector<EidosValue_SP> &p_arguments, EidosInterpreter &p_interpreter);
 	EidosValue_SP ExecuteMethod_registerInteractionCallback(EidosGlobalStringID p_method_id, const std::vector<EidosValue_SP> &p_arguments, EidosInterpreter &p_interpreter);
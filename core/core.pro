@@ -80,6 +80,7 @@ else:unix: PRE_TARGETDEPS += $$OUT_PWD/../treerec/tskit/libtskit.a
 
 
 SOURCES += \
+    checkpoint.cpp \
     chromosome.cpp \
     community.cpp \
     community_eidos.cpp \
@@ -110,6 +111,7 @@ SOURCES += \
     substitution.cpp
 
 HEADERS += \
+    checkpoint.h \
     chromosome.h \
     community.h \
     genome.h \
@@ -1297,39 +1297,240 @@ EidosValue_SP Genome::ExecuteMethod_sumOfMutationsOfType(EidosGlobalStringID p_m
 	return EidosValue_SP(new (gEidosValuePool->AllocateChunk()) EidosValue_Float(selcoeff_sum));
 }
 
-// print the sample represented by genomes, using SLiM's own format
-void Genome::PrintGenomes_SLiM(std::ostream &p_out, std::vector<Genome *> &p_genomes, slim_objectid_t p_source_subpop_id)
+// Tallies the mutations carried by a sample of genomes, for the sample output functions below.  Genomes commonly share mutation runs,
+// so the uses of each distinct run are counted first, and then the mutations in each distinct run are tallied once, into a scratch
+// array indexed by MutationIndex; this replaces building a PolymorphismMap one mutation at a time.  The scratch array is kept between
+// calls, so that repeated sample outputs (several in the same tick, for example) do not each allocate and zero an array the size of
+// the mutation block; only the entries for the sample's mutations are used, and they are cleared again when the tally is destroyed.
+class GenomeSampleTally
+{
+public:
+	std::vector<const Mutation *> mutations_;	// the distinct mutations in the sample, in order of first occurrence
+	int32_t *scratch_;							// the prevalence of each mutation in the sample, by MutationIndex; callers may reuse entries
+	
+	explicit GenomeSampleTally(const std::vector<Genome *> &p_genomes);
+	~GenomeSampleTally(void);
+};
+
+static std::vector<int32_t> gSLiM_SampleTallyScratch;		// all zero outside of a GenomeSampleTally's lifetime
+
+GenomeSampleTally::GenomeSampleTally(const std::vector<Genome *> &p_genomes)
 {
+	THREAD_SAFETY_IN_ACTIVE_PARALLEL("GenomeSampleTally::GenomeSampleTally(): usage of statics");
+	
+	// count the uses of each distinct run, keeping the runs in order of first use so that mutations_ is in order of first occurrence
+	robin_hood::unordered_flat_map<const MutationRun *, size_t> run_indices;
+	std::vector<std::pair<const MutationRun *, slim_refcount_t>> run_use_counts;
+	
+	for (Genome *genome : p_genomes)
+	{
+		if (!genome->IsNull())
+		{
+			for (int run_index = 0; run_index < genome->mutrun_count_; ++run_index)
+			{
+				const MutationRun *mutrun = genome->mutruns_[run_index];
+				auto inserted = run_indices.emplace(mutrun, run_use_counts.size());
+				
+				if (inserted.second)
+					run_use_counts.emplace_back(mutrun, 1);
+				else
+					run_use_counts[inserted.first->second].second++;
+			}
+		}
+	}
+	
+	// tally the mutations in each distinct run
+	size_t scratch_size = (size_t)gSLiM_Mutation_Block_LastUsedIndex + 1;
+	
+	if (gSLiM_SampleTallyScratch.size() < scratch_size)
+		gSLiM_SampleTallyScratch.resize(scratch_size, 0);
+	
 	Mutation *mut_block_ptr = gSLiM_Mutation_Block;
-	slim_popsize_t sample_size = (slim_popsize_t)p_genomes.size();
 	
-	// get the polymorphisms within the sample
-	PolymorphismMap polymorphisms;
+	scratch_ = gSLiM_SampleTallyScratch.data();
 	
-	for (slim_popsize_t s = 0; s < sample_size; s++)
+	for (auto &run_use_count : run_use_counts)
 	{
-		Genome &genome = *p_genomes[s];
+		const MutationRun *mutrun = run_use_count.first;
+		slim_refcount_t use_count = run_use_count.second;
+		int mut_count = mutrun->size();
+		const MutationIndex *mut_ptr = mutrun->begin_pointer_const();
 		
-		if (genome.IsNull())
-			EIDOS_TERMINATION << "ERROR (Genome::PrintGenomes_SLiM): cannot output null genomes." << EidosTerminate();
+		for (int mut_index = 0; mut_index < mut_count; ++mut_index)
+		{
+			int32_t &prevalence = scratch_[mut_ptr[mut_index]];
+			
+			if (prevalence == 0)
+				mutations_.emplace_back(mut_block_ptr + mut_ptr[mut_index]);
+			
+			prevalence += use_count;
+		}
+	}
+}
+
+GenomeSampleTally::~GenomeSampleTally(void)
+{
+	for (const Mutation *mutation : mutations_)
+		scratch_[mutation->BlockIndex()] = 0;
+}
+
+// The sites of a sample of genomes, for MS and .hap output, and optionally a bit-packed haplotype matrix over them.  The sites are the
+// distinct mutations in the sample (or only those that are polymorphic within the sample, if monomorphic sites are filtered), sorted
+// by position as in MS output; while the object exists, the tally's scratch entry for each mutation holds its site index plus one, or
+// 0 if it is not a site.  FillBits() builds the matrix, which packs the genomes 64 to a word: for each block of 64 genomes there is
+// one word per site, in which bit b is set if genome (64 * block + b) carries that site's mutation.  Each block's words are contiguous,
+// so that filling in a block stays within a small region of memory.  A mutation's run index is determined by its position, so the
+// sites in different run indices are disjoint; the matrix is therefore filled in parallel across run indices and blocks, each task
+// setting bits only in its own words.  Within a block, a run shared by several genomes is scanned only once, for all of them.
+class GenomeHaplotypeMatrix
+{
+public:
+	GenomeSampleTally tally_;					// scratch_ maps each mutation's MutationIndex to its site index plus one
+	std::vector<const Mutation *> sites_;		// the mutation at each site, in order of position
+	size_t genome_count_;
+	size_t block_count_;						// the number of 64-genome blocks, rounded up
+	std::vector<uint64_t> bits_;				// block_count_ blocks of sites_.size() words each; empty until FillBits() is called
+	
+	GenomeHaplotypeMatrix(const std::vector<Genome *> &p_genomes, bool p_filter_monomorphic);
+	void FillBits(const std::vector<Genome *> &p_genomes);
+	
+	inline const uint64_t *BlockWords(size_t p_block) const { return bits_.data() + p_block * sites_.size(); }
+};
+
+GenomeHaplotypeMatrix::GenomeHaplotypeMatrix(const std::vector<Genome *> &p_genomes, bool p_filter_monomorphic) : tally_(p_genomes), genome_count_(p_genomes.size()), block_count_((p_genomes.size() + 63) / 64)
+{
+	// BCH 7 Nov. 2016: sort the polymorphisms by position since that is the expected sort
+	// order in MS output.  In other types of output, sorting by the mutation id seems to
+	// be fine.  We sort starting from mutation id order, as a PolymorphismMap would give,
+	// to keep the same order of mutations at a given position.
+	std::vector<Polymorphism> sorted_polymorphisms;
+	
+	std::sort(tally_.mutations_.begin(), tally_.mutations_.end(), [](const Mutation *p_l, const Mutation *p_r) { return p_l->mutation_id_ < p_r->mutation_id_; });
+	sorted_polymorphisms.reserve(tally_.mutations_.size());
+	
+	for (const Mutation *mutation : tally_.mutations_)
+	{
+		sorted_polymorphisms.emplace_back((slim_polymorphismid_t)sorted_polymorphisms.size(), mutation, tally_.scratch_[mutation->BlockIndex()]);
 		
-		for (int run_index = 0; run_index < genome.mutrun_count_; ++run_index)
+		// the scratch entry for each mutation will hold its site index plus one, or 0 if it is filtered out below
+		tally_.scratch_[mutation->BlockIndex()] = 0;
+	}
+	
+	std::sort(sorted_polymorphisms.begin(), sorted_polymorphisms.end());
+	
+	// if requested, remove polymorphisms that are not polymorphic within the sample
+	sites_.reserve(sorted_polymorphisms.size());
+	
+	for (const Polymorphism &polymorphism : sorted_polymorphisms)
+	{
+		if (p_filter_monomorphic && ((size_t)polymorphism.prevalence_ == genome_count_))
+			continue;
+		
+		sites_.emplace_back(polymorphism.mutation_ptr_);
+		tally_.scratch_[polymorphism.mutation_ptr_->BlockIndex()] = (int32_t)sites_.size();
+	}
+}
+
+void GenomeHaplotypeMatrix::FillBits(const std::vector<Genome *> &p_genomes)
+{
+	bits_.resize(block_count_ * sites_.size(), 0);
+	
+	if (sites_.size() == 0)
+		return;
+	
+	// all genomes in the sample belong to one species, and so have the same run count
+	const int32_t *site_plus_one_lookup = tally_.scratch_;
+	uint64_t *bits_data = bits_.data();
+	size_t genome_count = genome_count_;
+	size_t site_count = sites_.size();
+	int64_t block_count = (int64_t)block_count_;
+	int64_t mutrun_count = p_genomes[0]->mutrun_count_;
+	int64_t task_count = mutrun_count * block_count;
+	
+	EIDOS_THREAD_COUNT(gEidos_OMP_threads_HAPLOTYPE_MATRIX);
+#pragma omp parallel for schedule(dynamic, 1) default(none) shared(p_genomes, site_plus_one_lookup, bits_data, genome_count, site_count, block_count, task_count) if(task_count >= EIDOS_OMPMIN_HAPLOTYPE_MATRIX) num_threads(thread_count)
+	for (int64_t task_index = 0; task_index < task_count; ++task_index)
+	{
+		int run_index = (int)(task_index / block_count);
+		size_t block_index = (size_t)(task_index % block_count);
+		uint64_t *block_words = bits_data + block_index * site_count;
+		size_t first_genome = block_index * 64;
+		size_t end_genome = std::min(first_genome + 64, genome_count);
+		
+		// find the distinct runs used by the genomes in this block, and the genomes that use each of them
+		std::pair<const MutationRun *, uint64_t> block_runs[64];
+		int block_run_count = 0;
+		
+		for (size_t genome_index = first_genome; genome_index < end_genome; ++genome_index)
 		{
-			const MutationRun *mutrun = genome.mutruns_[run_index];
+			const MutationRun *mutrun = p_genomes[genome_index]->mutruns_[run_index];
+			uint64_t genome_bit = (uint64_t)1 << (genome_index - first_genome);
+			int block_run_index;
+			
+			for (block_run_index = 0; block_run_index < block_run_count; ++block_run_index)
+			{
+				if (block_runs[block_run_index].first == mutrun)
+				{
+					block_runs[block_run_index].second |= genome_bit;
+					break;
+				}
+			}
+			
+			if (block_run_index == block_run_count)
+				block_runs[block_run_count++] = std::pair<const MutationRun *, uint64_t>(mutrun, genome_bit);
+		}
+		
+		// set the bits for each run's mutations; filtered mutations have a site index plus one of 0
+		for (int block_run_index = 0; block_run_index < block_run_count; ++block_run_index)
+		{
+			const MutationRun *mutrun = block_runs[block_run_index].first;
+			uint64_t genome_bits = block_runs[block_run_index].second;
 			int mut_count = mutrun->size();
 			const MutationIndex *mut_ptr = mutrun->begin_pointer_const();
 			
 			for (int mut_index = 0; mut_index < mut_count; ++mut_index)
-				AddMutationToPolymorphismMap(&polymorphisms, mut_block_ptr + mut_ptr[mut_index]);
+			{
+				int32_t site_plus_one = site_plus_one_lookup[mut_ptr[mut_index]];
+				
+				if (site_plus_one)
+					block_words[site_plus_one - 1] |= genome_bits;
+			}
 		}
 	}
+}
+
+// print the sample represented by genomes, using SLiM's own format
+void Genome::PrintGenomes_SLiM(std::ostream &p_out, std::vector<Genome *> &p_genomes, slim_objectid_t p_source_subpop_id)
+{
+	slim_popsize_t sample_size = (slim_popsize_t)p_genomes.size();
+	
+	for (slim_popsize_t s = 0; s < sample_size; s++)
+		if (p_genomes[s]->IsNull())
+			EIDOS_TERMINATION << "ERROR (Genome::PrintGenomes_SLiM): cannot output null genomes." << EidosTerminate();
+	
+	// get the polymorphisms within the sample; each polymorphism's id is its index in order of first occurrence, as a PolymorphismMap
+	// would assign, and they are printed in mutation id order, as a PolymorphismMap would iterate
+	GenomeSampleTally tally(p_genomes);
+	std::vector<Polymorphism> polymorphisms;
+	
+	polymorphisms.reserve(tally.mutations_.size());
+	
+	for (const Mutation *mutation : tally.mutations_)
+		polymorphisms.emplace_back((slim_polymorphismid_t)polymorphisms.size(), mutation, tally.scratch_[mutation->BlockIndex()]);
+	
+	std::sort(polymorphisms.begin(), polymorphisms.end(), [](const Polymorphism &p_l, const Polymorphism &p_r) { return p_l.mutation_ptr_->mutation_id_ < p_r.mutation_ptr_->mutation_id_; });
 	
 	// print the sample's polymorphisms; NOTE the output format changed due to the addition of mutation_id_, BCH 11 June 2016
 	// NOTE the output format changed due to the addition of the nucleotide, BCH 2 March 2019
 	p_out << "Mutations:"  << std::endl;
 	
-	for (const PolymorphismPair &polymorphism_pair : polymorphisms) 
-		polymorphism_pair.second.Print_ID(p_out);
+	for (const Polymorphism &polymorphism : polymorphisms)
+	{
+		polymorphism.Print_ID(p_out);
+		
+		// the scratch entry for each mutation now holds its polymorphism id, for lookup below
+		tally.scratch_[polymorphism.mutation_ptr_->BlockIndex()] = polymorphism.polymorphism_id_;
+	}
 	
 	// print the sample's genomes
 	p_out << "Genomes:" << std::endl;
@@ -1352,14 +1553,7 @@ void Genome::PrintGenomes_SLiM(std::ostream &p_out, std::vector<Genome *> &p_gen
 			const MutationIndex *mut_ptr = mutrun->begin_pointer_const();
 			
 			for (int mut_index = 0; mut_index < mut_count; ++mut_index)
-			{
-				slim_polymorphismid_t polymorphism_id = FindMutationInPolymorphismMap(polymorphisms, mut_block_ptr + mut_ptr[mut_index]);
-				
-				if (polymorphism_id == -1)
-					EIDOS_TERMINATION << "ERROR (Genome::PrintGenomes_SLiM): (internal error) polymorphism not found." << EidosTerminate();
-				
-				p_out << " " << polymorphism_id;
-			}
+				p_out << " " << tally.scratch_[mut_ptr[mut_index]];
 		}
 		
 		p_out << std::endl;
@@ -1369,24 +1563,56 @@ void Genome::PrintGenomes_SLiM(std::ostream &p_out, std::vector<Genome *> &p_gen
 // print the sample represented by genomes, using "ms" format
 void Genome::PrintGenomes_MS(std::ostream &p_out, std::vector<Genome *> &p_genomes, const Chromosome &p_chromosome, bool p_filter_monomorphic)
 {
-	Mutation *mut_block_ptr = gSLiM_Mutation_Block;
 	slim_popsize_t sample_size = (slim_popsize_t)p_genomes.size();
 	
-	// BCH 7 Nov. 2016: sort the polymorphisms by position since that is the expected sort
-	// order in MS output.  In other types of output, sorting by the mutation id seems to
-	// be fine.
-	std::vector<Polymorphism> sorted_polymorphisms;
+	for (slim_popsize_t s = 0; s < sample_size; s++)
+		if (p_genomes[s]->IsNull())
+			EIDOS_TERMINATION << "ERROR (Genome::PrintGenomes_MS): cannot output null genomes." << EidosTerminate();
+	
+	GenomeHaplotypeMatrix matrix(p_genomes, p_filter_monomorphic);
+	size_t site_count = matrix.sites_.size();
 	
+	// print header
+	p_out << "//" << std::endl << "segsites: " << site_count << std::endl;
+	
+	// print the sample's positions; these are formatted into a buffer with snprintf(), exactly as the stream would format them with
+	// std::fixed and std::setprecision(15), and written out together
+	if (site_count > 0)
 	{
-		// get the polymorphisms within the sample
-		PolymorphismMap polymorphisms;
+		std::string positions_line("positions:");
+		char double_buf[40];
 		
-		for (slim_popsize_t s = 0; s < sample_size; s++)
+		positions_line.reserve(positions_line.size() + site_count * 18 + 1);
+		
+		// BCH 26 Jan. 2020: increasing the precision from 7 to 10, so longer chromosomes work; maybe this should be a parameter?
+		// BCH 23 July 2020: increasing from 10 to 15, which is the limit of double-precision floats anyway
+		for (const Mutation *mutation : matrix.sites_)
 		{
-			Genome &genome = *p_genomes[s];
+			int length = snprintf(double_buf, 40, " %.15f", static_cast<double>(mutation->position_) / p_chromosome.last_position_);	// this prints positions as being in the interval [0,1], which Philipp decided was the best policy
 			
-			if (genome.IsNull())
-				EIDOS_TERMINATION << "ERROR (Genome::PrintGenomes_MS): cannot output null genomes." << EidosTerminate();
+			positions_line.append(double_buf, (size_t)length);
+		}
+		
+		positions_line.push_back('\n');
+		p_out.write(positions_line.data(), (std::streamsize)positions_line.size());
+	}
+	
+	// print the sample's genotypes; each genome's '1' characters are set in a line of '0' characters, which is written out, and then
+	// they are cleared again, so that the line never needs to be refilled.  Genomes usually carry few of the sample's mutations, so this
+	// is much faster than expanding the rows of a bit-packed matrix (FillBits() is not needed here).
+	std::string line(site_count + 1, '0');
+	char *line_ptr = &line[0];
+	const int32_t *site_plus_one_lookup = matrix.tally_.scratch_;
+	
+	line[site_count] = '\n';
+	
+	for (slim_popsize_t j = 0; j < sample_size; j++)														// go through all individuals
+	{
+		Genome &genome = *p_genomes[j];
+		
+		for (int pass = 0; pass < 2; ++pass)
+		{
+			char genotype_char = (pass == 0) ? '1' : '0';
 			
 			for (int run_index = 0; run_index < genome.mutrun_count_; ++run_index)
 			{
@@ -1395,102 +1621,102 @@ void Genome::PrintGenomes_MS(std::ostream &p_out, std::vector<Genome *> &p_genom
 				const MutationIndex *mut_ptr = mutrun->begin_pointer_const();
 				
 				for (int mut_index = 0; mut_index < mut_count; ++mut_index)
-					AddMutationToPolymorphismMap(&polymorphisms, mut_block_ptr + mut_ptr[mut_index]);
+				{
+					int32_t site_plus_one = site_plus_one_lookup[mut_ptr[mut_index]];
+					
+					// BCH 4/24/2019: when p_filter_monomorphic is true, mutations in a given genome may not be in the genotype string
+					if (site_plus_one)
+						line_ptr[site_plus_one - 1] = genotype_char;
+				}
 			}
+			
+			if (pass == 0)
+				p_out.write(line_ptr, (std::streamsize)(site_count + 1));
 		}
-		
-		for (const PolymorphismPair &polymorphism_pair : polymorphisms)
-			sorted_polymorphisms.emplace_back(polymorphism_pair.second);
-		
-		std::sort(sorted_polymorphisms.begin(), sorted_polymorphisms.end());
 	}
 	
-	// if requested, remove polymorphisms that are not polymorphic within the sample
-	if (p_filter_monomorphic)
-	{
-		std::vector<Polymorphism> filtered_polymorphisms;
-		
-		for (Polymorphism &p : sorted_polymorphisms)
-			if (p.prevalence_ != sample_size)
-				filtered_polymorphisms.emplace_back(p);
-		
-		std::swap(sorted_polymorphisms, filtered_polymorphisms);
-	}
+	p_out.flush();
+}
+
+// The .hap format written by Genome::WriteGenomes_Haplotypes(): the magic bytes "SLiMHaps", a uint32_t format version, a uint32_t
+// endianness tag, uint64_t counts of genomes and sites, an int64_t last chromosome position (for scaling positions as MS output does),
+// then an int64_t position and an int64_t mutation id for each site, and finally the bits of GenomeHaplotypeMatrix, as uint64_t words
+// (for each block of 64 genomes, one word per site; bit (j % 64) of word s in block (j / 64) is set if genome j carries site s).
+// All values are in native byte order; the endianness tag, 0x12345678, lets a reader detect a byte order different from its own.
+static const char gSLiM_HaplotypeMagic[8] = {'S', 'L', 'i', 'M', 'H', 'a', 'p', 's'};
+static const uint32_t gSLiM_HaplotypeVersion = 1;
+static const uint32_t gSLiM_HaplotypeEndianTag = 0x12345678;
+
+template <typename T>
+static inline void _HAP_AppendBinary(std::string &p_buffer, T p_value)
+{
+	p_buffer.append((const char *)&p_value, sizeof(T));
+}
+
+void Genome::WriteGenomes_Haplotypes(std::ostream &p_out, std::vector<Genome *> &p_genomes, const Chromosome &p_chromosome, bool p_filter_monomorphic)
+{
+	slim_popsize_t sample_size = (slim_popsize_t)p_genomes.size();
 	
-	// make a hash table that looks up the genotype string position from a mutation pointer
-#if EIDOS_ROBIN_HOOD_HASHING
-	robin_hood::unordered_flat_map<const Mutation*, int> genotype_string_positions;
-	//typedef robin_hood::pair<const Mutation*, int> MAP_PAIR;
-#elif STD_UNORDERED_MAP_HASHING
-	std::unordered_map<const Mutation*, int> genotype_string_positions;
-	//typedef std::pair<const Mutation*, int> MAP_PAIR;
-#endif
-	int genotype_string_position = 0;
+	for (slim_popsize_t s = 0; s < sample_size; s++)
+		if (p_genomes[s]->IsNull())
+			EIDOS_TERMINATION << "ERROR (Genome::WriteGenomes_Haplotypes): cannot output null genomes." << EidosTerminate();
+	
+	GenomeHaplotypeMatrix matrix(p_genomes, p_filter_monomorphic);
+	size_t site_count = matrix.sites_.size();
+	std::string header;
+	
+	matrix.FillBits(p_genomes);
+	
+	header.reserve(40 + site_count * 2 * sizeof(int64_t));
+	header.append(gSLiM_HaplotypeMagic, sizeof(gSLiM_HaplotypeMagic));
+	_HAP_AppendBinary(header, gSLiM_HaplotypeVersion);
+	_HAP_AppendBinary(header, gSLiM_HaplotypeEndianTag);
+	_HAP_AppendBinary(header, (uint64_t)matrix.genome_count_);
+	_HAP_AppendBinary(header, (uint64_t)site_count);
+	_HAP_AppendBinary(header, (int64_t)p_chromosome.last_position_);
+	
+	for (const Mutation *mutation : matrix.sites_)
+		_HAP_AppendBinary(header, (int64_t)mutation->position_);
+	for (const Mutation *mutation : matrix.sites_)
+		_HAP_AppendBinary(header, (int64_t)mutation->mutation_id_);
+	
+	p_out.write(header.data(), (std::streamsize)header.size());
+	p_out.write((const char *)matrix.bits_.data(), (std::streamsize)(matrix.bits_.size() * sizeof(uint64_t)));
+}
+
+// Helpers for Genome::PrintGenomes_VCF(), which formats call lines into text buffers by hand rather than with operator<<
+static inline void _VCF_AppendInt(std::string &p_buffer, int64_t p_value)
+{
+	char digits[24];
+	char *end = digits + sizeof(digits);
+	char *ptr = end;
+	uint64_t magnitude = (p_value < 0) ? (0 - (uint64_t)p_value) : (uint64_t)p_value;
 	
-	try {
-		for (const Polymorphism &polymorphism : sorted_polymorphisms) 
-			genotype_string_positions.emplace(polymorphism.mutation_ptr_, genotype_string_position++);
-	} catch (...) {
-		EIDOS_TERMINATION << "ERROR (Genome::PrintGenomes_MS): (internal error) SLiM encountered a raise from an internal hash table; please report this." << EidosTerminate(nullptr);
+	do
+	{
+		*--ptr = (char)('0' + (magnitude % 10));
+		magnitude /= 10;
 	}
+	while (magnitude);
 	
-	// print header
-	p_out << "//" << std::endl << "segsites: " << sorted_polymorphisms.size() << std::endl;
+	if (p_value < 0)
+		*--ptr = '-';
 	
-	// print the sample's positions
-	if (sorted_polymorphisms.size() > 0)
-	{
-		// Save flags/precision
-		std::ios_base::fmtflags oldflags = p_out.flags();
-		std::streamsize oldprecision = p_out.precision();
-		
-		p_out << std::fixed << std::setprecision(15);	// BCH 26 Jan. 2020: increasing this from 7 to 10, so longer chromosomes work; maybe this should be a parameter?
-														// BCH 23 July 2020: increasing from 10 to 15, which is the limit of double-precision floats anyway
-		
-		// Output positions
-		p_out << "positions:";
-		
-		for (const Polymorphism &polymorphism : sorted_polymorphisms) 
-			p_out << " " << static_cast<double>(polymorphism.mutation_ptr_->position_) / p_chromosome.last_position_;	// this prints positions as being in the interval [0,1], which Philipp decided was the best policy
-		
-		p_out << std::endl;
-		
-		// Restore flags/precision
-		p_out.flags(oldflags);
-		p_out.precision(oldprecision);
-	}
+	p_buffer.append(ptr, (size_t)(end - ptr));
+}
+
+static inline void _VCF_AppendFloat(std::string &p_buffer, double p_value, int p_precision)
+{
+	// this matches operator<< for a stream in its default floating-point format, with the given precision
+	char formatted[64];
+	int length = snprintf(formatted, sizeof(formatted), "%.*g", p_precision, p_value);
 	
-	// print the sample's genotypes
-	for (slim_popsize_t j = 0; j < sample_size; j++)														// go through all individuals
-	{
-		Genome &genome = *p_genomes[j];
-		std::string genotype(sorted_polymorphisms.size(), '0'); // fill with 0s
-		
-		for (int run_index = 0; run_index < genome.mutrun_count_; ++run_index)
-		{
-			const MutationRun *mutrun = genome.mutruns_[run_index];
-			int mut_count = mutrun->size();
-			const MutationIndex *mut_ptr = mutrun->begin_pointer_const();
-			
-			for (int mut_index = 0; mut_index < mut_count; ++mut_index)
-			{
-				const Mutation *mutation = mut_block_ptr + mut_ptr[mut_index];
-				auto found_position = genotype_string_positions.find(mutation);
-				
-				// BCH 4/24/2019: when p_filter_monomorphic is true, mutations in a given genome may not exist in the position map
-				if (found_position != genotype_string_positions.end())
-					genotype.replace(found_position->second, 1, "1");
-			}
-		}
-		
-		p_out << genotype << std::endl;
-	}
+	p_buffer.append(formatted, (size_t)std::min(std::max(length, 0), (int)sizeof(formatted) - 1));
 }
 
 // print the sample represented by genomes, using "vcf" format
 void Genome::PrintGenomes_VCF(std::ostream &p_out, std::vector<Genome *> &p_genomes, bool p_output_multiallelics, bool p_simplify_nucs, bool p_output_nonnucs, bool p_nucleotide_based, NucleotideArray *p_ancestral_seq)
 {
-	Mutation *mut_block_ptr = gSLiM_Mutation_Block;
 	slim_popsize_t sample_size = (slim_popsize_t)p_genomes.size();
 	
 	if (sample_size % 2 == 1)
@@ -1498,40 +1724,11 @@ void Genome::PrintGenomes_VCF(std::ostream &p_out, std::vector<Genome *> &p_geno
 	
 	sample_size /= 2;
 	
-	// get the polymorphisms within the sample
-	PolymorphismMap polymorphisms;
-	
-	for (slim_popsize_t s = 0; s < sample_size; s++)
-	{
-		Genome &genome1 = *p_genomes[(size_t)s * 2];
-		Genome &genome2 = *p_genomes[(size_t)s * 2 + 1];
-		
-		if (!genome1.IsNull())
-		{
-			for (int run_index = 0; run_index < genome1.mutrun_count_; ++run_index)
-			{
-				const MutationRun *mutrun = genome1.mutruns_[run_index];
-				int mut_count = mutrun->size();
-				const MutationIndex *mut_ptr = mutrun->begin_pointer_const();
-				
-				for (int mut_index = 0; mut_index < mut_count; ++mut_index)
-					AddMutationToPolymorphismMap(&polymorphisms, mut_block_ptr + mut_ptr[mut_index]);
-			}
-		}
-		
-		if (!genome2.IsNull())
-		{
-			for (int run_index = 0; run_index < genome2.mutrun_count_; ++run_index)
-			{
-				const MutationRun *mutrun = genome2.mutruns_[run_index];
-				int mut_count = mutrun->size();
-				const MutationIndex *mut_ptr = mutrun->begin_pointer_const();
-				
-				for (int mut_index = 0; mut_index < mut_count; ++mut_index)
-					AddMutationToPolymorphismMap(&polymorphisms, mut_block_ptr + mut_ptr[mut_index]);
-			}
-		}
-	}
+	// Get the polymorphisms within the sample; the tally's scratch array is reused below to map mutations to call line rows
+	size_t genome_count = p_genomes.size();
+	GenomeSampleTally tally(p_genomes);
+	std::vector<const Mutation *> &sample_mutations = tally.mutations_;
+	int32_t *mutation_scratch = tally.scratch_;
 	
 	// print the VCF header
 	p_out << "##fileformat=VCFv4.2" << std::endl;
@@ -1597,77 +1794,97 @@ void Genome::PrintGenomes_VCF(std::ostream &p_out, std::vector<Genome *> &p_geno
 	p_out << std::endl;
 	
 	// We want to output polymorphisms sorted by position (starting in SLiM 3.3), to facilitate
-	// calling all of the nucleotide mutations at a given position with a single call line.
+	// calling all of the nucleotide mutations at a given position with a single call line.  We
+	// sort starting from mutation id order, as a PolymorphismMap would give, to keep the same
+	// order of mutations at a given position as in previous versions.
+	std::sort(sample_mutations.begin(), sample_mutations.end(), [](const Mutation *p_l, const Mutation *p_r) { return p_l->mutation_id_ < p_r->mutation_id_; });
+	
 	std::vector<Polymorphism> sorted_polymorphisms;
 	
-	for (const PolymorphismPair &polymorphism_pair : polymorphisms)
-		sorted_polymorphisms.emplace_back(polymorphism_pair.second);
+	sorted_polymorphisms.reserve(sample_mutations.size());
+	
+	for (const Mutation *mutation : sample_mutations)
+		sorted_polymorphisms.emplace_back((slim_polymorphismid_t)sorted_polymorphisms.size(), mutation, mutation_scratch[mutation->BlockIndex()]);
 	
 	std::sort(sorted_polymorphisms.begin(), sorted_polymorphisms.end());
 	
-	// Print a line for each mutation.  Note that we do NOT treat multiple mutations at the same position at being different alleles,
-	// output on the same line.  This is because a single individual can carry more than one mutation at the same position, so it is
-	// not really a question of different alleles; if there are N mutations at a given position, there are 2^N possible "alleles",
-	// which is just silly to try to wedge into VCF format.  So instead, we output each mutation as a separate line, and we tag lines
-	// for positions that carry more than one mutation with the MULTIALLELIC flag so they can be filtered out if they bother the user.
+	// Each polymorphism is now a row in the sorted order; record those rows in the scratch array, and find the positions
+	size_t row_count = sorted_polymorphisms.size();
+	std::vector<size_t> position_starts;	// the first row at each distinct position, plus a final entry of row_count
+	
+	for (size_t row = 0; row < row_count; ++row)
+	{
+		const Mutation *mutation = sorted_polymorphisms[row].mutation_ptr_;
+		
+		mutation_scratch[mutation->BlockIndex()] = (int32_t)row;
+		
+		if ((row == 0) || (mutation->position_ != sorted_polymorphisms[row - 1].mutation_ptr_->position_))
+			position_starts.emplace_back(row);
+	}
+	
+	size_t position_count = position_starts.size();
+	
+	position_starts.emplace_back(row_count);
+	
+	// Individuals with two null genomes can't be called; this is an error if any call line is emitted
+	std::vector<uint8_t> genome_is_null(genome_count);
+	bool individual_both_null = false;
+	
+	for (size_t genome_index = 0; genome_index < genome_count; ++genome_index)
+		genome_is_null[genome_index] = p_genomes[genome_index]->IsNull();
+	
+	for (slim_popsize_t s = 0; s < sample_size; s++)
+		if (genome_is_null[(size_t)s * 2] && genome_is_null[(size_t)s * 2 + 1])
+			individual_both_null = true;
+	
+	// Print the call lines for one position, given the genotypes for its rows, into p_buffer.  Note that we do NOT treat multiple
+	// mutations at the same position at being different alleles, output on the same line.  This is because a single individual can
+	// carry more than one mutation at the same position, so it is not really a question of different alleles; if there are N mutations
+	// at a given position, there are 2^N possible "alleles", which is just silly to try to wedge into VCF format.  So instead, we output
+	// each mutation as a separate line, and we tag lines for positions that carry more than one mutation with the MULTIALLELIC flag so
+	// they can be filtered out if they bother the user.
 	// BCH 6 March 2019: The above comment remains true in non-nucleotide-based models.  In nucleotide-based models, the nucleotide-
 	// based mutations at a given position are all output as a single call line, and then any non-nucleotide-based mutations are
 	// emitted as separated call lines after that that are marked NONNUC (unless p_output_nonnucs is false, in which case they are
 	// simply suppressed).
-	for (auto polyiter = sorted_polymorphisms.begin(); polyiter != sorted_polymorphisms.end(); )
+	// Returns 0 for success, 1 if an individual has two null genomes, or 2 if a genome has more than one nucleotide-based mutation
+	// at the position; errors are raised by the caller, since this may run on a worker thread.
+	int float_precision = (int)p_out.precision();
+	
+	auto print_position = [&](std::string &p_buffer, size_t p_first_row, size_t p_end_row, const uint8_t *p_genotypes) -> int
 	{
-		// Assemble vectors of all the nuc-based and non-nuc-based mutations at this position; we will emit them all at once
-		std::vector<Polymorphism *> nuc_based, nonnuc_based;
-		slim_position_t mut_position = polyiter->mutation_ptr_->position_;
+		// Assemble vectors of all the nuc-based and non-nuc-based rows at this position; we will emit them all at once
+		std::vector<size_t> nuc_based, nonnuc_based;
+		slim_position_t mut_position = sorted_polymorphisms[p_first_row].mutation_ptr_->position_;
 		
-		while (true)
+		for (size_t row = p_first_row; row < p_end_row; ++row)
 		{
-			// Eat polymorphism entries in sorted_polymorphisms as long as they're at the same position, until the end
-			Polymorphism &polymorphism = *polyiter;
-			const Mutation *mutation = polyiter->mutation_ptr_;
-			
-			if (mutation->position_ == mut_position)
-			{
-				if (mutation->mutation_type_ptr_->nucleotide_based_)
-					nuc_based.emplace_back(&polymorphism);
-				else
-					nonnuc_based.emplace_back(&polymorphism);
-			}
+			if (sorted_polymorphisms[row].mutation_ptr_->mutation_type_ptr_->nucleotide_based_)
+				nuc_based.emplace_back(row);
 			else
-			{
-				break;
-			}
-			
-			// Next polymorphism
-			polyiter++;
-			if (polyiter == sorted_polymorphisms.end())
-				break;
+				nonnuc_based.emplace_back(row);
 		}
 		
 		// Emit the nucleotide-based mutations at this position as a single call line
 		if (p_nucleotide_based && (nuc_based.size() > 0))
 		{
-			// Get the ancestral nucleotide at this position; this will be index 0
-			// Indices 1..n will be used for the corresponding mutations in nonnuc_based
-			// Note that this means it is 
+			// Get the ancestral nucleotide at this position; this will be allele index 0
 			int ancestral_nuc_index = p_ancestral_seq->NucleotideAtIndex(mut_position);		// 0..3 for ACGT
-			
-			// Emit a single call line for all of the nucleotide-based mutations
+			int allele_index_for_nuc[4] = {-1, -1, -1, -1};
+			slim_refcount_t total_prevalence[4] = {0, 0, 0, 0};
 			
 			if (p_simplify_nucs)
 			{
 				// We are requested to simplify the nucleotide state; any mutations with the ancestral nucleotide will be considered part of the
 				// ancestral state, and any mutations with matching nucleotide will be lumped together; SLiM state will not be emitted
 				// We tally up the total prevalence of each nucleotide, ignoring the ancestral nucleotide.
-				slim_refcount_t total_prevalence[4] = {0, 0, 0, 0};
-				int allele_index_for_nuc[4] = {-1, -1 -1, -1};
-				
-				for (Polymorphism *polymorphism : nuc_based)
+				for (size_t row : nuc_based)
 				{
-					int derived_nuc_index = (unsigned char)polymorphism->mutation_ptr_->nucleotide_;
+					const Polymorphism &polymorphism = sorted_polymorphisms[row];
+					int derived_nuc_index = (unsigned char)polymorphism.mutation_ptr_->nucleotide_;
 					
 					if (derived_nuc_index != ancestral_nuc_index)
-						total_prevalence[derived_nuc_index] += polymorphism->prevalence_;
+						total_prevalence[derived_nuc_index] += polymorphism.prevalence_;
 				}
 				
 				// Assign genotype call indexes for the four nucleotides, based upon which ones have prevalence > 0
@@ -1679,245 +1896,162 @@ void Genome::PrintGenomes_VCF(std::ostream &p_out, std::vector<Genome *> &p_geno
 					if (total_prevalence[nuc_index] > 0)
 						allele_index_for_nuc[nuc_index] = next_allele_index++;
 				}
+			}
+			
+			// If simplifying and the only segregating alleles are back-mutations, we don't need to emit this call line at all
+			if (!p_simplify_nucs || (total_prevalence[0] + total_prevalence[1] + total_prevalence[2] + total_prevalence[3] != 0))
+			{
+				if (individual_both_null)
+					return 1;
+				
+				// emit CHROM ("1"), POS, ID (".")
+				p_buffer.append("1\t");
+				_VCF_AppendInt(p_buffer, mut_position + 1);			// +1 because VCF uses 1-based positions
+				p_buffer.append("\t.\t");
+				
+				// emit REF ("A" etc.)
+				p_buffer.push_back(gSLiM_Nucleotides[ancestral_nuc_index]);
+				p_buffer.push_back('\t');
 				
-				// If the only segregating alleles are back-mutations, we don't need to emit this call line at all
-				if (total_prevalence[0] + total_prevalence[1] + total_prevalence[2] + total_prevalence[3] != 0)
+				if (p_simplify_nucs)
 				{
-					// emit CHROM ("1"), POS, ID (".")
-					p_out << "1\t" << (mut_position + 1) << "\t.\t";			// +1 because VCF uses 1-based positions
-					
-					// emit REF ("A" etc.)
-					p_out << gSLiM_Nucleotides[ancestral_nuc_index];
-					p_out << "\t";
-					
 					// emit ALT ("T" etc.)
 					bool firstEmitted = true;
-					for (int nuc_index=0; nuc_index < 4; ++nuc_index)
+					for (int nuc_index = 0; nuc_index < 4; ++nuc_index)
 					{
 						if (total_prevalence[nuc_index] > 0)
 						{
 							if (!firstEmitted)
-								p_out << ',';
+								p_buffer.push_back(',');
 							firstEmitted = false;
 							
-							p_out << gSLiM_Nucleotides[nuc_index];
+							p_buffer.push_back(gSLiM_Nucleotides[nuc_index]);
 						}
 					}
 					
 					// emit QUAL (1000), FILTER (PASS)
-					p_out << "\t1000\tPASS\t";
+					p_buffer.append("\t1000\tPASS\t");
 					
-					// emit the INFO fields and the Genotype marker; note mutation-specific fields are omitted since we are aggregating
-					p_out << "AC=";
+					// emit the INFO fields; note mutation-specific fields are omitted since we are aggregating
+					p_buffer.append("AC=");
 					firstEmitted = true;
 					for (int nuc_prevalence : total_prevalence)
 					{
 						if (nuc_prevalence > 0)
 						{
 							if (!firstEmitted)
-								p_out << ',';
+								p_buffer.push_back(',');
 							firstEmitted = false;
 							
-							p_out << nuc_prevalence;
+							_VCF_AppendInt(p_buffer, nuc_prevalence);
 						}
 					}
-					p_out << ";DP=1000;";
-					p_out << "AA=" << gSLiM_Nucleotides[ancestral_nuc_index];
+					p_buffer.append(";DP=1000;");
+				}
+				else
+				{
+					// emit ALT ("T" etc.)
+					for (size_t row : nuc_based)
+					{
+						if (row != nuc_based.front())
+							p_buffer.push_back(',');
+						p_buffer.push_back(gSLiM_Nucleotides[sorted_polymorphisms[row].mutation_ptr_->nucleotide_]);
+					}
 					
-					p_out << "\tGT";
+					// emit QUAL (1000), FILTER (PASS)
+					p_buffer.append("\t1000\tPASS\t");
 					
-					// emit the individual calls
-					for (slim_popsize_t s = 0; s < sample_size; s++)
+					// emit the INFO fields
+					p_buffer.append("MID=");
+					for (size_t row : nuc_based)
 					{
-						Genome &g1 = *p_genomes[(size_t)s * 2];
-						Genome &g2 = *p_genomes[(size_t)s * 2 + 1];
-						bool g1_null = g1.IsNull(), g2_null = g2.IsNull();
-						
-						if (g1_null && g2_null)
-						{
-							// Both genomes are null; we should have eliminated the possibility of this with the check above
-							EIDOS_TERMINATION << "ERROR (Population::PrintGenomes_VCF): (internal error) no non-null genome to output for individual." << EidosTerminate();
-						}
-						
-						p_out << '\t';
-						
-						for (int genome_index = 0; genome_index <= 1; ++genome_index)
-						{
-							Genome &genome = (genome_index == 0) ? g1 : g2;
-							
-							if (!genome.IsNull())
-							{
-								// Find and emit the nuc-based mut contained by this genome, if any.  If more than one nuc-based mut is contained, it is an error.
-								int contained_mut_index = -1;
-								
-								for (int muts_index = 0; muts_index < (int)nuc_based.size(); ++muts_index)
-								{
-									const Mutation *mutation = nuc_based[muts_index]->mutation_ptr_;
-									
-									if (genome.contains_mutation(mutation->BlockIndex()))
-									{
-										if (contained_mut_index == -1)
-											contained_mut_index = muts_index;
-										else
-											EIDOS_TERMINATION << "ERROR (Population::PrintGenomes_VCF): more than one nucleotide-based mutation encountered at the same position (" << mut_position << ") in the same genome; the nucleotide cannot be called." << EidosTerminate();
-									}
-								}
-								
-								if (contained_mut_index == -1)
-									p_out << '0';
-								else
-									p_out << allele_index_for_nuc[nuc_based[contained_mut_index]->mutation_ptr_->nucleotide_];
-							}
-							
-							// If both genomes are non-null, emit a separator
-							if ((genome_index == 0) && !g1_null && !g2_null)
-								p_out << '|';
-						}
+						if (row != nuc_based.front())
+							p_buffer.push_back(',');
+						_VCF_AppendInt(p_buffer, sorted_polymorphisms[row].mutation_ptr_->mutation_id_);
 					}
-					
-					p_out << std::endl;
-				}
-			}
-			else
-			{
-				// emit CHROM ("1"), POS, ID (".")
-				p_out << "1\t" << (mut_position + 1) << "\t.\t";			// +1 because VCF uses 1-based positions
-				
-				// emit REF ("A" etc.)
-				p_out << gSLiM_Nucleotides[ancestral_nuc_index];
-				p_out << "\t";
-				
-				// emit ALT ("T" etc.)
-				for (Polymorphism *polymorphism : nuc_based)
-				{
-					if (polymorphism != nuc_based.front())
-						p_out << ',';
-					p_out << gSLiM_Nucleotides[polymorphism->mutation_ptr_->nucleotide_];
-				}
-				
-				// emit QUAL (1000), FILTER (PASS)
-				p_out << "\t1000\tPASS\t";
-				
-				// emit the INFO fields and the Genotype marker
-				p_out << "MID=";
-				for (Polymorphism *polymorphism : nuc_based)
-				{
-					if (polymorphism != nuc_based.front())
-						p_out << ',';
-					p_out << polymorphism->mutation_ptr_->mutation_id_;
-				}
-				p_out << ";";
-				
-				p_out << "S=";
-				for (Polymorphism *polymorphism : nuc_based)
-				{
-					if (polymorphism != nuc_based.front())
-						p_out << ',';
-					p_out << polymorphism->mutation_ptr_->selection_coeff_;
-				}
-				p_out << ";";
-				
-				p_out << "DOM=";
-				for (Polymorphism *polymorphism : nuc_based)
-				{
-					if (polymorphism != nuc_based.front())
-						p_out << ',';
-					p_out << polymorphism->mutation_ptr_->mutation_type_ptr_->dominance_coeff_;
-				}
-				p_out << ";";
-				
-				p_out << "PO=";
-				for (Polymorphism *polymorphism : nuc_based)
-				{
-					if (polymorphism != nuc_based.front())
-						p_out << ',';
-					p_out << polymorphism->mutation_ptr_->subpop_index_;
-				}
-				p_out << ";";
-				
-				p_out << "TO=";
-				for (Polymorphism *polymorphism : nuc_based)
-				{
-					if (polymorphism != nuc_based.front())
-						p_out << ',';
-					p_out << polymorphism->mutation_ptr_->origin_tick_;
-				}
-				p_out << ";";
-				
-				p_out << "MT=";
-				for (Polymorphism *polymorphism : nuc_based)
-				{
-					if (polymorphism != nuc_based.front())
-						p_out << ',';
-					p_out << polymorphism->mutation_ptr_->mutation_type_ptr_->mutation_type_id_;
-				}
-				p_out << ";";
-				
-				p_out << "AC=";
-				for (Polymorphism *polymorphism : nuc_based)
-				{
-					if (polymorphism != nuc_based.front())
-						p_out << ',';
-					p_out << polymorphism->prevalence_;
+					p_buffer.append(";S=");
+					for (size_t row : nuc_based)
+					{
+						if (row != nuc_based.front())
+							p_buffer.push_back(',');
+						_VCF_AppendFloat(p_buffer, sorted_polymorphisms[row].mutation_ptr_->selection_coeff_, float_precision);
+					}
+					p_buffer.append(";DOM=");
+					for (size_t row : nuc_based)
+					{
+						if (row != nuc_based.front())
+							p_buffer.push_back(',');
+						_VCF_AppendFloat(p_buffer, sorted_polymorphisms[row].mutation_ptr_->mutation_type_ptr_->dominance_coeff_, float_precision);
+					}
+					p_buffer.append(";PO=");
+					for (size_t row : nuc_based)
+					{
+						if (row != nuc_based.front())
+							p_buffer.push_back(',');
+						_VCF_AppendInt(p_buffer, sorted_polymorphisms[row].mutation_ptr_->subpop_index_);
+					}
+					p_buffer.append(";TO=");
+					for (size_t row : nuc_based)
+					{
+						if (row != nuc_based.front())
+							p_buffer.push_back(',');
+						_VCF_AppendInt(p_buffer, sorted_polymorphisms[row].mutation_ptr_->origin_tick_);
+					}
+					p_buffer.append(";MT=");
+					for (size_t row : nuc_based)
+					{
+						if (row != nuc_based.front())
+							p_buffer.push_back(',');
+						_VCF_AppendInt(p_buffer, sorted_polymorphisms[row].mutation_ptr_->mutation_type_ptr_->mutation_type_id_);
+					}
+					p_buffer.append(";AC=");
+					for (size_t row : nuc_based)
+					{
+						if (row != nuc_based.front())
+							p_buffer.push_back(',');
+						_VCF_AppendInt(p_buffer, sorted_polymorphisms[row].prevalence_);
+					}
+					p_buffer.append(";DP=1000;");
 				}
-				p_out << ";";
-				
-				p_out << "DP=1000;";
-				
-				p_out << "AA=" << gSLiM_Nucleotides[ancestral_nuc_index];
 				
-				p_out << "\tGT";
+				p_buffer.append("AA=");
+				p_buffer.push_back(gSLiM_Nucleotides[ancestral_nuc_index]);
+				p_buffer.append("\tGT");
 				
 				// emit the individual calls
-				for (slim_popsize_t s = 0; s < sample_size; s++)
+				for (size_t genome_index = 0; genome_index < genome_count; ++genome_index)
 				{
-					Genome &g1 = *p_genomes[(size_t)s * 2];
-					Genome &g2 = *p_genomes[(size_t)s * 2 + 1];
-					bool g1_null = g1.IsNull(), g2_null = g2.IsNull();
+					if (genome_index % 2 == 0)
+						p_buffer.push_back('\t');
+					else if (!genome_is_null[genome_index - 1] && !genome_is_null[genome_index])
+						p_buffer.push_back('|');		// if both genomes are non-null, emit a separator
 					
-					if (g1_null && g2_null)
-					{
-						// Both genomes are null; we should have eliminated the possibility of this with the check above
-						EIDOS_TERMINATION << "ERROR (Population::PrintGenomes_VCF): (internal error) no non-null genome to output for individual." << EidosTerminate();
-					}
+					if (genome_is_null[genome_index])
+						continue;
 					
-					p_out << '\t';
+					// Find and emit the nuc-based mut contained by this genome, if any.  If more than one nuc-based mut is contained, it is an error.
+					int contained_mut_index = -1;
 					
-					for (int genome_index = 0; genome_index <= 1; ++genome_index)
+					for (int muts_index = 0; muts_index < (int)nuc_based.size(); ++muts_index)
 					{
-						Genome &genome = (genome_index == 0) ? g1 : g2;
-						
-						if (!genome.IsNull())
+						if (p_genotypes[(nuc_based[muts_index] - p_first_row) * genome_count + genome_index])
 						{
-							// Find and emit the nuc-based mut contained by this genome, if any.  If more than one nuc-based mut is contained, it is an error.
-							int contained_mut_index = -1;
-							
-							for (int muts_index = 0; muts_index < (int)nuc_based.size(); ++muts_index)
-							{
-								const Mutation *mutation = nuc_based[muts_index]->mutation_ptr_;
-								
-								if (genome.contains_mutation(mutation->BlockIndex()))
-								{
-									if (contained_mut_index == -1)
-										contained_mut_index = muts_index;
-									else
-										EIDOS_TERMINATION << "ERROR (Population::PrintGenomes_VCF): more than one nucleotide-based mutation encountered at the same position (" << mut_position << ") in the same genome; the nucleotide cannot be called." << EidosTerminate();
-								}
-							}
-							
 							if (contained_mut_index == -1)
-								p_out << '0';
+								contained_mut_index = muts_index;
 							else
-								p_out << (contained_mut_index + 1);
+								return 2;
 						}
-						
-						// If both genomes are non-null, emit a separator
-						if ((genome_index == 0) && !g1_null && !g2_null)
-							p_out << '|';
 					}
+					
+					if (contained_mut_index == -1)
+						p_buffer.push_back('0');
+					else if (p_simplify_nucs)
+						_VCF_AppendInt(p_buffer, allele_index_for_nuc[(int)sorted_polymorphisms[nuc_based[contained_mut_index]].mutation_ptr_->nucleotide_]);
+					else
+						_VCF_AppendInt(p_buffer, contained_mut_index + 1);
 				}
 				
-				p_out << std::endl;
+				p_buffer.push_back('\n');
 			}
 		}
 		
@@ -1925,81 +2059,192 @@ void Genome::PrintGenomes_VCF(std::ostream &p_out, std::vector<Genome *> &p_geno
 		// We do this if outputNonnucleotides==T, or if we are non-nucleotide-based (in which case outputNonnucleotides is ignored)
 		if (p_output_nonnucs || !p_nucleotide_based)
 		{
-			for (Polymorphism *polymorphism : nonnuc_based)
+			// Count the mutations at the given position to determine if we are multiallelic
+			int allele_count = (int)nonnuc_based.size();
+			
+			// Output this mutation if (1) we are outputting multiallelics in a non-nuc-based model, or (2) we are a nuc-based model (regardless of allele count), or (3) it is not multiallelic
+			if (p_output_multiallelics || p_nucleotide_based || (allele_count == 1))
 			{
-				const Mutation *mutation = polymorphism->mutation_ptr_;
-				
-				// Count the mutations at the given position to determine if we are multiallelic
-				int allele_count = (int)nonnuc_based.size();
-				
-				// Output this mutation if (1) we are outputting multiallelics in a non-nuc-based model, or (2) we are a nuc-based model (regardless of allele count), or (3) it is not multiallelic
-				if (p_output_multiallelics || p_nucleotide_based || (allele_count == 1))
+				for (size_t row : nonnuc_based)
 				{
+					const Polymorphism &polymorphism = sorted_polymorphisms[row];
+					const Mutation *mutation = polymorphism.mutation_ptr_;
+					const uint8_t *row_genotypes = p_genotypes + (row - p_first_row) * genome_count;
+					
+					if (individual_both_null)
+						return 1;
+					
 					// emit CHROM ("1"), POS, ID ("."), REF ("A"), and ALT ("T")
-					p_out << "1\t" << (mut_position + 1) << "\t.\tA\tT";			// +1 because VCF uses 1-based positions
+					p_buffer.append("1\t");
+					_VCF_AppendInt(p_buffer, mut_position + 1);			// +1 because VCF uses 1-based positions
+					p_buffer.append("\t.\tA\tT");
 					
 					// emit QUAL (1000), FILTER (PASS)
-					p_out << "\t1000\tPASS\t";
+					p_buffer.append("\t1000\tPASS\t");
 					
 					// emit the INFO fields and the Genotype marker
-					p_out << "MID=" << mutation->mutation_id_ << ";";
-					p_out << "S=" << mutation->selection_coeff_ << ";";
-					p_out << "DOM=" << mutation->mutation_type_ptr_->dominance_coeff_ << ";";
-					p_out << "PO=" << mutation->subpop_index_ << ";";
-					p_out << "TO=" << mutation->origin_tick_ << ";";
-					p_out << "MT=" << mutation->mutation_type_ptr_->mutation_type_id_ << ";";
-					p_out << "AC=" << polymorphism->prevalence_ << ";";
-					p_out << "DP=1000";
+					p_buffer.append("MID=");
+					_VCF_AppendInt(p_buffer, mutation->mutation_id_);
+					p_buffer.append(";S=");
+					_VCF_AppendFloat(p_buffer, mutation->selection_coeff_, float_precision);
+					p_buffer.append(";DOM=");
+					_VCF_AppendFloat(p_buffer, mutation->mutation_type_ptr_->dominance_coeff_, float_precision);
+					p_buffer.append(";PO=");
+					_VCF_AppendInt(p_buffer, mutation->subpop_index_);
+					p_buffer.append(";TO=");
+					_VCF_AppendInt(p_buffer, mutation->origin_tick_);
+					p_buffer.append(";MT=");
+					_VCF_AppendInt(p_buffer, mutation->mutation_type_ptr_->mutation_type_id_);
+					p_buffer.append(";AC=");
+					_VCF_AppendInt(p_buffer, polymorphism.prevalence_);
+					p_buffer.append(";DP=1000");
 					
 					if (!p_nucleotide_based && (allele_count > 1))	// output MULTIALLELIC flags only in non-nuc-based models
-						p_out << ";MULTIALLELIC";
+						p_buffer.append(";MULTIALLELIC");
 					if (p_nucleotide_based && p_output_nonnucs)
-						p_out << ";NONNUC";
+						p_buffer.append(";NONNUC");
 					
-					p_out << "\tGT";
+					p_buffer.append("\tGT");
 					
-					// emit the individual calls
-					for (slim_popsize_t s = 0; s < sample_size; s++)
+					// emit the individual calls; an unpaired X or Y is emitted as haploid, and otherwise we emit an x|y pair that indicates the data is phased
+					for (size_t genome_index = 0; genome_index < genome_count; genome_index += 2)
 					{
-						Genome &g1 = *p_genomes[(size_t)s * 2];
-						Genome &g2 = *p_genomes[(size_t)s * 2 + 1];
-						bool g1_null = g1.IsNull(), g2_null = g2.IsNull();
+						bool g1_null = genome_is_null[genome_index], g2_null = genome_is_null[genome_index + 1];
 						
-						if (g1_null && g2_null)
-						{
-							// Both genomes are null; we should have eliminated the possibility of this with the check above
-							EIDOS_TERMINATION << "ERROR (Population::PrintGenomes_VCF): (internal error) no non-null genome to output for individual." << EidosTerminate();
-						}
-						else if (g1_null)
-						{
-							// An unpaired X or Y; we emit this as haploid, I think that is the right call...
-							p_out << (g2.contains_mutation(mutation->BlockIndex()) ? "\t1" : "\t0");
-						}
-						else if (g2_null)
-						{
-							// An unpaired X or Y; we emit this as haploid, I think that is the right call...
-							p_out << (g1.contains_mutation(mutation->BlockIndex()) ? "\t1" : "\t0");
-						}
-						else
-						{
-							// Both genomes are non-null; emit an x|y pair that indicates the data is phased
-							bool g1_has_mut = g1.contains_mutation(mutation->BlockIndex());
-							bool g2_has_mut = g2.contains_mutation(mutation->BlockIndex());
-							
-							if (g1_has_mut && g2_has_mut)	p_out << "\t1|1";
-							else if (g1_has_mut)			p_out << "\t1|0";
-							else if (g2_has_mut)			p_out << "\t0|1";
-							else							p_out << "\t0|0";
-						}
+						p_buffer.push_back('\t');
+						
+						if (!g1_null)
+							p_buffer.push_back(row_genotypes[genome_index] ? '1' : '0');
+						if (!g1_null && !g2_null)
+							p_buffer.push_back('|');
+						if (!g2_null)
+							p_buffer.push_back(row_genotypes[genome_index + 1] ? '1' : '0');
 					}
 					
-					p_out << std::endl;
+					p_buffer.push_back('\n');
 				}
 			}
 		}
 		
-		// polyiter already points to the mutation at the next position, or to end(), so we don't advance it here
+		return 0;
+	};
+	
+	// Print the call lines in chunks of whole positions.  For each chunk we fill in a matrix of genotypes, one byte per genome per row,
+	// by walking each genome's mutations forward from where the previous chunk left off; this replaces contains_mutation() lookups.
+	// The call lines are then formatted into per-thread buffers, each thread handling a contiguous range of positions, and written out.
+	const size_t max_chunk_bytes = 32 * 1024 * 1024;
+	size_t max_chunk_rows = std::max((size_t)1, max_chunk_bytes / std::max(genome_count, (size_t)1));
+	std::vector<uint8_t> genotypes;
+	std::vector<int> genome_run_cursors(genome_count, 0), genome_mut_cursors(genome_count, 0);
+	std::vector<std::string> thread_buffers(gEidosMaxThreads);
+	std::vector<int> thread_results(gEidosMaxThreads);
+	std::vector<size_t> thread_error_positions(gEidosMaxThreads);
+	
+	for (size_t chunk_first_position = 0; chunk_first_position < position_count; )
+	{
+		// Extend the chunk by whole positions up to the row limit; a single position may exceed the limit by itself
+		size_t chunk_end_position = chunk_first_position + 1;
+		
+		while ((chunk_end_position < position_count) && (position_starts[chunk_end_position + 1] - position_starts[chunk_first_position] <= max_chunk_rows))
+			chunk_end_position++;
+		
+		size_t chunk_first_row = position_starts[chunk_first_position];
+		size_t chunk_end_row = position_starts[chunk_end_position];
+		
+		genotypes.assign((chunk_end_row - chunk_first_row) * genome_count, 0);
+		
+		{
+			uint8_t *genotypes_data = genotypes.data();
+			const int32_t *mutation_rows = mutation_scratch;
+			int64_t genome_count_int = (int64_t)genome_count;
+			
+			EIDOS_THREAD_COUNT(gEidos_OMP_threads_VCF_OUTPUT);
+#pragma omp parallel for schedule(static) default(none) shared(p_genomes, genome_is_null, genome_run_cursors, genome_mut_cursors, genome_count, chunk_first_row, chunk_end_row, genome_count_int) firstprivate(genotypes_data, mutation_rows) if(genome_count_int * (int64_t)(chunk_end_row - chunk_first_row) >= EIDOS_OMPMIN_VCF_OUTPUT) num_threads(thread_count)
+			for (int64_t genome_index = 0; genome_index < genome_count_int; ++genome_index)
+			{
+				if (genome_is_null[genome_index])
+					continue;
+				
+				// Mutations within a genome are sorted by position, so those in this chunk come next, at rows below chunk_end_row
+				Genome *genome = p_genomes[genome_index];
+				int run_index = genome_run_cursors[genome_index];
+				int mut_index = genome_mut_cursors[genome_index];
+				
+				for ( ; run_index < genome->mutrun_count_; ++run_index, mut_index = 0)
+				{
+					const MutationRun *mutrun = genome->mutruns_[run_index];
+					int mut_count = mutrun->size();
+					const MutationIndex *mut_ptr = mutrun->begin_pointer_const();
+					
+					for ( ; mut_index < mut_count; ++mut_index)
+					{
+						size_t row = (size_t)mutation_rows[mut_ptr[mut_index]];
+						
+						if (row >= chunk_end_row)
+							break;
+						
+						genotypes_data[(row - chunk_first_row) * genome_count + (size_t)genome_index] = 1;
+					}
+					
+					if (mut_index < mut_count)
+						break;
+				}
+				
+				genome_run_cursors[genome_index] = run_index;
+				genome_mut_cursors[genome_index] = mut_index;
+			}
+		}
+		
+		{
+			const uint8_t *genotypes_data = genotypes.data();
+			size_t chunk_position_count = chunk_end_position - chunk_first_position;
+			
+			std::fill(thread_results.begin(), thread_results.end(), 0);
+			
+			EIDOS_THREAD_COUNT(gEidos_OMP_threads_VCF_OUTPUT);
+#pragma omp parallel default(none) shared(thread_buffers, thread_results, thread_error_positions, position_starts, print_position, chunk_first_position, chunk_position_count, chunk_first_row, genome_count) firstprivate(genotypes_data) if(chunk_position_count * genome_count >= EIDOS_OMPMIN_VCF_OUTPUT) num_threads(thread_count)
+			{
+				// Each thread formats a contiguous range of positions, so the buffers concatenate in order
+				int thread_num = omp_get_thread_num();
+				int num_threads = omp_get_num_threads();
+				size_t range_start = chunk_first_position + (chunk_position_count * thread_num) / num_threads;
+				size_t range_end = chunk_first_position + (chunk_position_count * (thread_num + 1)) / num_threads;
+				std::string &buffer = thread_buffers[thread_num];
+				
+				for (size_t position_index = range_start; position_index < range_end; ++position_index)
+				{
+					size_t first_row = position_starts[position_index];
+					int result = print_position(buffer, first_row, position_starts[position_index + 1], genotypes_data + (first_row - chunk_first_row) * genome_count);
+					
+					if (result)
+					{
+						thread_results[thread_num] = result;
+						thread_error_positions[thread_num] = first_row;
+						break;
+					}
+				}
+			}
+		}
+		
+		for (size_t thread_index = 0; thread_index < thread_buffers.size(); ++thread_index)
+		{
+			std::string &buffer = thread_buffers[thread_index];
+			int result = thread_results[thread_index];
+			
+			if (buffer.size())
+				p_out.write(buffer.data(), (std::streamsize)buffer.size());
+			buffer.clear();
+			
+			if (result == 1)
+				EIDOS_TERMINATION << "ERROR (Genome::PrintGenomes_VCF): (internal error) no non-null genome to output for individual." << EidosTerminate();
+			else if (result == 2)
+				EIDOS_TERMINATION << "ERROR (Genome::PrintGenomes_VCF): more than one nucleotide-based mutation encountered at the same position (" << sorted_polymorphisms[thread_error_positions[thread_index]].mutation_ptr_->position_ << ") in the same genome; the nucleotide cannot be called." << EidosTerminate();
+		}
+		
+		chunk_first_position = chunk_end_position;
 	}
+	
+	p_out.flush();
 }
 
 size_t Genome::MemoryUsageForMutrunBuffers(void)
@@ -2069,7 +2314,8 @@ const std::vector<EidosMethodSignature_CSP> *Genome_Class::Methods(void) const
 		methods->emplace_back((EidosClassMethodSignature *)(new EidosClassMethodSignature(gStr_readFromVCF, kEidosValueMaskObject, gSLiM_Mutation_Class))->AddString_S(gEidosStr_filePath)->AddIntObject_OSN("mutationType", gSLiM_MutationType_Class, gStaticEidosValueNULL));
 		methods->emplace_back((EidosClassMethodSignature *)(new EidosClassMethodSignature(gStr_removeMutations, kEidosValueMaskVOID))->AddObject_ON("mutations", gSLiM_Mutation_Class, gStaticEidosValueNULL)->AddLogical_OS("substitute", gStaticEidosValue_LogicalF));
 		methods->emplace_back((EidosClassMethodSignature *)(new EidosClassMethodSignature(gStr_outputMS, kEidosValueMaskVOID))->AddString_OSN(gEidosStr_filePath, gStaticEidosValueNULL)->AddLogical_OS("append", gStaticEidosValue_LogicalF)->AddLogical_OS("filterMonomorphic", gStaticEidosValue_LogicalF));
-		methods->emplace_back((EidosClassMethodSignature *)(new EidosClassMethodSignature(gStr_outputVCF, kEidosValueMaskVOID))->AddString_OSN(gEidosStr_filePath, gStaticEidosValueNULL)->AddLogical_OS("outputMultiallelics", gStaticEidosValue_LogicalT)->AddLogical_OS("append", gStaticEidosValue_LogicalF)->AddLogical_OS("simplifyNucleotides", gStaticEidosValue_LogicalF)->AddLogical_OS("outputNonnucleotides", gStaticEidosValue_LogicalT));
+		methods->emplace_back((EidosClassMethodSignature *)(new EidosClassMethodSignature(gStr_outputVCF, kEidosValueMaskVOID))->AddString_OSN(gEidosStr_filePath, gStaticEidosValueNULL)->AddLogical_OS("outputMultiallelics", gStaticEidosValue_LogicalT)->AddLogical_OS("append", gStaticEidosValue_LogicalF)->AddLogical_OS("simplifyNucleotides", gStaticEidosValue_LogicalF)->AddLogical_OS("outputNonnucleotides", gStaticEidosValue_LogicalT)->AddLogical_OS("compress", gStaticEidosValue_LogicalF));
+		methods->emplace_back((EidosClassMethodSignature *)(new EidosClassMethodSignature(gStr_outputHaplotypes, kEidosValueMaskVOID))->AddString_S(gEidosStr_filePath)->AddLogical_OS("append", gStaticEidosValue_LogicalF)->AddLogical_OS("filterMonomorphic", gStaticEidosValue_LogicalF));
 		methods->emplace_back((EidosClassMethodSignature *)(new EidosClassMethodSignature(gStr_output, kEidosValueMaskVOID))->AddString_OSN(gEidosStr_filePath, gStaticEidosValueNULL)->AddLogical_OS("append", gStaticEidosValue_LogicalF));
 		methods->emplace_back((EidosInstanceMethodSignature *)(new EidosInstanceMethodSignature(gStr_sumOfMutationsOfType, kEidosValueMaskFloat | kEidosValueMaskSingleton))->AddIntObject_S("mutType", gSLiM_MutationType_Class));
 		
@@ -2091,6 +2337,7 @@ EidosValue_SP Genome_Class::ExecuteClassMethod(EidosGlobalStringID p_method_id,
 		case gID_output:
 		case gID_outputMS:
 		case gID_outputVCF:						return ExecuteMethod_outputX(p_method_id, p_target, p_arguments, p_interpreter);
+		case gID_outputHaplotypes:				return ExecuteMethod_outputHaplotypes(p_method_id, p_target, p_arguments, p_interpreter);
 		case gID_readFromMS:					return ExecuteMethod_readFromMS(p_method_id, p_target, p_arguments, p_interpreter);
 		case gID_readFromVCF:					return ExecuteMethod_readFromVCF(p_method_id, p_target, p_arguments, p_interpreter);
 		case gID_removeMutations:				return ExecuteMethod_removeMutations(p_method_id, p_target, p_arguments, p_interpreter);
@@ -2860,7 +3107,7 @@ EidosValue_SP Genome_Class::ExecuteMethod_mutationFreqsCountsInGenomes(EidosGlob
 
 //	*********************	+ (void)output([Ns$ filePath = NULL], [logical$ append=F])
 //	*********************	+ (void)outputMS([Ns$ filePath = NULL], [logical$ append=F], [logical$ filterMonomorphic = F])
-//	*********************	+ (void)outputVCF([Ns$ filePath = NULL], [logical$ outputMultiallelics = T], [logical$ append=F], [logical$ simplifyNucleotides = F], [logical$ outputNonnucleotides = T])
+//	*********************	+ (void)outputVCF([Ns$ filePath = NULL], [logical$ outputMultiallelics = T], [logical$ append=F], [logical$ simplifyNucleotides = F], [logical$ outputNonnucleotides = T], [logical$ compress = F])
 //
 EidosValue_SP Genome_Class::ExecuteMethod_outputX(EidosGlobalStringID p_method_id, EidosValue_Object *p_target, const std::vector<EidosValue_SP> &p_arguments, EidosInterpreter &p_interpreter) const
 {
@@ -2871,6 +3118,7 @@ EidosValue_SP Genome_Class::ExecuteMethod_outputX(EidosGlobalStringID p_method_i
 	EidosValue *filterMonomorphic_value = ((p_method_id == gID_outputMS) ? p_arguments[2].get() : nullptr);
 	EidosValue *simplifyNucleotides_value = ((p_method_id == gID_outputVCF) ? p_arguments[3].get() : nullptr);
 	EidosValue *outputNonnucleotides_value = ((p_method_id == gID_outputVCF) ? p_arguments[4].get() : nullptr);
+	EidosValue *compress_value = ((p_method_id == gID_outputVCF) ? p_arguments[5].get() : nullptr);
 	
 	// default to outputting multiallelic positions (used by VCF output only)
 	bool output_multiallelics = true;
@@ -2888,6 +3136,12 @@ EidosValue_SP Genome_Class::ExecuteMethod_outputX(EidosGlobalStringID p_method_i
 	if (p_method_id == gID_outputVCF)
 		output_nonnucs = outputNonnucleotides_value->LogicalAtIndex_NOCAST(0, nullptr);
 	
+	// BGZF compression of the output file (VCF output only)
+	bool compress = false;
+	
+	if (p_method_id == gID_outputVCF)
+		compress = compress_value->LogicalAtIndex_NOCAST(0, nullptr);
+	
 	// figure out if we're filtering out mutations that are monomorphic within the sample (MS output only)
 	bool filter_monomorphic = false;
 	
@@ -2924,6 +3178,9 @@ EidosValue_SP Genome_Class::ExecuteMethod_outputX(EidosGlobalStringID p_method_i
 	// Now handle stream/file output and dispatch to the actual print method
 	if (filePath_value->Type() == EidosValueType::kValueNULL)
 	{
+		if (compress)
+			EIDOS_TERMINATION << "ERROR (Genome_Class::ExecuteMethod_outputX): compress=T requires a filePath for output." << EidosTerminate();
+		
 		// If filePath is NULL, output to our output stream
 		std::ostream &output_stream = p_interpreter.ExecutionOutputStream();
 		
@@ -2955,9 +3212,25 @@ EidosValue_SP Genome_Class::ExecuteMethod_outputX(EidosGlobalStringID p_method_i
 		bool append = append_value->LogicalAtIndex_NOCAST(0, nullptr);
 		std::ofstream outfile;
 		
-		outfile.open(outfile_path.c_str(), append ? (std::ios_base::app | std::ios_base::out) : std::ios_base::out);
+		if (compress && !Eidos_string_hasSuffix(outfile_path, ".gz"))
+			outfile_path.append(".gz");
 		
-		if (outfile.is_open())
+		outfile.open(outfile_path.c_str(), (append ? (std::ios_base::app | std::ios_base::out) : std::ios_base::out) | (compress ? std::ios_base::binary : std::ios_base::openmode()));
+		
+		if (outfile.is_open() && compress)
+		{
+			// BGZF-compressed VCF output; the output is a valid gzip file that can also be indexed by tabix
+			Eidos_BGZFStreambuf bgzf_buf(outfile);
+			std::ostream bgzf_stream(&bgzf_buf);
+			
+			Genome::PrintGenomes_VCF(bgzf_stream, genomes, output_multiallelics, simplify_nucs, output_nonnucs, species->IsNucleotideBased(), chromosome.AncestralSequence());
+			
+			if (!bgzf_stream || !bgzf_buf.Finish())
+				EIDOS_TERMINATION << "ERROR (Genome_Class::ExecuteMethod_outputX): error compressing output to " << outfile_path << "." << EidosTerminate();
+			
+			outfile.close();
+		}
+		else if (outfile.is_open())
 		{
 			switch (p_method_id)
 			{
@@ -2988,6 +3261,59 @@ EidosValue_SP Genome_Class::ExecuteMethod_outputX(EidosGlobalStringID p_method_i
 	return gStaticEidosValueVOID;
 }
 
+//	*********************	+ (void)outputHaplotypes(string$ filePath, [logical$ append = F], [logical$ filterMonomorphic = F])
+//
+EidosValue_SP Genome_Class::ExecuteMethod_outputHaplotypes(EidosGlobalStringID p_method_id, EidosValue_Object *p_target, const std::vector<EidosValue_SP> &p_arguments, EidosInterpreter &p_interpreter) const
+{
+#pragma unused (p_method_id, p_target, p_arguments, p_interpreter)
+	EidosValue *filePath_value = p_arguments[0].get();
+	EidosValue *append_value = p_arguments[1].get();
+	EidosValue *filterMonomorphic_value = p_arguments[2].get();
+	
+	bool append = append_value->LogicalAtIndex_NOCAST(0, nullptr);
+	bool filter_monomorphic = filterMonomorphic_value->LogicalAtIndex_NOCAST(0, nullptr);
+	
+	// Get all the genomes we're sampling from p_target; they must all be in the same species, as for outputMS()
+	int sample_size = p_target->Count();
+	std::vector<Genome *> genomes;
+	Species *species = nullptr;
+	
+	if (sample_size <= 0)
+		EIDOS_TERMINATION << "ERROR (Genome_Class::ExecuteMethod_outputHaplotypes): output of a zero-length genome vector is illegal; at least one genome is required for output." << EidosTerminate();
+	
+	for (int index = 0; index < sample_size; ++index)
+	{
+		Genome *genome = (Genome *)p_target->ObjectElementAtIndex_NOCAST(index, nullptr);
+		Species *genome_species = &genome->individual_->subpopulation_->species_;
+		
+		if (!species)
+			species = genome_species;
+		else if (species != genome_species)
+			EIDOS_TERMINATION << "ERROR (Genome_Class::ExecuteMethod_outputHaplotypes): all genomes for output must belong to the same species." << EidosTerminate();
+		
+		genomes.emplace_back(genome);
+	}
+	
+	species->population_.CheckForDeferralInGenomes(p_target, "Genome_Class::ExecuteMethod_outputHaplotypes");
+	
+	// Write the binary haplotype matrix to filePath; each write is self-contained, so appended samples can be read in sequence
+	std::string outfile_path = Eidos_ResolvedPath(filePath_value->StringAtIndex_NOCAST(0, nullptr));
+	std::ofstream outfile;
+	
+	outfile.open(outfile_path.c_str(), (append ? (std::ios_base::app | std::ios_base::out) : std::ios_base::out) | std::ios_base::binary);
+	
+	if (!outfile.is_open())
+		EIDOS_TERMINATION << "ERROR (Genome_Class::ExecuteMethod_outputHaplotypes): could not open "<< outfile_path << "." << EidosTerminate();
+	
+	Genome::WriteGenomes_Haplotypes(outfile, genomes, species->TheChromosome(), filter_monomorphic);
+	outfile.close();
+	
+	if (!outfile)
+		EIDOS_TERMINATION << "ERROR (Genome_Class::ExecuteMethod_outputHaplotypes): error writing to " << outfile_path << "." << EidosTerminate();
+	
+	return gStaticEidosValueVOID;
+}
+
 //	*********************	+ (o<Mutation>)readFromMS(s$ filePath = NULL, io<MutationType> mutationType)
 //
 EidosValue_SP Genome_Class::ExecuteMethod_readFromMS(EidosGlobalStringID p_method_id, EidosValue_Object *p_target, const std::vector<EidosValue_SP> &p_arguments, EidosInterpreter &p_interpreter) const
@@ -3027,30 +3353,56 @@ EidosValue_SP Genome_Class::ExecuteMethod_readFromMS(EidosGlobalStringID p_metho
 	
 	species.population_.CheckForDeferralInGenomes(p_target, "Genome_Class::ExecuteMethod_readFromMS");
 	
-	// Parse the whole input file and retain the information from it
-	std::ifstream infile(file_path);
+	// Parse the whole input file and retain the information from it; the file is mapped into memory (and decompressed, if it is
+	// gzipped), and the call lines, which are the bulk of the file, are kept in place rather than being copied into strings
+	Eidos_MappedFile infile(file_path);
 	
-	if (!infile)
+	if (!infile.IsOpen())
 		EIDOS_TERMINATION << "ERROR (Genome_Class::ExecuteMethod_readFromMS): could not read file at path " << file_path << "." << EidosTerminate();
 	
+	const char *file_data = infile.Data();
+	size_t file_size = infile.Size();
+	std::vector<char> decompressed_data;
+	
+	if (Eidos_IsGzipData(file_data, file_size))
+	{
+		if (!Eidos_DecompressGzipData(file_data, file_size, decompressed_data))
+			EIDOS_TERMINATION << "ERROR (Genome_Class::ExecuteMethod_readFromMS): could not decompress file at path " << file_path << "; the file may be corrupt, or may use gzip features that are not supported." << EidosTerminate();
+		
+		file_data = decompressed_data.data();
+		file_size = decompressed_data.size();
+	}
+	
 	std::string line, sub;
 	int parse_state = 0;
 	int segsites = -1;
 	std::vector<slim_position_t> positions;
-	std::vector<std::string> calls;
+	std::vector<const char *> calls;		// the start of each call line within file_data; each is segsites characters long
+	const char *file_end = file_data + file_size;
+	const char *line_start = file_data;
 	
-	while (!infile.eof())
+	for ( ; line_start < file_end; )
 	{
-		getline(infile, line);
+		const char *line_end = (const char *)memchr(line_start, '\n', (size_t)(file_end - line_start));
 		
-		if ((line.length() == 0) || (line.find("//") == 0))
+		if (!line_end)
+			line_end = file_end;
+		
+		const char *next_line_start = line_end + 1;
+		size_t line_length = (size_t)(line_end - line_start);
+		
+		if ((line_length == 0) || ((line_length >= 2) && (line_start[0] == '/') && (line_start[1] == '/')))
+		{
+			line_start = next_line_start;
 			continue;
+		}
 		
 		switch (parse_state)
 		{
 			case 0:
 			{
 				// Expecting "segsites: x"
+				line.assign(line_start, line_end);
 				std::istringstream iss(line);
 				
 				iss >> sub;
@@ -3076,6 +3428,7 @@ EidosValue_SP Genome_Class::ExecuteMethod_readFromMS(EidosGlobalStringID p_metho
 			case 1:
 			{
 				// Expecting "positions: a b c..."
+				line.assign(line_start, line_end);
 				std::istringstream iss(line);
 				
 				iss >> sub;
@@ -3112,21 +3465,22 @@ EidosValue_SP Genome_Class::ExecuteMethod_readFromMS(EidosGlobalStringID p_metho
 			case 2:
 			{
 				// Expecting "001010011001101111010..." of length segsites
-				if (line.find_first_not_of("01") != std::string::npos)
-					EIDOS_TERMINATION << "ERROR (Genome_Class::ExecuteMethod_readFromMS): call lines must be composed entirely of 0 and 1." << EidosTerminate();
-				if ((int)line.length() != segsites)
+				for (const char *call_ptr = line_start; call_ptr < line_end; ++call_ptr)
+					if ((*call_ptr != '0') && (*call_ptr != '1'))
+						EIDOS_TERMINATION << "ERROR (Genome_Class::ExecuteMethod_readFromMS): call lines must be composed entirely of 0 and 1." << EidosTerminate();
+				if ((int)line_length != segsites)
 					EIDOS_TERMINATION << "ERROR (Genome_Class::ExecuteMethod_readFromMS): call lines must be equal in length to the segsites value." << EidosTerminate();
 				
-				calls.emplace_back(line);
+				calls.emplace_back(line_start);
 				break;
 			}
 			default:
 				EIDOS_TERMINATION << "ERROR (Genome_Class::ExecuteMethod_readFromMS): (internal error) unhandled case." << EidosTerminate();
 		}
+		
+		line_start = next_line_start;
 	}
 	
-	infile.close();
-	
 	if ((int)calls.size() != target_size)
 		EIDOS_TERMINATION << "ERROR (Genome_Class::ExecuteMethod_readFromMS): target genome vector has size " << target_size << " but " << calls.size() << " call lines found." << EidosTerminate();
 	
@@ -3191,7 +3545,7 @@ EidosValue_SP Genome_Class::ExecuteMethod_readFromMS(EidosGlobalStringID p_metho
 		slim_position_t mutrun_length = genome->mutrun_length_;
 		slim_mutrun_index_t current_run_index = -1;
 		MutationRun *current_mutrun = nullptr;
-		std::string &genome_string = calls[genome_index];
+		const char *genome_string = calls[genome_index];
 		
 		for (int segsite_index = 0; segsite_index < segsites; ++segsite_index)
 		{
@@ -3225,20 +3579,129 @@ EidosValue_SP Genome_Class::ExecuteMethod_readFromMS(EidosGlobalStringID p_metho
 				else
 					current_mutrun->insert_sorted_mutation(mut_index);
 				
-				if (recording_mutations)
-					species.RecordNewDerivedState(genome, mut_pos, *genome->derived_mutation_ids_at_position(mut_pos));
+				if (recording_mutations)
+					species.RecordNewDerivedState(genome, mut_pos, *genome->derived_mutation_ids_at_position(mut_pos));
+			}
+		}
+	}
+	
+	// Return the instantiated mutations
+	int mutation_count = (int)mutation_indices.size();
+	EidosValue_Object *vec = (new (gEidosValuePool->AllocateChunk()) EidosValue_Object(gSLiM_Mutation_Class))->resize_no_initialize_RR(mutation_count);
+	
+	for (int mut_index = 0; mut_index < mutation_count; ++mut_index)
+		vec->set_object_element_no_check_no_previous_RR(mut_block_ptr + mutation_indices[mut_index], mut_index);
+	
+	return EidosValue_Object_SP(vec);
+}
+
+// Helper for Genome_Class::ExecuteMethod_readFromVCF(), which scans the genotype columns of call lines in parallel; only the common
+// cases are handled here (GT fields of one or two calls, in simple integer form), and any line that is not handled, including any
+// line that is malformed, is flagged with needs_full_parse_ so that it can be re-parsed, with error checking, by the caller
+struct VCFGenotypeScan
+{
+	std::vector<std::pair<int, int>> nonref_calls_;		// (genome index, call) for each call that is not 0 (REF)
+	bool needs_full_parse_;
+};
+
+static void _ScanVCFGenotypes(const char *p_line_start, const char *p_line_end, int p_sample_id_count, int p_target_size, VCFGenotypeScan &p_scan)
+{
+	const char *ptr = p_line_start;
+	int alt_allele_count = 1;
+	
+	p_scan.nonref_calls_.clear();
+	p_scan.needs_full_parse_ = true;
+	
+	if (p_sample_id_count == 0)
+		return;
+	
+	// skip the nine fixed fields, counting the ALT alleles; each field must be followed by a tab, since samples follow
+	for (int field_index = 0; field_index < 9; ++field_index)
+	{
+		const char *field_end = (const char *)memchr(ptr, '\t', (size_t)(p_line_end - ptr));
+		
+		if (!field_end)
+			return;
+		
+		if (field_index == 4)
+			alt_allele_count += (int)std::count(ptr, field_end, ',');
+		
+		ptr = field_end + 1;
+	}
+	
+	int genome_index = 0;
+	
+	// this is a single forward pass over the samples, since this is the hotspot of readFromVCF() for large files
+	for (int sample_index = 0; sample_index < p_sample_id_count; ++sample_index)
+	{
+		// first check for the overwhelmingly common case of a diploid call of single digits, followed by a tab
+		if ((p_line_end - ptr > 4) && (genome_index + 2 <= p_target_size) && (ptr[3] == '\t') && ((ptr[1] == '|') || (ptr[1] == '/')))
+		{
+			int call1 = ptr[0] - '0', call2 = ptr[2] - '0';
+			
+			if ((call1 >= 0) && (call1 <= std::min(alt_allele_count, 9)) && (call2 >= 0) && (call2 <= std::min(alt_allele_count, 9)) && (sample_index < p_sample_id_count - 1))
+			{
+				if (call1 != 0)
+					p_scan.nonref_calls_.emplace_back(genome_index, call1);
+				if (call2 != 0)
+					p_scan.nonref_calls_.emplace_back(genome_index + 1, call2);
+				
+				genome_index += 2;
+				ptr += 4;
+				continue;
 			}
 		}
+		
+		// parse one or two calls separated by | or /; we require simple integers with no leading zeros, and leave the rest to the caller
+		for (int call_index = 0; call_index < 2; ++call_index)
+		{
+			const char *digits_start = ptr;
+			int call = 0;
+			
+			while ((ptr < p_line_end) && (*ptr >= '0') && (*ptr <= '9') && (ptr - digits_start < 9))
+				call = call * 10 + (*ptr++ - '0');
+			
+			if ((ptr == digits_start) || ((*digits_start == '0') && (ptr - digits_start > 1)) || (call > alt_allele_count))
+				return;
+			if (genome_index >= p_target_size)
+				return;
+			
+			if (call != 0)
+				p_scan.nonref_calls_.emplace_back(genome_index, call);
+			genome_index++;
+			
+			if ((call_index == 1) || (ptr == p_line_end) || ((*ptr != '|') && (*ptr != '/')))
+				break;
+			ptr++;
+		}
+		
+		// the GT field must end here; skip any other fields for the sample
+		if ((ptr < p_line_end) && (*ptr == ':'))
+		{
+			ptr = (const char *)memchr(ptr, '\t', (size_t)(p_line_end - ptr));
+			
+			if (!ptr)
+				ptr = p_line_end;
+		}
+		
+		// the last sample must end the line, and no other sample may
+		if (sample_index == p_sample_id_count - 1)
+		{
+			if (ptr != p_line_end)
+				return;
+		}
+		else
+		{
+			if ((ptr == p_line_end) || (*ptr != '\t'))
+				return;
+			ptr++;
+		}
 	}
 	
-	// Return the instantiated mutations
-	int mutation_count = (int)mutation_indices.size();
-	EidosValue_Object *vec = (new (gEidosValuePool->AllocateChunk()) EidosValue_Object(gSLiM_Mutation_Class))->resize_no_initialize_RR(mutation_count);
-	
-	for (int mut_index = 0; mut_index < mutation_count; ++mut_index)
-		vec->set_object_element_no_check_no_previous_RR(mut_block_ptr + mutation_indices[mut_index], mut_index);
+	if (genome_index != p_target_size)
+		return;
 	
-	return EidosValue_Object_SP(vec);
+	p_scan.needs_full_parse_ = false;
 }
 
 //	*********************	+ (o<Mutation>)readFromVCF(s$ filePath = NULL, [Nio<MutationType> mutationType = NULL])
@@ -3273,28 +3736,51 @@ EidosValue_SP Genome_Class::ExecuteMethod_readFromVCF(EidosGlobalStringID p_meth
 	if (mutationType_value->Type() != EidosValueType::kValueNULL)
 		default_mutation_type_ptr = SLiM_ExtractMutationTypeFromEidosValue_io(mutationType_value, 0, &community, species, "readFromVCF()");			// SPECIES CONSISTENCY CHECK
 	
-	// Parse the whole input file and retain the information from it
-	std::ifstream infile(file_path);
+	// Read the input file, which may be gzip-compressed (BGZF, as written by outputVCF(compress=T) or bgzip, or a single gzip member);
+	// uncompressed files are memory-mapped rather than copied.  Call lines are kept as spans within the file data, not as strings.
+	Eidos_MappedFile infile(file_path);
 	
-	if (!infile)
+	if (!infile.IsOpen())
 		EIDOS_TERMINATION << "ERROR (Genome_Class::ExecuteMethod_readFromVCF): could not read file at path " << file_path << "." << EidosTerminate();
 	
+	const char *file_data = infile.Data();
+	size_t file_size = infile.Size();
+	std::vector<char> decompressed_data;
+	
+	if (Eidos_IsGzipData(file_data, file_size))
+	{
+		if (!Eidos_DecompressGzipData(file_data, file_size, decompressed_data))
+			EIDOS_TERMINATION << "ERROR (Genome_Class::ExecuteMethod_readFromVCF): could not decompress file at path " << file_path << "; the file may be corrupt, or may use gzip features that are not supported." << EidosTerminate();
+		
+		file_data = decompressed_data.data();
+		file_size = decompressed_data.size();
+	}
+	
+	struct VCFCallLine { slim_position_t position_; const char *start_; const char *end_; };
+	
 	std::string line, sub;
 	int parse_state = 0;
 	int sample_id_count = 0;
 	int target_size = p_target->Count();
 	bool info_MID_defined = false, info_S_defined = false, info_DOM_defined = false, info_PO_defined = false;
 	bool info_GO_defined = false, info_TO_defined = false, info_MT_defined = false, /*info_AA_defined = false,*/ info_NONNUC_defined = false;
-	std::vector<std::pair<slim_position_t, std::string>> call_lines;
+	std::vector<VCFCallLine> call_lines;
+	const char *file_end = file_data + file_size;
+	const char *line_start = file_data;
 	
-	while (!infile.eof())
+	while (true)
 	{
-		getline(infile, line);
+		const char *line_end = (file_size ? (const char *)memchr(line_start, '\n', (size_t)(file_end - line_start)) : nullptr);
+		
+		if (!line_end)
+			line_end = file_end;
 		
 		switch (parse_state)
 		{
 			case 0:
 			{
+				line.assign(line_start, line_end);
+				
 				// In header, parsing ## lines, until we get to the #CHROM line; the point of this is that we only want to interpret
 				// INFO fields like MID, S, etc. as having their SLiM-specific meaning if their SLiM-specific definition is present
 				if (line.compare(0, 2, "##") == 0)
@@ -3340,33 +3826,37 @@ EidosValue_SP Genome_Class::ExecuteMethod_readFromVCF(EidosGlobalStringID p_meth
 			}
 			case 1:
 			{
-				// In call lines, fields are separated by tabs, and could theoretically contain spaces; here we just read a whole line,
-				// extract the position field for the mutation, and save the line indexed by its mutation's position for later handling
-				if (line.length() == 0)
+				// In call lines, fields are separated by tabs, and could theoretically contain spaces; here we just extract the position
+				// field for the mutation, and save the line's span indexed by its mutation's position for later handling
+				if (line_end == line_start)
 					break;
 				
-				std::istringstream iss(line);
+				const char *chrom_end = (const char *)memchr(line_start, '\t', (size_t)(line_end - line_start));
+				const char *pos_start = (chrom_end ? chrom_end + 1 : line_end);
+				const char *pos_end = (const char *)memchr(pos_start, '\t', (size_t)(line_end - pos_start));
 				
-				std::getline(iss, sub, '\t');	// CHROM
-				std::getline(iss, sub, '\t');	// POS
+				sub.assign(pos_start, pos_end ? pos_end : line_end);	// POS
 				
 				int64_t pos = EidosInterpreter::NonnegativeIntegerForString(sub, nullptr) - 1;		// -1 because VCF uses 1-based positions
 				
 				if ((pos < 0) || (pos > last_position))
 					EIDOS_TERMINATION << "ERROR (Genome_Class::ExecuteMethod_readFromVCF): VCF file POS value " << pos << " out of range." << EidosTerminate();
 				
-				call_lines.emplace_back(pos, line);
+				call_lines.emplace_back(VCFCallLine{pos, line_start, line_end});
 				break;
 			}
 			default:
 				EIDOS_TERMINATION << "ERROR (Genome_Class::ExecuteMethod_readFromVCF): (internal error) unhandled case." << EidosTerminate();
 		}
+		
+		if (line_end == file_end)
+			break;
+		
+		line_start = line_end + 1;
 	}
 	
-	infile.close();
-	
 	// sort the call lines by position, so that we can add them to empty genomes efficiently
-	std::sort(call_lines.begin(), call_lines.end(), [ ](const std::pair<slim_position_t, std::string> &l1, const std::pair<slim_position_t, std::string> &l2) {return l1.first < l2.first;});
+	std::sort(call_lines.begin(), call_lines.end(), [ ](const VCFCallLine &l1, const VCFCallLine &l2) {return l1.position_ < l2.position_;});
 	
 	// cache target genomes and determine whether they are initially empty, in which case we can do fast mutation addition with emplace_back()
 	std::vector<Genome *> targets;
@@ -3400,387 +3890,436 @@ EidosValue_SP Genome_Class::ExecuteMethod_readFromVCF(EidosGlobalStringID p_meth
 	std::vector<MutationIndex> mutation_indices;
 	bool has_initial_mutations = (gSLiM_next_mutation_id != 0);
 	
-	for (std::pair<slim_position_t, std::string> &call_line : call_lines)
+	// The call lines are handled in chunks.  For each chunk, the genotype columns, which are the bulk of the file, are first scanned
+	// in parallel into lists of the non-REF calls in each line, by _ScanVCFGenotypes(); a line that scanner does not handle is flagged,
+	// and its genotypes are parsed again below by the full (slower) parser, which also produces any error messages.  Then, in order, the
+	// rest of each line is parsed, and its mutations are instantiated and added to the target genomes.
+	const size_t max_chunk_bytes = 64 * 1024 * 1024;
+	std::vector<VCFGenotypeScan> genotype_scans;
+	
+	for (size_t chunk_start = 0; chunk_start < call_lines.size(); )
 	{
-		slim_position_t mut_position = call_line.first;
-		std::istringstream iss(call_line.second);
-		std::string ref_str, alt_str, info_str;
-		
-		std::getline(iss, sub, '\t');		// CHROM; don't care
-		std::getline(iss, sub, '\t');		// POS; already fetched
-		std::getline(iss, sub, '\t');		// ID; don't care
-		std::getline(iss, ref_str, '\t');	// REF
-		std::getline(iss, alt_str, '\t');	// ALT
-		std::getline(iss, sub, '\t');		// QUAL; don't care
-		std::getline(iss, sub, '\t');		// FILTER; don't care
-		std::getline(iss, info_str, '\t');	// INFO
-		std::getline(iss, sub, '\t');		// FORMAT; don't care (GT must be first, according to the standard; we don't check)
-		
-		// parse/validate the REF nucleotide
-		int8_t ref_nuc;
-		
-		if (ref_str == "A")			ref_nuc = 0;
-		else if (ref_str == "C")	ref_nuc = 1;
-		else if (ref_str == "G")	ref_nuc = 2;
-		else if (ref_str == "T")	ref_nuc = 3;
-		else						EIDOS_TERMINATION << "ERROR (Genome_Class::ExecuteMethod_readFromVCF): VCF file REF value must be A/C/G/T." << EidosTerminate();
-		
-		// parse/validate the ALT nucleotides
-		std::vector<std::string> alt_substrs = Eidos_string_split(alt_str, ",");
-		std::vector<int8_t> alt_nucs;
-		
-		for (std::string &alt_substr : alt_substrs)
+		size_t chunk_end = chunk_start, chunk_bytes = 0;
+		
+		while ((chunk_end < call_lines.size()) && ((chunk_end == chunk_start) || (chunk_bytes < max_chunk_bytes)))
 		{
-			if (alt_substr == "A")			alt_nucs.emplace_back(0);
-			else if (alt_substr == "C")		alt_nucs.emplace_back(1);
-			else if (alt_substr == "G")		alt_nucs.emplace_back(2);
-			else if (alt_substr == "T")		alt_nucs.emplace_back(3);
-			else							EIDOS_TERMINATION << "ERROR (Genome_Class::ExecuteMethod_readFromVCF): VCF file ALT value must be A/C/G/T." << EidosTerminate();
+			chunk_bytes += (size_t)(call_lines[chunk_end].end_ - call_lines[chunk_end].start_);
+			chunk_end++;
 		}
 		
-		std::size_t alt_allele_count = alt_nucs.size();
+		int64_t chunk_line_count = (int64_t)(chunk_end - chunk_start);
+		const VCFCallLine *chunk_lines = call_lines.data() + chunk_start;
 		
-		// parse/validate the INFO fields that we recognize
-		std::vector<std::string> info_substrs = Eidos_string_split(info_str, ";");
-		std::vector<slim_mutationid_t> info_mutids;
-		std::vector<double> info_selcoeffs;
-		std::vector<double> info_domcoeffs;
-		std::vector<slim_objectid_t> info_poporigin;
-		std::vector<slim_tick_t> info_tickorigin;
-		std::vector<slim_objectid_t> info_muttype;
-		int8_t info_ancestral_nuc = -1;
-		bool info_is_nonnuc = false;
+		genotype_scans.resize((size_t)chunk_line_count);
 		
-		for (std::string &info_substr : info_substrs)
+		EIDOS_THREAD_COUNT(gEidos_OMP_threads_VCF_INPUT);
+#pragma omp parallel for schedule(dynamic, 16) default(none) shared(genotype_scans, chunk_line_count, sample_id_count, target_size) firstprivate(chunk_lines) if(chunk_line_count >= EIDOS_OMPMIN_VCF_INPUT) num_threads(thread_count)
+		for (int64_t line_index = 0; line_index < chunk_line_count; ++line_index)
+			_ScanVCFGenotypes(chunk_lines[line_index].start_, chunk_lines[line_index].end_, sample_id_count, target_size, genotype_scans[line_index]);
+		
+		for (int64_t line_index = 0; line_index < chunk_line_count; ++line_index)
 		{
-			if (info_MID_defined && (info_substr.compare(0, 4, "MID=") == 0))		// Mutation ID
-			{
-				std::vector<std::string> value_substrs = Eidos_string_split(info_substr.substr(4), ",");
-				
-				for (std::string &value_substr : value_substrs)
-					info_mutids.emplace_back((slim_mutationid_t)EidosInterpreter::NonnegativeIntegerForString(value_substr, nullptr));
-				
-				if (info_mutids.size() && has_initial_mutations)
-				{
-					if (!gEidosSuppressWarnings)
-					{
-						if (!community.warned_readFromVCF_mutIDs_unused_)
-						{
-							p_interpreter.ErrorOutputStream() << "#WARNING (Genome_Class::ExecuteMethod_readFromVCF): readFromVCF(): the VCF file specifies mutation IDs with the MID field, but some mutation IDs have already been used so uniqueness cannot be guaranteed.  Use of mutation IDs is therefore disabled; mutations will not receive the mutation ID requested in the file.  To fix this warning, remove the MID field from the VCF file before reading.  To get readFromVCF() to use the specified mutation IDs, load the VCF file into a model that has never simulated a mutation, and has therefore not used any mutation IDs." << std::endl;
-							community.warned_readFromVCF_mutIDs_unused_ = true;
-						}
-					}
-					
-					// disable use of MID for this read
-					info_MID_defined = false;
-					info_mutids.clear();
-				}
-			}
-			else if (info_S_defined && (info_substr.compare(0, 2, "S=") == 0))		// Selection Coefficient
-			{
-				std::vector<std::string> value_substrs = Eidos_string_split(info_substr.substr(2), ",");
-				
-				for (std::string &value_substr : value_substrs)
-					info_selcoeffs.emplace_back(EidosInterpreter::FloatForString(value_substr, nullptr));
-			}
-			else if (info_DOM_defined && (info_substr.compare(0, 4, "DOM=") == 0))	// Dominance Coefficient
-			{
-				std::vector<std::string> value_substrs = Eidos_string_split(info_substr.substr(4), ",");
-				
-				for (std::string &value_substr : value_substrs)
-					info_domcoeffs.emplace_back(EidosInterpreter::FloatForString(value_substr, nullptr));
-			}
-			else if (info_PO_defined && (info_substr.compare(0, 3, "PO=") == 0))	// Population of Origin
-			{
-				std::vector<std::string> value_substrs = Eidos_string_split(info_substr.substr(3), ",");
-				
-				for (std::string &value_substr : value_substrs)
-					info_poporigin.emplace_back((slim_objectid_t)EidosInterpreter::NonnegativeIntegerForString(value_substr, nullptr));
-			}
-			else if (info_TO_defined && (info_substr.compare(0, 3, "TO=") == 0))	// Tick of Origin
-			{
-				std::vector<std::string> value_substrs = Eidos_string_split(info_substr.substr(3), ",");
-				
-				for (std::string &value_substr : value_substrs)
-					info_tickorigin.emplace_back((slim_tick_t)EidosInterpreter::NonnegativeIntegerForString(value_substr, nullptr));
-			}
-			else if (info_GO_defined && (info_substr.compare(0, 3, "GO=") == 0))	// Generation of Origin - emitted by SLiM 3, treated as TO here
+			const VCFCallLine &call_line = chunk_lines[line_index];
+			VCFGenotypeScan &genotype_scan = genotype_scans[line_index];
+			slim_position_t mut_position = call_line.position_;
+			const char *field_start = call_line.start_;
+			std::string ref_str, alt_str, info_str;
+			
+			// Extract the fixed fields, following getline() semantics: a missing field is empty
+			for (int field_index = 0; field_index < 9; ++field_index)
 			{
-				std::vector<std::string> value_substrs = Eidos_string_split(info_substr.substr(3), ",");
+				const char *field_end = (const char *)memchr(field_start, '\t', (size_t)(call_line.end_ - field_start));
 				
-				for (std::string &value_substr : value_substrs)
-					info_tickorigin.emplace_back((slim_tick_t)EidosInterpreter::NonnegativeIntegerForString(value_substr, nullptr));
-			}
-			else if (info_MT_defined && (info_substr.compare(0, 3, "MT=") == 0))	// Mutation Type
-			{
-				std::vector<std::string> value_substrs = Eidos_string_split(info_substr.substr(3), ",");
+				if (!field_end)
+					field_end = call_line.end_;
 				
-				for (std::string &value_substr : value_substrs)
-					info_muttype.emplace_back((slim_objectid_t)EidosInterpreter::NonnegativeIntegerForString(value_substr, nullptr));
-			}
-			else if (/* info_AA_defined && */ (info_substr.compare(0, 3, "AA=") == 0))	// Ancestral Allele; definition not required since it is a standard field
-			{
-				std::string aa_str = info_substr.substr(3);
+				if (field_index == 3)		ref_str.assign(field_start, field_end);		// REF
+				else if (field_index == 4)	alt_str.assign(field_start, field_end);		// ALT
+				else if (field_index == 7)	info_str.assign(field_start, field_end);	// INFO
+				// CHROM, ID, QUAL, and FILTER we don't care about; POS was already fetched; FORMAT we don't care about (GT must be first, according to the standard; we don't check)
 				
-				if (aa_str == "A")			info_ancestral_nuc = 0;
-				else if (aa_str == "C")		info_ancestral_nuc = 1;
-				else if (aa_str == "G")		info_ancestral_nuc = 2;
-				else if (aa_str == "T")		info_ancestral_nuc = 3;
-				else						EIDOS_TERMINATION << "ERROR (Genome_Class::ExecuteMethod_readFromVCF): VCF file AA value must be A/C/G/T." << EidosTerminate();
-			}
-			else if (info_NONNUC_defined && (info_substr == "NONNUC"))				// Non-nucleotide-based
-			{
-				info_is_nonnuc = true;
+				field_start = (field_end == call_line.end_) ? field_end : field_end + 1;
 			}
 			
-			if ((info_mutids.size() != 0) && (info_mutids.size() != alt_allele_count))
-				EIDOS_TERMINATION << "ERROR (Genome_Class::ExecuteMethod_readFromVCF): VCF file unexpected value count for MID field." << EidosTerminate();
-			if ((info_selcoeffs.size() != 0) && (info_selcoeffs.size() != alt_allele_count))
-				EIDOS_TERMINATION << "ERROR (Genome_Class::ExecuteMethod_readFromVCF): VCF file unexpected value count for S field." << EidosTerminate();
-			if ((info_domcoeffs.size() != 0) && (info_domcoeffs.size() != alt_allele_count))
-				EIDOS_TERMINATION << "ERROR (Genome_Class::ExecuteMethod_readFromVCF): VCF file unexpected value count for DOM field." << EidosTerminate();
-			if ((info_poporigin.size() != 0) && (info_poporigin.size() != alt_allele_count))
-				EIDOS_TERMINATION << "ERROR (Genome_Class::ExecuteMethod_readFromVCF): VCF file unexpected value count for PO field." << EidosTerminate();
-			if ((info_tickorigin.size() != 0) && (info_tickorigin.size() != alt_allele_count))
-				EIDOS_TERMINATION << "ERROR (Genome_Class::ExecuteMethod_readFromVCF): VCF file unexpected value count for GO or TO field." << EidosTerminate();
-			if ((info_muttype.size() != 0) && (info_muttype.size() != alt_allele_count))
-				EIDOS_TERMINATION << "ERROR (Genome_Class::ExecuteMethod_readFromVCF): VCF file unexpected value count for MT field." << EidosTerminate();
-		}
-		
-		// read the genotype data for each sample id, which might be diploid or haploid, and might have data beyond GT
-		std::vector<int> genotype_calls;
-		
-		for (int sample_index = 0; sample_index < sample_id_count; ++sample_index)
-		{
-			if (iss.eof())
-				EIDOS_TERMINATION << "ERROR (Genome_Class::ExecuteMethod_readFromVCF): VCF file call line ended unexpectedly before the last sample." << EidosTerminate();
+			// parse/validate the REF nucleotide
+			int8_t ref_nuc;
+			
+			if (ref_str == "A")			ref_nuc = 0;
+			else if (ref_str == "C")	ref_nuc = 1;
+			else if (ref_str == "G")	ref_nuc = 2;
+			else if (ref_str == "T")	ref_nuc = 3;
+			else						EIDOS_TERMINATION << "ERROR (Genome_Class::ExecuteMethod_readFromVCF): VCF file REF value must be A/C/G/T." << EidosTerminate();
 			
-			std::getline(iss, sub, '\t');
+			// parse/validate the ALT nucleotides
+			std::vector<std::string> alt_substrs = Eidos_string_split(alt_str, ",");
+			std::vector<int8_t> alt_nucs;
 			
-			// extract just the GT field if others are present
-			std::size_t colon_pos = sub.find_first_of(':');
+			for (std::string &alt_substr : alt_substrs)
+			{
+				if (alt_substr == "A")			alt_nucs.emplace_back(0);
+				else if (alt_substr == "C")		alt_nucs.emplace_back(1);
+				else if (alt_substr == "G")		alt_nucs.emplace_back(2);
+				else if (alt_substr == "T")		alt_nucs.emplace_back(3);
+				else							EIDOS_TERMINATION << "ERROR (Genome_Class::ExecuteMethod_readFromVCF): VCF file ALT value must be A/C/G/T." << EidosTerminate();
+			}
 			
-			if (colon_pos != std::string::npos)
-				sub = sub.substr(0, colon_pos);
+			std::size_t alt_allele_count = alt_nucs.size();
 			
-			// separate haploid calls that are joined by | or /; this is the hotspot of the whole method, so we try to be efficient here
-			bool call_handled = false;
+			// parse/validate the INFO fields that we recognize
+			std::vector<std::string> info_substrs = Eidos_string_split(info_str, ";");
+			std::vector<slim_mutationid_t> info_mutids;
+			std::vector<double> info_selcoeffs;
+			std::vector<double> info_domcoeffs;
+			std::vector<slim_objectid_t> info_poporigin;
+			std::vector<slim_tick_t> info_tickorigin;
+			std::vector<slim_objectid_t> info_muttype;
+			int8_t info_ancestral_nuc = -1;
+			bool info_is_nonnuc = false;
 			
-			if ((sub.length() == 3) && ((sub[1] == '|') || (sub[1] == '/')))
+			for (std::string &info_substr : info_substrs)
 			{
-				// diploid, both single-digit
-				char sub_ch1 = sub[0];
-				char sub_ch2 = sub[2];
-				
-				if ((sub_ch1 >= '0') && (sub_ch1 <= '9') && (sub_ch2 >= '0') && (sub_ch2 <= '9'))
+				if (info_MID_defined && (info_substr.compare(0, 4, "MID=") == 0))		// Mutation ID
+				{
+					std::vector<std::string> value_substrs = Eidos_string_split(info_substr.substr(4), ",");
+					
+					for (std::string &value_substr : value_substrs)
+						info_mutids.emplace_back((slim_mutationid_t)EidosInterpreter::NonnegativeIntegerForString(value_substr, nullptr));
+					
+					if (info_mutids.size() && has_initial_mutations)
+					{
+						if (!gEidosSuppressWarnings)
+						{
+							if (!community.warned_readFromVCF_mutIDs_unused_)
+							{
+								p_interpreter.ErrorOutputStream() << "#WARNING (Genome_Class::ExecuteMethod_readFromVCF): readFromVCF(): the VCF file specifies mutation IDs with the MID field, but some mutation IDs have already been used so uniqueness cannot be guaranteed.  Use of mutation IDs is therefore disabled; mutations will not receive the mutation ID requested in the file.  To fix this warning, remove the MID field from the VCF file before reading.  To get readFromVCF() to use the specified mutation IDs, load the VCF file into a model that has never simulated a mutation, and has therefore not used any mutation IDs." << std::endl;
+								community.warned_readFromVCF_mutIDs_unused_ = true;
+							}
+						}
+						
+						// disable use of MID for this read
+						info_MID_defined = false;
+						info_mutids.clear();
+					}
+				}
+				else if (info_S_defined && (info_substr.compare(0, 2, "S=") == 0))		// Selection Coefficient
 				{
-					int genotype_call1 = (int)(sub_ch1 - '0');
-					int genotype_call2 = (int)(sub_ch2 - '0');
+					std::vector<std::string> value_substrs = Eidos_string_split(info_substr.substr(2), ",");
 					
-					if ((genotype_call1 < 0) || (genotype_call1 > (int)alt_allele_count) || (genotype_call2 < 0) || (genotype_call2 > (int)alt_allele_count))	// 0 is REF, 1..n are ALT alleles
-						EIDOS_TERMINATION << "ERROR (Genome_Class::ExecuteMethod_readFromVCF): VCF file call out of range (does not correspond to a REF or ALT allele in the call line)." << EidosTerminate();
+					for (std::string &value_substr : value_substrs)
+						info_selcoeffs.emplace_back(EidosInterpreter::FloatForString(value_substr, nullptr));
+				}
+				else if (info_DOM_defined && (info_substr.compare(0, 4, "DOM=") == 0))	// Dominance Coefficient
+				{
+					std::vector<std::string> value_substrs = Eidos_string_split(info_substr.substr(4), ",");
 					
-					genotype_calls.emplace_back(genotype_call1);
-					genotype_calls.emplace_back(genotype_call2);
-					call_handled = true;
+					for (std::string &value_substr : value_substrs)
+						info_domcoeffs.emplace_back(EidosInterpreter::FloatForString(value_substr, nullptr));
 				}
-			}
-			else if (sub.length() == 1)
-			{
-				// haploid, single-digit
-				char sub_ch = sub[0];
-				
-				if ((sub_ch >= '0') && (sub_ch <= '9'))
+				else if (info_PO_defined && (info_substr.compare(0, 3, "PO=") == 0))	// Population of Origin
 				{
-					int genotype_call = (int)(sub_ch - '0');
+					std::vector<std::string> value_substrs = Eidos_string_split(info_substr.substr(3), ",");
 					
-					if ((genotype_call < 0) || (genotype_call > (int)alt_allele_count))	// 0 is REF, 1..n are ALT alleles
-						EIDOS_TERMINATION << "ERROR (Genome_Class::ExecuteMethod_readFromVCF): VCF file call out of range (does not correspond to a REF or ALT allele in the call line)." << EidosTerminate();
+					for (std::string &value_substr : value_substrs)
+						info_poporigin.emplace_back((slim_objectid_t)EidosInterpreter::NonnegativeIntegerForString(value_substr, nullptr));
+				}
+				else if (info_TO_defined && (info_substr.compare(0, 3, "TO=") == 0))	// Tick of Origin
+				{
+					std::vector<std::string> value_substrs = Eidos_string_split(info_substr.substr(3), ",");
 					
-					genotype_calls.emplace_back(genotype_call);
-					call_handled = true;
+					for (std::string &value_substr : value_substrs)
+						info_tickorigin.emplace_back((slim_tick_t)EidosInterpreter::NonnegativeIntegerForString(value_substr, nullptr));
 				}
-			}
-			
-			if (!call_handled)
-			{
-				std::vector<std::string> genotype_substrs;
-				
-				if (sub.find('|') != std::string::npos)
-					genotype_substrs = Eidos_string_split(sub, "|");	// phased
-				else if (sub.find('/') != std::string::npos)
-					genotype_substrs = Eidos_string_split(sub, "/");	// unphased; we don't worry about that
-				else
-					genotype_substrs.emplace_back(sub);					// haploid, presumably
-				
-				if ((genotype_substrs.size() < 1) || (genotype_substrs.size() > 2))
-					EIDOS_TERMINATION << "ERROR (Genome_Class::ExecuteMethod_readFromVCF): VCF file genotype calls must be diploid or haploid; " << genotype_substrs.size() << " calls found in one sample." << EidosTerminate();
-				
-				// extract the calls' integer values, validate them, and keep them; we don't care which call was in which sample, we just preserve their order
-				for (std::string &genotype_substr : genotype_substrs)
+				else if (info_GO_defined && (info_substr.compare(0, 3, "GO=") == 0))	// Generation of Origin - emitted by SLiM 3, treated as TO here
 				{
-					std::size_t genotype_call = EidosInterpreter::NonnegativeIntegerForString(genotype_substr, nullptr);
+					std::vector<std::string> value_substrs = Eidos_string_split(info_substr.substr(3), ",");
 					
-					if (/*(genotype_call < 0) ||*/ (genotype_call > alt_allele_count))	// 0 is REF, 1..n are ALT alleles
-						EIDOS_TERMINATION << "ERROR (Genome_Class::ExecuteMethod_readFromVCF): VCF file call out of range (does not correspond to a REF or ALT allele in the call line)." << EidosTerminate();
+					for (std::string &value_substr : value_substrs)
+						info_tickorigin.emplace_back((slim_tick_t)EidosInterpreter::NonnegativeIntegerForString(value_substr, nullptr));
+				}
+				else if (info_MT_defined && (info_substr.compare(0, 3, "MT=") == 0))	// Mutation Type
+				{
+					std::vector<std::string> value_substrs = Eidos_string_split(info_substr.substr(3), ",");
 					
-					genotype_calls.emplace_back((int)genotype_call);
+					for (std::string &value_substr : value_substrs)
+						info_muttype.emplace_back((slim_objectid_t)EidosInterpreter::NonnegativeIntegerForString(value_substr, nullptr));
+				}
+				else if (/* info_AA_defined && */ (info_substr.compare(0, 3, "AA=") == 0))	// Ancestral Allele; definition not required since it is a standard field
+				{
+					std::string aa_str = info_substr.substr(3);
+					
+					if (aa_str == "A")			info_ancestral_nuc = 0;
+					else if (aa_str == "C")		info_ancestral_nuc = 1;
+					else if (aa_str == "G")		info_ancestral_nuc = 2;
+					else if (aa_str == "T")		info_ancestral_nuc = 3;
+					else						EIDOS_TERMINATION << "ERROR (Genome_Class::ExecuteMethod_readFromVCF): VCF file AA value must be A/C/G/T." << EidosTerminate();
+				}
+				else if (info_NONNUC_defined && (info_substr == "NONNUC"))				// Non-nucleotide-based
+				{
+					info_is_nonnuc = true;
 				}
-			}
-		}
-		
-		if (!iss.eof())
-			EIDOS_TERMINATION << "ERROR (Genome_Class::ExecuteMethod_readFromVCF): VCF file call line has unexpected entries following the last sample." << EidosTerminate();
-		if ((int)genotype_calls.size() != target_size)
-			EIDOS_TERMINATION << "ERROR (Genome_Class::ExecuteMethod_readFromVCF): target genome vector has size " << target_size << " but " << genotype_calls.size() << " calls were found in one call line." << EidosTerminate();
-		
-		// instantiate the mutations involved in this call line; the REF allele represents no mutation, ALT alleles are each separate mutations
-		std::vector<MutationIndex> alt_allele_mut_indices;
-		
-		for (std::size_t alt_allele_index = 0; alt_allele_index < alt_allele_count; ++alt_allele_index)
-		{
-			// figure out the mutation type; if specified with MT, look it up, otherwise use the default supplied
-			MutationType *mutation_type_ptr = default_mutation_type_ptr;
-			
-			if (info_muttype.size() > 0)
-			{
-				slim_objectid_t mutation_type_id = info_muttype[alt_allele_index];
-                
-                mutation_type_ptr = species->MutationTypeWithID(mutation_type_id);
 				
-				if (!mutation_type_ptr)
-					EIDOS_TERMINATION << "ERROR (Genome_Class::ExecuteMethod_readFromVCF): VCF file MT field references a mutation type m" << mutation_type_id << " that is not defined." << EidosTerminate();
-			}
-			
-			if (!mutation_type_ptr)
-				EIDOS_TERMINATION << "ERROR (Genome_Class::ExecuteMethod_readFromVCF): VCF file MT field missing, but no default mutation type was supplied in the mutationType parameter." << EidosTerminate();
-			
-			// check the dominance coefficient of DOM against that of the mutation type
-			if (info_domcoeffs.size() > 0)
-			{
-				if (std::abs(info_domcoeffs[alt_allele_index] - mutation_type_ptr->dominance_coeff_) > 0.0001)
-					EIDOS_TERMINATION << "ERROR (Genome_Class::ExecuteMethod_readFromVCF): VCF file DOM field specifies a dominance coefficient " << info_domcoeffs[alt_allele_index] << " that differs from the mutation type's dominance coefficient of " << mutation_type_ptr->dominance_coeff_ << "." << EidosTerminate();
+				if ((info_mutids.size() != 0) && (info_mutids.size() != alt_allele_count))
+					EIDOS_TERMINATION << "ERROR (Genome_Class::ExecuteMethod_readFromVCF): VCF file unexpected value count for MID field." << EidosTerminate();
+				if ((info_selcoeffs.size() != 0) && (info_selcoeffs.size() != alt_allele_count))
+					EIDOS_TERMINATION << "ERROR (Genome_Class::ExecuteMethod_readFromVCF): VCF file unexpected value count for S field." << EidosTerminate();
+				if ((info_domcoeffs.size() != 0) && (info_domcoeffs.size() != alt_allele_count))
+					EIDOS_TERMINATION << "ERROR (Genome_Class::ExecuteMethod_readFromVCF): VCF file unexpected value count for DOM field." << EidosTerminate();
+				if ((info_poporigin.size() != 0) && (info_poporigin.size() != alt_allele_count))
+					EIDOS_TERMINATION << "ERROR (Genome_Class::ExecuteMethod_readFromVCF): VCF file unexpected value count for PO field." << EidosTerminate();
+				if ((info_tickorigin.size() != 0) && (info_tickorigin.size() != alt_allele_count))
+					EIDOS_TERMINATION << "ERROR (Genome_Class::ExecuteMethod_readFromVCF): VCF file unexpected value count for GO or TO field." << EidosTerminate();
+				if ((info_muttype.size() != 0) && (info_muttype.size() != alt_allele_count))
+					EIDOS_TERMINATION << "ERROR (Genome_Class::ExecuteMethod_readFromVCF): VCF file unexpected value count for MT field." << EidosTerminate();
 			}
 			
-			// get the selection coefficient from S, or draw one
-			double selection_coeff;
-			
-			if (info_selcoeffs.size() > 0)
-				selection_coeff = info_selcoeffs[alt_allele_index];
-			else
-				selection_coeff = mutation_type_ptr->DrawSelectionCoefficient();
-			
-			// get the subpop index from PO, or set to -1; no bounds checking on this
-			slim_objectid_t subpop_index = -1;
-			
-			if (info_poporigin.size() > 0)
-				subpop_index = info_poporigin[alt_allele_index];
-			
-			// get the origin tick from gO, or set to the current tick; no bounds checking on this
-			slim_tick_t origin_tick;
-			
-			if (info_tickorigin.size() > 0)
-				origin_tick = info_tickorigin[alt_allele_index];
-			else
-				origin_tick = community.Tick();
-			
-			// figure out the nucleotide and do nucleotide-related checks
-			int8_t alt_allele_nuc = alt_nucs[alt_allele_index];		// must be defined, in all cases, but might be ignored
-			int8_t nucleotide;
-			
-			if (nucleotide_based)
+			// if the fast scan did not handle this line, parse its genotype data with the full parser, which raises on malformed input
+			if (genotype_scan.needs_full_parse_)
 			{
-				if (info_NONNUC_defined)
+				// skip the fixed fields as getline() would, then parse the samples
+				std::istringstream iss(std::string(call_line.start_, call_line.end_));
+				
+				for (int field_index = 0; field_index < 9; ++field_index)
+					std::getline(iss, sub, '\t');
+				
+				// read the genotype data for each sample id, which might be diploid or haploid, and might have data beyond GT
+				std::vector<int> genotype_calls;
+				
+				for (int sample_index = 0; sample_index < sample_id_count; ++sample_index)
 				{
-					// We are reading a SLiM-generated VCF file that uses NONNUC to designate non-nucleotide-based mutations
-					if (info_is_nonnuc)
+					if (iss.eof())
+						EIDOS_TERMINATION << "ERROR (Genome_Class::ExecuteMethod_readFromVCF): VCF file call line ended unexpectedly before the last sample." << EidosTerminate();
+					
+					std::getline(iss, sub, '\t');
+					
+					// extract just the GT field if others are present
+					std::size_t colon_pos = sub.find_first_of(':');
+					
+					if (colon_pos != std::string::npos)
+						sub = sub.substr(0, colon_pos);
+					
+					// separate haploid calls that are joined by | or /; this is the hotspot of the whole method, so we try to be efficient here
+					bool call_handled = false;
+					
+					if ((sub.length() == 3) && ((sub[1] == '|') || (sub[1] == '/')))
 					{
-						// This call line is marked NONNUC, so there is no associated nucleotide; check against the mutation type
-						if (mutation_type_ptr->nucleotide_based_)
-							EIDOS_TERMINATION << "ERROR (Genome_Class::ExecuteMethod_readFromVCF): a mutation marked NONNUC cannot use a nucleotide-based mutation type." << EidosTerminate();
+						// diploid, both single-digit
+						char sub_ch1 = sub[0];
+						char sub_ch2 = sub[2];
+						
+						if ((sub_ch1 >= '0') && (sub_ch1 <= '9') && (sub_ch2 >= '0') && (sub_ch2 <= '9'))
+						{
+							int genotype_call1 = (int)(sub_ch1 - '0');
+							int genotype_call2 = (int)(sub_ch2 - '0');
+							
+							if ((genotype_call1 < 0) || (genotype_call1 > (int)alt_allele_count) || (genotype_call2 < 0) || (genotype_call2 > (int)alt_allele_count))	// 0 is REF, 1..n are ALT alleles
+								EIDOS_TERMINATION << "ERROR (Genome_Class::ExecuteMethod_readFromVCF): VCF file call out of range (does not correspond to a REF or ALT allele in the call line)." << EidosTerminate();
+							
+							genotype_calls.emplace_back(genotype_call1);
+							genotype_calls.emplace_back(genotype_call2);
+							call_handled = true;
+						}
+					}
+					else if (sub.length() == 1)
+					{
+						// haploid, single-digit
+						char sub_ch = sub[0];
 						
-						nucleotide = -1;
+						if ((sub_ch >= '0') && (sub_ch <= '9'))
+						{
+							int genotype_call = (int)(sub_ch - '0');
+							
+							if ((genotype_call < 0) || (genotype_call > (int)alt_allele_count))	// 0 is REF, 1..n are ALT alleles
+								EIDOS_TERMINATION << "ERROR (Genome_Class::ExecuteMethod_readFromVCF): VCF file call out of range (does not correspond to a REF or ALT allele in the call line)." << EidosTerminate();
+							
+							genotype_calls.emplace_back(genotype_call);
+							call_handled = true;
+						}
 					}
-					else
+					
+					if (!call_handled)
 					{
-						// This call line is not marked NONNUC, so it represents nucleotide-based alleles
-						if (!mutation_type_ptr->nucleotide_based_)
-							EIDOS_TERMINATION << "ERROR (Genome_Class::ExecuteMethod_readFromVCF): a nucleotide-based mutation cannot use a non-nucleotide-based mutation type." << EidosTerminate();
-						if (ref_nuc != info_ancestral_nuc)
-							EIDOS_TERMINATION << "ERROR (Genome_Class::ExecuteMethod_readFromVCF): the REF nucleotide does not match the AA nucleotide." << EidosTerminate();
+						std::vector<std::string> genotype_substrs;
 						
-						int8_t ancestral = (int8_t)species->TheChromosome().AncestralSequence()->NucleotideAtIndex(mut_position);
+						if (sub.find('|') != std::string::npos)
+							genotype_substrs = Eidos_string_split(sub, "|");	// phased
+						else if (sub.find('/') != std::string::npos)
+							genotype_substrs = Eidos_string_split(sub, "/");	// unphased; we don't worry about that
+						else
+							genotype_substrs.emplace_back(sub);					// haploid, presumably
 						
-						if (ancestral != ref_nuc)
-							EIDOS_TERMINATION << "ERROR (Genome_Class::ExecuteMethod_readFromVCF): the REF/AA nucleotide does not match the ancestral nucleotide at the same position; a matching ancestral nucleotide sequence must be set prior to calling readFromVCF()." << EidosTerminate();
+						if ((genotype_substrs.size() < 1) || (genotype_substrs.size() > 2))
+							EIDOS_TERMINATION << "ERROR (Genome_Class::ExecuteMethod_readFromVCF): VCF file genotype calls must be diploid or haploid; " << genotype_substrs.size() << " calls found in one sample." << EidosTerminate();
 						
-						nucleotide = alt_allele_nuc;
+						// extract the calls' integer values, validate them, and keep them; we don't care which call was in which sample, we just preserve their order
+						for (std::string &genotype_substr : genotype_substrs)
+						{
+							std::size_t genotype_call = EidosInterpreter::NonnegativeIntegerForString(genotype_substr, nullptr);
+							
+							if (/*(genotype_call < 0) ||*/ (genotype_call > alt_allele_count))	// 0 is REF, 1..n are ALT alleles
+								EIDOS_TERMINATION << "ERROR (Genome_Class::ExecuteMethod_readFromVCF): VCF file call out of range (does not correspond to a REF or ALT allele in the call line)." << EidosTerminate();
+							
+							genotype_calls.emplace_back((int)genotype_call);
+						}
 					}
 				}
+				
+				if (!iss.eof())
+					EIDOS_TERMINATION << "ERROR (Genome_Class::ExecuteMethod_readFromVCF): VCF file call line has unexpected entries following the last sample." << EidosTerminate();
+				if ((int)genotype_calls.size() != target_size)
+					EIDOS_TERMINATION << "ERROR (Genome_Class::ExecuteMethod_readFromVCF): target genome vector has size " << target_size << " but " << genotype_calls.size() << " calls were found in one call line." << EidosTerminate();
+				
+				genotype_scan.nonref_calls_.clear();
+				
+				for (int genome_index = 0; genome_index < target_size; ++genome_index)
+					if (genotype_calls[genome_index] != 0)
+						genotype_scan.nonref_calls_.emplace_back(genome_index, genotype_calls[genome_index]);
+			}
+			
+			// instantiate the mutations involved in this call line; the REF allele represents no mutation, ALT alleles are each separate mutations
+			std::vector<MutationIndex> alt_allele_mut_indices;
+			
+			for (std::size_t alt_allele_index = 0; alt_allele_index < alt_allele_count; ++alt_allele_index)
+			{
+				// figure out the mutation type; if specified with MT, look it up, otherwise use the default supplied
+				MutationType *mutation_type_ptr = default_mutation_type_ptr;
+				
+				if (info_muttype.size() > 0)
+				{
+					slim_objectid_t mutation_type_id = info_muttype[alt_allele_index];
+	                
+	                mutation_type_ptr = species->MutationTypeWithID(mutation_type_id);
+					
+					if (!mutation_type_ptr)
+						EIDOS_TERMINATION << "ERROR (Genome_Class::ExecuteMethod_readFromVCF): VCF file MT field references a mutation type m" << mutation_type_id << " that is not defined." << EidosTerminate();
+				}
+				
+				if (!mutation_type_ptr)
+					EIDOS_TERMINATION << "ERROR (Genome_Class::ExecuteMethod_readFromVCF): VCF file MT field missing, but no default mutation type was supplied in the mutationType parameter." << EidosTerminate();
+				
+				// check the dominance coefficient of DOM against that of the mutation type
+				if (info_domcoeffs.size() > 0)
+				{
+					if (std::abs(info_domcoeffs[alt_allele_index] - mutation_type_ptr->dominance_coeff_) > 0.0001)
+						EIDOS_TERMINATION << "ERROR (Genome_Class::ExecuteMethod_readFromVCF): VCF file DOM field specifies a dominance coefficient " << info_domcoeffs[alt_allele_index] << " that differs from the mutation type's dominance coefficient of " << mutation_type_ptr->dominance_coeff_ << "." << EidosTerminate();
+				}
+				
+				// get the selection coefficient from S, or draw one
+				double selection_coeff;
+				
+				if (info_selcoeffs.size() > 0)
+					selection_coeff = info_selcoeffs[alt_allele_index];
+				else
+					selection_coeff = mutation_type_ptr->DrawSelectionCoefficient();
+				
+				// get the subpop index from PO, or set to -1; no bounds checking on this
+				slim_objectid_t subpop_index = -1;
+				
+				if (info_poporigin.size() > 0)
+					subpop_index = info_poporigin[alt_allele_index];
+				
+				// get the origin tick from gO, or set to the current tick; no bounds checking on this
+				slim_tick_t origin_tick;
+				
+				if (info_tickorigin.size() > 0)
+					origin_tick = info_tickorigin[alt_allele_index];
 				else
+					origin_tick = community.Tick();
+				
+				// figure out the nucleotide and do nucleotide-related checks
+				int8_t alt_allele_nuc = alt_nucs[alt_allele_index];		// must be defined, in all cases, but might be ignored
+				int8_t nucleotide;
+				
+				if (nucleotide_based)
 				{
-					// We are reading a generic VCF file that does not use NONNUC, so we follow the mutation type's lead; if it is nucleotide-based, we use the nucleotide specified
-					if (mutation_type_ptr->nucleotide_based_)
+					if (info_NONNUC_defined)
 					{
-						// The mutation type is nucleotide-based, so use the nucleotide specified; in this case we ignore REF and AA, however
-						nucleotide = alt_allele_nuc;
+						// We are reading a SLiM-generated VCF file that uses NONNUC to designate non-nucleotide-based mutations
+						if (info_is_nonnuc)
+						{
+							// This call line is marked NONNUC, so there is no associated nucleotide; check against the mutation type
+							if (mutation_type_ptr->nucleotide_based_)
+								EIDOS_TERMINATION << "ERROR (Genome_Class::ExecuteMethod_readFromVCF): a mutation marked NONNUC cannot use a nucleotide-based mutation type." << EidosTerminate();
+							
+							nucleotide = -1;
+						}
+						else
+						{
+							// This call line is not marked NONNUC, so it represents nucleotide-based alleles
+							if (!mutation_type_ptr->nucleotide_based_)
+								EIDOS_TERMINATION << "ERROR (Genome_Class::ExecuteMethod_readFromVCF): a nucleotide-based mutation cannot use a non-nucleotide-based mutation type." << EidosTerminate();
+							if (ref_nuc != info_ancestral_nuc)
+								EIDOS_TERMINATION << "ERROR (Genome_Class::ExecuteMethod_readFromVCF): the REF nucleotide does not match the AA nucleotide." << EidosTerminate();
+							
+							int8_t ancestral = (int8_t)species->TheChromosome().AncestralSequence()->NucleotideAtIndex(mut_position);
+							
+							if (ancestral != ref_nuc)
+								EIDOS_TERMINATION << "ERROR (Genome_Class::ExecuteMethod_readFromVCF): the REF/AA nucleotide does not match the ancestral nucleotide at the same position; a matching ancestral nucleotide sequence must be set prior to calling readFromVCF()." << EidosTerminate();
+							
+							nucleotide = alt_allele_nuc;
+						}
 					}
 					else
 					{
-						// The mutation type is non-nucleotide-based, so we ignore the nucleotide supplied, as well as REF/AA
-						nucleotide = -1;
+						// We are reading a generic VCF file that does not use NONNUC, so we follow the mutation type's lead; if it is nucleotide-based, we use the nucleotide specified
+						if (mutation_type_ptr->nucleotide_based_)
+						{
+							// The mutation type is nucleotide-based, so use the nucleotide specified; in this case we ignore REF and AA, however
+							nucleotide = alt_allele_nuc;
+						}
+						else
+						{
+							// The mutation type is non-nucleotide-based, so we ignore the nucleotide supplied, as well as REF/AA
+							nucleotide = -1;
+						}
 					}
 				}
-			}
-			else
-			{
-				// We are a non-nucleotide-based model, so NONNUC should not be defined; we do not understand nucleotides and will ignore them
-				if (info_NONNUC_defined)
-					EIDOS_TERMINATION << "ERROR (Genome_Class::ExecuteMethod_readFromVCF): cannot read a VCF file generated by a nucleotide-based model into a non-nucleotide-based model." << EidosTerminate();
+				else
+				{
+					// We are a non-nucleotide-based model, so NONNUC should not be defined; we do not understand nucleotides and will ignore them
+					if (info_NONNUC_defined)
+						EIDOS_TERMINATION << "ERROR (Genome_Class::ExecuteMethod_readFromVCF): cannot read a VCF file generated by a nucleotide-based model into a non-nucleotide-based model." << EidosTerminate();
+					
+					nucleotide = -1;
+				}
 				
-				nucleotide = -1;
-			}
-			
-			// instantiate the mutation with the values decided upon
-			MutationIndex new_mut_index = SLiM_NewMutationFromBlock();
-			Mutation *new_mut;
-			
-			if (info_mutids.size() > 0)
-			{
-				// a mutation ID was supplied; we use it blindly, having checked above that we are in the case where this is legal
-				slim_mutationid_t mut_mutid = info_mutids[alt_allele_index];
+				// instantiate the mutation with the values decided upon
+				MutationIndex new_mut_index = SLiM_NewMutationFromBlock();
+				Mutation *new_mut;
 				
-				new_mut = new (gSLiM_Mutation_Block + new_mut_index) Mutation(mut_mutid, mutation_type_ptr, mut_position, selection_coeff, subpop_index, origin_tick, nucleotide);
-			}
-			else
-			{
-				// no mutation ID supplied, so use whatever is next
-				new_mut = new (gSLiM_Mutation_Block + new_mut_index) Mutation(mutation_type_ptr, mut_position, selection_coeff, subpop_index, origin_tick, nucleotide);
-			}
-			
-			// This mutation type might not be used by any genomic element type (i.e. might not already be vetted), so we need to check and set pure_neutral_
-			if (selection_coeff != 0.0)
-			{
-				species->pure_neutral_ = false;
+				if (info_mutids.size() > 0)
+				{
+					// a mutation ID was supplied; we use it blindly, having checked above that we are in the case where this is legal
+					slim_mutationid_t mut_mutid = info_mutids[alt_allele_index];
+					
+					new_mut = new (gSLiM_Mutation_Block + new_mut_index) Mutation(mut_mutid, mutation_type_ptr, mut_position, selection_coeff, subpop_index, origin_tick, nucleotide);
+				}
+				else
+				{
+					// no mutation ID supplied, so use whatever is next
+					new_mut = new (gSLiM_Mutation_Block + new_mut_index) Mutation(mutation_type_ptr, mut_position, selection_coeff, subpop_index, origin_tick, nucleotide);
+				}
+				
+				// This mutation type might not be used by any genomic element type (i.e. might not already be vetted), so we need to check and set pure_neutral_
+				if (selection_coeff != 0.0)
+				{
+					species->pure_neutral_ = false;
+					
+					// Fix all_pure_neutral_DFE_ if the selcoeff was not drawn from the muttype's DFE
+					if (p_method_id == gID_addNewMutation)
+						mutation_type_ptr->all_pure_neutral_DFE_ = false;
+				}
 				
-				// Fix all_pure_neutral_DFE_ if the selcoeff was not drawn from the muttype's DFE
-				if (p_method_id == gID_addNewMutation)
-					mutation_type_ptr->all_pure_neutral_DFE_ = false;
+				// add it to our local map, so we can find it when making genomes, and to the population's mutation registry
+				pop.MutationRegistryAdd(new_mut);
+				alt_allele_mut_indices.emplace_back(new_mut_index);
+				mutation_indices.emplace_back(new_mut_index);
 			}
 			
-			// add it to our local map, so we can find it when making genomes, and to the population's mutation registry
-			pop.MutationRegistryAdd(new_mut);
-			alt_allele_mut_indices.emplace_back(new_mut_index);
-			mutation_indices.emplace_back(new_mut_index);
-		}
-		
-		// add the mutations to the appropriate genomes and record the new derived states
-		for (int genome_index = 0; genome_index < target_size; ++genome_index)
-		{
-			int call = genotype_calls[genome_index];
-			
-			if (call != 0)
+			// add the mutations to the appropriate genomes and record the new derived states
+			for (const std::pair<int, int> &nonref_call : genotype_scan.nonref_calls_)
 			{
+				int genome_index = nonref_call.first;
+				int call = nonref_call.second;
 				Genome *genome = targets[genome_index];
 				slim_mutrun_index_t &genome_last_mutrun_modified = target_last_mutrun_modified[genome_index];
 				MutationRun *&genome_last_mutrun = target_last_mutrun[genome_index];
@@ -3811,6 +4350,8 @@ EidosValue_SP Genome_Class::ExecuteMethod_readFromVCF(EidosGlobalStringID p_meth
 					species->RecordNewDerivedState(genome, mut_position, *genome->derived_mutation_ids_at_position(mut_position));
 			}
 		}
+		
+		chunk_start = chunk_end;
 	}
 	
 	// Return the instantiated mutations
@@ -59,6 +59,8 @@ class Population;
 class Subpopulation;
 class Individual;
 class GenomeWalker;
+class GenomeSampleTally;
+class GenomeHaplotypeMatrix;
 
 
 extern EidosClass *gSLiM_Genome_Class;
@@ -99,6 +101,8 @@ class Genome : public EidosObject
 	
 private:
 	typedef EidosObject super;
+	
+	friend class SLiMCheckpoint;				// reads and writes private state for checkpointing
 
 private:
 	EidosValue_SP self_value_;										// cached EidosValue object for speed
@@ -367,6 +371,9 @@ public:
 	// print the sample represented by genomes, using "ms" format
 	static void PrintGenomes_MS(std::ostream &p_out, std::vector<Genome *> &p_genomes, const Chromosome &p_chromosome, bool p_filter_monomorphic);
 	
+	// write the sample represented by genomes as a binary haplotype matrix, with positions; see GenomeHaplotypeMatrix
+	static void WriteGenomes_Haplotypes(std::ostream &p_out, std::vector<Genome *> &p_genomes, const Chromosome &p_chromosome, bool p_filter_monomorphic);
+	
 	// print the sample represented by genomes, using "vcf" format
 	static void PrintGenomes_VCF(std::ostream &p_out, std::vector<Genome *> &p_genomes, bool p_output_multiallelics, bool p_simplify_nucs, bool p_output_nonnucs, bool p_nucleotide_based, NucleotideArray *p_ancestral_seq);
 	
@@ -416,6 +423,8 @@ public:
 	friend Subpopulation;
 	friend Individual;
 	friend GenomeWalker;
+	friend GenomeSampleTally;
+	friend GenomeHaplotypeMatrix;
 };
 
 class Genome_Class : public EidosClass
@@ -436,6 +445,7 @@ public:
 	EidosValue_SP ExecuteMethod_addNewMutation(EidosGlobalStringID p_method_id, EidosValue_Object *p_target, const std::vector<EidosValue_SP> &p_arguments, EidosInterpreter &p_interpreter) const;
 	EidosValue_SP ExecuteMethod_mutationFreqsCountsInGenomes(EidosGlobalStringID p_method_id, EidosValue_Object *p_target, const std::vector<EidosValue_SP> &p_arguments, EidosInterpreter &p_interpreter) const;
 	EidosValue_SP ExecuteMethod_outputX(EidosGlobalStringID p_method_id, EidosValue_Object *p_target, const std::vector<EidosValue_SP> &p_arguments, EidosInterpreter &p_interpreter) const;
+	EidosValue_SP ExecuteMethod_outputHaplotypes(EidosGlobalStringID p_method_id, EidosValue_Object *p_target, const std::vector<EidosValue_SP> &p_arguments, EidosInterpreter &p_interpreter) const;
 	EidosValue_SP ExecuteMethod_readFromMS(EidosGlobalStringID p_method_id, EidosValue_Object *p_target, const std::vector<EidosValue_SP> &p_arguments, EidosInterpreter &p_interpreter) const;
 	EidosValue_SP ExecuteMethod_readFromVCF(EidosGlobalStringID p_method_id, EidosValue_Object *p_target, const std::vector<EidosValue_SP> &p_arguments, EidosInterpreter &p_interpreter) const;
 	EidosValue_SP ExecuteMethod_removeMutations(EidosGlobalStringID p_method_id, EidosValue_Object *p_target, const std::vector<EidosValue_SP> &p_arguments, EidosInterpreter &p_interpreter) const;
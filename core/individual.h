@@ -69,6 +69,8 @@ class Individual : public EidosDictionaryUnretained
 	
 private:
 	typedef EidosDictionaryUnretained super;
+	
+	friend class SLiMCheckpoint;				// reads and writes private state for checkpointing
 
 #ifdef SLIMGUI
 public:
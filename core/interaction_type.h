@@ -159,6 +159,8 @@ class InteractionType : public EidosDictionaryUnretained
 	
 private:
 	typedef EidosDictionaryUnretained super;
+	
+	friend class SLiMCheckpoint;				// reads and writes private state for checkpointing
 
 	static void _WarmUp(void);					// called internally at startup, do not call
 	friend InteractionType_Class;				// so it can call _WarmUp() for us
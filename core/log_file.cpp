@@ -24,6 +24,8 @@
 #include <algorithm>
 #include <vector>
 #include <iomanip>
+#include <fstream>
+#include <cstring>
 
 #include "slim_globals.h"
 #include "community.h"
@@ -44,6 +46,9 @@ LogFile::LogFile(Community &p_community) : community_(p_community)
 
 LogFile::~LogFile(void)
 {
+	// Write out any rows still buffered for the binary format; we can't raise here, so failure is silent
+	if (binary_ && (binary_row_count_ > 0))
+		_WriteBinaryRowGroup();
 }
 
 void LogFile::Raise_UsesStringKeys(void) const
@@ -51,8 +56,48 @@ void LogFile::Raise_UsesStringKeys(void) const
 	EIDOS_TERMINATION << "ERROR (LogFile::Raise_UsesStringKeys): cannot use an integer key with the target LogFile object; LogFile always uses string keys." << EidosTerminate(nullptr);
 }
 
-void LogFile::ConfigureFile(const std::string &p_filePath, std::vector<const std::string *> &p_initialContents, bool p_append, bool p_compress, const std::string &p_sep)
+// The binary format begins with a header: the magic bytes "SLiMLogB", a uint32_t format version, and the separator string
+// (a uint32_t length followed by its bytes), which is the default separator for conversion.  Records follow, each consisting
+// of a uint32_t record type, a uint64_t payload length, and the payload; all values are in native (little-endian) byte order.
+// A record of type kBinaryRecord_Contents holds initial contents lines, each terminated by a newline.  A record of type
+// kBinaryRecord_RowGroup holds a group of rows in columnar form; see LogFile::_WriteBinaryRowGroup().  Since each record
+// is self-describing and written in a single append, a reader can consume a file incrementally, even while it is being
+// written, and can stop cleanly at a truncated final record.
+static const char gSLiM_BinaryLogMagic[8] = {'S', 'L', 'i', 'M', 'L', 'o', 'g', 'B'};
+static const uint32_t gSLiM_BinaryLogVersion = 1;
+static const uint32_t kBinaryRecord_Contents = 1;
+static const uint32_t kBinaryRecord_RowGroup = 2;
+
+// Without an explicit flushInterval, binary rows are buffered until roughly this many bytes have accumulated
+#define SLIM_BINARY_LOG_ROW_GROUP_BYTES		(128 * 1024)
+
+template <typename T>
+static inline void _AppendBinary(std::string &p_buffer, T p_value)
 {
+	p_buffer.append((const char *)&p_value, sizeof(T));
+}
+
+static inline void _AppendBinaryString(std::string &p_buffer, const std::string &p_string)
+{
+	_AppendBinary(p_buffer, (uint32_t)p_string.size());
+	p_buffer.append(p_string);
+}
+
+static void _AppendBinaryRecord(std::string &p_buffer, uint32_t p_record_type, const std::string &p_payload)
+{
+	_AppendBinary(p_buffer, p_record_type);
+	_AppendBinary(p_buffer, (uint64_t)p_payload.size());
+	p_buffer.append(p_payload);
+}
+
+void LogFile::ConfigureFile(const std::string &p_filePath, std::vector<const std::string *> &p_initialContents, bool p_append, bool p_compress, const std::string &p_sep, bool p_binary)
+{
+	if (p_binary && p_compress)
+		EIDOS_TERMINATION << "ERROR (LogFile::ConfigureFile): the binary log file format does not support compression." << EidosTerminate();
+	
+	// Any rows buffered for the binary format belong to the file we were previously writing to
+	WriteBinaryRowGroup();
+	
 	user_file_path_ = p_filePath;
 	
 	// correct the user-visible path to end in ".gz" if it doesn't already
@@ -63,8 +108,59 @@ void LogFile::ConfigureFile(const std::string &p_filePath, std::vector<const std
 	resolved_file_path_ = Eidos_AbsolutePath(user_file_path_);
 	
 	compress_ = p_compress;
+	binary_ = p_binary;
 	sep_ = p_sep;
 	
+	if (binary_)
+	{
+		// When appending to an existing binary log, we check its header and continue after it; otherwise we write a new header
+		bool write_header = true;
+		
+		if (p_append)
+		{
+			std::ifstream existing_file(resolved_file_path_, std::ios_base::in | std::ios_base::binary);
+			
+			if (existing_file.is_open() && (existing_file.peek() != std::ifstream::traits_type::eof()))
+			{
+				char magic[sizeof(gSLiM_BinaryLogMagic)];
+				
+				if (!existing_file.read(magic, sizeof(magic)) || (memcmp(magic, gSLiM_BinaryLogMagic, sizeof(magic)) != 0))
+					EIDOS_TERMINATION << "ERROR (LogFile::ConfigureFile): cannot append binary log data to " << user_file_path_ << " because it is not a binary log file." << EidosTerminate();
+				
+				write_header = false;
+			}
+		}
+		
+		std::string buffer;
+		
+		if (write_header)
+		{
+			buffer.append(gSLiM_BinaryLogMagic, sizeof(gSLiM_BinaryLogMagic));
+			_AppendBinary(buffer, gSLiM_BinaryLogVersion);
+			_AppendBinaryString(buffer, sep_);
+		}
+		
+		if (p_initialContents.size())
+		{
+			std::string contents;
+			
+			for (const std::string *line : p_initialContents)
+			{
+				contents.append(*line);
+				contents.append(1, '\n');
+			}
+			
+			_AppendBinaryRecord(buffer, kBinaryRecord_Contents, contents);
+		}
+		
+		std::ofstream file_stream(resolved_file_path_, (p_append ? std::ios_base::app : std::ios_base::trunc) | std::ios_base::out | std::ios_base::binary);
+		
+		if (!file_stream.is_open() || !file_stream.write(buffer.data(), buffer.size()))
+			EIDOS_TERMINATION << "ERROR (LogFile::ConfigureFile): could not write to file at path " << user_file_path_ << "." << EidosTerminate();
+		
+		return;
+	}
+	
 	// We always open the file for writing (or appending) synchronously and write out the initial contents, if any
 	Eidos_WriteToFile(resolved_file_path_, p_initialContents, p_append, p_compress, EidosFileFlush::kForceFlush);
 }
@@ -312,6 +408,167 @@ void LogFile::_OutputValue(std::ostringstream &p_out, EidosValue *p_value)
 	}
 }
 
+uint32_t LogFile::_BinaryStringIndex(LogFileBinaryColumn &p_column, const std::string &p_string)
+{
+	auto lookup_iter = p_column.string_lookup_.find(p_string);
+	
+	if (lookup_iter != p_column.string_lookup_.end())
+		return lookup_iter->second;
+	
+	uint32_t string_index = (uint32_t)p_column.string_dictionary_.size();
+	
+	p_column.string_dictionary_.emplace_back(p_string);
+	p_column.string_lookup_.emplace(p_string, string_index);
+	binary_buffered_bytes_ += p_string.size() + 4;
+	
+	return string_index;
+}
+
+// The text for a non-NA integer/float/logical value, as the text format would write it
+static std::string _TextForBinaryValue(LogFileColumnType p_type, int64_t p_int_value, double p_float_value, int p_float_precision)
+{
+	if (p_type == LogFileColumnType::kInt64)
+		return std::to_string(p_int_value);
+	if (p_type == LogFileColumnType::kLogical)
+		return (p_int_value ? gEidosStr_T : gEidosStr_F);
+	
+	// Note that this is not thread-safe, like LogFile::_OutputValue()
+	int old_precision = gEidosFloatOutputPrecision;
+	gEidosFloatOutputPrecision = p_float_precision;
+	
+	std::string text = EidosStringForFloat(p_float_value);
+	
+	gEidosFloatOutputPrecision = old_precision;
+	
+	return text;
+}
+
+void LogFile::_ConvertBinaryColumnToString(LogFileBinaryColumn &p_column)
+{
+	// A column whose values change type within a row group becomes a string column; the text of each value is what
+	// the text format would have written, so conversion of the binary format to text gives the same result
+	size_t row_count = p_column.null_flags_.size();
+	LogFileColumnType old_type = p_column.type_;
+	
+	p_column.type_ = LogFileColumnType::kString;
+	p_column.string_indices_.resize(row_count);
+	
+	for (size_t row_index = 0; row_index < row_count; ++row_index)
+	{
+		if (p_column.null_flags_[row_index])
+			p_column.string_indices_[row_index] = _BinaryStringIndex(p_column, "NA");
+		else if (old_type == LogFileColumnType::kFloat64)
+			p_column.string_indices_[row_index] = _BinaryStringIndex(p_column, _TextForBinaryValue(old_type, 0, p_column.float_values_[row_index], float_precision_));
+		else
+			p_column.string_indices_[row_index] = _BinaryStringIndex(p_column, _TextForBinaryValue(old_type, p_column.int_values_[row_index], 0.0, float_precision_));
+	}
+	
+	p_column.int_values_.clear();
+	p_column.float_values_.clear();
+}
+
+void LogFile::_BufferBinaryValue(LogFileBinaryColumn &p_column, EidosValue *p_value)
+{
+	EidosValueType type = p_value->Type();
+	size_t row_index = p_column.null_flags_.size();
+	
+	binary_buffered_bytes_ += 9;
+	
+	if (type == EidosValueType::kValueNULL)
+	{
+		// NULL gets logged as NA; the column gets a placeholder value of its present type, to keep rows aligned
+		p_column.null_flags_.emplace_back(1);
+		p_column.has_nulls_ = true;
+		
+		switch (p_column.type_)
+		{
+			case LogFileColumnType::kNone:																break;
+			case LogFileColumnType::kInt64:
+			case LogFileColumnType::kLogical:	p_column.int_values_.emplace_back(0);					break;
+			case LogFileColumnType::kFloat64:	p_column.float_values_.emplace_back(0.0);				break;
+			case LogFileColumnType::kString:	p_column.string_indices_.emplace_back(_BinaryStringIndex(p_column, "NA"));	break;
+		}
+		return;
+	}
+	
+	LogFileColumnType value_type = LogFileColumnType::kString;
+	
+	if (p_value->Count() == 1)
+	{
+		if (type == EidosValueType::kValueInt)
+			value_type = LogFileColumnType::kInt64;
+		else if (type == EidosValueType::kValueFloat)
+			value_type = LogFileColumnType::kFloat64;
+		else if (type == EidosValueType::kValueLogical)
+			value_type = LogFileColumnType::kLogical;
+	}
+	
+	if (p_column.type_ == LogFileColumnType::kNone)
+	{
+		// The first non-NA value in a row group sets the column type; any preceding NA rows get placeholders
+		p_column.type_ = value_type;
+		
+		switch (value_type)
+		{
+			case LogFileColumnType::kNone:																break;
+			case LogFileColumnType::kInt64:
+			case LogFileColumnType::kLogical:	p_column.int_values_.resize(row_index, 0);				break;
+			case LogFileColumnType::kFloat64:	p_column.float_values_.resize(row_index, 0.0);			break;
+			case LogFileColumnType::kString:	p_column.string_indices_.resize(row_index, row_index ? _BinaryStringIndex(p_column, "NA") : 0);	break;
+		}
+	}
+	else if ((p_column.type_ != value_type) && (p_column.type_ != LogFileColumnType::kString))
+	{
+		_ConvertBinaryColumnToString(p_column);
+	}
+	
+	p_column.null_flags_.emplace_back(0);
+	
+	switch (p_column.type_)
+	{
+		case LogFileColumnType::kNone:		break;
+		case LogFileColumnType::kInt64:		p_column.int_values_.emplace_back(p_value->IntAtIndex_NOCAST(0, nullptr));				break;
+		case LogFileColumnType::kLogical:	p_column.int_values_.emplace_back(p_value->LogicalAtIndex_NOCAST(0, nullptr) ? 1 : 0);	break;
+		case LogFileColumnType::kFloat64:	p_column.float_values_.emplace_back(p_value->FloatAtIndex_NOCAST(0, nullptr));			break;
+		case LogFileColumnType::kString:
+		{
+			if (value_type == LogFileColumnType::kString)
+			{
+				if ((type == EidosValueType::kValueString) && (p_value->Count() == 1))
+				{
+					// this matches EidosValue_String::PrintValueAtIndex(), without the overhead of a stream
+					const std::string &string_value = ((EidosValue_String *)p_value)->StringRefAtIndex_NOCAST(0, nullptr);
+					
+					p_column.string_indices_.emplace_back(_BinaryStringIndex(p_column, Eidos_string_escaped(string_value, EidosStringQuoting::kChooseQuotes)));
+				}
+				else
+				{
+					std::ostringstream ss;
+					
+					_OutputValue(ss, p_value);
+					p_column.string_indices_.emplace_back(_BinaryStringIndex(p_column, ss.str()));
+				}
+			}
+			else
+			{
+				// a singleton integer/float/logical logged to a column that has become a string column
+				int64_t int_value = 0;
+				double float_value = 0.0;
+				
+				if (value_type == LogFileColumnType::kInt64)
+					int_value = p_value->IntAtIndex_NOCAST(0, nullptr);
+				else if (value_type == LogFileColumnType::kLogical)
+					int_value = (p_value->LogicalAtIndex_NOCAST(0, nullptr) ? 1 : 0);
+				else
+					float_value = p_value->FloatAtIndex_NOCAST(0, nullptr);
+				
+				p_column.string_indices_.emplace_back(_BinaryStringIndex(p_column, _TextForBinaryValue(value_type, int_value, float_value, float_precision_)));
+			}
+			break;
+		}
+	}
+}
+
 void LogFile::AppendNewRow(void)
 {
 	THREAD_SAFETY_IN_ACTIVE_PARALLEL("LogFile::AppendNewRow(): filesystem write");
@@ -347,8 +604,13 @@ void LogFile::AppendNewRow(void)
 #endif
 		}
 		
-		header_line = ss.str();
-		line_vec.emplace_back(&header_line);
+		if (binary_)
+			binary_columns_.resize(column_names_.size());		// column names are written with each row group instead
+		else
+		{
+			header_line = ss.str();
+			line_vec.emplace_back(&header_line);
+		}
 		
 #ifdef SLIMGUI
 		emitted_lines_.emplace_back(std::move(gui_line));
@@ -405,10 +667,15 @@ void LogFile::AppendNewRow(void)
 					_GeneratedValues_CustomMeanAndSD(generator, &generated_value_1, &generated_value_2);
 					
 					// emit generated_value_1
-					if (column_index != 0)
-						ss << sep_;
-					
-					_OutputValue(ss, generated_value_1.get());
+					if (binary_)
+						_BufferBinaryValue(binary_columns_[column_index], generated_value_1.get());
+					else
+					{
+						if (column_index != 0)
+							ss << sep_;
+						
+						_OutputValue(ss, generated_value_1.get());
+					}
 					
 #ifdef SLIMGUI
 					std::ostringstream gui_ss;
@@ -432,10 +699,15 @@ void LogFile::AppendNewRow(void)
 			}
 			
 			// Emit the generated value and add it to our Dictionary state
-			if (column_index != 0)
-				ss << sep_;
-			
-			_OutputValue(ss, generated_value.get());
+			if (binary_)
+				_BufferBinaryValue(binary_columns_[column_index], generated_value.get());
+			else
+			{
+				if (column_index != 0)
+					ss << sep_;
+				
+				_OutputValue(ss, generated_value.get());
+			}
 			
 #ifdef SLIMGUI
 			std::ostringstream gui_ss;
@@ -461,6 +733,27 @@ void LogFile::AppendNewRow(void)
 	
 	ContentsChanged("LogFile::AppendNewRow()");
 	
+	if (binary_)
+	{
+		// For the binary format, rows are buffered and written out as a row group, either after flushInterval rows or,
+		// by default, once enough data has accumulated for the write to be efficient
+		binary_row_count_++;
+		
+		if (explicit_flushing_)
+		{
+			unflushed_row_count_++;
+			
+			if (unflushed_row_count_ >= flush_interval_)
+				WriteBinaryRowGroup();
+		}
+		else if (binary_buffered_bytes_ >= SLIM_BINARY_LOG_ROW_GROUP_BYTES)
+		{
+			WriteBinaryRowGroup();
+		}
+		
+		return;
+	}
+	
 	// Write out the row
 	EidosFileFlush flush = EidosFileFlush::kDefaultFlush;
 	
@@ -493,6 +786,311 @@ void LogFile::TickEndCallout(void)
 	}
 }
 
+bool LogFile::_WriteBinaryRowGroup(void)
+{
+	// A row group record's payload is: a uint32_t column count, a uint64_t row count, and an int32_t float precision; then
+	// for each column, its name (a uint32_t length followed by its bytes), a uint8_t LogFileColumnType, a uint8_t flag that
+	// is 1 if the column contains NAs, the NA flags (one uint8_t per row, 1 for NA) if so, and then the column data:
+	// int64_t values for kInt64, double values for kFloat64, uint8_t values for kLogical, and for kString a uint32_t
+	// dictionary size, the dictionary strings, and uint32_t dictionary indices.  A kNone column (all NA) has no data.
+	std::string payload;
+	uint64_t row_count = (uint64_t)binary_row_count_;
+	
+	payload.reserve(binary_buffered_bytes_ + 1024);
+	
+	_AppendBinary(payload, (uint32_t)binary_columns_.size());
+	_AppendBinary(payload, row_count);
+	_AppendBinary(payload, (int32_t)float_precision_);
+	
+	for (size_t column_index = 0; column_index < binary_columns_.size(); ++column_index)
+	{
+		LogFileBinaryColumn &column = binary_columns_[column_index];
+		
+		_AppendBinaryString(payload, column_names_[column_index]);
+		_AppendBinary(payload, (uint8_t)column.type_);
+		_AppendBinary(payload, (uint8_t)(column.has_nulls_ ? 1 : 0));
+		
+		if (column.has_nulls_)
+			payload.append((const char *)column.null_flags_.data(), column.null_flags_.size());
+		
+		switch (column.type_)
+		{
+			case LogFileColumnType::kNone:
+				break;
+			case LogFileColumnType::kInt64:
+				payload.append((const char *)column.int_values_.data(), column.int_values_.size() * sizeof(int64_t));
+				break;
+			case LogFileColumnType::kFloat64:
+				payload.append((const char *)column.float_values_.data(), column.float_values_.size() * sizeof(double));
+				break;
+			case LogFileColumnType::kLogical:
+				for (int64_t value : column.int_values_)
+					_AppendBinary(payload, (uint8_t)value);
+				break;
+			case LogFileColumnType::kString:
+				_AppendBinary(payload, (uint32_t)column.string_dictionary_.size());
+				for (const std::string &dictionary_string : column.string_dictionary_)
+					_AppendBinaryString(payload, dictionary_string);
+				payload.append((const char *)column.string_indices_.data(), column.string_indices_.size() * sizeof(uint32_t));
+				break;
+		}
+		
+		column = LogFileBinaryColumn();
+	}
+	
+	binary_row_count_ = 0;
+	binary_buffered_bytes_ = 0;
+	unflushed_row_count_ = 0;
+	
+	std::string buffer;
+	
+	_AppendBinaryRecord(buffer, kBinaryRecord_RowGroup, payload);
+	
+	std::ofstream file_stream(resolved_file_path_, std::ios_base::app | std::ios_base::out | std::ios_base::binary);
+	
+	return (file_stream.is_open() && file_stream.write(buffer.data(), buffer.size()) && file_stream.flush());
+}
+
+void LogFile::WriteBinaryRowGroup(void)
+{
+	if (!binary_ || (binary_row_count_ == 0))
+		return;
+	
+	THREAD_SAFETY_IN_ACTIVE_PARALLEL("LogFile::WriteBinaryRowGroup(): filesystem write");
+	
+	if (!_WriteBinaryRowGroup())
+		EIDOS_TERMINATION << "ERROR (LogFile::WriteBinaryRowGroup): could not write to file at path " << user_file_path_ << "." << EidosTerminate();
+}
+
+// A cursor over a record payload in a binary log file, raising if the payload is too short for what is read from it
+class _BinaryLogReader
+{
+private:
+	const char *position_;
+	const char *end_;
+	const std::string &path_;
+	
+public:
+	_BinaryLogReader(const std::string &p_payload, const std::string &p_path) : position_(p_payload.data()), end_(p_payload.data() + p_payload.size()), path_(p_path) {}
+	
+	const char *Consume(uint64_t p_length)
+	{
+		if (p_length > (uint64_t)(end_ - position_))
+			EIDOS_TERMINATION << "ERROR (LogFile::ConvertBinaryLogFile): the binary log file at " << path_ << " is corrupt." << EidosTerminate();
+		
+		const char *data = position_;
+		
+		position_ += p_length;
+		return data;
+	}
+	
+	template <typename T>
+	T Read(void)
+	{
+		T value;
+		
+		memcpy(&value, Consume(sizeof(T)), sizeof(T));
+		return value;
+	}
+	
+	std::string ReadString(void)
+	{
+		uint32_t length = Read<uint32_t>();
+		
+		return std::string(Consume(length), length);
+	}
+};
+
+void LogFile::ConvertBinaryLogFile(const std::string &p_input_path, const std::string &p_output_path, const std::string *p_sep)
+{
+	std::ifstream input_stream(p_input_path, std::ios_base::in | std::ios_base::binary);
+	
+	if (!input_stream.is_open())
+		EIDOS_TERMINATION << "ERROR (LogFile::ConvertBinaryLogFile): could not read binary log file at " << p_input_path << "." << EidosTerminate();
+	
+	// Read the header
+	char magic[sizeof(gSLiM_BinaryLogMagic)];
+	uint32_t version, sep_length;
+	
+	if (!input_stream.read(magic, sizeof(magic)) || (memcmp(magic, gSLiM_BinaryLogMagic, sizeof(magic)) != 0) ||
+		!input_stream.read((char *)&version, sizeof(version)) || !input_stream.read((char *)&sep_length, sizeof(sep_length)))
+		EIDOS_TERMINATION << "ERROR (LogFile::ConvertBinaryLogFile): the file at " << p_input_path << " is not a binary log file." << EidosTerminate();
+	
+	if (version != gSLiM_BinaryLogVersion)
+		EIDOS_TERMINATION << "ERROR (LogFile::ConvertBinaryLogFile): the binary log file at " << p_input_path << " has an unsupported format version (" << version << ")." << EidosTerminate();
+	
+	std::string sep(sep_length, '\0');
+	
+	if (!input_stream.read(&sep[0], sep_length))
+		EIDOS_TERMINATION << "ERROR (LogFile::ConvertBinaryLogFile): the binary log file at " << p_input_path << " is corrupt." << EidosTerminate();
+	
+	if (p_sep)
+		sep = *p_sep;
+	
+	std::ofstream output_stream(p_output_path, std::ios_base::out | std::ios_base::trunc | std::ios_base::binary);
+	
+	if (!output_stream.is_open())
+		EIDOS_TERMINATION << "ERROR (LogFile::ConvertBinaryLogFile): could not write to file at path " << p_output_path << "." << EidosTerminate();
+	
+	// Read records one at a time; a truncated record at the end (a row group being written) ends the conversion cleanly
+	std::vector<std::string> last_column_names;
+	std::string payload;
+	std::string line;
+	
+	while (true)
+	{
+		uint32_t record_type;
+		uint64_t record_length;
+		
+		if (!input_stream.read((char *)&record_type, sizeof(record_type)) || !input_stream.read((char *)&record_length, sizeof(record_length)))
+			break;
+		
+		payload.resize(record_length);
+		
+		if (!input_stream.read(&payload[0], (std::streamsize)record_length))
+			break;
+		
+		if (record_type == kBinaryRecord_Contents)
+		{
+			output_stream << payload;
+			continue;
+		}
+		if (record_type != kBinaryRecord_RowGroup)
+			continue;		// skip unknown record types, for forward compatibility
+		
+		_BinaryLogReader reader(payload, p_input_path);
+		uint32_t column_count = reader.Read<uint32_t>();
+		uint64_t row_count = reader.Read<uint64_t>();
+		int32_t float_precision = reader.Read<int32_t>();
+		
+		std::vector<std::string> column_names;
+		std::vector<LogFileColumnType> column_types;
+		std::vector<const char *> column_null_flags;
+		std::vector<const char *> column_data;
+		std::vector<std::vector<std::string>> column_dictionaries(column_count);
+		
+		for (uint32_t column_index = 0; column_index < column_count; ++column_index)
+		{
+			column_names.emplace_back(reader.ReadString());
+			
+			LogFileColumnType column_type = (LogFileColumnType)reader.Read<uint8_t>();
+			bool has_nulls = reader.Read<uint8_t>();
+			
+			column_types.emplace_back(column_type);
+			column_null_flags.emplace_back(has_nulls ? reader.Consume(row_count) : nullptr);
+			
+			switch (column_type)
+			{
+				case LogFileColumnType::kNone:
+					if (!has_nulls)
+						EIDOS_TERMINATION << "ERROR (LogFile::ConvertBinaryLogFile): the binary log file at " << p_input_path << " is corrupt." << EidosTerminate();
+					column_data.emplace_back(nullptr);
+					break;
+				case LogFileColumnType::kInt64:
+				case LogFileColumnType::kFloat64:
+					if (row_count > UINT64_MAX / 8)
+						EIDOS_TERMINATION << "ERROR (LogFile::ConvertBinaryLogFile): the binary log file at " << p_input_path << " is corrupt." << EidosTerminate();
+					column_data.emplace_back(reader.Consume(row_count * 8));
+					break;
+				case LogFileColumnType::kLogical:
+					column_data.emplace_back(reader.Consume(row_count));
+					break;
+				case LogFileColumnType::kString:
+				{
+					uint32_t dictionary_size = reader.Read<uint32_t>();
+					
+					for (uint32_t dictionary_index = 0; dictionary_index < dictionary_size; ++dictionary_index)
+						column_dictionaries[column_index].emplace_back(reader.ReadString());
+					
+					if (row_count > UINT64_MAX / 4)
+						EIDOS_TERMINATION << "ERROR (LogFile::ConvertBinaryLogFile): the binary log file at " << p_input_path << " is corrupt." << EidosTerminate();
+					column_data.emplace_back(reader.Consume(row_count * 4));
+					break;
+				}
+				default:
+					EIDOS_TERMINATION << "ERROR (LogFile::ConvertBinaryLogFile): the binary log file at " << p_input_path << " is corrupt." << EidosTerminate();
+			}
+		}
+		
+		// Write a header line whenever the columns change, which for a single LogFile means once
+		if (column_names != last_column_names)
+		{
+			line.clear();
+			
+			for (uint32_t column_index = 0; column_index < column_count; ++column_index)
+			{
+				if (column_index != 0)
+					line.append(sep);
+				line.append(column_names[column_index]);
+			}
+			
+			output_stream << line << '\n';
+			last_column_names = column_names;
+		}
+		
+		for (uint64_t row_index = 0; row_index < row_count; ++row_index)
+		{
+			line.clear();
+			
+			for (uint32_t column_index = 0; column_index < column_count; ++column_index)
+			{
+				if (column_index != 0)
+					line.append(sep);
+				
+				if (column_null_flags[column_index] && column_null_flags[column_index][row_index])
+				{
+					line.append("NA");
+					continue;
+				}
+				
+				const char *data = column_data[column_index];
+				
+				switch (column_types[column_index])
+				{
+					case LogFileColumnType::kNone:
+						break;
+					case LogFileColumnType::kInt64:
+					{
+						int64_t int_value;
+						
+						memcpy(&int_value, data + row_index * 8, sizeof(int_value));
+						line.append(_TextForBinaryValue(LogFileColumnType::kInt64, int_value, 0.0, float_precision));
+						break;
+					}
+					case LogFileColumnType::kFloat64:
+					{
+						double float_value;
+						
+						memcpy(&float_value, data + row_index * 8, sizeof(float_value));
+						line.append(_TextForBinaryValue(LogFileColumnType::kFloat64, 0, float_value, float_precision));
+						break;
+					}
+					case LogFileColumnType::kLogical:
+						line.append(_TextForBinaryValue(LogFileColumnType::kLogical, data[row_index], 0.0, float_precision));
+						break;
+					case LogFileColumnType::kString:
+					{
+						uint32_t string_index;
+						
+						memcpy(&string_index, data + row_index * 4, sizeof(string_index));
+						
+						if (string_index >= column_dictionaries[column_index].size())
+							EIDOS_TERMINATION << "ERROR (LogFile::ConvertBinaryLogFile): the binary log file at " << p_input_path << " is corrupt." << EidosTerminate();
+						
+						line.append(column_dictionaries[column_index][string_index]);
+						break;
+					}
+				}
+			}
+			
+			output_stream << line << '\n';
+		}
+	}
+	
+	if (!output_stream.flush())
+		EIDOS_TERMINATION << "ERROR (LogFile::ConvertBinaryLogFile): could not write to file at path " << p_output_path << "." << EidosTerminate();
+}
+
 std::vector<std::string> LogFile::SortedKeys_StringKeys(void) const
 {
 	// We want to return the column names in order, so we have to override EidosDictionaryUnretained here
@@ -561,6 +1159,10 @@ void LogFile::SetProperty(EidosGlobalStringID p_property_id, const EidosValue &p
 			if ((value < 1) || (value > 22))
 				EIDOS_TERMINATION << "ERROR (LogFile::SetProperty): property precision must be in [1,22]." << EidosTerminate();
 			
+			// each binary row group records a single precision, so buffered rows are written out with the old one
+			if (value != float_precision_)
+				WriteBinaryRowGroup();
+			
 			float_precision_ = (int)value;
 			
 			return;
@@ -898,7 +1500,11 @@ EidosValue_SP LogFile::ExecuteMethod_addTick(EidosGlobalStringID p_method_id, co
 EidosValue_SP LogFile::ExecuteMethod_flush(EidosGlobalStringID p_method_id, const std::vector<EidosValue_SP> &p_arguments, EidosInterpreter &p_interpreter)
 {
 #pragma unused (p_method_id, p_arguments, p_interpreter)
-	Eidos_FlushFile(resolved_file_path_);
+	if (binary_)
+		WriteBinaryRowGroup();
+	else
+		Eidos_FlushFile(resolved_file_path_);
+	
 	unflushed_row_count_ = 0;
 	
 	return gStaticEidosValueVOID;
@@ -971,7 +1577,7 @@ EidosValue_SP LogFile::ExecuteMethod_setFilePath(EidosGlobalStringID p_method_id
 	if (sep_value->Type() != EidosValueType::kValueNULL)
 		sep = sep_value->StringRefAtIndex_NOCAST(0, nullptr);
 	
-	ConfigureFile(filePath, initialContents, append, do_compress, sep);
+	ConfigureFile(filePath, initialContents, append, do_compress, sep, binary_);
 	
 	return gStaticEidosValueVOID;
 }
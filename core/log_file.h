@@ -25,6 +25,7 @@
 
 #include <string>
 #include <sstream>
+#include <unordered_map>
 
 class Community;
 
@@ -58,10 +59,36 @@ struct LogFileGeneratorInfo
 };
 
 
+// Column types in the binary log format; see LogFile::WriteBinaryRowGroup() for the file layout
+enum class LogFileColumnType : uint8_t
+{
+	kNone = 0,							// no non-NA value has been logged to the column yet; no data is written
+	kInt64,
+	kFloat64,
+	kLogical,
+	kString								// dictionary-encoded; any value that is not a singleton integer/float/logical ends up here
+};
+
+// A column buffered for the binary log format; values accumulate here in native form until a row group is written
+struct LogFileBinaryColumn
+{
+	LogFileColumnType type_ = LogFileColumnType::kNone;
+	std::vector<int64_t> int_values_;					// for kInt64 and kLogical
+	std::vector<double> float_values_;					// for kFloat64
+	std::vector<uint32_t> string_indices_;				// for kString; indices into string_dictionary_
+	std::vector<std::string> string_dictionary_;		// for kString; the text of each value, as it would appear in a text log
+	std::unordered_map<std::string, uint32_t> string_lookup_;
+	std::vector<uint8_t> null_flags_;					// one entry per buffered row; 1 for NA
+	bool has_nulls_ = false;
+};
+
+
 class LogFile : public EidosDictionaryRetained
 {
 private:
 	typedef EidosDictionaryRetained super;
+	
+	friend class SLiMCheckpoint;				// reads and writes private state for checkpointing
 
 protected:
 	virtual void Raise_UsesStringKeys() const override;
@@ -79,6 +106,7 @@ private:
 	bool header_logged_ = false;								// true if the header has been written out (in which case our generators are locked)
 	
 	bool compress_;
+	bool binary_ = false;										// if true, we write the binary columnar format instead of text
 	std::string sep_;											// the separator string between values, such as "," or "\t"
 	int float_precision_ = 6;									// the precision of output of float values
 	
@@ -101,6 +129,11 @@ private:
 	// A dictionary of supplied values, for kGenerator_SuppliedColumn
 	EidosDictionaryUnretained supplied_values_;
 	
+	// Buffered columns for the binary format, written out as a row group periodically
+	std::vector<LogFileBinaryColumn> binary_columns_;
+	int64_t binary_row_count_ = 0;								// the number of rows buffered in binary_columns_
+	size_t binary_buffered_bytes_ = 0;							// a rough estimate of the size of the buffered row group
+	
 #ifdef SLIMGUI
 	// For SLiMgui, LogFile keeps a record of all of the output it generates, which SLiMgui pulls out of it
 	std::vector<std::vector<std::string>> emitted_lines_;
@@ -120,6 +153,11 @@ private:
 	
 	void _OutputValue(std::ostringstream &ss, EidosValue *value);
 	
+	uint32_t _BinaryStringIndex(LogFileBinaryColumn &p_column, const std::string &p_string);
+	void _ConvertBinaryColumnToString(LogFileBinaryColumn &p_column);
+	void _BufferBinaryValue(LogFileBinaryColumn &p_column, EidosValue *p_value);
+	bool _WriteBinaryRowGroup(void);
+	
 public:
 	LogFile(const LogFile &p_original) = delete;	// no copy-construct
 	LogFile& operator=(const LogFile&) = delete;	// no copying
@@ -127,12 +165,16 @@ public:
 	explicit LogFile(Community &p_community);
 	virtual ~LogFile(void) override;
 	
-	void ConfigureFile(const std::string &p_filePath, std::vector<const std::string *> &p_initialContents, bool p_append, bool p_compress, const std::string &p_sep);
+	void ConfigureFile(const std::string &p_filePath, std::vector<const std::string *> &p_initialContents, bool p_append, bool p_compress, const std::string &p_sep, bool p_binary);
 	void SetLogInterval(bool p_autologging_enabled, int64_t p_logInterval);
 	void SetFlushInterval(bool p_explicit_flushing, int64_t p_flushInterval);
 	
 	void AppendNewRow(void);
 	void TickEndCallout(void);
+	void WriteBinaryRowGroup(void);		// writes out any buffered rows, for the binary format; does nothing for the text format
+	
+	// Converts a file written in the binary format to CSV/TSV text, as the text format would have written it
+	static void ConvertBinaryLogFile(const std::string &p_input_path, const std::string &p_output_path, const std::string *p_sep);
 	
 	inline const std::string &UserFilePath(void) const { return user_file_path_; }
 	inline const std::string &ResolvedFilePath(void) const { return resolved_file_path_; }
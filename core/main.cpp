@@ -104,7 +104,7 @@ static void PrintUsageAndDie(bool p_print_header, bool p_print_full_usage)
 	
 	SLIM_OUTSTREAM << "usage: slim -v[ersion] | -u[sage] | -h[elp] | -testEidos | -testSLiM |" << std::endl;
 	SLIM_OUTSTREAM << "   [-l[ong] [<l>]] [-s[eed] <seed>] [-t[ime]] [-m[em]] [-M[emhist]] [-x]" << std::endl;
-	SLIM_OUTSTREAM << "   [-d[efine] <def>] ";
+	SLIM_OUTSTREAM << "   [-d[efine] <def>] [-restore <path>] ";
 #ifdef _OPENMP
 	// Some flags are visible only for a parallel build
 	SLIM_OUTSTREAM << "[-maxThreads <n>] [-perTaskThreads \"x\"] ";
@@ -131,6 +131,7 @@ static void PrintUsageAndDie(bool p_print_header, bool p_print_full_usage)
 		SLIM_OUTSTREAM << "   -M[emhist]         : print a histogram of SLiM's memory usage" << std::endl;
 		SLIM_OUTSTREAM << "   -x                 : disable SLiM's runtime safety/consistency checks" << std::endl;
 		SLIM_OUTSTREAM << "   -d[efine] <def>    : define an Eidos constant, such as \"mu=1e-7\"" << std::endl;
+		SLIM_OUTSTREAM << "   -restore <path>    : resume a run from a checkpoint written by outputCheckpoint()" << std::endl;
 #ifdef _OPENMP
 		// Some flags are visible only for a parallel build
 		SLIM_OUTSTREAM << "   -maxThreads <n>    : set the maximum number of threads used" << std::endl;
@@ -187,6 +188,7 @@ int main(int argc, char *argv[])	// FIXME: clang-tidy flags this with bugprone-e
 	const char *input_file = nullptr;
 	bool keep_time = false, keep_mem = false, keep_mem_hist = false, skip_checks = false, tree_seq_checks = false, tree_seq_force = false;
 	std::vector<std::string> defined_constants;
+	const char *restore_path = nullptr;
 	
 #ifdef _OPENMP
 	long max_thread_count = omp_get_max_threads();
@@ -388,6 +390,17 @@ int main(int argc, char *argv[])	// FIXME: clang-tidy flags this with bugprone-e
 			continue;
 		}
 		
+		// -restore <path>: resume a run from a checkpoint file
+		if (strcmp(arg, "--restore") == 0 || strcmp(arg, "-restore") == 0)
+		{
+			if (++arg_index == argc)
+				PrintUsageAndDie(false, true);
+			
+			restore_path = argv[arg_index];
+			
+			continue;
+		}
+		
 		// -maxThreads <x>: set the maximum number of OpenMP threads that will be used
 		if (strcmp(arg, "-maxThreads") == 0)
 		{
@@ -639,6 +652,9 @@ int main(int argc, char *argv[])	// FIXME: clang-tidy flags this with bugprone-e
 		
 		community->FinishInitialization();
 		
+		if (restore_path)
+			community->RestoreFromCheckpoint(restore_path);
+		
 		if (tree_seq_checks)
 			community->AllSpecies_TSXC_Enable();
         if (tree_seq_force && !tree_seq_checks)
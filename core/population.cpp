@@ -7590,12 +7590,13 @@ void Population::PrintAllBinary(std::ostream &p_out, bool p_output_spatial_posit
 		p_out.write(reinterpret_cast<char *>(&endianness_tag), sizeof endianness_tag);
 		
 		// Write a format version tag
-		int32_t version_tag = 7;													// version 2 started with SLiM 2.1
+		int32_t version_tag = 8;													// version 2 started with SLiM 2.1
 																					// version 3 started with SLiM 2.3
 																					// version 4 started with SLiM 3.0, only when individual age is output
 																					// version 5 started with SLiM 3.3, adding a "flags" field and nucleotide support
 																					// version 6 started with SLiM 3.5, adding optional pedigree ID output with a new flag
 																					// version 7 started with SLiM 4.0, changing generation to ticks and adding cycle
+																					// version 8 started with SLiM 4.3, writing each distinct mutation run only once
 		p_out.write(reinterpret_cast<char *>(&version_tag), sizeof version_tag);
 		
 		// Write the size of a double
@@ -7703,9 +7704,13 @@ void Population::PrintAllBinary(std::ostream &p_out, bool p_output_spatial_posit
 	// Write a tag indicating the section has ended
 	p_out.write(reinterpret_cast<char *>(&section_end_tag), sizeof section_end_tag);
 	
-	// Find all polymorphisms
-	PolymorphismMap polymorphisms;
-	Mutation *mut_block_ptr = gSLiM_Mutation_Block;
+	// Find all distinct mutation runs, in the order in which they are first referenced, and count their uses.  Genomes very
+	// often share MutationRun objects, so as of version 8 we write each run out only once and have genomes refer to it.
+	robin_hood::unordered_flat_map<const MutationRun *, int32_t> run_ids;
+	std::vector<const MutationRun *> runs;
+	std::vector<slim_refcount_t> run_use_counts;
+	int32_t mutrun_count = 0;
+	slim_position_t mutrun_length = 0;
 	
 	for (const std::pair<const slim_objectid_t,Subpopulation*> &subpop_pair : subpops_)			// go through all subpopulations
 	{
@@ -7715,20 +7720,59 @@ void Population::PrintAllBinary(std::ostream &p_out, bool p_output_spatial_posit
 		for (slim_popsize_t i = 0; i < 2 * subpop_size; i++)				// go through all children
 		{
 			Genome &genome = *(subpop->CurrentGenomes()[i]);
-			int mutrun_count = genome.mutrun_count_;
+			
+			if (genome.IsNull())
+				continue;
+			
+			// all non-null genomes share the same mutation run layout, which we record once for the whole file
+			if (mutrun_count == 0)
+			{
+				mutrun_count = genome.mutrun_count_;
+				mutrun_length = genome.mutrun_length_;
+			}
+			else if ((genome.mutrun_count_ != mutrun_count) || (genome.mutrun_length_ != mutrun_length))
+				EIDOS_TERMINATION << "ERROR (Population::PrintAllBinary): (internal error) genomes do not share the same mutation run layout." << EidosTerminate();
 			
 			for (int run_index = 0; run_index < mutrun_count; ++run_index)
 			{
 				const MutationRun *mutrun = genome.mutruns_[run_index];
-				int mut_count = mutrun->size();
-				const MutationIndex *mut_ptr = mutrun->begin_pointer_const();
+				auto run_iter = run_ids.emplace(mutrun, (int32_t)runs.size());
 				
-				for (int mut_index = 0; mut_index < mut_count; ++mut_index)
-					AddMutationToPolymorphismMap(&polymorphisms, mut_block_ptr + mut_ptr[mut_index]);
+				if (run_iter.second)
+				{
+					runs.emplace_back(mutrun);
+					run_use_counts.emplace_back(1);
+				}
+				else
+				{
+					run_use_counts[run_iter.first->second]++;
+				}
 			}
 		}
 	}
 	
+	// Find all polymorphisms; visiting the distinct runs in first-use order assigns the same polymorphism ids as visiting every genome
+	PolymorphismMap polymorphisms;
+	Mutation *mut_block_ptr = gSLiM_Mutation_Block;
+	
+	for (size_t run_id = 0; run_id < runs.size(); ++run_id)
+	{
+		const MutationRun *mutrun = runs[run_id];
+		slim_refcount_t extra_uses = run_use_counts[run_id] - 1;
+		int mut_count = mutrun->size();
+		const MutationIndex *mut_ptr = mutrun->begin_pointer_const();
+		
+		for (int mut_index = 0; mut_index < mut_count; ++mut_index)
+		{
+			Mutation *mutation = mut_block_ptr + mut_ptr[mut_index];
+			
+			AddMutationToPolymorphismMap(&polymorphisms, mutation);
+			
+			if (extra_uses)
+				polymorphisms.find(mutation->mutation_id_)->second.prevalence_ += extra_uses;
+		}
+	}
+	
 	// Write out the size of the mutation map, so we can allocate a vector rather than utilizing std::map when reading
 	int32_t mutation_map_size = (int32_t)polymorphisms.size();
 	
@@ -7778,9 +7822,52 @@ void Population::PrintAllBinary(std::ostream &p_out, bool p_output_spatial_posit
 	// Write a tag indicating the section has ended
 	p_out.write(reinterpret_cast<char *>(&section_end_tag), sizeof section_end_tag);
 	
-	// Genomes section
-	bool use_16_bit = (mutation_map_size <= UINT16_MAX - 1);	// 0xFFFF is reserved as the start of our various tags
+	// Mutation runs section, added in version 8: the layout of the runs, then each distinct run as a count followed by polymorphism ids.
+	// The run records are preceded by padding that aligns them to 8 bytes within the file, so that a reader that maps the file into
+	// memory can use the polymorphism ids in place.  The padding length is written out explicitly, so it does not matter if our
+	// stream cannot report its position; the records will then simply be unaligned.
+	{
+		int32_t run_table_size = (int32_t)runs.size();
+		
+		p_out.write(reinterpret_cast<char *>(&mutrun_count), sizeof mutrun_count);
+		p_out.write(reinterpret_cast<char *>(&mutrun_length), sizeof mutrun_length);
+		p_out.write(reinterpret_cast<char *>(&run_table_size), sizeof run_table_size);
+		
+		std::streamoff stream_position = p_out.tellp();
+		int32_t padding_size = (stream_position >= 0) ? (int32_t)((8 - ((stream_position + sizeof(padding_size)) % 8)) % 8) : 0;
+		const char padding[8] = {0, 0, 0, 0, 0, 0, 0, 0};
+		
+		p_out.write(reinterpret_cast<char *>(&padding_size), sizeof padding_size);
+		p_out.write(padding, padding_size);
+		
+		std::vector<slim_polymorphismid_t> run_polymorphism_ids;
+		
+		for (const MutationRun *mutrun : runs)
+		{
+			int32_t mut_count = mutrun->size();
+			const MutationIndex *mut_ptr = mutrun->begin_pointer_const();
+			
+			run_polymorphism_ids.resize(mut_count);
+			
+			for (int mut_index = 0; mut_index < mut_count; ++mut_index)
+			{
+				slim_polymorphismid_t polymorphism_id = FindMutationInPolymorphismMap(polymorphisms, mut_block_ptr + mut_ptr[mut_index]);
+				
+				if (polymorphism_id == -1)
+					EIDOS_TERMINATION << "ERROR (Population::PrintAllBinary): (internal error) polymorphism not found." << EidosTerminate();
+				
+				run_polymorphism_ids[mut_index] = polymorphism_id;
+			}
+			
+			p_out.write(reinterpret_cast<char *>(&mut_count), sizeof mut_count);
+			p_out.write(reinterpret_cast<char *>(run_polymorphism_ids.data()), mut_count * sizeof(slim_polymorphismid_t));
+		}
+	}
+	
+	// Write a tag indicating the section has ended
+	p_out.write(reinterpret_cast<char *>(&section_end_tag), sizeof section_end_tag);
 	
+	// Genomes section
 	for (const std::pair<const slim_objectid_t,Subpopulation*> &subpop_pair : subpops_)			// go through all subpopulations
 	{
 		Subpopulation *subpop = subpop_pair.second;
@@ -7831,75 +7918,25 @@ void Population::PrintAllBinary(std::ostream &p_out, bool p_output_spatial_posit
 				p_out.write(reinterpret_cast<char *>(&individual.age_), sizeof individual.age_);
 			}
 			
-			// Write out the mutation list
+			// Write out the mutation run list
 			if (genome.IsNull())
 			{
-				// null genomes get a 32-bit flag value written instead of a mutation count
+				// null genomes get a 32-bit flag value written instead of a mutation run count
 				int32_t null_genome_tag = 0xFFFF1000;
 				
 				p_out.write(reinterpret_cast<char *>(&null_genome_tag), sizeof null_genome_tag);
 			}
 			else
 			{
-				// write a 32-bit mutation count
-				{
-					int32_t total_mutations = genome.mutation_count();
-					
-					p_out.write(reinterpret_cast<char *>(&total_mutations), sizeof total_mutations);
-				}
+				// write a 32-bit mutation run count, followed by the index of each run in the mutation runs section; before
+				// version 8 this was a mutation count followed by the polymorphism id of each mutation in the genome
+				p_out.write(reinterpret_cast<char *>(&mutrun_count), sizeof mutrun_count);
 				
-				if (use_16_bit)
-				{
-					// Write out 16-bit mutation tags
-					int mutrun_count = genome.mutrun_count_;
-					
-					for (int run_index = 0; run_index < mutrun_count; ++run_index)
-					{
-						const MutationRun *mutrun = genome.mutruns_[run_index];
-						int mut_count = mutrun->size();
-						const MutationIndex *mut_ptr = mutrun->begin_pointer_const();
-						
-						for (int mut_index = 0; mut_index < mut_count; ++mut_index)
-						{
-							slim_polymorphismid_t polymorphism_id = FindMutationInPolymorphismMap(polymorphisms, mut_block_ptr + mut_ptr[mut_index]);
-							
-							if (polymorphism_id == -1)
-								EIDOS_TERMINATION << "ERROR (Population::PrintAllBinary): (internal error) polymorphism not found." << EidosTerminate();
-							
-							if (polymorphism_id <= UINT16_MAX - 1)
-							{
-								uint16_t id_16 = (uint16_t)polymorphism_id;
-								
-								p_out.write(reinterpret_cast<char *>(&id_16), sizeof id_16);
-							}
-							else
-							{
-								EIDOS_TERMINATION << "ERROR (Population::PrintAllBinary): (internal error) mutation id out of 16-bit bounds." << EidosTerminate();
-							}
-						}
-					}
-				}
-				else
+				for (int run_index = 0; run_index < mutrun_count; ++run_index)
 				{
-					// Write out 32-bit mutation tags
-					int mutrun_count = genome.mutrun_count_;
+					int32_t run_id = run_ids.find(genome.mutruns_[run_index])->second;
 					
-					for (int run_index = 0; run_index < mutrun_count; ++run_index)
-					{
-						const MutationRun *mutrun = genome.mutruns_[run_index];
-						int mut_count = mutrun->size();
-						const MutationIndex *mut_ptr = mutrun->begin_pointer_const();
-						
-						for (int mut_index = 0; mut_index < mut_count; ++mut_index)
-						{
-							slim_polymorphismid_t polymorphism_id = FindMutationInPolymorphismMap(polymorphisms, mut_block_ptr + mut_ptr[mut_index]);
-							
-							if (polymorphism_id == -1)
-								EIDOS_TERMINATION << "ERROR (Population::PrintAllBinary): (internal error) polymorphism not found." << EidosTerminate();
-							
-							p_out.write(reinterpret_cast<char *>(&polymorphism_id), sizeof polymorphism_id);
-						}
-					}
+					p_out.write(reinterpret_cast<char *>(&run_id), sizeof run_id);
 				}
 				
 				// now will come either a genome type (32 bits: 0, 1, or 2), or a section end tag
@@ -7919,6 +7956,52 @@ void Population::PrintAllBinary(std::ostream &p_out, bool p_output_spatial_posit
 	}
 }
 
+// Draws candidates for the PrintSample_X() methods below.  This gives exactly the draws that sampling from a vector of candidates
+// [p_count - 1, ..., 1, 0] would, with swap-and-pop removal of each drawn candidate when sampling without replacement, so samples are
+// unchanged for a given seed; but only the vector entries that removals have changed are stored, so drawing a small sample from a
+// large subpopulation does not have to build (or touch) a candidate for every genome or individual in it.
+class _SampleCandidates
+{
+	slim_popsize_t count_;			// the initial number of candidates
+	slim_popsize_t remaining_;		// the number of candidates remaining
+	robin_hood::unordered_flat_map<slim_popsize_t, slim_popsize_t> moved_;	// vector entries changed by removals, by index
+	
+	inline slim_popsize_t CandidateAtIndex(slim_popsize_t p_index) const
+	{
+		auto moved_iter = moved_.find(p_index);
+		
+		return ((moved_iter == moved_.end()) ? (count_ - 1 - p_index) : moved_iter->second);
+	}
+	
+public:
+	
+	explicit _SampleCandidates(slim_popsize_t p_count) : count_(p_count), remaining_(p_count) {}
+	
+	inline bool Empty(void) const { return (remaining_ == 0); }
+	
+	slim_popsize_t Draw(gsl_rng *p_rng, bool p_replace)
+	{
+		slim_popsize_t candidate_index = static_cast<slim_popsize_t>(Eidos_rng_uniform_int(p_rng, (uint32_t)remaining_));
+		slim_popsize_t candidate = CandidateAtIndex(candidate_index);
+		
+		// If we're sampling without replacement, remove the candidate we have just taken by moving the last candidate into its place
+		if (!p_replace)
+		{
+			slim_popsize_t last_index = remaining_ - 1;
+			slim_popsize_t last_candidate = CandidateAtIndex(last_index);
+			
+			moved_.erase(last_index);
+			
+			if (candidate_index != last_index)
+				moved_[candidate_index] = last_candidate;
+			
+			remaining_--;
+		}
+		
+		return candidate;
+	}
+};
+
 // print sample of p_sample_size genomes from subpopulation p_subpop_id
 void Population::PrintSample_SLiM(std::ostream &p_out, Subpopulation &p_subpop, slim_popsize_t p_sample_size, bool p_replace, IndividualSex p_requested_sex) const
 {
@@ -7931,34 +8014,22 @@ void Population::PrintSample_SLiM(std::ostream &p_out, Subpopulation &p_subpop,
 		EIDOS_TERMINATION << "ERROR (Population::PrintSample_SLiM): called to output Y chromosomes from females." << EidosTerminate();
 	
 	// assemble a sample (with or without replacement)
-	std::vector<slim_popsize_t> candidates;
-	
-	for (slim_popsize_t s = subpop_size * 2 - 1; s >= 0; --s)
-		candidates.emplace_back(s);
-	
+	_SampleCandidates candidates(subpop_size * 2);
 	std::vector<Genome *> sample; 
 	gsl_rng *rng = EIDOS_GSL_RNG(omp_get_thread_num());
 	
 	for (slim_popsize_t s = 0; s < p_sample_size; s++)
 	{
-		int candidate_index;
 		slim_popsize_t genome_index;
 		
 		// Scan for a genome that is not null and that belongs to an individual of the requested sex
 		do {
-			// select a random genome (not a random individual) by selecting a random candidate entry
-			if (candidates.size() == 0)
+			// select a random genome (not a random individual) by drawing a random candidate; without replacement, the candidate is
+			// removed, since either we will use it or it is invalid
+			if (candidates.Empty())
 				EIDOS_TERMINATION << "ERROR (Population::PrintSample_SLiM): not enough eligible genomes for sampling without replacement." << EidosTerminate();
 			
-			candidate_index = static_cast<slim_popsize_t>(Eidos_rng_uniform_int(rng, (uint32_t)candidates.size()));
-			genome_index = candidates[candidate_index];
-			
-			// If we're sampling without replacement, remove the index we have just taken; either we will use it or it is invalid
-			if (!p_replace)
-			{
-				candidates[candidate_index] = candidates.back();
-				candidates.pop_back();
-			}
+			genome_index = candidates.Draw(rng, p_replace);
 		} while (subpop_genomes[genome_index]->IsNull() || (p_subpop.sex_enabled_ && p_requested_sex != IndividualSex::kUnspecified && p_subpop.SexOfIndividual(genome_index / 2) != p_requested_sex));
 		
 		sample.emplace_back(subpop_genomes[genome_index]);
@@ -7980,34 +8051,22 @@ void Population::PrintSample_MS(std::ostream &p_out, Subpopulation &p_subpop, sl
 		EIDOS_TERMINATION << "ERROR (Population::PrintSample_MS): called to output Y chromosomes from females." << EidosTerminate();
 	
 	// assemble a sample (with or without replacement)
-	std::vector<slim_popsize_t> candidates;
-	
-	for (slim_popsize_t s = subpop_size * 2 - 1; s >= 0; --s)
-		candidates.emplace_back(s);
-	
+	_SampleCandidates candidates(subpop_size * 2);
 	std::vector<Genome *> sample; 
 	gsl_rng *rng = EIDOS_GSL_RNG(omp_get_thread_num());
 	
 	for (slim_popsize_t s = 0; s < p_sample_size; s++)
 	{
-		int candidate_index;
 		slim_popsize_t genome_index;
 		
 		// Scan for a genome that is not null and that belongs to an individual of the requested sex
 		do {
-			// select a random genome (not a random individual) by selecting a random candidate entry
-			if (candidates.size() == 0)
+			// select a random genome (not a random individual) by drawing a random candidate; without replacement, the candidate is
+			// removed, since either we will use it or it is invalid
+			if (candidates.Empty())
 				EIDOS_TERMINATION << "ERROR (Population::PrintSample_MS): not enough eligible genomes for sampling without replacement." << EidosTerminate();
 			
-			candidate_index = static_cast<slim_popsize_t>(Eidos_rng_uniform_int(rng, (uint32_t)candidates.size()));
-			genome_index = candidates[candidate_index];
-			
-			// If we're sampling without replacement, remove the index we have just taken; either we will use it or it is invalid
-			if (!p_replace)
-			{
-				candidates[candidate_index] = candidates.back();
-				candidates.pop_back();
-			}
+			genome_index = candidates.Draw(rng, p_replace);
 		} while (subpop_genomes[genome_index]->IsNull() || (p_subpop.sex_enabled_ && p_requested_sex != IndividualSex::kUnspecified && p_subpop.SexOfIndividual(genome_index / 2) != p_requested_sex));
 		
 		sample.emplace_back(subpop_genomes[genome_index]);
@@ -8031,35 +8090,23 @@ void Population::PrintSample_VCF(std::ostream &p_out, Subpopulation &p_subpop, s
 		EIDOS_TERMINATION << "ERROR (Population::PrintSample_VCF): called to output Y chromosomes from both sexes." << EidosTerminate();
 	
 	// assemble a sample (with or without replacement)
-	std::vector<slim_popsize_t> candidates;
-	
-	for (slim_popsize_t s = subpop_size - 1; s >= 0; --s)
-		candidates.emplace_back(s);
-	
+	_SampleCandidates candidates(subpop_size);
 	std::vector<Genome *> sample; 
 	gsl_rng *rng = EIDOS_GSL_RNG(omp_get_thread_num());
 	
 	for (slim_popsize_t s = 0; s < p_sample_size; s++)
 	{
-		int candidate_index;
 		slim_popsize_t individual_index;
 		slim_popsize_t genome1, genome2;
 		
 		// Scan for an individual of the requested sex
 		do {
-			// select a random individual by selecting a random candidate entry
-			if (candidates.size() == 0)
+			// select a random individual by drawing a random candidate; without replacement, the candidate is removed, since either
+			// we will use it or it is invalid
+			if (candidates.Empty())
 				EIDOS_TERMINATION << "ERROR (Population::PrintSample_VCF): not enough eligible individuals for sampling without replacement." << EidosTerminate();
 			
-			candidate_index = static_cast<slim_popsize_t>(Eidos_rng_uniform_int(rng, (uint32_t)candidates.size()));
-			individual_index = candidates[candidate_index];
-			
-			// If we're sampling without replacement, remove the index we have just taken; either we will use it or it is invalid
-			if (!p_replace)
-			{
-				candidates[candidate_index] = candidates.back();
-				candidates.pop_back();
-			}
+			individual_index = candidates.Draw(rng, p_replace);
 		} while (p_subpop.sex_enabled_ && (p_requested_sex != IndividualSex::kUnspecified) && (p_subpop.SexOfIndividual(individual_index) != p_requested_sex));
 		
 		genome1 = individual_index * 2;
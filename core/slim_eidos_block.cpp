@@ -60,6 +60,7 @@ static inline bool SLiM_TokenIsCallbackIdentifier(EidosToken *token)
 		(token->token_string_.compare(gStr_initialize) == 0) ||
 		(token->token_string_.compare(gStr_fitnessEffect) == 0) ||
 		(token->token_string_.compare(gStr_mutationEffect) == 0) ||
+		(token->token_string_.compare(gStr_mutationEffects) == 0) ||
 		(token->token_string_.compare(gStr_mutation) == 0) ||
 		(token->token_string_.compare(gStr_interaction) == 0) ||
 		(token->token_string_.compare(gStr_mateChoice) == 0) ||
@@ -402,8 +403,9 @@ EidosASTNode *SLiMEidosScript::Parse_SLiMEidosBlock(void)
 					
 					Match(EidosTokenType::kTokenRParen, "SLiM fitnessEffect() callback");
 				}
-				else if (current_token_->token_string_.compare(gStr_mutationEffect) == 0)
+				else if ((current_token_->token_string_.compare(gStr_mutationEffect) == 0) || (current_token_->token_string_.compare(gStr_mutationEffects) == 0))
 				{
+					// mutationEffects() is the vectorized form of mutationEffect(), with the same declaration syntax
 					EidosASTNode *callback_info_node = new (gEidosASTNodePool->AllocateChunk()) EidosASTNode(current_token_);
 					slim_script_block_node->AddChild(callback_info_node);
 					
@@ -858,7 +860,7 @@ SLiMEidosBlockType SLiMEidosBlock::BlockTypeForRootNode(EidosASTNode *p_root_nod
 					return SLiMEidosBlockType::SLiMEidosInitializeCallback;
 				else if (callback_name.compare(gStr_fitnessEffect) == 0)
 					return SLiMEidosBlockType::SLiMEidosFitnessEffectCallback;
-				else if (callback_name.compare(gStr_mutationEffect) == 0)
+				else if ((callback_name.compare(gStr_mutationEffect) == 0) || (callback_name.compare(gStr_mutationEffects) == 0))
 					return SLiMEidosBlockType::SLiMEidosMutationEffectCallback;
 				else if (callback_name.compare(gStr_mutation) == 0)
 					return SLiMEidosBlockType::SLiMEidosMutationCallback;
@@ -1070,15 +1072,16 @@ SLiMEidosBlock::SLiMEidosBlock(EidosASTNode *p_root_node) :
 						subpopulation_id_ = SLiMEidosScript::ExtractIDFromStringWithPrefix(subpop_id_token->token_string_, 'p', subpop_id_token);
 					}
 				}
-				else if ((callback_type == EidosTokenType::kTokenIdentifier) && (callback_name.compare(gStr_mutationEffect) == 0))
+				else if ((callback_type == EidosTokenType::kTokenIdentifier) && ((callback_name.compare(gStr_mutationEffect) == 0) || (callback_name.compare(gStr_mutationEffects) == 0)))
 				{
 					if ((n_callback_children != 1) && (n_callback_children != 2))
-						EIDOS_TERMINATION << "ERROR (SLiMEidosBlock::SLiMEidosBlock): mutationEffect() callback needs 1 or 2 parameters." << EidosTerminate(callback_token);
+						EIDOS_TERMINATION << "ERROR (SLiMEidosBlock::SLiMEidosBlock): " << callback_name << "() callback needs 1 or 2 parameters." << EidosTerminate(callback_token);
 					
 					EidosToken *mutation_type_id_token = callback_children[0]->token_;
 					
 					mutation_type_id_ = SLiMEidosScript::ExtractIDFromStringWithPrefix(mutation_type_id_token->token_string_, 'm', mutation_type_id_token);
 					type_ = SLiMEidosBlockType::SLiMEidosMutationEffectCallback;
+					vectorized_ = (callback_name.compare(gStr_mutationEffects) == 0);
 					
 					if (n_callback_children == 2)
 					{
@@ -1435,8 +1438,8 @@ void SLiMEidosBlock::PrintDeclaration(std::ostream& p_out, Community *p_communit
 			
 		case SLiMEidosBlockType::SLiMEidosMutationEffectCallback:
 		{
-			// mutationEffect(<mutTypeId> [, <subpopId>])
-			p_out << "mutationEffect(m" << mutation_type_id_;
+			// mutationEffect(<mutTypeId> [, <subpopId>]) or mutationEffects(<mutTypeId> [, <subpopId>])
+			p_out << (vectorized_ ? "mutationEffects(m" : "mutationEffect(m") << mutation_type_id_;
 			if (subpopulation_id_ != -1)
 				p_out << ", p" << subpopulation_id_;
 			p_out << ")";
@@ -1569,7 +1572,7 @@ void SLiMEidosBlock::Print(std::ostream &p_ostream) const
 		case SLiMEidosBlockType::SLiMEidosEventEarly:				p_ostream << gStr_early; break;
 		case SLiMEidosBlockType::SLiMEidosEventLate:				p_ostream << gStr_late; break;
 		case SLiMEidosBlockType::SLiMEidosInitializeCallback:		p_ostream << gStr_initialize; break;
-		case SLiMEidosBlockType::SLiMEidosMutationEffectCallback:	p_ostream << gStr_mutationEffect; break;
+		case SLiMEidosBlockType::SLiMEidosMutationEffectCallback:	p_ostream << (vectorized_ ? gStr_mutationEffects : gStr_mutationEffect); break;
 		case SLiMEidosBlockType::SLiMEidosFitnessEffectCallback:	p_ostream << gStr_fitnessEffect; break;
 		case SLiMEidosBlockType::SLiMEidosInteractionCallback:		p_ostream << gStr_interaction; break;
 		case SLiMEidosBlockType::SLiMEidosMateChoiceCallback:		p_ostream << gStr_mateChoice; break;
@@ -1624,7 +1627,7 @@ EidosValue_SP SLiMEidosBlock::GetProperty(EidosGlobalStringID p_property_id)
 				case SLiMEidosBlockType::SLiMEidosEventEarly:				return EidosValue_SP(new (gEidosValuePool->AllocateChunk()) EidosValue_String(gStr_early));
 				case SLiMEidosBlockType::SLiMEidosEventLate:				return EidosValue_SP(new (gEidosValuePool->AllocateChunk()) EidosValue_String(gStr_late));
 				case SLiMEidosBlockType::SLiMEidosInitializeCallback:		return EidosValue_SP(new (gEidosValuePool->AllocateChunk()) EidosValue_String(gStr_initialize));
-				case SLiMEidosBlockType::SLiMEidosMutationEffectCallback:	return EidosValue_SP(new (gEidosValuePool->AllocateChunk()) EidosValue_String(gStr_mutationEffect));
+				case SLiMEidosBlockType::SLiMEidosMutationEffectCallback:	return EidosValue_SP(new (gEidosValuePool->AllocateChunk()) EidosValue_String(vectorized_ ? gStr_mutationEffects : gStr_mutationEffect));
 				case SLiMEidosBlockType::SLiMEidosFitnessEffectCallback:	return EidosValue_SP(new (gEidosValuePool->AllocateChunk()) EidosValue_String(gStr_fitnessEffect));
 				case SLiMEidosBlockType::SLiMEidosInteractionCallback:		return EidosValue_SP(new (gEidosValuePool->AllocateChunk()) EidosValue_String(gStr_interaction));
 				case SLiMEidosBlockType::SLiMEidosMateChoiceCallback:		return EidosValue_SP(new (gEidosValuePool->AllocateChunk()) EidosValue_String(gStr_mateChoice));
@@ -27,6 +27,7 @@
 #include "mutation.h"
 #include "mutation_type.h"
 #include "individual.h"
+#include "log_file.h"
 #include "eidos_rng.h"
 #include "json.hpp"
 
@@ -75,6 +76,7 @@ const std::vector<EidosFunctionSignature_CSP> *Community::SLiMFunctionSignatures
 		sim_func_signatures_.emplace_back((EidosFunctionSignature *)(new EidosFunctionSignature("calcTajimasD", gSLiMSourceCode_calcWattersonsTheta, kEidosValueMaskFloat | kEidosValueMaskSingleton, "SLiM"))->AddObject("genomes", gSLiM_Genome_Class)->AddObject_ON("muts", gSLiM_Mutation_Class, gStaticEidosValueNULL)->AddInt_OSN("start", gStaticEidosValueNULL)->AddInt_OSN("end", gStaticEidosValueNULL));
 		
 		// Other built-in SLiM functions
+		sim_func_signatures_.emplace_back((EidosFunctionSignature *)(new EidosFunctionSignature("convertLogFile", SLiM_ExecuteFunction_convertLogFile, kEidosValueMaskVOID, "SLiM"))->AddString_S("filePath")->AddString_S("outputFilePath")->AddString_OSN("sep", gStaticEidosValueNULL));
 		sim_func_signatures_.emplace_back((EidosFunctionSignature *)(new EidosFunctionSignature("summarizeIndividuals", SLiM_ExecuteFunction_summarizeIndividuals, kEidosValueMaskFloat, "SLiM"))->AddObject("individuals", gSLiM_Individual_Class)->AddInt("dim")->AddNumeric("spatialBounds")->AddString_S("operation")->AddLogicalEquiv_OSN("empty", gStaticEidosValue_Float0)->AddLogical_OS("perUnitArea", gStaticEidosValue_LogicalF)->AddString_OSN("spatiality", gStaticEidosValueNULL));
 		sim_func_signatures_.emplace_back((EidosFunctionSignature *)(new EidosFunctionSignature("treeSeqMetadata", SLiM_ExecuteFunction_treeSeqMetadata, kEidosValueMaskObject | kEidosValueMaskSingleton, gEidosDictionaryRetained_Class, "SLiM"))->AddString_S("filePath")->AddLogical_OS("userData", gStaticEidosValue_LogicalT));
 		
@@ -1937,6 +1939,28 @@ EidosValue_SP SLiM_ExecuteFunction_summarizeIndividuals(const std::vector<EidosV
 	return EidosValue_SP(result_vec);
 }
 
+// (void)convertLogFile(string$ filePath, string$ outputFilePath, [Ns$ sep = NULL])
+EidosValue_SP SLiM_ExecuteFunction_convertLogFile(const std::vector<EidosValue_SP> &p_arguments, __attribute__((unused)) EidosInterpreter &p_interpreter)
+{
+	EidosValue *filePath_value = p_arguments[0].get();
+	EidosValue *outputFilePath_value = p_arguments[1].get();
+	EidosValue *sep_value = p_arguments[2].get();
+	
+	std::string file_path = Eidos_ResolvedPath(Eidos_StripTrailingSlash(filePath_value->StringAtIndex_NOCAST(0, nullptr)));
+	std::string output_file_path = Eidos_ResolvedPath(Eidos_StripTrailingSlash(outputFilePath_value->StringAtIndex_NOCAST(0, nullptr)));
+	std::string sep;
+	
+	if (sep_value->Type() != EidosValueType::kValueNULL)
+		sep = sep_value->StringAtIndex_NOCAST(0, nullptr);
+	
+	if (file_path == output_file_path)
+		EIDOS_TERMINATION << "ERROR (SLiM_ExecuteFunction_convertLogFile): convertLogFile() requires outputFilePath to be different from filePath." << EidosTerminate();
+	
+	LogFile::ConvertBinaryLogFile(file_path, output_file_path, (sep_value->Type() != EidosValueType::kValueNULL) ? &sep : nullptr);
+	
+	return gStaticEidosValueVOID;
+}
+
 // (object<Dictionary>$)treeSeqMetadata(string$ filePath, [logical$ userData=T])
 EidosValue_SP SLiM_ExecuteFunction_treeSeqMetadata(const std::vector<EidosValue_SP> &p_arguments, __attribute__((unused)) EidosInterpreter &p_interpreter)
 {
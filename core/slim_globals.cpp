@@ -1319,6 +1319,7 @@ const std::string &gStr_mutationFrequencies = EidosRegisteredString("mutationFre
 const std::string &gStr_mutationFrequenciesInGenomes = EidosRegisteredString("mutationFrequenciesInGenomes", gID_mutationFrequenciesInGenomes);
 //const std::string &gStr_mutationsOfType = EidosRegisteredString("mutationsOfType", gID_mutationsOfType);
 //const std::string &gStr_countOfMutationsOfType = EidosRegisteredString("countOfMutationsOfType", gID_countOfMutationsOfType);
+const std::string &gStr_outputCheckpoint = EidosRegisteredString("outputCheckpoint", gID_outputCheckpoint);
 const std::string &gStr_outputFixedMutations = EidosRegisteredString("outputFixedMutations", gID_outputFixedMutations);
 const std::string &gStr_outputFull = EidosRegisteredString("outputFull", gID_outputFull);
 const std::string &gStr_outputMutations = EidosRegisteredString("outputMutations", gID_outputMutations);
@@ -1397,6 +1398,7 @@ const std::string &gStr_outputVCFSample = EidosRegisteredString("outputVCFSample
 const std::string &gStr_outputSample = EidosRegisteredString("outputSample", gID_outputSample);
 const std::string &gStr_outputMS = EidosRegisteredString("outputMS", gID_outputMS);
 const std::string &gStr_outputVCF = EidosRegisteredString("outputVCF", gID_outputVCF);
+const std::string &gStr_outputHaplotypes = EidosRegisteredString("outputHaplotypes", gID_outputHaplotypes);
 const std::string &gStr_output = EidosRegisteredString("output", gID_output);
 const std::string &gStr_evaluate = EidosRegisteredString("evaluate", gID_evaluate);
 const std::string &gStr_distance = EidosRegisteredString("distance", gID_distance);
@@ -1536,6 +1538,7 @@ const std::string &gStr_late = EidosRegisteredString("late", gID_late);
 const std::string &gStr_initialize = EidosRegisteredString("initialize", gID_initialize);
 const std::string &gStr_fitnessEffect = EidosRegisteredString("fitnessEffect", gID_fitnessEffect);
 const std::string &gStr_mutationEffect = EidosRegisteredString("mutationEffect", gID_mutationEffect);
+const std::string &gStr_mutationEffects = EidosRegisteredString("mutationEffects", gID_mutationEffects);
 const std::string &gStr_interaction = EidosRegisteredString("interaction", gID_interaction);
 const std::string &gStr_mateChoice = EidosRegisteredString("mateChoice", gID_mateChoice);
 const std::string &gStr_modifyChild = EidosRegisteredString("modifyChild", gID_modifyChild);
@@ -913,6 +913,7 @@ extern const std::string &gStr_mutationFrequencies;
 extern const std::string &gStr_mutationFrequenciesInGenomes;
 //extern const std::string &gStr_mutationsOfType;
 //extern const std::string &gStr_countOfMutationsOfType;
+extern const std::string &gStr_outputCheckpoint;
 extern const std::string &gStr_outputFixedMutations;
 extern const std::string &gStr_outputFull;
 extern const std::string &gStr_outputMutations;
@@ -991,6 +992,7 @@ extern const std::string &gStr_outputVCFSample;
 extern const std::string &gStr_outputSample;
 extern const std::string &gStr_outputMS;
 extern const std::string &gStr_outputVCF;
+extern const std::string &gStr_outputHaplotypes;
 extern const std::string &gStr_output;
 extern const std::string &gStr_evaluate;
 extern const std::string &gStr_distance;
@@ -1124,6 +1126,7 @@ extern const std::string &gStr_late;
 extern const std::string &gStr_initialize;
 extern const std::string &gStr_fitnessEffect;
 extern const std::string &gStr_mutationEffect;
+extern const std::string &gStr_mutationEffects;
 extern const std::string &gStr_interaction;
 extern const std::string &gStr_mateChoice;
 extern const std::string &gStr_modifyChild;
@@ -1331,6 +1334,7 @@ enum _SLiMGlobalStringID : int {
 	gID_mutationFrequenciesInGenomes,
 	//gID_mutationsOfType,
 	//gID_countOfMutationsOfType,
+	gID_outputCheckpoint,
 	gID_outputFixedMutations,
 	gID_outputFull,
 	gID_outputMutations,
@@ -1409,6 +1413,7 @@ enum _SLiMGlobalStringID : int {
 	gID_outputSample,
 	gID_outputMS,
 	gID_outputVCF,
+	gID_outputHaplotypes,
 	gID_output,
 	gID_evaluate,
 	gID_distance,
@@ -1539,6 +1544,7 @@ enum _SLiMGlobalStringID : int {
 	gID_initialize,
 	gID_fitnessEffect,
 	gID_mutationEffect,
+	gID_mutationEffects,
 	gID_interaction,
 	gID_mateChoice,
 	gID_modifyChild,
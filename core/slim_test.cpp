@@ -35,6 +35,10 @@
 #include <map>
 #include <utility>
 #include <ctime>
+#include <cmath>
+#include <cstring>
+#include <fstream>
+#include <sstream>
 
 
 // Keeping records of test success / failure
@@ -43,7 +47,7 @@ static int gSLiMTestFailureCount = 0;
 
 
 // Instantiates and runs the script, and prints an error if the result does not match expectations
-void SLiMAssertScriptSuccess(const std::string &p_script_string, int p_lineNumber)
+void SLiMAssertScriptSuccess(const std::string &p_script_string, int p_lineNumber, bool p_treeseq_crosschecks)
 {
 	{
 	gSLiMTestFailureCount++;	// assume failure; we will fix this at the end if we succeed
@@ -56,6 +60,11 @@ void SLiMAssertScriptSuccess(const std::string &p_script_string, int p_lineNumbe
 		community->InitializeFromFile(infile);
 		community->InitializeRNGFromSeed(nullptr);
 		community->FinishInitialization();
+		
+		// as with -TSXC, but without its log message; this exercises both the full and the sampled crosschecks
+		if (p_treeseq_crosschecks)
+			for (Species *species : community->AllSpecies())
+				species->TSXC_Enable();
 	}
 	catch (...)
 	{
@@ -298,9 +307,240 @@ void SLiMAssertScriptStop(const std::string &p_script_string, int p_lineNumber)
 	gEidos_DictionaryNonRetainReleaseReferenceCounter = 0;
 }
 
+// Run p_script_string to completion, restoring from p_restore_path first if it is non-empty; returns false and sets
+// p_failure on a raise.  Buffered file appends are flushed afterwards, so that the files written can be inspected.
+static bool _SLiMRunScriptForCheckpointTest(const std::string &p_script_string, const std::string &p_restore_path, std::string &p_failure)
+{
+	Community *community = nullptr;
+	std::istringstream infile(p_script_string);
+	bool success = true;
+	
+	try {
+		community = new Community();
+		community->InitializeFromFile(infile);
+		community->InitializeRNGFromSeed(nullptr);
+		community->FinishInitialization();
+		
+		if (p_restore_path.length())
+			community->RestoreFromCheckpoint(p_restore_path);
+		
+		while (community->_RunOneTick());
+	}
+	catch (...)
+	{
+		p_failure = Eidos_GetTrimmedRaiseMessage();
+		success = false;
+	}
+	
+	if (community)
+		for (Species *species : community->AllSpecies())
+			species->DeleteAllMutationRuns();
+	
+	delete community;
+	InteractionType::DeleteSparseVectorFreeList();
+	Eidos_FlushFiles();
+	
+	gEidosErrorContext.currentScript = nullptr;
+	gEidosErrorContext.executingRuntimeScript = false;
+	gEidos_DictionaryNonRetainReleaseReferenceCounter = 0;
+	
+	return success;
+}
+
+static std::string _SLiMReadTestFile(const std::string &p_file_path)
+{
+	std::ifstream file_stream(p_file_path, std::ios::in | std::ios::binary);
+	std::ostringstream contents;
+	
+	if (!file_stream.is_open())
+		return "<missing>";
+	
+	contents << file_stream.rdbuf();
+	return contents.str();
+}
+
+void SLiMAssertHaplotypesMatchMS(const std::string &p_hap_path, const std::string &p_ms_path, int p_lineNumber)
+{
+	// Read back a .hap file written by outputHaplotypes() (see Genome::WriteGenomes_Haplotypes() for the format), and check each
+	// record in it against the corresponding record of an MS file written by outputMS() for the same genomes: the same sites, at
+	// the same positions (scaled to [0,1] in MS), with the same genotypes.  Either file may contain several appended records.
+	std::string hap = _SLiMReadTestFile(p_hap_path);
+	std::ifstream ms_stream(p_ms_path);
+	const char *hap_ptr = hap.data(), *hap_end = hap.data() + hap.size();
+	std::string failure;
+	int record_count = 0;
+	
+	auto read_hap = [&hap_ptr, hap_end](void *p_dest, size_t p_size) {
+		if ((size_t)(hap_end - hap_ptr) < p_size)
+			return false;
+		memcpy(p_dest, hap_ptr, p_size);
+		hap_ptr += p_size;
+		return true;
+	};
+	
+	while (failure.empty() && (hap_ptr < hap_end))
+	{
+		char magic[8];
+		uint32_t version, endian_tag;
+		uint64_t genome_count, site_count;
+		int64_t last_position;
+		
+		if (!read_hap(magic, 8) || (memcmp(magic, "SLiMHaps", 8) != 0) || !read_hap(&version, 4) || (version != 1) || !read_hap(&endian_tag, 4) || (endian_tag != 0x12345678) ||
+			!read_hap(&genome_count, 8) || !read_hap(&site_count, 8) || !read_hap(&last_position, 8) || (last_position <= 0))
+		{
+			failure = "malformed .hap header";
+			break;
+		}
+		
+		std::vector<int64_t> positions(site_count), mutation_ids(site_count);
+		uint64_t block_count = (genome_count + 63) / 64;
+		std::vector<uint64_t> words(block_count * site_count);
+		
+		if (!read_hap(positions.data(), site_count * sizeof(int64_t)) || !read_hap(mutation_ids.data(), site_count * sizeof(int64_t)) || !read_hap(words.data(), words.size() * sizeof(uint64_t)))
+		{
+			failure = "truncated .hap record";
+			break;
+		}
+		
+		std::string line, token;
+		uint64_t ms_site_count;
+		
+		if (!std::getline(ms_stream, line) || (line != "//") || !(ms_stream >> token) || (token != "segsites:") || !(ms_stream >> ms_site_count) || (ms_site_count != site_count))
+		{
+			failure = "MS record header does not match";
+			break;
+		}
+		
+		if (site_count > 0)
+		{
+			if (!(ms_stream >> token) || (token != "positions:"))
+			{
+				failure = "MS positions line missing";
+				break;
+			}
+			
+			for (uint64_t site_index = 0; site_index < site_count; ++site_index)
+			{
+				double ms_position;
+				
+				if (!(ms_stream >> ms_position) || (std::fabs(ms_position - (double)positions[site_index] / last_position) > 1e-12))
+				{
+					failure = "site positions differ";
+					break;
+				}
+			}
+		}
+		
+		std::getline(ms_stream, line);		// the end of the last header line
+		
+		for (uint64_t genome_index = 0; failure.empty() && (genome_index < genome_count); ++genome_index)
+		{
+			if (!std::getline(ms_stream, line) || (line.length() != site_count))
+			{
+				failure = "MS genotype line missing or of the wrong length";
+				break;
+			}
+			
+			const uint64_t *block_words = words.data() + (genome_index / 64) * site_count;
+			
+			for (uint64_t site_index = 0; site_index < site_count; ++site_index)
+			{
+				bool hap_bit = (block_words[site_index] >> (genome_index % 64)) & 1;
+				
+				if (line[site_index] != (hap_bit ? '1' : '0'))
+				{
+					failure = "genotypes differ";
+					break;
+				}
+			}
+		}
+		
+		record_count++;
+	}
+	
+	if (failure.empty())
+	{
+		std::string line;
+		
+		if (record_count == 0)
+			failure = "no records in the .hap file";
+		else if (std::getline(ms_stream, line) && !line.empty())
+			failure = "the MS file has more records than the .hap file";
+	}
+	
+	if (failure.length())
+	{
+		gSLiMTestFailureCount++;
+		
+		if (p_lineNumber != -1)
+			std::cerr << "[" << p_lineNumber << "] ";
+		
+		std::cerr << p_hap_path << " vs. " << p_ms_path << " : " << EIDOS_OUTPUT_FAILURE_TAG << " : record " << record_count << ": " << failure << std::endl;
+		return;
+	}
+	
+	gSLiMTestSuccessCount++;
+}
+
+void SLiMAssertCheckpointRestore(const std::string &p_script_string, const std::string &p_checkpoint_path, const std::vector<std::string> &p_output_paths, const std::vector<std::string> &p_log_paths, int p_lineNumber)
+{
+	// Run p_script_string uninterrupted; it should write a checkpoint to p_checkpoint_path along the way, the files at
+	// p_output_paths by the end, and log files at p_log_paths.  Then run it again, restored from the checkpoint, and check
+	// that those files come out byte-for-byte the same as in the uninterrupted run.  Output files are removed before the
+	// restored run, so they must be written again; log files are kept, since the restore truncates them to their length
+	// at the checkpoint and logging continues from there.
+	std::string failure;
+	std::vector<std::string> compared_paths(p_output_paths);
+	std::vector<std::string> uninterrupted_contents;
+	
+	compared_paths.insert(compared_paths.end(), p_log_paths.begin(), p_log_paths.end());
+	
+	gSLiMTestFailureCount++;	// assume failure; we will fix this at the end if we succeed
+	
+	if (!_SLiMRunScriptForCheckpointTest(p_script_string, "", failure))
+	{
+		if (p_lineNumber != -1)
+			std::cerr << "[" << p_lineNumber << "] ";
+		
+		std::cerr << p_script_string << " : " << EIDOS_OUTPUT_FAILURE_TAG << " : raise during uninterrupted run: " << failure << std::endl;
+		return;
+	}
+	
+	for (const std::string &compared_path : compared_paths)
+		uninterrupted_contents.emplace_back(_SLiMReadTestFile(compared_path));
+	
+	for (const std::string &output_path : p_output_paths)
+		remove(output_path.c_str());
+	
+	if (!_SLiMRunScriptForCheckpointTest(p_script_string, p_checkpoint_path, failure))
+	{
+		if (p_lineNumber != -1)
+			std::cerr << "[" << p_lineNumber << "] ";
+		
+		std::cerr << p_script_string << " : " << EIDOS_OUTPUT_FAILURE_TAG << " : raise during restored run: " << failure << std::endl;
+		return;
+	}
+	
+	for (size_t path_index = 0; path_index < compared_paths.size(); ++path_index)
+	{
+		if (_SLiMReadTestFile(compared_paths[path_index]) != uninterrupted_contents[path_index])
+		{
+			if (p_lineNumber != -1)
+				std::cerr << "[" << p_lineNumber << "] ";
+			
+			std::cerr << p_script_string << " : " << EIDOS_OUTPUT_FAILURE_TAG << " : restored run wrote different contents to " << compared_paths[path_index] << std::endl;
+			return;
+		}
+	}
+	
+	gSLiMTestFailureCount--;	// correct for our assumption of failure above
+	gSLiMTestSuccessCount++;
+}
+
 
 // Test subfunction prototypes
 static void _RunBasicTests(void);
+static void _RunPackedNodeMetadataTests(void);
 static void _RunSLiMTimingTests(void);
 
 
@@ -368,6 +608,7 @@ int RunSLiMTests(void)
 	// Run tests
 	_RunBasicTests();
 	_RunRelatednessTests();
+	_RunPackedNodeMetadataTests();
 	_RunInitTests();
 	_RunCommunityTests();
 	_RunSpeciesTests(temp_path);
@@ -857,6 +1098,119 @@ void _RunRelatednessTests(void)
 	}
 }
 
+#pragma mark PackedNodeMetadata tests
+void _RunPackedNodeMetadataTests(void)
+{
+	// This tests the internal API of PackedNodeMetadata, which holds node metadata for Species while a model runs.  Nodes without
+	// metadata come only from loaded .trees files that were not made by SLiM, so these sequences can't easily be set up in script.
+	// Each sequence is pushed, with an optional truncation partway through, and every node is then read back and compared.
+	typedef struct packed_node_test_node_ {
+		bool present;
+		slim_genomeid_t genome_id;
+		uint8_t is_null;
+		GenomeType type;
+	} packed_node_test_node;
+	
+	typedef struct packed_node_test_info_ {
+		std::vector<packed_node_test_node> nodes;
+		size_t truncate_after;		// if non-zero, truncate to truncate_position after pushing this many nodes
+		size_t truncate_position;
+	} packed_node_test_info;
+	
+	const packed_node_test_node absent = {false, 0, 0, GenomeType::kAutosome};
+	std::vector<packed_node_test_info> tests = {
+		// genome id 0 sets the base of its block; a later node after a gap must not replace it
+		{{{true, 0, 0, GenomeType::kAutosome}, absent, {true, 37, 0, GenomeType::kAutosome}}, 0, 0},
+		{{absent, {true, 0, 1, GenomeType::kYChromosome}, absent, absent, {true, 5, 0, GenomeType::kXChromosome}}, 0, 0},
+		{{{true, 12, 0, GenomeType::kAutosome}, absent, {true, 0, 0, GenomeType::kAutosome}, absent, {true, 1000, 0, GenomeType::kAutosome}}, 0, 0},
+		
+		// ids far from the base, in either direction, and records that can't be packed
+		{{{true, 0, 0, GenomeType::kAutosome}, {true, ((slim_genomeid_t)1) << 40, 0, GenomeType::kAutosome}, absent, {true, -3, 0, GenomeType::kAutosome}, {true, 7, 2, GenomeType::kAutosome}}, 0, 0},
+		
+		// truncating back to nodes with and without metadata, as RetractNewIndividual() does
+		{{{true, 0, 0, GenomeType::kAutosome}, absent, {true, 50, 0, GenomeType::kAutosome}, absent, {true, 51, 0, GenomeType::kAutosome}}, 3, 2},
+		{{absent, {true, 0, 0, GenomeType::kAutosome}, absent, {true, 9, 0, GenomeType::kAutosome}}, 2, 1},
+		{{{true, 4, 0, GenomeType::kAutosome}, {true, 0, 0, GenomeType::kAutosome}, absent, {true, 8, 0, GenomeType::kAutosome}}, 2, 0}
+	};
+	
+	// sequences that span blocks: a full block without metadata, followed by genome id 0, a gap, and another id
+	{
+		packed_node_test_info spanning = {std::vector<packed_node_test_node>(256, absent), 0, 0};
+		
+		spanning.nodes.push_back({true, 0, 0, GenomeType::kAutosome});
+		spanning.nodes.push_back(absent);
+		spanning.nodes.push_back({true, 300, 0, GenomeType::kAutosome});
+		tests.push_back(spanning);
+		
+		spanning.truncate_after = 257;
+		spanning.truncate_position = 256;
+		tests.push_back(spanning);
+	}
+	
+	for (size_t test_index = 0; test_index < tests.size(); ++test_index)
+	{
+		const packed_node_test_info &test = tests[test_index];
+		std::vector<packed_node_test_node> expected_nodes;
+		PackedNodeMetadata packed;
+		
+		try {
+			for (size_t node_index = 0; node_index < test.nodes.size(); ++node_index)
+			{
+				const packed_node_test_node &node = test.nodes[node_index];
+				GenomeMetadataRec metadata_rec;
+				
+				metadata_rec.genome_id_ = node.genome_id;
+				metadata_rec.is_null_ = node.is_null;
+				metadata_rec.type_ = node.type;
+				
+				packed.push_back(node.present ? &metadata_rec : nullptr);
+				expected_nodes.push_back(node);
+				
+				if (test.truncate_after && (node_index + 1 == test.truncate_after))
+				{
+					packed.truncate(test.truncate_position);
+					expected_nodes.resize(test.truncate_position);
+				}
+			}
+			
+			bool matched = (packed.size() == expected_nodes.size());
+			
+			for (size_t node_index = 0; matched && (node_index < expected_nodes.size()); ++node_index)
+			{
+				const packed_node_test_node &node = expected_nodes[node_index];
+				GenomeMetadataRec metadata_rec;
+				bool present = packed.get(node_index, &metadata_rec);
+				
+				if (present != node.present)
+					matched = false;
+				else if (present && ((metadata_rec.genome_id_ != node.genome_id) || (metadata_rec.is_null_ != node.is_null) || (metadata_rec.type_ != node.type)))
+					matched = false;
+				
+				if (!matched)
+					std::cerr << "PackedNodeMetadata test " << EIDOS_OUTPUT_FAILURE_TAG << ": test index " << test_index << " read back the wrong metadata at node " << node_index << std::endl;
+			}
+			
+			if (matched)
+			{
+				gSLiMTestSuccessCount++;
+			}
+			else
+			{
+				gSLiMTestFailureCount++;
+				
+				if (packed.size() != expected_nodes.size())
+					std::cerr << "PackedNodeMetadata test " << EIDOS_OUTPUT_FAILURE_TAG << ": test index " << test_index << " has size " << packed.size() << " (" << expected_nodes.size() << " expected)" << std::endl;
+			}
+		}
+		catch (...)
+		{
+			gSLiMTestFailureCount++;
+			
+			std::cerr << "PackedNodeMetadata test " << EIDOS_OUTPUT_FAILURE_TAG << ": test index " << test_index << " raised an exception: " << Eidos_GetTrimmedRaiseMessage() << std::endl;
+		}
+	}
+}
+
 #pragma mark SLiM timing tests
 void _RunSLiMTimingTests(void)
 {
@@ -22,15 +22,18 @@
 
 #include <stdio.h>
 #include <string>
+#include <vector>
 
 
 int RunSLiMTests(void);
 
 
 // Helper functions for testing
-extern void SLiMAssertScriptSuccess(const std::string &p_script_string, int p_lineNumber = -1);
+extern void SLiMAssertScriptSuccess(const std::string &p_script_string, int p_lineNumber = -1, bool p_treeseq_crosschecks = false);
 extern void SLiMAssertScriptRaise(const std::string &p_script_string, const std::string &p_reason_snip, int p_lineNumber, bool p_expect_error_position = true);
 extern void SLiMAssertScriptStop(const std::string &p_script_string, int p_lineNumber = -1);
+extern void SLiMAssertHaplotypesMatchMS(const std::string &p_hap_path, const std::string &p_ms_path, int p_lineNumber = -1);
+extern void SLiMAssertCheckpointRestore(const std::string &p_script_string, const std::string &p_checkpoint_path, const std::vector<std::string> &p_output_paths, const std::vector<std::string> &p_log_paths, int p_lineNumber = -1);
 
 
 // Conceptually, all the slim_test_X.cpp stuff is a single source file, and all the details below are private.
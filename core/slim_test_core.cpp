@@ -324,6 +324,11 @@ void _RunCommunityTests(void)
 	SLiMAssertScriptStop(gen1_setup_p1 + "2 early() { if (identical(community.allSpecies, sim)) stop(); } ", __LINE__);
 	SLiMAssertScriptStop(gen1_setup_p1 + "2 early() { if (identical(community.allSubpopulations, p1)) stop(); } ", __LINE__);
 	SLiMAssertScriptStop(gen1_setup_p1 + "2 early() { if (community.logFiles.size() == 0) stop(); } ", __LINE__);
+	
+	// identifier nodes in callbacks bind to the constants they resolve to; the bindings must see constants and subpopulations come and go
+	SLiMAssertScriptStop(gen1_setup_p1 + "1 early() { defineConstant('K', 3); sim.setValue('s', 0); } modifyChild() { sim.setValue('s', sim.getValue('s') + K + (exists('L') ? L else 0)); return T; } 5 early() { defineConstant('L', 100); } 10 late() { if (sim.getValue('s') == 4*10*3 + 6*10*103) stop(); }", __LINE__);
+	SLiMAssertScriptStop(gen1_setup_p1 + "1 early() { sim.setValue('n', integer(0)); } 3 early() { sim.addSubpop('p2', 4); } 5 early() { p2.setSubpopulationSize(0); } 2:7 late() { sim.setValue('n', c(sim.getValue('n'), exists('p2') ? p2.individualCount else -1)); } 7 late() { if (identical(sim.getValue('n'), c(-1, 4, 4, -1, -1, -1))) stop(); }", __LINE__);
+	SLiMAssertScriptRaise(gen1_setup_p1 + "3 early() { sim.addSubpop('p2', 4); } 5 early() { p2.setSubpopulationSize(0); } 3:7 late() { p2.individualCount; }", "undefined identifier p2", __LINE__);
 	SLiMAssertScriptStop(gen1_setup_p1 + "2 early() { if (community.tick == 2) stop(); } ", __LINE__);
 	SLiMAssertScriptStop(gen1_setup_p1 + "2 early() { community.tag = 10; if (community.tag == 10) stop(); } ", __LINE__);
 	
@@ -583,6 +588,15 @@ void _RunSpeciesTests(const std::string &temp_path)
 		SLiMAssertScriptRaise(gen1_setup + "1 early() { sim.readFromPopulationFile('" + temp_path + "/notAFile.foo'); }", "does not exist or is empty", __LINE__);
 		SLiMAssertScriptSuccess(gen1_setup_p1 + "1 early() { sim.readFromPopulationFile('" + temp_path + "/slimOutputFullTest.txt'); if (size(sim.subpopulations) != 3) stop(); }", __LINE__);			// legal; should wipe previous state
 		SLiMAssertScriptSuccess(gen1_setup_p1 + "1 early() { sim.readFromPopulationFile('" + temp_path + "/slimOutputFullTest.slimbinary'); if (size(sim.subpopulations) != 3) stop(); }", __LINE__);	// legal; should wipe previous state
+		
+		// binary round trips should reproduce the text output exactly (apart from the #OUT line, which contains the file path), including
+		// when the reading model lays out its mutation runs differently, so that runs have to be reassembled from the file's runs
+		std::string round_trip_check = "a = readFile('" + temp_path + "/slimRoundTrip1.txt'); b = readFile('" + temp_path + "/slimRoundTrip2.txt'); if ((size(a) < 5) | (sum(a != b) != 1)) stop('mismatch'); ";
+		
+		SLiMAssertScriptSuccess(gen1_setup_highmut_p1 + "1 early() { sim.addSubpop('p2', 5); } 20 late() { sim.outputFull('" + temp_path + "/slimRoundTrip1.txt'); sim.outputFull('" + temp_path + "/slimRoundTrip.slimbinary', T); sim.readFromPopulationFile('" + temp_path + "/slimRoundTrip.slimbinary'); sim.outputFull('" + temp_path + "/slimRoundTrip2.txt'); " + round_trip_check + "}", __LINE__);
+		SLiMAssertScriptSuccess("initialize() { initializeSex('X'); } " + gen1_setup_highmut_p1 + "20 late() { sim.outputFull('" + temp_path + "/slimRoundTrip1.txt'); sim.outputFull('" + temp_path + "/slimRoundTrip.slimbinary', T); sim.readFromPopulationFile('" + temp_path + "/slimRoundTrip.slimbinary'); sim.outputFull('" + temp_path + "/slimRoundTrip2.txt'); " + round_trip_check + "}", __LINE__);
+		SLiMAssertScriptSuccess("initialize() { initializeSLiMOptions(mutationRuns=4); } " + gen1_setup_highmut_p1 + "20 late() { sim.outputFull('" + temp_path + "/slimRoundTrip1.txt'); sim.outputFull('" + temp_path + "/slimRoundTrip.slimbinary', T); }", __LINE__);
+		SLiMAssertScriptSuccess("initialize() { initializeSLiMOptions(mutationRuns=7); } " + gen1_setup + "1 late() { sim.readFromPopulationFile('" + temp_path + "/slimRoundTrip.slimbinary'); sim.outputFull('" + temp_path + "/slimRoundTrip2.txt'); " + round_trip_check + "}", __LINE__);
 	}
 	
 	// Test sim - (object<SLiMEidosBlock>)registerFirstEvent(Nis$ id, string$ source, [integer$ start], [integer$ end])
@@ -743,9 +757,28 @@ void _RunSpeciesTests(const std::string &temp_path)
 	//SLiMAssertScriptStop(gen1_setup_p1 + "1 early() { b = community.rescheduleScriptBlock(1, ticks=c(25:28, 35)); r = sapply(b, 'applyValue.start:applyValue.end;'); if (identical(r, c(25:28, 35))) stop(); } s1 10 early() { }", __LINE__);
 	//SLiMAssertScriptStop(gen1_setup_p1 + "1 early() { b = community.rescheduleScriptBlock(1, ticks=c(13, 25:28)); r = sapply(b, 'applyValue.start:applyValue.end;'); if (identical(r, c(13, 25:28))) stop(); } s1 10 early() { }", __LINE__);
 	
-	// Test Community - (object<LogFile>$)createLogFile(string$ filePath, [Ns initialContents = NULL], [logical$ append = F], [logical$ compress = F], [string$ sep = ","], [Ni$ logInterval = NULL], [Ni$ flushInterval = NULL])
+	// Test Community - (object<LogFile>$)createLogFile(string$ filePath, [Ns initialContents = NULL], [logical$ append = F], [logical$ compress = F], [string$ sep = ","], [Ni$ logInterval = NULL], [Ni$ flushInterval = NULL], [string$ format = "text"])
 	if (Eidos_TemporaryDirectoryExists())
+	{
 		SLiMAssertScriptSuccess(gen1_setup_p1p2p3 + "1 late() { path = '" + temp_path + "/slimLogFileTest.txt'; log = community.createLogFile(path, initialContents='# HEADER COMMENT', logInterval=1); log.addTick(); log.addCycle(); log.addSubpopulationSize(p1); } 10 late() { }", __LINE__);
+		SLiMAssertScriptStop(gen1_setup_p1p2p3 + "1 late() { for (f in c('text', 'binary')) { log = community.createLogFile('" + temp_path + "/slimLogFileTest_' + f + '.txt', initialContents='# HEADER COMMENT', logInterval=1, flushInterval=(f == 'binary') ? 4 else NULL, format=f); log.addTick(); log.addCycleStage(); log.addSubpopulationSize(p1); log.addCustomColumn('x', 'm = integerMod(community.tick, 3); if (m == 0) NULL; else if (m == 1) 1.5 * community.tick; else \"s\";'); } } 10 late() { community.logFiles.flush(); convertLogFile('" + temp_path + "/slimLogFileTest_binary.txt', '" + temp_path + "/slimLogFileTest_converted.txt'); if (identical(readFile('" + temp_path + "/slimLogFileTest_text.txt'), readFile('" + temp_path + "/slimLogFileTest_converted.txt'))) stop(); }", __LINE__);
+		SLiMAssertScriptRaise(gen1_setup_p1p2p3 + "1 late() { community.createLogFile('" + temp_path + "/slimLogFileTest.txt', compress=T, format='binary'); }", "does not support compression", __LINE__);
+	}
+	
+	// Test Community - (void)outputCheckpoint(string$ filePath)
+	if (Eidos_TemporaryDirectoryExists())
+	{
+		SLiMAssertScriptStop(gen1_setup_p1p2p3 + "5 late() { community.outputCheckpoint('" + temp_path + "/slimCheckpointTest.ckpt'); defineGlobal('d', Dictionary('x', 1:3)); community.setValue('d', d); } 6 early() { if (fileExists('" + temp_path + "/slimCheckpointTest.ckpt') & !fileExists('" + temp_path + "/slimCheckpointTest.ckpt.tmp')) stop(); }", __LINE__);
+		SLiMAssertScriptRaise(gen1_setup_p1 + "1 late() { community.setValue('img', Image(matrix(rep(0, 4), 2, 2))); community.outputCheckpoint('" + temp_path + "/slimCheckpointTest.ckpt'); }", "cannot be saved in a checkpoint", __LINE__, false);
+		SLiMAssertScriptRaise("initialize() { initializeTreeSeq(); } " + gen1_setup_p1 + "1 late() { community.outputCheckpoint('" + temp_path + "/slimCheckpointTest.ckpt'); }", "tree-sequence recording", __LINE__);
+		
+		// a restored run must match the uninterrupted run: RNG state, mutations, globals, Dictionary values, and log files
+		std::string checkpoint_path = temp_path + "/slimCheckpointTest_restore.ckpt";
+		std::string summary_path = temp_path + "/slimCheckpointTest_summary.txt";
+		std::string log_path = temp_path + "/slimCheckpointTest_log.txt";
+		
+		SLiMAssertCheckpointRestore(gen1_setup_highmut_p1 + "1 late() { defineGlobal('total', 0); community.setValue('ticks', integer(0)); sim.setValue('dict', Dictionary('x', 1.5)); log = community.createLogFile('" + log_path + "', logInterval=1); log.addTick(); log.addSubpopulationSize(p1); log.addCustomColumn('muts', 'sim.mutations.size();'); log.addCustomColumn('draw', 'runif(1);'); } 1:10 late() { defineGlobal('total', total + rdunif(1, 0, 1000)); community.setValue('ticks', c(community.getValue('ticks'), community.tick)); sim.getValue('dict').setValue('y' + community.tick, p1.individuals.countOfMutationsOfType(m1)); } 5 late() { community.outputCheckpoint('" + checkpoint_path + "'); } 10 late() { m = sim.mutations; m = m[order(m.id)]; writeFile('" + summary_path + "', c(paste(rdunif(5, 0, 1000000000)), paste(m.id), paste(m.position), paste(m.originTick), paste(total), paste(community.getValue('ticks')), sim.getValue('dict').serialize('json'))); }", checkpoint_path, {summary_path}, {log_path}, __LINE__);
+	}
 	
 	// Test Community - (void)simulationFinished(void)
 	SLiMAssertScriptStop(gen1_setup_p1 + "11 early() { stop(); }", __LINE__);
@@ -1120,6 +1153,10 @@ void _RunSubpopulationTests(void)
 	SLiMAssertScriptStop(gen1_setup_sex_p1 + "1 late() { p1.outputMSSample(1, F, '*'); stop(); }", __LINE__);
 	SLiMAssertScriptRaise(gen1_setup_sex_p1 + "1 late() { p1.outputMSSample(1, F, 'Z'); stop(); }", "requested sex", __LINE__);
 	
+	// a sample without replacement of every genome should contain each genome exactly once
+	SLiMAssertScriptStop(gen1_setup_p1 + "1 late() { p1.genomes.removeMutations(); p1.genomes[0:2].addNewMutation(m1, 0.0, 10); f = writeTempFile('slim_test_', '.txt', ''); p1.outputMSSample(20, F, filePath=f); lines = readFile(f); if (sum(lines == '1') == 3 & sum(lines == '0') == 17) stop(); }", __LINE__);
+	SLiMAssertScriptStop(gen1_setup_p1 + "1 late() { p1.genomes.removeMutations(); p1.genomes.addNewMutation(m1, 0.0, 10); p1.genomes[0].addNewMutation(m1, 0.0, 20); f = writeTempFile('slim_test_', '.txt', ''); p1.outputMSSample(20, F, filePath=f, filterMonomorphic=T); lines = readFile(f); if (lines[1] == 'segsites: 1' & sum(lines == '1') == 1) stop(); }", __LINE__);
+	
 	// Test Subpopulation - (void)outputSample(integer$ sampleSize, [logical$ replace], [string$ requestedSex])
 	SLiMAssertScriptStop(gen1_setup_p1 + "1 late() { p1.outputSample(1); stop(); }", __LINE__);
 	SLiMAssertScriptStop(gen1_setup_p1 + "1 late() { p1.outputSample(1, F); stop(); }", __LINE__);
@@ -1153,6 +1190,8 @@ void _RunSubpopulationTests(void)
 	SLiMAssertScriptStop(gen1_setup_sex_p1 + "1 late() { p1.outputSample(1, F, '*'); stop(); }", __LINE__);
 	SLiMAssertScriptRaise(gen1_setup_sex_p1 + "1 late() { p1.outputSample(1, F, 'Z'); stop(); }", "requested sex", __LINE__);
 	
+	SLiMAssertScriptStop(gen1_setup_p1 + "1 late() { p1.genomes.removeMutations(); p1.genomes[0:2].addNewMutation(m1, 0.0, 10); f = writeTempFile('slim_test_', '.txt', ''); p1.outputSample(20, F, filePath=f); lines = readFile(f); if (size(grep(' 10 0 0.5 p1 1 3$', lines)) == 1 & size(grep(' 0$', lines)) == 3) stop(); }", __LINE__);
+	
 	// Test Subpopulation - (void)outputVCFSample(integer$ sampleSize, [logical$ replace], [string$ requestedSex], [logical$ outputMultiallelics)
 	SLiMAssertScriptStop(gen1_setup_p1 + "1 late() { p1.outputVCFSample(1); stop(); }", __LINE__);
 	SLiMAssertScriptStop(gen1_setup_p1 + "1 late() { p1.outputVCFSample(1, F); stop(); }", __LINE__);
@@ -1175,6 +1214,8 @@ void _RunSubpopulationTests(void)
 	SLiMAssertScriptRaise(gen1_setup_p1 + "1 late() { p1.outputVCFSample(5, F, 'M', T); stop(); }", "non-sexual simulation", __LINE__);
 	SLiMAssertScriptRaise(gen1_setup_p1 + "1 late() { p1.outputVCFSample(5, F, 'F', T); stop(); }", "non-sexual simulation", __LINE__);
 	SLiMAssertScriptStop(gen1_setup_p1 + "1 late() { p1.outputVCFSample(5, F, '*', T); stop(); }", __LINE__);
+	SLiMAssertScriptRaise(gen1_setup_p1 + "1 late() { p1.outputVCFSample(5, compress=T); stop(); }", "requires a filePath", __LINE__);
+	SLiMAssertScriptStop(gen1_setup_p1 + "1 late() { p1.genomes.removeMutations(); p1.genomes[0:2].addNewMutation(m1, 0.0, 10); f = writeTempFile('slim_test_', '.txt', ''); p1.outputVCFSample(10, F, filePath=f); lines = readFile(f); if (size(grep(';AC=3;', lines)) == 1) stop(); }", __LINE__);
 	
 	SLiMAssertScriptStop(gen1_setup_sex_p1 + "1 late() { p1.outputVCFSample(1); stop(); }", __LINE__);
 	SLiMAssertScriptStop(gen1_setup_sex_p1 + "1 late() { p1.outputVCFSample(1, F); stop(); }", __LINE__);
@@ -2123,6 +2164,18 @@ void _RunSLiMEidosBlockTests(void)
 	SLiMAssertScriptRaise(gen1_setup_p1p2p3 + "mutationEffect(m1) { mut; return 'a'; } 100 early() { ; }", "return value", __LINE__);
 	SLiMAssertScriptRaise(gen1_setup_p1p2p3 + "mutationEffect(m1) { mut; return mut; } 100 early() { ; }", "return value", __LINE__);
 	
+	// mutationEffects() callbacks, the vectorized form, which should produce the same fitness values as the equivalent mutationEffect() callbacks
+	SLiMAssertScriptStop(gen1_setup_p1p2p3 + "mutationEffects(m1) { return effect; } 100 early() { stop(); }", __LINE__);
+	SLiMAssertScriptStop(gen1_setup_p1p2p3 + "mutationEffects(m1) { stop(); } 100 early() { ; }", __LINE__);
+	SLiMAssertScriptStop(gen1_setup_p1p2p3 + "mutationEffects(m1, p1) { if (size(mut) == size(effect) & size(mut) == size(homozygous) & size(mut) == size(individual) & all(individual.subpopulation == subpop)) stop(); return 1.0; } 100 early() { ; }", __LINE__);
+	SLiMAssertScriptSuccess(gen1_setup_p1p2p3 + "mutationEffects(m2) { stop(); } 100 early() { ; }", __LINE__);
+	SLiMAssertScriptSuccess(gen1_setup_p1p2p3 + "early() { s1.active = 0; } s1 mutationEffects(m1) { stop(); } 100 early() { ; }", __LINE__);
+	SLiMAssertScriptRaise(gen1_setup_p1p2p3 + "mutationEffects(m1) { return c(effect, 1.0); } 100 early() { ; }", "same length as effect", __LINE__);
+	SLiMAssertScriptRaise(gen1_setup_p1p2p3 + "mutationEffects(m1) { return 1; } 100 early() { ; }", "same length as effect", __LINE__);
+	SLiMAssertScriptStop(gen1_setup_p1p2p3 + "s1 mutationEffect(m1) { return (homozygous ? 1.5 else 1.2) * effect + individual.index * 0.01; } s2 mutationEffects(m1) { return ifelse(homozygous, 1.5, 1.2) * effect + individual.index * 0.01; } s3 mutationEffects(m1) { return effect * 0.9; } early() { s2.active = 0; s3.active = 0; } 50 early() { sim.recalculateFitness(); f1 = p1.cachedFitness(NULL); s1.active = 0; s2.active = 1; sim.recalculateFitness(); f2 = p1.cachedFitness(NULL); s1.active = 1; s2.active = 0; s3.active = 1; sim.recalculateFitness(); f3 = p1.cachedFitness(NULL); s1.active = 0; s2.active = 1; sim.recalculateFitness(); f4 = p1.cachedFitness(NULL); if (all(abs(f1 - f2) < 1e-9) & all(abs(f3 - f4) < 1e-9)) stop(); }", __LINE__);
+	SLiMAssertScriptStop("initialize() { initializeMutationRate(1e-5); initializeMutationType('m1', 0.5, 'f', 0.0); initializeGenomicElementType('g1', m1, 1.0); initializeGenomicElement(g1, 0, 99999); initializeRecombinationRate(1e-8); initializeSex('X'); } 1 early() { sim.addSubpop('p1', 20); } s1 mutationEffect(m1) { return (isNULL(homozygous) ? 0.5 else (homozygous ? 1.5 else 1.2)); } s2 mutationEffects(m1) { return ifelse(homozygous, 1.5, ifelse(individual.sex == 'M', 0.5, 1.2)); } early() { s2.active = 0; } 50 early() { sim.recalculateFitness(); f1 = p1.cachedFitness(NULL); s1.active = 0; s2.active = 1; sim.recalculateFitness(); f2 = p1.cachedFitness(NULL); if (all(abs(f1 - f2) < 1e-9)) stop(); }", __LINE__);
+	SLiMAssertScriptStop(gen1_setup_p1p2p3 + "1 early() { sim.registerMutationEffectCallback('s1', '{ if (size(effect) > 1) stop(); return effect; }', m1, vectorized=T); } 100 early() { ; }", __LINE__);
+	
 	SLiMAssertScriptStop(gen1_setup_p1p2p3 + "mutationEffect(m1) { mut; homozygous; individual; subpop; return effect; } 100 early() { stop(); }", __LINE__);
 	
 	// mateChoice() callbacks
@@ -875,6 +875,24 @@ void _RunGenomeTests(const std::string &temp_path)
 		SLiMAssertScriptRaise(gen1_setup_sex_p1 + "10 late() { sample(p1.genomes, 100, T).outputMS('" + temp_path + "/slimOutputMSTest4.txt'); stop(); }", "cannot output null genomes", __LINE__);
 		SLiMAssertScriptStop(gen1_setup_sex_p1 + "10 late() { sample(p1.genomes[!p1.genomes.isNullGenome], 100, T).outputMS('" + temp_path + "/slimOutputMSTest5.txt'); stop(); }", __LINE__);
 	}
+	SLiMAssertScriptStop(gen1_setup_p1 + "1 late() { p1.genomes.removeMutations(); p1.genomes[c(0, 5)].addNewMutation(m1, 0.0, 10); p1.genomes.addNewMutation(m1, 0.0, 20); p1.genomes[1].addNewMutation(m1, 0.0, 5); f = writeTempFile('slim_test_', '.txt', ''); p1.genomes.outputMS(f, filterMonomorphic=T); lines = readFile(f); if (lines[1] == 'segsites: 2' & lines[3] == '01' & lines[4] == '10' & lines[8] == '01' & sum(lines == '00') == size(p1.genomes) - 3) stop(); }", __LINE__);
+	
+	// Test Genome + (void)outputHaplotypes(string$ filePath, [logical$ append = F], [logical$ filterMonomorphic = F])
+	if (Eidos_TemporaryDirectoryExists())
+	{
+		SLiMAssertScriptRaise(gen1_setup_p1 + "10 late() { sample(p1.genomes, 0, T).outputHaplotypes('" + temp_path + "/slimOutputHaplotypesTest1.hap'); stop(); }", "at least one genome is required", __LINE__);
+		SLiMAssertScriptStop(gen1_setup_p1 + "10 late() { sample(p1.genomes, 100, T).outputHaplotypes('" + temp_path + "/slimOutputHaplotypesTest2.hap'); p1.genomes.outputHaplotypes('" + temp_path + "/slimOutputHaplotypesTest2.hap', append=T, filterMonomorphic=T); if (fileExists('" + temp_path + "/slimOutputHaplotypesTest2.hap')) stop(); }", __LINE__);
+		SLiMAssertScriptRaise(gen1_setup_sex_p1 + "10 late() { sample(p1.genomes, 100, T).outputHaplotypes('" + temp_path + "/slimOutputHaplotypesTest3.hap'); stop(); }", "cannot output null genomes", __LINE__);
+		SLiMAssertScriptStop(gen1_setup_sex_p1 + "10 late() { sample(p1.genomes[!p1.genomes.isNullGenome], 100, T).outputHaplotypes('" + temp_path + "/slimOutputHaplotypesTest4.hap'); stop(); }", __LINE__);
+		
+		// read the .hap files back and check them against outputMS() for the same genomes, with more than one block of 64 genomes
+		std::string hap_path = temp_path + "/slimOutputHaplotypesTest5.hap", ms_path = temp_path + "/slimOutputHaplotypesTest5.txt";
+		
+		SLiMAssertScriptSuccess(gen1_setup_highmut_p1 + "10 late() { g = sample(p1.genomes, 150, T); g.outputHaplotypes('" + hap_path + "'); g.outputMS('" + ms_path + "'); g = c(p1.genomes[0:2], p1.genomes[0]); g.outputHaplotypes('" + hap_path + "', append=T, filterMonomorphic=T); g.outputMS('" + ms_path + "', append=T, filterMonomorphic=T); }", __LINE__);
+		SLiMAssertHaplotypesMatchMS(hap_path, ms_path, __LINE__);
+		SLiMAssertScriptSuccess(gen1_setup_sex_p1 + "10 late() { g = p1.genomes[!p1.genomes.isNullGenome]; g.outputHaplotypes('" + hap_path + "'); g.outputMS('" + ms_path + "'); }", __LINE__);
+		SLiMAssertHaplotypesMatchMS(hap_path, ms_path, __LINE__);
+	}
 	
 	// Test Genome + (void)output([Ns$ filePath])
 	SLiMAssertScriptRaise(gen1_setup_p1 + "10 late() { sample(p1.genomes, 0, T).output(); stop(); }", "at least one genome is required", __LINE__);
@@ -917,6 +935,16 @@ void _RunGenomeTests(const std::string &temp_path)
 	{
 		SLiMAssertScriptStop(gen1_setup_sex_p1 + "10 late() { sample(p1.individuals, 100, T).genomes.outputVCF('" + temp_path + "/slimOutputVCFTest8.txt', F); stop(); }", __LINE__);
 	}
+	
+	// Test Genome + (void)outputVCF(..., [logical$ compress = F]), which writes BGZF and requires a file path
+	SLiMAssertScriptRaise(gen1_setup_p1 + "10 late() { sample(p1.individuals, 100, T).genomes.outputVCF(compress=T); stop(); }", "requires a filePath", __LINE__);
+	if (Eidos_TemporaryDirectoryExists())
+	{
+		SLiMAssertScriptSuccess(gen1_setup_highmut_p1 + "10 late() { path = '" + temp_path + "/slimOutputVCFTest9.vcf'; p1.genomes.outputVCF(path, compress=T); if (!fileExists(path + '.gz')) stop('missing'); plain = '" + temp_path + "/slimOutputVCFTest9_plain.vcf'; p1.genomes.outputVCF(plain); if (!identical(readFile(path + '.gz'), readFile(plain))) stop('content'); }", __LINE__);
+		SLiMAssertScriptSuccess(gen1_setup_sex_p1 + "10 late() { path = '" + temp_path + "/slimOutputVCFTest10.vcf.gz'; p1.genomes.outputVCF(path, compress=T); p1.genomes.outputVCF(path, append=T, compress=T); if (!fileExists(path)) stop('missing'); if (fileExists(path + '.gz')) stop('double suffix'); plain = '" + temp_path + "/slimOutputVCFTest10_plain.vcf'; p1.genomes.outputVCF(plain); p1.genomes.outputVCF(plain, append=T); if (!identical(readFile(path), readFile(plain))) stop('content'); }", __LINE__);
+		SLiMAssertScriptSuccess(gen1_setup_highmut_p1 + "10 late() { path = '" + temp_path + "/slimReadVCFTest1.vcf.gz'; p1.genomes.outputVCF(path, compress=T); sim.addSubpop('p2', 10); p2.genomes.readFromVCF(path, m1); if (!identical(p1.genomes.countOfMutationsOfType(m1), p2.genomes.countOfMutationsOfType(m1))) stop('counts'); if (!identical(sort(p1.genomes.mutations.position), sort(p2.genomes.mutations.position))) stop('positions'); }", __LINE__);
+		SLiMAssertScriptSuccess(gen1_setup_highmut_p1 + "10 late() { path = '" + temp_path + "/slimReadMSTest1.txt'; p1.genomes.outputMS(path); writeFile(path + '.gz', readFile(path), compress=T); sim.addSubpop('p2', 10); p2.genomes.readFromMS(path + '.gz', m1); if (!identical(p1.genomes.countOfMutationsOfType(m1), p2.genomes.countOfMutationsOfType(m1))) stop('counts'); }", __LINE__);
+	}
 }
 
 
@@ -2073,6 +2073,22 @@ void _RunTreeSeqTests(const std::string &temp_path)
 	SLiMAssertScriptStop("initialize() { initializeTreeSeq(recordMutations=T, simplificationRatio=INF, checkCoalescence=F, runCrosschecks=T); } " + gen1_setup_p1 + "100 early() { stop(); }", __LINE__);
 	SLiMAssertScriptStop("initialize() { initializeTreeSeq(recordMutations=F, simplificationRatio=0.0, checkCoalescence=F, runCrosschecks=T); } " + gen1_setup_p1 + "100 early() { stop(); }", __LINE__);
 	SLiMAssertScriptStop("initialize() { initializeTreeSeq(recordMutations=T, simplificationRatio=0.0, checkCoalescence=F, runCrosschecks=T); } " + gen1_setup_p1 + "100 early() { stop(); }", __LINE__);
+	SLiMAssertScriptStop("initialize() { initializeTreeSeq(simplificationRatio=INF, runCrosschecks=T, tableMemoryLimit=0.01); } " + gen1_setup_p1 + "100 early() { stop(); }", __LINE__);
+	SLiMAssertScriptStop("initialize() { initializeTreeSeq(simplificationRatio=10.0, runCrosschecks=T, tableMemoryLimit=0.01); } " + gen1_setup_p1 + "100 early() { stop(); }", __LINE__);
+	SLiMAssertScriptStop("initialize() { initializeTreeSeq(tableMemoryLimit=INF); } " + gen1_setup_p1 + "100 early() { stop(); }", __LINE__);
+	SLiMAssertScriptRaise("initialize() { initializeTreeSeq(tableMemoryLimit=-1); } " + gen1_setup_p1 + "100 early() { stop(); }", "tableMemoryLimit to be >= 0", __LINE__);
+	
+	// tableMemoryLimit should actually bound the tables: with automatic simplification otherwise off, the node and edge tables
+	// stay small and shrink whenever the limit is crossed, whereas without the limit they grow every tick
+	if (Eidos_TemporaryDirectoryExists())
+	{
+		std::string table_rows_setup("function (i)tableRows(s path, s table) { lines = readFile(path + '/' + table + '.txt'); return size(lines) - 1 - which(substr(lines, 0, 2) == 'id\\t'); } ");
+		std::string table_rows_record("1:60 late() { path = '" + temp_path + "/SLiM_treeSeq_limit.trees'; sim.treeSeqOutput(path, simplify=F, _binary=F); sim.setValue('N', c(sim.getValue('N'), tableRows(path, 'NodeTable'))); sim.setValue('E', c(sim.getValue('E'), tableRows(path, 'EdgeTable'))); } ");
+		
+		SLiMAssertScriptStop(table_rows_setup + "initialize() { initializeTreeSeq(simplificationRatio=INF, tableMemoryLimit=0.01); } " + gen1_setup_p1 + table_rows_record + "60 late() { N = sim.getValue('N'); edges = sim.getValue('E'); if ((max(N) <= 400) & (max(edges) <= 400) & any(N[1:59] < N[0:58]) & any(edges[1:59] < edges[0:58])) stop(); }", __LINE__);
+		SLiMAssertScriptStop(table_rows_setup + "initialize() { initializeTreeSeq(simplificationRatio=INF); } " + gen1_setup_p1 + table_rows_record + "60 late() { N = sim.getValue('N'); edges = sim.getValue('E'); if ((max(N) > 400) & (max(edges) > 400) & all(N[1:59] > N[0:58])) stop(); }", __LINE__);
+	}
+	
 	SLiMAssertScriptStop("initialize() { initializeTreeSeq(recordMutations=F, simplificationRatio=10.0, checkCoalescence=T, runCrosschecks=T); } " + gen1_setup_p1 + "100 early() { stop(); }", __LINE__);
 	SLiMAssertScriptStop("initialize() { initializeTreeSeq(recordMutations=T, simplificationRatio=10.0, checkCoalescence=T, runCrosschecks=T); } " + gen1_setup_p1 + "100 early() { stop(); }", __LINE__);
 	SLiMAssertScriptStop("initialize() { initializeTreeSeq(recordMutations=F, simplificationRatio=INF, checkCoalescence=T, runCrosschecks=T); } " + gen1_setup_p1 + "100 early() { stop(); }", __LINE__);
@@ -2080,9 +2096,14 @@ void _RunTreeSeqTests(const std::string &temp_path)
 	SLiMAssertScriptStop("initialize() { initializeTreeSeq(recordMutations=F, simplificationRatio=0.0, checkCoalescence=T, runCrosschecks=T); } " + gen1_setup_p1 + "100 early() { stop(); }", __LINE__);
 	SLiMAssertScriptStop("initialize() { initializeTreeSeq(recordMutations=T, simplificationRatio=0.0, checkCoalescence=T, runCrosschecks=T); } " + gen1_setup_p1 + "100 early() { stop(); }", __LINE__);
 	
+	// sampled crosschecks of sites against genomes, as run by -TSXC in the cycles between its full crosschecks
+	SLiMAssertScriptSuccess(gen1_setup_highmut_p1 + "120 late() { }", __LINE__, true);
+	SLiMAssertScriptSuccess("initialize() { initializeSex('X'); } " + gen1_setup_highmut_p1 + "30 late() { muts = p1.genomes[0].mutations; if (size(muts)) p1.genomes[0].removeMutations(muts[0]); } 120 late() { }", __LINE__, true);
+	
 	// treeSeqCoalesced()
 	SLiMAssertScriptRaise("initialize() { initializeTreeSeq(); } " + gen1_setup_p1 + "1: early() { sim.treeSeqCoalesced(); } 100 early() { stop(); }", "coalescence checking is enabled", __LINE__);
 	SLiMAssertScriptStop("initialize() { initializeTreeSeq(checkCoalescence=T); } " + gen1_setup_p1 + "1: early() { sim.treeSeqCoalesced(); } 100 early() { stop(); }", __LINE__);
+	SLiMAssertScriptSuccess("initialize() { initializeTreeSeq(simplificationInterval=1, checkCoalescence=T); } " + gen1_setup_p1 + "1:400 late() { if (sim.treeSeqCoalesced()) defineGlobal('seen', T); else if (exists('seen')) stop('uncoalesced again'); } 400 late() { if (!exists('seen')) stop('never coalesced'); }", __LINE__);
 	
 	// treeSeqSimplify()
 	SLiMAssertScriptStop("initialize() { initializeTreeSeq(); } " + gen1_setup_p1 + "50 early() { sim.treeSeqSimplify(); } 100 early() { stop(); }", __LINE__);
@@ -2107,6 +2128,18 @@ void _RunTreeSeqTests(const std::string &temp_path)
 		SLiMAssertScriptStop("initialize() { initializeTreeSeq(); } " + gen1_setup_p1 + "100 early() { sim.treeSeqOutput('" + temp_path + "/SLiM_treeSeq_2.trees', simplify=T, includeModel=F, _binary=F); stop(); }", __LINE__);
 		SLiMAssertScriptStop("initialize() { initializeTreeSeq(); } " + gen1_setup_p1 + "100 early() { sim.treeSeqOutput('" + temp_path + "/SLiM_treeSeq_3.trees', simplify=F, includeModel=F, _binary=T); stop(); }", __LINE__);
 		SLiMAssertScriptStop("initialize() { initializeTreeSeq(); } " + gen1_setup_p1 + "100 early() { sim.treeSeqOutput('" + temp_path + "/SLiM_treeSeq_4.trees', simplify=T, includeModel=F, _binary=T); stop(); }", __LINE__);
+		
+		SLiMAssertScriptStop("initialize() { initializeTreeSeq(); initializeMutationType('m2', 0.5, 'f', 0.0); } " + gen1_setup_p1 + "100 early() { sim.treeSeqOutput('" + temp_path + "/SLiM_treeSeq_5.trees', overlayMutationType=m2, overlayRate=1e-5); sim.readFromPopulationFile('" + temp_path + "/SLiM_treeSeq_5.trees'); if (size(sim.mutationsOfType(m2)) > 0) stop(); }", __LINE__);
+		SLiMAssertScriptStop("initialize() { initializeTreeSeq(); initializeMutationType('m2', 0.5, 'f', 0.0); } " + gen1_setup_p1 + "100 early() { sim.treeSeqOutput('" + temp_path + "/SLiM_treeSeq_6.trees', overlayMutationType=m2, overlayRate=0.0); sim.readFromPopulationFile('" + temp_path + "/SLiM_treeSeq_6.trees'); if (size(sim.mutationsOfType(m2)) == 0) stop(); }", __LINE__);
+		SLiMAssertScriptStop("initialize() { initializeTreeSeq(); } " + gen1_setup_p1 + "100 early() { sim.treeSeqOutput('" + temp_path + "/SLiM_treeSeq_7.trees', simplify=F, overlayMutationType=m1, overlayRate=1e-6, _binary=F); stop(); }", __LINE__);
+		SLiMAssertScriptSuccess("initialize() { initializeTreeSeq(); initializeMutationType('m2', 0.5, 'f', 0.0); } " + gen1_setup_p1 + "100 early() { setSeed(17); sim.treeSeqOutput('" + temp_path + "/SLiM_treeSeq_9.trees', overlayMutationType=m2, overlayRate=1e-5); x = runif(5); setSeed(17); if (!identical(x, runif(5))) stop('rng'); }", __LINE__);
+		SLiMAssertScriptSuccess("initialize() { initializeTreeSeq(); initializeMutationType('m2', 0.5, 'f', 0.0); } " + gen1_setup_p1 + "100 early() { sim.treeSeqOutput('" + temp_path + "/SLiM_treeSeq_10.trees', overlayMutationType=m2, overlayRate=1e-5); sim.treeSeqOutput('" + temp_path + "/SLiM_treeSeq_11.trees', overlayMutationType=m2, overlayRate=1e-5); sim.readFromPopulationFile('" + temp_path + "/SLiM_treeSeq_10.trees'); m = sim.mutationsOfType(m2); m = m[order(m.id)]; pos1 = m.position; ids1 = m.id; ticks1 = m.originTick; sim.readFromPopulationFile('" + temp_path + "/SLiM_treeSeq_11.trees'); m = sim.mutationsOfType(m2); m = m[order(m.id)]; if (size(pos1) == 0) stop('empty'); if (!identical(pos1, m.position) | !identical(ids1, m.id) | !identical(ticks1, m.originTick)) stop('mismatch'); }", __LINE__);
+		SLiMAssertScriptRaise("initialize() { initializeTreeSeq(); initializeMutationType('m2', 0.5, 'f', -0.1); } " + gen1_setup_p1 + "100 early() { sim.treeSeqOutput('" + temp_path + "/SLiM_treeSeq_8.trees', overlayMutationType=m2); }", "must be neutral", __LINE__);
+		
+		// node metadata is kept packed while running; it must survive output and reload through simplification, with null genomes, and with children rejected by modifyChild() (retracted from the tables)
+		SLiMAssertScriptSuccess("initialize() { initializeSLiMOptions(keepPedigrees=T); initializeTreeSeq(simplificationInterval=5); initializeSex('X'); } " + gen1_setup_p1 + "modifyChild() { return (runif(1) < 0.7); } 30 late() { g = p1.genomes; ids = g.genomePedigreeID; nulls = g.isNullGenome; types = g.genomeType; if (!any(nulls)) stop('no null genomes'); sim.treeSeqOutput('" + temp_path + "/SLiM_treeSeq_12.trees'); sim.treeSeqOutput('" + temp_path + "/SLiM_treeSeq_13', simplify=F, _binary=F); sim.readFromPopulationFile('" + temp_path + "/SLiM_treeSeq_12.trees'); g = p1.genomes; if (!identical(ids, g.genomePedigreeID) | !identical(nulls, g.isNullGenome) | !identical(types, g.genomeType)) stop('genome mismatch'); sim.treeSeqOutput('" + temp_path + "/SLiM_treeSeq_14', simplify=F, _binary=F); if (!identical(readFile('" + temp_path + "/SLiM_treeSeq_13/NodeTable.txt'), readFile('" + temp_path + "/SLiM_treeSeq_14/NodeTable.txt'))) stop('node table mismatch'); }", __LINE__, true);
+		SLiMAssertScriptRaise("initialize() { initializeTreeSeq(); } " + gen1_setup_p1 + "100 early() { sim.treeSeqOutput('" + temp_path + "/SLiM_treeSeq_8.trees', overlayMutationType=m1, overlayRate=-1e-7); }", "finite and >= 0", __LINE__);
+		SLiMAssertScriptRaise("initialize() { initializeTreeSeq(); } " + gen1_setup_p1 + "100 early() { sim.treeSeqOutput('" + temp_path + "/SLiM_treeSeq_8.trees', overlayRate=1e-7); }", "overlayMutationType to be supplied", __LINE__);
 	}
 }
 
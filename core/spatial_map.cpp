@@ -191,6 +191,15 @@ SpatialMap::SpatialMap(std::string p_name, SpatialMap &p_original) :
 	}
 }
 
+SpatialMap::SpatialMap(std::string p_name) :
+	name_(std::move(p_name)), tag_value_(SLIM_TAG_UNSET_VALUE), spatiality_(0), spatiality_type_(0), periodic_a_(false), periodic_b_(false), periodic_c_(false), required_dimensionality_(0), bounds_a0_(0), bounds_a1_(0), bounds_b0_(0), bounds_b1_(0), bounds_c0_(0), bounds_c1_(0), values_size_(0), interpolate_(false), values_min_(0), values_max_(0), colors_min_(0), colors_max_(0)
+{
+	// This makes an empty map with no grid; SLiMCheckpoint fills in all of the state directly when restoring a saved map
+	grid_size_[0] = 0;
+	grid_size_[1] = 0;
+	grid_size_[2] = 0;
+}
+
 SpatialMap::~SpatialMap(void)
 {
 	if (values_)
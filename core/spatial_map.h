@@ -93,6 +93,7 @@ public:
 	SpatialMap(void) = delete;																// no null construction
 	SpatialMap(std::string p_name, std::string p_spatiality_string, Subpopulation *p_subpop, EidosValue *p_values, bool p_interpolate, EidosValue *p_value_range, EidosValue *p_colors);
 	SpatialMap(std::string p_name, SpatialMap &p_original);
+	explicit SpatialMap(std::string p_name);												// an empty map, for SLiMCheckpoint to fill in
 	~SpatialMap(void);
 	
 	void TakeColorsFromEidosValues(EidosValue *p_value_range, EidosValue *p_colors, const std::string &p_code_name, const std::string &p_eidos_name);
@@ -47,8 +47,11 @@
 #include <unistd.h>
 #include <unordered_set>
 #include <unordered_map>
+#include <map>
+#include <vector>
 #include <float.h>
 #include <ctime>
+#include <random>
 
 #include "eidos_globals.h"
 #if EIDOS_ROBIN_HOOD_HASHING
@@ -469,6 +472,7 @@ slim_tick_t Species::InitializePopulationFromFile(const std::string &p_file_stri
 			
 			// reset our last coalescence state; we don't know whether we're coalesced now or not
 			last_coalescence_state_ = false;
+			coalescence_sentinel_position_ = 0;
 		}
 	}
 	else if (file_format == SLiMFileFormat::kFormatTskitText)
@@ -1027,43 +1031,35 @@ slim_tick_t Species::_InitializePopulationFromTextFile(const char *p_file, Eidos
 #ifndef __clang_analyzer__
 slim_tick_t Species::_InitializePopulationFromBinaryFile(const char *p_file, EidosInterpreter *p_interpreter)
 {
+	// Map the file into memory (or read it into a buffer, where mapping is not possible); we work only with the buffer from here on
+	Eidos_MappedFile mapped_file(p_file);
+	
+	if (!mapped_file.IsOpen() || (mapped_file.Size() == 0))
+		EIDOS_TERMINATION << "ERROR (Species::_InitializePopulationFromBinaryFile): could not open initialization file." << EidosTerminate();
+	
+	return _InitializePopulationFromBinaryBuffer(mapped_file.Data(), mapped_file.Size(), p_interpreter);
+}
+
+slim_tick_t Species::_InitializePopulationFromBinaryBuffer(char *p_buffer, std::size_t p_buffer_size, EidosInterpreter *p_interpreter)
+{
+	// This reads the binary format written by Population::PrintAllBinary(); it is used for binary population files, and for the
+	// population blob embedded in each species chunk of a checkpoint file (see checkpoint.cpp).  Errors are reported under the
+	// name of _InitializePopulationFromBinaryFile(), since that is the user-visible path in almost all cases.
 	THREAD_SAFETY_IN_ACTIVE_PARALLEL("Species::_InitializePopulationFromBinaryFile(): SLiM global state read");
 	
-	std::size_t file_size = 0;
 	slim_tick_t file_tick, file_cycle;
 	int32_t spatial_output_count;
 	int age_output_count = 0;
 	int pedigree_output_count = 0;
 	bool has_nucleotides = false;
 	
-	// Read file into buf
-	std::ifstream infile(p_file, std::ios::in | std::ios::binary);
-	
-	if (!infile.is_open() || infile.eof())
-		EIDOS_TERMINATION << "ERROR (Species::_InitializePopulationFromBinaryFile): could not open initialization file." << EidosTerminate();
-	
-	// Determine the file length
-	infile.seekg(0, std::ios_base::end);
-	file_size = infile.tellg();
-	
-	// Read in the entire file; we assume we have enough memory, for now
-	std::unique_ptr<char[]> raii_buf(new char[file_size]);
-	char *buf = raii_buf.get();
-	
-	if (!buf)
-		EIDOS_TERMINATION << "ERROR (Species::_InitializePopulationFromBinaryFile): could not allocate input buffer." << EidosTerminate();
-	
-	char *buf_end = buf + file_size;
+	char *buf = p_buffer;
+	char *buf_end = buf + p_buffer_size;
 	char *p = buf;
 	
-	infile.seekg(0, std::ios_base::beg);
-	infile.read(buf, file_size);
-	
-	// Close the file; we will work only with our buffer from here on
 	// Note that we use memcpy() to read values from the buffer, since it takes care of alignment issues
 	// for us that otherwise both the UndefinedBehaviorSanitizer.  On platforms that don't care about
 	// alignment this should compile down to the same code; on platforms that do care, it avoids a crash.
-	infile.close();
 	
 	int32_t section_end_tag;
 	int32_t file_version;
@@ -1091,7 +1087,7 @@ slim_tick_t Species::_InitializePopulationFromBinaryFile(const char *p_file, Eid
 			version_tag = 3;
 		}
 		
-		if ((version_tag != 1) && (version_tag != 2) && (version_tag != 3) && (version_tag != 5) && (version_tag != 6) && (version_tag != 7))
+		if ((version_tag != 1) && (version_tag != 2) && (version_tag != 3) && (version_tag != 5) && (version_tag != 6) && (version_tag != 7) && (version_tag != 8))
 			EIDOS_TERMINATION << "ERROR (Species::_InitializePopulationFromBinaryFile): unrecognized version (" << version_tag << ")." << EidosTerminate();
 		
 		file_version = version_tag;
@@ -1455,6 +1451,108 @@ slim_tick_t Species::_InitializePopulationFromBinaryFile(const char *p_file, Eid
 			EIDOS_TERMINATION << "ERROR (Species::_InitializePopulationFromBinaryFile): missing section end after mutations." << EidosTerminate();
 	}
 	
+	// Mutation runs section, added in version 8.  Each distinct mutation run is stored once, and genomes refer to runs by index.
+	// We translate the runs into MutationIndex values here, concatenated into run_mutations; run k occupies the range from
+	// run_offsets[k] to run_offsets[k + 1].  If our mutation run layout matches the file's, genomes then share the runs.
+	int32_t file_mutrun_count = 0;
+	slim_position_t file_mutrun_length = 0;
+	int32_t run_table_size = 0;
+	std::vector<MutationIndex> run_mutations;
+	std::vector<int64_t> run_offsets;
+	
+	if (file_version >= 8)
+	{
+		int32_t padding_size;
+		
+		if (p + sizeof(file_mutrun_count) + sizeof(file_mutrun_length) + sizeof(run_table_size) + sizeof(padding_size) > buf_end)
+			EIDOS_TERMINATION << "ERROR (Species::_InitializePopulationFromBinaryFile): unexpected EOF at mutation run table." << EidosTerminate();
+		
+		memcpy(&file_mutrun_count, p, sizeof(file_mutrun_count));
+		p += sizeof(file_mutrun_count);
+		
+		memcpy(&file_mutrun_length, p, sizeof(file_mutrun_length));
+		p += sizeof(file_mutrun_length);
+		
+		memcpy(&run_table_size, p, sizeof(run_table_size));
+		p += sizeof(run_table_size);
+		
+		memcpy(&padding_size, p, sizeof(padding_size));
+		p += sizeof(padding_size);
+		
+		if ((file_mutrun_count < 0) || (file_mutrun_length < 0) || (run_table_size < 0) || (padding_size < 0) || (padding_size > 7) || ((run_table_size > 0) && ((file_mutrun_count == 0) || (file_mutrun_length == 0))))
+			EIDOS_TERMINATION << "ERROR (Species::_InitializePopulationFromBinaryFile): malformed mutation run table." << EidosTerminate();
+		
+		if (p + padding_size > buf_end)
+			EIDOS_TERMINATION << "ERROR (Species::_InitializePopulationFromBinaryFile): unexpected EOF at mutation run table." << EidosTerminate();
+		
+		p += padding_size;
+		
+		// The writer aligns the run records, so we can normally use the polymorphism ids in place; if it could not, we copy them
+		bool ids_aligned = ((reinterpret_cast<uintptr_t>(p) % alignof(slim_polymorphismid_t)) == 0);
+		std::vector<slim_polymorphismid_t> unaligned_ids;
+		
+		run_offsets.reserve(run_table_size + 1);
+		
+		for (int32_t run_id = 0; run_id < run_table_size; ++run_id)
+		{
+			int32_t run_size;
+			
+			if (p + sizeof(run_size) > buf_end)
+				EIDOS_TERMINATION << "ERROR (Species::_InitializePopulationFromBinaryFile): unexpected EOF while reading mutation run." << EidosTerminate();
+			
+			memcpy(&run_size, p, sizeof(run_size));
+			p += sizeof(run_size);
+			
+			if ((run_size < 0) || (run_size > mutation_map_size) || (p + run_size * sizeof(slim_polymorphismid_t) > buf_end))
+				EIDOS_TERMINATION << "ERROR (Species::_InitializePopulationFromBinaryFile): unexpected EOF while reading mutation run." << EidosTerminate();
+			
+			const slim_polymorphismid_t *polymorphism_ids;
+			
+			if (ids_aligned)
+			{
+				polymorphism_ids = reinterpret_cast<const slim_polymorphismid_t *>(p);
+			}
+			else
+			{
+				unaligned_ids.resize(run_size);
+				memcpy(unaligned_ids.data(), p, run_size * sizeof(slim_polymorphismid_t));
+				polymorphism_ids = unaligned_ids.data();
+			}
+			
+			p += run_size * sizeof(slim_polymorphismid_t);
+			
+			run_offsets.emplace_back((int64_t)run_mutations.size());
+			
+			for (int32_t mut_index = 0; mut_index < run_size; ++mut_index)
+			{
+				slim_polymorphismid_t polymorphism_id = polymorphism_ids[mut_index];
+				
+				if ((polymorphism_id < 0) || (polymorphism_id >= mutation_map_size))
+					EIDOS_TERMINATION << "ERROR (Species::_InitializePopulationFromBinaryFile): mutation " << polymorphism_id << " has not been defined." << EidosTerminate();
+				
+				run_mutations.emplace_back(mutations[polymorphism_id]);
+			}
+		}
+		
+		run_offsets.emplace_back((int64_t)run_mutations.size());
+		
+		if (p + sizeof(section_end_tag) > buf_end)
+			EIDOS_TERMINATION << "ERROR (Species::_InitializePopulationFromBinaryFile): unexpected EOF after mutation runs." << EidosTerminate();
+		
+		memcpy(&section_end_tag, p, sizeof(section_end_tag));
+		p += sizeof(section_end_tag);
+		
+		if (section_end_tag != (int32_t)0xFFFF0000)
+			EIDOS_TERMINATION << "ERROR (Species::_InitializePopulationFromBinaryFile): missing section end after mutation runs." << EidosTerminate();
+	}
+	
+	// Scratch state for building genomes from the run table; see below
+	std::vector<int32_t> genome_run_ids;											// the run table index of each run of the current genome
+	std::vector<const MutationRun *> loaded_runs(run_table_size, nullptr);			// the MutationRun made for each run table entry, when layouts match
+	std::vector<slim_mutrun_index_t> loaded_run_indices(run_table_size, -1);		// the run index at which each loaded run is used
+	std::vector<int64_t> assembly_key;												// our run index followed by the overlapping run table indices
+	std::map<std::vector<int64_t>, const MutationRun *> assembled_runs;				// the MutationRun assembled for each key, when layouts differ
+	
 	// Genomes section
 	if (pedigree_output_count)
 		gSLiM_next_pedigree_id = 0;
@@ -1603,6 +1701,149 @@ slim_tick_t Species::_InitializePopulationFromBinaryFile(const char *p_file, Eid
 			// Read in the mutation list
 			int32_t mutcount = 0;
 			
+			if (file_version >= 8)
+			{
+				// reading mutation run indices; total_mutations is actually the genome's mutation run count
+				if (total_mutations != file_mutrun_count)
+					EIDOS_TERMINATION << "ERROR (Species::_InitializePopulationFromBinaryFile): genome mutation run count does not match the mutation run table." << EidosTerminate();
+				
+				if (p + sizeof(int32_t) * total_mutations > buf_end)
+					EIDOS_TERMINATION << "ERROR (Species::_InitializePopulationFromBinaryFile): unexpected EOF while reading genome." << EidosTerminate();
+				
+				int64_t file_genome_mutation_count = 0;
+				
+				genome_run_ids.resize(total_mutations);
+				
+				for (int32_t file_run_index = 0; file_run_index < total_mutations; ++file_run_index)
+				{
+					int32_t run_id;
+					
+					memcpy(&run_id, p, sizeof(run_id));
+					p += sizeof(run_id);
+					
+					if ((run_id < 0) || (run_id >= run_table_size))
+						EIDOS_TERMINATION << "ERROR (Species::_InitializePopulationFromBinaryFile): mutation run " << run_id << " has not been defined." << EidosTerminate();
+					
+					genome_run_ids[file_run_index] = run_id;
+					file_genome_mutation_count += run_offsets[run_id + 1] - run_offsets[run_id];
+				}
+				
+				if ((genome.mutrun_count_ == file_mutrun_count) && (genome.mutrun_length_ == file_mutrun_length))
+				{
+					// The file's runs have the same layout as our genome, so each run can be used as it stands, shared across genomes
+					for (slim_mutrun_index_t run_index = 0; run_index < total_mutations; ++run_index)
+					{
+						int32_t run_id = genome_run_ids[run_index];
+						const MutationIndex *run_begin = run_mutations.data() + run_offsets[run_id];
+						int32_t run_size = (int32_t)(run_offsets[run_id + 1] - run_offsets[run_id]);
+						
+						// empty runs are left as they are; the genome was created with empty runs
+						if (run_size == 0)
+							continue;
+						
+						const MutationRun *&loaded_run = loaded_runs[run_id];
+						
+						if (!loaded_run)
+						{
+							slim_position_t run_start = run_index * file_mutrun_length;
+							slim_position_t run_end = run_start + file_mutrun_length;
+							
+							if (((mut_block_ptr + run_begin[0])->position_ < run_start) || ((mut_block_ptr + run_begin[run_size - 1])->position_ >= run_end))
+								EIDOS_TERMINATION << "ERROR (Species::_InitializePopulationFromBinaryFile): mutation run " << run_id << " contains mutations outside of its position range." << EidosTerminate();
+							
+#ifdef _OPENMP
+							// When parallel, the MutationRunContext depends upon the position in the genome
+							MutationRunContext &mutrun_context = SpeciesMutationRunContextForMutationRunIndex(run_index);
+#endif
+							
+							MutationRun *new_run = MutationRun::NewMutationRun(mutrun_context);
+							
+							new_run->emplace_back_bulk(run_begin, run_size);
+							loaded_run = new_run;
+							loaded_run_indices[run_id] = run_index;
+						}
+						else if (loaded_run_indices[run_id] != run_index)
+						{
+							EIDOS_TERMINATION << "ERROR (Species::_InitializePopulationFromBinaryFile): mutation run " << run_id << " is used at more than one position." << EidosTerminate();
+						}
+						
+						genome.mutruns_[run_index] = loaded_run;
+					}
+				}
+				else
+				{
+					// The file's runs are laid out differently from ours (typically because mutation run experiments settled on a
+					// different run count), so each of our runs is assembled from the file runs that overlap it.  Genomes that have
+					// the same file runs at those positions get the same assembled run, so sharing survives the change of layout.
+					slim_position_t mutrun_length = genome.mutrun_length_;
+					int64_t genome_mutation_count = 0;
+					
+					for (slim_mutrun_index_t run_index = 0; run_index < genome.mutrun_count_; ++run_index)
+					{
+						slim_position_t run_start = run_index * mutrun_length;
+						slim_position_t run_end = run_start + mutrun_length;
+						slim_mutrun_index_t first_file_run = run_start / file_mutrun_length;
+						slim_mutrun_index_t last_file_run = std::min((run_end - 1) / file_mutrun_length, (slim_mutrun_index_t)file_mutrun_count - 1);
+						bool run_is_empty = true;
+						
+						assembly_key.clear();
+						assembly_key.emplace_back(run_index);
+						
+						for (slim_mutrun_index_t file_run_index = first_file_run; file_run_index <= last_file_run; ++file_run_index)
+						{
+							int32_t run_id = genome_run_ids[file_run_index];
+							
+							assembly_key.emplace_back(run_id);
+							
+							if (run_offsets[run_id + 1] != run_offsets[run_id])
+								run_is_empty = false;
+						}
+						
+						// empty runs are left as they are; the genome was created with empty runs
+						if (run_is_empty)
+							continue;
+						
+						auto assembled_iter = assembled_runs.find(assembly_key);
+						
+						if (assembled_iter == assembled_runs.end())
+						{
+#ifdef _OPENMP
+							// When parallel, the MutationRunContext depends upon the position in the genome
+							MutationRunContext &mutrun_context = SpeciesMutationRunContextForMutationRunIndex(run_index);
+#endif
+							
+							MutationRun *new_run = MutationRun::NewMutationRun(mutrun_context);
+							
+							for (size_t key_index = 1; key_index < assembly_key.size(); ++key_index)
+							{
+								int32_t run_id = (int32_t)assembly_key[key_index];
+								
+								for (int64_t mut_index = run_offsets[run_id]; mut_index < run_offsets[run_id + 1]; ++mut_index)
+								{
+									MutationIndex mutation = run_mutations[mut_index];
+									slim_position_t position = (mut_block_ptr + mutation)->position_;
+									
+									if ((position >= run_start) && (position < run_end))
+										new_run->emplace_back(mutation);
+								}
+							}
+							
+							assembled_iter = assembled_runs.emplace(assembly_key, new_run).first;
+						}
+						
+						genome.mutruns_[run_index] = assembled_iter->second;
+						genome_mutation_count += assembled_iter->second->size();
+					}
+					
+					// every mutation in the file's runs should have landed in exactly one of our runs
+					if (genome_mutation_count != file_genome_mutation_count)
+						EIDOS_TERMINATION << "ERROR (Species::_InitializePopulationFromBinaryFile): genome contains mutations at positions outside of its mutation runs." << EidosTerminate();
+				}
+				
+				continue;		// the genome's runs are already in place
+			}
+			
+			// before version 8, genomes list the polymorphism ids of their mutations directly
 			if (use_16_bit)
 			{
 				// reading 16-bit mutation tags
@@ -1774,6 +2015,11 @@ slim_tick_t Species::_InitializePopulationFromBinaryFile(const char *p_file, Eid
 {
 	return 0;
 }
+
+slim_tick_t Species::_InitializePopulationFromBinaryBuffer(char *p_buffer, std::size_t p_buffer_size, EidosInterpreter *p_interpreter)
+{
+	return 0;
+}
 #endif
 
 void Species::DeleteAllMutationRuns(void)
@@ -1829,10 +2075,18 @@ void Species::RunInitializeCallbacks(void)
 	num_species_declarations_ = 0;
 	
 	// execute initialize() callbacks, which should always have a tick of 0 set
-	std::vector<SLiMEidosBlock*> init_blocks = CallbackBlocksMatching(0, SLiMEidosBlockType::SLiMEidosInitializeCallback, -1, -1, -1);
-	
-	for (auto script_block : init_blocks)
-		community_.ExecuteEidosEvent(script_block);
+	// when restoring from a checkpoint, the logged initialize...() calls are replayed instead of running the callbacks
+	if (community_.RestoreCheckpoint())
+	{
+		community_.RestoreCheckpoint()->ReplayInitializeCalls(this);
+	}
+	else
+	{
+		std::vector<SLiMEidosBlock*> init_blocks = CallbackBlocksMatching(0, SLiMEidosBlockType::SLiMEidosInitializeCallback, -1, -1, -1);
+		
+		for (auto script_block : init_blocks)
+			community_.ExecuteEidosEvent(script_block);
+	}
 	
 	// check for complete initialization
 	if ((num_mutation_rates_ == 0) && (num_mutation_types_ == 0) && (num_genomic_element_types_ == 0) &&
@@ -2177,8 +2431,13 @@ void Species::MaintainTreeSequence(void)
 #endif
 		
 		// note that this causes simplification, so it will confuse the auto-simplification code
-		if (running_treeseq_crosschecks_ && (cycle_ % treeseq_crosschecks_interval_ == 0))
-			CrosscheckTreeSeqIntegrity();
+		if (running_treeseq_crosschecks_)
+		{
+			if (cycle_ % treeseq_crosschecks_interval_ == 0)
+				CrosscheckTreeSeqIntegrity();
+			else if (treeseq_crosschecks_sample_size_ > 0)
+				CrosscheckTreeSeqIntegrity_Sampled(treeseq_crosschecks_sample_size_);
+		}
 	}
 }
 
@@ -4250,9 +4509,38 @@ void Species::SimplifyTreeSequence(void)
 		
 		tsk_flags_t flags = TSK_SIMPLIFY_FILTER_SITES | TSK_SIMPLIFY_FILTER_INDIVIDUALS | TSK_SIMPLIFY_KEEP_INPUT_ROOTS;
 		if (!retain_coalescent_only_) flags |= TSK_SIMPLIFY_KEEP_UNARY;
-		int ret = tsk_table_collection_simplify(&tables_, samples.data(), (tsk_size_t)samples.size(), flags, NULL);
+		std::vector<tsk_id_t> node_map;
+		
+		if (node_metadata_packed_)
+			node_map.resize(tables_.nodes.num_rows);
+		
+		int ret = tsk_table_collection_simplify(&tables_, samples.data(), (tsk_size_t)samples.size(), flags, node_map.size() ? node_map.data() : NULL);
 		if (ret != 0) handle_error("tsk_table_collection_simplify", ret);
 		
+		// carry the packed node metadata over to the retained nodes, in their new order
+		if (node_metadata_packed_)
+		{
+			std::vector<tsk_id_t> old_node_for_new(tables_.nodes.num_rows, TSK_NULL);
+			
+			for (size_t old_node = 0; old_node < node_map.size(); ++old_node)
+				if (node_map[old_node] != TSK_NULL)
+					old_node_for_new[node_map[old_node]] = (tsk_id_t)old_node;
+			
+			PackedNodeMetadata retained_metadata;
+			
+			for (tsk_id_t old_node : old_node_for_new)
+			{
+				GenomeMetadataRec metadata_rec;
+				
+				if ((old_node != TSK_NULL) && packed_node_metadata_.get(old_node, &metadata_rec))
+					retained_metadata.push_back(&metadata_rec);
+				else
+					retained_metadata.push_back(nullptr);
+			}
+			
+			std::swap(packed_node_metadata_, retained_metadata);
+		}
+		
 		EIDOS_BENCHMARK_END(EidosBenchmarkType::k_SIMPLIFY_CORE);
 	}
 	
@@ -4281,28 +4569,25 @@ void Species::CheckCoalescenceAfterSimplification(void)
 		EIDOS_TERMINATION << "ERROR (Species::CheckCoalescenceAfterSimplification): (internal error) coalescence check called with recording or checking off." << EidosTerminate();
 #endif
 	
-	// Copy the table collection; Jerome says this is unnecessary since tsk_table_collection_build_index()
-	// does not modify the core information in the table collection, but just adds some separate indices.
-	// However, we also need to add a population table, so really it is best to make a copy I think.
-	tsk_table_collection_t tables_copy;
-	int ret;
-	
-	ret = tsk_table_collection_copy(&tables_, &tables_copy, 0);
-	if (ret < 0) handle_error("tsk_table_collection_copy", ret);
-	
-	// Our tables copy needs to have a population table now, since this is required to build a tree sequence
-	WritePopulationTable(&tables_copy);
-	
-	ret = tsk_table_collection_build_index(&tables_copy, 0);
-	if (ret < 0) handle_error("tsk_table_collection_build_index", ret);
-	
-	tsk_treeseq_t ts;
-	
-	ret = tsk_treeseq_init(&ts, &tables_copy, 0);
-	if (ret < 0) handle_error("tsk_treeseq_init", ret);
-	
-	// Collect a vector of all extant genome node IDs
-	std::vector<tsk_id_t> all_extant_nodes;
+	// We check coalescence directly on tables_, which have just been simplified; we used to make a copy of the table collection
+	// and build a tree sequence from it, but that copied all of the tables twice (once here, once in tsk_treeseq_init()) after
+	// every simplification.  Instead, we (1) check the position at which we last found the model to be uncoalesced, which will
+	// usually settle the question with a single pass over the edge table while the model is far from coalescence, and then, if
+	// necessary, (2) sweep along the chromosome, maintaining the number of extant genomes below each node as edges are inserted
+	// and removed, just as tsk_tree_t maintains its tracked sample counts, stopping at the first interval that is not coalesced.
+	// Keep in mind that nodes for the first-gen ancestors, and remembered individuals, mean that there may be more than one root
+	// with children even when we have coalesced; what we need to know is whether some node has *all* extant genomes below it.
+	// Note that this is not incremental across simplifications: simplify() renumbers the nodes and rewrites the edge table, so
+	// per-interval root counts from the previous check cannot be carried forward.  A check therefore costs one pass over the
+	// edges while the sentinel position is uncoalesced (typical of a burn-in), and a sort and sweep of the edges after that.
+	tsk_edge_table_t &edges = tables_.edges;
+	tsk_size_t node_count = tables_.nodes.num_rows;
+	tsk_size_t edge_count = edges.num_rows;
+	double sequence_length = tables_.sequence_length;
+	
+	// Tally all extant genome node IDs; tracked[] holds the number of extant genomes at or below each node
+	std::vector<slim_popsize_t> tracked(node_count, 0);
+	slim_popsize_t extant_node_count = 0;
 	
 	for (auto subpop_iter : population_.subpops_)
 	{
@@ -4312,68 +4597,129 @@ void Species::CheckCoalescenceAfterSimplification(void)
 		Genome **genome_ptr = genomes.data();
 		
 		for (slim_popsize_t genome_index = 0; genome_index < genome_count; ++genome_index)
-			all_extant_nodes.emplace_back(genome_ptr[genome_index]->tsk_node_id_);
+			tracked[genome_ptr[genome_index]->tsk_node_id_] = 1;
+		
+		extant_node_count += genome_count;
 	}
 	
-	int64_t extant_node_count = (int64_t)all_extant_nodes.size();
-	
-	// Iterate through the trees to check coalescence; this is a bit tricky because of keeping first-gen nodes and nodes
-	// in remembered individuals.  We use the sparse tree's "tracked samples" feature, tracking extant individuals
-	// only, to find out whether all extant individuals are under a single root (coalesced), or under multiple roots
-	// (not coalesced).  Doing this requires a scan through all the roots at each site, which is very slow if we have
-	// indeed coalesced, but if we are far from coalescence we will usually be able to determine that in the scan of the
-	// first tree (because every site will probably be uncoalesced), which seems like the right performance trade-off.
-	tsk_tree_t t;
-	bool fully_coalesced = true;
-	
-	tsk_tree_init(&t, &ts, 0);
-	if (ret < 0) handle_error("tsk_tree_init", ret);
-	
-	tsk_tree_set_tracked_samples(&t, extant_node_count, all_extant_nodes.data());
-	if (ret < 0) handle_error("tsk_tree_set_tracked_samples", ret);
+	if (extant_node_count <= 1)
+	{
+		last_coalescence_state_ = true;
+		return;
+	}
 	
-	ret = tsk_tree_first(&t);
-	if (ret < 0) handle_error("tsk_tree_first", ret);
+	std::vector<tsk_id_t> parent(node_count, TSK_NULL);
 	
-	for (; (ret == 1) && fully_coalesced; ret = tsk_tree_next(&t))
+	// (1) Build the tree at the sentinel position, and see whether all extant genomes lead up to the same root
 	{
-#if 0
-		// If we didn't keep first-generation lineages, or remember genomes, >1 root would mean not coalesced
-		if (tsk_tree_get_num_roots(&t) > 1)
-		{
-			fully_coalesced = false;
-			break;
-		}
-#else
-		// But we do have retained/remembered nodes in the tree, so we need to be smarter; nodes for the first gen
-		// ancestors will always be present, giving >1 root in each tree even when we have coalesced, and the
-		// remembered individuals may mean that more than one root node has children, too, even when we have
-		// coalesced.  What we need to know is: how many roots are there that have >0 *extant* children?  This
-		// is what we use the tracked samples for; they are extant individuals.
-		for (tsk_id_t root = tsk_tree_get_left_root(&t); root != TSK_NULL; root = t.right_sib[root])
+		double sentinel = coalescence_sentinel_position_;
+		
+		if ((sentinel < 0) || (sentinel >= sequence_length))
+			sentinel = 0;
+		
+		for (tsk_size_t edge_index = 0; edge_index < edge_count; ++edge_index)
+			if ((edges.left[edge_index] <= sentinel) && (sentinel < edges.right[edge_index]))
+				parent[edges.child[edge_index]] = edges.parent[edge_index];
+		
+		// known_root[] memoizes the root above each node visited, so each node is walked through only once
+		std::vector<tsk_id_t> known_root(node_count, TSK_NULL);
+		tsk_id_t common_root = TSK_NULL;
+		
+		for (tsk_id_t node = 0; node < (tsk_id_t)node_count; ++node)
 		{
-			int64_t num_tracked = t.num_tracked_samples[root];
+			if (tracked[node] == 0)
+				continue;
 			
-			if ((num_tracked > 0) && (num_tracked < extant_node_count))
+			tsk_id_t root = node;
+			
+			while ((known_root[root] == TSK_NULL) && (parent[root] != TSK_NULL))
+				root = parent[root];
+			if (known_root[root] != TSK_NULL)
+				root = known_root[root];
+			
+			for (tsk_id_t path_node = node; (path_node != TSK_NULL) && (known_root[path_node] == TSK_NULL); path_node = parent[path_node])
+				known_root[path_node] = root;
+			
+			if (common_root == TSK_NULL)
+				common_root = root;
+			else if (root != common_root)
 			{
-				fully_coalesced = false;
-				break;
+				// not coalesced at the sentinel position, so we are not coalesced; the sentinel remains where it is
+				last_coalescence_state_ = false;
+				return;
 			}
 		}
-#endif
 	}
-	if (ret < 0) handle_error("tsk_tree_next", ret);
 	
-	ret = tsk_tree_free(&t);
-	if (ret < 0) handle_error("tsk_tree_free", ret);
+	// (2) Sweep along the chromosome; the edge table is sorted by parent time after simplification, so stable sorts by left and
+	// right give us insertion and removal orders with ties in time order (although the counts come out right in any order)
+	std::vector<tsk_id_t> insertion_order(edge_count), removal_order(edge_count);
+	
+	for (tsk_size_t edge_index = 0; edge_index < edge_count; ++edge_index)
+		insertion_order[edge_index] = removal_order[edge_index] = (tsk_id_t)edge_index;
+	
+	std::stable_sort(insertion_order.begin(), insertion_order.end(), [&edges](tsk_id_t a, tsk_id_t b) { return edges.left[a] < edges.left[b]; });
+	std::stable_sort(removal_order.begin(), removal_order.end(), [&edges](tsk_id_t a, tsk_id_t b) { return edges.right[a] < edges.right[b]; });
+	
+	std::fill(parent.begin(), parent.end(), TSK_NULL);
 	
-	ret = tsk_treeseq_free(&ts);
-	if (ret < 0) handle_error("tsk_treeseq_free", ret);
+	int64_t full_node_count = 0;		// the number of nodes that have all extant genomes below them
+	tsk_size_t insertion_index = 0, removal_index = 0;
+	double x = 0;
+	bool fully_coalesced = true;
 	
-	if (&tables_copy != &tables_)
+	while (x < sequence_length)
 	{
-		ret = tsk_table_collection_free(&tables_copy);
-		if (ret < 0) handle_error("tsk_table_collection_free", ret);
+		while ((removal_index < edge_count) && (edges.right[removal_order[removal_index]] == x))
+		{
+			tsk_id_t edge = removal_order[removal_index++];
+			tsk_id_t child = edges.child[edge];
+			slim_popsize_t child_tracked = tracked[child];
+			
+			if (child_tracked)
+				for (tsk_id_t node = edges.parent[edge]; node != TSK_NULL; node = parent[node])
+				{
+					if (tracked[node] == extant_node_count)
+						full_node_count--;
+					tracked[node] -= child_tracked;
+				}
+			
+			parent[child] = TSK_NULL;
+		}
+		
+		while ((insertion_index < edge_count) && (edges.left[insertion_order[insertion_index]] == x))
+		{
+			tsk_id_t edge = insertion_order[insertion_index++];
+			tsk_id_t child = edges.child[edge];
+			slim_popsize_t child_tracked = tracked[child];
+			
+			parent[child] = edges.parent[edge];
+			
+			if (child_tracked)
+				for (tsk_id_t node = edges.parent[edge]; node != TSK_NULL; node = parent[node])
+				{
+					tracked[node] += child_tracked;
+					if (tracked[node] == extant_node_count)
+						full_node_count++;
+				}
+		}
+		
+		if (full_node_count == 0)
+		{
+			// remember where we found the model to be uncoalesced, so we can check there first next time
+			fully_coalesced = false;
+			coalescence_sentinel_position_ = x;
+			break;
+		}
+		
+		double next_x = sequence_length;
+		
+		if (insertion_index < edge_count)
+			next_x = std::min(next_x, edges.left[insertion_order[insertion_index]]);
+		if (removal_index < edge_count)
+			next_x = std::min(next_x, edges.right[removal_order[removal_index]]);
+		
+		x = next_x;
 	}
 	
 	//std::cout << "tick " << community->Tick() << ": fully_coalesced == " << (fully_coalesced ? "TRUE" : "false") << std::endl;
@@ -4433,6 +4779,9 @@ void Species::AllocateTreeSequenceTables(void)
 	tables_initialized_ = true;
 	tables_.sequence_length = (double)chromosome_->last_position_ + 1;
 	
+	// the tables are empty, so we can keep node metadata packed from the start
+	PackNodeMetadata();
+	
 	RecordTablePosition();
 }
 
@@ -4469,6 +4818,9 @@ void Species::RetractNewIndividual()
 	//current_new_individual_ = nullptr;
 	
 	tsk_table_collection_truncate(&tables_, &table_position_);
+	
+	if (node_metadata_packed_)
+		packed_node_metadata_.truncate(tables_.nodes.num_rows);
 }
 
 void Species::RecordNewGenome(std::vector<slim_position_t> *p_breakpoints, Genome *p_new_genome, 
@@ -4493,8 +4845,17 @@ void Species::RecordNewGenome(std::vector<slim_position_t> *p_breakpoints, Genom
 	
 	MetadataForGenome(p_new_genome, &metadata_rec);
 	
+	// the metadata goes into packed_node_metadata_ instead of the node table, if we're packing it; see PackNodeMetadata()
 	const char *metadata = (char *)&metadata_rec;
 	size_t metadata_length = sizeof(GenomeMetadataRec)/sizeof(char);
+	
+	if (node_metadata_packed_)
+	{
+		packed_node_metadata_.push_back(&metadata_rec);
+		metadata = NULL;
+		metadata_length = 0;
+	}
+	
 	tsk_id_t offspringTSKID = tsk_node_table_add_row(&tables_.nodes, flags, time, (tsk_id_t)p_new_genome->individual_->subpopulation_->subpopulation_id_,
 		TSK_NULL, metadata, (tsk_size_t)metadata_length);
 	if (offspringTSKID < 0) handle_error("tsk_node_table_add_row", offspringTSKID);
@@ -4646,6 +5007,28 @@ void Species::CheckAutoSimplification(void)
 	// automatically"; we check for that up front.
 	++simplify_elapsed_;
 	
+	// If a table memory limit was given to initializeTreeSeq(), it takes precedence over the
+	// interval/ratio heuristics below; when the rows in use exceed the limit we simplify right away, keeping the peak
+	// footprint of recording bounded regardless of demography.  If we were using the ratio heuristic, this means its
+	// interval is too long for the limit, so we shorten it to the interval we actually managed this time.
+	if ((table_memory_limit_ > 0) && (MemoryInUseForTables(tables_) > table_memory_limit_))
+	{
+		int64_t elapsed = simplify_elapsed_;
+		
+		SimplifyTreeSequence();
+		
+		if ((simplification_interval_ == -1) && (simplify_interval_ > elapsed))
+			simplify_interval_ = std::max((double)elapsed, 1.0);
+		
+		if ((MemoryInUseForTables(tables_) > table_memory_limit_) && !warned_table_memory_limit_ && !gEidosSuppressWarnings)
+		{
+			SLIM_ERRSTREAM << "#WARNING (Species::CheckAutoSimplification): the tree-sequence tables still exceed tableMemoryLimit after simplification, so simplification will occur every cycle; consider raising tableMemoryLimit." << std::endl;
+			warned_table_memory_limit_ = true;
+		}
+		
+		return;
+	}
+	
 	if (simplification_interval_ != -1)
 	{
 		// BCH 4/5/2019: Adding support for a chosen simplification interval rather than a ratio.  A value of -1
@@ -6264,26 +6647,288 @@ void Species::ReadTreeSequenceMetadata(tsk_table_collection_t *p_tables, slim_ti
 #endif
 }
 
-void Species::WriteTreeSequence(std::string &p_recording_tree_path, bool p_binary, bool p_simplify, bool p_include_model, EidosDictionaryUnretained *p_metadata_dict)
+// The number of chromosome intervals used by OverlayNeutralMutations(); fixed, so that results do not depend on the thread count
+static const int64_t kOverlayIntervalCount = 256;
+
+// Mix bits for seeding the overlay RNGs (the splitmix64 finalizer), so that nearby seeds give unrelated sequences
+static inline uint64_t OverlaySeedMix(uint64_t p_x)
 {
-#if DEBUG
-	if (!recording_tree_)
-		EIDOS_TERMINATION << "ERROR (Species::WriteTreeSequence): (internal error) tree sequence recording method called with recording off." << EidosTerminate();
-#endif
+	p_x += 0x9E3779B97F4A7C15ULL;
+	p_x = (p_x ^ (p_x >> 30)) * 0xBF58476D1CE4E5B9ULL;
+	p_x = (p_x ^ (p_x >> 27)) * 0x94D049BB133111EBULL;
+	return p_x ^ (p_x >> 31);
+}
+
+void Species::OverlayNeutralMutations(tsk_table_collection_t *p_tables, MutationType *p_mutation_type, double p_rate)
+{
+	// Place neutral mutations of type p_mutation_type onto the branches of the (sorted) tree sequence in p_tables, as
+	// an alternative to simulating them forward in time.  Mutations arise only within genomic elements, as in SLiM;
+	// the rate is p_rate if it is >= 0, otherwise the chromosome's mutation rate map.  Each branch (edge) receives a
+	// Poisson number of mutations given its length in ticks and the rate-weighted span of the edge.  New mutations are
+	// placed only at positions without an existing site (infinite sites); a position that is already taken is re-drawn
+	// within the same interval.  The work is split into a fixed set of chromosome intervals, each with its own
+	// private RNG seeded from the model's seed and the tick, so the result does not depend on the number of threads.
+	// Times in p_tables must still be in SLiM's internal units (before the rebasing done in WriteTreeSequence()).
+	if (nucleotide_based_)
+		EIDOS_TERMINATION << "ERROR (Species::OverlayNeutralMutations): neutral mutation overlay is not supported in nucleotide-based models." << EidosTerminate();
+	if (!((p_mutation_type->dfe_type_ == DFEType::kFixed) && (p_mutation_type->dfe_parameters_.size() == 1) && (p_mutation_type->dfe_parameters_[0] == 0.0)))
+		EIDOS_TERMINATION << "ERROR (Species::OverlayNeutralMutations): the overlay mutation type must be neutral (a fixed DFE with a selection coefficient of 0.0)." << EidosTerminate();
+	if ((p_rate < 0) && !chromosome_->UsingSingleMutationMap())
+		EIDOS_TERMINATION << "ERROR (Species::OverlayNeutralMutations): neutral mutation overlay cannot use sex-specific mutation rate maps; supply an explicit overlay rate." << EidosTerminate();
 	
-	// If p_binary, then write out to that path;
-	// otherwise, create p_recording_tree_path as a directory,
-	// and write out to text files in that directory
-	int ret = 0;
+	// Intersect the genomic elements with the rate map, giving segments of constant rate [start, end] with rate > 0
+	struct OverlaySegment { slim_position_t start_; slim_position_t end_; double rate_; };
+	std::vector<OverlaySegment> segments;
 	
-	// Standardize the path, resolving a leading ~ and maybe other things
-	std::string path = Eidos_ResolvedPath(Eidos_StripTrailingSlash(p_recording_tree_path));
+	{
+		std::vector<std::pair<slim_position_t, slim_position_t>> elements;
+		
+		for (GenomicElement *element : chromosome_->GenomicElements())
+			elements.emplace_back(element->start_position_, element->end_position_);
+		
+		std::sort(elements.begin(), elements.end());
+		
+		const std::vector<slim_position_t> &rate_ends = chromosome_->mutation_end_positions_H_;
+		const std::vector<double> &rates = chromosome_->mutation_rates_H_;
+		
+		for (auto &element : elements)
+		{
+			if (p_rate >= 0)
+			{
+				if (p_rate > 0)
+					segments.emplace_back(OverlaySegment{element.first, element.second, p_rate});
+				continue;
+			}
+			
+			slim_position_t start = element.first;
+			size_t rate_index = std::lower_bound(rate_ends.begin(), rate_ends.end(), start) - rate_ends.begin();
+			
+			while ((start <= element.second) && (rate_index < rate_ends.size()))
+			{
+				slim_position_t end = std::min(element.second, rate_ends[rate_index]);
+				
+				if (rates[rate_index] > 0)
+					segments.emplace_back(OverlaySegment{start, end, rates[rate_index]});
+				
+				start = end + 1;
+				rate_index++;
+			}
+		}
+	}
 	
-	// Add a population (i.e., subpopulation) table to the table collection; subpopulation information
-	// comes from the time of output.  This needs to happen before simplify/sort.
-	WritePopulationTable(&tables_);
+	if (segments.size() == 0)
+		return;
 	
-	// First we simplify, on the original table collection; we considered doing this on the copy,
+	// The positions of existing sites, which are sorted since p_tables is sorted
+	const double *site_positions = p_tables->sites.position;
+	tsk_size_t site_count = p_tables->sites.num_rows;
+	
+	const tsk_edge_table_t &edges = p_tables->edges;
+	const double *node_time = p_tables->nodes.time;
+	tsk_size_t edge_count = edges.num_rows;
+	slim_position_t last_position = chromosome_->last_position_;
+	size_t segment_count = segments.size();
+	
+	// The chromosome is divided into a fixed set of intervals, independent of the thread count, so the positions drawn
+	// in each interval are disjoint and the result does not depend on how the intervals are scheduled across threads
+	int64_t interval_count = std::min((int64_t)kOverlayIntervalCount, (int64_t)last_position + 1);
+	slim_position_t interval_length = (slim_position_t)((last_position + interval_count) / interval_count);
+	
+	// Partition the edges by interval once, as a compressed list of edge indices per interval; an edge spanning several
+	// intervals is listed in each of them, in edge table order
+	std::vector<size_t> interval_offsets(interval_count + 1, 0);
+	std::vector<tsk_id_t> interval_edges;
+	
+	for (int pass = 0; pass < 2; ++pass)
+	{
+		std::vector<size_t> fill_offsets;
+		
+		if (pass == 1)
+		{
+			for (int64_t interval_index = 0; interval_index < interval_count; ++interval_index)
+				interval_offsets[interval_index + 1] += interval_offsets[interval_index];
+			
+			interval_edges.resize(interval_offsets[interval_count]);
+			fill_offsets.assign(interval_offsets.begin(), interval_offsets.end() - 1);
+		}
+		
+		for (tsk_size_t edge_index = 0; edge_index < edge_count; ++edge_index)
+		{
+			slim_position_t left = (slim_position_t)std::ceil(edges.left[edge_index]);
+			slim_position_t right = std::min(last_position, (slim_position_t)std::ceil(edges.right[edge_index]) - 1);
+			
+			if ((left > right) || (node_time[edges.parent[edge_index]] <= node_time[edges.child[edge_index]]))
+				continue;
+			
+			int64_t first_interval = left / interval_length;
+			int64_t last_interval = right / interval_length;
+			
+			for (int64_t interval_index = first_interval; interval_index <= last_interval; ++interval_index)
+			{
+				if (pass == 0)
+					interval_offsets[interval_index + 1]++;
+				else
+					interval_edges[fill_offsets[interval_index]++] = (tsk_id_t)edge_index;
+			}
+		}
+	}
+	
+	// Each interval draws from its own private generator, seeded from the model's seed, the current tick, and the
+	// interval index; the model's RNG is not used, so writing output does not change the course of the simulation
+	unsigned long int model_seed = EIDOS_STATE_RNG(0)->rng_last_seed_;
+	uint64_t tick_seed = OverlaySeedMix((uint64_t)model_seed ^ OverlaySeedMix((uint64_t)community_.Tick()));
+	
+	struct OverlayMutation { slim_position_t position_; tsk_id_t node_; double time_; };
+	std::vector<std::vector<OverlayMutation>> interval_mutations(interval_count);
+	std::vector<Eidos_RNG_State> thread_rngs(gEidosMaxThreads);
+	
+	for (Eidos_RNG_State &rng_state : thread_rngs)
+		_Eidos_InitializeOneRNG(rng_state);
+	
+	EIDOS_THREAD_COUNT(gEidos_OMP_threads_TS_OVERLAY);
+#pragma omp parallel default(none) shared(interval_mutations, thread_rngs, interval_offsets, interval_edges, interval_count, interval_length, segments, segment_count, edges, node_time, site_positions, site_count, last_position, tick_seed) if(interval_edges.size() >= EIDOS_OMPMIN_TS_OVERLAY) num_threads(thread_count)
+	{
+		gsl_rng *rng = thread_rngs[omp_get_thread_num()].gsl_rng_;
+		Eidos_MT_State *mt = &thread_rngs[omp_get_thread_num()].mt_rng_;
+		std::unordered_set<slim_position_t> used_positions;
+		
+#pragma omp for schedule(dynamic, 1)
+		for (int64_t interval_index = 0; interval_index < interval_count; ++interval_index)
+		{
+			slim_position_t chunk_start = interval_length * interval_index;
+			slim_position_t chunk_end = std::min(last_position, chunk_start + interval_length - 1);
+			uint64_t interval_seed = OverlaySeedMix(tick_seed ^ (uint64_t)interval_index);
+			
+			gsl_rng_set(rng, (unsigned long int)interval_seed);
+			Eidos_MT64_init_genrand64(mt, interval_seed);
+			used_positions.clear();
+			
+			std::vector<OverlayMutation> &mutations = interval_mutations[interval_index];
+			
+			for (size_t edge_offset = interval_offsets[interval_index]; edge_offset < interval_offsets[interval_index + 1]; ++edge_offset)
+			{
+				tsk_id_t edge_index = interval_edges[edge_offset];
+				slim_position_t left = std::max(chunk_start, (slim_position_t)std::ceil(edges.left[edge_index]));
+				slim_position_t right = std::min(chunk_end, (slim_position_t)std::ceil(edges.right[edge_index]) - 1);
+				
+				tsk_id_t child = edges.child[edge_index];
+				double child_time = node_time[child];
+				double parent_time = node_time[edges.parent[edge_index]];
+				double branch_length = parent_time - child_time;
+				
+				// mutation times are whole ticks within the branch when possible, so that origin ticks are exact
+				double first_tick = std::ceil(child_time);
+				double tick_count = std::ceil(parent_time) - first_tick;
+				
+				size_t segment_index = std::lower_bound(segments.begin(), segments.end(), left, [](const OverlaySegment &p_segment, slim_position_t p_position) { return p_segment.end_ < p_position; }) - segments.begin();
+				
+				for ( ; (segment_index < segment_count) && (segments[segment_index].start_ <= right); ++segment_index)
+				{
+					const OverlaySegment &segment = segments[segment_index];
+					slim_position_t start = std::max(left, segment.start_);
+					slim_position_t end = std::min(right, segment.end_);
+					uint64_t span = (uint64_t)(end - start + 1);
+					unsigned int count = gsl_ran_poisson(rng, segment.rate_ * span * branch_length);
+					
+					for (unsigned int mut_index = 0; mut_index < count; ++mut_index)
+					{
+						for (int attempt = 0; attempt < 10; ++attempt)
+						{
+							slim_position_t position = start + (slim_position_t)Eidos_rng_uniform_int_MT64(mt, span);
+							
+							if (std::binary_search(site_positions, site_positions + site_count, (double)position) || !used_positions.insert(position).second)
+								continue;
+							
+							double time;
+							
+							if (tick_count >= 1)
+								time = first_tick + (double)Eidos_rng_uniform_int_MT64(mt, (uint64_t)tick_count);
+							else
+								time = child_time + Eidos_rng_uniform(rng) * branch_length;
+							
+							mutations.emplace_back(OverlayMutation{position, child, time});
+							break;
+						}
+					}
+				}
+			}
+			
+			std::sort(mutations.begin(), mutations.end(), [](const OverlayMutation &p_a, const OverlayMutation &p_b) { return p_a.position_ < p_b.position_; });
+		}
+	}
+	
+	for (Eidos_RNG_State &rng_state : thread_rngs)
+		_Eidos_FreeOneRNG(rng_state);
+	
+	// The intervals are in position order, so concatenating them gives all of the new mutations in position order; the
+	// rows are appended to the site and mutation tables, which we then re-sort
+	std::vector<OverlayMutation> mutations;
+	
+	for (std::vector<OverlayMutation> &interval_vector : interval_mutations)
+		mutations.insert(mutations.end(), interval_vector.begin(), interval_vector.end());
+	
+	if (mutations.size() == 0)
+		return;
+	
+	slim_tick_t current_tick = community_.Tick();
+	slim_tick_t time_adjustment = community_.tree_seq_tick_;
+	slim_objectid_t mutation_type_id = p_mutation_type->mutation_type_id_;
+	
+	// Mutation ids for the new mutations follow on from gSLiM_next_mutation_id, so they are unique within the output,
+	// but the counter itself is not advanced; the running model never contains these mutations, and the ids are claimed
+	// only if the file is read back in, when gSLiM_next_mutation_id is moved past the largest id read
+	slim_mutationid_t mutation_id = gSLiM_next_mutation_id;
+	
+	for (OverlayMutation &mutation : mutations)
+	{
+		tsk_id_t site_id = tsk_site_table_add_row(&p_tables->sites, (double)mutation.position_, NULL, 0, NULL, 0);
+		if (site_id < 0) handle_error("tsk_site_table_add_row", site_id);
+		
+		MutationMetadataRec metadata_rec;
+		
+		metadata_rec.mutation_type_id_ = mutation_type_id;
+		metadata_rec.selection_coeff_ = 0.0;
+		metadata_rec.subpop_index_ = p_tables->nodes.population[mutation.node_];
+		metadata_rec.origin_tick_ = current_tick - (slim_tick_t)std::round(mutation.time_ + time_adjustment);
+		metadata_rec.nucleotide_ = -1;
+		
+		tsk_id_t mut_id = tsk_mutation_table_add_row(&p_tables->mutations, site_id, mutation.node_, TSK_NULL, mutation.time_,
+			(char *)&mutation_id, sizeof(slim_mutationid_t), (char *)&metadata_rec, sizeof(MutationMetadataRec));
+		if (mut_id < 0) handle_error("tsk_mutation_table_add_row", mut_id);
+		
+		mutation_id++;
+	}
+	
+	// The edges are already sorted; the bookmark tells tskit to leave them alone and sort only sites and mutations
+	tsk_bookmark_t start;
+	
+	memset(&start, 0, sizeof(tsk_bookmark_t));
+	start.edges = p_tables->edges.num_rows;
+	
+	int ret = tsk_table_collection_sort(p_tables, &start, TSK_NO_CHECK_INTEGRITY);
+	if (ret < 0) handle_error("tsk_table_collection_sort", ret);
+}
+
+void Species::WriteTreeSequence(std::string &p_recording_tree_path, bool p_binary, bool p_simplify, bool p_include_model, EidosDictionaryUnretained *p_metadata_dict, MutationType *p_overlay_mutation_type, double p_overlay_rate)
+{
+#if DEBUG
+	if (!recording_tree_)
+		EIDOS_TERMINATION << "ERROR (Species::WriteTreeSequence): (internal error) tree sequence recording method called with recording off." << EidosTerminate();
+#endif
+	
+	// If p_binary, then write out to that path;
+	// otherwise, create p_recording_tree_path as a directory,
+	// and write out to text files in that directory
+	int ret = 0;
+	
+	// Standardize the path, resolving a leading ~ and maybe other things
+	std::string path = Eidos_ResolvedPath(Eidos_StripTrailingSlash(p_recording_tree_path));
+	
+	// Add a population (i.e., subpopulation) table to the table collection; subpopulation information
+	// comes from the time of output.  This needs to happen before simplify/sort.
+	WritePopulationTable(&tables_);
+	
+	// First we simplify, on the original table collection; we considered doing this on the copy,
 	// but then the copy takes longer and the simplify's work is lost, and there doesn't seem to
 	// be a compelling case for leaving the original tables unsimplified.  Note that Peter has done
 	// a check that calling treeSeqOutput() in the middle of a run does not change the result, although
@@ -6298,6 +6943,9 @@ void Species::WriteTreeSequence(std::string &p_recording_tree_path, bool p_binar
 	ret = tsk_table_collection_copy(&tables_, &output_tables, 0);
 	if (ret < 0) handle_error("tsk_table_collection_copy", ret);
 	
+	// Expand the node metadata into the standard per-node records for output
+	UnpackNodeMetadata(&output_tables);
+	
 	// Sort and deduplicate; we don't need to do this if we simplified above, since simplification does these steps
 	if (!p_simplify)
 	{
@@ -6313,6 +6961,10 @@ void Species::WriteTreeSequence(std::string &p_recording_tree_path, bool p_binar
 		if (ret < 0) handle_error("tsk_table_collection_deduplicate_sites", ret);
 	}
 	
+	// Overlay neutral mutations onto the output tables, if requested; this does not affect the running model
+	if (p_overlay_mutation_type)
+		OverlayNeutralMutations(&output_tables, p_overlay_mutation_type, p_overlay_rate);
+	
 	// Add in the mutation.parent information; valid tree sequences need parents, but we don't keep them while running
 	ret = tsk_table_collection_build_index(&output_tables, 0);
 	if (ret < 0) handle_error("tsk_table_collection_build_index", ret);
@@ -6494,7 +7146,103 @@ void Species::FreeTreeSequence()
 		
 		remembered_genomes_.clear();
 		tabled_individuals_hash_.clear();
+		
+		node_metadata_packed_ = false;
+		packed_node_metadata_.clear();
+	}
+}
+
+static void _ReplaceNodeTableMetadata(tsk_node_table_t &p_node_table, const char *p_metadata, const tsk_size_t *p_metadata_offset)
+{
+	// Rebuilds p_node_table with the given metadata column (or none, if NULL), keeping its other columns and its schema.  This
+	// goes through a new table because tsk_node_table_set_columns() cannot take its source columns from the table itself.
+	tsk_node_table_t new_table;
+	int ret = tsk_node_table_init(&new_table, 0);
+	if (ret != 0) Species::handle_error("tsk_node_table_init", ret);
+	
+	ret = tsk_node_table_set_columns(&new_table, p_node_table.num_rows, p_node_table.flags, p_node_table.time, p_node_table.population, p_node_table.individual, p_metadata, p_metadata_offset);
+	if (ret != 0) Species::handle_error("tsk_node_table_set_columns", ret);
+	
+	ret = tsk_node_table_set_metadata_schema(&new_table, p_node_table.metadata_schema, p_node_table.metadata_schema_length);
+	if (ret != 0) Species::handle_error("tsk_node_table_set_metadata_schema", ret);
+	
+	tsk_node_table_free(&p_node_table);
+	p_node_table = new_table;
+}
+
+void Species::PackNodeMetadata(void)
+{
+	// Move the SLiM metadata for the node table out of tables_.nodes and into packed_node_metadata_; from here on, new
+	// nodes are recorded without tskit metadata, and UnpackNodeMetadata() is used to restore it on copies made for output.
+	// If any row has metadata that is not a GenomeMetadataRec (which is possible in a .trees file produced by other
+	// software) we leave the node table as it is, and keep recording metadata into it in the standard fashion.
+	if (node_metadata_packed_)
+		return;
+	
+	tsk_node_table_t &node_table = tables_.nodes;
+	tsk_size_t node_count = node_table.num_rows;
+	
+	packed_node_metadata_.clear();
+	
+	for (tsk_size_t node_index = 0; node_index < node_count; ++node_index)
+	{
+		tsk_size_t metadata_length = node_table.metadata_offset[node_index + 1] - node_table.metadata_offset[node_index];
+		
+		if (metadata_length == sizeof(GenomeMetadataRec))
+		{
+			packed_node_metadata_.push_back((GenomeMetadataRec *)(node_table.metadata + node_table.metadata_offset[node_index]));
+		}
+		else if (metadata_length == 0)
+		{
+			packed_node_metadata_.push_back(nullptr);
+		}
+		else
+		{
+			packed_node_metadata_.clear();
+			return;
+		}
+	}
+	
+	if (node_table.metadata_length > 0)
+	{
+		// Rebuild the node table without metadata; clearing the column in place would leave its buffer allocated
+		_ReplaceNodeTableMetadata(node_table, NULL, NULL);
+	}
+	
+	node_metadata_packed_ = true;
+}
+
+void Species::UnpackNodeMetadata(tsk_table_collection_t *p_tables)
+{
+	// Expand packed_node_metadata_ into the metadata column of p_tables, which must be a copy of tables_ with the same nodes
+	if (!node_metadata_packed_)
+		return;
+	
+	tsk_node_table_t &node_table = p_tables->nodes;
+	tsk_size_t node_count = node_table.num_rows;
+	
+	if (node_count != packed_node_metadata_.size())
+		EIDOS_TERMINATION << "ERROR (Species::UnpackNodeMetadata): (internal error) node table size does not match the packed node metadata." << EidosTerminate();
+	
+	std::vector<GenomeMetadataRec> metadata;
+	std::vector<tsk_size_t> metadata_offset;
+	
+	metadata.reserve(node_count);
+	metadata_offset.reserve(node_count + 1);
+	metadata_offset.emplace_back(0);
+	
+	for (tsk_size_t node_index = 0; node_index < node_count; ++node_index)
+	{
+		GenomeMetadataRec metadata_rec;
+		
+		if (packed_node_metadata_.get(node_index, &metadata_rec))
+			metadata.emplace_back(metadata_rec);
+		
+		metadata_offset.emplace_back((tsk_size_t)(metadata.size() * sizeof(GenomeMetadataRec)));
 	}
+	
+	if (metadata.size())
+		_ReplaceNodeTableMetadata(node_table, (char *)metadata.data(), metadata_offset.data());
 }
 
 void Species::RecordAllDerivedStatesFromSLiM(void)
@@ -6597,6 +7345,109 @@ void Species::MetadataForIndividual(Individual *p_individual, IndividualMetadata
 		p_metadata->flags_ |= SLIM_INDIVIDUAL_METADATA_MIGRATED;
 }
 
+// out-of-line definitions for the constants that are passed by reference
+const uint32_t PackedNodeMetadata::kWordAbsent;
+const uint32_t PackedNodeMetadata::kWordException;
+
+void PackedNodeMetadata::clear(void)
+{
+	block_base_.clear();
+	words_.clear();
+	exceptions_.clear();
+	last_block_has_base_ = false;
+}
+
+void PackedNodeMetadata::push_back(const GenomeMetadataRec *p_metadata)
+{
+	size_t index = words_.size();
+	
+	if (index % kBlockSize == 0)
+	{
+		block_base_.emplace_back(0);
+		last_block_has_base_ = false;
+	}
+	
+	if (!p_metadata)
+	{
+		words_.emplace_back(kWordAbsent);
+		return;
+	}
+	
+	// the base of a block is taken from the first node in it that has metadata; any genome id, including 0, can be a base
+	slim_genomeid_t &base = block_base_.back();
+	
+	if (!last_block_has_base_)
+	{
+		base = p_metadata->genome_id_;
+		last_block_has_base_ = true;
+	}
+	
+	int64_t biased_offset = (int64_t)p_metadata->genome_id_ - (int64_t)base + kOffsetBias;
+	uint8_t is_null = p_metadata->is_null_;
+	uint8_t type = (uint8_t)p_metadata->type_;
+	
+	// the largest biased offset is excluded so that a packed word can never collide with the reserved words
+	if ((biased_offset >= 0) && (biased_offset < (int64_t)(2 * kOffsetBias) - 1) && (is_null <= 1) && (type <= 2))
+	{
+		words_.emplace_back((uint32_t)(biased_offset << 3) | (uint32_t)(is_null << 2) | (uint32_t)type);
+	}
+	else
+	{
+		words_.emplace_back(kWordException);
+		exceptions_.emplace_back(index, *p_metadata);
+	}
+}
+
+void PackedNodeMetadata::truncate(size_t p_size)
+{
+	if (p_size >= words_.size())
+		return;
+	
+	words_.resize(p_size);
+	block_base_.resize((p_size + kBlockSize - 1) / kBlockSize);
+	
+	while (exceptions_.size() && (exceptions_.back().first >= p_size))
+		exceptions_.pop_back();
+	
+	// the last block now has a base only if a node in it that has metadata survived the truncation
+	last_block_has_base_ = false;
+	
+	for (size_t index = (p_size == 0) ? 0 : ((p_size - 1) / kBlockSize) * kBlockSize; index < p_size; ++index)
+	{
+		if (words_[index] != kWordAbsent)
+		{
+			last_block_has_base_ = true;
+			break;
+		}
+	}
+}
+
+bool PackedNodeMetadata::get(size_t p_index, GenomeMetadataRec *p_metadata) const
+{
+	uint32_t word = words_[p_index];
+	
+	if (word == kWordAbsent)
+		return false;
+	
+	if (word == kWordException)
+	{
+		auto exception_iter = std::lower_bound(exceptions_.begin(), exceptions_.end(), p_index, [](const std::pair<size_t, GenomeMetadataRec> &p_exception, size_t p_value) { return p_exception.first < p_value; });
+		
+		*p_metadata = exception_iter->second;
+		return true;
+	}
+	
+	p_metadata->genome_id_ = block_base_[p_index / kBlockSize] + (slim_genomeid_t)((int64_t)(word >> 3) - kOffsetBias);
+	p_metadata->is_null_ = (uint8_t)((word >> 2) & 0x01);
+	p_metadata->type_ = (GenomeType)(word & 0x03);
+	return true;
+}
+
+size_t PackedNodeMetadata::MemoryUsage(void) const
+{
+	return block_base_.capacity() * sizeof(slim_genomeid_t) + words_.capacity() * sizeof(uint32_t) + exceptions_.capacity() * sizeof(std::pair<size_t, GenomeMetadataRec>);
+}
+
 void Species::DumpMutationTable(void)
 {
 #if DEBUG
@@ -6973,6 +7824,134 @@ void Species::CrosscheckTreeSeqIntegrity(void)
 	}
 }
 
+void Species::CrosscheckTreeSeqIntegrity_Sampled(int p_position_count)
+{
+	THREAD_SAFETY_IN_ANY_PARALLEL("Species::CrosscheckTreeSeqIntegrity_Sampled(): illegal when parallel");
+	
+#if DEBUG
+	if (!recording_tree_)
+		EIDOS_TERMINATION << "ERROR (Species::CrosscheckTreeSeqIntegrity_Sampled): (internal error) tree sequence recording method called with recording off." << EidosTerminate();
+#endif
+	
+	// This is a cheaper variant of CrosscheckTreeSeqIntegrity() that checks only a random sample of sites, working directly on
+	// tables_ without copying, sorting, or simplifying them.  For each sampled position we build the local tree from whatever
+	// edges cover that position (the edge table need not be sorted for this), and then find the derived state of each extant
+	// genome as the derived state of the most recent mutation at that position on its nearest ancestral node, including itself.
+	// That is compared against the mutations SLiM has at that position in the genome, plus any substitutions at the position.
+	if (!recording_mutations_)
+		return;
+	
+	tsk_size_t site_count = tables_.sites.num_rows;
+	
+	if ((site_count == 0) || (p_position_count <= 0))
+		return;
+	
+	std::vector<Genome *> genomes;
+	
+	for (auto pop_iter : population_.subpops_)
+		for (Genome *genome : pop_iter.second->parent_genomes_)
+			genomes.emplace_back(genome);
+	
+	if (genomes.size() == 0)
+		return;
+	
+	// choose the positions to check from the site table, using a private generator so we don't perturb the model's random numbers
+	std::vector<double> positions;
+	std::minstd_rand position_generator((std::minstd_rand::result_type)(cycle_ + 1));
+	
+	for (int sample_index = 0; sample_index < p_position_count; ++sample_index)
+		positions.emplace_back(tables_.sites.position[position_generator() % site_count]);
+	
+	std::sort(positions.begin(), positions.end());
+	positions.erase(std::unique(positions.begin(), positions.end()), positions.end());
+	
+	tsk_edge_table_t &edges = tables_.edges;
+	tsk_mutation_table_t &mutations = tables_.mutations;
+	std::vector<tsk_id_t> parent(tables_.nodes.num_rows, TSK_NULL);
+	std::unordered_map<tsk_id_t, tsk_id_t> node_mutation;		// the last mutation table row at the position for each node
+	std::vector<slim_mutationid_t> tree_mutids, genome_mutids;
+	
+	for (double position : positions)
+	{
+		slim_position_t position_int = (slim_position_t)position;
+		
+		// build the local tree at this position
+		std::fill(parent.begin(), parent.end(), TSK_NULL);
+		
+		for (tsk_size_t edge_index = 0; edge_index < edges.num_rows; ++edge_index)
+			if ((edges.left[edge_index] <= position) && (position < edges.right[edge_index]))
+				parent[edges.child[edge_index]] = edges.parent[edge_index];
+		
+		// find the mutations at this position; table order is chronological for each node, so the last row for a node wins
+		node_mutation.clear();
+		
+		for (tsk_size_t mut_index = 0; mut_index < mutations.num_rows; ++mut_index)
+			if (tables_.sites.position[mutations.site[mut_index]] == position)
+				node_mutation[mutations.node[mut_index]] = (tsk_id_t)mut_index;
+		
+		// get the substitutions at this position, which should be present in every non-null genome
+		auto substitution_range_iter = population_.treeseq_substitutions_map_.equal_range(position_int);
+		
+		for (Genome *genome : genomes)
+		{
+			// get the derived state in the tree for this genome
+			tree_mutids.clear();
+			
+			for (tsk_id_t node = genome->tsk_node_id_; node != TSK_NULL; node = parent[node])
+			{
+				auto node_mutation_iter = node_mutation.find(node);
+				
+				if (node_mutation_iter != node_mutation.end())
+				{
+					tsk_id_t mut_index = node_mutation_iter->second;
+					tsk_size_t derived_state_length = mutations.derived_state_offset[mut_index + 1] - mutations.derived_state_offset[mut_index];
+					
+					if (derived_state_length % sizeof(slim_mutationid_t) != 0)
+						EIDOS_TERMINATION << "ERROR (Species::CrosscheckTreeSeqIntegrity_Sampled): (internal error) derived state had length that was not a multiple of sizeof(slim_mutationid_t)." << EidosTerminate();
+					
+					const slim_mutationid_t *derived_state = (const slim_mutationid_t *)(mutations.derived_state + mutations.derived_state_offset[mut_index]);
+					
+					tree_mutids.insert(tree_mutids.end(), derived_state, derived_state + derived_state_length / sizeof(slim_mutationid_t));
+					break;
+				}
+			}
+			
+			// get the mutations in SLiM for this genome, including fixed mutations
+			genome_mutids.clear();
+			
+			if (genome->IsNull())
+			{
+				if (tree_mutids.size())
+					EIDOS_TERMINATION << "ERROR (Species::CrosscheckTreeSeqIntegrity_Sampled): (internal error) null genome has non-zero treeseq allele length " << tree_mutids.size() << " at position " << position_int << "." << EidosTerminate();
+				continue;
+			}
+			
+			const MutationRun *mutrun = genome->mutruns_[position_int / genome->mutrun_length_];
+			const MutationIndex *mut_ptr = mutrun->begin_pointer_const();
+			const MutationIndex *mut_end_ptr = mutrun->end_pointer_const();
+			Mutation *mut_block_ptr = gSLiM_Mutation_Block;
+			
+			for (; mut_ptr != mut_end_ptr; ++mut_ptr)
+			{
+				Mutation *mut = mut_block_ptr + *mut_ptr;
+				
+				if (mut->position_ == position_int)
+					genome_mutids.emplace_back(mut->mutation_id_);
+			}
+			
+			for (auto substitution_iter = substitution_range_iter.first; substitution_iter != substitution_range_iter.second; ++substitution_iter)
+				genome_mutids.emplace_back(substitution_iter->second->mutation_id_);
+			
+			// crosscheck, sorting so there is no order-dependency
+			std::sort(tree_mutids.begin(), tree_mutids.end());
+			std::sort(genome_mutids.begin(), genome_mutids.end());
+			
+			if (tree_mutids != genome_mutids)
+				EIDOS_TERMINATION << "ERROR (Species::CrosscheckTreeSeqIntegrity_Sampled): (internal error) genome/allele mismatch at position " << position_int << ": the treeseq has " << tree_mutids.size() << " mutation(s), SLiM has " << genome_mutids.size() << " including substitutions." << EidosTerminate();
+		}
+	}
+}
+
 void Species::__RewriteOldIndividualsMetadata(int p_file_version)
 {
 	// rewrite individuals table metadata if it is in the old (pre-parent-pedigree-id) format; after this,
@@ -7791,7 +8770,7 @@ void Species::__TabulateSubpopulationsFromTreeSequence(std::unordered_map<slim_o
 	}
 }
 
-void Species::__CreateSubpopulationsFromTabulation(std::unordered_map<slim_objectid_t, ts_subpop_info> &p_subpopInfoMap, EidosInterpreter *p_interpreter, std::unordered_map<tsk_id_t, Genome *> &p_nodeToGenomeMap)
+void Species::__CreateSubpopulationsFromTabulation(std::unordered_map<slim_objectid_t, ts_subpop_info> &p_subpopInfoMap, EidosInterpreter *p_interpreter, std::vector<Genome *> &p_nodeToGenomeMap)
 {
 	// We will keep track of all pedigree IDs used, and check at the end that they do not collide; faster than checking as we go
 	// This could be done with a hash table, but I imagine that would be slower until the number of individuals becomes very large
@@ -7857,8 +8836,8 @@ void Species::__CreateSubpopulationsFromTabulation(std::unordered_map<slim_objec
 				individual->genome1_->tsk_node_id_ = node_id_0;
 				individual->genome2_->tsk_node_id_ = node_id_1;
 				
-				p_nodeToGenomeMap.emplace(node_id_0, individual->genome1_);
-				p_nodeToGenomeMap.emplace(node_id_1, individual->genome2_);
+				p_nodeToGenomeMap[node_id_0] = individual->genome1_;
+				p_nodeToGenomeMap[node_id_1] = individual->genome2_;
 				
 				slim_pedigreeid_t pedigree_id = subpop_info.pedigreeID_[tabulation_index];
 				individual->SetPedigreeID(pedigree_id);
@@ -8152,12 +9131,38 @@ void Species::__ConfigureSubpopulationsFromTables(EidosInterpreter *p_interprete
 }
 
 typedef struct ts_mut_info {
+	slim_mutationid_t mutation_id;
 	slim_position_t position;
 	MutationMetadataRec metadata;
 	slim_refcount_t ref_count;
+	MutationIndex mut_index;		// set by __CreateMutationsFromTabulation(); -1 for a substitution or an uninstantiated mutation
 } ts_mut_info;
 
-void Species::__TabulateMutationsFromTables(std::unordered_map<slim_mutationid_t, ts_mut_info> &p_mutMap, int p_file_version)
+// Find the ts_mut_info for a given mutation id, by binary search in the vector sorted by __TabulateMutationsFromTables(); nullptr if not found
+static inline ts_mut_info *_FindTabulatedMutation(std::vector<ts_mut_info> &p_mutInfo, slim_mutationid_t p_mut_id)
+{
+	auto mut_info_iter = std::lower_bound(p_mutInfo.begin(), p_mutInfo.end(), p_mut_id, [](const ts_mut_info &info, slim_mutationid_t mut_id) { return info.mutation_id < mut_id; });
+	
+	if ((mut_info_iter == p_mutInfo.end()) || (mut_info_iter->mutation_id != p_mut_id))
+		return nullptr;
+	
+	return &(*mut_info_iter);
+}
+
+// Find the range of sites [*p_first_site, *p_end_site) whose positions fall within the given range of mutation run indices; this is used to
+// divide the work of walking variants among threads, with each thread responsible for its own range of mutation runs (as elsewhere in SLiM)
+static void _SiteRangeForMutationRuns(tsk_treeseq_t *p_ts, slim_position_t p_mutrun_length, int p_first_mutrun_index, int p_last_mutrun_index, tsk_size_t *p_first_site, tsk_size_t *p_end_site)
+{
+	const double *site_positions = p_ts->tables->sites.position;
+	tsk_size_t site_count = p_ts->tables->sites.num_rows;
+	double start_position = (double)p_first_mutrun_index * p_mutrun_length;
+	double end_position = ((double)p_last_mutrun_index + 1) * p_mutrun_length;
+	
+	*p_first_site = (tsk_size_t)(std::lower_bound(site_positions, site_positions + site_count, start_position) - site_positions);
+	*p_end_site = (tsk_size_t)(std::lower_bound(site_positions, site_positions + site_count, end_position) - site_positions);
+}
+
+void Species::__TabulateMutationsFromTables(std::vector<ts_mut_info> &p_mutInfo, int p_file_version)
 {
 	std::size_t metadata_rec_size = ((p_file_version < 3) ? sizeof(MutationMetadataRec_PRENUC) : sizeof(MutationMetadataRec));
 	tsk_mutation_table_t &mut_table = tables_.mutations;
@@ -8166,6 +9171,12 @@ void Species::__TabulateMutationsFromTables(std::unordered_map<slim_mutationid_t
 	if ((mut_count > 0) && !recording_mutations_)
 		EIDOS_TERMINATION << "ERROR (Species::__TabulateMutationsFromTables): cannot load mutations when mutation recording is disabled." << EidosTerminate();
 	
+	// We tabulate every mutation reference in the table, in table order, and then sort by mutation id and collapse duplicates below.
+	// A sorted vector, rather than a hash table keyed by mutation id, gives us cheap and cache-friendly lookups by binary search
+	// later on, and those lookups are safe to do from multiple threads since the vector is not modified after this point.
+	p_mutInfo.clear();
+	p_mutInfo.reserve(mut_count);
+	
 	for (tsk_size_t mut_index = 0; mut_index < mut_count; ++mut_index)
 	{
 		const char *derived_state_bytes = mut_table.derived_state + mut_table.derived_state_offset[mut_index];
@@ -8192,30 +9203,15 @@ void Species::__TabulateMutationsFromTables(std::unordered_map<slim_mutationid_t
 		
 		slim_position_t position = (slim_position_t)position_double_round;
 		
-		// tabulate the mutations referenced by this entry, overwriting previous tabulations (last state wins)
+		// tabulate the mutations referenced by this entry
 		for (int stack_index = 0; stack_index < stack_count; ++stack_index)
 		{
-			slim_mutationid_t mut_id = derived_state_vec[stack_index];
-			
-			auto mut_info_find = p_mutMap.find(mut_id);
-			ts_mut_info *mut_info;
+			ts_mut_info mut_info;
 			
-			if (mut_info_find == p_mutMap.end())
-			{
-				// no entry already present; create one
-				auto mut_info_insert = p_mutMap.emplace(mut_id, ts_mut_info());
-				mut_info = &((mut_info_insert.first)->second);
-				
-				mut_info->position = position;
-			}
-			else
-			{
-				// entry already present; check that it refers to the same mutation, using its position (see https://github.com/MesserLab/SLiM/issues/179)
-				mut_info = &(mut_info_find->second);
-				
-				if (mut_info->position != position)
-					EIDOS_TERMINATION << "ERROR (Species::__TabulateMutationsFromTables): inconsistent mutation position observed reading tree sequence data; this may indicate that mutation IDs are not unique." << EidosTerminate();
-			}
+			mut_info.mutation_id = derived_state_vec[stack_index];
+			mut_info.position = position;
+			mut_info.ref_count = 0;
+			mut_info.mut_index = -1;
 			
 			// This method handles the fact that a file version of 2 or below will not contain a nucleotide field for its mutation metadata.
 			// We hide this fact from the rest of the initialization code; ts_mut_info uses MutationMetadataRec, and we fill in a value of
@@ -8224,106 +9220,168 @@ void Species::__TabulateMutationsFromTables(std::unordered_map<slim_mutationid_t
 			{
 				MutationMetadataRec_PRENUC *prenuc_metadata = (MutationMetadataRec_PRENUC *)metadata_vec + stack_index;
 				
-				mut_info->metadata.mutation_type_id_ = prenuc_metadata->mutation_type_id_;
-				mut_info->metadata.selection_coeff_ = prenuc_metadata->selection_coeff_;
-				mut_info->metadata.subpop_index_ = prenuc_metadata->subpop_index_;
-				mut_info->metadata.origin_tick_ = prenuc_metadata->origin_tick_;
-				mut_info->metadata.nucleotide_ = -1;
+				mut_info.metadata.mutation_type_id_ = prenuc_metadata->mutation_type_id_;
+				mut_info.metadata.selection_coeff_ = prenuc_metadata->selection_coeff_;
+				mut_info.metadata.subpop_index_ = prenuc_metadata->subpop_index_;
+				mut_info.metadata.origin_tick_ = prenuc_metadata->origin_tick_;
+				mut_info.metadata.nucleotide_ = -1;
 			}
 			else
 			{
 				MutationMetadataRec *metadata = (MutationMetadataRec *)metadata_vec + stack_index;
 				
-				mut_info->metadata = *metadata;
+				mut_info.metadata = *metadata;
 			}
+			
+			p_mutInfo.emplace_back(mut_info);
 		}
 	}
-}
-
-void Species::__TallyMutationReferencesWithTreeSequence(std::unordered_map<slim_mutationid_t, ts_mut_info> &p_mutMap, std::unordered_map<tsk_id_t, Genome *> p_nodeToGenomeMap, tsk_treeseq_t *p_ts)
-{
-	// allocate and set up the tsk_variant object we'll use to walk through sites
-	tsk_variant_t *variant;
-	variant = (tsk_variant_t *)malloc(sizeof(tsk_variant_t));
-	if (!variant)
-		EIDOS_TERMINATION << "ERROR (Species::__TallyMutationReferencesWithTreeSequence): allocation failed; you may need to raise the memory limit for SLiM." << EidosTerminate(nullptr);
 	
-	int ret = tsk_variant_init(
-			variant, p_ts, NULL, 0, NULL, TSK_ISOLATED_NOT_MISSING);
-	if (ret != 0) handle_error("__TallyMutationReferencesWithTreeSequence tsk_variant_init()", ret);
+	// sort by mutation id; the sort is stable, so for each mutation id the entries remain in table order
+	std::stable_sort(p_mutInfo.begin(), p_mutInfo.end(), [](const ts_mut_info &a, const ts_mut_info &b) { return a.mutation_id < b.mutation_id; });
 	
-	// set up a map from sample indices in the variant to Genome objects; the sample
-	// may contain nodes that are ancestral and need to be excluded
-	std::vector<Genome *> indexToGenomeMap;
-	size_t sample_count = variant->num_samples;
+	// collapse entries with the same mutation id, overwriting previous tabulations (last state wins); check that all entries for a given
+	// mutation id refer to the same mutation, using its position (see https://github.com/MesserLab/SLiM/issues/179)
+	size_t tabulated_count = p_mutInfo.size();
+	size_t unique_count = 0;
 	
-	for (size_t sample_index = 0; sample_index < sample_count; ++sample_index)
+	for (size_t tabulated_index = 0; tabulated_index < tabulated_count; ++tabulated_index)
 	{
-		tsk_id_t sample_node_id = variant->samples[sample_index];
-		auto sample_nodeToGenome_iter = p_nodeToGenomeMap.find(sample_node_id);
+		ts_mut_info &mut_info = p_mutInfo[tabulated_index];
 		
-		if (sample_nodeToGenome_iter != p_nodeToGenomeMap.end())
-			indexToGenomeMap.emplace_back(sample_nodeToGenome_iter->second);
+		if ((unique_count > 0) && (p_mutInfo[unique_count - 1].mutation_id == mut_info.mutation_id))
+		{
+			if (p_mutInfo[unique_count - 1].position != mut_info.position)
+				EIDOS_TERMINATION << "ERROR (Species::__TabulateMutationsFromTables): inconsistent mutation position observed reading tree sequence data; this may indicate that mutation IDs are not unique." << EidosTerminate();
+			
+			p_mutInfo[unique_count - 1] = mut_info;
+		}
 		else
-			indexToGenomeMap.emplace_back(nullptr);	// this sample is not extant; no corresponding genome
+		{
+			if (unique_count != tabulated_index)
+				p_mutInfo[unique_count] = mut_info;
+			unique_count++;
+		}
 	}
 	
-	// add mutations to genomes by looping through variants
-	for (tsk_size_t i = 0; i < p_ts->tables->sites.num_rows; i++)
+	p_mutInfo.resize(unique_count);
+}
+
+void Species::__TallyMutationReferencesWithTreeSequence(std::vector<ts_mut_info> &p_mutInfo, std::vector<Genome *> &p_nodeToGenomeMap, tsk_treeseq_t *p_ts)
+{
+	// We walk the variants in parallel, with each thread responsible for the sites within its own range of mutation runs, just as
+	// for the MutationRunContext design.  Each thread has its own tsk_variant_t (and thus its own tsk_tree_t).  Since each mutation
+	// has a single position (checked by __TabulateMutationsFromTables()), the ts_mut_info entries tallied by each thread are disjoint.
+	int mutrun_count_multiplier = chromosome_->mutrun_count_multiplier_;
+	int mutrun_context_count = SpeciesMutationRunContextCount();
+	slim_position_t mutrun_length = chromosome_->mutrun_length_;
+	int tsk_error = 0;
+	bool saw_error_1 = false, saw_error_2 = false;
+	slim_mutationid_t missing_mut_id = -1;
+	
+	if (mutrun_count_multiplier * mutrun_context_count != chromosome_->mutrun_count_)
+		EIDOS_TERMINATION << "ERROR (Species::__TallyMutationReferencesWithTreeSequence): (internal error) mutation run subdivision is incorrect." << EidosTerminate();
+	
+#pragma omp parallel default(none) shared(p_mutInfo, p_nodeToGenomeMap, p_ts, mutrun_count_multiplier, mutrun_length, missing_mut_id) reduction(min: tsk_error) reduction(||: saw_error_1) reduction(||: saw_error_2) num_threads(mutrun_context_count)
 	{
-		ret = tsk_variant_decode(variant, (tsk_id_t)i, 0);
-		if (ret < 0) handle_error("__TallyMutationReferencesWithTreeSequence tsk_variant_decode()", ret);
+		// this is initialized by OpenMP to the largest integer (reduction type min); we want zero instead!
+		tsk_error = 0;
+		
+		int first_mutrun_index = omp_get_thread_num() * mutrun_count_multiplier;
+		int last_mutrun_index = first_mutrun_index + mutrun_count_multiplier - 1;
+		tsk_size_t first_site, end_site;
+		
+		_SiteRangeForMutationRuns(p_ts, mutrun_length, first_mutrun_index, last_mutrun_index, &first_site, &end_site);
 		
-		// We have a new variant; set it into SLiM.  A variant represents a site at which a tracked mutation exists.
-		// The tsk_variant_t will tell us all the allelic states involved at that site, what the alleles are, and which genomes
-		// in the sample are using them.  We want to find any mutations that are shared across all non-null genomes.
-		for (tsk_size_t allele_index = 0; allele_index < variant->num_alleles; ++allele_index)
+		if (first_site < end_site)
 		{
-			tsk_size_t allele_length = variant->allele_lengths[allele_index];
+			// set up the tsk_variant object we'll use to walk through sites
+			tsk_variant_t variant;
+			int ret = tsk_variant_init(&variant, p_ts, NULL, 0, NULL, TSK_ISOLATED_NOT_MISSING);
 			
-			if (allele_length > 0)
+			if (ret != 0)
+				tsk_error = ret;
+			else
 			{
-				// Calculate the number of extant genomes that reference this allele
-				int32_t allele_refs = 0;
+				// set up a map from sample indices in the variant to Genome objects; the sample
+				// may contain nodes that are ancestral and need to be excluded
+				size_t sample_count = variant.num_samples;
+				std::vector<Genome *> indexToGenomeMap(sample_count);
+				std::vector<int32_t> allele_refs;
 				
-				for (size_t sample_index = 0; sample_index < sample_count; sample_index++)
-					if ((variant->genotypes[sample_index] == (int32_t)allele_index) && (indexToGenomeMap[sample_index] != nullptr))
-						allele_refs++;
+				for (size_t sample_index = 0; sample_index < sample_count; ++sample_index)
+					indexToGenomeMap[sample_index] = p_nodeToGenomeMap[variant.samples[sample_index]];	// nullptr if not extant
 				
-				// If that count is greater than zero (might be zero if only non-extant nodes reference the allele), tally it
-				if (allele_refs)
+				for (tsk_size_t i = first_site; i < end_site; i++)
 				{
-					if (allele_length % sizeof(slim_mutationid_t) != 0)
-						EIDOS_TERMINATION << "ERROR (Species::__TallyMutationReferencesWithTreeSequence): (internal error) variant allele had length that was not a multiple of sizeof(slim_mutationid_t)." << EidosTerminate();
-					allele_length /= sizeof(slim_mutationid_t);
+					ret = tsk_variant_decode(&variant, (tsk_id_t)i, 0);
+					if (ret < 0) { tsk_error = ret; break; }
 					
-					slim_mutationid_t *allele = (slim_mutationid_t *)variant->alleles[allele_index];
+					// We have a new variant; set it into SLiM.  A variant represents a site at which a tracked mutation exists.
+					// The tsk_variant_t will tell us all the allelic states involved at that site, what the alleles are, and which genomes
+					// in the sample are using them.  We want to find any mutations that are shared across all non-null genomes.
+					// Calculate the number of extant genomes that reference each allele, in a single pass over the genotypes
+					allele_refs.assign(variant.num_alleles, 0);
 					
-					for (tsk_size_t mutid_index = 0; mutid_index < allele_length; ++mutid_index)
+					for (size_t sample_index = 0; sample_index < sample_count; sample_index++)
 					{
-						slim_mutationid_t mut_id = allele[mutid_index];
-						auto mut_info_iter = p_mutMap.find(mut_id);
-						
-						if (mut_info_iter == p_mutMap.end())
-							EIDOS_TERMINATION << "ERROR (Species::__TallyMutationReferencesWithTreeSequence): mutation id " << mut_id << " was referenced but does not exist." << EidosTerminate();
+						int32_t genotype = variant.genotypes[sample_index];
 						
-						// Add allele_refs to the refcount for this mutation
-						ts_mut_info &mut_info = mut_info_iter->second;
+						if ((genotype >= 0) && indexToGenomeMap[sample_index])
+							allele_refs[genotype]++;
+					}
+					
+					for (tsk_size_t allele_index = 0; allele_index < variant.num_alleles; ++allele_index)
+					{
+						tsk_size_t allele_length = variant.allele_lengths[allele_index];
 						
-						mut_info.ref_count += allele_refs;
+						// If the count is greater than zero (might be zero if only non-extant nodes reference the allele), tally it
+						if ((allele_length > 0) && allele_refs[allele_index])
+						{
+							if (allele_length % sizeof(slim_mutationid_t) != 0)
+							{
+								saw_error_1 = true;
+								continue;
+							}
+							allele_length /= sizeof(slim_mutationid_t);
+							
+							const slim_mutationid_t *allele = (const slim_mutationid_t *)variant.alleles[allele_index];
+							
+							for (tsk_size_t mutid_index = 0; mutid_index < allele_length; ++mutid_index)
+							{
+								slim_mutationid_t mut_id = allele[mutid_index];
+								ts_mut_info *mut_info = _FindTabulatedMutation(p_mutInfo, mut_id);
+								
+								if (!mut_info)
+								{
+									saw_error_2 = true;
+#pragma omp critical (TallyMutationReferencesWithTreeSequence_missing)
+									missing_mut_id = mut_id;
+									continue;
+								}
+								
+								// Add allele_refs to the refcount for this mutation
+								mut_info->ref_count += allele_refs[allele_index];
+							}
+						}
 					}
 				}
+				
+				ret = tsk_variant_free(&variant);
+				if ((ret != 0) && (tsk_error == 0))
+					tsk_error = ret;
 			}
 		}
 	}
 	
-	// free
-	ret = tsk_variant_free(variant);
-	if (ret != 0) handle_error("__TallyMutationReferencesWithTreeSequence tsk_variant_free()", ret);
-	free(variant);
+	if (tsk_error != 0) handle_error("__TallyMutationReferencesWithTreeSequence tsk_variant_decode()", tsk_error);
+	if (saw_error_1)
+		EIDOS_TERMINATION << "ERROR (Species::__TallyMutationReferencesWithTreeSequence): (internal error) variant allele had length that was not a multiple of sizeof(slim_mutationid_t)." << EidosTerminate();
+	if (saw_error_2)
+		EIDOS_TERMINATION << "ERROR (Species::__TallyMutationReferencesWithTreeSequence): mutation id " << missing_mut_id << " was referenced but does not exist." << EidosTerminate();
 }
 
-void Species::__CreateMutationsFromTabulation(std::unordered_map<slim_mutationid_t, ts_mut_info> &p_mutInfoMap, std::unordered_map<slim_mutationid_t, MutationIndex> &p_mutIndexMap)
+void Species::__CreateMutationsFromTabulation(std::vector<ts_mut_info> &p_mutInfo)
 {
 	// count the number of non-null genomes there are; this is the count that would represent fixation
 	slim_refcount_t fixation_count = 0;
@@ -8333,11 +9391,10 @@ void Species::__CreateMutationsFromTabulation(std::unordered_map<slim_mutationid
 			if (!genome->IsNull())
 				fixation_count++;
 	
-	// instantiate mutations
-	for (auto mut_info_iter : p_mutInfoMap)
+	// instantiate mutations, in order of mutation id
+	for (ts_mut_info &mut_info : p_mutInfo)
 	{
-		slim_mutationid_t mutation_id = mut_info_iter.first;
-		ts_mut_info &mut_info = mut_info_iter.second;
+		slim_mutationid_t mutation_id = mut_info.mutation_id;
 		MutationMetadataRec *metadata_ptr = &mut_info.metadata;
 		MutationMetadataRec metadata;
 		slim_position_t position = mut_info.position;
@@ -8373,8 +9430,7 @@ void Species::__CreateMutationsFromTabulation(std::unordered_map<slim_mutationid
 			population_.treeseq_substitutions_map_.emplace(position, sub);
 			population_.substitutions_.emplace_back(sub);
 			
-			// add -1 to our local map, so we know there's an entry but we also know it's a substitution
-			p_mutIndexMap[mutation_id] = -1;
+			// leave mut_index as -1, so we know it's a substitution
 		}
 		else
 		{
@@ -8383,8 +9439,8 @@ void Species::__CreateMutationsFromTabulation(std::unordered_map<slim_mutationid
 			
 			Mutation *new_mut = new (gSLiM_Mutation_Block + new_mut_index) Mutation(mutation_id, mutation_type_ptr, position, metadata.selection_coeff_, metadata.subpop_index_, metadata.origin_tick_, metadata.nucleotide_);
 			
-			// add it to our local map, so we can find it when making genomes, and to the population's mutation registry
-			p_mutIndexMap[mutation_id] = new_mut_index;
+			// record its index, so we can find it when making genomes, and add it to the population's mutation registry
+			mut_info.mut_index = new_mut_index;
 			population_.MutationRegistryAdd(new_mut);
 			
 #ifdef SLIM_KEEP_MUTTYPE_REGISTRIES
@@ -8402,115 +9458,155 @@ void Species::__CreateMutationsFromTabulation(std::unordered_map<slim_mutationid
 	}
 }
 
-void Species::__AddMutationsFromTreeSequenceToGenomes(std::unordered_map<slim_mutationid_t, MutationIndex> &p_mutIndexMap, std::unordered_map<tsk_id_t, Genome *> p_nodeToGenomeMap, tsk_treeseq_t *p_ts)
+void Species::__AddMutationsFromTreeSequenceToGenomes(std::vector<ts_mut_info> &p_mutInfo, std::vector<Genome *> &p_nodeToGenomeMap, tsk_treeseq_t *p_ts)
 {
 	// This code is based on Species::CrosscheckTreeSeqIntegrity(), but it can be much simpler.
 	// We also don't need to sort/deduplicate/simplify; the tables read in should be simplified already.
 	if (!recording_mutations_)
 		return;
 	
-	// allocate and set up the variant object we'll use to walk through sites
-	tsk_variant_t *variant;
-
-	variant = (tsk_variant_t *)malloc(sizeof(tsk_variant_t));
-	if (!variant)
-		EIDOS_TERMINATION << "ERROR (Species::__AddMutationsFromTreeSequenceToGenomes): allocation failed; you may need to raise the memory limit for SLiM." << EidosTerminate(nullptr);
+	// As in __TallyMutationReferencesWithTreeSequence(), each thread walks the variants for its own range of mutation runs, with its
+	// own tsk_variant_t.  Each thread therefore builds only the mutation runs it is responsible for, from its own MutationRunContext.
+	int mutrun_count_multiplier = chromosome_->mutrun_count_multiplier_;
+	int mutrun_context_count = SpeciesMutationRunContextCount();
+	slim_position_t mutrun_length = chromosome_->mutrun_length_;
+	int tsk_error = 0;
+	bool saw_error_1 = false, saw_error_2 = false, saw_error_3 = false;
+	slim_mutationid_t missing_mut_id = -1;
 	
-	int ret = tsk_variant_init(variant, p_ts, NULL, 0, NULL, TSK_ISOLATED_NOT_MISSING);
-	if (ret != 0) handle_error("__AddMutationsFromTreeSequenceToGenomes tsk_variant_init()", ret);
+	if (mutrun_count_multiplier * mutrun_context_count != chromosome_->mutrun_count_)
+		EIDOS_TERMINATION << "ERROR (Species::__AddMutationsFromTreeSequenceToGenomes): (internal error) mutation run subdivision is incorrect." << EidosTerminate();
 	
-	// set up a map from sample indices in the variant to Genome objects; the sample
-	// may contain nodes that are ancestral and need to be excluded
-	std::vector<Genome *> indexToGenomeMap;
-	size_t sample_count = variant->num_samples;
-	
-	for (size_t sample_index = 0; sample_index < sample_count; ++sample_index)
+	// THIS PARALLEL REGION CANNOT HAVE AN IF()!  IT MUST ALWAYS EXECUTE PARALLEL!
+	// Each thread must use the MutationRunContext for the mutation runs it builds, which is the context for its thread number.
+#pragma omp parallel default(none) shared(p_mutInfo, p_nodeToGenomeMap, p_ts, mutrun_count_multiplier, mutrun_length, missing_mut_id) reduction(min: tsk_error) reduction(||: saw_error_1) reduction(||: saw_error_2) reduction(||: saw_error_3) num_threads(mutrun_context_count)
 	{
-		tsk_id_t sample_node_id = variant->samples[sample_index];
-		auto sample_nodeToGenome_iter = p_nodeToGenomeMap.find(sample_node_id);
+		// this is initialized by OpenMP to the largest integer (reduction type min); we want zero instead!
+		tsk_error = 0;
 		
-		if (sample_nodeToGenome_iter != p_nodeToGenomeMap.end())
-		{
-			// we found a genome for this sample, so record it
-			indexToGenomeMap.emplace_back(sample_nodeToGenome_iter->second);
-		}
-		else
-		{
-			// this sample is not extant; no corresponding genome, so record nullptr
-			indexToGenomeMap.emplace_back(nullptr);
-		}
-	}
-	
-	// add mutations to genomes by looping through variants
-#ifndef _OPENMP
-	MutationRunContext &mutrun_context = SpeciesMutationRunContextForThread(omp_get_thread_num());	// when not parallel, we have only one MutationRunContext
-#endif
-	
-	for (tsk_size_t i = 0; i < p_ts->tables->sites.num_rows; i++)
-	{
-		ret = tsk_variant_decode(variant, (tsk_id_t)i, 0);
-		if (ret < 0) handle_error("__AddMutationsFromTreeSequenceToGenomes tsk_variant_decode()", ret);
+		MutationRunContext &mutrun_context = SpeciesMutationRunContextForThread(omp_get_thread_num());
+		int first_mutrun_index = omp_get_thread_num() * mutrun_count_multiplier;
+		int last_mutrun_index = first_mutrun_index + mutrun_count_multiplier - 1;
+		tsk_size_t first_site, end_site;
 		
-		// We have a new variant; set it into SLiM.  A variant represents a site at which a tracked mutation exists.
-		// The tsk_variant_t will tell us all the allelic states involved at that site, what the alleles are, and which genomes
-		// in the sample are using them.  We will then set all the genomes that the variant claims to involve to have
-		// the allele the variant attributes to them.  The variants are returned in sorted order by position, so we can
-		// always add new mutations to the ends of genomes.
-		slim_position_t variant_pos_int = (slim_position_t)variant->site.position;
+		_SiteRangeForMutationRuns(p_ts, mutrun_length, first_mutrun_index, last_mutrun_index, &first_site, &end_site);
 		
-		for (size_t sample_index = 0; sample_index < sample_count; sample_index++)
+		if (first_site < end_site)
 		{
-			Genome *genome = indexToGenomeMap[sample_index];
+			// set up the variant object we'll use to walk through sites
+			tsk_variant_t variant;
+			int ret = tsk_variant_init(&variant, p_ts, NULL, 0, NULL, TSK_ISOLATED_NOT_MISSING);
 			
-			if (genome)
+			if (ret != 0)
+				tsk_error = ret;
+			else
 			{
-				int32_t genome_variant = variant->genotypes[sample_index];
-				tsk_size_t genome_allele_length = variant->allele_lengths[genome_variant];
+				// set up a map from sample indices in the variant to Genome objects; the sample
+				// may contain nodes that are ancestral and need to be excluded
+				size_t sample_count = variant.num_samples;
+				std::vector<Genome *> indexToGenomeMap(sample_count);
+				std::vector<std::vector<MutationIndex>> allele_mut_indices;
 				
-				if (genome_allele_length % sizeof(slim_mutationid_t) != 0)
-					EIDOS_TERMINATION << "ERROR (Species::__AddMutationsFromTreeSequenceToGenomes): (internal error) variant allele had length that was not a multiple of sizeof(slim_mutationid_t)." << EidosTerminate();
-				genome_allele_length /= sizeof(slim_mutationid_t);
+				for (size_t sample_index = 0; sample_index < sample_count; ++sample_index)
+					indexToGenomeMap[sample_index] = p_nodeToGenomeMap[variant.samples[sample_index]];	// nullptr if not extant
 				
-				if (genome_allele_length > 0)
+				for (tsk_size_t i = first_site; i < end_site; i++)
 				{
-					if (genome->IsNull())
-						EIDOS_TERMINATION << "ERROR (Species::__AddMutationsFromTreeSequenceToGenomes): (internal error) null genome has non-zero treeseq allele length " << genome_allele_length << "." << EidosTerminate();
+					ret = tsk_variant_decode(&variant, (tsk_id_t)i, 0);
+					if (ret < 0) { tsk_error = ret; break; }
 					
-					slim_mutationid_t *genome_allele = (slim_mutationid_t *)variant->alleles[genome_variant];
-					slim_mutrun_index_t run_index = (slim_mutrun_index_t)(variant_pos_int / genome->mutrun_length_);
+					// We have a new variant; set it into SLiM.  A variant represents a site at which a tracked mutation exists.
+					// The tsk_variant_t will tell us all the allelic states involved at that site, what the alleles are, and which genomes
+					// in the sample are using them.  We will then set all the genomes that the variant claims to involve to have
+					// the allele the variant attributes to them.  The variants are returned in sorted order by position, so we can
+					// always add new mutations to the ends of genomes.
+					slim_position_t variant_pos_int = (slim_position_t)variant.site.position;
+					slim_mutrun_index_t run_index = (slim_mutrun_index_t)(variant_pos_int / mutrun_length);
 					
-#ifdef _OPENMP
-					// When parallel, the MutationRunContext depends upon the position in the genome
-					MutationRunContext &mutrun_context = SpeciesMutationRunContextForMutationRunIndex(run_index);
-#endif
-					
-					// We use WillModifyRun_UNSHARED() because we know that these runs are unshared (unless empty);
-					// we created them empty, nobody has modified them but us, and we process each genome separately.
-					MutationRun *mutrun = genome->WillModifyRun_UNSHARED(run_index, mutrun_context);
+					// Look up the mutations for each allele once, rather than once per genome; fixed mutations (mut_index == -1) are omitted
+					if (allele_mut_indices.size() < variant.num_alleles)
+						allele_mut_indices.resize(variant.num_alleles);
 					
-					for (tsk_size_t mutid_index = 0; mutid_index < genome_allele_length; ++mutid_index)
+					for (tsk_size_t allele_index = 0; allele_index < variant.num_alleles; ++allele_index)
 					{
-						slim_mutationid_t mut_id = genome_allele[mutid_index];
-						auto mut_index_iter = p_mutIndexMap.find(mut_id);
+						std::vector<MutationIndex> &mut_indices = allele_mut_indices[allele_index];
+						tsk_size_t allele_length = variant.allele_lengths[allele_index];
+						
+						mut_indices.clear();
 						
-						if (mut_index_iter == p_mutIndexMap.end())
-							EIDOS_TERMINATION << "ERROR (Species::__AddMutationsFromTreeSequenceToGenomes): mutation id " << mut_id << " was referenced but does not exist." << EidosTerminate();
+						if (allele_length % sizeof(slim_mutationid_t) != 0)
+						{
+							saw_error_1 = true;
+							continue;
+						}
+						allele_length /= sizeof(slim_mutationid_t);
 						
-						// Add the mutation to the genome unless it is fixed (mut_index == -1)
-						MutationIndex mut_index = mut_index_iter->second;
+						const slim_mutationid_t *allele = (const slim_mutationid_t *)variant.alleles[allele_index];
 						
-						if (mut_index != -1)
-							mutrun->emplace_back(mut_index);
+						for (tsk_size_t mutid_index = 0; mutid_index < allele_length; ++mutid_index)
+						{
+							slim_mutationid_t mut_id = allele[mutid_index];
+							ts_mut_info *mut_info = _FindTabulatedMutation(p_mutInfo, mut_id);
+							
+							if (!mut_info)
+							{
+								saw_error_3 = true;
+#pragma omp critical (AddMutationsFromTreeSequenceToGenomes_missing)
+								missing_mut_id = mut_id;
+								continue;
+							}
+							
+							if (mut_info->mut_index != -1)
+								mut_indices.emplace_back(mut_info->mut_index);
+						}
+					}
+					
+					for (size_t sample_index = 0; sample_index < sample_count; sample_index++)
+					{
+						Genome *genome = indexToGenomeMap[sample_index];
+						
+						if (genome)
+						{
+							int32_t genome_variant = variant.genotypes[sample_index];
+							
+							if (variant.allele_lengths[genome_variant] > 0)
+							{
+								if (genome->IsNull())
+								{
+									saw_error_2 = true;
+									continue;
+								}
+								
+								std::vector<MutationIndex> &mut_indices = allele_mut_indices[genome_variant];
+								
+								if (mut_indices.size())
+								{
+									// We use WillModifyRun_UNSHARED() because we know that these runs are unshared (unless empty);
+									// we created them empty, nobody has modified them but us, and we process each genome separately.
+									MutationRun *mutrun = genome->WillModifyRun_UNSHARED(run_index, mutrun_context);
+									
+									for (MutationIndex mut_index : mut_indices)
+										mutrun->emplace_back(mut_index);
+								}
+							}
+						}
 					}
 				}
+				
+				ret = tsk_variant_free(&variant);
+				if ((ret != 0) && (tsk_error == 0))
+					tsk_error = ret;
 			}
 		}
 	}
 	
-	// free
-	ret = tsk_variant_free(variant);
-	if (ret != 0) handle_error("__AddMutationsFromTreeSequenceToGenomes tsk_variant_free()", ret);
-	free(variant);
+	if (tsk_error != 0) handle_error("__AddMutationsFromTreeSequenceToGenomes tsk_variant_decode()", tsk_error);
+	if (saw_error_1)
+		EIDOS_TERMINATION << "ERROR (Species::__AddMutationsFromTreeSequenceToGenomes): (internal error) variant allele had length that was not a multiple of sizeof(slim_mutationid_t)." << EidosTerminate();
+	if (saw_error_2)
+		EIDOS_TERMINATION << "ERROR (Species::__AddMutationsFromTreeSequenceToGenomes): (internal error) null genome has non-zero treeseq allele length." << EidosTerminate();
+	if (saw_error_3)
+		EIDOS_TERMINATION << "ERROR (Species::__AddMutationsFromTreeSequenceToGenomes): mutation id " << missing_mut_id << " was referenced but does not exist." << EidosTerminate();
 }
 
 void Species::__CheckNodePedigreeIDs(EidosInterpreter *p_interpreter)
@@ -8607,7 +9703,8 @@ void Species::_InstantiateSLiMObjectsFromTables(EidosInterpreter *p_interpreter,
 	ret = tsk_treeseq_init(ts, &tables_, TSK_TS_INIT_BUILD_INDEXES);
 	if (ret != 0) handle_error("_InstantiateSLiMObjectsFromTables tsk_treeseq_init()", ret);
 	
-	std::unordered_map<tsk_id_t, Genome *> nodeToGenomeMap;
+	// a dense map from node ids to Genome objects; nullptr for nodes that do not correspond to an extant genome
+	std::vector<Genome *> nodeToGenomeMap(tables_.nodes.num_rows, nullptr);
 	
 	{
 		std::unordered_map<slim_objectid_t, ts_subpop_info> subpopInfoMap;
@@ -8618,18 +9715,15 @@ void Species::_InstantiateSLiMObjectsFromTables(EidosInterpreter *p_interpreter,
 		__ConfigureSubpopulationsFromTables(p_interpreter);
 	}
 	
-	std::unordered_map<slim_mutationid_t, MutationIndex> mutIndexMap;
-	
 	{
-		std::unordered_map<slim_mutationid_t, ts_mut_info> mutInfoMap;
+		std::vector<ts_mut_info> mutInfo;
 		
-		__TabulateMutationsFromTables(mutInfoMap, p_file_version);
-		__TallyMutationReferencesWithTreeSequence(mutInfoMap, nodeToGenomeMap, ts);
-		__CreateMutationsFromTabulation(mutInfoMap, mutIndexMap);
+		__TabulateMutationsFromTables(mutInfo, p_file_version);
+		__TallyMutationReferencesWithTreeSequence(mutInfo, nodeToGenomeMap, ts);
+		__CreateMutationsFromTabulation(mutInfo);
+		__AddMutationsFromTreeSequenceToGenomes(mutInfo, nodeToGenomeMap, ts);
 	}
 	
-	__AddMutationsFromTreeSequenceToGenomes(mutIndexMap, nodeToGenomeMap, ts);
-	
 	ret = tsk_treeseq_free(ts);
 	if (ret != 0) handle_error("_InstantiateSLiMObjectsFromTables tsk_treeseq_free()", ret);
 	free(ts);
@@ -8709,6 +9803,10 @@ void Species::_InstantiateSLiMObjectsFromTables(EidosInterpreter *p_interpreter,
 	
 	// Reset our last coalescence state; we don't know whether we're coalesced now or not
 	last_coalescence_state_ = false;
+	coalescence_sentinel_position_ = 0;
+	
+	// Loading is done with the node metadata, so from here on we can keep it packed
+	PackNodeMetadata();
 }
 
 slim_tick_t Species::_InitializePopulationFromTskitTextFile(const char *p_file, EidosInterpreter *p_interpreter, SUBPOP_REMAP_HASH &p_subpop_map)
@@ -8990,6 +10088,37 @@ size_t Species::MemoryUsageForTables(tsk_table_collection_t &p_tables)
 	
 	usage += remembered_genomes_.size() * sizeof(tsk_id_t);
 	
+	if (&p_tables == &tables_)
+		usage += packed_node_metadata_.MemoryUsage();
+	
+	return usage;
+}
+
+size_t Species::MemoryInUseForTables(tsk_table_collection_t &p_tables)
+{
+	// MemoryUsageForTables() reports allocated capacity, which tskit never gives back after simplification; this instead
+	// estimates the bytes occupied by rows actually in use, for the tables that grow as a model runs.  This is what the
+	// tableMemoryLimit of initializeTreeSeq() is compared against, since it goes back down when we simplify.
+	tsk_table_collection_t &t = p_tables;
+	size_t usage = 0;
+	
+	usage += t.individuals.num_rows * (sizeof(uint32_t) + 3 * sizeof(tsk_size_t));
+	usage += t.individuals.location_length * sizeof(double) + t.individuals.parents_length * sizeof(tsk_id_t) + t.individuals.metadata_length;
+	
+	usage += t.nodes.num_rows * (sizeof(uint32_t) + sizeof(double) + 2 * sizeof(tsk_id_t) + sizeof(tsk_size_t));
+	usage += t.nodes.metadata_length;
+	
+	if (&p_tables == &tables_)
+		usage += packed_node_metadata_.size() * sizeof(uint32_t);
+	
+	usage += t.edges.num_rows * (2 * sizeof(double) + 2 * sizeof(tsk_id_t));
+	
+	usage += t.sites.num_rows * (sizeof(double) + 2 * sizeof(tsk_size_t));
+	usage += t.sites.ancestral_state_length + t.sites.metadata_length;
+	
+	usage += t.mutations.num_rows * (3 * sizeof(tsk_id_t) + sizeof(double) + 2 * sizeof(tsk_size_t));
+	usage += t.mutations.derived_state_length + t.mutations.metadata_length;
+	
 	return usage;
 }
 
@@ -9006,6 +10135,7 @@ void Species::TSXC_Enable(void)
 	running_coalescence_checks_ = false;
 	running_treeseq_crosschecks_ = true;
 	treeseq_crosschecks_interval_ = 50;		// check every 50th cycle, otherwise it is just too slow
+	treeseq_crosschecks_sample_size_ = 10;	// in other cycles, check a sample of sites, which is cheap
 	
 	pedigrees_enabled_ = true;
 	pedigrees_enabled_by_SLiM_ = true;
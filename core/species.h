@@ -153,6 +153,33 @@ static_assert(sizeof(IndividualMetadataRec) == 40, "IndividualMetadataRec is not
 static_assert(sizeof(SubpopulationMetadataRec_PREJSON) == 88, "SubpopulationMetadataRec_PREJSON is not 88 bytes!");
 static_assert(sizeof(SubpopulationMigrationMetadataRec_PREJSON) == 12, "SubpopulationMigrationMetadataRec_PREJSON is not 12 bytes!");
 
+// PackedNodeMetadata holds the GenomeMetadataRec for each row of the node table in a compact columnar form while
+// a model runs, rather than as 10 bytes per node in the tskit metadata column; it is expanded back to the standard
+// records only for output.  Nodes are recorded in nearly increasing genome id order, so genome ids are stored as
+// frame-of-reference offsets from a base value for each block of nodes, packed into one 32-bit word per node along
+// with is_null_ and type_.  Rows without SLiM metadata, and records that do not fit, use the two reserved words.
+class PackedNodeMetadata
+{
+private:
+	static const size_t kBlockSize = 256;					// nodes per frame-of-reference block
+	static const uint32_t kWordAbsent = 0xFFFFFFFF;			// the node has no metadata at all
+	static const uint32_t kWordException = 0xFFFFFFFE;		// the node's record is in exceptions_
+	static const int64_t kOffsetBias = ((int64_t)1) << 28;	// offsets are stored biased, to allow ids below the base
+
+	std::vector<slim_genomeid_t> block_base_;				// the reference genome id for each block
+	std::vector<uint32_t> words_;							// (offset + kOffsetBias) << 3 | is_null_ << 2 | type_, per node
+	std::vector<std::pair<size_t, GenomeMetadataRec>> exceptions_;	// records that could not be packed, by node index
+	bool last_block_has_base_ = false;						// true once a node with metadata has set the base of the last block
+
+public:
+	inline size_t size(void) const { return words_.size(); }
+	void clear(void);
+	void push_back(const GenomeMetadataRec *p_metadata);	// nullptr for a node without metadata
+	void truncate(size_t p_size);
+	bool get(size_t p_index, GenomeMetadataRec *p_metadata) const;	// returns false for a node without metadata
+	size_t MemoryUsage(void) const;
+};
+
 // We check endianness on the platform we're building on; we assume little-endianness in our read/write code, I think.
 #if defined(__BYTE_ORDER__)
 #if (__BYTE_ORDER__ == __ORDER_BIG_ENDIAN__)
@@ -171,6 +198,8 @@ class Species : public EidosDictionaryUnretained
 	
 private:
 	typedef EidosDictionaryUnretained super;
+	
+	friend class SLiMCheckpoint;				// reads and writes private state for checkpointing
 
 #ifdef SLIMGUI
 public:
@@ -213,6 +242,7 @@ private:
 	slim_tick_t InitializePopulationFromFile(const std::string &p_file_string, EidosInterpreter *p_interpreter, SUBPOP_REMAP_HASH &p_subpop_remap);	// initialize the population from the file
 	slim_tick_t _InitializePopulationFromTextFile(const char *p_file, EidosInterpreter *p_interpreter);				// initialize the population from a SLiM text file
 	slim_tick_t _InitializePopulationFromBinaryFile(const char *p_file, EidosInterpreter *p_interpreter);			// initialize the population from a SLiM binary file
+	slim_tick_t _InitializePopulationFromBinaryBuffer(char *p_buffer, std::size_t p_buffer_size, EidosInterpreter *p_interpreter);	// initialize the population from SLiM binary data in memory
 	
 	// initialization completeness check counts; used only when running initialize() callbacks
 	int num_mutation_types_;
@@ -330,17 +360,24 @@ private:
 	typedef std::unordered_map<slim_pedigreeid_t, tsk_id_t> INDIVIDUALS_HASH;
  #endif
 	INDIVIDUALS_HASH tabled_individuals_hash_;	// look up individuals table row numbers from pedigree IDs
+	
+	bool node_metadata_packed_ = false;			// if true, node metadata is kept in packed_node_metadata_, and tables_.nodes has none
+	PackedNodeMetadata packed_node_metadata_;	// the metadata for each row of tables_.nodes, when node_metadata_packed_ is true
 
 	bool running_coalescence_checks_ = false;	// true if we check for coalescence after each simplification
 	bool last_coalescence_state_ = false;		// if running_coalescence_checks_==true, updated every simplification
+	double coalescence_sentinel_position_ = 0;	// the position where we last found the model uncoalesced; checked first next time
 	
 	bool running_treeseq_crosschecks_ = false;	// true if crosschecks between our tree sequence tables and SLiM's data are enabled
 	int treeseq_crosschecks_interval_ = 1;		// crosschecks, if enabled, will be done every treeseq_crosschecks_interval_ cycles
+	int treeseq_crosschecks_sample_size_ = 0;	// if > 0, a sampled crosscheck of this many sites is done in the cycles between full crosschecks
 	
 	double simplification_ratio_;				// the pre:post table size ratio we target with our automatic simplification heuristic
 	int64_t simplification_interval_;			// the cycle interval between simplifications; -1 if not used (in which case the ratio is used)
 	int64_t simplify_elapsed_ = 0;				// the number of cycles elapsed since a simplification was done (automatic or otherwise)
 	double simplify_interval_;					// the current number of cycles between automatic simplifications when using simplification_ratio_
+	size_t table_memory_limit_ = 0;				// if > 0, auto-simplify whenever the in-use size of the tables exceeds this many bytes
+	bool warned_table_memory_limit_ = false;	// true once we have warned that simplification could not get under table_memory_limit_
 	
 public:
 	
@@ -583,7 +620,8 @@ public:
 	void WriteProvenanceTable(tsk_table_collection_t *p_tables, bool p_use_newlines, bool p_include_model);
 	void WriteTreeSequenceMetadata(tsk_table_collection_t *p_tables, EidosDictionaryUnretained *p_metadata_dict);
 	void ReadTreeSequenceMetadata(tsk_table_collection_t *p_tables, slim_tick_t *p_tick, slim_tick_t *p_cycle, SLiMModelType *p_model_type, int *p_file_version);
-	void WriteTreeSequence(std::string &p_recording_tree_path, bool p_binary, bool p_simplify, bool p_include_model, EidosDictionaryUnretained *p_metadata_dict);
+	void OverlayNeutralMutations(tsk_table_collection_t *p_tables, MutationType *p_mutation_type, double p_rate);
+	void WriteTreeSequence(std::string &p_recording_tree_path, bool p_binary, bool p_simplify, bool p_include_model, EidosDictionaryUnretained *p_metadata_dict, MutationType *p_overlay_mutation_type, double p_overlay_rate);
     void ReorderIndividualTable(tsk_table_collection_t *p_tables, std::vector<int> p_individual_map, bool p_keep_unmapped);
 	void AddParentsColumnForOutput(tsk_table_collection_t *p_tables, INDIVIDUALS_HASH *p_individuals_hash);
 	void BuildTabledIndividualsHash(tsk_table_collection_t *p_tables, INDIVIDUALS_HASH *p_individuals_hash);
@@ -592,28 +630,32 @@ public:
 	void CheckAutoSimplification(void);
     void TreeSequenceDataFromAscii(const std::string &NodeFileName, const std::string &EdgeFileName, const std::string &SiteFileName, const std::string &MutationFileName, const std::string &IndividualsFileName, const std::string &PopulationFileName, const std::string &ProvenanceFileName);
 	void FreeTreeSequence();
+	void PackNodeMetadata(void);
+	void UnpackNodeMetadata(tsk_table_collection_t *p_tables);
 	void RecordAllDerivedStatesFromSLiM(void);
 	void DumpMutationTable(void);
 	void CheckTreeSeqIntegrity(void);		// checks the tree sequence tables themselves
 	void CrosscheckTreeSeqIntegrity(void);	// checks the tree sequence tables against SLiM's data structures
+	void CrosscheckTreeSeqIntegrity_Sampled(int p_position_count);	// checks a random sample of sites, without copying the tables
 	
 	void __RewriteOldIndividualsMetadata(int p_file_version);
 	void __RewriteOrCheckPopulationMetadata(void);
 	void __RemapSubpopulationIDs(SUBPOP_REMAP_HASH &p_subpop_map, int p_file_version);
 	void __PrepareSubpopulationsFromTables(std::unordered_map<slim_objectid_t, ts_subpop_info> &p_subpopInfoMap);
 	void __TabulateSubpopulationsFromTreeSequence(std::unordered_map<slim_objectid_t, ts_subpop_info> &p_subpopInfoMap, tsk_treeseq_t *p_ts, SLiMModelType p_file_model_type);
-	void __CreateSubpopulationsFromTabulation(std::unordered_map<slim_objectid_t, ts_subpop_info> &p_subpopInfoMap, EidosInterpreter *p_interpreter, std::unordered_map<tsk_id_t, Genome *> &p_nodeToGenomeMap);
+	void __CreateSubpopulationsFromTabulation(std::unordered_map<slim_objectid_t, ts_subpop_info> &p_subpopInfoMap, EidosInterpreter *p_interpreter, std::vector<Genome *> &p_nodeToGenomeMap);
 	void __ConfigureSubpopulationsFromTables(EidosInterpreter *p_interpreter);
-	void __TabulateMutationsFromTables(std::unordered_map<slim_mutationid_t, ts_mut_info> &p_mutMap, int p_file_version);
-	void __TallyMutationReferencesWithTreeSequence(std::unordered_map<slim_mutationid_t, ts_mut_info> &p_mutMap, std::unordered_map<tsk_id_t, Genome *> p_nodeToGenomeMap, tsk_treeseq_t *p_ts);
-	void __CreateMutationsFromTabulation(std::unordered_map<slim_mutationid_t, ts_mut_info> &p_mutInfoMap, std::unordered_map<slim_mutationid_t, MutationIndex> &p_mutIndexMap);
-	void __AddMutationsFromTreeSequenceToGenomes(std::unordered_map<slim_mutationid_t, MutationIndex> &p_mutIndexMap, std::unordered_map<tsk_id_t, Genome *> p_nodeToGenomeMap, tsk_treeseq_t *p_ts);
+	void __TabulateMutationsFromTables(std::vector<ts_mut_info> &p_mutInfo, int p_file_version);
+	void __TallyMutationReferencesWithTreeSequence(std::vector<ts_mut_info> &p_mutInfo, std::vector<Genome *> &p_nodeToGenomeMap, tsk_treeseq_t *p_ts);
+	void __CreateMutationsFromTabulation(std::vector<ts_mut_info> &p_mutInfo);
+	void __AddMutationsFromTreeSequenceToGenomes(std::vector<ts_mut_info> &p_mutInfo, std::vector<Genome *> &p_nodeToGenomeMap, tsk_treeseq_t *p_ts);
 	void __CheckNodePedigreeIDs(EidosInterpreter *p_interpreter);
 	void _InstantiateSLiMObjectsFromTables(EidosInterpreter *p_interpreter, slim_tick_t p_metadata_tick, slim_tick_t p_metadata_cycle, SLiMModelType p_file_model_type, int p_file_version, SUBPOP_REMAP_HASH &p_subpop_map);	// given tree-seq tables, makes individuals, genomes, and mutations
 	slim_tick_t _InitializePopulationFromTskitTextFile(const char *p_file, EidosInterpreter *p_interpreter, SUBPOP_REMAP_HASH &p_subpop_map);	// initialize the population from an tskit text file
 	slim_tick_t _InitializePopulationFromTskitBinaryFile(const char *p_file, EidosInterpreter *p_interpreter, SUBPOP_REMAP_HASH &p_subpop_remap);	// initialize the population from an tskit binary file
 	
 	size_t MemoryUsageForTables(tsk_table_collection_t &p_tables);
+	size_t MemoryInUseForTables(tsk_table_collection_t &p_tables);
 	void TSXC_Enable(void);
 	void TSF_Enable(void);
 	
@@ -1266,7 +1266,7 @@ EidosValue_SP Species::ExecuteContextFunction_initializeSpecies(const std::strin
 }
 
 // TREE SEQUENCE RECORDING
-//	*********************	(void)initializeTreeSeq([logical$ recordMutations = T], [Nif$ simplificationRatio = NULL], [Ni$ simplificationInterval = NULL], [logical$ checkCoalescence = F], [logical$ runCrosschecks = F], [logical$ retainCoalescentOnly = T], [Ns$ timeUnit = NULL])
+//	*********************	(void)initializeTreeSeq([logical$ recordMutations = T], [Nif$ simplificationRatio = NULL], [Ni$ simplificationInterval = NULL], [logical$ checkCoalescence = F], [logical$ runCrosschecks = F], [logical$ retainCoalescentOnly = T], [Ns$ timeUnit = NULL], [Nif$ tableMemoryLimit = NULL])
 //
 EidosValue_SP Species::ExecuteContextFunction_initializeTreeSeq(const std::string &p_function_name, const std::vector<EidosValue_SP> &p_arguments, EidosInterpreter &p_interpreter)
 {
@@ -1278,6 +1278,7 @@ EidosValue_SP Species::ExecuteContextFunction_initializeTreeSeq(const std::strin
 	EidosValue *arg_runCrosschecks_value = p_arguments[4].get();
 	EidosValue *arg_retainCoalescentOnly_value = p_arguments[5].get();
 	EidosValue *arg_timeUnit_value = p_arguments[6].get();
+	EidosValue *arg_tableMemoryLimit_value = p_arguments[7].get();
 	std::ostream &output_stream = p_interpreter.ExecutionOutputStream();
 	
 	if (num_treeseq_declarations_ > 0)
@@ -1337,6 +1338,20 @@ EidosValue_SP Species::ExecuteContextFunction_initializeTreeSeq(const std::strin
 			EIDOS_TERMINATION << "ERROR (Species::ExecuteContextFunction_initializeTreeSeq): initializeTreeSeq() requires simplificationInterval to be > 0." << EidosTerminate();
 	}
 	
+	// The table memory limit is given in MB, like the memory usage reported by usage(); zero or NULL means no limit
+	table_memory_limit_ = 0;
+	
+	if (arg_tableMemoryLimit_value->Type() != EidosValueType::kValueNULL)
+	{
+		double limit_MB = arg_tableMemoryLimit_value->NumericAtIndex_NOCAST(0, nullptr);
+		
+		if (std::isnan(limit_MB) || (limit_MB < 0))
+			EIDOS_TERMINATION << "ERROR (Species::ExecuteContextFunction_initializeTreeSeq): initializeTreeSeq() requires tableMemoryLimit to be >= 0." << EidosTerminate();
+		
+		if (!std::isinf(limit_MB))
+			table_memory_limit_ = (size_t)(limit_MB * 1024.0 * 1024.0);
+	}
+	
 	// Pedigree recording is turned on as a side effect of tree sequence recording, since we need to
 	// have unique identifiers for every individual; pedigree recording does that for us
 	pedigrees_enabled_ = true;
@@ -1412,6 +1427,13 @@ EidosValue_SP Species::ExecuteContextFunction_initializeTreeSeq(const std::strin
 			if (previous_params) output_stream << ", ";
 			output_stream << "timeUnit = '" << community_.treeseq_time_unit_ << "'";	// assumes a simple string with no quotes
 			previous_params = true;
+		}
+		
+		if (arg_tableMemoryLimit_value->Type() != EidosValueType::kValueNULL)
+		{
+			if (previous_params) output_stream << ", ";
+			output_stream << "tableMemoryLimit = " << arg_tableMemoryLimit_value->NumericAtIndex_NOCAST(0, nullptr);
+			previous_params = true;
 			(void)previous_params;	// dead store above is deliberate
 		}
 		
@@ -2876,7 +2898,7 @@ EidosValue_SP Species::ExecuteMethod_registerMutationCallback(EidosGlobalStringI
 	return new_script_block->SelfSymbolTableEntry().second;
 }
 
-//	*********************	– (object<SLiMEidosBlock>$)registerMutationEffectCallback(Nis$ id, string$ source, io<MutationType>$ mutType, [Nio<Subpopulation>$ subpop = NULL], [Ni$ start = NULL], [Ni$ end = NULL])
+//	*********************	– (object<SLiMEidosBlock>$)registerMutationEffectCallback(Nis$ id, string$ source, io<MutationType>$ mutType, [Nio<Subpopulation>$ subpop = NULL], [Ni$ start = NULL], [Ni$ end = NULL], [logical$ vectorized = F])
 //
 EidosValue_SP Species::ExecuteMethod_registerMutationEffectCallback(EidosGlobalStringID p_method_id, const std::vector<EidosValue_SP> &p_arguments, EidosInterpreter &p_interpreter)
 {
@@ -2887,6 +2909,7 @@ EidosValue_SP Species::ExecuteMethod_registerMutationEffectCallback(EidosGlobalS
 	EidosValue *subpop_value = p_arguments[3].get();
 	EidosValue *start_value = p_arguments[4].get();
 	EidosValue *end_value = p_arguments[5].get();
+	EidosValue *vectorized_value = p_arguments[6].get();
 	
 	slim_objectid_t script_id = -1;		// used if id_value is NULL, to indicate an anonymous block
 	std::string script_string = source_value->StringAtIndex_NOCAST(0, nullptr);
@@ -2913,6 +2936,7 @@ EidosValue_SP Species::ExecuteMethod_registerMutationEffectCallback(EidosGlobalS
 	
 	new_script_block->mutation_type_id_ = mut_type_id;
 	new_script_block->subpopulation_id_ = subpop_id;
+	new_script_block->vectorized_ = vectorized_value->LogicalAtIndex_NOCAST(0, nullptr);
 	
 	// SPECIES CONSISTENCY CHECK (done by AddScriptBlock())
 	community_.AddScriptBlock(new_script_block, &p_interpreter, nullptr);		// takes ownership from us
@@ -3254,7 +3278,7 @@ EidosValue_SP Species::ExecuteMethod_treeSeqRememberIndividuals(EidosGlobalStrin
 }
 
 // TREE SEQUENCE RECORDING
-//	*********************	- (void)treeSeqOutput(string$ path, [logical$ simplify = T], [logical$ includeModel = T], [No$ metadata = NULL], [logical$ _binary = T]) (note the _binary flag is undocumented)
+//	*********************	- (void)treeSeqOutput(string$ path, [logical$ simplify = T], [logical$ includeModel = T], [No$ metadata = NULL], [Nio<MutationType>$ overlayMutationType = NULL], [Nif$ overlayRate = NULL], [logical$ _binary = T]) (note the _binary flag is undocumented)
 //
 EidosValue_SP Species::ExecuteMethod_treeSeqOutput(EidosGlobalStringID p_method_id, const std::vector<EidosValue_SP> &p_arguments, EidosInterpreter &p_interpreter)
 {
@@ -3263,7 +3287,9 @@ EidosValue_SP Species::ExecuteMethod_treeSeqOutput(EidosGlobalStringID p_method_
 	EidosValue *simplify_value = p_arguments[1].get();
 	EidosValue *includeModel_value = p_arguments[2].get();
 	EidosValue *metadata_value = p_arguments[3].get();
-	EidosValue *binary_value = p_arguments[4].get();
+	EidosValue *overlayMutationType_value = p_arguments[4].get();
+	EidosValue *overlayRate_value = p_arguments[5].get();
+	EidosValue *binary_value = p_arguments[6].get();
 	
 	if (!recording_tree_)
 		EIDOS_TERMINATION << "ERROR (Species::ExecuteMethod_treeSeqOutput): treeSeqOutput() may only be called when tree recording is enabled." << EidosTerminate();
@@ -3301,7 +3327,26 @@ EidosValue_SP Species::ExecuteMethod_treeSeqOutput(EidosGlobalStringID p_method_
 			EIDOS_TERMINATION << "ERROR (Species::ExecuteMethod_treeSeqOutput): (internal) metadata object did not convert to EidosDictionaryUnretained." << EidosTerminate();	// should never happen
 	}
 	
-	WriteTreeSequence(path_string, binary, simplify, includeModel, metadata_dict);
+	// Neutral mutations can be overlaid onto the output tables; the rate defaults to the chromosome's mutation rate map
+	MutationType *overlay_mutation_type = nullptr;
+	double overlay_rate = -1;
+	
+	if (overlayMutationType_value->Type() != EidosValueType::kValueNULL)
+	{
+		overlay_mutation_type = SLiM_ExtractMutationTypeFromEidosValue_io(overlayMutationType_value, 0, &community_, this, "treeSeqOutput()");		// SPECIES CONSISTENCY CHECK
+		
+		if (overlayRate_value->Type() != EidosValueType::kValueNULL)
+		{
+			overlay_rate = overlayRate_value->NumericAtIndex_NOCAST(0, nullptr);
+			
+			if (!std::isfinite(overlay_rate) || (overlay_rate < 0))
+				EIDOS_TERMINATION << "ERROR (Species::ExecuteMethod_treeSeqOutput): treeSeqOutput() requires overlayRate to be finite and >= 0." << EidosTerminate();
+		}
+	}
+	else if (overlayRate_value->Type() != EidosValueType::kValueNULL)
+		EIDOS_TERMINATION << "ERROR (Species::ExecuteMethod_treeSeqOutput): treeSeqOutput() requires overlayMutationType to be supplied if overlayRate is supplied." << EidosTerminate();
+	
+	WriteTreeSequence(path_string, binary, simplify, includeModel, metadata_dict, overlay_mutation_type, overlay_rate);
 	
 	return gStaticEidosValueVOID;
 }
@@ -3405,7 +3450,7 @@ const std::vector<EidosMethodSignature_CSP> *Species_Class::Methods(void) const
 		methods->emplace_back((EidosInstanceMethodSignature *)(new EidosInstanceMethodSignature(gStr_registerRecombinationCallback, kEidosValueMaskObject | kEidosValueMaskSingleton, gSLiM_SLiMEidosBlock_Class))->AddIntString_SN("id")->AddString_S(gEidosStr_source)->AddIntObject_OSN("subpop", gSLiM_Subpopulation_Class, gStaticEidosValueNULL)->AddInt_OSN("start", gStaticEidosValueNULL)->AddInt_OSN("end", gStaticEidosValueNULL));
 		methods->emplace_back((EidosInstanceMethodSignature *)(new EidosInstanceMethodSignature(gStr_registerSurvivalCallback, kEidosValueMaskObject | kEidosValueMaskSingleton, gSLiM_SLiMEidosBlock_Class))->AddIntString_SN("id")->AddString_S(gEidosStr_source)->AddIntObject_OSN("subpop", gSLiM_Subpopulation_Class, gStaticEidosValueNULL)->AddInt_OSN("start", gStaticEidosValueNULL)->AddInt_OSN("end", gStaticEidosValueNULL));
 		methods->emplace_back((EidosInstanceMethodSignature *)(new EidosInstanceMethodSignature(gStr_registerMutationCallback, kEidosValueMaskObject | kEidosValueMaskSingleton, gSLiM_SLiMEidosBlock_Class))->AddIntString_SN("id")->AddString_S(gEidosStr_source)->AddIntObject_OSN("mutType", gSLiM_MutationType_Class, gStaticEidosValueNULL)->AddIntObject_OSN("subpop", gSLiM_Subpopulation_Class, gStaticEidosValueNULL)->AddInt_OSN("start", gStaticEidosValueNULL)->AddInt_OSN("end", gStaticEidosValueNULL));
-		methods->emplace_back((EidosInstanceMethodSignature *)(new EidosInstanceMethodSignature(gStr_registerMutationEffectCallback, kEidosValueMaskObject | kEidosValueMaskSingleton, gSLiM_SLiMEidosBlock_Class))->AddIntString_SN("id")->AddString_S(gEidosStr_source)->AddIntObject_S("mutType", gSLiM_MutationType_Class)->AddIntObject_OSN("subpop", gSLiM_Subpopulation_Class, gStaticEidosValueNULL)->AddInt_OSN("start", gStaticEidosValueNULL)->AddInt_OSN("end", gStaticEidosValueNULL));
+		methods->emplace_back((EidosInstanceMethodSignature *)(new EidosInstanceMethodSignature(gStr_registerMutationEffectCallback, kEidosValueMaskObject | kEidosValueMaskSingleton, gSLiM_SLiMEidosBlock_Class))->AddIntString_SN("id")->AddString_S(gEidosStr_source)->AddIntObject_S("mutType", gSLiM_MutationType_Class)->AddIntObject_OSN("subpop", gSLiM_Subpopulation_Class, gStaticEidosValueNULL)->AddInt_OSN("start", gStaticEidosValueNULL)->AddInt_OSN("end", gStaticEidosValueNULL)->AddLogical_OS("vectorized", gStaticEidosValue_LogicalF));
 		methods->emplace_back((EidosInstanceMethodSignature *)(new EidosInstanceMethodSignature(gStr_registerReproductionCallback, kEidosValueMaskObject | kEidosValueMaskSingleton, gSLiM_SLiMEidosBlock_Class))->AddIntString_SN("id")->AddString_S(gEidosStr_source)->AddIntObject_OSN("subpop", gSLiM_Subpopulation_Class, gStaticEidosValueNULL)->AddString_OSN("sex", gStaticEidosValueNULL)->AddInt_OSN("start", gStaticEidosValueNULL)->AddInt_OSN("end", gStaticEidosValueNULL));
 		methods->emplace_back((EidosInstanceMethodSignature *)(new EidosInstanceMethodSignature(gStr_simulationFinished, kEidosValueMaskVOID)));
 		methods->emplace_back((EidosInstanceMethodSignature *)(new EidosInstanceMethodSignature(gStr_skipTick, kEidosValueMaskVOID)));
@@ -3413,7 +3458,7 @@ const std::vector<EidosMethodSignature_CSP> *Species_Class::Methods(void) const
 		methods->emplace_back((EidosInstanceMethodSignature *)(new EidosInstanceMethodSignature(gStr_treeSeqCoalesced, kEidosValueMaskLogical | kEidosValueMaskSingleton)));
 		methods->emplace_back((EidosInstanceMethodSignature *)(new EidosInstanceMethodSignature(gStr_treeSeqSimplify, kEidosValueMaskVOID)));
 		methods->emplace_back((EidosInstanceMethodSignature *)(new EidosInstanceMethodSignature(gStr_treeSeqRememberIndividuals, kEidosValueMaskVOID))->AddObject("individuals", gSLiM_Individual_Class)->AddLogical_OS("permanent", gStaticEidosValue_LogicalT));
-		methods->emplace_back((EidosInstanceMethodSignature *)(new EidosInstanceMethodSignature(gStr_treeSeqOutput, kEidosValueMaskVOID))->AddString_S("path")->AddLogical_OS("simplify", gStaticEidosValue_LogicalT)->AddLogical_OS("includeModel", gStaticEidosValue_LogicalT)->AddObject_OSN("metadata", nullptr, gStaticEidosValueNULL)->AddLogical_OS("_binary", gStaticEidosValue_LogicalT));
+		methods->emplace_back((EidosInstanceMethodSignature *)(new EidosInstanceMethodSignature(gStr_treeSeqOutput, kEidosValueMaskVOID))->AddString_S("path")->AddLogical_OS("simplify", gStaticEidosValue_LogicalT)->AddLogical_OS("includeModel", gStaticEidosValue_LogicalT)->AddObject_OSN("metadata", nullptr, gStaticEidosValueNULL)->AddIntObject_OSN("overlayMutationType", gSLiM_MutationType_Class, gStaticEidosValueNULL)->AddNumeric_OSN("overlayRate", gStaticEidosValueNULL)->AddLogical_OS("_binary", gStaticEidosValue_LogicalT));
 		methods->emplace_back((EidosInstanceMethodSignature *)(new EidosInstanceMethodSignature(gStr__debug, kEidosValueMaskVOID)));
 		
 		std::sort(methods->begin(), methods->end(), CompareEidosCallSignatures);
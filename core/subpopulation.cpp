@@ -38,6 +38,7 @@
 #include <map>
 #include <utility>
 #include <cmath>
+#include <memory>
 
 
 #pragma mark -
@@ -1292,6 +1293,24 @@ void Subpopulation::UpdateFitness(std::vector<SLiMEidosBlock*> &p_mutationEffect
 				}
 	}
 	
+	// If any active mutationEffect() callback is vectorized (a mutationEffects() callback), the mutation effects for all parents are
+	// computed together here, up front, and the loops below just look up each individual's result; see FitnessOfParents_VectorizedCallbacks()
+	bool vectorized_mutationEffect_callbacks = false;
+	std::vector<double> vectorized_parent_fitness;
+	
+	if (mutationEffect_callbacks_exist && !skip_chromosomal_fitness)
+	{
+		for (SLiMEidosBlock *mutationEffect_callback : p_mutationEffect_callbacks)
+			if (mutationEffect_callback->block_active_ && mutationEffect_callback->vectorized_)
+			{
+				vectorized_mutationEffect_callbacks = true;
+				break;
+			}
+		
+		if (vectorized_mutationEffect_callbacks)
+			FitnessOfParents_VectorizedCallbacks(p_mutationEffect_callbacks, vectorized_parent_fitness);
+	}
+	
 	// calculate fitnesses in parent population and cache the values
 	if (sex_enabled_)
 	{
@@ -1452,6 +1471,8 @@ void Subpopulation::UpdateFitness(std::vector<SLiMEidosBlock*> &p_mutationEffect
 						{
 							if (!mutationEffect_callbacks_exist)
 								fitness *= FitnessOfParentWithGenomeIndices_NoCallbacks(female_index);
+							else if (vectorized_mutationEffect_callbacks)
+								fitness *= vectorized_parent_fitness[female_index];
 							else if (single_mutationEffect_callback)
 								fitness *= FitnessOfParentWithGenomeIndices_SingleCallback(female_index, p_mutationEffect_callbacks, single_callback_mut_type);
 							else
@@ -1493,6 +1514,8 @@ void Subpopulation::UpdateFitness(std::vector<SLiMEidosBlock*> &p_mutationEffect
 					{
 						if (!mutationEffect_callbacks_exist)
 							fitness *= FitnessOfParentWithGenomeIndices_NoCallbacks(female_index);
+						else if (vectorized_mutationEffect_callbacks)
+							fitness *= vectorized_parent_fitness[female_index];
 						else if (single_mutationEffect_callback)
 							fitness *= FitnessOfParentWithGenomeIndices_SingleCallback(female_index, p_mutationEffect_callbacks, single_callback_mut_type);
 						else
@@ -1675,6 +1698,8 @@ void Subpopulation::UpdateFitness(std::vector<SLiMEidosBlock*> &p_mutationEffect
 						{
 							if (!mutationEffect_callbacks_exist)
 								fitness *= FitnessOfParentWithGenomeIndices_NoCallbacks(male_index);
+							else if (vectorized_mutationEffect_callbacks)
+								fitness *= vectorized_parent_fitness[male_index];
 							else if (single_mutationEffect_callback)
 								fitness *= FitnessOfParentWithGenomeIndices_SingleCallback(male_index, p_mutationEffect_callbacks, single_callback_mut_type);
 							else
@@ -1717,6 +1742,8 @@ void Subpopulation::UpdateFitness(std::vector<SLiMEidosBlock*> &p_mutationEffect
 					{
 						if (!mutationEffect_callbacks_exist)
 							fitness *= FitnessOfParentWithGenomeIndices_NoCallbacks(male_index);
+						else if (vectorized_mutationEffect_callbacks)
+							fitness *= vectorized_parent_fitness[male_index];
 						else if (single_mutationEffect_callback)
 							fitness *= FitnessOfParentWithGenomeIndices_SingleCallback(male_index, p_mutationEffect_callbacks, single_callback_mut_type);
 						else
@@ -1914,6 +1941,8 @@ void Subpopulation::UpdateFitness(std::vector<SLiMEidosBlock*> &p_mutationEffect
 						{
 							if (!mutationEffect_callbacks_exist)
 								fitness *= FitnessOfParentWithGenomeIndices_NoCallbacks(individual_index);
+							else if (vectorized_mutationEffect_callbacks)
+								fitness *= vectorized_parent_fitness[individual_index];
 							else if (single_mutationEffect_callback)
 								fitness *= FitnessOfParentWithGenomeIndices_SingleCallback(individual_index, p_mutationEffect_callbacks, single_callback_mut_type);
 							else
@@ -1955,6 +1984,8 @@ void Subpopulation::UpdateFitness(std::vector<SLiMEidosBlock*> &p_mutationEffect
 					{
 						if (!mutationEffect_callbacks_exist)
 							fitness *= FitnessOfParentWithGenomeIndices_NoCallbacks(individual_index);
+						else if (vectorized_mutationEffect_callbacks)
+							fitness *= vectorized_parent_fitness[individual_index];
 						else if (single_mutationEffect_callback)
 							fitness *= FitnessOfParentWithGenomeIndices_SingleCallback(individual_index, p_mutationEffect_callbacks, single_callback_mut_type);
 						else
@@ -2287,6 +2318,158 @@ double Subpopulation::ApplyMutationEffectCallbacks(MutationIndex p_mutation, int
 	return p_computed_fitness;
 }
 
+// This is the vectorized counterpart of ApplyMutationEffectCallbacks(), for a single mutationEffects() callback.  The callback is
+// called once, with vectors of the mutations, homozygosity flags, effects, and individuals for the batch entries selected by
+// p_batch_indices, and returns either a vector of new effects (one per entry) or a singleton effect that applies to all of them.
+void Subpopulation::ApplyMutationEffectCallback_Vectorized(SLiMEidosBlock *p_mutationEffect_callback, const std::vector<uint32_t> &p_batch_indices, const std::vector<MutationIndex> &p_batch_muts, const std::vector<int8_t> &p_batch_homozygous, std::vector<double> &p_batch_effects, const std::vector<slim_popsize_t> &p_batch_owners)
+{
+	THREAD_SAFETY_IN_ANY_PARALLEL("Population::ApplyMutationEffectCallback_Vectorized(): running Eidos callback");
+	
+	size_t batch_count = p_batch_indices.size();
+	
+	if (batch_count == 0)
+		return;
+	
+#if (SLIMPROFILING == 1)
+	// PROFILING
+	SLIM_PROFILE_BLOCK_START();
+#endif
+	
+#if DEBUG_POINTS_ENABLED
+	// SLiMgui debugging point
+	EidosDebugPointIndent indenter;
+	
+	{
+		EidosInterpreterDebugPointsSet *debug_points = community_.DebugPoints();
+		EidosToken *decl_token = p_mutationEffect_callback->root_node_->token_;
+		
+		if (debug_points && debug_points->set.size() && (decl_token->token_line_ != -1) &&
+			(debug_points->set.find(decl_token->token_line_) != debug_points->set.end()))
+		{
+			SLIM_ERRSTREAM << EidosDebugPointIndent::Indent() << "#DEBUG mutationEffects(m" << p_mutationEffect_callback->mutation_type_id_;
+			if (p_mutationEffect_callback->subpopulation_id_ != -1)
+				SLIM_ERRSTREAM << ", p" << p_mutationEffect_callback->subpopulation_id_;
+			SLIM_ERRSTREAM << ")";
+			
+			if (p_mutationEffect_callback->block_id_ != -1)
+				SLIM_ERRSTREAM << " s" << p_mutationEffect_callback->block_id_;
+			
+			SLIM_ERRSTREAM << " (line " << (decl_token->token_line_ + 1) << community_.DebugPointInfo() << ")" << std::endl;
+			indenter.indent();
+		}
+	}
+#endif
+	
+	const EidosASTNode *compound_statement_node = p_mutationEffect_callback->compound_statement_node_;
+	EidosValue_SP result_SP;
+	
+	if (compound_statement_node->cached_return_value_)
+	{
+		// The script is a constant expression such as "{ return 1.1; }", so we can short-circuit it completely
+		result_SP = compound_statement_node->cached_return_value_;
+	}
+	else if (p_mutationEffect_callback->has_cached_optimization_)
+	{
+		// See ApplyMutationEffectCallbacks(); the cached optimizations are elementwise, so they apply to each entry in the batch
+		if (p_mutationEffect_callback->has_cached_opt_reciprocal)
+		{
+			double A = p_mutationEffect_callback->cached_opt_A_;
+			
+			for (uint32_t batch_index : p_batch_indices)
+				p_batch_effects[batch_index] = (A / p_batch_effects[batch_index]);
+		}
+		else
+		{
+			EIDOS_TERMINATION << "ERROR (Subpopulation::ApplyMutationEffectCallback_Vectorized): (internal error) cached optimization flag mismatch" << EidosTerminate(p_mutationEffect_callback->identifier_token_);
+		}
+	}
+	else
+	{
+		EidosSymbolTable callback_symbols(EidosSymbolTableType::kContextConstantsTable, &community_.SymbolTable());
+		EidosSymbolTable client_symbols(EidosSymbolTableType::kLocalVariablesTable, &callback_symbols);
+		EidosFunctionMap &function_map = community_.FunctionMap();
+		EidosInterpreter interpreter(p_mutationEffect_callback->compound_statement_node_, client_symbols, function_map, &community_, SLIM_OUTSTREAM, SLIM_ERRSTREAM);
+		
+		if (p_mutationEffect_callback->contains_self_)
+			callback_symbols.InitializeConstantSymbolEntry(p_mutationEffect_callback->SelfSymbolTableEntry());		// define "self"
+		
+		// Set up the callback's parameters as vectors parallel to one another, with one element per batch entry
+		if (p_mutationEffect_callback->contains_mut_)
+		{
+			Mutation *mut_block_ptr = gSLiM_Mutation_Block;
+			EidosValue_Object *mut_value = (new (gEidosValuePool->AllocateChunk()) EidosValue_Object(gSLiM_Mutation_Class))->resize_no_initialize_RR(batch_count);
+			
+			for (size_t value_index = 0; value_index < batch_count; ++value_index)
+				mut_value->set_object_element_no_check_no_previous_RR(mut_block_ptr + p_batch_muts[p_batch_indices[value_index]], value_index);
+			
+			callback_symbols.InitializeConstantSymbolEntry(gID_mut, EidosValue_SP(mut_value));
+		}
+		if (p_mutationEffect_callback->contains_effect_)
+		{
+			EidosValue_Float *effect_value = (new (gEidosValuePool->AllocateChunk()) EidosValue_Float())->resize_no_initialize(batch_count);
+			
+			for (size_t value_index = 0; value_index < batch_count; ++value_index)
+				effect_value->set_float_no_check(p_batch_effects[p_batch_indices[value_index]], value_index);
+			
+			callback_symbols.InitializeConstantSymbolEntry(gID_effect, EidosValue_SP(effect_value));
+		}
+		if (p_mutationEffect_callback->contains_individual_)
+		{
+			EidosValue_Object *individual_value = (new (gEidosValuePool->AllocateChunk()) EidosValue_Object(gSLiM_Individual_Class))->resize_no_initialize(batch_count);
+			
+			for (size_t value_index = 0; value_index < batch_count; ++value_index)
+				individual_value->set_object_element_no_check_NORR(parent_individuals_[p_batch_owners[p_batch_indices[value_index]]], value_index);
+			
+			callback_symbols.InitializeConstantSymbolEntry(gID_individual, EidosValue_SP(individual_value));
+		}
+		if (p_mutationEffect_callback->contains_subpop_)
+			callback_symbols.InitializeConstantSymbolEntry(gID_subpop, SymbolTableEntry().second);
+		
+		// a vector cannot contain NULL, so mutations opposed by a NULL chromosome (p_homozygous == -1) get F here
+		if (p_mutationEffect_callback->contains_homozygous_)
+		{
+			EidosValue_Logical *homozygous_value = (new (gEidosValuePool->AllocateChunk()) EidosValue_Logical())->resize_no_initialize(batch_count);
+			
+			for (size_t value_index = 0; value_index < batch_count; ++value_index)
+				homozygous_value->set_logical_no_check(p_batch_homozygous[p_batch_indices[value_index]] == 1, value_index);
+			
+			callback_symbols.InitializeConstantSymbolEntry(gID_homozygous, EidosValue_SP(homozygous_value));
+		}
+		
+		result_SP = interpreter.EvaluateInternalBlock(p_mutationEffect_callback->script_);
+	}
+	
+	if (result_SP)
+	{
+		// Scatter the callback's result back into the batch; a singleton result applies to every entry
+		EidosValue *result = result_SP.get();
+		int result_count = result->Count();
+		
+		if ((result->Type() != EidosValueType::kValueFloat) || ((result_count != 1) && (result_count != (int)batch_count)))
+			EIDOS_TERMINATION << "ERROR (Subpopulation::ApplyMutationEffectCallback_Vectorized): mutationEffects() callbacks must provide a float return value that is either a singleton or the same length as effect." << EidosTerminate(p_mutationEffect_callback->identifier_token_);
+		
+		const double *result_data = result->FloatData();
+		
+		if (result_count == 1)
+		{
+			double effect = result_data[0];
+			
+			for (uint32_t batch_index : p_batch_indices)
+				p_batch_effects[batch_index] = effect;
+		}
+		else
+		{
+			for (size_t value_index = 0; value_index < batch_count; ++value_index)
+				p_batch_effects[p_batch_indices[value_index]] = result_data[value_index];
+		}
+	}
+	
+#if (SLIMPROFILING == 1)
+	// PROFILING
+	SLIM_PROFILE_BLOCK_END(community_.profile_callback_totals_[(int)(SLiMEidosBlockType::SLiMEidosMutationEffectCallback)]);
+#endif
+}
+
 double Subpopulation::ApplyFitnessEffectCallbacks(std::vector<SLiMEidosBlock*> &p_fitnessEffect_callbacks, slim_popsize_t p_individual_index)
 {
 	THREAD_SAFETY_IN_ANY_PARALLEL("Population::ApplyFitnessEffectCallbacks(): running Eidos callback");
@@ -2887,6 +3070,186 @@ double Subpopulation::FitnessOfParentWithGenomeIndices_Callbacks(slim_popsize_t
 	}
 }
 
+// This version of FitnessOfParentWithGenomeIndices handles the case where at least one active callback is a vectorized mutationEffects()
+// callback.  Rather than evaluating one individual at a time, it gathers every (mutation, individual) pair in the subpopulation into
+// a batch in one pass over the genomes, runs each callback over the batch – once in total for a vectorized callback, or once per
+// matching entry for a non-vectorized callback – and then multiplies the resulting effects into the fitness of each individual.
+// Individuals with a fitness_scaling_ of zero are not evaluated, as in the per-individual versions; their fitness is left at 1.0.
+void Subpopulation::FitnessOfParents_VectorizedCallbacks(std::vector<SLiMEidosBlock*> &p_mutationEffect_callbacks, std::vector<double> &p_parent_fitness)
+{
+#if SLIM_USE_NONNEUTRAL_CACHES
+	int32_t nonneutral_change_counter = species_.nonneutral_change_counter_;
+	int32_t nonneutral_regime = species_.last_nonneutral_regime_;
+#endif
+	
+	Mutation *mut_block_ptr = gSLiM_Mutation_Block;
+	std::vector<MutationIndex> batch_muts;
+	std::vector<int8_t> batch_homozygous;		// -1 for opposed by a null genome, 0 for heterozygous, 1 for homozygous
+	std::vector<double> batch_effects;
+	std::vector<slim_popsize_t> batch_owners;
+	
+	auto add_to_batch = [&](MutationIndex p_mutation, int8_t p_homozygous, double p_effect, slim_popsize_t p_owner) {
+		batch_muts.emplace_back(p_mutation);
+		batch_homozygous.emplace_back(p_homozygous);
+		batch_effects.emplace_back(p_effect);
+		batch_owners.emplace_back(p_owner);
+	};
+	
+	// Gather: one pass over the parental genomes, classifying each mutation as in FitnessOfParentWithGenomeIndices_Callbacks()
+	for (slim_popsize_t individual_index = 0; individual_index < parent_subpop_size_; ++individual_index)
+	{
+		if (!(parent_individuals_[individual_index]->fitness_scaling_ > 0.0))
+			continue;
+		
+		Genome *genome1 = parent_genomes_[(size_t)individual_index * 2];
+		Genome *genome2 = parent_genomes_[(size_t)individual_index * 2 + 1];
+		bool genome1_null = genome1->IsNull();
+		bool genome2_null = genome2->IsNull();
+		
+		if (genome1_null && genome2_null)
+		{
+			continue;
+		}
+		else if (genome1_null || genome2_null)
+		{
+			const Genome *genome = genome1_null ? genome2 : genome1;
+			const int32_t mutrun_count = genome->mutrun_count_;
+			
+			for (int run_index = 0; run_index < mutrun_count; ++run_index)
+			{
+				const MutationRun *mutrun = genome->mutruns_[run_index];
+				
+#if SLIM_USE_NONNEUTRAL_CACHES
+				const MutationIndex *genome_iter, *genome_max;
+				
+				mutrun->beginend_nonneutral_pointers(&genome_iter, &genome_max, nonneutral_change_counter, nonneutral_regime);
+#else
+				const MutationIndex *genome_iter = mutrun->begin_pointer_const();
+				const MutationIndex *genome_max = mutrun->end_pointer_const();
+#endif
+				
+				for ( ; genome_iter != genome_max; ++genome_iter)
+					add_to_batch(*genome_iter, -1, (mut_block_ptr + *genome_iter)->cached_one_plus_haploiddom_sel_, individual_index);
+			}
+		}
+		else
+		{
+			const int32_t mutrun_count = genome1->mutrun_count_;
+			
+			for (int run_index = 0; run_index < mutrun_count; ++run_index)
+			{
+				const MutationRun *mutrun1 = genome1->mutruns_[run_index];
+				const MutationRun *mutrun2 = genome2->mutruns_[run_index];
+				
+#if SLIM_USE_NONNEUTRAL_CACHES
+				const MutationIndex *genome1_iter, *genome2_iter, *genome1_max, *genome2_max;
+				
+				mutrun1->beginend_nonneutral_pointers(&genome1_iter, &genome1_max, nonneutral_change_counter, nonneutral_regime);
+				mutrun2->beginend_nonneutral_pointers(&genome2_iter, &genome2_max, nonneutral_change_counter, nonneutral_regime);
+#else
+				const MutationIndex *genome1_iter = mutrun1->begin_pointer_const();
+				const MutationIndex *genome2_iter = mutrun2->begin_pointer_const();
+				
+				const MutationIndex *genome1_max = mutrun1->end_pointer_const();
+				const MutationIndex *genome2_max = mutrun2->end_pointer_const();
+#endif
+				
+				// merge the two position-sorted runs; mutations at a position shared by both genomes are checked for homozygosity
+				while ((genome1_iter != genome1_max) || (genome2_iter != genome2_max))
+				{
+					slim_position_t genome1_position = ((genome1_iter != genome1_max) ? (mut_block_ptr + *genome1_iter)->position_ : SLIM_MAX_BASE_POSITION + 1);
+					slim_position_t genome2_position = ((genome2_iter != genome2_max) ? (mut_block_ptr + *genome2_iter)->position_ : SLIM_MAX_BASE_POSITION + 1);
+					
+					if (genome1_position < genome2_position)
+					{
+						add_to_batch(*genome1_iter, 0, (mut_block_ptr + *genome1_iter)->cached_one_plus_dom_sel_, individual_index);
+						genome1_iter++;
+					}
+					else if (genome2_position < genome1_position)
+					{
+						add_to_batch(*genome2_iter, 0, (mut_block_ptr + *genome2_iter)->cached_one_plus_dom_sel_, individual_index);
+						genome2_iter++;
+					}
+					else
+					{
+						const MutationIndex *genome1_end = genome1_iter, *genome2_end = genome2_iter;
+						
+						while ((genome1_end != genome1_max) && ((mut_block_ptr + *genome1_end)->position_ == genome1_position))
+							genome1_end++;
+						while ((genome2_end != genome2_max) && ((mut_block_ptr + *genome2_end)->position_ == genome1_position))
+							genome2_end++;
+						
+						for (const MutationIndex *scan = genome1_iter; scan != genome1_end; ++scan)
+						{
+							if (std::find(genome2_iter, genome2_end, *scan) != genome2_end)
+								add_to_batch(*scan, 1, (mut_block_ptr + *scan)->cached_one_plus_sel_, individual_index);
+							else
+								add_to_batch(*scan, 0, (mut_block_ptr + *scan)->cached_one_plus_dom_sel_, individual_index);
+						}
+						
+						for (const MutationIndex *scan = genome2_iter; scan != genome2_end; ++scan)
+							if (std::find(genome1_iter, genome1_end, *scan) == genome1_end)
+								add_to_batch(*scan, 0, (mut_block_ptr + *scan)->cached_one_plus_dom_sel_, individual_index);
+						
+						genome1_iter = genome1_end;
+						genome2_iter = genome2_end;
+					}
+				}
+			}
+		}
+	}
+	
+	// Apply each active callback, in order, to the batch entries for the mutation type it modifies; each callback sees the
+	// effects produced by the callbacks before it, as in the non-vectorized case
+	std::vector<SLiMEidosBlock*> single_callback(1, nullptr);
+	std::vector<uint32_t> batch_indices;
+	
+	batch_indices.reserve(batch_muts.size());
+	
+	for (SLiMEidosBlock *mutationEffect_callback : p_mutationEffect_callbacks)
+	{
+		if (!mutationEffect_callback->block_active_)
+			continue;
+		
+		slim_objectid_t callback_mutation_type_id = mutationEffect_callback->mutation_type_id_;
+		
+		batch_indices.clear();
+		
+		for (size_t batch_index = 0; batch_index < batch_muts.size(); ++batch_index)
+			if ((callback_mutation_type_id == -1) || ((mut_block_ptr + batch_muts[batch_index])->mutation_type_ptr_->mutation_type_id_ == callback_mutation_type_id))
+				batch_indices.emplace_back((uint32_t)batch_index);
+		
+		if (mutationEffect_callback->vectorized_)
+		{
+			ApplyMutationEffectCallback_Vectorized(mutationEffect_callback, batch_indices, batch_muts, batch_homozygous, batch_effects, batch_owners);
+		}
+		else
+		{
+			single_callback[0] = mutationEffect_callback;
+			
+			for (uint32_t batch_index : batch_indices)
+				batch_effects[batch_index] = ApplyMutationEffectCallbacks(batch_muts[batch_index], batch_homozygous[batch_index], batch_effects[batch_index], single_callback, parent_individuals_[batch_owners[batch_index]]);
+		}
+	}
+	
+	// Scatter: multiply the effects into each individual's fitness; once an individual's fitness reaches zero it stays there, as in
+	// the per-individual versions, which return 0.0 as soon as the running product is <= 0.0
+	p_parent_fitness.assign(parent_subpop_size_, 1.0);
+	
+	for (size_t batch_index = 0; batch_index < batch_muts.size(); ++batch_index)
+	{
+		double &w = p_parent_fitness[batch_owners[batch_index]];
+		
+		if (w > 0.0)
+		{
+			w *= batch_effects[batch_index];
+			
+			if (w <= 0.0)
+				w = 0.0;
+		}
+	}
+}
+
 // This version of FitnessOfParentWithGenomeIndices assumes a single callback exists, modifying the given mutation type.  It is a hybrid of the previous two versions.
 //
 double Subpopulation::FitnessOfParentWithGenomeIndices_SingleCallback(slim_popsize_t p_individual_index, std::vector<SLiMEidosBlock*> &p_mutationEffect_callbacks, MutationType *p_single_callback_mut_type)
@@ -8377,7 +8740,7 @@ EidosValue_SP Subpopulation::ExecuteMethod_spatialMapValue(EidosGlobalStringID p
 
 //	*********************	– (void)outputMSSample(integer$ sampleSize, [logical$ replace = T], [string$ requestedSex = "*"], [Ns$ filePath = NULL], [logical$ append=F], [logical$ filterMonomorphic = F])
 //	*********************	– (void)outputSample(integer$ sampleSize, [logical$ replace = T], [string$ requestedSex = "*"], [Ns$ filePath = NULL], [logical$ append=F])
-//	*********************	– (void)outputVCFSample(integer$ sampleSize, [logical$ replace = T], [string$ requestedSex = "*"], [logical$ outputMultiallelics = T], [Ns$ filePath = NULL], [logical$ append=F], [logical$ simplifyNucleotides = F], [logical$ outputNonnucleotides = T])
+//	*********************	– (void)outputVCFSample(integer$ sampleSize, [logical$ replace = T], [string$ requestedSex = "*"], [logical$ outputMultiallelics = T], [Ns$ filePath = NULL], [logical$ append=F], [logical$ simplifyNucleotides = F], [logical$ outputNonnucleotides = T], [logical$ compress = F])
 //
 EidosValue_SP Subpopulation::ExecuteMethod_outputXSample(EidosGlobalStringID p_method_id, const std::vector<EidosValue_SP> &p_arguments, EidosInterpreter &p_interpreter)
 {
@@ -8391,6 +8754,7 @@ EidosValue_SP Subpopulation::ExecuteMethod_outputXSample(EidosGlobalStringID p_m
 	EidosValue *filterMonomorphic_arg = ((p_method_id == gID_outputMSSample) ? p_arguments[5].get() : nullptr);
 	EidosValue *simplifyNucleotides_arg = ((p_method_id == gID_outputVCFSample) ? p_arguments[6].get() : nullptr);
 	EidosValue *outputNonnucleotides_arg = ((p_method_id == gID_outputVCFSample) ? p_arguments[7].get() : nullptr);
+	EidosValue *compress_arg = ((p_method_id == gID_outputVCFSample) ? p_arguments[8].get() : nullptr);
 	
 	std::ostream &output_stream = p_interpreter.ExecutionOutputStream();
 	
@@ -8443,6 +8807,11 @@ EidosValue_SP Subpopulation::ExecuteMethod_outputXSample(EidosGlobalStringID p_m
 	if (p_method_id == gID_outputVCFSample)
 		output_nonnucs = outputNonnucleotides_arg->LogicalAtIndex_NOCAST(0, nullptr);
 	
+	bool compress = false;
+	
+	if (p_method_id == gID_outputVCFSample)
+		compress = compress_arg->LogicalAtIndex_NOCAST(0, nullptr);
+	
 	bool filter_monomorphic = false;
 	
 	if (p_method_id == gID_outputMSSample)
@@ -8458,14 +8827,31 @@ EidosValue_SP Subpopulation::ExecuteMethod_outputXSample(EidosGlobalStringID p_m
 		outfile_path = Eidos_ResolvedPath(filePath_arg->StringAtIndex_NOCAST(0, nullptr));
 		bool append = append_arg->LogicalAtIndex_NOCAST(0, nullptr);
 		
-		outfile.open(outfile_path.c_str(), append ? (std::ios_base::app | std::ios_base::out) : std::ios_base::out);
+		if (compress && !Eidos_string_hasSuffix(outfile_path, ".gz"))
+			outfile_path.append(".gz");
+		
+		outfile.open(outfile_path.c_str(), (append ? (std::ios_base::app | std::ios_base::out) : std::ios_base::out) | (compress ? std::ios_base::binary : std::ios_base::openmode()));
 		has_file = true;
 		
 		if (!outfile.is_open())
 			EIDOS_TERMINATION << "ERROR (Subpopulation::ExecuteMethod_outputXSample): " << EidosStringRegistry::StringForGlobalStringID(p_method_id) << "() could not open "<< outfile_path << "." << EidosTerminate();
 	}
+	else if (compress)
+	{
+		EIDOS_TERMINATION << "ERROR (Subpopulation::ExecuteMethod_outputXSample): " << EidosStringRegistry::StringForGlobalStringID(p_method_id) << "() requires a filePath for output when compress=T." << EidosTerminate();
+	}
 	
-	std::ostream &out = *(has_file ? dynamic_cast<std::ostream *>(&outfile) : dynamic_cast<std::ostream *>(&output_stream));
+	// When compressing, VCF output goes through a BGZF compressor to the file; it is finished, and checked for errors, below
+	std::unique_ptr<Eidos_BGZFStreambuf> bgzf_buf;
+	std::unique_ptr<std::ostream> bgzf_stream;
+	
+	if (compress)
+	{
+		bgzf_buf.reset(new Eidos_BGZFStreambuf(outfile));
+		bgzf_stream.reset(new std::ostream(bgzf_buf.get()));
+	}
+	
+	std::ostream &out = *(compress ? bgzf_stream.get() : (has_file ? dynamic_cast<std::ostream *>(&outfile) : dynamic_cast<std::ostream *>(&output_stream)));
 	
 	if (!has_file || (p_method_id == gID_outputSample))
 	{
@@ -8498,6 +8884,9 @@ EidosValue_SP Subpopulation::ExecuteMethod_outputXSample(EidosGlobalStringID p_m
 	else if (p_method_id == gID_outputVCFSample)
 		population_.PrintSample_VCF(out, *this, sample_size, replace, requested_sex, output_multiallelics, simplify_nucs, output_nonnucs);
 	
+	if (compress && (!out || !bgzf_buf->Finish()))
+		EIDOS_TERMINATION << "ERROR (Subpopulation::ExecuteMethod_outputXSample): " << EidosStringRegistry::StringForGlobalStringID(p_method_id) << "() encountered an error compressing output to " << outfile_path << "." << EidosTerminate();
+	
 	if (has_file)
 		outfile.close(); 
 	
@@ -8684,7 +9073,7 @@ const std::vector<EidosMethodSignature_CSP> *Subpopulation_Class::Methods(void)
 		methods->emplace_back((EidosInstanceMethodSignature *)(new EidosInstanceMethodSignature(gStr_spatialMapImage, kEidosValueMaskObject | kEidosValueMaskSingleton, gEidosImage_Class))->AddString_S("name")->AddInt_OSN(gEidosStr_width, gStaticEidosValueNULL)->AddInt_OSN(gEidosStr_height, gStaticEidosValueNULL)->AddLogical_OS("centers", gStaticEidosValue_LogicalF)->AddLogical_OS(gEidosStr_color, gStaticEidosValue_LogicalT)->MarkDeprecated());
 		methods->emplace_back((EidosInstanceMethodSignature *)(new EidosInstanceMethodSignature(gStr_spatialMapValue, kEidosValueMaskFloat))->AddArg(kEidosValueMaskString | kEidosValueMaskObject | kEidosValueMaskSingleton, "map", gSLiM_SpatialMap_Class)->AddFloat("point"));
 		methods->emplace_back((EidosInstanceMethodSignature *)(new EidosInstanceMethodSignature(gStr_outputMSSample, kEidosValueMaskVOID))->AddInt_S("sampleSize")->AddLogical_OS("replace", gStaticEidosValue_LogicalT)->AddString_OS("requestedSex", gStaticEidosValue_StringAsterisk)->AddString_OSN(gEidosStr_filePath, gStaticEidosValueNULL)->AddLogical_OS("append", gStaticEidosValue_LogicalF)->AddLogical_OS("filterMonomorphic", gStaticEidosValue_LogicalF));
-		methods->emplace_back((EidosInstanceMethodSignature *)(new EidosInstanceMethodSignature(gStr_outputVCFSample, kEidosValueMaskVOID))->AddInt_S("sampleSize")->AddLogical_OS("replace", gStaticEidosValue_LogicalT)->AddString_OS("requestedSex", gStaticEidosValue_StringAsterisk)->AddLogical_OS("outputMultiallelics", gStaticEidosValue_LogicalT)->AddString_OSN(gEidosStr_filePath, gStaticEidosValueNULL)->AddLogical_OS("append", gStaticEidosValue_LogicalF)->AddLogical_OS("simplifyNucleotides", gStaticEidosValue_LogicalF)->AddLogical_OS("outputNonnucleotides", gStaticEidosValue_LogicalT));
+		methods->emplace_back((EidosInstanceMethodSignature *)(new EidosInstanceMethodSignature(gStr_outputVCFSample, kEidosValueMaskVOID))->AddInt_S("sampleSize")->AddLogical_OS("replace", gStaticEidosValue_LogicalT)->AddString_OS("requestedSex", gStaticEidosValue_StringAsterisk)->AddLogical_OS("outputMultiallelics", gStaticEidosValue_LogicalT)->AddString_OSN(gEidosStr_filePath, gStaticEidosValueNULL)->AddLogical_OS("append", gStaticEidosValue_LogicalF)->AddLogical_OS("simplifyNucleotides", gStaticEidosValue_LogicalF)->AddLogical_OS("outputNonnucleotides", gStaticEidosValue_LogicalT)->AddLogical_OS("compress", gStaticEidosValue_LogicalF));
 		methods->emplace_back((EidosInstanceMethodSignature *)(new EidosInstanceMethodSignature(gStr_outputSample, kEidosValueMaskVOID))->AddInt_S("sampleSize")->AddLogical_OS("replace", gStaticEidosValue_LogicalT)->AddString_OS("requestedSex", gStaticEidosValue_StringAsterisk)->AddString_OSN(gEidosStr_filePath, gStaticEidosValueNULL)->AddLogical_OS("append", gStaticEidosValue_LogicalF));
 		methods->emplace_back((EidosInstanceMethodSignature *)(new EidosInstanceMethodSignature(gStr_configureDisplay, kEidosValueMaskVOID))->AddFloat_ON("center", gStaticEidosValueNULL)->AddFloat_OSN("scale", gStaticEidosValueNULL)->AddString_OSN(gEidosStr_color, gStaticEidosValueNULL));
 		
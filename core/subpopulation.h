@@ -93,6 +93,8 @@ class Subpopulation : public EidosDictionaryUnretained
 
 private:
 	typedef EidosDictionaryUnretained super;
+	
+	friend class SLiMCheckpoint;				// reads and writes private state for checkpointing
 
 private:
 	
@@ -358,8 +360,10 @@ public:
 	double FitnessOfParentWithGenomeIndices_NoCallbacks(slim_popsize_t p_individual_index);
 	double FitnessOfParentWithGenomeIndices_Callbacks(slim_popsize_t p_individual_index, std::vector<SLiMEidosBlock*> &p_mutationEffect_callbacks);
 	double FitnessOfParentWithGenomeIndices_SingleCallback(slim_popsize_t p_individual_index, std::vector<SLiMEidosBlock*> &p_mutationEffect_callbacks, MutationType *p_single_callback_mut_type);
+	void FitnessOfParents_VectorizedCallbacks(std::vector<SLiMEidosBlock*> &p_mutationEffect_callbacks, std::vector<double> &p_parent_fitness);		// all parents at once, for mutationEffects() callbacks
 	
 	double ApplyMutationEffectCallbacks(MutationIndex p_mutation, int p_homozygous, double p_computed_fitness, std::vector<SLiMEidosBlock*> &p_mutationEffect_callbacks, Individual *p_individual);
+	void ApplyMutationEffectCallback_Vectorized(SLiMEidosBlock *p_mutationEffect_callback, const std::vector<uint32_t> &p_batch_indices, const std::vector<MutationIndex> &p_batch_muts, const std::vector<int8_t> &p_batch_homozygous, std::vector<double> &p_batch_effects, const std::vector<slim_popsize_t> &p_batch_owners);
 	double ApplyFitnessEffectCallbacks(std::vector<SLiMEidosBlock*> &p_fitnessEffect_callbacks, slim_popsize_t p_individual_index);
 	
 	// WF only:
@@ -20,6 +20,9 @@
 
 #include "eidos_ast_node.h"
 #include "eidos_interpreter.h"
+#include "eidos_functions.h"
+#include "eidos_type_interpreter.h"
+#include "eidos_type_table.h"
 
 #include <string>
 #include <algorithm>
@@ -49,6 +52,12 @@ EidosASTNode::~EidosASTNode(void)
 		delete argument_cache_;
 		argument_cache_ = nullptr;
 	}
+	
+	if (bytecode_)
+	{
+		delete bytecode_;
+		bytecode_ = nullptr;
+	}
 }
 
 void EidosASTNode::AddChild(EidosASTNode *p_child_node)
@@ -77,13 +86,15 @@ void EidosASTNode::OptimizeTree(void) const
 	_OptimizeIdentifiers();		// cache unique IDs for identifiers using EidosStringRegistry::GlobalStringIDForString()
 	_OptimizeEvaluators();		// cache evaluator functions in cached_evaluator_ for fast node evaluation
 	_OptimizeAssignments();		// cache information about assignments that allows simple increment/decrement assignments to be accelerated
+	_OptimizeBytecode();		// compile pure scalar expressions to register bytecode; must come after _OptimizeEvaluators()
+	_OptimizeTypeSpecializations();		// specialize evaluators for inferred operand types; must come after _OptimizeBytecode()
 }
 
 void EidosASTNode::_OptimizeConstants(void) const
 {
 	// recurse down the tree; determine our children, then ourselves
-	for (const EidosASTNode *child : children_)
-		child->_OptimizeConstants();
+	for (size_t child_index = 0, child_count = OptimizedChildCount(); child_index < child_count; ++child_index)
+		children_[child_index]->_OptimizeConstants();
 	
 	// now find constant expressions and make EidosValues for them
 	EidosTokenType token_type = token_->token_type_;
@@ -166,8 +177,8 @@ void EidosASTNode::_OptimizeConstants(void) const
 void EidosASTNode::_OptimizeIdentifiers(void) const
 {
 	// recurse down the tree; determine our children, then ourselves
-	for (auto child : children_)
-		child->_OptimizeIdentifiers();
+	for (size_t child_index = 0, child_count = OptimizedChildCount(); child_index < child_count; ++child_index)
+		children_[child_index]->_OptimizeIdentifiers();
 	
 	if (token_->token_type_ == EidosTokenType::kTokenIdentifier)
 	{
@@ -192,8 +203,8 @@ void EidosASTNode::_OptimizeIdentifiers(void) const
 void EidosASTNode::_OptimizeEvaluators(void) const
 {
 	// recurse down the tree; determine our children, then ourselves
-	for (auto child : children_)
-		child->_OptimizeEvaluators();
+	for (size_t child_index = 0, child_count = OptimizedChildCount(); child_index < child_count; ++child_index)
+		children_[child_index]->_OptimizeEvaluators();
 	
 	EidosTokenType token_type = token_->token_type_;
 	
@@ -244,8 +255,8 @@ void EidosASTNode::_OptimizeEvaluators(void) const
 void EidosASTNode::_OptimizeAssignments(void) const
 {
 	// recurse down the tree; determine our children, then ourselves
-	for (auto child : children_)
-		child->_OptimizeAssignments();
+	for (size_t child_index = 0, child_count = OptimizedChildCount(); child_index < child_count; ++child_index)
+		children_[child_index]->_OptimizeAssignments();
 	
 	EidosTokenType token_type = token_->token_type_;
 	
@@ -308,6 +319,315 @@ void EidosASTNode::_OptimizeAssignments(void) const
 	}
 }
 
+// The function map used for type-interpreting: a copy of the built-in function map, made once.  Type-interpreting a function
+// declaration adds the user-defined function to the map, so those are removed again once a tree has been type-interpreted.
+static EidosFunctionMap *s_specialization_function_map = nullptr;
+
+static void _EidosScanForSpecialization(const EidosASTNode *p_node, bool *p_has_candidates, bool *p_has_function_decls)
+{
+	// Find whether a subtree has any operator node that EidosTypeInterpreter::_SpecializeBinaryOperator() could specialize, and
+	// whether it declares any functions; a subtree with no candidates does not need to be type-interpreted at all
+	EidosEvaluationMethod generic_evaluator = EidosInterpreter::GenericEvaluatorForSpecializedNode(p_node);
+	
+	if (generic_evaluator && (p_node->cached_evaluator_ == generic_evaluator) && (p_node->children_.size() == 2))
+		*p_has_candidates = true;
+	else if (p_node->token_->token_type_ == EidosTokenType::kTokenFunction)
+		*p_has_function_decls = true;
+	
+	for (const EidosASTNode *child : p_node->children_)
+		_EidosScanForSpecialization(child, p_has_candidates, p_has_function_decls);
+}
+
+static void _EidosTypeInterpretForSpecialization(const EidosASTNode *p_node, bool p_is_interpreter_block)
+{
+	EidosTypeTable type_table;
+	EidosCallTypeTable call_type_table;
+	
+	gEidosConstantsSymbolTable->AddSymbolsToTypeTable(&type_table);
+	
+	EidosTypeInterpreter type_interpreter(p_node, type_table, *s_specialization_function_map, call_type_table);
+	
+	type_interpreter.SetSpecializeEvaluators(true);
+	
+	if (p_is_interpreter_block)
+		type_interpreter.TypeEvaluateInterpreterBlock();	// result not used
+	else
+		type_interpreter.TypeEvaluateNode(p_node);			// result not used
+}
+
+static void _EidosRemoveUserDefinedSpecializationFunctions(void)
+{
+	for (auto iter = s_specialization_function_map->begin(); iter != s_specialization_function_map->end(); )
+	{
+		if (iter->second->user_defined_)
+			iter = s_specialization_function_map->erase(iter);
+		else
+			++iter;
+	}
+}
+
+void EidosASTNode::_OptimizeTypeSpecializations(void) const
+{
+	// Type-interpret the tree so that EidosTypeInterpreter can specialize the evaluators of nodes with inferred operand types; see
+	// EidosTypeInterpreter::_SpecializeBinaryOperator().  An interpreter block is type-interpreted as a whole.  In a Context file,
+	// such as a SLiM script, the Context's own nodes are not understood by EidosTypeInterpreter, so each script block body and
+	// function declaration is type-interpreted separately.  Only built-in Eidos functions are known, so Context functions and
+	// Context-defined symbols have no inferred type, and operations on them are not specialized.  A tree with no operator node
+	// that could be specialized is skipped, since type-interpreting it would change nothing.
+	THREAD_SAFETY_IN_ACTIVE_PARALLEL("EidosASTNode::_OptimizeTypeSpecializations(): s_specialization_function_map change");
+	
+	const EidosFunctionMap *builtin_function_map = EidosInterpreter::BuiltInFunctionMap();
+	
+	if (!builtin_function_map || !gEidosConstantsSymbolTable)
+		return;
+	
+	EidosTokenType token_type = token_->token_type_;
+	
+	if ((token_type != EidosTokenType::kTokenInterpreterBlock) && (token_type != EidosTokenType::kTokenContextFile) && (token_type != EidosTokenType::kTokenContextEidosBlock))
+		return;
+	
+	bool has_candidates = false, has_function_decls = false;
+	
+	_EidosScanForSpecialization(this, &has_candidates, &has_function_decls);
+	
+	if (!has_candidates)
+		return;
+	
+	if (!s_specialization_function_map)
+		s_specialization_function_map = new EidosFunctionMap(*builtin_function_map);
+	
+	try
+	{
+		if (token_type == EidosTokenType::kTokenInterpreterBlock)
+		{
+			_EidosTypeInterpretForSpecialization(this, true);
+		}
+		else
+		{
+			std::vector<const EidosASTNode *> block_nodes(1, this);
+			
+			while (block_nodes.size())
+			{
+				const EidosASTNode *block_node = block_nodes.back();
+				
+				block_nodes.pop_back();
+				
+				for (const EidosASTNode *child : block_node->children_)
+				{
+					EidosTokenType child_token_type = child->token_->token_type_;
+					
+					if (child_token_type == EidosTokenType::kTokenContextEidosBlock)
+						block_nodes.emplace_back(child);
+					else if ((child_token_type == EidosTokenType::kTokenLBrace) || (child_token_type == EidosTokenType::kTokenFunction))
+						_EidosTypeInterpretForSpecialization(child, false);
+				}
+			}
+		}
+	}
+	catch (...)
+	{
+		_EidosRemoveUserDefinedSpecializationFunctions();
+		throw;
+	}
+	
+	if (has_function_decls)
+		_EidosRemoveUserDefinedSpecializationFunctions();
+}
+
+void EidosASTNode::_OptimizeBytecode(void) const
+{
+	// Compile the outermost eligible operator node of each subtree, whose program covers its whole subtree; the nodes inside it
+	// are not compiled again, since they are evaluated by that program.  If a subtree can't be compiled as a whole, we recurse
+	// down to look for smaller subtrees that can be.  If a program bails out at runtime, the tree walker evaluates its subtree.
+	bool eligible;
+	
+	// Bare constants and identifiers gain nothing from compilation, so only operator and function call nodes are eligible roots
+	switch (token_->token_type_)
+	{
+		case EidosTokenType::kTokenLParen:
+		case EidosTokenType::kTokenPlus:
+		case EidosTokenType::kTokenMinus:
+		case EidosTokenType::kTokenMult:
+		case EidosTokenType::kTokenDiv:
+		case EidosTokenType::kTokenMod:
+		case EidosTokenType::kTokenExp:
+		case EidosTokenType::kTokenEq:
+		case EidosTokenType::kTokenNotEq:
+		case EidosTokenType::kTokenLt:
+		case EidosTokenType::kTokenLtEq:
+		case EidosTokenType::kTokenGt:
+		case EidosTokenType::kTokenGtEq:
+		case EidosTokenType::kTokenAnd:
+		case EidosTokenType::kTokenOr:
+		case EidosTokenType::kTokenNot:
+			eligible = (cached_evaluator_ != nullptr);
+			break;
+		default:
+			eligible = false;
+			break;
+	}
+	
+	if (eligible)
+	{
+		EidosBytecodeProgram *program = new EidosBytecodeProgram();
+		
+		if (_CompileBytecode(program, 0))
+		{
+			program->fallback_evaluator_ = cached_evaluator_;
+			bytecode_ = program;
+			cached_evaluator_ = &EidosInterpreter::Evaluate_Bytecode;
+			return;
+		}
+		
+		delete program;
+	}
+	
+	for (size_t child_index = 0, child_count = OptimizedChildCount(); child_index < child_count; ++child_index)
+		children_[child_index]->_OptimizeBytecode();
+}
+
+bool EidosASTNode::_CompileBytecode(EidosBytecodeProgram *p_program, int p_dest_register) const
+{
+	// Emit instructions that leave the value of this subtree in register p_dest_register, using only registers at or above it.
+	// Returns false if the subtree contains anything that bytecode can't represent; p_program is then left in an unusable state.
+	if (p_dest_register + 1 >= EIDOS_BYTECODE_MAX_REGISTERS)
+		return false;
+	
+	EidosBytecodeInstruction instruction;
+	
+	instruction.dest_ = (uint8_t)p_dest_register;
+	instruction.src1_ = (uint8_t)p_dest_register;
+	instruction.src2_ = (uint8_t)(p_dest_register + 1);
+	instruction.immediate_.type_ = EidosValueType::kValueInt;
+	instruction.immediate_.int_ = 0;
+	instruction.node_ = nullptr;
+	
+	EidosTokenType token_type = token_->token_type_;
+	size_t child_count = children_.size();
+	
+	switch (token_type)
+	{
+		case EidosTokenType::kTokenNumber:
+		case EidosTokenType::kTokenIdentifier:
+		{
+			if (child_count != 0)
+				return false;
+			
+			if (cached_literal_value_)
+			{
+				// numeric literals, and the constant identifiers T, F, INF, NAN, E, and PI, become immediate loads
+				EidosValue *literal = cached_literal_value_.get();
+				
+				if ((literal->Count() != 1) || (literal->DimensionCount() != 1))
+					return false;
+				
+				switch (literal->Type())
+				{
+					case EidosValueType::kValueLogical:	instruction.immediate_.logical_ = literal->LogicalAtIndex_NOCAST(0, nullptr); break;
+					case EidosValueType::kValueInt:		instruction.immediate_.int_ = literal->IntAtIndex_NOCAST(0, nullptr); break;
+					case EidosValueType::kValueFloat:	instruction.immediate_.float_ = literal->FloatAtIndex_NOCAST(0, nullptr); break;
+					default:							return false;
+				}
+				
+				instruction.op_ = EidosBytecodeOp::kLoadConstant;
+				instruction.immediate_.type_ = literal->Type();
+			}
+			else
+			{
+				if ((token_type != EidosTokenType::kTokenIdentifier) || (cached_stringID_ == gEidosID_none))
+					return false;
+				
+				instruction.op_ = EidosBytecodeOp::kLoadIdentifier;
+				instruction.node_ = this;
+			}
+			
+			p_program->instructions_.emplace_back(instruction);
+			return true;
+		}
+		case EidosTokenType::kTokenLParen:
+		{
+			// calls to a few built-in math functions of one numeric argument; named and default arguments are not handled
+			if (child_count != 2)
+				return false;
+			
+			const EidosASTNode *call_name_node = children_[0];
+			
+			if ((call_name_node->token_->token_type_ != EidosTokenType::kTokenIdentifier) || !call_name_node->cached_signature_)
+				return false;
+			
+			EidosInternalFunctionPtr function = call_name_node->cached_signature_->internal_function_;
+			
+			if (function == &Eidos_ExecuteFunction_exp)			instruction.op_ = EidosBytecodeOp::kFunctionExp;
+			else if (function == &Eidos_ExecuteFunction_log)	instruction.op_ = EidosBytecodeOp::kFunctionLog;
+			else if (function == &Eidos_ExecuteFunction_log10)	instruction.op_ = EidosBytecodeOp::kFunctionLog10;
+			else if (function == &Eidos_ExecuteFunction_log2)	instruction.op_ = EidosBytecodeOp::kFunctionLog2;
+			else if (function == &Eidos_ExecuteFunction_sqrt)	instruction.op_ = EidosBytecodeOp::kFunctionSqrt;
+			else
+				return false;
+			
+			if (!children_[1]->_CompileBytecode(p_program, p_dest_register))
+				return false;
+			
+			p_program->instructions_.emplace_back(instruction);
+			return true;
+		}
+		case EidosTokenType::kTokenMinus:
+		case EidosTokenType::kTokenNot:
+			if (child_count == 1)
+			{
+				if (!children_[0]->_CompileBytecode(p_program, p_dest_register))
+					return false;
+				
+				instruction.op_ = ((token_type == EidosTokenType::kTokenMinus) ? EidosBytecodeOp::kNegate : EidosBytecodeOp::kNot);
+				if (token_type == EidosTokenType::kTokenNot)
+					p_program->elementwise_ = false;
+				p_program->instructions_.emplace_back(instruction);
+				return true;
+			}
+			if (token_type == EidosTokenType::kTokenNot)
+				return false;
+			instruction.op_ = EidosBytecodeOp::kSubtract;
+			break;
+		case EidosTokenType::kTokenPlus:		instruction.op_ = EidosBytecodeOp::kAdd; break;
+		case EidosTokenType::kTokenMult:		instruction.op_ = EidosBytecodeOp::kMultiply; break;
+		case EidosTokenType::kTokenDiv:			instruction.op_ = EidosBytecodeOp::kDivide; break;
+		case EidosTokenType::kTokenMod:			instruction.op_ = EidosBytecodeOp::kModulo; break;
+		case EidosTokenType::kTokenExp:			instruction.op_ = EidosBytecodeOp::kExponent; break;
+		case EidosTokenType::kTokenEq:			instruction.op_ = EidosBytecodeOp::kEqual; break;
+		case EidosTokenType::kTokenNotEq:		instruction.op_ = EidosBytecodeOp::kNotEqual; break;
+		case EidosTokenType::kTokenLt:			instruction.op_ = EidosBytecodeOp::kLess; break;
+		case EidosTokenType::kTokenLtEq:		instruction.op_ = EidosBytecodeOp::kLessEqual; break;
+		case EidosTokenType::kTokenGt:			instruction.op_ = EidosBytecodeOp::kGreater; break;
+		case EidosTokenType::kTokenGtEq:		instruction.op_ = EidosBytecodeOp::kGreaterEqual; break;
+		case EidosTokenType::kTokenAnd:			instruction.op_ = EidosBytecodeOp::kAnd; break;
+		case EidosTokenType::kTokenOr:			instruction.op_ = EidosBytecodeOp::kOr; break;
+		default:
+			return false;
+	}
+	
+	if ((instruction.op_ >= EidosBytecodeOp::kEqual) && (instruction.op_ <= EidosBytecodeOp::kOr))
+		p_program->elementwise_ = false;
+	
+	// Binary operators; & and | can have more than two children, which are folded into the destination register left to right
+	bool is_nary = ((token_type == EidosTokenType::kTokenAnd) || (token_type == EidosTokenType::kTokenOr));
+	
+	if ((child_count < 2) || ((child_count > 2) && !is_nary))
+		return false;
+	
+	if (!children_[0]->_CompileBytecode(p_program, p_dest_register))
+		return false;
+	
+	for (size_t child_index = 1; child_index < child_count; ++child_index)
+	{
+		if (!children_[child_index]->_CompileBytecode(p_program, p_dest_register + 1))
+			return false;
+		
+		p_program->instructions_.emplace_back(instruction);
+	}
+	
+	return true;
+}
+
 bool EidosASTNode::HasCachedNumericValue(void) const
 {
 	if ((token_->token_type_ == EidosTokenType::kTokenNumber) && cached_literal_value_ && (cached_literal_value_->Count() == 1))
@@ -31,6 +31,7 @@
 
 class EidosASTNode;
 class EidosInterpreter;
+class EidosSymbolTable;
 
 
 // EidosASTNodes must be allocated out of the global pool, for speed.  See eidos_object_pool.h.  When Eidos disposes of a node,
@@ -64,6 +65,72 @@ struct EidosASTNode_ArgumentCache
 	bool argument_buffer_in_use_;										// prevents argument_buffer_ from being overwritten by recursion
 };
 
+// Register bytecode for pure scalar expressions.  EidosASTNode::_OptimizeBytecode() lowers maximal subtrees built only from
+// numeric/logical constants, identifiers, and the arithmetic, comparison, and logical operators into a compact register program,
+// which EidosInterpreter::Evaluate_Bytecode() executes on unboxed singleton registers, boxing into an EidosValue only for the
+// final result.  Any case the program doesn't handle – a non-singleton operand, a matrix, a string, an integer overflow, an
+// undefined identifier – makes it bail out to the tree-walking evaluator, which then produces the usual result or error.  Since
+// the subtree has no side effects, re-evaluating it through the tree walker after a bail-out is always safe.
+//
+// Programs that use only arithmetic and elementwise math functions can also run over same-length numeric vectors; see
+// EidosInterpreter::_ExecuteBytecodeFused().  Such a program is evaluated in one pass, block by block, into a single result
+// buffer, instead of allocating a temporary vector for every operator and function call in the expression.
+#define EIDOS_BYTECODE_MAX_REGISTERS	16
+#define EIDOS_BYTECODE_BLOCK_SIZE		256
+
+enum class EidosBytecodeOp : uint8_t {
+	kLoadConstant = 0,		// dest = immediate
+	kLoadIdentifier,		// dest = singleton value of identifier node_
+	kNegate,				// dest = -src1
+	kAdd,					// dest = src1 + src2
+	kSubtract,				// dest = src1 - src2
+	kMultiply,				// dest = src1 * src2
+	kDivide,				// dest = src1 / src2
+	kModulo,				// dest = src1 % src2
+	kExponent,				// dest = src1 ^ src2
+	kEqual,					// dest = src1 == src2
+	kNotEqual,				// dest = src1 != src2
+	kLess,					// dest = src1 < src2
+	kLessEqual,				// dest = src1 <= src2
+	kGreater,				// dest = src1 > src2
+	kGreaterEqual,			// dest = src1 >= src2
+	kAnd,					// dest = src1 & src2
+	kOr,					// dest = src1 | src2
+	kNot,					// dest = !src1
+	kFunctionExp,			// dest = exp(src1)
+	kFunctionLog,			// dest = log(src1)
+	kFunctionLog10,			// dest = log10(src1)
+	kFunctionLog2,			// dest = log2(src1)
+	kFunctionSqrt			// dest = sqrt(src1)
+};
+
+struct EidosBytecodeRegister
+{
+	EidosValueType type_;								// kValueLogical, kValueInt, or kValueFloat
+	union {
+		eidos_logical_t logical_;
+		int64_t int_;
+		double float_;
+	};
+};
+
+struct EidosBytecodeInstruction
+{
+	EidosBytecodeOp op_;
+	uint8_t dest_, src1_, src2_;						// register indices
+	EidosBytecodeRegister immediate_;					// for kLoadConstant only
+	const EidosASTNode *node_;							// for kLoadIdentifier only; the identifier node, with cached_stringID_
+};
+
+struct EidosBytecodeProgram
+{
+	std::vector<EidosBytecodeInstruction> instructions_;	// the result is left in register 0
+	EidosEvaluationMethod fallback_evaluator_;				// the tree-walking evaluator for the root node, used on bail-out
+	bool elementwise_ = true;								// true if the program has no comparison or logical operators, so it can run over vectors
+	mutable uint32_t success_count_ = 0;					// runtime statistics, used to give up on programs that usually bail out
+	mutable uint32_t bailout_count_ = 0;
+};
+
 // A class representing a node in a parse tree for a script
 class EidosASTNode
 {
@@ -80,6 +147,9 @@ public:
 	mutable EidosFunctionSignature_CSP cached_signature_ = nullptr;		// a cached pointer to the function signature corresponding to the token, on the call name node
 	mutable EidosEvaluationMethod cached_evaluator_ = nullptr;			// a pre-cached pointer to method to evaluate this node; shorthand for EvaluateNode()
 	mutable EidosGlobalStringID cached_stringID_ = gEidosID_none;		// a pre-cached identifier for the token string, for fast property/method lookup
+	mutable const EidosClass *cached_dispatch_class_ = nullptr;			// property/method name nodes only: the target class for the inline cache below
+	mutable const EidosPropertySignature *cached_property_signature_ = nullptr;	// property name nodes only: the signature for cached_dispatch_class_
+	mutable const EidosMethodSignature *cached_method_signature_ = nullptr;		// method name nodes only: the signature for cached_dispatch_class_
 	
 	uint8_t token_is_owned_ = false;									// if T, we own token_ because it is a virtual token that replaced a real token
 	mutable uint8_t cached_compound_assignment_ = false;				// pre-cached on assignment nodes if they are of the form "x=x+1" or "x=x-1" only
@@ -90,7 +160,13 @@ public:
 	bool was_parenthesized_ = false;									// set to true for nodes that are the child of a set of grouping parentheses
 	
 	mutable EidosASTNode_ArgumentCache *argument_cache_ = nullptr;		// OWNED POINTER: an argument cache struct, allocated on demand for function/method call nodes
+	mutable EidosBytecodeProgram *bytecode_ = nullptr;					// OWNED POINTER: a register program for a pure scalar expression rooted here; see _OptimizeBytecode()
 	
+	mutable const EidosSymbolTable *bound_symbol_key_table_ = nullptr;	// identifier nodes only: the symbol table a constant was resolved by walking from
+	mutable uint64_t bound_symbol_key_serial_ = 0;						// identifier nodes only: the serial of bound_symbol_key_table_, to detect address reuse
+	mutable EidosValue *bound_symbol_value_ = nullptr;					// identifier nodes only: the resolved constant; see EidosSymbolTable::GetValueRawOrNullForASTNode_Bound()
+	mutable uint64_t bound_symbol_epoch_ = 0;							// identifier nodes only: the constants epoch at which the binding was made
+
 #if (SLIMPROFILING == 1)
 	// PROFILING
 	mutable eidos_profile_t profile_total_ = 0;							// profiling clock for this node and its children; only set for some nodes
@@ -118,6 +194,53 @@ public:
 	void _OptimizeIdentifiers(void) const;								// cache function signatures, global strings for methods and properties, etc.
 	void _OptimizeEvaluators(void) const;								// cache pointers to method for evaluation
 	void _OptimizeAssignments(void) const;								// detect and mark simple increment/decrement assignments on a variable
+	void _OptimizeBytecode(void) const;									// compile pure scalar expressions to register bytecode
+	bool _CompileBytecode(EidosBytecodeProgram *p_program, int p_dest_register) const;
+	void _OptimizeTypeSpecializations(void) const;						// specialize evaluators for operand types inferred by EidosTypeInterpreter
+	
+	// the number of leading children visited by the optimization passes; the body of a function declaration is skipped, since it
+	// is never evaluated in place – Evaluate_FunctionDecl() gives the function its own copy of the body, optimized separately
+	inline size_t OptimizedChildCount(void) const { return (((token_->token_type_ == EidosTokenType::kTokenFunction) && (children_.size() == 4)) ? 3 : children_.size()); }
+
+	// Monomorphic inline caches for property and method dispatch, used on the identifier node y of x.y and x.y() by EidosInterpreter.
+	// Repeated dispatch on targets of the same class skips the dispatch table lookup; a target of a different class refills the cache
+	// from the class's dispatch table, which remains the lookup of record.  Dispatch tables are fixed after warmup, so this is safe.
+	// The cache is left alone inside parallel regions, where the node may be shared; a miss there just uses the dispatch table.
+	inline __attribute__((always_inline)) const EidosPropertySignature *PropertySignatureForClass(const EidosClass *p_class) const
+	{
+		if (p_class != cached_dispatch_class_)
+		{
+			const EidosPropertySignature *signature = p_class->SignatureForProperty(cached_stringID_);
+			
+			if (!omp_in_parallel())
+			{
+				cached_property_signature_ = signature;
+				cached_dispatch_class_ = p_class;
+			}
+			
+			return signature;
+		}
+		
+		return cached_property_signature_;
+	}
+	
+	inline __attribute__((always_inline)) const EidosMethodSignature *MethodSignatureForClass(const EidosClass *p_class) const
+	{
+		if (p_class != cached_dispatch_class_)
+		{
+			const EidosMethodSignature *signature = p_class->SignatureForMethod(cached_stringID_);
+			
+			if (!omp_in_parallel())
+			{
+				cached_method_signature_ = signature;
+				cached_dispatch_class_ = p_class;
+			}
+			
+			return signature;
+		}
+		
+		return cached_method_signature_;
+	}
 	
 	bool HasCachedNumericValue(void) const;
 	double CachedNumericValue(void) const;
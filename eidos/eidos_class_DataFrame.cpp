@@ -23,7 +23,7 @@
 #include "eidos_interpreter.h"
 
 #include <fstream>
-#include <regex>
+#include <deque>
 #include <limits>
 #include <string>
 #include <algorithm>
@@ -716,71 +716,160 @@ static EidosValue_SP Eidos_Instantiate_EidosDataFrame(const std::vector<EidosVal
 	return result_SP;
 }
 
-//	(object<DataFrame>$)readCSV(string$ filePath, [ls colNames = T], [Ns$ colTypes = NULL], [string$ sep = ","], [string$ quote = "\""], [string$ dec = "."], [string$ comment = ""])
-static EidosValue_SP Eidos_ExecuteFunction_readCSV(const std::vector<EidosValue_SP> &p_arguments, EidosInterpreter &p_interpreter)
+// readCSV() parses its input in line-aligned chunks, in parallel when running multithreaded.  Each element is recorded as a span
+// of bytes; unquoted elements point directly into the file data, while quoted elements (which need unquoting) are stored by the
+// chunk.  Since a quoted element can span lines, input containing the quote character is parsed as a single chunk.
+struct _EidosCSVElement
 {
-	EidosValue *filePath_value = p_arguments[0].get();
-	EidosValue *colNames_value = p_arguments[1].get();
-	EidosValue *colTypes_value = p_arguments[2].get();
-	EidosValue *sep_value = p_arguments[3].get();
-	EidosValue *quote_value = p_arguments[4].get();
-	EidosValue *dec_value = p_arguments[5].get();
-	EidosValue *comment_value = p_arguments[6].get();
+	const char *data_;
+	size_t length_;
+};
+
+// Bits for the column types an element could be read as; a column's guessed type is the first type that all its elements allow
+#define EIDOS_CSV_LOGICAL	0x01
+#define EIDOS_CSV_INTEGER	0x02
+#define EIDOS_CSV_FLOAT		0x04
+
+enum class _EidosCSVError
+{
+	kNone = 0,
+	kColumnCount,					// an inconsistent column count; observed count in error_count_
+	kUnexpectedEOF,					// an unexpected end-of-file inside a quoted element
+	kUnexpectedCharacter			// an unexpected character, error_char_, after the end of a quoted element
+};
+
+struct _EidosCSVChunk
+{
+	const char *start_;
+	const char *end_;
+	
+	std::vector<_EidosCSVElement> elements_;		// the elements of the chunk's rows, in row-major order
+	std::deque<std::string> quoted_elements_;		// storage for the unquoted contents of quoted elements; a deque keeps them in place
+	int64_t row_count_ = 0;
+	int ncols_ = -1;								// the column count of the first row in the chunk
+	int64_t first_row_line_ = 0;					// the line number of the end of the first row, counting from 1 within the chunk
+	int64_t line_count_ = 0;						// the number of lines in the chunk
+	std::vector<uint8_t> first_row_types_;			// per column, the EIDOS_CSV_ bits allowed by the first row's element, which might be a header
+	std::vector<uint8_t> column_types_;				// per column, the EIDOS_CSV_ bits allowed by the elements of all subsequent rows
+	
+	_EidosCSVError error_ = _EidosCSVError::kNone;	// the first error in the chunk, if any; parsing stops at an error
+	int64_t error_line_ = 0;						// the line number of the error, within the chunk
+	size_t error_count_ = 0;
+	char error_char_ = 0;
+};
+
+// Compares p_length characters at p_data to the uppercase word p_word, case-insensitively
+static bool _Eidos_CSVWordEquals(const char *p_data, size_t p_length, const char *p_word)
+{
+	for (size_t index = 0; index < p_length; ++index)
+		if ((p_word[index] == 0) || (std::toupper((unsigned char)p_data[index]) != p_word[index]))
+			return false;
 	
-	// Start by opening the CSV data file; a little weird that we just warn and retunr NULL on a file I/O error, but this follows readFile()
-	std::string base_path = filePath_value->StringAtIndex_NOCAST(0, nullptr);
-	std::string file_path = Eidos_ResolvedPath(base_path);
+	return (p_word[p_length] == 0);
+}
+
+// Returns the EIDOS_CSV_ bits for the types that an element could be read as, matching the integer pattern "[+-]?[0-9]+" and the
+// float pattern "[+-]?[0-9]+(\.[0-9]*)?([eE][+-]?[0-9]+)?" (with dec as the decimal separator) or a case-insensitive NAN or INF
+static uint8_t _Eidos_CSVElementTypes(const char *p_data, size_t p_length, char p_dec)
+{
+	switch (p_length)
+	{
+		case 1:
+			if ((*p_data == 'T') || (*p_data == 'F'))
+				return EIDOS_CSV_LOGICAL;
+			break;
+		case 4:
+			if ((strncmp(p_data, "TRUE", 4) == 0) || (strncmp(p_data, "true", 4) == 0))
+				return EIDOS_CSV_LOGICAL;
+			break;
+		case 5:
+			if ((strncmp(p_data, "FALSE", 5) == 0) || (strncmp(p_data, "false", 5) == 0))
+				return EIDOS_CSV_LOGICAL;
+			break;
+	}
+	
+	const char *ptr = p_data;
+	const char *end = p_data + p_length;
+	
+	// optional sign and required digits; an integer ends here
+	if ((ptr < end) && ((*ptr == '+') || (*ptr == '-')))
+		ptr++;
+	
+	const char *digits_start = ptr;
 	
-	std::ifstream file_stream(file_path.c_str());
+	while ((ptr < end) && (*ptr >= '0') && (*ptr <= '9'))
+		ptr++;
 	
-	if (!file_stream.is_open())
+	if (ptr != digits_start)
 	{
-		if (!gEidosSuppressWarnings)
-			p_interpreter.ErrorOutputStream() << "#WARNING (Eidos_ExecuteFunction_readCSV): function readCSV() could not read file at path " << file_path << "." << std::endl;
-		return gStaticEidosValueNULL;
+		if (ptr == end)
+			return EIDOS_CSV_INTEGER | EIDOS_CSV_FLOAT;
+		
+		// optional fraction
+		if (*ptr == p_dec)
+		{
+			ptr++;
+			while ((ptr < end) && (*ptr >= '0') && (*ptr <= '9'))
+				ptr++;
+		}
+		
+		// optional exponent, with required digits
+		if ((ptr < end) && ((*ptr == 'e') || (*ptr == 'E')))
+		{
+			ptr++;
+			if ((ptr < end) && ((*ptr == '+') || (*ptr == '-')))
+				ptr++;
+			
+			const char *exponent_start = ptr;
+			
+			while ((ptr < end) && (*ptr >= '0') && (*ptr <= '9'))
+				ptr++;
+			
+			if (ptr == exponent_start)
+				return 0;
+		}
+		
+		return (ptr == end) ? EIDOS_CSV_FLOAT : 0;
 	}
-
-	// Figure out our various separators/delimiters
-	std::string sep_string = sep_value->StringAtIndex_NOCAST(0, nullptr);
-	std::string quote_string = quote_value->StringAtIndex_NOCAST(0, nullptr);
-	std::string dec_string = dec_value->StringAtIndex_NOCAST(0, nullptr);
-	std::string comment_string = comment_value->StringAtIndex_NOCAST(0, nullptr);
 	
-	if (sep_string.length() > 1)
-		EIDOS_TERMINATION << "ERROR (Eidos_ExecuteFunction_readCSV): readCSV() requires that sep be a string of exactly one character, or the empty string \"\"." << EidosTerminate(nullptr);
-	if (quote_string.length() != 1)
-		EIDOS_TERMINATION << "ERROR (Eidos_ExecuteFunction_readCSV): readCSV() requires that quote be a string of exactly one character." << EidosTerminate(nullptr);
-	if (dec_string.length() != 1)
-		EIDOS_TERMINATION << "ERROR (Eidos_ExecuteFunction_readCSV): readCSV() requires that dec be a string of exactly one character." << EidosTerminate(nullptr);
-	if (comment_string.length() > 1)
-		EIDOS_TERMINATION << "ERROR (Eidos_ExecuteFunction_readCSV): readCSV() requires that comment be a string of exactly one character, or the empty string." << EidosTerminate(nullptr);
+	// NAN, INF, INFINITY, -INF, -INFINITY, +INF, +INFINITY are also accepted as float
+	if (_Eidos_CSVWordEquals(p_data, p_length, "NAN"))
+		return EIDOS_CSV_FLOAT;
 	
-	char sep = (sep_string.length() ? sep_string[0] : 0);				// 0 indicates "whitespace separator", a special case
-	char quote = quote_string[0];
-	char dec = dec_string[0];
-	char comment = (comment_string.length() ? comment_string[0] : 0);	// 0 indicates "no comments"
+	size_t word_length = (size_t)(end - ptr);
 	
-	if ((sep && ((sep == quote) || (sep == dec) || (sep == comment))) ||
-		((quote == dec) || (quote == comment) || (dec == comment)))
-		EIDOS_TERMINATION << "ERROR (Eidos_ExecuteFunction_readCSV): readCSV() requires sep, quote, dec, and comment to be different from each other." << EidosTerminate(nullptr);
-	if (!std::isprint(dec) || std::isalnum(dec) || (dec == '+') || (dec == '-'))
-		EIDOS_TERMINATION << "ERROR (Eidos_ExecuteFunction_readCSV): readCSV() requires that dec be a printable, non-alphanumeric character that is not '+' or '-' (typically '.' or ',')." << EidosTerminate(nullptr);
+	if (_Eidos_CSVWordEquals(ptr, word_length, "INF") || _Eidos_CSVWordEquals(ptr, word_length, "INFINITY"))
+		return EIDOS_CSV_FLOAT;
 	
-	// Read lines and split each line up into components; this is non-trivial since it involves parsing out quoted strings and unquoting them
-	// Check that each line has the same number of components as we go along, to avoid having to make an extra pass
-	std::string line;
-	std::vector<std::vector<std::string>> rows;
-	int ncols = -1, line_number = 0;
+	return 0;
+}
+
+// Parses the lines from p_chunk.start_ to p_chunk.end_ into elements, classifying each element for type guessing as it goes.  This
+// does not raise, since it may run in parallel; errors are recorded in the chunk for the caller to raise.
+static void _Eidos_ParseCSVChunk(_EidosCSVChunk &p_chunk, char sep, char quote, char dec, char comment)
+{
+	const char *chunk_pos = p_chunk.start_;
+	const char *chunk_end = p_chunk.end_;
+	int64_t line_number = 0;
+	size_t row_start = 0;
 	
-	while (getline(file_stream, line))
+	while (chunk_pos < chunk_end)
 	{
-		// split line into strings based on sep, quote, and comment
-		std::vector<std::string> row;
-		const char *line_ptr = line.data();
-		char ch = *line_ptr;
+		// find the end of the line; like getline(), a final line need not end in a newline
+		const char *line_ptr = chunk_pos;
+		const char *line_end = (const char *)memchr(chunk_pos, '\n', chunk_end - chunk_pos);
+		
+		if (!line_end)
+			line_end = chunk_end;
 		
+		chunk_pos = ((line_end < chunk_end) ? line_end + 1 : chunk_end);
 		line_number++;		// after this increment, this has the line number (1-based) we are current parsing
 		
+		// a NUL character ends the line's contents, as it did when lines were read into std::string and parsed as C strings
+		char ch = ((line_ptr < line_end) ? *line_ptr : 0);
+		
+		auto next_char = [&line_ptr, &line_end](void) { return ((++line_ptr < line_end) ? *line_ptr : (char)0); };
+		
 		// a line is allowed to be completely empty, or to be a comment line (starting at its first character)
 		if ((ch == 0) || (comment && (ch == comment)))
 			continue;
@@ -788,7 +877,9 @@ static EidosValue_SP Eidos_ExecuteFunction_readCSV(const std::vector<EidosValue_
 		// if the separator is "whitespace" the line can begin with whitespace, which we eat here
 		if (!sep)
 			while ((ch == ' ') || (ch == '\t'))
-				ch = *(++line_ptr);
+				ch = next_char();
+		
+		row_start = p_chunk.elements_.size();
 		
 		do
 		{
@@ -802,7 +893,7 @@ static EidosValue_SP Eidos_ExecuteFunction_readCSV(const std::vector<EidosValue_
 			{
 				// empty element (if the separator is not whitespace), and then end the line
 				if (sep)
-					row.emplace_back();
+					p_chunk.elements_.emplace_back(_EidosCSVElement{line_ptr, 0});
 				break;
 			}
 			
@@ -812,8 +903,8 @@ static EidosValue_SP Eidos_ExecuteFunction_readCSV(const std::vector<EidosValue_
 			// because two consecutive "whitespace" separators cannot occur, whereas ",," can occur implying an empty string
 			if (ch == sep)
 			{
-				row.emplace_back();
-				ch = *(++line_ptr);
+				p_chunk.elements_.emplace_back(_EidosCSVElement{line_ptr, 0});
+				ch = next_char();
 				continue;
 			}
 			
@@ -822,10 +913,11 @@ static EidosValue_SP Eidos_ExecuteFunction_readCSV(const std::vector<EidosValue_
 			if (ch == quote)
 			{
 				// quoted string: read until the end quote, unquoting doubled quotes
-				std::string element_string;
+				p_chunk.quoted_elements_.emplace_back();
+				std::string &element_string = p_chunk.quoted_elements_.back();
 				
 				// eat the quote and get the next character
-				ch = *(++line_ptr);
+				ch = next_char();
 				
 				do
 				{
@@ -835,25 +927,35 @@ static EidosValue_SP Eidos_ExecuteFunction_readCSV(const std::vector<EidosValue_
 					if (ch == 0)
 					{
 						// we reached the end of the line, but we're still inside the quoted element; incorporate the implied newline and keep going
-						if (!getline(file_stream, line))
-							EIDOS_TERMINATION << "ERROR (Eidos_ExecuteFunction_readCSV): function readCSV() encountered an unexpected end-of-file inside a quoted element, at line " << line_number << "." << EidosTerminate(nullptr);
+						if (chunk_pos >= chunk_end)
+						{
+							p_chunk.error_ = _EidosCSVError::kUnexpectedEOF;
+							p_chunk.error_line_ = line_number;
+							return;
+						}
 						
 						element_string.append(1, '\n');
 						line_number++;
-						line_ptr = line.data();
-						ch = *line_ptr;
+						line_ptr = chunk_pos;
+						line_end = (const char *)memchr(chunk_pos, '\n', chunk_end - chunk_pos);
+						
+						if (!line_end)
+							line_end = chunk_end;
+						
+						chunk_pos = ((line_end < chunk_end) ? line_end + 1 : chunk_end);
+						ch = ((line_ptr < line_end) ? *line_ptr : 0);
 					}
 					else if (ch == quote)
 					{
 						// we hit a quote character; if the *next* character is also a quote, then we have a double quote,
 						// which is an escape indicating a single quote, otherwise we have terminated the element
-						ch = *(++line_ptr);
+						ch = next_char();
 						
 						if (ch == quote)
 						{
 							// doubled quote; append one quote and continue
 							element_string.append(1, quote);
-							ch = *(++line_ptr);
+							ch = next_char();
 						}
 						else
 						{
@@ -861,14 +963,14 @@ static EidosValue_SP Eidos_ExecuteFunction_readCSV(const std::vector<EidosValue_
 							// at this point, we expect only a separator, a comment, or a line end; the element is done
 							if (sep && (ch == sep))
 							{
-								ch = *(++line_ptr);
+								ch = next_char();
 								break;
 							}
 							else if (!sep && ((ch == ' ') || (ch == '\t')))
 							{
 								// eat a "whitespace" separator, similar to above
 								while ((ch == ' ') || (ch == '\t'))
-									ch = *(++line_ptr);
+									ch = next_char();
 								break;
 							}
 							else if ((ch == 0) || (comment && (ch == comment)))
@@ -878,7 +980,10 @@ static EidosValue_SP Eidos_ExecuteFunction_readCSV(const std::vector<EidosValue_
 							}
 							else
 							{
-								EIDOS_TERMINATION << "ERROR (Eidos_ExecuteFunction_readCSV): function readCSV() encountered an unexpected character '" << ch << "' after the end of a quoted element." << EidosTerminate(nullptr);
+								p_chunk.error_ = _EidosCSVError::kUnexpectedCharacter;
+								p_chunk.error_line_ = line_number;
+								p_chunk.error_char_ = ch;
+								return;
 							}
 						}
 					}
@@ -886,24 +991,25 @@ static EidosValue_SP Eidos_ExecuteFunction_readCSV(const std::vector<EidosValue_
 					{
 						// this character is part of the element; the above cases are the only exceptions
 						element_string.append(1, ch);
-						ch = *(++line_ptr);
+						ch = next_char();
 					}
 				}
 				while (true);
 				
 				// add the completed element to the row
-				row.emplace_back(element_string);
+				p_chunk.elements_.emplace_back(_EidosCSVElement{element_string.data(), element_string.length()});
 			}
 			else
 			{
 				// unquoted string: read until a separator, comment, or null
-				std::string element_string;
+				const char *element_start = line_ptr;
+				const char *element_end;
 				
 				do
 				{
-					// at the top of the loop, ch has a valid character to be added to the element; do so
-					element_string.append(1, ch);
-					ch = *(++line_ptr);
+					// at the top of the loop, ch has a valid character that is part of the element; move past it
+					ch = next_char();
+					element_end = line_ptr;
 					
 					// now decide what to do about the next character
 					// NOLINTBEGIN(*-branch-clone) : intentional branch clones
@@ -917,14 +1023,14 @@ static EidosValue_SP Eidos_ExecuteFunction_readCSV(const std::vector<EidosValue_
 					{
 						// we hit a separator, which terminates the element but expects another
 						// eat the separator so we're at the start of the next element
-						ch = *(++line_ptr);
+						ch = next_char();
 						break;
 					}
 					else if (!sep && ((ch == ' ') || (ch == '\t')))
 					{
 						// eat a "whitespace" separator, similar to above
 						while ((ch == ' ') || (ch == '\t'))
-							ch = *(++line_ptr);
+							ch = next_char();
 						break;
 					}
 					else if (comment && (ch == comment))
@@ -940,7 +1046,7 @@ static EidosValue_SP Eidos_ExecuteFunction_readCSV(const std::vector<EidosValue_
 				while (true);
 				
 				// add the completed element to the row
-				row.emplace_back(element_string);
+				p_chunk.elements_.emplace_back(_EidosCSVElement{element_start, (size_t)(element_end - element_start)});
 			}
 			
 			// if we ended the line above without seeing a separator, we do not expect another element; the row is done
@@ -950,34 +1056,186 @@ static EidosValue_SP Eidos_ExecuteFunction_readCSV(const std::vector<EidosValue_
 		}
 		while (true);
 		
-		// check the column count, and if it passes, append this row to our buffer and move on
-		if (ncols == -1)
-			ncols = (int)row.size();
-		else if (ncols != (int)row.size())
-			EIDOS_TERMINATION << "ERROR (Eidos_ExecuteFunction_readCSV): function readCSV() encountered an inconsistent column count in CSV file (" << row.size() << " observed, " << ncols << " previously), at line " << line_number << "." << EidosTerminate(nullptr);
+		// check the column count; the caller checks the first row of each chunk against the first row of the file
+		size_t row_size = p_chunk.elements_.size() - row_start;
+		
+		if (p_chunk.ncols_ == -1)
+		{
+			p_chunk.ncols_ = (int)row_size;
+			p_chunk.first_row_line_ = line_number;
+			p_chunk.first_row_types_.resize(row_size);
+			p_chunk.column_types_.resize(row_size, EIDOS_CSV_LOGICAL | EIDOS_CSV_INTEGER | EIDOS_CSV_FLOAT);
+			
+			for (size_t col_index = 0; col_index < row_size; ++col_index)
+			{
+				const _EidosCSVElement &element = p_chunk.elements_[row_start + col_index];
+				
+				p_chunk.first_row_types_[col_index] = _Eidos_CSVElementTypes(element.data_, element.length_, dec);
+			}
+		}
+		else if (p_chunk.ncols_ != (int)row_size)
+		{
+			p_chunk.elements_.resize(row_start);
+			p_chunk.error_ = _EidosCSVError::kColumnCount;
+			p_chunk.error_line_ = line_number;
+			p_chunk.error_count_ = row_size;
+			return;
+		}
+		else
+		{
+			// narrow the possible types of each column; once a column can only be a string, its elements need not be classified
+			for (size_t col_index = 0; col_index < row_size; ++col_index)
+			{
+				uint8_t &column_types = p_chunk.column_types_[col_index];
+				
+				if (column_types)
+				{
+					const _EidosCSVElement &element = p_chunk.elements_[row_start + col_index];
+					
+					column_types &= _Eidos_CSVElementTypes(element.data_, element.length_, dec);
+				}
+			}
+		}
 		
-		rows.emplace_back(row);
+		p_chunk.row_count_++;
 	}
 	
-	if (file_stream.bad())
+	p_chunk.line_count_ = line_number;
+}
+
+//	(object<DataFrame>$)readCSV(string$ filePath, [ls colNames = T], [Ns$ colTypes = NULL], [string$ sep = ","], [string$ quote = "\""], [string$ dec = "."], [string$ comment = ""])
+static EidosValue_SP Eidos_ExecuteFunction_readCSV(const std::vector<EidosValue_SP> &p_arguments, EidosInterpreter &p_interpreter)
+{
+	EidosValue *filePath_value = p_arguments[0].get();
+	EidosValue *colNames_value = p_arguments[1].get();
+	EidosValue *colTypes_value = p_arguments[2].get();
+	EidosValue *sep_value = p_arguments[3].get();
+	EidosValue *quote_value = p_arguments[4].get();
+	EidosValue *dec_value = p_arguments[5].get();
+	EidosValue *comment_value = p_arguments[6].get();
+	
+	// Start by reading the CSV data file; a little weird that we just warn and return NULL on a file I/O error, but this follows readFile()
+	// The file is mapped into memory, or decompressed into a buffer if it is gzip data, and parsed from there without a copy
+	std::string base_path = filePath_value->StringAtIndex_NOCAST(0, nullptr);
+	std::string file_path = Eidos_ResolvedPath(base_path);
+	Eidos_MappedFile mapped_file(file_path);
+	std::vector<char> file_buffer;
+	const char *file_data;
+	size_t file_size;
+	
+	if (!Eidos_GetFileContents(file_path, mapped_file, file_buffer, &file_data, &file_size))
 	{
 		if (!gEidosSuppressWarnings)
-			p_interpreter.ErrorOutputStream() << "#WARNING (Eidos_ExecuteFunction_readCSV): function readCSV() encountered stream errors while reading file at path " << file_path << "." << std::endl;
+			p_interpreter.ErrorOutputStream() << "#WARNING (Eidos_ExecuteFunction_readCSV): function readCSV() could not read file at path " << file_path << "." << std::endl;
 		return gStaticEidosValueNULL;
 	}
+
+	// Figure out our various separators/delimiters
+	std::string sep_string = sep_value->StringAtIndex_NOCAST(0, nullptr);
+	std::string quote_string = quote_value->StringAtIndex_NOCAST(0, nullptr);
+	std::string dec_string = dec_value->StringAtIndex_NOCAST(0, nullptr);
+	std::string comment_string = comment_value->StringAtIndex_NOCAST(0, nullptr);
+	
+	if (sep_string.length() > 1)
+		EIDOS_TERMINATION << "ERROR (Eidos_ExecuteFunction_readCSV): readCSV() requires that sep be a string of exactly one character, or the empty string \"\"." << EidosTerminate(nullptr);
+	if (quote_string.length() != 1)
+		EIDOS_TERMINATION << "ERROR (Eidos_ExecuteFunction_readCSV): readCSV() requires that quote be a string of exactly one character." << EidosTerminate(nullptr);
+	if (dec_string.length() != 1)
+		EIDOS_TERMINATION << "ERROR (Eidos_ExecuteFunction_readCSV): readCSV() requires that dec be a string of exactly one character." << EidosTerminate(nullptr);
+	if (comment_string.length() > 1)
+		EIDOS_TERMINATION << "ERROR (Eidos_ExecuteFunction_readCSV): readCSV() requires that comment be a string of exactly one character, or the empty string." << EidosTerminate(nullptr);
+	
+	char sep = (sep_string.length() ? sep_string[0] : 0);				// 0 indicates "whitespace separator", a special case
+	char quote = quote_string[0];
+	char dec = dec_string[0];
+	char comment = (comment_string.length() ? comment_string[0] : 0);	// 0 indicates "no comments"
+	
+	if ((sep && ((sep == quote) || (sep == dec) || (sep == comment))) ||
+		((quote == dec) || (quote == comment) || (dec == comment)))
+		EIDOS_TERMINATION << "ERROR (Eidos_ExecuteFunction_readCSV): readCSV() requires sep, quote, dec, and comment to be different from each other." << EidosTerminate(nullptr);
+	if (!std::isprint(dec) || std::isalnum(dec) || (dec == '+') || (dec == '-'))
+		EIDOS_TERMINATION << "ERROR (Eidos_ExecuteFunction_readCSV): readCSV() requires that dec be a printable, non-alphanumeric character that is not '+' or '-' (typically '.' or ',')." << EidosTerminate(nullptr);
+	
+	// Split the data into line-aligned chunks and split each line of each chunk up into elements, in parallel; this is non-trivial since
+	// it involves parsing out quoted strings and unquoting them.  A quoted element can span lines, so a chunk boundary cannot be placed
+	// safely if the quote character occurs anywhere; in that case the whole file is parsed as a single chunk.
+	std::vector<_EidosCSVChunk> chunks;
+	
+	if (memchr(file_data, quote, file_size))
+	{
+		chunks.resize(1);
+		chunks[0].start_ = file_data;
+		chunks[0].end_ = file_data + file_size;
+	}
+	else
+	{
+		std::vector<std::pair<const char *, const char *>> chunk_ranges = Eidos_LineAlignedChunks(file_data, file_size, 1024 * 1024);
+		
+		chunks.resize(chunk_ranges.size());
+		
+		for (size_t chunk_index = 0; chunk_index < chunk_ranges.size(); ++chunk_index)
+		{
+			chunks[chunk_index].start_ = chunk_ranges[chunk_index].first;
+			chunks[chunk_index].end_ = chunk_ranges[chunk_index].second;
+		}
+	}
+	
+	int64_t chunk_count = (int64_t)chunks.size();
+	
+	EIDOS_THREAD_COUNT(gEidos_OMP_threads_FILE_INPUT);
+#pragma omp parallel for schedule(dynamic, 1) default(none) shared(chunks, chunk_count, sep, quote, dec, comment) if(chunk_count >= EIDOS_OMPMIN_FILE_INPUT) num_threads(thread_count)
+	for (int64_t chunk_index = 0; chunk_index < chunk_count; ++chunk_index)
+		_Eidos_ParseCSVChunk(chunks[chunk_index], sep, quote, dec, comment);
+	
+	// Check that each chunk has the same number of columns as the first row, and raise the first error in the file, if any; the
+	// line numbers in each chunk are relative to the start of the chunk, so we offset them by the line counts of preceding chunks
+	int ncols = -1;
+	int64_t line_offset = 0, nrows_total = 0;
+	const _EidosCSVChunk *first_row_chunk = nullptr;
+	
+	for (const _EidosCSVChunk &chunk : chunks)
+	{
+		if (chunk.ncols_ != -1)
+		{
+			if (ncols == -1)
+			{
+				ncols = chunk.ncols_;
+				first_row_chunk = &chunk;
+			}
+			else if (ncols != chunk.ncols_)
+				EIDOS_TERMINATION << "ERROR (Eidos_ExecuteFunction_readCSV): function readCSV() encountered an inconsistent column count in CSV file (" << chunk.ncols_ << " observed, " << ncols << " previously), at line " << (line_offset + chunk.first_row_line_) << "." << EidosTerminate(nullptr);
+		}
+		
+		if (chunk.error_ == _EidosCSVError::kColumnCount)
+			EIDOS_TERMINATION << "ERROR (Eidos_ExecuteFunction_readCSV): function readCSV() encountered an inconsistent column count in CSV file (" << chunk.error_count_ << " observed, " << ncols << " previously), at line " << (line_offset + chunk.error_line_) << "." << EidosTerminate(nullptr);
+		else if (chunk.error_ == _EidosCSVError::kUnexpectedEOF)
+			EIDOS_TERMINATION << "ERROR (Eidos_ExecuteFunction_readCSV): function readCSV() encountered an unexpected end-of-file inside a quoted element, at line " << (line_offset + chunk.error_line_) << "." << EidosTerminate(nullptr);
+		else if (chunk.error_ == _EidosCSVError::kUnexpectedCharacter)
+			EIDOS_TERMINATION << "ERROR (Eidos_ExecuteFunction_readCSV): function readCSV() encountered an unexpected character '" << chunk.error_char_ << "' after the end of a quoted element." << EidosTerminate(nullptr);
+		
+		line_offset += chunk.line_count_;
+		nrows_total += chunk.row_count_;
+	}
 	
 	// Decide on the name for each column, using colNames and/or defaults
-	// If a header line is expected, this removes the first input line to act as the header
+	// If a header line is expected, this uses the first input row as the header, and the data rows begin after it
 	std::vector<std::string> columnNames;
+	bool has_header = false;
 	
 	if ((colNames_value->Type() == EidosValueType::kValueLogical) && (colNames_value->Count() == 1) && (colNames_value->LogicalAtIndex_NOCAST(0, nullptr) == true))
 	{
 		// colNames == T means "a header row is present, use it"
-		if (rows.size() == 0)
+		if (!first_row_chunk)
 			EIDOS_TERMINATION << "ERROR (Eidos_ExecuteFunction_readCSV): readCSV() found no header row, but colNames==T indicating that one is expected." << EidosTerminate(nullptr);
 		
-		columnNames = rows[0];
-		rows.erase(rows.begin());
+		for (int col_index = 0; col_index < ncols; ++col_index)
+		{
+			const _EidosCSVElement &element = first_row_chunk->elements_[col_index];
+			
+			columnNames.emplace_back(element.data_, element.length_);
+		}
+		
+		has_header = true;
 	}
 	else if ((colNames_value->Type() == EidosValueType::kValueLogical) && (colNames_value->Count() == 1) && (colNames_value->LogicalAtIndex_NOCAST(0, nullptr) == false))
 	{
@@ -1061,74 +1319,35 @@ static EidosValue_SP Eidos_ExecuteFunction_readCSV(const std::vector<EidosValue_
 		has_null_coltype = true;
 	}
 	
-	// Resolve the type for columns that we're supposed to guess on
+	// Resolve the type for columns that we're supposed to guess on, from the possible types that parsing found for each column; we try
+	// logical first, then integer, then float, and string is the fallback.  The header row, if any, is not considered.
 	if (has_null_coltype)
 	{
-		if (!Eidos_RegexWorks())
-			EIDOS_TERMINATION << "ERROR (Eidos_ExecuteFunction_grep): This build of Eidos does not have a working <regex> library, due to a bug in the underlying C++ standard library provided by the system.  Calls to readCSV() that require guessing the type of a column (which uses regex) are therefore not allowed.  This problem might be resolved by updating your compiler or toolchain, or by upgrading to a more recent version of your operating system." << EidosTerminate(nullptr);
-	
-		std::regex integer_regex("[+-]?[0-9]+", std::regex_constants::ECMAScript);
-		std::regex float_regex(std::string("[+-]?[0-9]+(\\") + std::string(1, dec) + std::string("[0-9]*)?([eE][+-]?[0-9]+)?"), std::regex_constants::ECMAScript);
-		
 		for (int col_index = 0; col_index < ncols; ++col_index)
 		{
 			if (coltypes[col_index] == EidosValueType::kValueNULL)
 			{
-				// Try EidosValueType::kValueLogical first; candidate values are "T", "TRUE", "true", "F", "FALSE", or "false", case-sensitive
-				EidosValueType coltype = EidosValueType::kValueLogical;
-				
-				if (coltype == EidosValueType::kValueLogical)
-				{
-					for (const auto &row : rows)
-					{
-						const std::string &row_value = row[col_index];
-						
-						if ((row_value != "T") && (row_value != "TRUE") && (row_value != "true") && (row_value != "F") && (row_value != "FALSE") && (row_value != "false"))
-						{
-							coltype = EidosValueType::kValueInt;	// try integer next
-							break;
-						}
-					}
-				}
+				uint8_t column_types = EIDOS_CSV_LOGICAL | EIDOS_CSV_INTEGER | EIDOS_CSV_FLOAT;
 				
-				if (coltype == EidosValueType::kValueInt)
+				for (const _EidosCSVChunk &chunk : chunks)
 				{
-					for (const auto &row : rows)
-					{
-						const std::string &row_value = row[col_index];
-						
-						if (!std::regex_match(row_value, integer_regex))
-						{
-							coltype = EidosValueType::kValueFloat;	// try float next
-							break;
-						}
-					}
-				}
-				
-				if (coltype == EidosValueType::kValueFloat)
-				{
-					for (const auto &row : rows)
-					{
-						const std::string &row_value = row[col_index];
-						
-						if (Eidos_string_equalsCaseInsensitive(row_value, "NAN") ||
-							Eidos_string_equalsCaseInsensitive(row_value, "INF") ||
-							Eidos_string_equalsCaseInsensitive(row_value, "INFINITY") ||
-							Eidos_string_equalsCaseInsensitive(row_value, "-INF") ||
-							Eidos_string_equalsCaseInsensitive(row_value, "-INFINITY") ||
-							Eidos_string_equalsCaseInsensitive(row_value, "+INF") ||
-							Eidos_string_equalsCaseInsensitive(row_value, "+INFINITY"))
-							continue;
-						
-						if (!std::regex_match(row_value, float_regex))
-						{
-							coltype = EidosValueType::kValueString;	// string is the fallback
-							break;
-						}
-					}
+					if (chunk.ncols_ == -1)
+						continue;
+					
+					if (!has_header || (&chunk != first_row_chunk))
+						column_types &= chunk.first_row_types_[col_index];
+					
+					column_types &= chunk.column_types_[col_index];
 				}
 				
-				coltypes[col_index] = coltype;
+				if (column_types & EIDOS_CSV_LOGICAL)
+					coltypes[col_index] = EidosValueType::kValueLogical;
+				else if (column_types & EIDOS_CSV_INTEGER)
+					coltypes[col_index] = EidosValueType::kValueInt;
+				else if (column_types & EIDOS_CSV_FLOAT)
+					coltypes[col_index] = EidosValueType::kValueFloat;
+				else
+					coltypes[col_index] = EidosValueType::kValueString;
 			}
 		}
 	}
@@ -1140,8 +1359,17 @@ static EidosValue_SP Eidos_ExecuteFunction_readCSV(const std::vector<EidosValue_
 	
 	objectElement->Release();	// objectElement is now retained by result_SP, so we can release it
 	
-	// Put the row data into the DataFrame, column by column
-	int nrows = (int)rows.size();
+	// Make the column values, and find where each chunk's rows begin in them
+	int64_t nrows = nrows_total - (has_header ? 1 : 0);
+	std::vector<EidosValue_SP> column_values(std::max(ncols, 0));
+	std::vector<int64_t> chunk_row_starts(chunk_count, 0);
+	
+	for (int64_t chunk_index = 1; chunk_index < chunk_count; ++chunk_index)
+	{
+		const _EidosCSVChunk &previous_chunk = chunks[chunk_index - 1];
+		
+		chunk_row_starts[chunk_index] = chunk_row_starts[chunk_index - 1] + previous_chunk.row_count_ - ((has_header && (&previous_chunk == first_row_chunk)) ? 1 : 0);
+	}
 	
 	for (int col_index = 0; col_index < ncols; ++col_index)
 	{
@@ -1154,107 +1382,162 @@ static EidosValue_SP Eidos_ExecuteFunction_readCSV(const std::vector<EidosValue_
 		if (coltype == EidosValueType::kValueNULL)
 			EIDOS_TERMINATION << "ERROR (Eidos_ExecuteFunction_readCSV): (internal error) column type was not guessed." << EidosTerminate(nullptr);
 		
-		EidosValue_SP column_values;
+		if (coltype == EidosValueType::kValueLogical)
+			column_values[col_index] = EidosValue_SP((new (gEidosValuePool->AllocateChunk()) EidosValue_Logical())->resize_no_initialize(nrows));
+		else if (coltype == EidosValueType::kValueInt)
+			column_values[col_index] = EidosValue_SP((new (gEidosValuePool->AllocateChunk()) EidosValue_Int())->resize_no_initialize(nrows));
+		else if (coltype == EidosValueType::kValueFloat)
+			column_values[col_index] = EidosValue_SP((new (gEidosValuePool->AllocateChunk()) EidosValue_Float())->resize_no_initialize(nrows));
+		else if (coltype == EidosValueType::kValueString)
+		{
+			EidosValue_String *string_column = new (gEidosValuePool->AllocateChunk()) EidosValue_String();
+			
+			string_column->StringVectorData().resize(nrows);
+			column_values[col_index] = EidosValue_SP(string_column);
+		}
+		else
+			EIDOS_TERMINATION << "ERROR (Eidos_ExecuteFunction_readCSV): (internal error) unrecognized column type." << EidosTerminate(nullptr);
+	}
+	
+	// Convert the elements directly into the column buffers, in parallel across columns and chunks; a conversion error is recorded, and
+	// the first error (by column, then by row) is raised afterwards, as it would have been if the columns were converted in order
+	int64_t task_count = std::max(ncols, 0) * chunk_count;
+	std::vector<std::string> task_errors(task_count);
+	std::vector<EidosValueType> task_error_types(task_count, EidosValueType::kValueVOID);
+	
+#pragma omp parallel for schedule(dynamic, 1) default(none) shared(chunks, chunk_count, chunk_row_starts, task_count, task_errors, task_error_types, column_values, coltypes, ncols, has_header, first_row_chunk, dec) if(task_count >= EIDOS_OMPMIN_FILE_INPUT) num_threads(thread_count)
+	for (int64_t task_index = 0; task_index < task_count; ++task_index)
+	{
+		int col_index = (int)(task_index / chunk_count);
+		const _EidosCSVChunk &chunk = chunks[task_index % chunk_count];
+		EidosValueType coltype = coltypes[col_index];
+		
+		if ((coltype == EidosValueType::kValueVOID) || (chunk.ncols_ == -1))
+			continue;
+		
+		int64_t first_row = ((has_header && (&chunk == first_row_chunk)) ? 1 : 0);
+		int64_t result_index = chunk_row_starts[task_index % chunk_count];
+		const _EidosCSVElement *element = chunk.elements_.data() + first_row * ncols + col_index;
 		
 		if (coltype == EidosValueType::kValueLogical)
 		{
-			EidosValue_Logical *logical_column = (new (gEidosValuePool->AllocateChunk()) EidosValue_Logical())->resize_no_initialize(nrows);
-			column_values = EidosValue_SP(logical_column);
+			eidos_logical_t *logical_data = ((EidosValue_Logical *)column_values[col_index].get())->data_mutable() + result_index;
 			
-			for (int row_index = 0; row_index < nrows; ++row_index)
+			for (int64_t row_index = first_row; row_index < chunk.row_count_; ++row_index, element += ncols)
 			{
-				const std::string &row_value = rows[row_index][col_index];
+				uint8_t element_types = _Eidos_CSVElementTypes(element->data_, element->length_, dec);
 				
-				if ((row_value == "T") || (row_value == "TRUE") || (row_value == "true"))
-					logical_column->set_logical_no_check(true, row_index);
-				else if ((row_value == "F") || (row_value == "FALSE") || (row_value == "false"))
-					logical_column->set_logical_no_check(false, row_index);
-				else
-					EIDOS_TERMINATION << "ERROR (Eidos_ExecuteFunction_readCSV): (internal error) unexpected value '" << row_value << "' in logical column." << EidosTerminate(nullptr);
+				if (!(element_types & EIDOS_CSV_LOGICAL))
+				{
+					task_errors[task_index].assign(element->data_, element->length_);
+					task_error_types[task_index] = EidosValueType::kValueLogical;
+					break;
+				}
+				
+				*(logical_data++) = ((element->data_[0] == 'T') || (element->data_[0] == 't'));
 			}
 		}
 		else if (coltype == EidosValueType::kValueInt)
 		{
-			EidosValue_Int *integer_column = (new (gEidosValuePool->AllocateChunk()) EidosValue_Int())->resize_no_initialize(nrows);
-			column_values = EidosValue_SP(integer_column);
+			int64_t *int_data = ((EidosValue_Int *)column_values[col_index].get())->data_mutable() + result_index;
+			std::string element_string;
 			
-			for (int row_index = 0; row_index < nrows; ++row_index)
+			for (int64_t row_index = first_row; row_index < chunk.row_count_; ++row_index, element += ncols)
 			{
-				const std::string &row_value = rows[row_index][col_index];
-				const char *row_cstr = row_value.c_str();
+				// strtoll() needs a null-terminated string, which elements in the file data are not
+				element_string.assign(element->data_, element->length_);
+				
+				const char *element_cstr = element_string.c_str();
 				char *last_used_char = nullptr;
 				
 				errno = 0;
-				int64_t int_value = strtoll(row_cstr, &last_used_char, 10);
+				int64_t int_value = strtoll(element_cstr, &last_used_char, 10);
 				
-				if (errno || (last_used_char == row_cstr))
-					EIDOS_TERMINATION << "ERROR (Eidos_ExecuteFunction_readCSV): value '" << row_value << "' could not be represented as an integer (strtoll conversion error)." << EidosTerminate(nullptr);
+				if (errno || (last_used_char == element_cstr))
+				{
+					task_errors[task_index] = element_string;
+					task_error_types[task_index] = EidosValueType::kValueInt;
+					break;
+				}
 				
-				integer_column->set_int_no_check(int_value, row_index);
+				*(int_data++) = int_value;
 			}
 		}
 		else if (coltype == EidosValueType::kValueFloat)
 		{
-			EidosValue_Float *float_column = (new (gEidosValuePool->AllocateChunk()) EidosValue_Float())->resize_no_initialize(nrows);
-			column_values = EidosValue_SP(float_column);
+			double *float_data = ((EidosValue_Float *)column_values[col_index].get())->data_mutable() + result_index;
+			std::string element_string;
 			
-			for (int row_index = 0; row_index < nrows; ++row_index)
+			for (int64_t row_index = first_row; row_index < chunk.row_count_; ++row_index, element += ncols)
 			{
-				std::string &row_value = rows[row_index][col_index];	// non-const here so we can fix the decimal separator
+				element_string.assign(element->data_, element->length_);
+				
 				double float_value;
 				
-				if (Eidos_string_equalsCaseInsensitive(row_value, "NAN"))
+				if (Eidos_string_equalsCaseInsensitive(element_string, "NAN"))
 					float_value = std::numeric_limits<double>::quiet_NaN();
-				else if (Eidos_string_equalsCaseInsensitive(row_value, "INF") ||
-					Eidos_string_equalsCaseInsensitive(row_value, "INFINITY") ||
-					Eidos_string_equalsCaseInsensitive(row_value, "+INF") ||
-					Eidos_string_equalsCaseInsensitive(row_value, "+INFINITY"))
+				else if (Eidos_string_equalsCaseInsensitive(element_string, "INF") ||
+					Eidos_string_equalsCaseInsensitive(element_string, "INFINITY") ||
+					Eidos_string_equalsCaseInsensitive(element_string, "+INF") ||
+					Eidos_string_equalsCaseInsensitive(element_string, "+INFINITY"))
 					float_value = std::numeric_limits<double>::infinity();
-				else if (Eidos_string_equalsCaseInsensitive(row_value, "-INF") ||
-					Eidos_string_equalsCaseInsensitive(row_value, "-INFINITY"))
+				else if (Eidos_string_equalsCaseInsensitive(element_string, "-INF") ||
+					Eidos_string_equalsCaseInsensitive(element_string, "-INFINITY"))
 					float_value = -std::numeric_limits<double>::infinity();
 				else
 				{
 					if (dec != '.')
 					{
 						// We are in the C locale, so strtod() expects a '.' decimal separator.
-						size_t dec_pos = row_value.find(dec);
+						size_t dec_pos = element_string.find(dec);
 						
 						if (dec_pos != std::string::npos)
-							row_value.replace(dec_pos, 1, 1, '.');
+							element_string.replace(dec_pos, 1, 1, '.');
 					}
 					
-					const char *row_cstr = row_value.c_str();
+					const char *element_cstr = element_string.c_str();
 					char *last_used_char = nullptr;
 					
 					errno = 0;
-					float_value = strtod(row_cstr, &last_used_char);
+					float_value = strtod(element_cstr, &last_used_char);
 					
-					if (errno || (last_used_char == row_cstr))
-						EIDOS_TERMINATION << "ERROR (Eidos_ExecuteFunction_readCSV): value '" << row_value << "' could not be represented as a float (strtod conversion error)." << EidosTerminate(nullptr);
+					if (errno || (last_used_char == element_cstr))
+					{
+						task_errors[task_index] = element_string;
+						task_error_types[task_index] = EidosValueType::kValueFloat;
+						break;
+					}
 				}
 				
-				float_column->set_float_no_check(float_value, row_index);
+				*(float_data++) = float_value;
 			}
 		}
 		else if (coltype == EidosValueType::kValueString)
 		{
-			EidosValue_String *string_column = (new (gEidosValuePool->AllocateChunk()) EidosValue_String())->Reserve(nrows);
-			column_values = EidosValue_SP(string_column);
+			std::string *string_data = ((EidosValue_String *)column_values[col_index].get())->StringVectorData().data() + result_index;
 			
-			for (int row_index = 0; row_index < nrows; ++row_index)
-			{
-				const std::string &row_value = rows[row_index][col_index];
-				
-				string_column->PushString(row_value);
-			}
+			for (int64_t row_index = first_row; row_index < chunk.row_count_; ++row_index, element += ncols)
+				(string_data++)->assign(element->data_, element->length_);
 		}
-		else
-			EIDOS_TERMINATION << "ERROR (Eidos_ExecuteFunction_readCSV): (internal error) unrecognized column type." << EidosTerminate(nullptr);
+	}
+	
+	for (int64_t task_index = 0; task_index < task_count; ++task_index)
+	{
+		EidosValueType error_type = task_error_types[task_index];
 		
-		objectElement->SetKeyValue_StringKeys(columnNames[col_index], column_values);
+		if (error_type == EidosValueType::kValueLogical)
+			EIDOS_TERMINATION << "ERROR (Eidos_ExecuteFunction_readCSV): (internal error) unexpected value '" << task_errors[task_index] << "' in logical column." << EidosTerminate(nullptr);
+		else if (error_type == EidosValueType::kValueInt)
+			EIDOS_TERMINATION << "ERROR (Eidos_ExecuteFunction_readCSV): value '" << task_errors[task_index] << "' could not be represented as an integer (strtoll conversion error)." << EidosTerminate(nullptr);
+		else if (error_type == EidosValueType::kValueFloat)
+			EIDOS_TERMINATION << "ERROR (Eidos_ExecuteFunction_readCSV): value '" << task_errors[task_index] << "' could not be represented as a float (strtod conversion error)." << EidosTerminate(nullptr);
 	}
 	
+	// Put the columns into the DataFrame
+	for (int col_index = 0; col_index < ncols; ++col_index)
+		if (column_values[col_index])
+			objectElement->SetKeyValue_StringKeys(columnNames[col_index], column_values[col_index]);
+	
 	objectElement->ContentsChanged("readCSV()");
 	
 	return result_SP;
@@ -957,6 +957,42 @@ EidosValue_SP UniqueEidosValue(const EidosValue *p_x_value, bool p_preserve_orde
 	return result_SP;
 }
 
+// A long, contiguous, ascending run of integer indices into an integer or float vector selects a slice that can share the
+// original's buffer, copy-on-write, instead of copying it, if it covers at least half of that buffer; see EidosValueBufferShare.
+// Returns nullptr in other cases.
+static EidosValue_SP _SharedSliceForContiguousIndices(const EidosValue *p_original_value, const int64_t *p_int_index_data, int p_indices_count, int p_original_value_count)
+{
+	if (p_indices_count <= EIDOS_VALUE_BUFFER_MAX_POOLED)
+		return EidosValue_SP(nullptr);
+	
+	EidosValueType original_value_type = p_original_value->Type();
+	int64_t first_index = p_int_index_data[0];
+	
+	if ((first_index < 0) || (first_index + p_indices_count > p_original_value_count))
+		return EidosValue_SP(nullptr);
+	
+	for (int value_idx = 1; value_idx < p_indices_count; value_idx++)
+		if (p_int_index_data[value_idx] != first_index + value_idx)
+			return EidosValue_SP(nullptr);
+	
+	if (original_value_type == EidosValueType::kValueInt)
+	{
+		const EidosValue_Int *int_value = (const EidosValue_Int *)p_original_value;
+		
+		if (int_value->CanShareSlice((size_t)p_indices_count))
+			return int_value->SharedSlice((size_t)first_index, (size_t)p_indices_count);
+	}
+	else if (original_value_type == EidosValueType::kValueFloat)
+	{
+		const EidosValue_Float *float_value = (const EidosValue_Float *)p_original_value;
+		
+		if (float_value->CanShareSlice((size_t)p_indices_count))
+			return float_value->SharedSlice((size_t)first_index, (size_t)p_indices_count);
+	}
+	
+	return EidosValue_SP(nullptr);
+}
+
 EidosValue_SP SubsetEidosValue(const EidosValue *p_original_value, const EidosValue *p_indices, EidosToken *p_error_token, bool p_raise_range_errors)
 {
 	// We have a simple vector-style subset that is not NULL; handle it as we did in Eidos 1.5 and earlier
@@ -1054,6 +1090,14 @@ EidosValue_SP SubsetEidosValue(const EidosValue *p_original_value, const EidosVa
 		// Subsetting with a int vector can use a vector of any length; the specific indices referenced will be taken
 		const int64_t *int_index_data = p_indices->IntData();
 		
+		if ((original_value_type == EidosValueType::kValueFloat) || (original_value_type == EidosValueType::kValueInt))
+		{
+			result_SP = _SharedSliceForContiguousIndices(p_original_value, int_index_data, indices_count, original_value_count);
+			
+			if (result_SP)
+				return result_SP;
+		}
+		
 		if (original_value_type == EidosValueType::kValueFloat)
 		{
 			// result type is float; optimize for that
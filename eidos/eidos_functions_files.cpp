@@ -29,8 +29,6 @@
 #include <fstream>
 #include <sys/stat.h>
 
-#include "../eidos_zlib/zlib.h"
-
 
 // ************************************************************************************
 //
@@ -182,10 +180,13 @@ EidosValue_SP Eidos_ExecuteFunction_readFile(const std::vector<EidosValue_SP> &p
 	std::string base_path = filePath_value->StringAtIndex_NOCAST(0, nullptr);
 	std::string file_path = Eidos_ResolvedPath(base_path);
 	
-	// read the contents in
-	std::ifstream file_stream(file_path.c_str());
+	// read the contents in; the file is mapped into memory (and decompressed, if it is gzip data) and split into lines in parallel
+	Eidos_MappedFile mapped_file(file_path);
+	std::vector<char> file_buffer;
+	const char *file_data;
+	size_t file_size;
 	
-	if (!file_stream.is_open())
+	if (!Eidos_GetFileContents(file_path, mapped_file, file_buffer, &file_data, &file_size))
 	{
 		if (!gEidosSuppressWarnings)
 			p_interpreter.ErrorOutputStream() << "#WARNING (Eidos_ExecuteFunction_readFile): function readFile() could not read file at path " << file_path << "." << std::endl;
@@ -196,16 +197,51 @@ EidosValue_SP Eidos_ExecuteFunction_readFile(const std::vector<EidosValue_SP> &p
 		EidosValue_String *string_result = new (gEidosValuePool->AllocateChunk()) EidosValue_String();
 		result_SP = EidosValue_SP(string_result);
 		
-		std::string line;
+		// count the lines in each chunk, as getline() would see them: a final line need not end in a newline
+		std::vector<std::pair<const char *, const char *>> chunks = Eidos_LineAlignedChunks(file_data, file_size, 1024 * 1024);
+		int64_t chunk_count = (int64_t)chunks.size();
+		std::vector<size_t> chunk_line_starts(chunk_count + 1, 0);
 		
-		while (getline(file_stream, line))
-			string_result->PushString(line);
+		EIDOS_THREAD_COUNT(gEidos_OMP_threads_FILE_INPUT);
+#pragma omp parallel for schedule(dynamic, 1) default(none) shared(chunks, chunk_count, chunk_line_starts) if(chunk_count >= EIDOS_OMPMIN_FILE_INPUT) num_threads(thread_count)
+		for (int64_t chunk_index = 0; chunk_index < chunk_count; ++chunk_index)
+		{
+			const char *chunk_start = chunks[chunk_index].first, *chunk_end = chunks[chunk_index].second;
+			size_t line_count = 0;
+			
+			while (chunk_start < chunk_end)
+			{
+				const char *newline = (const char *)memchr(chunk_start, '\n', chunk_end - chunk_start);
+				
+				line_count++;
+				chunk_start = (newline ? newline + 1 : chunk_end);
+			}
+			
+			chunk_line_starts[chunk_index + 1] = line_count;
+		}
 		
-		if (file_stream.bad())
+		for (int64_t chunk_index = 0; chunk_index < chunk_count; ++chunk_index)
+			chunk_line_starts[chunk_index + 1] += chunk_line_starts[chunk_index];
+		
+		// then make the line strings directly in the result vector
+		std::vector<std::string> &lines = string_result->StringVectorData();
+		
+		lines.resize(chunk_line_starts[chunk_count]);
+		
+#pragma omp parallel for schedule(dynamic, 1) default(none) shared(chunks, chunk_count, chunk_line_starts, lines) if(chunk_count >= EIDOS_OMPMIN_FILE_INPUT) num_threads(thread_count)
+		for (int64_t chunk_index = 0; chunk_index < chunk_count; ++chunk_index)
 		{
-			if (!gEidosSuppressWarnings)
-				p_interpreter.ErrorOutputStream() << "#WARNING (Eidos_ExecuteFunction_readFile): function readFile() encountered stream errors while reading file at path " << file_path << "." << std::endl;
-			result_SP = gStaticEidosValueNULL;
+			const char *chunk_start = chunks[chunk_index].first, *chunk_end = chunks[chunk_index].second;
+			size_t line_index = chunk_line_starts[chunk_index];
+			
+			while (chunk_start < chunk_end)
+			{
+				const char *newline = (const char *)memchr(chunk_start, '\n', chunk_end - chunk_start);
+				const char *line_end = (newline ? newline : chunk_end);
+				
+				lines[line_index++].assign(chunk_start, line_end - chunk_start);
+				chunk_start = (newline ? newline + 1 : chunk_end);
+			}
 		}
 	}
 	
@@ -384,62 +420,49 @@ EidosValue_SP Eidos_ExecuteFunction_writeTempFile(const std::vector<EidosValue_S
 	
 	if (do_compress)
 	{
-		// compression using zlib; very different from the no-compression case, unfortunately, because here we use C-based APIs
-		gzFile gzf = gzdopen(fd, "wb");
+		// compression using zlib, writing BGZF with Eidos_WriteBGZFData() so that large outputs are compressed in parallel
+		std::string file_path(file_path_cstr);
+		std::ofstream file_stream(file_path.c_str(), std::ios_base::out | std::ios_base::binary);
+		close(fd);	// opened by Eidos_mkstemps()
 		
-		if (!gzf)
+		if (!file_stream.is_open())
 		{
 			if (!gEidosSuppressWarnings)
-				p_interpreter.ErrorOutputStream() << "#WARNING (Eidos_ExecuteFunction_writeTempFile): function writeTempFile() could not write to file at path " << file_path_cstr << "." << std::endl;
+				p_interpreter.ErrorOutputStream() << "#WARNING (Eidos_ExecuteFunction_writeTempFile): function writeTempFile() could not write to file at path " << file_path << "." << std::endl;
 			result_SP = gStaticEidosValue_StringEmpty;
 		}
 		else
 		{
-			std::ostringstream outstream;
+			std::string outstring;
 			
 			if (contents_count == 1)
 			{
 				// no final newline in this case, so the user can precisely specify the file contents if desired
-				outstream << contents_value->StringAtIndex_NOCAST(0, nullptr);
+				outstring = contents_value->StringAtIndex_NOCAST(0, nullptr);
 			}
 			else
 			{
 				const std::string *string_vec = contents_value->StringData();
 				
 				for (int value_index = 0; value_index < contents_count; ++value_index)
-					outstream << string_vec[value_index] << std::endl;
-			}
-			
-			std::string outstring = outstream.str();
-			const char *outcstr = outstring.c_str();
-			size_t outcstr_length = strlen(outcstr);
-			
-			// do the writing with zlib
-			bool failed = true;
-			int retval = gzbuffer(gzf, 128*1024L);	// bigger buffer for greater speed
-			
-			if (retval != -1)
-			{
-				retval = gzwrite(gzf, outcstr, (unsigned)outcstr_length);
-				
-				if ((retval != 0) || (outcstr_length == 0))	// writing 0 bytes returns 0, which is supposed to be an error code
 				{
-					retval = gzclose_w(gzf);
-					
-					if (retval == Z_OK)
-						failed = false;
+					outstring.append(string_vec[value_index]);
+					outstring.append(1, '\n');
 				}
 			}
 			
-			if (failed)
+			bool failed = !Eidos_WriteBGZFData(file_stream, outstring.data(), outstring.length());
+			
+			file_stream.close();
+			
+			if (failed || file_stream.fail())
 			{
 				if (!gEidosSuppressWarnings)
-					p_interpreter.ErrorOutputStream() << "#WARNING (Eidos_ExecuteFunction_writeTempFile): function writeTempFile() encountered zlib errors while writing to file at path " << file_path_cstr << "." << std::endl;
+					p_interpreter.ErrorOutputStream() << "#WARNING (Eidos_ExecuteFunction_writeTempFile): function writeTempFile() encountered zlib errors while writing to file at path " << file_path << "." << std::endl;
 				result_SP = gStaticEidosValue_StringEmpty;
 			}
 			else
 			{
-				std::string file_path(file_path_cstr);
 				result_SP = EidosValue_SP(new (gEidosValuePool->AllocateChunk()) EidosValue_String(file_path));
 			}
 		}
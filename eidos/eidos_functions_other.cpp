@@ -818,6 +818,7 @@ EidosValue_SP Eidos_ExecuteFunction_parallelGetTaskThreadCounts(__attribute__((u
 	objectElement->SetKeyValue_StringKeys("SUM_FLOAT", EidosValue_SP(new (gEidosValuePool->AllocateChunk()) EidosValue_Int(gEidos_OMP_threads_SUM_FLOAT)));
 	objectElement->SetKeyValue_StringKeys("SUM_LOGICAL", EidosValue_SP(new (gEidosValuePool->AllocateChunk()) EidosValue_Int(gEidos_OMP_threads_SUM_LOGICAL)));
 	objectElement->SetKeyValue_StringKeys("TRUNC", EidosValue_SP(new (gEidosValuePool->AllocateChunk()) EidosValue_Int(gEidos_OMP_threads_TRUNC)));
+	objectElement->SetKeyValue_StringKeys("FUSED_ARITH", EidosValue_SP(new (gEidosValuePool->AllocateChunk()) EidosValue_Int(gEidos_OMP_threads_FUSED_ARITH)));
 	
 	objectElement->SetKeyValue_StringKeys("MAX_INT", EidosValue_SP(new (gEidosValuePool->AllocateChunk()) EidosValue_Int(gEidos_OMP_threads_MAX_INT)));
 	objectElement->SetKeyValue_StringKeys("MAX_FLOAT", EidosValue_SP(new (gEidosValuePool->AllocateChunk()) EidosValue_Int(gEidos_OMP_threads_MAX_FLOAT)));
@@ -930,6 +931,13 @@ EidosValue_SP Eidos_ExecuteFunction_parallelGetTaskThreadCounts(__attribute__((u
 	objectElement->SetKeyValue_StringKeys("PARENTS_CLEAR", EidosValue_SP(new (gEidosValuePool->AllocateChunk()) EidosValue_Int(gEidos_OMP_threads_PARENTS_CLEAR)));
 	objectElement->SetKeyValue_StringKeys("UNIQUE_MUTRUNS", EidosValue_SP(new (gEidosValuePool->AllocateChunk()) EidosValue_Int(gEidos_OMP_threads_UNIQUE_MUTRUNS)));
 	objectElement->SetKeyValue_StringKeys("SURVIVAL", EidosValue_SP(new (gEidosValuePool->AllocateChunk()) EidosValue_Int(gEidos_OMP_threads_SURVIVAL)));
+	objectElement->SetKeyValue_StringKeys("TS_OVERLAY", EidosValue_SP(new (gEidosValuePool->AllocateChunk()) EidosValue_Int(gEidos_OMP_threads_TS_OVERLAY)));
+	objectElement->SetKeyValue_StringKeys("VCF_OUTPUT", EidosValue_SP(new (gEidosValuePool->AllocateChunk()) EidosValue_Int(gEidos_OMP_threads_VCF_OUTPUT)));
+	objectElement->SetKeyValue_StringKeys("BGZF_COMPRESS", EidosValue_SP(new (gEidosValuePool->AllocateChunk()) EidosValue_Int(gEidos_OMP_threads_BGZF_COMPRESS)));
+	objectElement->SetKeyValue_StringKeys("BGZF_DECOMPRESS", EidosValue_SP(new (gEidosValuePool->AllocateChunk()) EidosValue_Int(gEidos_OMP_threads_BGZF_DECOMPRESS)));
+	objectElement->SetKeyValue_StringKeys("VCF_INPUT", EidosValue_SP(new (gEidosValuePool->AllocateChunk()) EidosValue_Int(gEidos_OMP_threads_VCF_INPUT)));
+	objectElement->SetKeyValue_StringKeys("FILE_INPUT", EidosValue_SP(new (gEidosValuePool->AllocateChunk()) EidosValue_Int(gEidos_OMP_threads_FILE_INPUT)));
+	objectElement->SetKeyValue_StringKeys("HAPLOTYPE_MATRIX", EidosValue_SP(new (gEidosValuePool->AllocateChunk()) EidosValue_Int(gEidos_OMP_threads_HAPLOTYPE_MATRIX)));
 #endif
 	
 	objectElement->ContentsChanged("parallelGetTaskThreadCounts()");
@@ -1026,6 +1034,7 @@ EidosValue_SP Eidos_ExecuteFunction_parallelSetTaskThreadCounts(__attribute__((u
 						else if (key == "SUM_FLOAT")					gEidos_OMP_threads_SUM_FLOAT = (int)value_int64;
 						else if (key == "SUM_LOGICAL")					gEidos_OMP_threads_SUM_LOGICAL = (int)value_int64;
 						else if (key == "TRUNC")						gEidos_OMP_threads_TRUNC = (int)value_int64;
+						else if (key == "FUSED_ARITH")					gEidos_OMP_threads_FUSED_ARITH = (int)value_int64;
 						
 						else if (key == "MAX_INT")						gEidos_OMP_threads_MAX_INT = (int)value_int64;
 						else if (key == "MAX_FLOAT")					gEidos_OMP_threads_MAX_FLOAT = (int)value_int64;
@@ -1138,6 +1147,13 @@ EidosValue_SP Eidos_ExecuteFunction_parallelSetTaskThreadCounts(__attribute__((u
 						else if (key == "PARENTS_CLEAR")				gEidos_OMP_threads_PARENTS_CLEAR = (int)value_int64;
 						else if (key == "UNIQUE_MUTRUNS")				gEidos_OMP_threads_UNIQUE_MUTRUNS = (int)value_int64;
 						else if (key == "SURVIVAL")						gEidos_OMP_threads_SURVIVAL = (int)value_int64;
+						else if (key == "TS_OVERLAY")					gEidos_OMP_threads_TS_OVERLAY = (int)value_int64;
+						else if (key == "VCF_OUTPUT")					gEidos_OMP_threads_VCF_OUTPUT = (int)value_int64;
+						else if (key == "BGZF_COMPRESS")				gEidos_OMP_threads_BGZF_COMPRESS = (int)value_int64;
+						else if (key == "BGZF_DECOMPRESS")				gEidos_OMP_threads_BGZF_DECOMPRESS = (int)value_int64;
+						else if (key == "VCF_INPUT")					gEidos_OMP_threads_VCF_INPUT = (int)value_int64;
+						else if (key == "FILE_INPUT")					gEidos_OMP_threads_FILE_INPUT = (int)value_int64;
+						else if (key == "HAPLOTYPE_MATRIX")				gEidos_OMP_threads_HAPLOTYPE_MATRIX = (int)value_int64;
 						else
 							EIDOS_TERMINATION << "ERROR (Eidos_ExecuteFunction_parallelSetTaskThreadCounts): parallelSetTaskThreadCounts() does not recognize the task name " << key << "." << EidosTerminate(nullptr);
 						
@@ -59,13 +59,23 @@
 // added for Eidos_mkstemps() and Eidos_TemporaryDirectoryExists()
 #include <sys/stat.h>
 #include <fstream>
+#include <iterator>
 #include <fcntl.h>
 #include <errno.h>
 #include <stdio.h>
 #ifdef _WIN32
 #include <fileapi.h>
+#else
+#include <sys/mman.h>	// for Eidos_MappedFile
 #endif
 
+// for the background writer used by Eidos_WriteToFile() and Eidos_FlushFiles()
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <deque>
+#include <unordered_set>
+
 // for Eidos_WelchTTest()
 #include "gsl_cdf.h"
 
@@ -75,6 +85,9 @@
 // for _Eidos_FlushZipBuffer()
 #include "../eidos_zlib/zlib.h"
 
+// for Eidos_DecompressGzipData()
+#include "lodepng.h"
+
 // for Eidos_ColorPaletteLookup()
 #include "eidos_tinycolormap.h"
 
@@ -244,6 +257,7 @@ int gEidos_OMP_threads_SUM_INTEGER = EIDOS_OMP_MAX_THREADS;
 int gEidos_OMP_threads_SUM_FLOAT = EIDOS_OMP_MAX_THREADS;
 int gEidos_OMP_threads_SUM_LOGICAL = EIDOS_OMP_MAX_THREADS;
 int gEidos_OMP_threads_TRUNC = EIDOS_OMP_MAX_THREADS;
+int gEidos_OMP_threads_FUSED_ARITH = EIDOS_OMP_MAX_THREADS;
 
 int gEidos_OMP_threads_MAX_INT = EIDOS_OMP_MAX_THREADS;
 int gEidos_OMP_threads_MAX_FLOAT = EIDOS_OMP_MAX_THREADS;
@@ -356,6 +370,13 @@ int gEidos_OMP_threads_SIMPLIFY_SORT_POST = EIDOS_OMP_MAX_THREADS;
 int gEidos_OMP_threads_PARENTS_CLEAR = EIDOS_OMP_MAX_THREADS;
 int gEidos_OMP_threads_UNIQUE_MUTRUNS = EIDOS_OMP_MAX_THREADS;
 int gEidos_OMP_threads_SURVIVAL = EIDOS_OMP_MAX_THREADS;
+int gEidos_OMP_threads_TS_OVERLAY = EIDOS_OMP_MAX_THREADS;
+int gEidos_OMP_threads_VCF_OUTPUT = EIDOS_OMP_MAX_THREADS;
+int gEidos_OMP_threads_BGZF_COMPRESS = EIDOS_OMP_MAX_THREADS;
+int gEidos_OMP_threads_BGZF_DECOMPRESS = EIDOS_OMP_MAX_THREADS;
+int gEidos_OMP_threads_VCF_INPUT = EIDOS_OMP_MAX_THREADS;
+int gEidos_OMP_threads_FILE_INPUT = EIDOS_OMP_MAX_THREADS;
+int gEidos_OMP_threads_HAPLOTYPE_MATRIX = EIDOS_OMP_MAX_THREADS;
 
 EidosPerTaskThreadCounts gEidosDefaultPerTaskThreadCounts = EidosPerTaskThreadCounts::kDefault;
 std::string gEidosPerTaskThreadCountsSetName = "DEFAULT";	// should get overwritten
@@ -400,6 +421,7 @@ void _Eidos_SetOpenMPThreadCounts(EidosPerTaskThreadCounts per_task_thread_count
 		gEidos_OMP_threads_SUM_FLOAT = EIDOS_OMP_MAX_THREADS;
 		gEidos_OMP_threads_SUM_LOGICAL = EIDOS_OMP_MAX_THREADS;
 		gEidos_OMP_threads_TRUNC = EIDOS_OMP_MAX_THREADS;
+		gEidos_OMP_threads_FUSED_ARITH = EIDOS_OMP_MAX_THREADS;
 		
 		gEidos_OMP_threads_MAX_INT = EIDOS_OMP_MAX_THREADS;
 		gEidos_OMP_threads_MAX_FLOAT = EIDOS_OMP_MAX_THREADS;
@@ -512,6 +534,13 @@ void _Eidos_SetOpenMPThreadCounts(EidosPerTaskThreadCounts per_task_thread_count
 		gEidos_OMP_threads_PARENTS_CLEAR = EIDOS_OMP_MAX_THREADS;
 		gEidos_OMP_threads_UNIQUE_MUTRUNS = EIDOS_OMP_MAX_THREADS;
 		gEidos_OMP_threads_SURVIVAL = EIDOS_OMP_MAX_THREADS;
+		gEidos_OMP_threads_TS_OVERLAY = EIDOS_OMP_MAX_THREADS;
+		gEidos_OMP_threads_VCF_OUTPUT = EIDOS_OMP_MAX_THREADS;
+		gEidos_OMP_threads_BGZF_COMPRESS = EIDOS_OMP_MAX_THREADS;
+		gEidos_OMP_threads_BGZF_DECOMPRESS = EIDOS_OMP_MAX_THREADS;
+		gEidos_OMP_threads_VCF_INPUT = EIDOS_OMP_MAX_THREADS;
+		gEidos_OMP_threads_FILE_INPUT = EIDOS_OMP_MAX_THREADS;
+		gEidos_OMP_threads_HAPLOTYPE_MATRIX = EIDOS_OMP_MAX_THREADS;
 	}
 	else if (per_task_thread_counts == EidosPerTaskThreadCounts::kMacStudio2022_16)
 	{
@@ -537,6 +566,7 @@ void _Eidos_SetOpenMPThreadCounts(EidosPerTaskThreadCounts per_task_thread_count
 		gEidos_OMP_threads_SUM_FLOAT = 8;
 		gEidos_OMP_threads_SUM_LOGICAL = 8;
 		gEidos_OMP_threads_TRUNC = 8;
+		gEidos_OMP_threads_FUSED_ARITH = 16;
 		
 		gEidos_OMP_threads_MAX_INT = 8;
 		gEidos_OMP_threads_MAX_FLOAT = 16;
@@ -649,6 +679,13 @@ void _Eidos_SetOpenMPThreadCounts(EidosPerTaskThreadCounts per_task_thread_count
 		gEidos_OMP_threads_PARENTS_CLEAR = 16;
 		gEidos_OMP_threads_UNIQUE_MUTRUNS = 16;
 		gEidos_OMP_threads_SURVIVAL = 16;
+		gEidos_OMP_threads_TS_OVERLAY = 16;
+		gEidos_OMP_threads_VCF_OUTPUT = 16;
+		gEidos_OMP_threads_BGZF_COMPRESS = 16;
+		gEidos_OMP_threads_BGZF_DECOMPRESS = 16;
+		gEidos_OMP_threads_VCF_INPUT = 16;
+		gEidos_OMP_threads_FILE_INPUT = 16;
+		gEidos_OMP_threads_HAPLOTYPE_MATRIX = 16;
 	}
 	else if (per_task_thread_counts == EidosPerTaskThreadCounts::kXeonGold2_40)
 	{
@@ -676,6 +713,7 @@ void _Eidos_SetOpenMPThreadCounts(EidosPerTaskThreadCounts per_task_thread_count
 		gEidos_OMP_threads_SUM_FLOAT = 40;
 		gEidos_OMP_threads_SUM_LOGICAL = 40;
 		gEidos_OMP_threads_TRUNC = 40;
+		gEidos_OMP_threads_FUSED_ARITH = 40;
 		
 		gEidos_OMP_threads_MAX_INT = 40;
 		gEidos_OMP_threads_MAX_FLOAT = 40;
@@ -788,6 +826,13 @@ void _Eidos_SetOpenMPThreadCounts(EidosPerTaskThreadCounts per_task_thread_count
 		gEidos_OMP_threads_PARENTS_CLEAR = 40;
 		gEidos_OMP_threads_UNIQUE_MUTRUNS = 40;
 		gEidos_OMP_threads_SURVIVAL = 40;
+		gEidos_OMP_threads_TS_OVERLAY = 40;
+		gEidos_OMP_threads_VCF_OUTPUT = 40;
+		gEidos_OMP_threads_BGZF_COMPRESS = 40;
+		gEidos_OMP_threads_BGZF_DECOMPRESS = 40;
+		gEidos_OMP_threads_VCF_INPUT = 40;
+		gEidos_OMP_threads_FILE_INPUT = 40;
+		gEidos_OMP_threads_HAPLOTYPE_MATRIX = 40;
 	}
 	else
 	{
@@ -840,6 +885,7 @@ void _Eidos_ClipOpenMPThreadCounts(void)
 	gEidos_OMP_threads_SUM_FLOAT = std::min(gEidosMaxThreads, gEidos_OMP_threads_SUM_FLOAT);
 	gEidos_OMP_threads_SUM_LOGICAL = std::min(gEidosMaxThreads, gEidos_OMP_threads_SUM_LOGICAL);
 	gEidos_OMP_threads_TRUNC = std::min(gEidosMaxThreads, gEidos_OMP_threads_TRUNC);
+	gEidos_OMP_threads_FUSED_ARITH = std::min(gEidosMaxThreads, gEidos_OMP_threads_FUSED_ARITH);
 
 	gEidos_OMP_threads_MAX_INT = std::min(gEidosMaxThreads, gEidos_OMP_threads_MAX_INT);
 	gEidos_OMP_threads_MAX_FLOAT = std::min(gEidosMaxThreads, gEidos_OMP_threads_MAX_FLOAT);
@@ -952,6 +998,13 @@ void _Eidos_ClipOpenMPThreadCounts(void)
 	gEidos_OMP_threads_PARENTS_CLEAR = std::min(gEidosMaxThreads, gEidos_OMP_threads_PARENTS_CLEAR);
 	gEidos_OMP_threads_UNIQUE_MUTRUNS = std::min(gEidosMaxThreads, gEidos_OMP_threads_UNIQUE_MUTRUNS);
 	gEidos_OMP_threads_SURVIVAL = std::min(gEidosMaxThreads, gEidos_OMP_threads_SURVIVAL);
+	gEidos_OMP_threads_TS_OVERLAY = std::min(gEidosMaxThreads, gEidos_OMP_threads_TS_OVERLAY);
+	gEidos_OMP_threads_VCF_OUTPUT = std::min(gEidosMaxThreads, gEidos_OMP_threads_VCF_OUTPUT);
+	gEidos_OMP_threads_BGZF_COMPRESS = std::min(gEidosMaxThreads, gEidos_OMP_threads_BGZF_COMPRESS);
+	gEidos_OMP_threads_BGZF_DECOMPRESS = std::min(gEidosMaxThreads, gEidos_OMP_threads_BGZF_DECOMPRESS);
+	gEidos_OMP_threads_VCF_INPUT = std::min(gEidosMaxThreads, gEidos_OMP_threads_VCF_INPUT);
+	gEidos_OMP_threads_FILE_INPUT = std::min(gEidosMaxThreads, gEidos_OMP_threads_FILE_INPUT);
+	gEidos_OMP_threads_HAPLOTYPE_MATRIX = std::min(gEidosMaxThreads, gEidos_OMP_threads_HAPLOTYPE_MATRIX);
 }
 
 void Eidos_WarmUpOpenMP(std::ostream *outstream, bool changed_max_thread_count, int new_max_thread_count, bool active_threads, std::string thread_count_set_name)
@@ -2484,6 +2537,484 @@ bool Eidos_TemporaryDirectoryExists(void)
 	return exists;
 }
 
+Eidos_MappedFile::Eidos_MappedFile(const std::string &p_file_path)
+{
+	int open_flags = O_RDONLY;
+#ifdef O_BINARY
+	open_flags |= O_BINARY;		// on Windows, avoid newline translation
+#endif
+	int fd = open(p_file_path.c_str(), open_flags);
+	
+	if (fd == -1)
+		return;
+	
+	struct stat file_info;
+	
+	if ((fstat(fd, &file_info) != 0) || !S_ISREG(file_info.st_mode))
+	{
+		close(fd);
+		return;
+	}
+	
+	size_ = (size_t)file_info.st_size;
+	
+	if (size_ == 0)
+	{
+		// mmap() refuses zero-length mappings, and there is nothing to read anyway
+		close(fd);
+		is_open_ = true;
+		return;
+	}
+	
+#ifndef _WIN32
+	void *mapping = mmap(nullptr, size_, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+	
+	if (mapping != MAP_FAILED)
+	{
+		// our clients parse front to back, so encourage aggressive readahead
+		madvise(mapping, size_, MADV_SEQUENTIAL);
+		
+		data_ = static_cast<char *>(mapping);
+		is_mapped_ = true;
+		is_open_ = true;
+		close(fd);		// the mapping remains valid after the descriptor is closed
+		return;
+	}
+#endif
+	
+	// fall back to reading the whole file into a buffer
+	data_ = static_cast<char *>(malloc(size_));
+	
+	if (data_)
+	{
+		size_t total_read = 0;
+		
+		while (total_read < size_)
+		{
+			ssize_t read_count = read(fd, data_ + total_read, size_ - total_read);
+			
+			if (read_count <= 0)
+				break;
+			
+			total_read += (size_t)read_count;
+		}
+		
+		if (total_read == size_)
+		{
+			is_open_ = true;
+		}
+		else
+		{
+			free(data_);
+			data_ = nullptr;
+		}
+	}
+	
+	close(fd);
+}
+
+Eidos_MappedFile::~Eidos_MappedFile(void)
+{
+	if (data_)
+	{
+#ifndef _WIN32
+		if (is_mapped_)
+			munmap(data_, size_);
+		else
+#endif
+			free(data_);
+		
+		data_ = nullptr;
+	}
+}
+
+bool Eidos_GetFileContents(const std::string &p_file_path, Eidos_MappedFile &p_mapped_file, std::vector<char> &p_buffer, const char **p_data, size_t *p_size)
+{
+	const char *data;
+	size_t size;
+	
+	if (p_mapped_file.IsOpen())
+	{
+		data = p_mapped_file.Data();
+		size = p_mapped_file.Size();
+	}
+	else
+	{
+		std::ifstream file_stream(p_file_path.c_str(), std::ios_base::in | std::ios_base::binary);
+		
+		if (!file_stream.is_open())
+			return false;
+		
+		p_buffer.assign(std::istreambuf_iterator<char>(file_stream), std::istreambuf_iterator<char>());
+		
+		if (file_stream.bad())
+			return false;
+		
+		data = p_buffer.data();
+		size = p_buffer.size();
+	}
+	
+	if (Eidos_IsGzipData(data, size))
+	{
+		std::vector<char> decompressed_data;
+		
+		if (!Eidos_DecompressGzipData(data, size, decompressed_data))
+			return false;
+		
+		p_buffer.swap(decompressed_data);
+		data = p_buffer.data();
+		size = p_buffer.size();
+	}
+	
+	*p_data = data;
+	*p_size = size;
+	return true;
+}
+
+std::vector<std::pair<const char *, const char *>> Eidos_LineAlignedChunks(const char *p_data, size_t p_size, size_t p_chunk_size)
+{
+	std::vector<std::pair<const char *, const char *>> chunks;
+	const char *chunk_start = p_data;
+	const char *data_end = p_data + p_size;
+	
+	while (chunk_start < data_end)
+	{
+		const char *chunk_end = data_end;
+		
+		if ((size_t)(data_end - chunk_start) > p_chunk_size)
+		{
+			const char *newline = (const char *)memchr(chunk_start + p_chunk_size, '\n', data_end - (chunk_start + p_chunk_size));
+			
+			if (newline)
+				chunk_end = newline + 1;
+		}
+		
+		chunks.emplace_back(chunk_start, chunk_end);
+		chunk_start = chunk_end;
+	}
+	
+	return chunks;
+}
+
+// The BGZF format is described in the SAM/BAM specification (https://samtools.github.io/hts-specs/SAMv1.pdf), section 4.1.
+// Each block is a gzip member with a "BC" extra subfield giving the total block size minus one; the file ends with an empty block.
+static const size_t kBGZFHeaderSize = 18;
+static const size_t kBGZFFooterSize = 8;
+static const size_t kBGZFMaxBlockSize = 0x10000;
+
+static const unsigned char gBGZFEOFMarker[28] = {
+	0x1f, 0x8b, 0x08, 0x04, 0x00, 0x00, 0x00, 0x00, 0x00, 0xff, 0x06, 0x00, 0x42, 0x43, 0x02, 0x00,
+	0x1b, 0x00, 0x03, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00
+};
+
+// Compress one block into p_out, which must have room for kBGZFMaxBlockSize bytes; returns the block size, or 0 on failure
+static size_t _Eidos_BGZFCompressBlock(const char *p_data, size_t p_length, unsigned char *p_out)
+{
+	size_t compressed_length = 0;
+	
+	// Try the default compression level first; if the data is incompressible enough that it won't fit, store it uncompressed
+	for (int level : {Z_DEFAULT_COMPRESSION, Z_NO_COMPRESSION})
+	{
+		z_stream zs;
+		
+		zs.zalloc = Z_NULL;
+		zs.zfree = Z_NULL;
+		zs.opaque = Z_NULL;
+		
+		if (deflateInit2(&zs, level, Z_DEFLATED, -15, 8, Z_DEFAULT_STRATEGY) != Z_OK)		// negative window bits for a raw deflate stream
+			return 0;
+		
+		zs.next_in = (Bytef *)p_data;
+		zs.avail_in = (uInt)p_length;
+		zs.next_out = p_out + kBGZFHeaderSize;
+		zs.avail_out = (uInt)(kBGZFMaxBlockSize - kBGZFHeaderSize - kBGZFFooterSize);
+		
+		int result = deflate(&zs, Z_FINISH);
+		
+		compressed_length = zs.total_out;
+		deflateEnd(&zs);
+		
+		if (result == Z_STREAM_END)
+			break;
+		if ((result != Z_OK) && (result != Z_BUF_ERROR))
+			return 0;
+		
+		compressed_length = 0;
+	}
+	
+	if (compressed_length == 0)
+		return 0;
+	
+	size_t block_size = kBGZFHeaderSize + compressed_length + kBGZFFooterSize;
+	uint32_t crc = (uint32_t)crc32(crc32(0L, Z_NULL, 0), (const Bytef *)p_data, (uInt)p_length);
+	uint32_t input_size = (uint32_t)p_length;
+	unsigned char *footer = p_out + kBGZFHeaderSize + compressed_length;
+	
+	// gzip header with FEXTRA, MTIME 0, XFL 0, OS unknown, XLEN 6, then the BC subfield of length 2 holding BSIZE (little-endian)
+	memcpy(p_out, gBGZFEOFMarker, 16);
+	p_out[16] = (unsigned char)((block_size - 1) & 0xFF);
+	p_out[17] = (unsigned char)((block_size - 1) >> 8);
+	
+	for (int byte_index = 0; byte_index < 4; ++byte_index)
+	{
+		footer[byte_index] = (unsigned char)((crc >> (byte_index * 8)) & 0xFF);
+		footer[byte_index + 4] = (unsigned char)((input_size >> (byte_index * 8)) & 0xFF);
+	}
+	
+	return block_size;
+}
+
+// definitions for the static constants, which are ODR-used (by std::min(), for example)
+const size_t Eidos_BGZFStreambuf::kBlockDataSize;
+const size_t Eidos_BGZFStreambuf::kBatchBlockCount;
+
+Eidos_BGZFStreambuf::Eidos_BGZFStreambuf(std::ostream &p_dest) : dest_(p_dest), buffer_(kBlockDataSize * kBatchBlockCount)
+{
+	setp(buffer_.data(), buffer_.data() + buffer_.size());
+}
+
+Eidos_BGZFStreambuf::~Eidos_BGZFStreambuf(void)
+{
+	Finish();
+}
+
+bool Eidos_BGZFStreambuf::CompressBuffer(size_t p_byte_count)
+{
+	if (failed_)
+		return false;
+	if (p_byte_count == 0)
+		return true;
+	
+	int64_t block_count = (int64_t)((p_byte_count + kBlockDataSize - 1) / kBlockDataSize);
+	std::vector<unsigned char> compressed((size_t)block_count * kBGZFMaxBlockSize);
+	std::vector<size_t> compressed_sizes((size_t)block_count, 0);
+	const char *buffer_data = buffer_.data();
+	unsigned char *compressed_data = compressed.data();
+	size_t *compressed_sizes_data = compressed_sizes.data();
+	
+	EIDOS_THREAD_COUNT(gEidos_OMP_threads_BGZF_COMPRESS);
+#pragma omp parallel for schedule(dynamic, 1) default(none) shared(block_count, p_byte_count) firstprivate(buffer_data, compressed_data, compressed_sizes_data) if(block_count >= EIDOS_OMPMIN_BGZF_COMPRESS) num_threads(thread_count)
+	for (int64_t block_index = 0; block_index < block_count; ++block_index)
+	{
+		size_t block_start = (size_t)block_index * kBlockDataSize;
+		size_t block_length = std::min(kBlockDataSize, p_byte_count - block_start);
+		
+		compressed_sizes_data[block_index] = _Eidos_BGZFCompressBlock(buffer_data + block_start, block_length, compressed_data + (size_t)block_index * kBGZFMaxBlockSize);
+	}
+	
+	for (int64_t block_index = 0; block_index < block_count; ++block_index)
+	{
+		size_t block_size = compressed_sizes_data[block_index];
+		
+		if (block_size == 0)
+		{
+			failed_ = true;
+			return false;
+		}
+		
+		dest_.write((const char *)compressed_data + (size_t)block_index * kBGZFMaxBlockSize, (std::streamsize)block_size);
+	}
+	
+	if (!dest_)
+		failed_ = true;
+	
+	return !failed_;
+}
+
+Eidos_BGZFStreambuf::int_type Eidos_BGZFStreambuf::overflow(int_type p_ch)
+{
+	// the buffer is full, and so consists entirely of full blocks; compress it all and start over
+	if (finished_ || !CompressBuffer((size_t)(pptr() - pbase())))
+		return traits_type::eof();
+	
+	setp(buffer_.data(), buffer_.data() + buffer_.size());
+	
+	if (!traits_type::eq_int_type(p_ch, traits_type::eof()))
+	{
+		*pptr() = traits_type::to_char_type(p_ch);
+		pbump(1);
+	}
+	
+	return traits_type::not_eof(p_ch);
+}
+
+bool Eidos_BGZFStreambuf::Finish(void)
+{
+	if (!finished_)
+	{
+		finished_ = true;
+		
+		if (CompressBuffer((size_t)(pptr() - pbase())))
+		{
+			dest_.write((const char *)gBGZFEOFMarker, sizeof(gBGZFEOFMarker));
+			dest_.flush();
+			
+			if (!dest_)
+				failed_ = true;
+		}
+		
+		setp(nullptr, nullptr);
+	}
+	
+	return !failed_;
+}
+
+bool Eidos_WriteBGZFData(std::ostream &p_dest, const char *p_data, size_t p_length)
+{
+	Eidos_BGZFStreambuf bgzf_buf(p_dest);
+	
+	if (p_length && (bgzf_buf.sputn(p_data, (std::streamsize)p_length) != (std::streamsize)p_length))
+		return false;
+	
+	return bgzf_buf.Finish();
+}
+
+// Parse the header of the gzip member at p_data, returning its length, or 0 if it is malformed; if the member is a BGZF block,
+// *p_bgzf_block_size is set to the total size of the block from its BC subfield, and otherwise it is set to 0
+static size_t _Eidos_GzipHeaderLength(const unsigned char *p_data, size_t p_size, size_t *p_bgzf_block_size)
+{
+	*p_bgzf_block_size = 0;
+	
+	if ((p_size < 18) || (p_data[0] != 0x1f) || (p_data[1] != 0x8b) || (p_data[2] != 8))	// magic number and the deflate method
+		return 0;
+	
+	unsigned char flags = p_data[3];
+	size_t header_length = 10;
+	
+	if (flags & 0x04)	// FEXTRA
+	{
+		size_t extra_length = (size_t)p_data[10] | ((size_t)p_data[11] << 8);
+		size_t subfield = 12;
+		
+		header_length = 12 + extra_length;
+		
+		if (header_length > p_size)
+			return 0;
+		
+		while (subfield + 4 <= header_length)
+		{
+			size_t subfield_length = (size_t)p_data[subfield + 2] | ((size_t)p_data[subfield + 3] << 8);
+			
+			if ((p_data[subfield] == 'B') && (p_data[subfield + 1] == 'C') && (subfield_length == 2) && (subfield + 6 <= header_length))
+				*p_bgzf_block_size = ((size_t)p_data[subfield + 4] | ((size_t)p_data[subfield + 5] << 8)) + 1;
+			
+			subfield += 4 + subfield_length;
+		}
+	}
+	
+	for (unsigned char string_flag : {(unsigned char)0x08, (unsigned char)0x10})	// FNAME and FCOMMENT, zero-terminated
+	{
+		if (flags & string_flag)
+		{
+			while ((header_length < p_size) && p_data[header_length])
+				header_length++;
+			header_length++;
+		}
+	}
+	
+	if (flags & 0x02)	// FHCRC
+		header_length += 2;
+	
+	return (header_length <= p_size) ? header_length : 0;
+}
+
+static inline uint32_t _Eidos_ReadLittleEndian32(const unsigned char *p_data)
+{
+	return (uint32_t)p_data[0] | ((uint32_t)p_data[1] << 8) | ((uint32_t)p_data[2] << 16) | ((uint32_t)p_data[3] << 24);
+}
+
+// Inflate one gzip member's raw deflate data into p_output, which must have room for exactly p_expected_size bytes, checking the CRC
+static bool _Eidos_InflateGzipMember(const unsigned char *p_deflate_data, size_t p_deflate_size, uint32_t p_expected_crc, size_t p_expected_size, char *p_output)
+{
+	unsigned char *inflated = nullptr;
+	size_t inflated_size = 0;
+	unsigned error = lodepng_inflate(&inflated, &inflated_size, p_deflate_data, p_deflate_size, &lodepng_default_decompress_settings);
+	bool success = (!error && (inflated_size == p_expected_size));
+	
+	if (success && inflated_size)
+	{
+		success = ((uint32_t)crc32(crc32(0L, Z_NULL, 0), inflated, (uInt)inflated_size) == p_expected_crc);
+		
+		if (success)
+			memcpy(p_output, inflated, inflated_size);
+	}
+	
+	free(inflated);
+	return success;
+}
+
+bool Eidos_DecompressGzipData(const char *p_data, size_t p_size, std::vector<char> &p_output)
+{
+	const unsigned char *data = (const unsigned char *)p_data;
+	
+	// Find the blocks, if the data is entirely BGZF; the uncompressed size of each block is in its footer, so we know where its output goes
+	std::vector<size_t> block_starts, block_sizes, output_offsets;
+	size_t position = 0, total_output_size = 0;
+	bool is_bgzf = true;
+	
+	while (position < p_size)
+	{
+		size_t block_size;
+		size_t header_length = _Eidos_GzipHeaderLength(data + position, p_size - position, &block_size);
+		
+		if ((header_length == 0) || (block_size < header_length + 8) || (block_size > p_size - position))
+		{
+			is_bgzf = false;
+			break;
+		}
+		
+		uint32_t uncompressed_size = _Eidos_ReadLittleEndian32(data + position + block_size - 4);
+		
+		if (uncompressed_size > kBGZFMaxBlockSize)
+		{
+			is_bgzf = false;
+			break;
+		}
+		
+		block_starts.emplace_back(position);
+		block_sizes.emplace_back(block_size);
+		output_offsets.emplace_back(total_output_size);
+		total_output_size += uncompressed_size;
+		position += block_size;
+	}
+	
+	if (is_bgzf)
+	{
+		p_output.resize(total_output_size);
+		output_offsets.emplace_back(total_output_size);
+		
+		int64_t block_count = (int64_t)block_starts.size();
+		std::vector<uint8_t> block_succeeded((size_t)block_count, 0);
+		char *output_data = p_output.data();
+		
+		EIDOS_THREAD_COUNT(gEidos_OMP_threads_BGZF_DECOMPRESS);
+#pragma omp parallel for schedule(dynamic, 16) default(none) shared(block_count, block_starts, block_sizes, output_offsets, block_succeeded) firstprivate(data, output_data) if(block_count >= EIDOS_OMPMIN_BGZF_DECOMPRESS) num_threads(thread_count)
+		for (int64_t block_index = 0; block_index < block_count; ++block_index)
+		{
+			const unsigned char *block = data + block_starts[block_index];
+			size_t block_size = block_sizes[block_index];
+			size_t unused_block_size;
+			size_t header_length = _Eidos_GzipHeaderLength(block, block_size, &unused_block_size);
+			size_t output_offset = output_offsets[block_index];
+			
+			block_succeeded[block_index] = _Eidos_InflateGzipMember(block + header_length, block_size - header_length - 8, _Eidos_ReadLittleEndian32(block + block_size - 8), output_offsets[block_index + 1] - output_offset, output_data + output_offset);
+		}
+		
+		return (std::find(block_succeeded.begin(), block_succeeded.end(), 0) == block_succeeded.end());
+	}
+	
+	// Otherwise, we handle a single gzip member; data following it would not be decompressed, and would make its footer mismatch
+	size_t unused_block_size;
+	size_t header_length = _Eidos_GzipHeaderLength(data, p_size, &unused_block_size);
+	
+	if ((header_length == 0) || (p_size < header_length + 8))
+		return false;
+	
+	p_output.resize(_Eidos_ReadLittleEndian32(data + p_size - 4));
+	
+	return _Eidos_InflateGzipMember(data + header_length, p_size - header_length - 8, _Eidos_ReadLittleEndian32(data + p_size - 8), p_output.size(), p_output.data());
+}
+
 // Create a temporary file based upon a template filename; note that pattern is modified!
 
 // There is a function called mkstemps() on OS X, and on many Linux systems, but it is not
@@ -2655,41 +3186,207 @@ bool _Eidos_FlushZipBuffer(const std::string &file_path, const std::string &outs
 	
 	//std::cout << "_Eidos_FlushZipBuffer() called for " << file_path << std::endl;
 	
-	const char *outcstr = outstring.c_str();
 	size_t outcstr_length = outstring.length();
 	
 	if (outcstr_length == 0)
 		return true;
 	
-	gzFile gzf = gzopen(file_path.c_str(), "ab");
+	// the data is appended as BGZF blocks, which are compressed in parallel when multithreaded; appended BGZF data, like any
+	// concatenation of gzip members, is valid gzip
+	std::ofstream file_stream(file_path.c_str(), std::ios_base::out | std::ios_base::app | std::ios_base::binary);
 	
-	if (!gzf)
+	if (!file_stream.is_open())
 	{
 		//std::cerr << "errno == " << errno << std::endl;
 		return false;
 	}
 	
-	// do the writing with zlib
-	int retval = gzbuffer(gzf, 128*1024L);	// bigger buffer for greater speed
-	
-	if (retval == -1)
+	if (!Eidos_WriteBGZFData(file_stream, outstring.data(), outcstr_length))
 		return false;
 	
-	retval = gzwrite(gzf, outcstr, (unsigned)outcstr_length);
+	file_stream.close();
 	
-	if (retval == 0)
-		return false;
+	return !file_stream.fail();
+}
+
+#if EIDOS_ASYNC_ZIP_FLUSHES
+// The background writer.  Buffers handed to _Eidos_WriteZipBuffer() are compressed and written out, in the order queued, by a
+// dedicated thread that is started on first use; for each job, the thread appends to the file through its own std::ofstream,
+// compressing with Eidos_WriteBGZFData() (see _Eidos_FlushZipBuffer()), so it shares no stream state.  The queue is bounded in
+// size, so a producer that gets far ahead of the disk blocks until it catches up.  Write failures cannot be raised on the writer
+// thread, so they are recorded and reported at the next barrier (_Eidos_WaitForZipWrites()) or the next write to the same path.
+class _Eidos_ZipWriter
+{
+private:
+	struct Job {
+		std::string file_path_;
+		std::string data_;
+	};
+	
+	static constexpr size_t kMaxQueuedBytes = 64 * 1024 * 1024;
+	
+	std::mutex mutex_;
+	std::condition_variable work_available_;		// signaled when a job is queued, or when stopping
+	std::condition_variable work_done_;				// signaled when a job completes, freeing queue space
+	std::deque<Job> queue_;
+	std::unordered_map<std::string, int> pending_jobs_;	// path -> number of jobs queued or in progress
+	std::unordered_set<std::string> failed_paths_;
+	size_t queued_bytes_ = 0;
+	bool stopping_ = false;
+	std::thread thread_;
+	
+	void WriterLoop(void)
+	{
+		std::unique_lock<std::mutex> lock(mutex_);
+		
+		while (true)
+		{
+			work_available_.wait(lock, [this] { return stopping_ || !queue_.empty(); });
+			
+			if (queue_.empty())
+				return;		// stopping, with no work left
+			
+			Job job = std::move(queue_.front());
+			queue_.pop_front();
+			
+			lock.unlock();
+			bool result = _Eidos_FlushZipBuffer(job.file_path_, job.data_);
+			lock.lock();
+			
+			queued_bytes_ -= job.data_.length();
+			
+			if (!result)
+				failed_paths_.insert(job.file_path_);
+			
+			auto pending_iter = pending_jobs_.find(job.file_path_);
+			
+			if (--pending_iter->second == 0)
+				pending_jobs_.erase(pending_iter);
+			
+			work_done_.notify_all();
+		}
+	}
 	
-	retval = gzclose_w(gzf);
+public:
+	_Eidos_ZipWriter(const _Eidos_ZipWriter&) = delete;					// no copying
+	_Eidos_ZipWriter& operator=(const _Eidos_ZipWriter&) = delete;		// no copying
+	_Eidos_ZipWriter(void) = default;
 	
-	if (retval != Z_OK)
-		return false;
+	~_Eidos_ZipWriter(void)
+	{
+		{
+			std::lock_guard<std::mutex> lock(mutex_);
+			stopping_ = true;
+		}
+		
+		work_available_.notify_all();
+		
+		if (thread_.joinable())
+			thread_.join();
+	}
 	
-	return true;
+	void Enqueue(const std::string &p_file_path, std::string &&p_data)
+	{
+		std::unique_lock<std::mutex> lock(mutex_);
+		
+		if (!thread_.joinable())
+			thread_ = std::thread(&_Eidos_ZipWriter::WriterLoop, this);
+		
+		// block while the queue is full; a single oversized buffer is admitted when the queue is empty
+		work_done_.wait(lock, [this] { return queue_.empty() || (queued_bytes_ < kMaxQueuedBytes); });
+		
+		queued_bytes_ += p_data.length();
+		pending_jobs_[p_file_path]++;
+		queue_.emplace_back(Job{p_file_path, std::move(p_data)});
+		
+		lock.unlock();
+		work_available_.notify_one();
+	}
+	
+	// Waits until all jobs for p_file_path (or for all paths, if p_file_path is nullptr) have been written; returns false if
+	// any write for those paths failed since the last call, and clears that failure
+	bool Wait(const std::string *p_file_path)
+	{
+		std::unique_lock<std::mutex> lock(mutex_);
+		
+		if (p_file_path)
+		{
+			work_done_.wait(lock, [this, p_file_path] { return pending_jobs_.find(*p_file_path) == pending_jobs_.end(); });
+			
+			return (failed_paths_.erase(*p_file_path) == 0);
+		}
+		
+		work_done_.wait(lock, [this] { return pending_jobs_.empty(); });
+		
+		bool success = failed_paths_.empty();
+		
+		for (const std::string &failed_path : failed_paths_)
+			std::cerr << std::endl << "ERROR (Eidos_FlushFiles): Flush of gzip data to file " << failed_path << " failed!" << std::endl;
+		
+		failed_paths_.clear();
+		return success;
+	}
+	
+	// Returns true if a write to p_file_path has failed and not yet been reported, clearing that failure
+	bool TakeFailure(const std::string &p_file_path)
+	{
+		std::lock_guard<std::mutex> lock(mutex_);
+		
+		return (failed_paths_.erase(p_file_path) != 0);
+	}
+	
+	size_t QueuedBytes(void)
+	{
+		std::lock_guard<std::mutex> lock(mutex_);
+		
+		return queued_bytes_;
+	}
+};
+
+static _Eidos_ZipWriter gEidos_ZipWriter;
+
+size_t Eidos_QueuedFileWriteBytes(void)
+{
+	return gEidos_ZipWriter.QueuedBytes();
+}
+#else
+size_t Eidos_QueuedFileWriteBytes(void)
+{
+	return 0;
+}
+#endif
+
+// This hands a buffer of data off to be written to p_file_path with gzip append; p_outstring is consumed
+// Errors are raised, either now or, when writing in the background, by a later call for the same path or a later flush
+static void _Eidos_WriteZipBuffer(const std::string &p_file_path, std::string &&p_outstring)
+{
+#if EIDOS_ASYNC_ZIP_FLUSHES
+	if (gEidos_ZipWriter.TakeFailure(p_file_path))
+		EIDOS_TERMINATION << "#ERROR (Eidos_WriteToFile): could not flush zip buffer to file at path " << p_file_path << "." << EidosTerminate(nullptr);
+	
+	gEidos_ZipWriter.Enqueue(p_file_path, std::move(p_outstring));
+#else
+	bool result = _Eidos_FlushZipBuffer(p_file_path, p_outstring);
+	
+	if (!result)
+		EIDOS_TERMINATION << "#ERROR (Eidos_WriteToFile): could not flush zip buffer to file at path " << p_file_path << "." << EidosTerminate(nullptr);
+#endif
 }
 #endif
 
-// This flushes a given file, if it is buffering zip output
+// Writes that do not go through the background writer call this first, so that they do not overtake data queued for the same file
+static inline void _Eidos_WaitForZipWrites(const std::string &p_file_path)
+{
+#if EIDOS_BUFFER_ZIP_APPENDS && EIDOS_ASYNC_ZIP_FLUSHES
+	if (!gEidos_ZipWriter.Wait(&p_file_path))
+		EIDOS_TERMINATION << "#ERROR (Eidos_WriteToFile): could not flush zip buffer to file at path " << p_file_path << "." << EidosTerminate(nullptr);
+#else
+#pragma unused (p_file_path)
+#endif
+}
+
+// This flushes a given file, if it is buffering zip output; when writing in the background, this is a barrier that returns only
+// once everything previously written to the file is on disk
 // This raises if an error occurs
 void Eidos_FlushFile(const std::string &p_file_path)
 {
@@ -2697,20 +3394,29 @@ void Eidos_FlushFile(const std::string &p_file_path)
 	
 #if EIDOS_BUFFER_ZIP_APPENDS
 	auto buffer_iter = gEidosBufferedZipAppendData.find(p_file_path);
+	bool result = true;
 	
 	if (buffer_iter != gEidosBufferedZipAppendData.end())
 	{
-		bool result = _Eidos_FlushZipBuffer(buffer_iter->first, buffer_iter->second);
-		
-		if (!result)
-			EIDOS_TERMINATION << "ERROR (Eidos_FlushFile): Flush of gzip data to file " << buffer_iter->first << " failed!" << EidosTerminate(nullptr);
-		
+#if EIDOS_ASYNC_ZIP_FLUSHES
+		gEidos_ZipWriter.Enqueue(buffer_iter->first, std::move(buffer_iter->second));
+#else
+		result = _Eidos_FlushZipBuffer(buffer_iter->first, buffer_iter->second);
+#endif
 		gEidosBufferedZipAppendData.erase(buffer_iter);
 	}
+	
+#if EIDOS_ASYNC_ZIP_FLUSHES
+	result = gEidos_ZipWriter.Wait(&p_file_path);
+#endif
+	
+	if (!result)
+		EIDOS_TERMINATION << "ERROR (Eidos_FlushFile): Flush of gzip data to file " << p_file_path << " failed!" << EidosTerminate(nullptr);
 #endif
 }
 
-// This flushes all outstanding buffered zip data to the appropriate files
+// This flushes all outstanding buffered zip data to the appropriate files; when writing in the background, this is a barrier
+// that returns only once all of that data, and everything written previously, is on disk
 // This returns false if an error occurs
 bool Eidos_FlushFiles(void)
 {
@@ -2722,6 +3428,9 @@ bool Eidos_FlushFiles(void)
 	
 	for (auto &buffer_pair : gEidosBufferedZipAppendData)
 	{
+#if EIDOS_ASYNC_ZIP_FLUSHES
+		gEidos_ZipWriter.Enqueue(buffer_pair.first, std::move(buffer_pair.second));
+#else
 		bool result = _Eidos_FlushZipBuffer(buffer_pair.first, buffer_pair.second);
 		
 		if (!result)
@@ -2732,10 +3441,16 @@ bool Eidos_FlushFiles(void)
 			std::cerr << std::endl << "ERROR (Eidos_FlushFiles): Flush of gzip data to file " << buffer_pair.first << " failed!" << std::endl;
 			success = false;
 		}
+#endif
 	}
 	
 	gEidosBufferedZipAppendData.clear();
 	
+#if EIDOS_ASYNC_ZIP_FLUSHES
+	// Failures are logged to stderr by Wait(), without a raise, for the reasons given above
+	success = gEidos_ZipWriter.Wait(nullptr);
+#endif
+	
 	return success;
 #endif
 	
@@ -2754,7 +3469,8 @@ void Eidos_WriteToFile(const std::string &p_file_path, const std::vector<const s
 		#if EIDOS_BUFFER_ZIP_APPENDS
 		if (p_append)
 		{
-			// the append case gets handled by _Eidos_FlushZipBuffer() if EIDOS_BUFFER_ZIP_APPENDS is true
+			// the append case gets handled by _Eidos_FlushZipBuffer() if EIDOS_BUFFER_ZIP_APPENDS is true, on the background writer
+			// thread if EIDOS_ASYNC_ZIP_FLUSHES is also true
 			auto buffer_iter = gEidosBufferedZipAppendData.find(p_file_path);
 			
 			if (buffer_iter == gEidosBufferedZipAppendData.end())
@@ -2773,11 +3489,10 @@ void Eidos_WriteToFile(const std::string &p_file_path, const std::vector<const s
 			if ((p_flush_option == EidosFileFlush::kForceFlush) ||
 				((p_flush_option == EidosFileFlush::kDefaultFlush) && (buffer.length() > 1024L * 128L)))
 			{
-				bool result = _Eidos_FlushZipBuffer(p_file_path, buffer);
-				gEidosBufferedZipAppendData.erase(buffer_iter);
+				std::string outstring = std::move(buffer);
 				
-				if (!result)
-					EIDOS_TERMINATION << "#ERROR (Eidos_WriteToFile): could not flush zip buffer to file at path " << p_file_path << "." << EidosTerminate(nullptr);
+				gEidosBufferedZipAppendData.erase(buffer_iter);
+				_Eidos_WriteZipBuffer(p_file_path, std::move(outstring));
 			}
 		}
 		else
@@ -2785,44 +3500,35 @@ void Eidos_WriteToFile(const std::string &p_file_path, const std::vector<const s
 		{
 			// this code can handle both the append and the non-append case, but the append case may generate very low-quality
 			// compression (potentially even worse than the uncompressed data) due to having an excess of gzip headers
-			gzFile gzf = gzopen(p_file_path.c_str(), p_append ? "ab" : "wb");
+			_Eidos_WaitForZipWrites(p_file_path);
+			
+			std::ofstream file_stream(p_file_path.c_str(), std::ios_base::out | std::ios_base::binary | (p_append ? std::ios_base::app : std::ios_base::trunc));
 			
-			if (!gzf)
+			if (!file_stream.is_open())
 				EIDOS_TERMINATION << "#ERROR (Eidos_WriteToFile): could not write to file at path " << p_file_path << "." << EidosTerminate(nullptr);
 			
-			std::ostringstream outstream;
+			std::string outstring;
 			
 			for (const std::string *content_line : p_contents)
-				outstream << *content_line << std::endl;
-			
-			std::string outstring = outstream.str();
-			const char *outcstr = outstring.c_str();
-			size_t outcstr_length = strlen(outcstr);
-			
-			// do the writing with zlib
-			bool failed = true;
-			int retval = gzbuffer(gzf, 128*1024L);	// bigger buffer for greater speed
-			
-			if (retval != -1)
 			{
-				retval = gzwrite(gzf, outcstr, (unsigned)outcstr_length);
-				
-				if ((retval != 0) || (outcstr_length == 0))	// writing 0 bytes returns 0, which is supposed to be an error code
-				{
-					retval = gzclose_w(gzf);
-					
-					if (retval == Z_OK)
-						failed = false;
-				}
+				outstring.append(*content_line);
+				outstring.append(1, '\n');
 			}
 			
-			if (failed)
+			// do the writing as BGZF, compressed in parallel when multithreaded
+			bool failed = !Eidos_WriteBGZFData(file_stream, outstring.data(), outstring.length());
+			
+			file_stream.close();
+			
+			if (failed || file_stream.fail())
 				EIDOS_TERMINATION << "#ERROR (Eidos_WriteToFile): encountered zlib errors while writing to file at path " << p_file_path << "." << EidosTerminate(nullptr);
 		}
 	}
 	else
 	{
 		// no compression
+		_Eidos_WaitForZipWrites(p_file_path);
+		
 		std::ofstream file_stream(p_file_path.c_str(), p_append ? (std::ios_base::app | std::ios_base::out) : std::ios_base::out);
 		
 		if (!file_stream.is_open())
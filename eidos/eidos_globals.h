@@ -544,6 +544,83 @@ std::string Eidos_TemporaryDirectory(void);
 // Apparently on some cluster systems /tmp does not exist, weirdly... I have no idea what's up with that...
 bool Eidos_TemporaryDirectoryExists(void);
 
+// A read-only view of the entire contents of a file, for parsers that want to walk a file's bytes directly.  The file is
+// memory-mapped where possible, so pages are brought in by the OS as they are touched rather than copied up front; on
+// platforms without mmap(), or if mapping fails, the file is read into a private buffer instead.  The mapping is private,
+// so the bytes may be modified by the client without affecting the file.  IsOpen() is false if the file could not be read.
+class Eidos_MappedFile
+{
+private:
+	char *data_ = nullptr;
+	size_t size_ = 0;
+	bool is_open_ = false;
+	bool is_mapped_ = false;		// if true, data_ was obtained from mmap(); if false, it was obtained from malloc()
+	
+public:
+	Eidos_MappedFile(const Eidos_MappedFile&) = delete;					// no copying
+	Eidos_MappedFile& operator=(const Eidos_MappedFile&) = delete;		// no copying
+	Eidos_MappedFile(void) = delete;									// no null construction
+	
+	explicit Eidos_MappedFile(const std::string &p_file_path);
+	~Eidos_MappedFile(void);
+	
+	inline __attribute__((always_inline)) bool IsOpen(void) const { return is_open_; }
+	inline __attribute__((always_inline)) char *Data(void) const { return data_; }
+	inline __attribute__((always_inline)) size_t Size(void) const { return size_; }
+};
+
+// A streambuf that writes BGZF, the blocked gzip format used by bgzip, tabix, and htslib, to a destination stream that should be
+// opened in binary mode.  Output is a valid gzip file, readable by any gzip reader, but it consists of independently compressed
+// blocks of at most 0xff00 bytes each, which allows files such as VCF to be indexed.  Full blocks are compressed in batches, in
+// parallel when running multithreaded; flushing does not force a block boundary, to avoid making tiny blocks.  Finish() must be
+// called (or the destructor will call it) to compress any remaining data and append the BGZF end-of-file marker.
+class Eidos_BGZFStreambuf : public std::streambuf
+{
+private:
+	std::ostream &dest_;
+	std::vector<char> buffer_;		// uncompressed data awaiting compression
+	bool finished_ = false;
+	bool failed_ = false;
+	
+	bool CompressBuffer(size_t p_byte_count);	// compresses the first p_byte_count bytes of buffer_ and writes them to dest_
+	
+protected:
+	virtual int_type overflow(int_type p_ch) override;
+	
+public:
+	static const size_t kBlockDataSize = 0xff00;		// the maximum uncompressed data per block, as used by htslib
+	static const size_t kBatchBlockCount = 64;			// the number of blocks compressed together, and in parallel
+	
+	Eidos_BGZFStreambuf(const Eidos_BGZFStreambuf&) = delete;					// no copying
+	Eidos_BGZFStreambuf& operator=(const Eidos_BGZFStreambuf&) = delete;		// no copying
+	Eidos_BGZFStreambuf(void) = delete;										// no null construction
+	
+	explicit Eidos_BGZFStreambuf(std::ostream &p_dest);
+	virtual ~Eidos_BGZFStreambuf(void) override;
+	
+	bool Finish(void);		// returns false if any compression or write error has occurred; idempotent
+};
+
+// Writes p_length bytes at p_data to p_dest as a complete BGZF stream, including the end-of-file marker, using Eidos_BGZFStreambuf;
+// this is how Eidos writes all gzip-compressed files, so that compression can use multiple threads.  Returns false on failure.
+bool Eidos_WriteBGZFData(std::ostream &p_dest, const char *p_data, size_t p_length);
+
+// Reading gzip-compressed input.  Eidos_IsGzipData() checks for the gzip magic number; Eidos_DecompressGzipData() decompresses into
+// p_output, returning false if the data is malformed or uses features that are not supported.  BGZF data, including concatenated
+// BGZF files, is decompressed block by block, in parallel when running multithreaded; other gzip data must be a single gzip member.
+inline __attribute__((always_inline)) bool Eidos_IsGzipData(const char *p_data, size_t p_size) { return (p_size >= 18) && ((unsigned char)p_data[0] == 0x1f) && ((unsigned char)p_data[1] == 0x8b); }
+bool Eidos_DecompressGzipData(const char *p_data, size_t p_size, std::vector<char> &p_output);
+
+// Gets the contents of the file at p_file_path for parsing, given p_mapped_file already constructed for that path.  If the file could not
+// be mapped (a pipe or other special file, for example) it is read through a stream into p_buffer instead.  Gzip data, detected from the
+// contents rather than the filename, is decompressed into p_buffer.  On return, *p_data and *p_size describe the contents, which remain
+// valid as long as p_mapped_file and p_buffer do.  Returns false if the file could not be read or decompressed.
+bool Eidos_GetFileContents(const std::string &p_file_path, Eidos_MappedFile &p_mapped_file, std::vector<char> &p_buffer, const char **p_data, size_t *p_size);
+
+// Splits p_size bytes at p_data into chunks of roughly p_chunk_size bytes, each beginning at the start of a line (after a '\n'), so that
+// the lines of a file can be parsed in parallel; the chunks are returned as [start, end) pairs that together cover the data in order.
+std::vector<std::pair<const char *, const char *>> Eidos_LineAlignedChunks(const char *p_data, size_t p_size, size_t p_chunk_size);
+
 // Create a temporary file based upon a template filename; note that pattern is modified!
 int Eidos_mkstemps(char *p_pattern, int p_suffix_len);
 int Eidos_mkstemps_directory(char *p_pattern, int p_suffix_len);
@@ -551,9 +628,12 @@ int Eidos_mkstemps_directory(char *p_pattern, int p_suffix_len);
 // Writing files with support for gzip compression and buffered flushing
 #define EIDOS_BUFFER_ZIP_APPENDS	1
 
+#define EIDOS_ASYNC_ZIP_FLUSHES		1	// if 1 (and EIDOS_BUFFER_ZIP_APPENDS is 1), buffered zip appends are compressed and written by a background thread
+
 #if EIDOS_BUFFER_ZIP_APPENDS	// implementation details for Eidos_FlushFiles(); for internal use only
 extern std::unordered_map<std::string, std::string> gEidosBufferedZipAppendData;	// canonical absolute file path -> buffered text
 bool _Eidos_FlushZipBuffer(const std::string &p_file_path, const std::string &p_outstring);
+size_t Eidos_QueuedFileWriteBytes(void);	// bytes handed to the background writer but not yet written; for memory usage reporting
 #endif
 
 void Eidos_FlushFile(const std::string &p_file_path);
@@ -1148,7 +1228,7 @@ enum _EidosGlobalStringID : uint32_t
 	gEidosID_Individual,
 	
 	gEidosID_LastEntry,					// IDs added by the Context should start here
-	gEidosID_LastContextEntry = 510		// IDs added by the Context must end before this value; Eidos reserves the remaining values
+	gEidosID_LastContextEntry = 600		// IDs added by the Context must end before this value; Eidos reserves the remaining values
 };
 
 extern std::vector<std::string> gEidosConstantNames;	// T, F, NULL, PI, E, INF, NAN
@@ -789,7 +789,9 @@ void EidosInterpreter::_AssignRValueToLValue(EidosValue_SP p_rvalue, const Eidos
 				EIDOS_TERMINATION << "ERROR (EidosInterpreter::_AssignRValueToLValue): (internal error) the '.' operator for x.y requires operand y to be an identifier." << EidosTerminate(nullptr);
 			
 			// OK, we have <object type>.<identifier>; we can work with that
-			static_cast<EidosValue_Object *>(first_child_value.get())->SetPropertyOfElements(second_child_node->cached_stringID_, *p_rvalue, second_child_node->token_);
+			EidosValue_Object *target_value = static_cast<EidosValue_Object *>(first_child_value.get());
+			
+			target_value->SetPropertyOfElements(second_child_node->cached_stringID_, second_child_node->PropertySignatureForClass(target_value->Class()), *p_rvalue, second_child_node->token_);
 			
 			break;
 		}
@@ -1576,8 +1578,8 @@ EidosValue_SP EidosInterpreter::Evaluate_Call(const EidosASTNode *p_node)
 		EidosGlobalStringID method_id = second_child_node->cached_stringID_;
 		EidosValue_Object_SP method_object = static_pointer_cast<EidosValue_Object>(first_child_value);	// guaranteed by the Type() call above
 		
-		// Look up the method signature; this could be cached in the tree, probably, since we guarantee that method signatures are unique by name
-		const EidosMethodSignature *method_signature = method_object->Class()->SignatureForMethod(method_id);
+		// Look up the method signature, through the inline cache on the method name node
+		const EidosMethodSignature *method_signature = second_child_node->MethodSignatureForClass(method_object->Class());
 		
 		if (!method_signature)
 		{
@@ -1862,7 +1864,9 @@ EidosValue_SP EidosInterpreter::Evaluate_MemberRef(const EidosASTNode *p_node)
 		EidosErrorPosition error_pos_save = PushErrorPositionFromToken(second_child_token);
 		
 		// We offload the actual work to GetPropertyOfElements() to keep things simple here
-		result_SP = static_cast<EidosValue_Object *>(first_child_value.get())->GetPropertyOfElements(second_child_node->cached_stringID_);
+		EidosValue_Object *target_value = static_cast<EidosValue_Object *>(first_child_value.get());
+		
+		result_SP = target_value->GetPropertyOfElements(second_child_node->cached_stringID_, second_child_node->PropertySignatureForClass(target_value->Class()));
 		
 		// Forget the function token, since it is not responsible for any future errors
 		RestoreErrorPosition(error_pos_save);
@@ -1900,7 +1904,9 @@ EidosValue_SP EidosInterpreter::Evaluate_MemberRef(const EidosASTNode *p_node)
 		EidosErrorPosition error_pos_save = PushErrorPositionFromToken(second_child_token);
 		
 		// We offload the actual work to GetPropertyOfElements() to keep things simple here
-		result_SP = static_cast<EidosValue_Object *>(first_child_value)->GetPropertyOfElements(second_child_node->cached_stringID_);
+		EidosValue_Object *target_value = static_cast<EidosValue_Object *>(first_child_value);
+		
+		result_SP = target_value->GetPropertyOfElements(second_child_node->cached_stringID_, second_child_node->PropertySignatureForClass(target_value->Class()));
 		
 		// Forget the function token, since it is not responsible for any future errors
 		RestoreErrorPosition(error_pos_save);
@@ -1924,7 +1930,9 @@ EidosValue_SP EidosInterpreter::Evaluate_MemberRef(const EidosASTNode *p_node)
 		EidosErrorPosition error_pos_save = PushErrorPositionFromToken(second_child_token);
 		
 		// We offload the actual work to GetPropertyOfElements() to keep things simple here
-		result_SP = static_cast<EidosValue_Object *>(first_child_value.get())->GetPropertyOfElements(second_child_node->cached_stringID_);
+		EidosValue_Object *target_value = static_cast<EidosValue_Object *>(first_child_value.get());
+		
+		result_SP = target_value->GetPropertyOfElements(second_child_node->cached_stringID_, second_child_node->PropertySignatureForClass(target_value->Class()));
 		
 		// Forget the function token, since it is not responsible for any future errors
 		RestoreErrorPosition(error_pos_save);
@@ -5084,7 +5092,13 @@ EidosValue_SP EidosInterpreter::Evaluate_Identifier(const EidosASTNode *p_node)
 		}
 		else
 		{
-			result_SP = global_symbols_->GetValueOrRaiseForASTNode(p_node);	// raises if undefined
+			// look the identifier up through its cached binding, if any; see EidosSymbolTable::GetValueRawOrNullForASTNode_Bound()
+			EidosValue *result = global_symbols_->GetValueRawOrNullForASTNode_Bound(p_node);
+			
+			if (result)
+				result_SP = EidosValue_SP(result);
+			else
+				result_SP = global_symbols_->GetValueOrRaiseForASTNode(p_node);	// raises if undefined
 		}
 	}
 	
@@ -6075,10 +6089,16 @@ EidosValue_SP EidosInterpreter::Evaluate_FunctionDecl(const EidosASTNode *p_node
 			// occur, since the code for the function body already passed through that process once.
 			// BCH 2/8/2021: Note that we now base this EidosScript on body_node->token_->token_line_ for purposes of debug
 			// point detection, so Eidos knows that this script is a substring of the original user script.
+			// The re-tokenize and re-parse turned out not to be negligible for scripts that define thousands of functions,
+			// so when the declaration belongs to the script being tracked for errors (the usual case) we now copy the tokens
+			// and nodes of the body instead, which produces the same result; the slow path remains as a fallback.
 			EidosScript *script = new EidosScript(body_node->token_->token_string_, body_node->token_->token_line_);
 			
-			script->Tokenize();
-			script->ParseInterpreterBlockToAST(false);
+			if (!gEidosErrorContext.currentScript || !script->CopyCompoundStatementFromScript(*gEidosErrorContext.currentScript, body_node))
+			{
+				script->Tokenize();
+				script->ParseInterpreterBlockToAST(false);
+			}
 			
 			sig->body_script_ = script;
 			sig->user_defined_ = true;
@@ -6120,6 +6140,691 @@ EidosValue_SP EidosInterpreter::Evaluate_FunctionDecl(const EidosASTNode *p_node
 	return result_SP;
 }
 
+// Conversions of bytecode registers to operand types, following the promotion rules of the tree-walking evaluators; the
+// logical conversion returns false for NAN, which the tree walker raises on, so the caller must bail out in that case
+static inline __attribute__((always_inline)) double _BytecodeRegisterAsFloat(const EidosBytecodeRegister &p_register)
+{
+	switch (p_register.type_)
+	{
+		case EidosValueType::kValueLogical:	return (p_register.logical_ ? 1.0 : 0.0);
+		case EidosValueType::kValueInt:		return (double)p_register.int_;
+		default:							return p_register.float_;
+	}
+}
+
+static inline __attribute__((always_inline)) int64_t _BytecodeRegisterAsInt(const EidosBytecodeRegister &p_register)
+{
+	// never called for float registers
+	return ((p_register.type_ == EidosValueType::kValueLogical) ? (p_register.logical_ ? 1 : 0) : p_register.int_);
+}
+
+static inline __attribute__((always_inline)) bool _BytecodeRegisterAsLogical(const EidosBytecodeRegister &p_register, eidos_logical_t *p_logical)
+{
+	switch (p_register.type_)
+	{
+		case EidosValueType::kValueLogical:	*p_logical = p_register.logical_; return true;
+		case EidosValueType::kValueInt:		*p_logical = (p_register.int_ != 0); return true;
+		default:
+			if (std::isnan(p_register.float_))
+				return false;
+			*p_logical = (p_register.float_ != 0.0);
+			return true;
+	}
+}
+
+inline __attribute__((always_inline)) bool EidosInterpreter::_ExecuteBytecodeInstruction(const EidosBytecodeInstruction &instruction, EidosBytecodeRegister *p_registers)
+{
+	// Execute one instruction of a program built by EidosASTNode::_CompileBytecode().  Returns false to bail out whenever an operand
+	// or result falls outside what the registers represent; no error is ever raised here.  Note that the destination register can
+	// be the same as a source register, so operands are always read before the destination is written.
+	EidosBytecodeRegister &dest = p_registers[instruction.dest_];
+	EidosBytecodeOp op = instruction.op_;
+	
+	switch (op)
+	{
+		case EidosBytecodeOp::kLoadConstant:
+		{
+			dest = instruction.immediate_;
+			break;
+		}
+		case EidosBytecodeOp::kLoadIdentifier:
+		{
+			EidosValue *value = global_symbols_->GetValueRawOrNullForASTNode_Bound(instruction.node_);
+			
+			if (!value || (value->DimensionCount() != 1) || (value->Count() != 1))
+				return false;
+			
+			switch (value->Type())
+			{
+				case EidosValueType::kValueLogical:
+					dest.type_ = EidosValueType::kValueLogical;
+					dest.logical_ = static_cast<EidosValue_Logical *>(value)->data()[0];
+					break;
+				case EidosValueType::kValueInt:
+					dest.type_ = EidosValueType::kValueInt;
+					dest.int_ = static_cast<EidosValue_Int *>(value)->data()[0];
+					break;
+				case EidosValueType::kValueFloat:
+					dest.type_ = EidosValueType::kValueFloat;
+					dest.float_ = static_cast<EidosValue_Float *>(value)->data()[0];
+					break;
+				default:
+					return false;
+			}
+			break;
+		}
+		case EidosBytecodeOp::kNegate:
+		{
+			const EidosBytecodeRegister &operand = p_registers[instruction.src1_];
+			
+			if (operand.type_ == EidosValueType::kValueInt)
+			{
+				int64_t result;
+				
+				if (Eidos_sub_overflow((int64_t)0, operand.int_, &result))
+					return false;
+				
+				dest.int_ = result;
+			}
+			else if (operand.type_ == EidosValueType::kValueFloat)
+			{
+				dest.float_ = -operand.float_;
+			}
+			else
+				return false;
+			
+			dest.type_ = operand.type_;
+			break;
+		}
+		case EidosBytecodeOp::kAdd:
+		case EidosBytecodeOp::kSubtract:
+		case EidosBytecodeOp::kMultiply:
+		case EidosBytecodeOp::kDivide:
+		case EidosBytecodeOp::kModulo:
+		case EidosBytecodeOp::kExponent:
+		{
+			const EidosBytecodeRegister &operand1 = p_registers[instruction.src1_];
+			const EidosBytecodeRegister &operand2 = p_registers[instruction.src2_];
+			
+			// arithmetic on logical operands is an error, which the tree walker will raise
+			if ((operand1.type_ == EidosValueType::kValueLogical) || (operand2.type_ == EidosValueType::kValueLogical))
+				return false;
+			
+			if ((operand1.type_ == EidosValueType::kValueInt) && (operand2.type_ == EidosValueType::kValueInt) && (op <= EidosBytecodeOp::kMultiply))
+			{
+				// integer +, -, and * produce an integer result, with overflow producing an error in the tree walker
+				int64_t result;
+				bool overflow;
+				
+				if (op == EidosBytecodeOp::kAdd)
+					overflow = Eidos_add_overflow(operand1.int_, operand2.int_, &result);
+				else if (op == EidosBytecodeOp::kSubtract)
+					overflow = Eidos_sub_overflow(operand1.int_, operand2.int_, &result);
+				else
+					overflow = Eidos_mul_overflow(operand1.int_, operand2.int_, &result);
+				
+				if (overflow)
+					return false;
+				
+				dest.type_ = EidosValueType::kValueInt;
+				dest.int_ = result;
+			}
+			else
+			{
+				// all other cases produce a float result; /, %, and ^ always do, even for integer operands
+				double x = _BytecodeRegisterAsFloat(operand1);
+				double y = _BytecodeRegisterAsFloat(operand2);
+				double result;
+				
+				switch (op)
+				{
+					case EidosBytecodeOp::kAdd:			result = x + y; break;
+					case EidosBytecodeOp::kSubtract:	result = x - y; break;
+					case EidosBytecodeOp::kMultiply:	result = x * y; break;
+					case EidosBytecodeOp::kDivide:		result = x / y; break;
+					case EidosBytecodeOp::kModulo:		result = fmod(x, y); break;
+					default:							result = pow(x, y); break;
+				}
+				
+				dest.type_ = EidosValueType::kValueFloat;
+				dest.float_ = result;
+			}
+			break;
+		}
+		case EidosBytecodeOp::kEqual:
+		case EidosBytecodeOp::kNotEqual:
+		case EidosBytecodeOp::kLess:
+		case EidosBytecodeOp::kLessEqual:
+		case EidosBytecodeOp::kGreater:
+		case EidosBytecodeOp::kGreaterEqual:
+		{
+			const EidosBytecodeRegister &operand1 = p_registers[instruction.src1_];
+			const EidosBytecodeRegister &operand2 = p_registers[instruction.src2_];
+			bool result;
+			
+			// comparisons promote to float if either operand is float, and otherwise compare as integers (logical < integer)
+			if ((operand1.type_ == EidosValueType::kValueFloat) || (operand2.type_ == EidosValueType::kValueFloat))
+			{
+				double x = _BytecodeRegisterAsFloat(operand1);
+				double y = _BytecodeRegisterAsFloat(operand2);
+				
+				switch (op)
+				{
+					case EidosBytecodeOp::kEqual:		result = (x == y); break;
+					case EidosBytecodeOp::kNotEqual:	result = (x != y); break;
+					case EidosBytecodeOp::kLess:		result = (x < y); break;
+					case EidosBytecodeOp::kLessEqual:	result = (x <= y); break;
+					case EidosBytecodeOp::kGreater:		result = (x > y); break;
+					default:							result = (x >= y); break;
+				}
+			}
+			else
+			{
+				int64_t x = _BytecodeRegisterAsInt(operand1);
+				int64_t y = _BytecodeRegisterAsInt(operand2);
+				
+				switch (op)
+				{
+					case EidosBytecodeOp::kEqual:		result = (x == y); break;
+					case EidosBytecodeOp::kNotEqual:	result = (x != y); break;
+					case EidosBytecodeOp::kLess:		result = (x < y); break;
+					case EidosBytecodeOp::kLessEqual:	result = (x <= y); break;
+					case EidosBytecodeOp::kGreater:		result = (x > y); break;
+					default:							result = (x >= y); break;
+				}
+			}
+			
+			dest.type_ = EidosValueType::kValueLogical;
+			dest.logical_ = result;
+			break;
+		}
+		case EidosBytecodeOp::kAnd:
+		case EidosBytecodeOp::kOr:
+		{
+			eidos_logical_t x, y;
+			
+			if (!_BytecodeRegisterAsLogical(p_registers[instruction.src1_], &x) || !_BytecodeRegisterAsLogical(p_registers[instruction.src2_], &y))
+				return false;
+			
+			dest.type_ = EidosValueType::kValueLogical;
+			dest.logical_ = ((op == EidosBytecodeOp::kAnd) ? (x && y) : (x || y));
+			break;
+		}
+		case EidosBytecodeOp::kNot:
+		{
+			eidos_logical_t x;
+			
+			if (!_BytecodeRegisterAsLogical(p_registers[instruction.src1_], &x))
+				return false;
+			
+			dest.type_ = EidosValueType::kValueLogical;
+			dest.logical_ = !x;
+			break;
+		}
+		case EidosBytecodeOp::kFunctionExp:
+		case EidosBytecodeOp::kFunctionLog:
+		case EidosBytecodeOp::kFunctionLog10:
+		case EidosBytecodeOp::kFunctionLog2:
+		case EidosBytecodeOp::kFunctionSqrt:
+		{
+			const EidosBytecodeRegister &operand = p_registers[instruction.src1_];
+			
+			// these functions take a numeric argument and always return float
+			if (operand.type_ == EidosValueType::kValueLogical)
+				return false;
+			
+			double x = _BytecodeRegisterAsFloat(operand);
+			
+			switch (op)
+			{
+				case EidosBytecodeOp::kFunctionExp:		dest.float_ = exp(x); break;
+				case EidosBytecodeOp::kFunctionLog:		dest.float_ = log(x); break;
+				case EidosBytecodeOp::kFunctionLog10:	dest.float_ = log10(x); break;
+				case EidosBytecodeOp::kFunctionLog2:	dest.float_ = log2(x); break;
+				default:								dest.float_ = sqrt(x); break;
+			}
+			
+			dest.type_ = EidosValueType::kValueFloat;
+			break;
+		}
+	}
+	
+	return true;
+}
+
+bool EidosInterpreter::_ExecuteBytecode(const EidosBytecodeProgram &p_program, EidosBytecodeRegister *p_registers)
+{
+	// Run a program on singleton operands, leaving the result in p_registers[0]; returns false to bail out
+	for (const EidosBytecodeInstruction &instruction : p_program.instructions_)
+		if (!_ExecuteBytecodeInstruction(instruction, p_registers))
+			return false;
+	
+	return true;
+}
+
+// Fused elementwise evaluation of bytecode programs over vectors.  Scalar subexpressions are computed once, up front, by the
+// scalar executor; what remains is a list of steps, each reading its operands from a vector leaf in the symbol table, a
+// scalar, or the block buffer of an earlier step.  Steps are run over blocks of EIDOS_BYTECODE_BLOCK_SIZE elements, so the
+// intermediate values for a block stay in cache, and each step's inner loop is a simple loop that the compiler can vectorize.
+enum class EidosFusedOperandKind : uint8_t {
+	kScalar = 0,
+	kFloatVector,
+	kIntVector,
+	kRegister
+};
+
+struct EidosFusedOperand
+{
+	EidosFusedOperandKind kind_;
+	uint8_t register_;					// for kRegister
+	double scalar_;						// for kScalar
+	const double *float_data_;			// for kFloatVector
+	const int64_t *int_data_;			// for kIntVector
+};
+
+struct EidosFusedStep
+{
+	EidosBytecodeOp op_;
+	uint8_t dest_;
+	EidosFusedOperand operand1_, operand2_;
+};
+
+static inline __attribute__((always_inline)) const double *_FusedOperandData(const EidosFusedOperand &p_operand, double (*p_registers)[EIDOS_BYTECODE_BLOCK_SIZE], double *p_scratch, int64_t p_start, int p_length)
+{
+	// returns nullptr for a scalar operand, which the caller broadcasts
+	switch (p_operand.kind_)
+	{
+		case EidosFusedOperandKind::kScalar:		return nullptr;
+		case EidosFusedOperandKind::kFloatVector:	return p_operand.float_data_ + p_start;
+		case EidosFusedOperandKind::kRegister:		return p_registers[p_operand.register_];
+		case EidosFusedOperandKind::kIntVector:
+		{
+			const int64_t *int_data = p_operand.int_data_ + p_start;
+			
+			for (int index = 0; index < p_length; ++index)
+				p_scratch[index] = (double)int_data[index];
+			
+			return p_scratch;
+		}
+	}
+	
+	return nullptr;
+}
+
+template <typename F>
+static inline __attribute__((always_inline)) void _FusedBinaryLoop(double *p_dest, const double *p_data1, double p_scalar1, const double *p_data2, double p_scalar2, int p_length, F p_function)
+{
+	if (p_data1 && p_data2)
+		for (int index = 0; index < p_length; ++index)
+			p_dest[index] = p_function(p_data1[index], p_data2[index]);
+	else if (p_data1)
+		for (int index = 0; index < p_length; ++index)
+			p_dest[index] = p_function(p_data1[index], p_scalar2);
+	else
+		for (int index = 0; index < p_length; ++index)
+			p_dest[index] = p_function(p_scalar1, p_data2[index]);
+}
+
+template <typename F>
+static inline __attribute__((always_inline)) void _FusedUnaryLoop(double *p_dest, const double *p_data, int p_length, F p_function)
+{
+	for (int index = 0; index < p_length; ++index)
+		p_dest[index] = p_function(p_data[index]);
+}
+
+static void _ExecuteFusedBlock(const std::vector<EidosFusedStep> &p_steps, int64_t p_start, int p_length, double *p_result_data)
+{
+	double registers[EIDOS_BYTECODE_MAX_REGISTERS][EIDOS_BYTECODE_BLOCK_SIZE];
+	double scratch1[EIDOS_BYTECODE_BLOCK_SIZE], scratch2[EIDOS_BYTECODE_BLOCK_SIZE];
+	size_t step_count = p_steps.size();
+	
+	for (size_t step_index = 0; step_index < step_count; ++step_index)
+	{
+		const EidosFusedStep &step = p_steps[step_index];
+		const double *data1 = _FusedOperandData(step.operand1_, registers, scratch1, p_start, p_length);
+		const double *data2 = _FusedOperandData(step.operand2_, registers, scratch2, p_start, p_length);
+		double scalar1 = step.operand1_.scalar_, scalar2 = step.operand2_.scalar_;
+		
+		// the last step writes straight into the result
+		double *dest = ((step_index == step_count - 1) ? p_result_data + p_start : registers[step.dest_]);
+		
+		switch (step.op_)
+		{
+			case EidosBytecodeOp::kNegate:			_FusedUnaryLoop(dest, data1, p_length, [](double x) { return -x; }); break;
+			case EidosBytecodeOp::kFunctionExp:		_FusedUnaryLoop(dest, data1, p_length, [](double x) { return exp(x); }); break;
+			case EidosBytecodeOp::kFunctionLog:		_FusedUnaryLoop(dest, data1, p_length, [](double x) { return log(x); }); break;
+			case EidosBytecodeOp::kFunctionLog10:	_FusedUnaryLoop(dest, data1, p_length, [](double x) { return log10(x); }); break;
+			case EidosBytecodeOp::kFunctionLog2:	_FusedUnaryLoop(dest, data1, p_length, [](double x) { return log2(x); }); break;
+			case EidosBytecodeOp::kFunctionSqrt:	_FusedUnaryLoop(dest, data1, p_length, [](double x) { return sqrt(x); }); break;
+			case EidosBytecodeOp::kAdd:				_FusedBinaryLoop(dest, data1, scalar1, data2, scalar2, p_length, [](double x, double y) { return x + y; }); break;
+			case EidosBytecodeOp::kSubtract:		_FusedBinaryLoop(dest, data1, scalar1, data2, scalar2, p_length, [](double x, double y) { return x - y; }); break;
+			case EidosBytecodeOp::kMultiply:		_FusedBinaryLoop(dest, data1, scalar1, data2, scalar2, p_length, [](double x, double y) { return x * y; }); break;
+			case EidosBytecodeOp::kDivide:			_FusedBinaryLoop(dest, data1, scalar1, data2, scalar2, p_length, [](double x, double y) { return x / y; }); break;
+			case EidosBytecodeOp::kModulo:			_FusedBinaryLoop(dest, data1, scalar1, data2, scalar2, p_length, [](double x, double y) { return fmod(x, y); }); break;
+			case EidosBytecodeOp::kExponent:		_FusedBinaryLoop(dest, data1, scalar1, data2, scalar2, p_length, [](double x, double y) { return pow(x, y); }); break;
+			default: break;
+		}
+	}
+}
+
+EidosValue_SP EidosInterpreter::_ExecuteBytecodeFused(const EidosBytecodeProgram &p_program)
+{
+	// Run an elementwise program over vector operands, all of which must be dimensionless and either singletons or of one common
+	// length.  Returns nullptr to bail out in any case that the tree walker handles differently – including integer +, -, and *
+	// between vectors, which would produce an integer result with overflow checks – so that the tree walker can take over.
+	EidosBytecodeRegister scalar_registers[EIDOS_BYTECODE_MAX_REGISTERS];
+	EidosFusedOperand vector_registers[EIDOS_BYTECODE_MAX_REGISTERS];
+	bool register_is_vector[EIDOS_BYTECODE_MAX_REGISTERS];
+	std::vector<EidosFusedStep> steps;
+	int vector_length = -1;
+	bool result_is_last_step = false;
+	
+	for (const EidosBytecodeInstruction &instruction : p_program.instructions_)
+	{
+		EidosBytecodeOp op = instruction.op_;
+		uint8_t dest = instruction.dest_;
+		
+		if (op == EidosBytecodeOp::kLoadIdentifier)
+		{
+			EidosValue *value = global_symbols_->GetValueRawOrNullForASTNode_Bound(instruction.node_);
+			
+			if (!value || (value->DimensionCount() != 1))
+				return EidosValue_SP(nullptr);
+			
+			EidosValueType value_type = value->Type();
+			int value_count = value->Count();
+			
+			if ((value_type != EidosValueType::kValueInt) && (value_type != EidosValueType::kValueFloat))
+				return EidosValue_SP(nullptr);
+			
+			if (value_count == 1)
+			{
+				if (!_ExecuteBytecodeInstruction(instruction, scalar_registers))
+					return EidosValue_SP(nullptr);
+				
+				register_is_vector[dest] = false;
+				result_is_last_step = false;
+				continue;
+			}
+			
+			if ((value_count == 0) || ((vector_length != -1) && (value_count != vector_length)))
+				return EidosValue_SP(nullptr);
+			
+			EidosFusedOperand &leaf = vector_registers[dest];
+			
+			vector_length = value_count;
+			leaf.kind_ = ((value_type == EidosValueType::kValueInt) ? EidosFusedOperandKind::kIntVector : EidosFusedOperandKind::kFloatVector);
+			leaf.float_data_ = ((value_type == EidosValueType::kValueFloat) ? value->FloatData() : nullptr);
+			leaf.int_data_ = ((value_type == EidosValueType::kValueInt) ? value->IntData() : nullptr);
+			leaf.scalar_ = 0.0;
+			register_is_vector[dest] = true;
+			result_is_last_step = false;
+			continue;
+		}
+		
+		bool is_unary = ((op == EidosBytecodeOp::kNegate) || (op >= EidosBytecodeOp::kFunctionExp));
+		bool src1_is_vector = ((op != EidosBytecodeOp::kLoadConstant) && register_is_vector[instruction.src1_]);
+		bool src2_is_vector = (!is_unary && (op != EidosBytecodeOp::kLoadConstant) && register_is_vector[instruction.src2_]);
+		
+		if (!src1_is_vector && !src2_is_vector)
+		{
+			// constants, and operations on scalars only, are done once with the scalar executor
+			if (!_ExecuteBytecodeInstruction(instruction, scalar_registers))
+				return EidosValue_SP(nullptr);
+			
+			register_is_vector[dest] = false;
+			result_is_last_step = false;
+			continue;
+		}
+		
+		EidosFusedStep step;
+		
+		step.op_ = op;
+		step.dest_ = dest;
+		
+		for (int operand_index = 0; operand_index < (is_unary ? 1 : 2); ++operand_index)
+		{
+			uint8_t src = (operand_index == 0) ? instruction.src1_ : instruction.src2_;
+			EidosFusedOperand &operand = ((operand_index == 0) ? step.operand1_ : step.operand2_);
+			
+			if (register_is_vector[src])
+			{
+				operand = vector_registers[src];
+			}
+			else
+			{
+				const EidosBytecodeRegister &scalar = scalar_registers[src];
+				
+				if (scalar.type_ == EidosValueType::kValueLogical)
+					return EidosValue_SP(nullptr);
+				
+				operand.kind_ = EidosFusedOperandKind::kScalar;
+				operand.scalar_ = _BytecodeRegisterAsFloat(scalar);
+				operand.float_data_ = nullptr;
+				operand.int_data_ = nullptr;
+			}
+		}
+		
+		if (is_unary)
+			step.operand2_ = step.operand1_;
+		
+		// integer negation, and integer +, -, and * on two integer operands, produce integer results in the tree walker
+		if ((op == EidosBytecodeOp::kNegate) && (step.operand1_.kind_ == EidosFusedOperandKind::kIntVector))
+			return EidosValue_SP(nullptr);
+		
+		if ((op >= EidosBytecodeOp::kAdd) && (op <= EidosBytecodeOp::kMultiply))
+		{
+			bool int1 = ((step.operand1_.kind_ == EidosFusedOperandKind::kIntVector) || (!src1_is_vector && (scalar_registers[instruction.src1_].type_ == EidosValueType::kValueInt)));
+			bool int2 = ((step.operand2_.kind_ == EidosFusedOperandKind::kIntVector) || (!src2_is_vector && (scalar_registers[instruction.src2_].type_ == EidosValueType::kValueInt)));
+			
+			if (int1 && int2)
+				return EidosValue_SP(nullptr);
+		}
+		
+		steps.emplace_back(step);
+		
+		EidosFusedOperand &result = vector_registers[dest];
+		
+		result.kind_ = EidosFusedOperandKind::kRegister;
+		result.register_ = dest;
+		result.scalar_ = 0.0;
+		result.float_data_ = nullptr;
+		result.int_data_ = nullptr;
+		register_is_vector[dest] = true;
+		result_is_last_step = true;
+	}
+	
+	// the final instruction must be a vector step, which writes the result; otherwise the scalar executor would have sufficed
+	if (!result_is_last_step)
+		return EidosValue_SP(nullptr);
+	
+	EidosValue_Float *float_result = (new (gEidosValuePool->AllocateChunk()) EidosValue_Float())->resize_no_initialize(vector_length);
+	EidosValue_SP result_SP(float_result);
+	double *result_data = float_result->data_mutable();
+	int block_count = (vector_length + EIDOS_BYTECODE_BLOCK_SIZE - 1) / EIDOS_BYTECODE_BLOCK_SIZE;
+	
+	EIDOS_THREAD_COUNT(gEidos_OMP_threads_FUSED_ARITH);
+#pragma omp parallel for schedule(static) default(none) shared(block_count, vector_length, steps) firstprivate(result_data) if(parallel:vector_length >= EIDOS_OMPMIN_FUSED_ARITH) num_threads(thread_count)
+	for (int block_index = 0; block_index < block_count; ++block_index)
+	{
+		int64_t block_start = (int64_t)block_index * EIDOS_BYTECODE_BLOCK_SIZE;
+		int block_length = (int)std::min((int64_t)EIDOS_BYTECODE_BLOCK_SIZE, vector_length - block_start);
+		
+		_ExecuteFusedBlock(steps, block_start, block_length, result_data);
+	}
+	
+	return result_SP;
+}
+
+EidosValue_SP EidosInterpreter::Evaluate_Bytecode(const EidosASTNode *p_node)
+{
+	const EidosBytecodeProgram *program = p_node->bytecode_;
+	
+#if DEBUG || defined(EIDOS_GUI)
+	// execution logs are a trace of the tree walk, so bytecode is bypassed when logging
+	if (logging_execution_)
+		return (this->*(program->fallback_evaluator_))(p_node);
+#endif
+	
+#if DEBUG_POINTS_ENABLED
+	// similarly, debug points log function calls as the tree walker makes them
+	if (debug_points_ && debug_points_->set.size())
+		return (this->*(program->fallback_evaluator_))(p_node);
+#endif
+	
+	EidosBytecodeRegister registers[EIDOS_BYTECODE_MAX_REGISTERS];
+	
+	if (_ExecuteBytecode(*program, registers))
+	{
+		if (!omp_in_parallel() && (program->success_count_ != UINT32_MAX))
+			program->success_count_++;
+		
+		const EidosBytecodeRegister &result = registers[0];
+		
+		switch (result.type_)
+		{
+			case EidosValueType::kValueLogical:	return (result.logical_ ? gStaticEidosValue_LogicalT : gStaticEidosValue_LogicalF);
+			case EidosValueType::kValueInt:		return EidosValue_SP(new (gEidosValuePool->AllocateChunk()) EidosValue_Int(result.int_));
+			default:							return EidosValue_SP(new (gEidosValuePool->AllocateChunk()) EidosValue_Float(result.float_));
+		}
+	}
+	
+	// If the scalar executor bailed out, perhaps because an operand is a vector, try the fused vector executor
+	if (program->elementwise_)
+	{
+		EidosValue_SP result_SP = _ExecuteBytecodeFused(*program);
+		
+		if (result_SP)
+		{
+			if (!omp_in_parallel() && (program->success_count_ != UINT32_MAX))
+				program->success_count_++;
+			
+			return result_SP;
+		}
+	}
+	
+	// Bail out to the tree walker.  If this node bails out more often than not (because its operands are usually vectors, say),
+	// stop trying bytecode for it; the counters are left alone inside parallel regions, where the node may be shared.
+	if (!omp_in_parallel())
+	{
+		program->bailout_count_++;
+		
+		if ((program->bailout_count_ >= 16) && (program->bailout_count_ > program->success_count_))
+			p_node->cached_evaluator_ = program->fallback_evaluator_;
+	}
+	
+	return (this->*(program->fallback_evaluator_))(p_node);
+}
+
+EidosEvaluationMethod EidosInterpreter::GenericEvaluatorForSpecializedNode(const EidosASTNode *p_node)
+{
+	switch (p_node->token_->token_type_)
+	{
+		case EidosTokenType::kTokenPlus:	return &EidosInterpreter::Evaluate_Plus;
+		case EidosTokenType::kTokenMinus:	return &EidosInterpreter::Evaluate_Minus;
+		case EidosTokenType::kTokenMult:	return &EidosInterpreter::Evaluate_Mult;
+		case EidosTokenType::kTokenEq:		return &EidosInterpreter::Evaluate_Eq;
+		case EidosTokenType::kTokenNotEq:	return &EidosInterpreter::Evaluate_NotEq;
+		case EidosTokenType::kTokenLt:		return &EidosInterpreter::Evaluate_Lt;
+		case EidosTokenType::kTokenLtEq:	return &EidosInterpreter::Evaluate_LtEq;
+		case EidosTokenType::kTokenGt:		return &EidosInterpreter::Evaluate_Gt;
+		case EidosTokenType::kTokenGtEq:	return &EidosInterpreter::Evaluate_GtEq;
+		default:							return nullptr;
+	}
+}
+
+EidosValue_SP EidosInterpreter::_DeoptimizeSpecializedNode(const EidosASTNode *p_node)
+{
+	// A specialization's guard failed, so the node goes back to its generic evaluator for good.  The operands of specialized
+	// nodes are free of side effects (see EidosTypeInterpreter::_SpecializeBinaryOperator()), so re-evaluating them is safe.
+	EidosEvaluationMethod generic_evaluator = GenericEvaluatorForSpecializedNode(p_node);
+	
+	if (!omp_in_parallel())
+		p_node->cached_evaluator_ = generic_evaluator;
+	
+	return (this->*generic_evaluator)(p_node);
+}
+
+EidosValue_SP EidosInterpreter::Evaluate_Specialized_IntInt(const EidosASTNode *p_node)
+{
+	// A binary operator whose operands were inferred to be integer; guarded by a check for two integer singleton vectors
+#if DEBUG || defined(EIDOS_GUI)
+	if (logging_execution_)
+		return (this->*GenericEvaluatorForSpecializedNode(p_node))(p_node);
+#endif
+	
+	EidosValue_SP first_child_value = FastEvaluateNode(p_node->children_[0]);
+	EidosValue_SP second_child_value = FastEvaluateNode(p_node->children_[1]);
+	EidosValue *first_value = first_child_value.get();
+	EidosValue *second_value = second_child_value.get();
+	
+	if ((first_value->Type() != EidosValueType::kValueInt) || (second_value->Type() != EidosValueType::kValueInt) ||
+		(static_cast<EidosValue_Int *>(first_value)->EidosValue_Int::Count() != 1) || (static_cast<EidosValue_Int *>(second_value)->EidosValue_Int::Count() != 1) ||
+		(first_value->DimensionCount() != 1) || (second_value->DimensionCount() != 1))
+		return _DeoptimizeSpecializedNode(p_node);
+	
+	int64_t x = static_cast<EidosValue_Int *>(first_value)->data()[0];
+	int64_t y = static_cast<EidosValue_Int *>(second_value)->data()[0];
+	int64_t result;
+	
+	switch (p_node->token_->token_type_)
+	{
+		case EidosTokenType::kTokenPlus:
+			if (Eidos_add_overflow(x, y, &result))
+				return _DeoptimizeSpecializedNode(p_node);		// the generic evaluator raises
+			return EidosValue_SP(new (gEidosValuePool->AllocateChunk()) EidosValue_Int(result));
+		case EidosTokenType::kTokenMinus:
+			if (Eidos_sub_overflow(x, y, &result))
+				return _DeoptimizeSpecializedNode(p_node);
+			return EidosValue_SP(new (gEidosValuePool->AllocateChunk()) EidosValue_Int(result));
+		case EidosTokenType::kTokenMult:
+			if (Eidos_mul_overflow(x, y, &result))
+				return _DeoptimizeSpecializedNode(p_node);
+			return EidosValue_SP(new (gEidosValuePool->AllocateChunk()) EidosValue_Int(result));
+		case EidosTokenType::kTokenEq:		return ((x == y) ? gStaticEidosValue_LogicalT : gStaticEidosValue_LogicalF);
+		case EidosTokenType::kTokenNotEq:	return ((x != y) ? gStaticEidosValue_LogicalT : gStaticEidosValue_LogicalF);
+		case EidosTokenType::kTokenLt:		return ((x < y) ? gStaticEidosValue_LogicalT : gStaticEidosValue_LogicalF);
+		case EidosTokenType::kTokenLtEq:	return ((x <= y) ? gStaticEidosValue_LogicalT : gStaticEidosValue_LogicalF);
+		case EidosTokenType::kTokenGt:		return ((x > y) ? gStaticEidosValue_LogicalT : gStaticEidosValue_LogicalF);
+		default:							return ((x >= y) ? gStaticEidosValue_LogicalT : gStaticEidosValue_LogicalF);
+	}
+}
+
+EidosValue_SP EidosInterpreter::Evaluate_Specialized_FloatFloat(const EidosASTNode *p_node)
+{
+	// A binary operator whose operands were inferred to be float; guarded by a check for two float singleton vectors
+#if DEBUG || defined(EIDOS_GUI)
+	if (logging_execution_)
+		return (this->*GenericEvaluatorForSpecializedNode(p_node))(p_node);
+#endif
+	
+	EidosValue_SP first_child_value = FastEvaluateNode(p_node->children_[0]);
+	EidosValue_SP second_child_value = FastEvaluateNode(p_node->children_[1]);
+	EidosValue *first_value = first_child_value.get();
+	EidosValue *second_value = second_child_value.get();
+	
+	if ((first_value->Type() != EidosValueType::kValueFloat) || (second_value->Type() != EidosValueType::kValueFloat) ||
+		(static_cast<EidosValue_Float *>(first_value)->EidosValue_Float::Count() != 1) || (static_cast<EidosValue_Float *>(second_value)->EidosValue_Float::Count() != 1) ||
+		(first_value->DimensionCount() != 1) || (second_value->DimensionCount() != 1))
+		return _DeoptimizeSpecializedNode(p_node);
+	
+	double x = static_cast<EidosValue_Float *>(first_value)->data()[0];
+	double y = static_cast<EidosValue_Float *>(second_value)->data()[0];
+	
+	switch (p_node->token_->token_type_)
+	{
+		case EidosTokenType::kTokenPlus:	return EidosValue_SP(new (gEidosValuePool->AllocateChunk()) EidosValue_Float(x + y));
+		case EidosTokenType::kTokenMinus:	return EidosValue_SP(new (gEidosValuePool->AllocateChunk()) EidosValue_Float(x - y));
+		case EidosTokenType::kTokenMult:	return EidosValue_SP(new (gEidosValuePool->AllocateChunk()) EidosValue_Float(x * y));
+		case EidosTokenType::kTokenEq:		return ((x == y) ? gStaticEidosValue_LogicalT : gStaticEidosValue_LogicalF);
+		case EidosTokenType::kTokenNotEq:	return ((x != y) ? gStaticEidosValue_LogicalT : gStaticEidosValue_LogicalF);
+		case EidosTokenType::kTokenLt:		return ((x < y) ? gStaticEidosValue_LogicalT : gStaticEidosValue_LogicalF);
+		case EidosTokenType::kTokenLtEq:	return ((x <= y) ? gStaticEidosValue_LogicalT : gStaticEidosValue_LogicalF);
+		case EidosTokenType::kTokenGt:		return ((x > y) ? gStaticEidosValue_LogicalT : gStaticEidosValue_LogicalF);
+		default:							return ((x >= y) ? gStaticEidosValue_LogicalT : gStaticEidosValue_LogicalF);
+	}
+}
+
 
 
 
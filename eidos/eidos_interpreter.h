@@ -292,7 +292,12 @@ public:
 		// this code path is used when the expectation is that we're fetching an object from the symbol table)
 		// use a cached value from EidosASTNode::_OptimizeConstants() if present
 		
-		return global_symbols_->GetValueRawOrRaiseForASTNode(p_node);	// raises if undefined
+		EidosValue *result = global_symbols_->GetValueRawOrNullForASTNode_Bound(p_node);
+		
+		if (!result)
+			result = global_symbols_->GetValueRawOrRaiseForASTNode(p_node);	// raises if undefined
+		
+		return result;
 	}
 	EidosValue_SP Evaluate_If(const EidosASTNode *p_node);
 	EidosValue_SP Evaluate_Do(const EidosASTNode *p_node);
@@ -302,6 +307,14 @@ public:
 	EidosValue_SP Evaluate_Break(const EidosASTNode *p_node);
 	EidosValue_SP Evaluate_Return(const EidosASTNode *p_node);
 	EidosValue_SP Evaluate_FunctionDecl(const EidosASTNode *p_node);
+	EidosValue_SP Evaluate_Bytecode(const EidosASTNode *p_node);
+	bool _ExecuteBytecodeInstruction(const EidosBytecodeInstruction &instruction, EidosBytecodeRegister *p_registers);
+	bool _ExecuteBytecode(const EidosBytecodeProgram &p_program, EidosBytecodeRegister *p_registers);
+	EidosValue_SP _ExecuteBytecodeFused(const EidosBytecodeProgram &p_program);
+	EidosValue_SP Evaluate_Specialized_IntInt(const EidosASTNode *p_node);
+	EidosValue_SP Evaluate_Specialized_FloatFloat(const EidosASTNode *p_node);
+	EidosValue_SP _DeoptimizeSpecializedNode(const EidosASTNode *p_node);
+	static EidosEvaluationMethod GenericEvaluatorForSpecializedNode(const EidosASTNode *p_node);
 	
 	// Function dispatch/execution; these are implemented in eidos_functions.cpp
 	static const std::vector<EidosFunctionSignature_CSP> &BuiltInFunctions(void);
@@ -273,6 +273,7 @@ private:
 #define EIDOS_OMPMIN_SUM_FLOAT				2000
 #define EIDOS_OMPMIN_SUM_LOGICAL			6000
 #define EIDOS_OMPMIN_TRUNC					2000
+#define EIDOS_OMPMIN_FUSED_ARITH			10000
 
 // Eidos: max(), min(), pmax(), pmin()
 #define EIDOS_OMPMIN_MAX_INT				2000
@@ -391,6 +392,13 @@ private:
 #define EIDOS_OMPMIN_SIMPLIFY_SORT			4000
 #define EIDOS_OMPMIN_SIMPLIFY_SORT_POST		4000
 #define EIDOS_OMPMIN_SURVIVAL				10000
+#define EIDOS_OMPMIN_TS_OVERLAY				1000
+#define EIDOS_OMPMIN_VCF_OUTPUT				1000
+#define EIDOS_OMPMIN_BGZF_COMPRESS			4
+#define EIDOS_OMPMIN_BGZF_DECOMPRESS		4
+#define EIDOS_OMPMIN_VCF_INPUT				100
+#define EIDOS_OMPMIN_FILE_INPUT				4
+#define EIDOS_OMPMIN_HAPLOTYPE_MATRIX		16
 
 #else
 // This set of minimum counts is for debugging; we want to run all self-tests in parallel, so that
@@ -411,6 +419,7 @@ private:
 #define EIDOS_OMPMIN_SUM_FLOAT				0
 #define EIDOS_OMPMIN_SUM_LOGICAL			0
 #define EIDOS_OMPMIN_TRUNC					0
+#define EIDOS_OMPMIN_FUSED_ARITH			0
 
 // Eidos: max(), min(), pmax(), pmin()
 #define EIDOS_OMPMIN_MAX_INT				0
@@ -529,6 +538,13 @@ private:
 #define EIDOS_OMPMIN_SIMPLIFY_SORT			0
 #define EIDOS_OMPMIN_SIMPLIFY_SORT_POST		0
 #define EIDOS_OMPMIN_SURVIVAL				0
+#define EIDOS_OMPMIN_TS_OVERLAY				0
+#define EIDOS_OMPMIN_VCF_OUTPUT				0
+#define EIDOS_OMPMIN_BGZF_COMPRESS			0
+#define EIDOS_OMPMIN_BGZF_DECOMPRESS		0
+#define EIDOS_OMPMIN_VCF_INPUT				0
+#define EIDOS_OMPMIN_FILE_INPUT				0
+#define EIDOS_OMPMIN_HAPLOTYPE_MATRIX		0
 
 #endif
 
@@ -550,6 +566,7 @@ extern int gEidos_OMP_threads_SUM_INTEGER;
 extern int gEidos_OMP_threads_SUM_FLOAT;
 extern int gEidos_OMP_threads_SUM_LOGICAL;
 extern int gEidos_OMP_threads_TRUNC;
+extern int gEidos_OMP_threads_FUSED_ARITH;
 
 // Eidos: max(), min(), pmax(), pmin(); benchmark section X
 extern int gEidos_OMP_threads_MAX_INT;
@@ -670,6 +687,13 @@ extern int gEidos_OMP_threads_SIMPLIFY_SORT_POST;
 extern int gEidos_OMP_threads_PARENTS_CLEAR;
 extern int gEidos_OMP_threads_UNIQUE_MUTRUNS;
 extern int gEidos_OMP_threads_SURVIVAL;
+extern int gEidos_OMP_threads_TS_OVERLAY;
+extern int gEidos_OMP_threads_VCF_OUTPUT;
+extern int gEidos_OMP_threads_BGZF_COMPRESS;
+extern int gEidos_OMP_threads_BGZF_DECOMPRESS;
+extern int gEidos_OMP_threads_VCF_INPUT;
+extern int gEidos_OMP_threads_FILE_INPUT;
+extern int gEidos_OMP_threads_HAPLOTYPE_MATRIX;
 
 // benchmark section M is for "models", whole SLiM models that test overall scaling
 // for different model types; they do not correspond to per-task keys
@@ -21,6 +21,7 @@
 #include "eidos_rng.h"
 
 #include <stdio.h>
+#include <string.h>
 #include <unistd.h>
 #include <fcntl.h>
 #include <sys/time.h>
@@ -251,6 +252,110 @@ void Eidos_SetRNGSeed(unsigned long int p_seed)
 #endif
 }
 
+static void _Eidos_SaveOneRNGState(const Eidos_RNG_State &r, std::string &p_buffer)
+{
+	uint64_t last_seed = (uint64_t)r.rng_last_seed_;
+	uint32_t gsl_state_size = (uint32_t)gsl_rng_size(r.gsl_rng_);
+	int32_t mti = (int32_t)r.mt_rng_.mti_;
+	int32_t bit_counter = (int32_t)r.random_bool_bit_counter_;
+	uint64_t bit_buffer = r.random_bool_bit_buffer_;
+	
+	p_buffer.append((const char *)&last_seed, sizeof(last_seed));
+	p_buffer.append((const char *)&gsl_state_size, sizeof(gsl_state_size));
+	p_buffer.append((const char *)gsl_rng_state(r.gsl_rng_), gsl_state_size);
+	p_buffer.append((const char *)r.mt_rng_.mt_, Eidos_MT64_NN * sizeof(uint64_t));
+	p_buffer.append((const char *)&mti, sizeof(mti));
+	p_buffer.append((const char *)&bit_counter, sizeof(bit_counter));
+	p_buffer.append((const char *)&bit_buffer, sizeof(bit_buffer));
+}
+
+static void _Eidos_ReadRNGBytes(void *p_dest, size_t p_size, const char *&p_ptr, const char *p_end)
+{
+	if ((size_t)(p_end - p_ptr) < p_size)
+		EIDOS_TERMINATION << "ERROR (Eidos_RestoreRNGState): the saved random number generator state is truncated." << EidosTerminate(nullptr);
+	
+	memcpy(p_dest, p_ptr, p_size);
+	p_ptr += p_size;
+}
+
+static void _Eidos_RestoreOneRNGState(Eidos_RNG_State *r, const char *&p_ptr, const char *p_end)
+{
+	// if r is nullptr, the state is consumed but discarded (a generator for a thread we do not have)
+	uint64_t last_seed;
+	uint32_t gsl_state_size;
+	
+	_Eidos_ReadRNGBytes(&last_seed, sizeof(last_seed), p_ptr, p_end);
+	_Eidos_ReadRNGBytes(&gsl_state_size, sizeof(gsl_state_size), p_ptr, p_end);
+	
+	if (r && (gsl_state_size != gsl_rng_size(r->gsl_rng_)))
+		EIDOS_TERMINATION << "ERROR (Eidos_RestoreRNGState): the saved random number generator state does not match this build's generator." << EidosTerminate(nullptr);
+	
+	if ((size_t)(p_end - p_ptr) < gsl_state_size + Eidos_MT64_NN * sizeof(uint64_t) + 2 * sizeof(int32_t) + sizeof(uint64_t))
+		EIDOS_TERMINATION << "ERROR (Eidos_RestoreRNGState): the saved random number generator state is truncated." << EidosTerminate(nullptr);
+	
+	if (!r)
+	{
+		p_ptr += gsl_state_size + Eidos_MT64_NN * sizeof(uint64_t) + 2 * sizeof(int32_t) + sizeof(uint64_t);
+		return;
+	}
+	
+	int32_t mti, bit_counter;
+	
+	r->rng_last_seed_ = (unsigned long int)last_seed;
+	_Eidos_ReadRNGBytes(gsl_rng_state(r->gsl_rng_), gsl_state_size, p_ptr, p_end);
+	_Eidos_ReadRNGBytes(r->mt_rng_.mt_, Eidos_MT64_NN * sizeof(uint64_t), p_ptr, p_end);
+	_Eidos_ReadRNGBytes(&mti, sizeof(mti), p_ptr, p_end);
+	_Eidos_ReadRNGBytes(&bit_counter, sizeof(bit_counter), p_ptr, p_end);
+	_Eidos_ReadRNGBytes(&r->random_bool_bit_buffer_, sizeof(r->random_bool_bit_buffer_), p_ptr, p_end);
+	r->mt_rng_.mti_ = mti;
+	r->random_bool_bit_counter_ = bit_counter;
+}
+
+void Eidos_SaveRNGState(std::string &p_buffer)
+{
+	THREAD_SAFETY_IN_ANY_PARALLEL("Eidos_SaveRNGState(): RNG access");
+	
+	if (!gEidos_RNG_Initialized)
+		EIDOS_TERMINATION << "ERROR (Eidos_SaveRNGState): (internal error) the Eidos random number generator has not been allocated." << EidosTerminate(nullptr);
+	
+#ifndef _OPENMP
+	uint32_t thread_count = 1;
+	
+	p_buffer.append((const char *)&thread_count, sizeof(thread_count));
+	_Eidos_SaveOneRNGState(gEidos_RNG_SINGLE, p_buffer);
+#else
+	uint32_t thread_count = (uint32_t)gEidos_RNG_PERTHREAD.size();
+	
+	p_buffer.append((const char *)&thread_count, sizeof(thread_count));
+	
+	for (uint32_t threadIndex = 0; threadIndex < thread_count; ++threadIndex)
+		_Eidos_SaveOneRNGState(*gEidos_RNG_PERTHREAD[threadIndex], p_buffer);
+#endif
+}
+
+void Eidos_RestoreRNGState(const char *&p_ptr, const char *p_end)
+{
+	THREAD_SAFETY_IN_ANY_PARALLEL("Eidos_RestoreRNGState(): RNG change");
+	
+	if (!gEidos_RNG_Initialized)
+		EIDOS_TERMINATION << "ERROR (Eidos_RestoreRNGState): (internal error) the Eidos random number generator has not been allocated." << EidosTerminate(nullptr);
+	
+	uint32_t thread_count;
+	
+	_Eidos_ReadRNGBytes(&thread_count, sizeof(thread_count), p_ptr, p_end);
+	
+	for (uint32_t threadIndex = 0; threadIndex < thread_count; ++threadIndex)
+	{
+#ifndef _OPENMP
+		Eidos_RNG_State *r = (threadIndex == 0) ? &gEidos_RNG_SINGLE : nullptr;
+#else
+		Eidos_RNG_State *r = (threadIndex < gEidos_RNG_PERTHREAD.size()) ? gEidos_RNG_PERTHREAD[threadIndex] : nullptr;
+#endif
+		
+		_Eidos_RestoreOneRNGState(r, p_ptr, p_end);
+	}
+}
+
 #ifndef USE_GSL_POISSON
 double Eidos_FastRandomPoisson_PRECALCULATE(double p_mu)
 {
@@ -35,6 +35,7 @@
 #include <stdint.h>
 #include <cmath>
 #include <vector>
+#include <string>
 #include "eidos_globals.h"
 
 
@@ -126,6 +127,12 @@ void Eidos_InitializeRNG(void);
 void Eidos_FreeRNG(void);
 void Eidos_SetRNGSeed(unsigned long int p_seed);
 
+// save and restore the complete RNG state (every per-thread generator, when running multithreaded) as an opaque byte
+// string, for checkpointing; if the thread count differs on restore, the generators common to both are restored and
+// any additional generators keep their current state.  Eidos_RestoreRNGState() advances p_ptr past what it consumed.
+void Eidos_SaveRNGState(std::string &p_buffer);
+void Eidos_RestoreRNGState(const char *&p_ptr, const char *p_end);
+
 
 // This code is copied and modified from taus.c in the GSL library because we want to be able to inline taus_get().
 // Random number generation can be a major bottleneck in many SLiM models, so I think this is worth the grossness.
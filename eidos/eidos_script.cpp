@@ -27,6 +27,7 @@
 #include <iostream>
 #include <sstream>
 #include <utility>
+#include <algorithm>
 
 
 // set these to true to get logging of tokens / AST / evaluation
@@ -101,8 +102,10 @@ void EidosScript::Tokenize(bool p_make_bad_tokens, bool p_keep_nonsignificant)
 	if (!p_make_bad_tokens)
 		gEidosErrorContext.currentScript = this;
 	
-	// delete all existing tokens
+	// delete all existing tokens; EidosToken can't be moved, so growing the stream copies every token string, and for large
+	// scripts it is worth reserving for a conservative estimate of the token count (scripts average several chars per token)
 	token_stream_.clear();
+	token_stream_.reserve(script_string_.length() / 8 + 1);
 	
 	// destroy the parse root and return it to the pool; the tree must be allocated out of gEidosASTNodePool!
 	if (parse_root_)
@@ -2770,6 +2773,132 @@ void EidosScript::ParseInterpreterBlockToAST(bool p_allow_functions, bool p_make
 	parse_make_bad_nodes_ = false;
 }
 
+static bool _Eidos_SubtreeUsesTokenRange(const EidosASTNode *p_node, const EidosToken *p_first_token, const EidosToken *p_last_token)
+{
+	// every non-owned token in the subtree must point into [p_first_token, p_last_token]; bad tokens from tolerant parsing disqualify
+	const EidosToken *token = p_node->token_;
+	
+	if (token->token_type_ == EidosTokenType::kTokenBad)
+		return false;
+	if (!p_node->token_is_owned_ && ((token < p_first_token) || (token > p_last_token)))
+		return false;
+	
+#if (SLIMPROFILING == 1)
+	const EidosToken *end_token = p_node->full_range_end_token_;
+	
+	if (end_token && ((end_token < p_first_token) || (end_token > p_last_token)))
+		return false;
+#endif
+	
+	for (const EidosASTNode *child : p_node->children_)
+		if (!_Eidos_SubtreeUsesTokenRange(child, p_first_token, p_last_token))
+			return false;
+	
+	return true;
+}
+
+static EidosASTNode *_Eidos_CopySubtree(const EidosASTNode *p_node, const EidosToken *p_source_first_token, EidosToken *p_dest_first_token, int32_t p_offset, int32_t p_offset_UTF16)
+{
+	// copy only the state produced by parsing; the optimization caches are rebuilt by OptimizeTree() on the copy
+	const EidosToken *token = p_node->token_;
+	EidosASTNode *node;
+	
+	if (p_node->token_is_owned_)
+		node = new (gEidosASTNodePool->AllocateChunk()) EidosASTNode(new EidosToken(token->token_type_, token->token_string_, token->token_start_ - p_offset, token->token_end_ - p_offset, token->token_UTF16_start_ - p_offset_UTF16, token->token_UTF16_end_ - p_offset_UTF16, token->token_line_), true);
+	else
+		node = new (gEidosASTNodePool->AllocateChunk()) EidosASTNode(p_dest_first_token + (token - p_source_first_token));
+	
+	node->typespec_ = p_node->typespec_;
+	node->hit_eof_in_tolerant_parse_ = p_node->hit_eof_in_tolerant_parse_;
+	node->was_parenthesized_ = p_node->was_parenthesized_;
+	
+#if (SLIMPROFILING == 1)
+	if (p_node->full_range_end_token_)
+		node->full_range_end_token_ = p_dest_first_token + (p_node->full_range_end_token_ - p_source_first_token);
+#endif
+	
+	node->children_.reserve(p_node->children_.size());
+	
+	for (const EidosASTNode *child : p_node->children_)
+		node->AddChild(_Eidos_CopySubtree(child, p_source_first_token, p_dest_first_token, p_offset, p_offset_UTF16));
+	
+	return node;
+}
+
+bool EidosScript::CopyCompoundStatementFromScript(const EidosScript &p_source_script, const EidosASTNode *p_source_node)
+{
+	THREAD_SAFETY_IN_ACTIVE_PARALLEL("EidosScript::CopyCompoundStatementFromScript(): token_stream_ and parse_root_ change");
+	
+	// Find the brace tokens delimiting the compound statement in the source token stream; tokens are in order of position
+	const std::vector<EidosToken> &source_tokens = p_source_script.token_stream_;
+	const EidosToken *block_token = p_source_node->token_;
+	
+	if ((block_token->token_type_ != EidosTokenType::kTokenLBrace) || (block_token->token_string_ != script_string_) || (source_tokens.size() == 0))
+		return false;
+	
+	auto first_iter = std::lower_bound(source_tokens.begin(), source_tokens.end(), block_token->token_start_, [](const EidosToken &p_token, int32_t p_start) { return p_token.token_start_ < p_start; });
+	auto last_iter = std::lower_bound(first_iter, source_tokens.end(), block_token->token_end_, [](const EidosToken &p_token, int32_t p_start) { return p_token.token_start_ < p_start; });
+	
+	if ((first_iter == source_tokens.end()) || (last_iter == source_tokens.end()) ||
+		(first_iter->token_type_ != EidosTokenType::kTokenLBrace) || (first_iter->token_start_ != block_token->token_start_) ||
+		(last_iter->token_type_ != EidosTokenType::kTokenRBrace) || (last_iter->token_end_ != block_token->token_end_))
+		return false;
+	
+	const EidosToken *source_first_token = &*first_iter;
+	const EidosToken *source_last_token = &*last_iter;
+	
+	if (!_Eidos_SubtreeUsesTokenRange(p_source_node, source_first_token, source_last_token))
+		return false;
+	
+	// destroy the parse root and return it to the pool; the tree must be allocated out of gEidosASTNodePool!
+	if (parse_root_)
+	{
+		parse_root_->~EidosASTNode();
+		gEidosASTNodePool->DisposeChunk(const_cast<EidosASTNode*>(parse_root_));
+		parse_root_ = nullptr;
+	}
+	
+	// Copy the tokens, shifting their positions to be relative to our script string; lines are in the full user script
+	// and are kept as is.  This reproduces what Tokenize() would generate for our script string, including the final EOF.
+	int32_t offset = block_token->token_start_;
+	int32_t offset_UTF16 = block_token->token_UTF16_start_;
+	
+	token_stream_.clear();
+	token_stream_.reserve((source_last_token - source_first_token) + 2);
+	
+	for (const EidosToken *token = source_first_token; token <= source_last_token; ++token)
+		token_stream_.emplace_back(token->token_type_, token->token_string_, token->token_start_ - offset, token->token_end_ - offset, token->token_UTF16_start_ - offset_UTF16, token->token_UTF16_end_ - offset_UTF16, token->token_line_);
+	
+	int32_t eof_pos = (int32_t)script_string_.length();
+	int32_t eof_pos_UTF16 = block_token->token_UTF16_end_ - offset_UTF16 + 1;
+	
+	token_stream_.emplace_back(EidosTokenType::kTokenEOF, "EOF", eof_pos, eof_pos, eof_pos_UTF16, eof_pos_UTF16, source_last_token->token_line_);
+	
+	// set up error tracking for this script
+	EidosScript *current_script_save = gEidosErrorContext.currentScript;
+	gEidosErrorContext.currentScript = this;
+	
+	// wrap a copy of the compound statement in an interpreter block node, as Parse_InterpreterBlock() would
+	EidosASTNode *compound_node = _Eidos_CopySubtree(p_source_node, source_first_token, token_stream_.data(), offset, offset_UTF16);
+	
+	parse_root_ = new (gEidosASTNodePool->AllocateChunk()) EidosASTNode(new EidosToken(EidosTokenType::kTokenInterpreterBlock, script_string_, 0, eof_pos - 1, 0, eof_pos_UTF16 - 1, token_stream_[0].token_line_), true);
+	parse_root_->AddChild(compound_node);
+	
+	parse_root_->OptimizeTree();
+	
+	// if logging of the AST is requested, do that
+	if (gEidosLogAST)
+	{
+		std::cout << "AST : \n";
+		this->PrintAST(std::cout);
+	}
+	
+	// restore error tracking
+	gEidosErrorContext.currentScript = current_script_save;
+	
+	return true;
+}
+
 void EidosScript::PrintTokens(std::ostream &p_outstream) const
 {
 	if (token_stream_.size())
@@ -86,6 +86,12 @@ public:
 	// generate AST from token stream for an interpreter block ( statement* EOF )
 	void ParseInterpreterBlockToAST(bool p_allow_functions, bool p_make_bad_nodes = false);
 	
+	// generate token stream and AST by copying a compound statement that p_source_script has already parsed, as a faster
+	// alternative to Tokenize() and ParseInterpreterBlockToAST(false); our script string must be that of p_source_node's
+	// token, as for a user-defined function body.  Returns false, leaving us untouched, if p_source_node did not come
+	// from p_source_script's token stream; the caller should then fall back to tokenizing and parsing.
+	bool CopyCompoundStatementFromScript(const EidosScript &p_source_script, const EidosASTNode *p_source_node);
+	
 	void PrintTokens(std::ostream &p_outstream) const;
 	void PrintAST(std::ostream &p_outstream) const;
 	
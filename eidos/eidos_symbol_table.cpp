@@ -125,11 +125,16 @@ void FreeSymbolTablePool(void)
 #pragma mark EidosSymbolTable
 #pragma mark -
 
+uint64_t EidosSymbolTable::s_constants_epoch_ = 1;
+uint64_t EidosSymbolTable::s_next_table_serial_ = 1;
+
 EidosSymbolTable::EidosSymbolTable(EidosSymbolTableType p_table_type, EidosSymbolTable *p_parent_table) : table_type_(p_table_type),
 	table_type_is_constant_((p_table_type != EidosSymbolTableType::kGlobalVariablesTable) && (p_table_type != EidosSymbolTableType::kLocalVariablesTable))
 {
 	THREAD_SAFETY_IN_ACTIVE_PARALLEL("EidosSymbolTable::EidosSymbolTable(): usage of statics");
 	
+	serial_ = s_next_table_serial_++;
+	
 	// allocate the lookup table
 	slots_ = GetZeroedTableFromPool(&capacity_);
 	
@@ -206,6 +211,9 @@ EidosSymbolTable::~EidosSymbolTable(void)
 	if (table_type_ == EidosSymbolTableType::kINVALID_TABLE_TYPE)
 		EIDOS_TERMINATION << "ERROR (EidosSymbolTable::~EidosSymbolTable): (internal error) zombie symbol table being destructed." << EidosTerminate(nullptr);
 	
+	if (bound_through_)
+		s_constants_epoch_++;
+	
 	table_type_ = EidosSymbolTableType::kINVALID_TABLE_TYPE;
 	
 	// slots_ may have symbols defined in it, so we need to zero out the used slots for re-use.  Remember that
@@ -402,6 +410,70 @@ EidosValue *EidosSymbolTable::_GetValue_RAW(EidosGlobalStringID p_symbol_name, c
 	EIDOS_TERMINATION << "ERROR (EidosSymbolTable::_GetValue_RAW): undefined identifier " << EidosStringRegistry::StringForGlobalStringID(p_symbol_name) << "." << EidosTerminate(p_symbol_token);
 }
 
+EidosValue *EidosSymbolTable::_GetValue_RAW_NoRaise(EidosGlobalStringID p_symbol_name) const
+{
+	// This follows _GetValue_RAW() but returns nullptr for an undefined symbol
+	const EidosSymbolTable *current_table = this;
+	
+	do
+	{
+		// try the current table, if the symbol is within its capacity
+		if (p_symbol_name < current_table->capacity_)
+		{
+			EidosValue *slot_value = current_table->slots_[p_symbol_name].symbol_value_SP_.get();
+			
+			if (slot_value)
+				return slot_value;
+		}
+		
+		// We didn't get a hit, so try our chained table
+		current_table = current_table->chain_symbol_table_;
+	}
+	while (current_table);
+	
+	return nullptr;
+}
+
+EidosValue *EidosSymbolTable::_GetValue_RAW_Bind(const EidosASTNode *p_symbol_node) const
+{
+	// This continues GetValueRawOrNullForASTNode_Bound() up the chain past the first chained table, which the caller has
+	// already probed, binding p_symbol_node if the symbol is a constant.  Every table walked through is marked, so that a
+	// later change to it invalidates the binding.  Bindings are not made inside parallel regions, where other threads may
+	// be reading the node's binding (and the tables' marks) concurrently.
+	EidosGlobalStringID symbol_name = p_symbol_node->cached_stringID_;
+	const EidosSymbolTable *key_table = chain_symbol_table_->chain_symbol_table_;
+	const EidosSymbolTable *current_table = key_table;
+	bool may_bind = !omp_in_parallel();
+	
+	while (current_table)
+	{
+		if (may_bind)
+			current_table->bound_through_ = true;
+		
+		if (symbol_name < current_table->capacity_)
+		{
+			EidosValue *slot_value = current_table->slots_[symbol_name].symbol_value_SP_.get();
+			
+			if (slot_value)
+			{
+				if (current_table->table_type_is_constant_ && may_bind)
+				{
+					p_symbol_node->bound_symbol_key_table_ = key_table;
+					p_symbol_node->bound_symbol_key_serial_ = key_table->serial_;
+					p_symbol_node->bound_symbol_value_ = slot_value;
+					p_symbol_node->bound_symbol_epoch_ = s_constants_epoch_;
+				}
+				
+				return slot_value;
+			}
+		}
+		
+		current_table = current_table->chain_symbol_table_;
+	}
+	
+	return nullptr;
+}
+
 EidosValue_SP EidosSymbolTable::_GetValue_IsConstIsLocal(EidosGlobalStringID p_symbol_name, const EidosToken *p_symbol_token, bool *p_is_const, bool *p_is_local) const
 {
 	// This follows _GetValue() but provides the p_is_const and p_is_global flags
@@ -461,6 +533,9 @@ void EidosSymbolTable::SetValueForSymbol(EidosGlobalStringID p_symbol_name, Eido
 {
 	THREAD_SAFETY_IN_ACTIVE_PARALLEL("EidosSymbolTable::SetValueForSymbol(): symbol table change");
 	
+	if (bound_through_)
+		s_constants_epoch_++;
+	
 	// If we have the only reference to the value, we don't need to copy it; otherwise we copy, since we don't want to hold
 	// onto a reference that somebody else might modify under us (or that we might modify under them, with syntaxes like
 	// x[2]=...; and x=x+1;). If the value is invisible then we copy it, since the symbol table never stores invisible values.
@@ -497,6 +572,9 @@ void EidosSymbolTable::SetValueForSymbolNoCopy(EidosGlobalStringID p_symbol_name
 {
 	THREAD_SAFETY_IN_ACTIVE_PARALLEL("EidosSymbolTable::SetValueForSymbolNoCopy(): symbol table change");
 	
+	if (bound_through_)
+		s_constants_epoch_++;
+	
 	// So, this is a little weird.  SetValueForSymbol() copies the passed value, as explained in its comment above.
 	// If a few cases, however, we want to play funny games and prevent that copy from occurring so that we can munge
 	// values directly inside a value we just set in the symbol table.  Evaluate_For() is the worst offender in this
@@ -583,6 +661,9 @@ void EidosSymbolTable::DefineConstantForSymbol(EidosGlobalStringID p_symbol_name
 		for (patchTable = this; patchTable != definedConstantsTable; patchTable = patchTable->parent_symbol_table_)
 			if (patchTable->chain_symbol_table_ == intrinsicConstantsTable)
 				patchTable->chain_symbol_table_ = definedConstantsTable;
+		
+		// Chains that bindings were made through have changed, so invalidate all bindings
+		s_constants_epoch_++;
 	}
 	
 	// If we have the only reference to the value, we don't need to copy it; otherwise we copy, since we don't want to hold
@@ -657,6 +738,9 @@ void EidosSymbolTable::DefineConstantForSymbolNoCopy(EidosGlobalStringID p_symbo
 		for (patchTable = this; patchTable != definedConstantsTable; patchTable = patchTable->parent_symbol_table_)
 			if (patchTable->chain_symbol_table_ == intrinsicConstantsTable)
 				patchTable->chain_symbol_table_ = definedConstantsTable;
+		
+		// Chains that bindings were made through have changed, so invalidate all bindings
+		s_constants_epoch_++;
 	}
 	
 	// Now we have a private value, which we can mark as constant
@@ -740,6 +824,9 @@ void EidosSymbolTable::_RemoveSymbol(EidosGlobalStringID p_symbol_name, bool p_r
 			
 			slot->symbol_value_SP_.reset();
 			
+			if (bound_through_)
+				s_constants_epoch_++;
+			
 			// Now we need to fix the linked list, which is O(n): we have to find the previous entry that points to this entry
 			EidosGlobalStringID index = 0;
 			
@@ -783,6 +870,9 @@ void EidosSymbolTable::_InitializeConstantSymbolEntry(EidosGlobalStringID p_symb
 	if (p_symbol_name >= capacity_)
 		_ResizeToFitSymbol(p_symbol_name);
 	
+	if (bound_through_)
+		s_constants_epoch_++;
+	
 	// We assume that this symbol is not yet defined, for maximal set-up speed
 	slots_[p_symbol_name].symbol_value_SP_ = std::move(p_value);
 	slots_[p_symbol_name].next_ = slots_[0].next_;
@@ -135,11 +135,24 @@ private:
 	EidosSymbolTable *parent_symbol_table_ = nullptr;	// NOT OWNED unless the parent_symbol_table_owned_ flag is set
 	bool parent_symbol_table_owned_ = false;			// set to true if we own our parent table, which would be a defined-constants table
 	
+	// Identifier nodes cache the constant they last resolved to, keyed by the table the lookup walked from; see
+	// GetValueRawOrNullForASTNode_Bound().  Each table gets a unique serial_, so a table constructed at the address of a
+	// destroyed one never matches a stale binding.  Tables a binding walked through are marked bound_through_, and only
+	// modifying or destroying a marked table increments the epoch; per-callback tables are probed directly and never
+	// marked, so creating them does not invalidate anything.  Variables need no invalidation, since they can never shadow
+	// a constant.
+	static uint64_t s_constants_epoch_;
+	static uint64_t s_next_table_serial_;
+	uint64_t serial_;
+	mutable bool bound_through_ = false;
+	
 	// Utility methods called by the public methods to do the real work
 	std::vector<std::string> _SymbolNames(bool p_include_constants, bool p_include_variables) const;
 	EidosValue_SP _GetValue(EidosGlobalStringID p_symbol_name, const EidosToken *p_symbol_token) const;
 	EidosValue_SP _GetValue_SpecialRaise(EidosGlobalStringID p_symbol_name, const EidosToken *p_symbol_token) const;
 	EidosValue *_GetValue_RAW(EidosGlobalStringID p_symbol_name, const EidosToken *p_symbol_token) const;
+	EidosValue *_GetValue_RAW_NoRaise(EidosGlobalStringID p_symbol_name) const;
+	EidosValue *_GetValue_RAW_Bind(const EidosASTNode *p_symbol_node) const;
 	EidosValue_SP _GetValue_IsConstIsLocal(EidosGlobalStringID p_symbol_name, const EidosToken *p_symbol_token, bool *p_is_const, bool *p_is_local) const;
 	void _RemoveSymbol(EidosGlobalStringID p_symbol_name, bool p_remove_constant);
 	void _InitializeConstantSymbolEntry(EidosGlobalStringID p_symbol_name, EidosValue_SP p_value);
@@ -189,6 +202,50 @@ public:
 	inline __attribute__((always_inline)) EidosValue *GetValueRawOrRaiseForASTNode(const EidosASTNode *p_symbol_node) const { return _GetValue_RAW(p_symbol_node->cached_stringID_, p_symbol_node->token_); }
 	inline __attribute__((always_inline)) EidosValue *GetValueRawOrRaiseForSymbol(EidosGlobalStringID p_symbol_name) const { return _GetValue_RAW(p_symbol_name, nullptr); }
 	
+	// Get a value as an unwrapped EidosValue *, returning nullptr instead of raising if the symbol is undefined; this is for callers, like the
+	// bytecode interpreter, that fall back to another code path to produce the error
+	inline __attribute__((always_inline)) EidosValue *GetValueRawOrNullForSymbol(EidosGlobalStringID p_symbol_name) const { return _GetValue_RAW_NoRaise(p_symbol_name); }
+	
+	// Like GetValueRawOrNullForSymbol(), but uses the binding cached in an identifier node to skip walking the chain to a constant
+	// that the node resolved to before.  This table and the first table chained from it are always probed directly, since they
+	// are typically transient (a function's local variables, a callback's pseudo-parameters); the binding is keyed by the table
+	// after those, which is normally a long-lived one, so bindings survive across calls and callbacks.
+	inline __attribute__((always_inline)) EidosValue *GetValueRawOrNullForASTNode_Bound(const EidosASTNode *p_symbol_node) const
+	{
+		EidosGlobalStringID symbol_name = p_symbol_node->cached_stringID_;
+		
+		if (symbol_name < capacity_)
+		{
+			EidosValue *slot_value = slots_[symbol_name].symbol_value_SP_.get();
+			
+			if (slot_value)
+				return slot_value;
+		}
+		
+		const EidosSymbolTable *first_table = chain_symbol_table_;
+		
+		if (!first_table)
+			return nullptr;
+		
+		if (symbol_name < first_table->capacity_)
+		{
+			EidosValue *slot_value = first_table->slots_[symbol_name].symbol_value_SP_.get();
+			
+			if (slot_value)
+				return slot_value;
+		}
+		
+		const EidosSymbolTable *key_table = first_table->chain_symbol_table_;
+		
+		if (!key_table)
+			return nullptr;
+		
+		if ((p_symbol_node->bound_symbol_key_table_ == key_table) && (p_symbol_node->bound_symbol_key_serial_ == key_table->serial_) && (p_symbol_node->bound_symbol_epoch_ == s_constants_epoch_))
+			return p_symbol_node->bound_symbol_value_;
+		
+		return _GetValue_RAW_Bind(p_symbol_node);
+	}
+	
 	// Special getters that return a boolean flag, true if the fetched symbol is a constant
 	inline __attribute__((always_inline)) EidosValue_SP GetValueOrRaiseForASTNode_IsConstIsLocal(const EidosASTNode *p_symbol_node, bool *p_is_const, bool *p_is_local) const { return _GetValue_IsConstIsLocal(p_symbol_node->cached_stringID_, p_symbol_node->token_, p_is_const, p_is_local); }
 	inline __attribute__((always_inline)) EidosValue_SP GetValueOrRaiseForSymbol_IsConstIsLocal(EidosGlobalStringID p_symbol_name, bool *p_is_const, bool *p_is_local) const { return _GetValue_IsConstIsLocal(p_symbol_name, nullptr, p_is_const, p_is_local); }
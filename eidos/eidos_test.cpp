@@ -345,6 +345,7 @@ int RunEidosTests(void)
 	_RunOperatorLogicalOrTests();
 	_RunOperatorLogicalNotTests();
 	_RunOperatorTernaryConditionalTests();
+	_RunOperatorBytecodeTests();
 	_RunKeywordIfTests();
 	_RunKeywordDoTests();
 	_RunKeywordWhileTests();
@@ -98,6 +98,7 @@ extern void _RunOperatorLogicalAndTests(void);
 extern void _RunOperatorLogicalOrTests(void);
 extern void _RunOperatorLogicalNotTests(void);
 extern void _RunOperatorTernaryConditionalTests(void);
+extern void _RunOperatorBytecodeTests(void);
 extern void _RunKeywordIfTests(void);
 extern void _RunKeywordDoTests(void);
 extern void _RunKeywordWhileTests(void);
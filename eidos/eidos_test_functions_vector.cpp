@@ -71,6 +71,11 @@ void _RunFunctionVectorConstructionTests_a_through_r(void)
 	EidosAssertScriptSuccess("c(object(), _Test(7)[F]);", EidosValue_SP(new (gEidosValuePool->AllocateChunk()) EidosValue_Object(gEidosTestElement_Class)));
 	EidosAssertScriptSuccess("c(_Test(7)[F], object());", EidosValue_SP(new (gEidosValuePool->AllocateChunk()) EidosValue_Object(gEidosTestElement_Class)));
 	
+	// growth across the inline, pooled, and malloced storage of integer and float vectors
+	EidosAssertScriptSuccess_L("x = 0; for (i in 1:200) { x = c(x, i); if (!identical(x, 0:i)) stop(); } y = c(x, x); identical(y[199:202], c(199, 200, 0, 1));", true);
+	EidosAssertScriptSuccess_L("x = 0.0; for (i in 1:200) { x = c(x, i * 0.5); if (!identical(x, (0:i) * 0.5)) stop(); } identical(x[c(0, 1, 2, 3, 64, 65, 200)], c(0, 1, 2, 3, 64, 65, 200) * 0.5);", true);
+	EidosAssertScriptSuccess_L("x = integer(0); for (i in 1:20) { v = c(i, -i); x = c(x, v); } identical(x, c(rbind(1:20, -(1:20))));", true);
+	
 	// float()
 	EidosAssertScriptSuccess("float(0);", gStaticEidosValue_Float_ZeroVec);
 	EidosAssertScriptSuccess("float(1);", gStaticEidosValue_Float0);
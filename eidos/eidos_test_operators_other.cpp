@@ -439,6 +439,18 @@ void _RunOperatorAssignTests(void)
 	EidosAssertScriptSuccess_L("function (void)mod(void) { defineGlobal('x', rbind(x, 2)); } x = 1; mod(); identical(x, rbind(1, 2));", true);
 	EidosAssertScriptSuccess_L("function (void)mod(void) { defineGlobal('x', rbind(x, 2.0)); } x = 1.0; mod(); identical(x, rbind(1.0, 2.0));", true);
 	
+	// long vectors are shared copy-on-write by assignment, argument passing, and contiguous subsets; modifying any sharer must not affect the others
+	EidosAssertScriptSuccess_L("x = 0:999; y = x; x[0] = -1; y[999] = -2; (x[0] == -1) & (x[999] == 999) & (y[0] == 0) & (y[999] == -2);", true);
+	EidosAssertScriptSuccess_L("x = (0:999) * 0.5; y = x; x = x + 1; y[1] = 7.0; (x[1] == 1.5) & (y[1] == 7.0) & (y[2] == 1.0);", true);
+	EidosAssertScriptSuccess_L("function (i)mod(i v) { v[0] = 100; v = c(v, 5); return v; } x = 0:999; y = mod(x); (x[0] == 0) & (size(x) == 1000) & (y[0] == 100) & (size(y) == 1001);", true);
+	EidosAssertScriptSuccess_L("x = 0:999; y = x[100:899]; z = y[0:199]; y[0] = -1; x[100] = -2; (z[0] == 100) & (y[0] == -1) & (y[1] == 101) & (x[100] == -2) & identical(z, 100:299);", true);
+	EidosAssertScriptSuccess_L("x = (0:999) * 1.0; y = x[500:999]; x = NULL; y = c(y, 1000.0); identical(y, (500:1000) * 1.0);", true);
+	EidosAssertScriptSuccess_L("x = 0:999; y = x[10:209]; y = sort(y, ascending=F); identical(y, 209:10) & identical(x, 0:999);", true);
+	EidosAssertScriptSuccess_L("x = matrix(0:999, nrow=10); y = x; y[0, 0] = 5; (x[0, 0] == 0) & (y[0, 0] == 5) & identical(dim(y), c(10, 100));", true);
+	EidosAssertScriptSuccess_L("x = 0:999; for (i in 1:3) { y = x; x[i] = -i; } identical(y[0:3], c(0, -1, -2, 3)) & identical(x[0:3], c(0, -1, -2, -3));", true);
+	EidosAssertScriptSuccess_L("x = 0:99999; y = x[10:209]; x[10] = -1; y[1] = -2; (x[10] == -1) & (x[11] == 11) & (y[0] == 10) & (y[1] == -2) & identical(y[2:199], 12:209);", true);	// a short slice of a long vector is copied, not shared
+	EidosAssertScriptSuccess_L("x = (0:99999) * 1.0; y = x[10:99999]; x[10] = -1.0; (x[10] == -1.0) & (y[0] == 10.0) & identical(y, (10:99999) * 1.0);", true);
+	
 #if EIDOS_HAS_OVERFLOW_BUILTINS
 	EidosAssertScriptRaise("x = 5e18; x = x + 5e18;", 16, "overflow with the binary");
 	EidosAssertScriptRaise("x = c(5e18, 0); x = x + 5e18;", 22, "overflow with the binary");
@@ -752,6 +764,60 @@ void _RunOperatorTernaryConditionalTests(void)
 	// test right-associativity; this produces 2 if ? else is left-associative since the left half would then evaluate to 1, which is T
 	EidosAssertScriptSuccess_I("a = 0; a == 0 ? 1 else a == 1 ? 2 else 4;", 1);
 }
+
+#pragma mark operator bytecode
+void _RunOperatorBytecodeTests(void)
+{
+	// scalar expressions on variables run as register bytecode; these exercise its type rules and its fallback to the tree walker
+	EidosAssertScriptSuccess_I("x = 5; y = 2; x + y * 3 - 1;", 10);
+	EidosAssertScriptSuccess_I("x = 5; -x;", -5);
+	EidosAssertScriptSuccess_F("x = 5; y = 2; x / y;", 2.5);
+	EidosAssertScriptSuccess_F("x = 5; y = 2; x % y;", 1.0);
+	EidosAssertScriptSuccess_F("x = 5; y = 2; x ^ y;", 25.0);
+	EidosAssertScriptSuccess_F("x = 5; y = 0.5; x * y + 1;", 3.5);
+	EidosAssertScriptSuccess_L("x = 3; y = 1.5; (x * y > 4) & (x != 2) | F;", true);
+	EidosAssertScriptSuccess_L("x = T; y = 1; x == y;", true);
+	EidosAssertScriptSuccess_L("x = T; y = 0.5; x > y;", true);
+	EidosAssertScriptSuccess_L("x = 7; y = 0.0; x & !y;", true);
+	EidosAssertScriptSuccess_L("x = NAN; x == x;", false);
+	EidosAssertScriptSuccess_L("x = matrix(5); identical(x + 1, matrix(6));", true);
+	EidosAssertScriptSuccess_L("x = 1:3; identical(x * 2 + 1, c(3, 5, 7));", true);
+	EidosAssertScriptSuccess_S("x = 'a'; x + 1;", "a1");
+	EidosAssertScriptSuccess_I("s = 0; for (i in 1:40) { x = (i % 2 == 0) ? 1:3 else i; s = s + sum(x * 2); } s;", 1040);
+	EidosAssertScriptSuccess_I("x = 1; x + 1 + (2 + (3 + (4 + (5 + (6 + (7 + (8 + (9 + (10 + (11 + (12 + (13 + (14 + (15 + (16 + (17 + (18 + (19 + (20)))))))))))))))))));", 211);
+	EidosAssertScriptRaise("x = 9223372036854775807; x + 1;", 27, "integer addition overflow");
+	EidosAssertScriptRaise("x = -9223372036854775807 - 1; -x;", 30, "integer negation overflow");
+	EidosAssertScriptRaise("x = 5; x * 3000000000000000000;", 9, "integer multiplication overflow");
+	EidosAssertScriptRaise("x = T; x + 1;", 9, "is not supported by the binary '+' operator");
+	EidosAssertScriptRaise("x = NAN; x & T;", 11, "cannot be converted");
+	EidosAssertScriptRaise("x = NAN; !x;", 9, "cannot be converted");
+	EidosAssertScriptRaise("y + 1;", 0, "undefined identifier");
+	
+	// elementwise expressions over vectors are fused into a single pass; these check that it matches the tree walker exactly
+	EidosAssertScriptSuccess_L("a = runif(1000); b = rnorm(1000); c = runif(1000); d = runif(1000, 0, 5); s = 2.5; x = a * b + c * exp(-d / s); identical(x, sapply(0:999, 'a[applyValue] * b[applyValue] + c[applyValue] * exp(-d[applyValue] / s);'));", true);
+	EidosAssertScriptSuccess_L("a = runif(1000, 1, 2); n = 3; x = sqrt(a) - log(a * n) / log10(a + 1) + log2(a) % (n - 1); y = sapply(a, 'sqrt(applyValue) - log(applyValue * n) / log10(applyValue + 1) + log2(applyValue) % (n - 1);'); identical(x, y);", true);
+	EidosAssertScriptSuccess_L("a = 1:1000; b = runif(1000); x = a * b - a / 7 + a ^ 2; identical(x, sapply(seqAlong(a), 'a[applyValue] * b[applyValue] - a[applyValue] / 7 + a[applyValue] ^ 2;'));", true);
+	EidosAssertScriptSuccess_L("a = c(1.0, 4.0, 9.0); identical(-sqrt(a) * 2, c(-2.0, -4.0, -6.0));", true);
+	EidosAssertScriptSuccess_L("a = 1:3; identical(a * 2 + 1, c(3, 5, 7));", true);
+	EidosAssertScriptSuccess_L("a = 1:3; b = c(0.5, 1.5, 2.5); identical(exp(a) * b, c(exp(1) * 0.5, exp(2) * 1.5, exp(3) * 2.5));", true);
+	EidosAssertScriptSuccess_L("a = matrix(c(1.0, 2.0)); identical(a * 2.0 + 1.0, matrix(c(3.0, 5.0)));", true);
+	EidosAssertScriptRaise("a = runif(3); b = runif(4); a * b + 1;", 30, "requires that either");
+	EidosAssertScriptRaise("a = c(9223372036854775807, 1); b = runif(2); (a + 1) * b;", 48, "integer addition overflow");
+	
+	// type-specialized evaluators; these are guarded, and fall back to the generic evaluator when an inferred type is wrong
+	EidosAssertScriptSuccess_L("x = rdunif(100, 0, 9); s = 0; for (i in 0:99) if (x[i] > 4) s = s + x[i]; s == sum(x[x > 4]);", true);
+	EidosAssertScriptSuccess_F("x = c(1, 2, 3); y = 0; for (i in 0:2) { y = y + x[i]; x = x + 0.5; } y;", 7.5);
+	EidosAssertScriptSuccess_IV("v = c(1, 2); a = v[0]; for (i in 0:1) { z = a + v[1]; a = v; } z;", {3, 4});
+	EidosAssertScriptSuccess_L("m = matrix(1:4, nrow=2); for (i in 0:1) z = m[i,i] * m[i,i]; identical(z, matrix(16));", true);
+	EidosAssertScriptSuccess_I("x = c(NAN, 1.0); n = 0; for (i in 0:1) if (x[i] == x[i]) n = n + 1; n;", 1);
+	EidosAssertScriptRaise("f = 9223372036854775807; y = c(1, 2); for (i in 0:1) z = f + y[i];", 59, "integer addition overflow");
+	
+	// property and method lookups cache their signature per call site; these check sites that see more than one class
+	EidosAssertScriptSuccess_IV("x = integer(0); for (i in 1:4) { o = (i % 2) ? Dictionary('a', i) else DataFrame('a', i); x = c(x, o.getValue('a'), size(o.allKeys)); } x;", {1, 1, 2, 1, 3, 1, 4, 1});
+	EidosAssertScriptSuccess_IV("x = integer(0); for (i in 1:4) { o = (i % 2) ? _Test(i) else c(_Test(i), _Test(-i)); o._yolk = o._yolk * 10; x = c(x, o._yolk); } x;", {10, 20, -20, 30, 40, -40});
+	EidosAssertScriptRaise("for (i in 1:2) { o = (i == 1) ? _Test(1) else Dictionary('a', 1); x = o._yolk; }", 72, "is not defined for object element type");
+	EidosAssertScriptRaise("for (i in 1:2) { o = (i == 1) ? _Test(1) else Dictionary('a', 1); o._yolk = 5; }", 68, "is not defined for object element type");
+}
 	
 	// ************************************************************************************
 	//
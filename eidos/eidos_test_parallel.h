@@ -369,6 +369,17 @@ if (!identical(y1, yN)) stop('parallel trunc(float x) failed test');
 
 // ***********************************************************************************************
 
+// fused elementwise arithmetic									// EIDOS_OMPMIN_FUSED_ARITH
+
+a = runif(1000000, -100, 100);
+b = runif(1000000, 0, 10);
+yN = a * b + sqrt(b) * exp(-a / 50);
+parallelSetNumThreads(1);
+y1 = a * b + sqrt(b) * exp(-a / 50);
+if (!identical(y1, yN)) stop('parallel fused elementwise arithmetic failed test');
+
+// ***********************************************************************************************
+
 // (integer$)sum(logical x)										// EIDOS_OMPMIN_SUM_LOGICAL
 
 x = asLogical(rdunif(1000000, 0, 1));
@@ -303,6 +303,75 @@ EidosTypeSpecifier EidosTypeInterpreter::_TypeEvaluate_MethodCall_Internal(const
 	return result_type;
 }
 
+static bool _EidosNodeIsPureOperand(const EidosASTNode *p_node)
+{
+	// Operands that can be evaluated a second time without observable effects: constants, identifiers, subsets, property
+	// reads, and arithmetic on those.  Calls and assignments are excluded, since they can have side effects.
+	switch (p_node->token_->token_type_)
+	{
+		case EidosTokenType::kTokenNumber:
+		case EidosTokenType::kTokenString:
+			return true;
+		case EidosTokenType::kTokenIdentifier:
+			return (p_node->children_.size() == 0);
+		case EidosTokenType::kTokenDot:
+			return ((p_node->children_.size() == 2) && _EidosNodeIsPureOperand(p_node->children_[0]) &&
+					(p_node->children_[1]->token_->token_type_ == EidosTokenType::kTokenIdentifier));
+		case EidosTokenType::kTokenLBracket:
+		case EidosTokenType::kTokenPlus:
+		case EidosTokenType::kTokenMinus:
+		case EidosTokenType::kTokenMult:
+		case EidosTokenType::kTokenDiv:
+		case EidosTokenType::kTokenMod:
+		case EidosTokenType::kTokenExp:
+			for (const EidosASTNode *child : p_node->children_)
+				if (!child || !_EidosNodeIsPureOperand(child))
+					return false;
+			return (p_node->children_.size() > 0);
+		default:
+			return false;
+	}
+}
+
+void EidosTypeInterpreter::_SpecializeBinaryOperator(const EidosASTNode *p_node, const EidosTypeSpecifier &p_first_child_type, const EidosTypeSpecifier &p_second_child_type)
+{
+	// If both operands are inferred to be integer, or both float, give the node an evaluator specialized for singletons of that
+	// type.  The inference is only a prediction – the type table is not flow-sensitive, and does not track singleton-ness – so
+	// the specialized evaluator checks its operands and falls back to the generic evaluator for good when the check fails.
+	// Nodes that already have a faster evaluator, such as bytecode, are left alone.
+	if ((p_node->children_.size() != 2) || (p_node->cached_evaluator_ != EidosInterpreter::GenericEvaluatorForSpecializedNode(p_node)))
+		return;
+	
+	EidosValueMask first_mask = (p_first_child_type.type_mask & kEidosValueMaskFlagStrip);
+	EidosValueMask second_mask = (p_second_child_type.type_mask & kEidosValueMaskFlagStrip);
+	EidosEvaluationMethod specialized_evaluator;
+	
+	if ((first_mask == kEidosValueMaskInt) && (second_mask == kEidosValueMaskInt))
+		specialized_evaluator = &EidosInterpreter::Evaluate_Specialized_IntInt;
+	else if ((first_mask == kEidosValueMaskFloat) && (second_mask == kEidosValueMaskFloat))
+		specialized_evaluator = &EidosInterpreter::Evaluate_Specialized_FloatFloat;
+	else
+		return;
+	
+	// a failed guard re-evaluates the operands through the generic evaluator, so they must be free of side effects
+	if (!_EidosNodeIsPureOperand(p_node->children_[0]) || !_EidosNodeIsPureOperand(p_node->children_[1]))
+		return;
+	
+	p_node->cached_evaluator_ = specialized_evaluator;
+}
+
+void EidosTypeInterpreter::_SpecializeComparison(const EidosASTNode *p_node)
+{
+	// comparisons always produce logical, so their operands are type-evaluated only when specializing
+	if (p_node->children_.size() == 2)
+	{
+		EidosTypeSpecifier first_child_type = TypeEvaluateNode(p_node->children_[0]);
+		EidosTypeSpecifier second_child_type = TypeEvaluateNode(p_node->children_[1]);
+		
+		_SpecializeBinaryOperator(p_node, first_child_type, second_child_type);
+	}
+}
+
 void EidosTypeInterpreter::_ProcessArgumentListTypes(const EidosASTNode *p_node, const EidosCallSignature *p_call_signature, std::vector<EidosASTNode *> &p_arguments)
 {
 	const std::vector<EidosASTNode *> &node_children = p_node->children_;
@@ -595,6 +664,9 @@ EidosTypeSpecifier EidosTypeInterpreter::TypeEvaluate_Plus(const EidosASTNode *p
 		EidosTypeSpecifier first_child_type = TypeEvaluateNode(p_node->children_[0]);
 		EidosTypeSpecifier second_child_type = TypeEvaluateNode(p_node->children_[1]);
 		
+		if (specialize_evaluators_)
+			_SpecializeBinaryOperator(p_node, first_child_type, second_child_type);
+		
 		if ((first_child_type.type_mask == kEidosValueMaskString) || (second_child_type.type_mask == kEidosValueMaskString))
 		{
 			result_type.type_mask = kEidosValueMaskString;
@@ -643,6 +715,9 @@ EidosTypeSpecifier EidosTypeInterpreter::TypeEvaluate_Minus(const EidosASTNode *
 		EidosTypeSpecifier first_child_type = TypeEvaluateNode(p_node->children_[0]);
 		EidosTypeSpecifier second_child_type = TypeEvaluateNode(p_node->children_[1]);
 		
+		if (specialize_evaluators_)
+			_SpecializeBinaryOperator(p_node, first_child_type, second_child_type);
+		
 		bool integer1 = !!(first_child_type.type_mask & kEidosValueMaskInt);
 		bool float1 = !!(first_child_type.type_mask & kEidosValueMaskFloat);
 		bool integer2 = !!(second_child_type.type_mask & kEidosValueMaskInt);
@@ -691,6 +766,9 @@ EidosTypeSpecifier EidosTypeInterpreter::TypeEvaluate_Mult(const EidosASTNode *p
 		EidosTypeSpecifier first_child_type = TypeEvaluateNode(p_node->children_[0]);
 		EidosTypeSpecifier second_child_type = TypeEvaluateNode(p_node->children_[1]);
 		
+		if (specialize_evaluators_)
+			_SpecializeBinaryOperator(p_node, first_child_type, second_child_type);
+		
 		bool integer1 = !!(first_child_type.type_mask & kEidosValueMaskInt);
 		bool float1 = !!(first_child_type.type_mask & kEidosValueMaskFloat);
 		bool integer2 = !!(second_child_type.type_mask & kEidosValueMaskInt);
@@ -854,49 +932,61 @@ EidosTypeSpecifier EidosTypeInterpreter::TypeEvaluate_Assign_R(const EidosASTNod
 
 EidosTypeSpecifier EidosTypeInterpreter::TypeEvaluate_Eq(const EidosASTNode *p_node)
 {
-#pragma unused(p_node)
 	EidosTypeSpecifier result_type = EidosTypeSpecifier{kEidosValueMaskLogical, nullptr};
 	
+	if (specialize_evaluators_)
+		_SpecializeComparison(p_node);
+	
 	return result_type;
 }
 
 EidosTypeSpecifier EidosTypeInterpreter::TypeEvaluate_Lt(const EidosASTNode *p_node)
 {
-#pragma unused(p_node)
 	EidosTypeSpecifier result_type = EidosTypeSpecifier{kEidosValueMaskLogical, nullptr};
 	
+	if (specialize_evaluators_)
+		_SpecializeComparison(p_node);
+	
 	return result_type;
 }
 
 EidosTypeSpecifier EidosTypeInterpreter::TypeEvaluate_LtEq(const EidosASTNode *p_node)
 {
-#pragma unused(p_node)
 	EidosTypeSpecifier result_type = EidosTypeSpecifier{kEidosValueMaskLogical, nullptr};
 	
+	if (specialize_evaluators_)
+		_SpecializeComparison(p_node);
+	
 	return result_type;
 }
 
 EidosTypeSpecifier EidosTypeInterpreter::TypeEvaluate_Gt(const EidosASTNode *p_node)
 {
-#pragma unused(p_node)
 	EidosTypeSpecifier result_type = EidosTypeSpecifier{kEidosValueMaskLogical, nullptr};
 	
+	if (specialize_evaluators_)
+		_SpecializeComparison(p_node);
+	
 	return result_type;
 }
 
 EidosTypeSpecifier EidosTypeInterpreter::TypeEvaluate_GtEq(const EidosASTNode *p_node)
 {
-#pragma unused(p_node)
 	EidosTypeSpecifier result_type = EidosTypeSpecifier{kEidosValueMaskLogical, nullptr};
 	
+	if (specialize_evaluators_)
+		_SpecializeComparison(p_node);
+	
 	return result_type;
 }
 
 EidosTypeSpecifier EidosTypeInterpreter::TypeEvaluate_NotEq(const EidosASTNode *p_node)
 {
-#pragma unused(p_node)
 	EidosTypeSpecifier result_type = EidosTypeSpecifier{kEidosValueMaskLogical, nullptr};
 	
+	if (specialize_evaluators_)
+		_SpecializeComparison(p_node);
+	
 	return result_type;
 }
 
@@ -941,6 +1031,10 @@ EidosTypeSpecifier EidosTypeInterpreter::TypeEvaluate_If(const EidosASTNode *p_n
 	
 	EidosTypeSpecifier result_type = EidosTypeSpecifier{kEidosValueMaskNone, nullptr};
 	
+	// the condition's type is not needed for code completion, but evaluating it lets its operators be specialized
+	if (specialize_evaluators_ && (children_size > 0))
+		TypeEvaluateNode(p_node->children_[0]);
+	
 	if (children_size > 1)
 	{
 		EidosASTNode *true_node = p_node->children_[1];
@@ -963,6 +1057,9 @@ EidosTypeSpecifier EidosTypeInterpreter::TypeEvaluate_Do(const EidosASTNode *p_n
 	if (p_node->children_.size() >= 1)
 		TypeEvaluateNode(p_node->children_[0]);
 	
+	if (specialize_evaluators_ && (p_node->children_.size() >= 2))
+		TypeEvaluateNode(p_node->children_[1]);
+	
 	return result_type;
 }
 
@@ -970,6 +1067,9 @@ EidosTypeSpecifier EidosTypeInterpreter::TypeEvaluate_While(const EidosASTNode *
 {
 	EidosTypeSpecifier result_type = EidosTypeSpecifier{kEidosValueMaskNone, nullptr};
 	
+	if (specialize_evaluators_ && (p_node->children_.size() >= 1))
+		TypeEvaluateNode(p_node->children_[0]);
+	
 	if (p_node->children_.size() >= 2)
 		TypeEvaluateNode(p_node->children_[1]);
 	
@@ -1197,6 +1297,7 @@ EidosTypeSpecifier EidosTypeInterpreter::TypeEvaluate_FunctionDecl(const EidosAS
 				EidosTypeInterpreter typeInterpreter(body_node, typeTable, function_map_, callTypeTable);
 				
 				typeInterpreter.SetExternalTypeTable(global_symbols_);		// defined constants/variables should also go into the global scope
+				typeInterpreter.SetSpecializeEvaluators(specialize_evaluators_);
 				typeInterpreter.TypeEvaluateNode(body_node);				// result not used
 			}
 		}
@@ -59,6 +59,9 @@ protected:
 	std::vector<std::string> *argument_completions_ = nullptr;
 	size_t script_length_ = 0;
 	
+	// for specializing the evaluators of AST nodes whose operand types are inferred; see _SpecializeBinaryOperator()
+	bool specialize_evaluators_ = false;
+	
 public:
 	
 	EidosTypeInterpreter(const EidosTypeInterpreter&) = delete;					// no copying
@@ -71,6 +74,7 @@ public:
 	virtual ~EidosTypeInterpreter(void);
 	
 	inline void SetExternalTypeTable(EidosTypeTable *p_external_type_table) { external_type_table_ = p_external_type_table; }	// to support local-scope type tables that are nested in the global scope
+	inline void SetSpecializeEvaluators(bool p_specialize) { specialize_evaluators_ = p_specialize; }	// used by EidosASTNode::_OptimizeTypeSpecializations()
 	
 	inline __attribute__((always_inline)) EidosTypeTable &SymbolTable(void) { return *global_symbols_; };	// the returned reference is to the symbol table that the interpreter has borrowed
 	inline __attribute__((always_inline)) EidosFunctionMap &FunctionMap(void) { return function_map_; };	// the returned reference is to the function map that the interpreter has borrowed
@@ -126,6 +130,10 @@ public:
 	
 	virtual EidosTypeSpecifier _TypeEvaluate_MethodCall_Internal(const EidosClass *p_target, const EidosMethodSignature *p_method_signature, const std::vector<EidosASTNode *> &p_arguments);
 	
+	// Evaluator specialization, when enabled with SetSpecializeEvaluators()
+	void _SpecializeBinaryOperator(const EidosASTNode *p_node, const EidosTypeSpecifier &p_first_child_type, const EidosTypeSpecifier &p_second_child_type);
+	void _SpecializeComparison(const EidosASTNode *p_node);
+	
 	// Argument processing; handles default arguments and named arguments
 	void _ProcessArgumentListTypes(const EidosASTNode *p_node, const EidosCallSignature *p_call_signature, std::vector<EidosASTNode *> &p_arguments);
 };
@@ -35,6 +35,10 @@
 // The global object pool for EidosValue, initialized in Eidos_WarmUp()
 EidosObjectPool *gEidosValuePool = nullptr;
 
+// Free lists for the recycled buffers of EidosValue_Int and EidosValue_Float, by size class; see Eidos_AllocateValueBuffer()
+void *gEidosValueBufferFreeList[EIDOS_VALUE_BUFFER_CLASS_COUNT] = {nullptr, nullptr, nullptr, nullptr, nullptr};
+size_t gEidosValueBufferFreeCount[EIDOS_VALUE_BUFFER_CLASS_COUNT] = {0, 0, 0, 0, 0};
+
 
 //
 //	Global static EidosValue objects; these are effectively const, although EidosValues can't be declared as const.
@@ -371,6 +375,11 @@ void EidosValue::RaiseForRangeViolation(void) const
 	EIDOS_TERMINATION << "ERROR (EidosValue::RaiseForRangeViolation): (internal error) access violated the current size of an EidosValue." << EidosTerminate(nullptr);
 }
 
+void EidosValue::RaiseForSharedBufferViolation(void) const
+{
+	EIDOS_TERMINATION << "ERROR (EidosValue::RaiseForSharedBufferViolation): (internal error) unchecked write to the shared buffer of an EidosValue." << EidosTerminate(nullptr);
+}
+
 void EidosValue::RaiseForRetainReleaseViolation(void) const
 {
 	EIDOS_TERMINATION << "ERROR (EidosValue::RaiseForRetainReleaseViolation): (internal error) access violated the retain/release policy of an EidosValue." << EidosTerminate(nullptr);
@@ -1276,7 +1285,7 @@ void EidosValue_String::Sort(bool p_ascending)
 #pragma mark EidosValue_Int
 #pragma mark -
 
-EidosValue_Int::EidosValue_Int(const std::vector<int16_t> &p_intvec) : EidosValue(EidosValueType::kValueInt), values_(&singleton_value_), count_(0), capacity_(1)
+EidosValue_Int::EidosValue_Int(const std::vector<int16_t> &p_intvec) : EidosValue(EidosValueType::kValueInt), values_(inline_values_), count_(0), capacity_(EIDOS_VALUE_INLINE_CAPACITY)
 {
 	size_t count = p_intvec.size();
 	const int16_t *values = p_intvec.data();
@@ -1287,7 +1296,7 @@ EidosValue_Int::EidosValue_Int(const std::vector<int16_t> &p_intvec) : EidosValu
 		set_int_no_check(values[index], index);
 }
 
-EidosValue_Int::EidosValue_Int(const std::vector<int32_t> &p_intvec) : EidosValue(EidosValueType::kValueInt), values_(&singleton_value_), count_(0), capacity_(1)
+EidosValue_Int::EidosValue_Int(const std::vector<int32_t> &p_intvec) : EidosValue(EidosValueType::kValueInt), values_(inline_values_), count_(0), capacity_(EIDOS_VALUE_INLINE_CAPACITY)
 {
 	size_t count = p_intvec.size();
 	const int32_t *values = p_intvec.data();
@@ -1298,7 +1307,7 @@ EidosValue_Int::EidosValue_Int(const std::vector<int32_t> &p_intvec) : EidosValu
 		set_int_no_check(values[index], index);
 }
 
-EidosValue_Int::EidosValue_Int(const std::vector<int64_t> &p_intvec) : EidosValue(EidosValueType::kValueInt), values_(&singleton_value_), count_(0), capacity_(1)
+EidosValue_Int::EidosValue_Int(const std::vector<int64_t> &p_intvec) : EidosValue(EidosValueType::kValueInt), values_(inline_values_), count_(0), capacity_(EIDOS_VALUE_INLINE_CAPACITY)
 {
 	size_t count = p_intvec.size();
 	const int64_t *values = p_intvec.data();
@@ -1309,7 +1318,7 @@ EidosValue_Int::EidosValue_Int(const std::vector<int64_t> &p_intvec) : EidosValu
 		set_int_no_check(values[index], index);
 }
 
-EidosValue_Int::EidosValue_Int(std::initializer_list<int64_t> p_init_list) : EidosValue(EidosValueType::kValueInt), values_(&singleton_value_), count_(0), capacity_(1)
+EidosValue_Int::EidosValue_Int(std::initializer_list<int64_t> p_init_list) : EidosValue(EidosValueType::kValueInt), values_(inline_values_), count_(0), capacity_(EIDOS_VALUE_INLINE_CAPACITY)
 {
 	reserve(p_init_list.size());
 	
@@ -1317,7 +1326,7 @@ EidosValue_Int::EidosValue_Int(std::initializer_list<int64_t> p_init_list) : Eid
 		push_int_no_check(init_item);
 }
 
-EidosValue_Int::EidosValue_Int(const int64_t *p_values, size_t p_count) : EidosValue(EidosValueType::kValueInt), values_(&singleton_value_), count_(0), capacity_(1)
+EidosValue_Int::EidosValue_Int(const int64_t *p_values, size_t p_count) : EidosValue(EidosValueType::kValueInt), values_(inline_values_), count_(0), capacity_(EIDOS_VALUE_INLINE_CAPACITY)
 {
 	resize_no_initialize(p_count);
 	
@@ -1413,9 +1422,80 @@ EidosValue_SP EidosValue_Int::GetValueAtIndex(const int p_idx, const EidosToken
 EidosValue_SP EidosValue_Int::CopyValues(void) const
 {
 	// note that constness, invisibility, etc. do not get copied
+	// long vectors share our buffer, copy-on-write, rather than being copied; see EidosValueBufferShare
+	if ((count_ > EIDOS_VALUE_BUFFER_MAX_POOLED) && CanShareSlice(count_))
+		return EidosValue_SP(SharedSlice(0, count_)->CopyDimensionsFromValue(this));
+	
 	return EidosValue_SP((new (gEidosValuePool->AllocateChunk()) EidosValue_Int(values_, count_))->CopyDimensionsFromValue(this));
 }
 
+EidosValue_Int_SP EidosValue_Int::SharedSlice(size_t p_offset, size_t p_count) const
+{
+	THREAD_SAFETY_IN_ACTIVE_PARALLEL("EidosValue_Int::SharedSlice(): value buffer share change");
+	
+#if DEBUG
+	if (!CanShareSlice(p_count) || (p_offset + p_count > count_))
+		EIDOS_TERMINATION << "ERROR (EidosValue_Int::SharedSlice): (internal error) buffer cannot be shared." << EidosTerminate(nullptr);
+#endif
+	
+	// Sharing changes how our buffer is owned, but not our values, so it is legal for a const (and even a constant) value
+	EidosValue_Int *mutable_this = const_cast<EidosValue_Int *>(this);
+	
+	if (!buffer_shared_)
+	{
+		mutable_this->buffer_share_ = new EidosValueBufferShare{values_, capacity_, 1};
+		mutable_this->buffer_shared_ = true;
+	}
+	
+	EidosValue_Int *slice = new (gEidosValuePool->AllocateChunk()) EidosValue_Int();
+	
+	slice->buffer_share_ = buffer_share_;
+	slice->buffer_shared_ = true;
+	slice->values_ = values_ + p_offset;
+	slice->count_ = p_count;
+	slice->capacity_ = p_count;
+	buffer_share_->refcount_++;
+	
+	return EidosValue_Int_SP(slice);
+}
+
+void EidosValue_Int::_UnshareBuffer(void)
+{
+	THREAD_SAFETY_IN_ACTIVE_PARALLEL("EidosValue_Int::_UnshareBuffer(): value buffer share change");
+	
+	EidosValueBufferShare *share = buffer_share_;
+	
+	buffer_shared_ = false;
+	
+	if ((share->refcount_ == 1) && (values_ == share->buffer_))
+	{
+		// we are the last user of the whole buffer, so we just take it back
+		capacity_ = share->capacity_;
+		delete share;
+		return;
+	}
+	
+	// otherwise, we copy the elements we use into storage of our own, and release the shared buffer
+	int64_t *shared_values = values_;
+	
+	if (count_ <= EIDOS_VALUE_INLINE_CAPACITY)
+	{
+		values_ = inline_values_;
+		capacity_ = EIDOS_VALUE_INLINE_CAPACITY;
+	}
+	else
+	{
+		values_ = (int64_t *)Eidos_AllocateValueBuffer(count_, &capacity_);
+		
+		if (!values_)
+			EIDOS_TERMINATION << "ERROR (EidosValue_Int::_UnshareBuffer): allocation failed; you may need to raise the memory limit for SLiM." << EidosTerminate(nullptr);
+	}
+	
+	memcpy(values_, shared_values, count_ * sizeof(int64_t));
+	
+	Eidos_ReleaseValueBufferShare(share);
+}
+
 void EidosValue_Int::PushValueFromIndexOfEidosValue(int p_idx, const EidosValue &p_source_script_value, const EidosToken *p_blame_token)
 {
 	WILL_MODIFY(this);
@@ -1429,6 +1509,7 @@ void EidosValue_Int::PushValueFromIndexOfEidosValue(int p_idx, const EidosValue
 void EidosValue_Int::Sort(bool p_ascending)
 {
 	WILL_MODIFY(this);
+	WILL_MODIFY_BUFFER(this);
 	
 	if (count_ < 2)
 		return;
@@ -1440,29 +1521,37 @@ void EidosValue_Int::Sort(bool p_ascending)
 EidosValue_Int *EidosValue_Int::reserve(size_t p_reserved_size)
 {
 	WILL_MODIFY(this);
+	WILL_MODIFY_BUFFER(this);
 	
 	if (p_reserved_size > capacity_)
 	{
-		// this is a reservation for an explicit size, so we give that size exactly, to avoid wasting space
-		
-		if (values_ == &singleton_value_)
+		// this is a reservation for an explicit size, so we give that size exactly, to avoid wasting space; small buffers are
+		// rounded up to a size class, though, so they can be recycled; see Eidos_AllocateValueBuffer()
+		if ((values_ != inline_values_) && (capacity_ > EIDOS_VALUE_BUFFER_MAX_POOLED))
 		{
-			values_ = (int64_t *)malloc(p_reserved_size * sizeof(int64_t));
+			values_ = (int64_t *)realloc(values_, p_reserved_size * sizeof(int64_t));
 			
 			if (!values_)
 				EIDOS_TERMINATION << "ERROR (EidosValue_Int::reserve): allocation failed; you may need to raise the memory limit for SLiM." << EidosTerminate(nullptr);
 			
-			values_[0] = singleton_value_;
+			capacity_ = p_reserved_size;
 		}
 		else
 		{
-			values_ = (int64_t *)realloc(values_, p_reserved_size * sizeof(int64_t));
+			size_t new_capacity;
+			int64_t *new_values = (int64_t *)Eidos_AllocateValueBuffer(p_reserved_size, &new_capacity);
 			
-			if (!values_)
+			if (!new_values)
 				EIDOS_TERMINATION << "ERROR (EidosValue_Int::reserve): allocation failed; you may need to raise the memory limit for SLiM." << EidosTerminate(nullptr);
+			
+			memcpy(new_values, values_, capacity_ * sizeof(int64_t));
+			
+			if (values_ != inline_values_)
+				Eidos_FreeValueBuffer(values_, capacity_);
+			
+			values_ = new_values;
+			capacity_ = new_capacity;
 		}
-		
-		capacity_ = p_reserved_size;
 	}
 	
 	return this;
@@ -1471,6 +1560,7 @@ EidosValue_Int *EidosValue_Int::reserve(size_t p_reserved_size)
 void EidosValue_Int::erase_index(size_t p_index)
 {
 	WILL_MODIFY(this);
+	WILL_MODIFY_BUFFER(this);
 	
 	if (p_index >= count_)
 		RaiseForRangeViolation();
@@ -1498,7 +1588,7 @@ void EidosValue_Int::erase_index(size_t p_index)
 #pragma mark EidosValue_Float
 #pragma mark -
 
-EidosValue_Float::EidosValue_Float(const std::vector<double> &p_doublevec) : EidosValue(EidosValueType::kValueFloat), values_(&singleton_value_), count_(0), capacity_(1)
+EidosValue_Float::EidosValue_Float(const std::vector<double> &p_doublevec) : EidosValue(EidosValueType::kValueFloat), values_(inline_values_), count_(0), capacity_(EIDOS_VALUE_INLINE_CAPACITY)
 {
 	size_t count = p_doublevec.size();
 	const double *values = p_doublevec.data();
@@ -1509,7 +1599,7 @@ EidosValue_Float::EidosValue_Float(const std::vector<double> &p_doublevec) : Eid
 		set_float_no_check(values[index], index);
 }
 
-EidosValue_Float::EidosValue_Float(std::initializer_list<double> p_init_list) : EidosValue(EidosValueType::kValueFloat), values_(&singleton_value_), count_(0), capacity_(1)
+EidosValue_Float::EidosValue_Float(std::initializer_list<double> p_init_list) : EidosValue(EidosValueType::kValueFloat), values_(inline_values_), count_(0), capacity_(EIDOS_VALUE_INLINE_CAPACITY)
 {
 	reserve(p_init_list.size());
 	
@@ -1517,7 +1607,7 @@ EidosValue_Float::EidosValue_Float(std::initializer_list<double> p_init_list) :
 		push_float_no_check(init_item);
 }
 
-EidosValue_Float::EidosValue_Float(const double *p_values, size_t p_count) : EidosValue(EidosValueType::kValueFloat), values_(&singleton_value_), count_(0), capacity_(1)
+EidosValue_Float::EidosValue_Float(const double *p_values, size_t p_count) : EidosValue(EidosValueType::kValueFloat), values_(inline_values_), count_(0), capacity_(EIDOS_VALUE_INLINE_CAPACITY)
 {
 	resize_no_initialize(p_count);
 	
@@ -1627,9 +1717,80 @@ EidosValue_SP EidosValue_Float::GetValueAtIndex(const int p_idx, const EidosToke
 EidosValue_SP EidosValue_Float::CopyValues(void) const
 {
 	// note that constness, invisibility, etc. do not get copied
+	// long vectors share our buffer, copy-on-write, rather than being copied; see EidosValueBufferShare
+	if ((count_ > EIDOS_VALUE_BUFFER_MAX_POOLED) && CanShareSlice(count_))
+		return EidosValue_SP(SharedSlice(0, count_)->CopyDimensionsFromValue(this));
+	
 	return EidosValue_SP((new (gEidosValuePool->AllocateChunk()) EidosValue_Float(values_, count_))->CopyDimensionsFromValue(this));
 }
 
+EidosValue_Float_SP EidosValue_Float::SharedSlice(size_t p_offset, size_t p_count) const
+{
+	THREAD_SAFETY_IN_ACTIVE_PARALLEL("EidosValue_Float::SharedSlice(): value buffer share change");
+	
+#if DEBUG
+	if (!CanShareSlice(p_count) || (p_offset + p_count > count_))
+		EIDOS_TERMINATION << "ERROR (EidosValue_Float::SharedSlice): (internal error) buffer cannot be shared." << EidosTerminate(nullptr);
+#endif
+	
+	// Sharing changes how our buffer is owned, but not our values, so it is legal for a const (and even a constant) value
+	EidosValue_Float *mutable_this = const_cast<EidosValue_Float *>(this);
+	
+	if (!buffer_shared_)
+	{
+		mutable_this->buffer_share_ = new EidosValueBufferShare{values_, capacity_, 1};
+		mutable_this->buffer_shared_ = true;
+	}
+	
+	EidosValue_Float *slice = new (gEidosValuePool->AllocateChunk()) EidosValue_Float();
+	
+	slice->buffer_share_ = buffer_share_;
+	slice->buffer_shared_ = true;
+	slice->values_ = values_ + p_offset;
+	slice->count_ = p_count;
+	slice->capacity_ = p_count;
+	buffer_share_->refcount_++;
+	
+	return EidosValue_Float_SP(slice);
+}
+
+void EidosValue_Float::_UnshareBuffer(void)
+{
+	THREAD_SAFETY_IN_ACTIVE_PARALLEL("EidosValue_Float::_UnshareBuffer(): value buffer share change");
+	
+	EidosValueBufferShare *share = buffer_share_;
+	
+	buffer_shared_ = false;
+	
+	if ((share->refcount_ == 1) && (values_ == share->buffer_))
+	{
+		// we are the last user of the whole buffer, so we just take it back
+		capacity_ = share->capacity_;
+		delete share;
+		return;
+	}
+	
+	// otherwise, we copy the elements we use into storage of our own, and release the shared buffer
+	double *shared_values = values_;
+	
+	if (count_ <= EIDOS_VALUE_INLINE_CAPACITY)
+	{
+		values_ = inline_values_;
+		capacity_ = EIDOS_VALUE_INLINE_CAPACITY;
+	}
+	else
+	{
+		values_ = (double *)Eidos_AllocateValueBuffer(count_, &capacity_);
+		
+		if (!values_)
+			EIDOS_TERMINATION << "ERROR (EidosValue_Float::_UnshareBuffer): allocation failed; you may need to raise the memory limit for SLiM." << EidosTerminate(nullptr);
+	}
+	
+	memcpy(values_, shared_values, count_ * sizeof(double));
+	
+	Eidos_ReleaseValueBufferShare(share);
+}
+
 void EidosValue_Float::PushValueFromIndexOfEidosValue(int p_idx, const EidosValue &p_source_script_value, const EidosToken *p_blame_token)
 {
 	WILL_MODIFY(this);
@@ -1643,6 +1804,7 @@ void EidosValue_Float::PushValueFromIndexOfEidosValue(int p_idx, const EidosValu
 void EidosValue_Float::Sort(bool p_ascending)
 {
 	WILL_MODIFY(this);
+	WILL_MODIFY_BUFFER(this);
 	
 	if (count_ < 2)
 		return;
@@ -1657,29 +1819,37 @@ void EidosValue_Float::Sort(bool p_ascending)
 EidosValue_Float *EidosValue_Float::reserve(size_t p_reserved_size)
 {
 	WILL_MODIFY(this);
+	WILL_MODIFY_BUFFER(this);
 	
 	if (p_reserved_size > capacity_)
 	{
-		// this is a reservation for an explicit size, so we give that size exactly, to avoid wasting space
-		
-		if (values_ == &singleton_value_)
+		// this is a reservation for an explicit size, so we give that size exactly, to avoid wasting space; small buffers are
+		// rounded up to a size class, though, so they can be recycled; see Eidos_AllocateValueBuffer()
+		if ((values_ != inline_values_) && (capacity_ > EIDOS_VALUE_BUFFER_MAX_POOLED))
 		{
-			values_ = (double *)malloc(p_reserved_size * sizeof(double));
+			values_ = (double *)realloc(values_, p_reserved_size * sizeof(double));
 			
 			if (!values_)
 				EIDOS_TERMINATION << "ERROR (EidosValue_Float::reserve): allocation failed; you may need to raise the memory limit for SLiM." << EidosTerminate(nullptr);
 			
-			values_[0] = singleton_value_;
+			capacity_ = p_reserved_size;
 		}
 		else
 		{
-			values_ = (double *)realloc(values_, p_reserved_size * sizeof(double));
+			size_t new_capacity;
+			double *new_values = (double *)Eidos_AllocateValueBuffer(p_reserved_size, &new_capacity);
 			
-			if (!values_)
+			if (!new_values)
 				EIDOS_TERMINATION << "ERROR (EidosValue_Float::reserve): allocation failed; you may need to raise the memory limit for SLiM." << EidosTerminate(nullptr);
+			
+			memcpy(new_values, values_, capacity_ * sizeof(double));
+			
+			if (values_ != inline_values_)
+				Eidos_FreeValueBuffer(values_, capacity_);
+			
+			values_ = new_values;
+			capacity_ = new_capacity;
 		}
-		
-		capacity_ = p_reserved_size;
 	}
 	
 	return this;
@@ -1688,6 +1858,7 @@ EidosValue_Float *EidosValue_Float::reserve(size_t p_reserved_size)
 void EidosValue_Float::erase_index(size_t p_index)
 {
 	WILL_MODIFY(this);
+	WILL_MODIFY_BUFFER(this);
 	
 	if (p_index >= count_)
 		RaiseForRangeViolation();
@@ -2144,9 +2315,14 @@ void EidosValue_Object::SortBy(const std::string &p_property, bool p_ascending)
 }
 
 EidosValue_SP EidosValue_Object::GetPropertyOfElements(EidosGlobalStringID p_property_id) const
+{
+	return GetPropertyOfElements(p_property_id, class_->SignatureForProperty(p_property_id));
+}
+
+EidosValue_SP EidosValue_Object::GetPropertyOfElements(EidosGlobalStringID p_property_id, const EidosPropertySignature *p_signature) const
 {
 	size_t values_size = count_;
-	const EidosPropertySignature *signature = class_->SignatureForProperty(p_property_id);
+	const EidosPropertySignature *signature = p_signature;
 	
 	if (!signature)
 		EIDOS_TERMINATION << "ERROR (EidosValue_Object::GetPropertyOfElements): property " << EidosStringRegistry::StringForGlobalStringID(p_property_id) << " is not defined for object element type " << ElementType() << "." << EidosTerminate(nullptr);
@@ -2268,7 +2444,12 @@ EidosValue_SP EidosValue_Object::GetPropertyOfElements(EidosGlobalStringID p_pro
 
 void EidosValue_Object::SetPropertyOfElements(EidosGlobalStringID p_property_id, const EidosValue &p_value, EidosToken *p_property_token)
 {
-	const EidosPropertySignature *signature = Class()->SignatureForProperty(p_property_id);
+	SetPropertyOfElements(p_property_id, Class()->SignatureForProperty(p_property_id), p_value, p_property_token);
+}
+
+void EidosValue_Object::SetPropertyOfElements(EidosGlobalStringID p_property_id, const EidosPropertySignature *p_signature, const EidosValue &p_value, EidosToken *p_property_token)
+{
+	const EidosPropertySignature *signature = p_signature;
 	
 	// BCH 9 Sept. 2022: if the property does not exist, raise an error on the token for the property name.
 	// Note that other errors stemming from this call will refer to whatever the current error range is.
@@ -52,6 +52,102 @@
 extern EidosObjectPool *gEidosValuePool;
 
 
+// EidosValue_Int and EidosValue_Float keep up to EIDOS_VALUE_INLINE_CAPACITY values inline, inside the EidosValue object itself;
+// two values fit within the chunk size of gEidosValuePool, which is set by EidosValue_Object, so short vectors like c(x, y) cost
+// nothing beyond the EidosValue.  Longer buffers, up to EIDOS_VALUE_BUFFER_MAX_POOLED elements, are allocated in power-of-two
+// size classes and recycled through free lists when freed, so that the churn of short vectors in scripts avoids malloc/free;
+// larger buffers are malloced at their exact size, as before.  Both classes have 8-byte elements, so they share the pools.
+#define EIDOS_VALUE_INLINE_CAPACITY			2
+#define EIDOS_VALUE_BUFFER_MIN_POOLED		4
+#define EIDOS_VALUE_BUFFER_MAX_POOLED		64
+#define EIDOS_VALUE_BUFFER_CLASS_COUNT		5		// 4, 8, 16, 32, 64 elements
+#define EIDOS_VALUE_BUFFER_MAX_FREE			4096	// the maximum number of free buffers retained per size class
+
+extern void *gEidosValueBufferFreeList[EIDOS_VALUE_BUFFER_CLASS_COUNT];
+extern size_t gEidosValueBufferFreeCount[EIDOS_VALUE_BUFFER_CLASS_COUNT];
+
+inline __attribute__((always_inline)) int Eidos_ValueBufferSizeClass(size_t p_element_count)
+{
+	int size_class = 0;
+	
+	for (size_t class_count = EIDOS_VALUE_BUFFER_MIN_POOLED; class_count < p_element_count; class_count <<= 1)
+		size_class++;
+	
+	return size_class;
+}
+
+// Allocates a buffer for at least p_element_count 8-byte elements; the capacity actually provided is returned in p_capacity
+inline void *Eidos_AllocateValueBuffer(size_t p_element_count, size_t *p_capacity)
+{
+	THREAD_SAFETY_IN_ACTIVE_PARALLEL("Eidos_AllocateValueBuffer(): value buffer pool change");
+	
+	if (p_element_count > EIDOS_VALUE_BUFFER_MAX_POOLED)
+	{
+		*p_capacity = p_element_count;
+		return malloc(p_element_count * sizeof(int64_t));
+	}
+	
+	int size_class = Eidos_ValueBufferSizeClass(p_element_count);
+	void *buffer = gEidosValueBufferFreeList[size_class];
+	
+	*p_capacity = ((size_t)EIDOS_VALUE_BUFFER_MIN_POOLED << size_class);
+	
+	if (buffer)
+	{
+		gEidosValueBufferFreeList[size_class] = *(void **)buffer;
+		gEidosValueBufferFreeCount[size_class]--;
+		return buffer;
+	}
+	
+	return malloc(*p_capacity * sizeof(int64_t));
+}
+
+// Frees a buffer obtained from Eidos_AllocateValueBuffer(); p_capacity must be the capacity it provided
+inline void Eidos_FreeValueBuffer(void *p_buffer, size_t p_capacity)
+{
+	THREAD_SAFETY_IN_ACTIVE_PARALLEL("Eidos_FreeValueBuffer(): value buffer pool change");
+	
+	if (p_capacity <= EIDOS_VALUE_BUFFER_MAX_POOLED)
+	{
+		int size_class = Eidos_ValueBufferSizeClass(p_capacity);
+		
+		if (gEidosValueBufferFreeCount[size_class] < EIDOS_VALUE_BUFFER_MAX_FREE)
+		{
+			*(void **)p_buffer = gEidosValueBufferFreeList[size_class];
+			gEidosValueBufferFreeList[size_class] = p_buffer;
+			gEidosValueBufferFreeCount[size_class]++;
+			return;
+		}
+	}
+	
+	free(p_buffer);
+}
+
+// Vectors longer than EIDOS_VALUE_BUFFER_MAX_POOLED are shared copy-on-write rather than copied, by CopyValues() and by subsets
+// that select a contiguous range of elements; see EidosValue_Int::SharedSlice().  Only a slice covering at least half of the
+// buffer shares it, so that a short slice of a long vector never keeps the whole buffer alive.  Each sharing value points into
+// the same malloced buffer, which is freed when the last of them releases it.  A value that is about to be modified first gets
+// its own copy of the elements it uses (or, if it is the last user of the whole buffer, simply takes the buffer back); see
+// WILL_MODIFY_BUFFER().  The reference count is not atomic, so sharing has the same threading constraints as EidosValue itself.
+struct EidosValueBufferShare
+{
+	void *buffer_;						// the malloced buffer
+	size_t capacity_;					// the capacity of buffer_, in elements
+	uint32_t refcount_;					// the number of values pointing into buffer_
+};
+
+inline void Eidos_ReleaseValueBufferShare(EidosValueBufferShare *p_share)
+{
+	THREAD_SAFETY_IN_ACTIVE_PARALLEL("Eidos_ReleaseValueBufferShare(): value buffer share change");
+	
+	if (--p_share->refcount_ == 0)
+	{
+		free(p_share->buffer_);
+		delete p_share;
+	}
+}
+
+
 // Global EidosValues that are defined at Eidos_WarmUp() time and are never deallocated.
 extern EidosValue_VOID_SP gStaticEidosValueVOID;
 
@@ -186,6 +282,10 @@ bool CompareEidosValues(const EidosValue &p_value1, int p_index1, const EidosVal
 #define WILL_MODIFY(x)	//if ((x)->constant_) RaiseForImmutabilityCall();
 #endif
 
+// This macro is used by EidosValue_Int and EidosValue_Float before any change to their values; if their buffer is shared with
+// other values, copy-on-write, it gives them a private copy of their values first.  Unlike WILL_MODIFY(), this is always active.
+#define WILL_MODIFY_BUFFER(x)	if ((x)->buffer_shared_) (x)->_UnshareBuffer();
+
 
 class EidosValue
 {
@@ -200,6 +300,7 @@ protected:
 	unsigned int invisible_ : 1;							// as in R; if true, the value will not normally be printed to the console
 	unsigned int registered_for_patching_ : 1;				// used by EidosValue_Object, otherwise UNINITIALIZED; declared here for reasons of memory packing
 	unsigned int class_uses_retain_release_ : 1;			// used by EidosValue_Object, otherwise UNINITIALIZED; cached from UsesRetainRelease() of class_; true until class_ is set
+	unsigned int buffer_shared_ : 1;						// used by EidosValue_Int and EidosValue_Float; if set, values_ is in a copy-on-write buffer; see EidosValueBufferShare
 	
 	int64_t *dim_;											// nullptr for vectors; points to a malloced, OWNED array of dimensions for matrices and arrays
 															//    when allocated, the first value in the buffer is a count of the dimensions that follow
@@ -212,7 +313,7 @@ public:
 	EidosValue& operator=(const EidosValue&) = delete;		// no copying
 	EidosValue(void) = delete;								// no null constructor
 	
-	inline EidosValue(EidosValueType p_value_type) : intrusive_ref_count_(0), cached_type_(p_value_type), constant_(false), iterator_var_(false), invisible_(false), dim_(nullptr)
+	inline EidosValue(EidosValueType p_value_type) : intrusive_ref_count_(0), cached_type_(p_value_type), constant_(false), iterator_var_(false), invisible_(false), buffer_shared_(false), dim_(nullptr)
 	{
 #ifdef EIDOS_TRACK_VALUE_ALLOCATION
 		valueTrackingCount++;
@@ -234,6 +335,7 @@ public:
 	void RaiseForImmutabilityCall(void) const __attribute__((__noreturn__)) __attribute__((analyzer_noreturn));
 	void RaiseForCapacityViolation(void) const __attribute__((__noreturn__)) __attribute__((analyzer_noreturn));
 	void RaiseForRangeViolation(void) const __attribute__((__noreturn__)) __attribute__((analyzer_noreturn));
+	void RaiseForSharedBufferViolation(void) const __attribute__((__noreturn__)) __attribute__((analyzer_noreturn));
 	void RaiseForRetainReleaseViolation(void) const __attribute__((__noreturn__)) __attribute__((analyzer_noreturn));
 	
 	// basic methods
@@ -689,9 +791,12 @@ private:
 	typedef EidosValue super;
 
 protected:
-	// singleton/vector design: values_ will either point to singleton_value_, or to a malloced buffer; it will never be nullptr
-	// in the case of a zero-length vector, note that values_ will point to singleton_value_ with count_ == 0 but capacity_ == 1
-	int64_t singleton_value_;
+	// small-vector design: values_ will either point to inline_values_, or to a buffer from Eidos_AllocateValueBuffer(), or into
+	// a shared buffer if buffer_shared_ is set; it will never be nullptr; for a zero-length vector, values_ may point to inline_values_
+	union {
+		int64_t inline_values_[EIDOS_VALUE_INLINE_CAPACITY];	// used when values_ == inline_values_
+		EidosValueBufferShare *buffer_share_;			// used when buffer_shared_ is set
+	};
 	int64_t *values_ = nullptr;
 	size_t count_, capacity_;
 	
@@ -699,17 +804,17 @@ public:
 	EidosValue_Int(const EidosValue_Int &p_original) = delete;			// no copy-construct
 	EidosValue_Int& operator=(const EidosValue_Int&) = delete;			// no copying
 	
-	explicit inline EidosValue_Int(void) : EidosValue(EidosValueType::kValueInt), values_(&singleton_value_), count_(0), capacity_(1) { }
-	explicit inline EidosValue_Int(int64_t p_int1) : EidosValue(EidosValueType::kValueInt), singleton_value_(p_int1), values_(&singleton_value_), count_(1), capacity_(1) { }
+	explicit inline EidosValue_Int(void) : EidosValue(EidosValueType::kValueInt), values_(inline_values_), count_(0), capacity_(EIDOS_VALUE_INLINE_CAPACITY) { }
+	explicit inline EidosValue_Int(int64_t p_int1) : EidosValue(EidosValueType::kValueInt), values_(inline_values_), count_(1), capacity_(EIDOS_VALUE_INLINE_CAPACITY) { inline_values_[0] = p_int1; }
 	explicit EidosValue_Int(const std::vector<int16_t> &p_intvec);
 	explicit EidosValue_Int(const std::vector<int32_t> &p_intvec);
 	explicit EidosValue_Int(const std::vector<int64_t> &p_intvec);
 	explicit EidosValue_Int(std::initializer_list<int64_t> p_init_list);
 	explicit EidosValue_Int(const int64_t *p_values, size_t p_count);
-	inline virtual ~EidosValue_Int(void) override { if (values_ != &singleton_value_) free(values_); }
+	inline virtual ~EidosValue_Int(void) override { if (buffer_shared_) Eidos_ReleaseValueBufferShare(buffer_share_); else if (values_ != inline_values_) Eidos_FreeValueBuffer(values_, capacity_); }
 	
 	virtual const int64_t *IntData(void) const override { return values_; }
-	virtual int64_t *IntData_Mutable(void) override { WILL_MODIFY(this); return values_; }
+	virtual int64_t *IntData_Mutable(void) override { WILL_MODIFY(this); WILL_MODIFY_BUFFER(this); return values_; }
 	
 	virtual int Count(void) const override { return (int)count_; }
 	virtual const std::string &ElementType(void) const override;
@@ -730,6 +835,12 @@ public:
 	virtual void PushValueFromIndexOfEidosValue(int p_idx, const EidosValue &p_source_script_value, const EidosToken *p_blame_token) override;
 	virtual void Sort(bool p_ascending) override;
 	
+	// copy-on-write buffer sharing; see EidosValueBufferShare
+	inline bool CanShareBuffer(void) const { return buffer_shared_ || ((values_ != inline_values_) && (capacity_ > EIDOS_VALUE_BUFFER_MAX_POOLED)); }
+	inline bool CanShareSlice(size_t p_count) const { return CanShareBuffer() && (p_count * 2 >= (buffer_shared_ ? buffer_share_->capacity_ : capacity_)); }	// only slices of at least half the buffer, so a small slice never pins a large buffer
+	EidosValue_Int_SP SharedSlice(size_t p_offset, size_t p_count) const;		// requires CanShareSlice(p_count); an O(1) view of p_count elements
+	void _UnshareBuffer(void);											// called by WILL_MODIFY_BUFFER(); do not call directly
+	
 	// vector lookalike methods for speed; not virtual, only for clients with an EidosValue_Int*
 	EidosValue_Int *reserve(size_t p_reserved_size);					// as in std::vector
 	void erase_index(size_t p_index);									// a weak substitute for erase()
@@ -761,6 +872,7 @@ public:
 		// resizes up to exactly p_new_size; if new capacity is needed, doubles to achieve that
 		// this avoids doing a realloc with every resize, with repeated resize operations
 		WILL_MODIFY(this);
+		WILL_MODIFY_BUFFER(this);
 		
 		if (capacity_ < p_new_size)
 		{
@@ -775,11 +887,12 @@ public:
 		count_ = p_new_size;	// regardless of the capacity set, set the size to exactly p_new_size
 	}
 	
-	inline __attribute__((always_inline)) int64_t *data_mutable(void) { WILL_MODIFY(this); return values_; }
+	inline __attribute__((always_inline)) int64_t *data_mutable(void) { WILL_MODIFY(this); WILL_MODIFY_BUFFER(this); return values_; }
 	inline __attribute__((always_inline)) const int64_t *data(void) const { return values_; }
 	inline __attribute__((always_inline)) void push_int(int64_t p_int)
 	{
 		WILL_MODIFY(this);
+		WILL_MODIFY_BUFFER(this);
 		if (count_ == capacity_) expand();
 		values_[count_++] = p_int;
 	}
@@ -787,7 +900,9 @@ public:
 		WILL_MODIFY(this);
 #if DEBUG
 		// do checks only in DEBUG mode, for speed; the user should never be able to trigger these errors
+		// the buffer is unshared by reserve(), resize_no_initialize(), and data_mutable(), one of which must come first
 		if (count_ == capacity_) RaiseForCapacityViolation();
+		if (buffer_shared_) RaiseForSharedBufferViolation();
 #endif
 		values_[count_++] = p_int;
 	}
@@ -795,7 +910,9 @@ public:
 		WILL_MODIFY(this);
 #if DEBUG
 		// do checks only in DEBUG mode, for speed; the user should never be able to trigger these errors
+		// the buffer is unshared by reserve(), resize_no_initialize(), and data_mutable(), one of which must come first
 		if (p_index >= count_) RaiseForRangeViolation();
+		if (buffer_shared_) RaiseForSharedBufferViolation();
 #endif
 		values_[p_index] = p_int;
 	}
@@ -817,9 +934,12 @@ private:
 	typedef EidosValue super;
 
 protected:
-	// singleton/vector design: values_ will either point to singleton_value_, or to a malloced buffer; it will never be nullptr
-	// in the case of a zero-length vector, note that values_ will point to singleton_value_ with count_ == 0 but capacity_ == 1
-	double singleton_value_;
+	// small-vector design: values_ will either point to inline_values_, or to a buffer from Eidos_AllocateValueBuffer(), or into
+	// a shared buffer if buffer_shared_ is set; it will never be nullptr; for a zero-length vector, values_ may point to inline_values_
+	union {
+		double inline_values_[EIDOS_VALUE_INLINE_CAPACITY];	// used when values_ == inline_values_
+		EidosValueBufferShare *buffer_share_;			// used when buffer_shared_ is set
+	};
 	double *values_;
 	size_t count_, capacity_;
 	
@@ -827,15 +947,15 @@ public:
 	EidosValue_Float(const EidosValue_Float &p_original) = delete;			// no copy-construct
 	EidosValue_Float& operator=(const EidosValue_Float&) = delete;			// no copying
 	
-	explicit inline EidosValue_Float(void) : EidosValue(EidosValueType::kValueFloat), values_(&singleton_value_), count_(0), capacity_(1) { }
-	explicit inline EidosValue_Float(double p_float1) : EidosValue(EidosValueType::kValueFloat), singleton_value_(p_float1), values_(&singleton_value_), count_(1), capacity_(1) { }
+	explicit inline EidosValue_Float(void) : EidosValue(EidosValueType::kValueFloat), values_(inline_values_), count_(0), capacity_(EIDOS_VALUE_INLINE_CAPACITY) { }
+	explicit inline EidosValue_Float(double p_float1) : EidosValue(EidosValueType::kValueFloat), values_(inline_values_), count_(1), capacity_(EIDOS_VALUE_INLINE_CAPACITY) { inline_values_[0] = p_float1; }
 	explicit EidosValue_Float(const std::vector<double> &p_doublevec);
 	explicit EidosValue_Float(std::initializer_list<double> p_init_list);
 	explicit EidosValue_Float(const double *p_values, size_t p_count);
-	inline virtual ~EidosValue_Float(void) override { if (values_ != &singleton_value_) free(values_); }
+	inline virtual ~EidosValue_Float(void) override { if (buffer_shared_) Eidos_ReleaseValueBufferShare(buffer_share_); else if (values_ != inline_values_) Eidos_FreeValueBuffer(values_, capacity_); }
 	
 	virtual const double *FloatData(void) const override { return values_; }
-	virtual double *FloatData_Mutable(void) override { WILL_MODIFY(this); return values_; }
+	virtual double *FloatData_Mutable(void) override { WILL_MODIFY(this); WILL_MODIFY_BUFFER(this); return values_; }
 	
 	virtual int Count(void) const override { return (int)count_; }
 	virtual const std::string &ElementType(void) const override;
@@ -856,6 +976,12 @@ public:
 	virtual void PushValueFromIndexOfEidosValue(int p_idx, const EidosValue &p_source_script_value, const EidosToken *p_blame_token) override;
 	virtual void Sort(bool p_ascending) override;
 
+	// copy-on-write buffer sharing; see EidosValueBufferShare
+	inline bool CanShareBuffer(void) const { return buffer_shared_ || ((values_ != inline_values_) && (capacity_ > EIDOS_VALUE_BUFFER_MAX_POOLED)); }
+	inline bool CanShareSlice(size_t p_count) const { return CanShareBuffer() && (p_count * 2 >= (buffer_shared_ ? buffer_share_->capacity_ : capacity_)); }	// only slices of at least half the buffer, so a small slice never pins a large buffer
+	EidosValue_Float_SP SharedSlice(size_t p_offset, size_t p_count) const;		// requires CanShareSlice(p_count); an O(1) view of p_count elements
+	void _UnshareBuffer(void);											// called by WILL_MODIFY_BUFFER(); do not call directly
+	
 	// vector lookalike methods for speed; not virtual, only for clients with an EidosValue_Float*
 	EidosValue_Float *reserve(size_t p_reserved_size);				// as in std::vector
 	void erase_index(size_t p_index);								// a weak substitute for erase()
@@ -887,6 +1013,7 @@ public:
 		// resizes up to exactly p_new_size; if new capacity is needed, doubles to achieve that
 		// this avoids doing a realloc with every resize, with repeated resize operations
 		WILL_MODIFY(this);
+		WILL_MODIFY_BUFFER(this);
 		
 		if (capacity_ < p_new_size)
 		{
@@ -901,11 +1028,12 @@ public:
 		count_ = p_new_size;	// regardless of the capacity set, set the size to exactly p_new_size
 	}
 	
-	inline __attribute__((always_inline)) double *data_mutable(void) { WILL_MODIFY(this); return values_; }
+	inline __attribute__((always_inline)) double *data_mutable(void) { WILL_MODIFY(this); WILL_MODIFY_BUFFER(this); return values_; }
 	inline __attribute__((always_inline)) const double *data(void) const { return values_; }
 	inline __attribute__((always_inline)) void push_float(double p_float)
 	{
 		WILL_MODIFY(this);
+		WILL_MODIFY_BUFFER(this);
 		if (count_ == capacity_) expand();
 		values_[count_++] = p_float;
 	}
@@ -913,7 +1041,9 @@ public:
 		WILL_MODIFY(this);
 #if DEBUG
 		// do checks only in DEBUG mode, for speed; the user should never be able to trigger these errors
+		// the buffer is unshared by reserve(), resize_no_initialize(), and data_mutable(), one of which must come first
 		if (count_ == capacity_) RaiseForCapacityViolation();
+		if (buffer_shared_) RaiseForSharedBufferViolation();
 #endif
 		values_[count_++] = p_float;
 	}
@@ -921,7 +1051,9 @@ public:
 		WILL_MODIFY(this);
 #if DEBUG
 		// do checks only in DEBUG mode, for speed; the user should never be able to trigger these errors
+		// the buffer is unshared by reserve(), resize_no_initialize(), and data_mutable(), one of which must come first
 		if (p_index >= count_) RaiseForRangeViolation();
+		if (buffer_shared_) RaiseForSharedBufferViolation();
 #endif
 		values_[p_index] = p_float;
 	}
@@ -1026,8 +1158,12 @@ public:
 	
 	// Property and method support; defined only on EidosValue_Object, not EidosValue.  The methods that a
 	// EidosValue_Object instance defines depend upon the type of the EidosObject objects it contains.
+	// The variants taking a signature are for callers that have already looked it up, such as EidosInterpreter with its inline caches;
+	// p_signature must be the signature for p_property_id in our class, or nullptr if the property is not defined (which raises).
 	EidosValue_SP GetPropertyOfElements(EidosGlobalStringID p_property_id) const;
+	EidosValue_SP GetPropertyOfElements(EidosGlobalStringID p_property_id, const EidosPropertySignature *p_signature) const;
 	void SetPropertyOfElements(EidosGlobalStringID p_property_id, const EidosValue &p_value, EidosToken *p_property_token);
+	void SetPropertyOfElements(EidosGlobalStringID p_property_id, const EidosPropertySignature *p_signature, const EidosValue &p_value, EidosToken *p_property_token);
 	
 	EidosValue_SP ExecuteMethodCall(EidosGlobalStringID p_method_id, const EidosInstanceMethodSignature *p_call_signature, const std::vector<EidosValue_SP> &p_arguments, EidosInterpreter &p_interpreter);
 	